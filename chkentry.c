@@ -76,7 +76,7 @@ static bool quiet = false;		    /* true ==> quiet mode */
  * Use the usage() function to print the usage_msg([0-9]?)+ strings.
  */
 static const char * const usage_msg =
-    "usage: %s [-h] [-v level] [-J level] [-V] [-q] [-b] [-I path] ... [-P] [-s] [-S] [-w] dir\n"
+    "usage: %s [-h] [-v level] [-J level] [-V] [-q] [-b] [-I path] ... [-P] [-s] [-S] [-w] [-C cachedir] dir\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
     "\t-v level\tset verbosity level (def level: %d)\n"
@@ -94,6 +94,8 @@ static const char * const usage_msg =
     "\t\t\t    NOTE: -S conflicts with -I path, -P, -s, and -w\n"
     "\t-w\t\tIOCCC judge use only: winning entry checks\n"
     "\t\t\t    NOTE: -w conflicts with -s\n"
+    "\t-C cachedir\tcache verdicts and reports in cachedir, replay them for an unchanged dir\n"
+    "\t\t\t    (def: do not cache)\n"
     "\n"
     "\tdir\tthe directory to be checked (entry directory if -w, submission directory otherwise)\n"
     "\n"
@@ -113,7 +115,9 @@ static const char * const usage_msg =
 /*
  * functions
  */
-static bool chk_json(FILE *err, char const *submission_dir, char const *filename, struct json_sem *sem);
+static bool chk_json(FILE *err, char const *submission_dir, char const *filename, struct json_sem *sem,
+		     int (*find)(struct json *node, unsigned int depth, struct json_sem *sem));
+static void cache_add_items(struct result_cache *cache, struct dyn_array *items);
 static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
 
 
@@ -146,6 +150,10 @@ main(int argc, char *argv[])
     /**/
     int cd_ret = -1;			/* chdir(2) return */
     /**/
+    char *cachedir = NULL;		/* -C cachedir, NULL ==> no result cache */
+    struct result_cache cache;		/* result cache state */
+    intmax_t cached_ok = 0;		/* walk_ok of a cached result */
+    /**/
     int i;
     intmax_t j;
 
@@ -156,7 +164,7 @@ main(int argc, char *argv[])
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:J:VqbI:PwsS")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:J:VqbI:PwsSC:")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 0 */
 	    usage(2, program, "");	/*ooo*/
@@ -213,6 +221,9 @@ main(int argc, char *argv[])
         case 'S':
             submission_mode = true;
             break;
+	case 'C':   /* -C cachedir - cache verdicts and reports in cachedir */
+	    cachedir = optarg;
+	    break;
 	case ':':   /* option requires an argument */
 	case '?':   /* illegal option */
 	default:    /* anything else but should not actually happen */
@@ -226,6 +237,13 @@ main(int argc, char *argv[])
 	    break;
 	}
     }
+    /*
+     * setup the result cache, if -C cachedir, before we chdir(2) into the submission directory
+     */
+    result_cache_init(&cache, cachedir, CHKENTRY_BASENAME, CHKENTRY_VERSION, MKIOCCCENTRY_REPO_VERSION,
+		      JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION, NULL);
+    result_cache_add_tool(&cache, program);
+
     submit_dir = argv[optind]; /* IMPORTANT! */
     switch (argc-optind) {
     case 1:
@@ -345,6 +363,22 @@ main(int argc, char *argv[])
     dbg(DBG_LOW, "will use context: %s name: %s",
 		 context, (wset_p == NULL || wset_p->name == NULL) ? "((NULL))" : wset_p->name);
 
+    /*
+     * key the result cache by every option that can change the report
+     *
+     * NOTE: any -I path is added to the key when it is processed below.
+     */
+    result_cache_add_intmax(&cache, (intmax_t)verbosity_level);
+    result_cache_add_intmax(&cache, (intmax_t)json_verbosity_level);
+    result_cache_add_intmax(&cache, (intmax_t)quiet);
+    result_cache_add_intmax(&cache, (intmax_t)msg_warn_silent);
+    result_cache_add_intmax(&cache, (intmax_t)ignore_permissions);
+    result_cache_add_intmax(&cache, (intmax_t)winning_entry_mode);
+    result_cache_add_intmax(&cache, (intmax_t)special_mode);
+    result_cache_add_intmax(&cache, (intmax_t)submission_mode);
+    result_cache_add_str(&cache, submit_dir);
+    result_cache_add_str(&cache, submission_dir);
+
     /*
      * init_walk_stat - initialize a walk_stat
      */
@@ -366,7 +400,7 @@ main(int argc, char *argv[])
     if (cap_I_seen) {
 
 	optind = 1;	/* reset getopt(3) processing */
-	while ((i = getopt(argc, argv, ":hv:J:VqI:PwsSb")) != -1) {
+	while ((i = getopt(argc, argv, ":hv:J:VqI:PwsSbC:")) != -1) {
 	    switch (i) {
 	    case 'h':		/* -h - print help to stderr and exit 0 */
 	    case 'v':		/* -v verbosity */
@@ -378,9 +412,11 @@ main(int argc, char *argv[])
 	    case 's':
 	    case 'S':
 	    case 'b':
+	    case 'C':
 		/* already processed, nothing to do now */
 		break;
 	    case 'I':
+		result_cache_add_str(&cache, optarg);
 		skip_add_ret = skip_add(&wstat, optarg);
 		if (skip_add_ret) {
 		    dbg(DBG_LOW, "context will ignore, when canonicalized: %s", optarg);
@@ -417,6 +453,39 @@ main(int argc, char *argv[])
      */
     sort_walk_istat(&wstat);
 
+    /*
+     * finish the result cache key with what was walked and the JSON files to check
+     *
+     * If the same tree, with the same sizes, modes and modification times, and the
+     * same JSON files were checked before, replay that report instead of checking
+     * it all over again.
+     */
+    cache_add_items(&cache, wstat.filedirsym);
+    cache_add_items(&cache, wstat.not_filedirsym);
+    if (winning_entry_mode) {
+	result_cache_add_file(&cache, ".entry.json");
+    } else {
+	result_cache_add_file(&cache, ".auth.json");
+	result_cache_add_file(&cache, ".info.json");
+    }
+    if (result_cache_lookup(&cache, &cached_ok)) {
+	/*
+	 * the report of this very tree was replayed from the cache
+	 */
+	result_cache_free(&cache);
+	if (submission_dir != NULL) {
+	    free(submission_dir);
+	    submission_dir = NULL;
+	}
+	free_walk_stat(&wstat);
+	if (cached_ok == 0) {
+	    err(1, CHKENTRY_BASENAME, "check failed for: %s", submit_dir); /*ooo*/
+	    not_reached();
+	}
+	exit(0); /*ooo*/
+    }
+    result_cache_capture(&cache);
+
     /*
      * end walk and check if the walk was successful
      */
@@ -542,7 +611,7 @@ main(int argc, char *argv[])
 	 * TODO: until we have a struct json_sem for .entry.json, we pass NULL
 	 */
 	json_filename = ".entry.json";
-	json_ok = chk_json(stderr, ".", json_filename, NULL);
+	json_ok = chk_json(stderr, ".", json_filename, NULL, NULL);
 	if (json_ok == false) {
 	    dbg(DBG_LOW, "invalid JSON file: %s/%s", submission_dir, json_filename);
 	    walk_ok = false;
@@ -557,7 +626,7 @@ main(int argc, char *argv[])
 	 * check .auth.json
 	 */
 	json_filename = ".auth.json";
-	json_ok = chk_json(stderr, ".", json_filename, sem_auth);
+	json_ok = chk_json(stderr, ".", json_filename, sem_auth, sem_auth_find);
 	if (json_ok == false) {
 	    dbg(DBG_LOW, "invalid JSON file: %s/%s", submission_dir, json_filename);
 	    walk_ok = false;
@@ -567,12 +636,14 @@ main(int argc, char *argv[])
 	 * check .info.json
 	 */
 	json_filename = ".info.json";
-	json_ok = chk_json(stderr, ".", json_filename, sem_info);
+	json_ok = chk_json(stderr, ".", json_filename, sem_info, sem_info_find);
 	if (json_ok == false) {
 	    dbg(DBG_LOW, "invalid JSON file: %s/%s", submission_dir, json_filename);
 	    walk_ok = false;
 	}
     }
+    result_cache_store(&cache, (intmax_t)walk_ok);
+    result_cache_free(&cache);
 
     /*
      * free submission directory
@@ -598,6 +669,53 @@ main(int argc, char *argv[])
 }
 
 
+/*
+ * cache_add_items - add walked items to a result cache key
+ *
+ * Each item adds its canonicalized and original path, type, size, mode
+ * and modification time.
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	items	dynamic array of struct item pointers
+ *
+ * NOTE: this function does not return on NULL args or a NULL item.
+ */
+static void
+cache_add_items(struct result_cache *cache, struct dyn_array *items)
+{
+    struct item *i_p;			/* pointer to an element in the dynamic array */
+    intmax_t len;			/* number of elements in the dynamic array */
+    intmax_t j;
+
+    /*
+     * firewall
+     */
+    if (cache == NULL || items == NULL) {
+	err(15, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (!cache->enabled) {
+	return;
+    }
+
+    len = dyn_array_tell(items);
+    result_cache_add_intmax(cache, len);
+    for (j=0; j < len; ++j) {
+	i_p = dyn_array_value(items, struct item *, j);
+	if (i_p == NULL || i_p->fts_path == NULL || i_p->orig_path == NULL) {
+	    err(16, __func__, "item[%jd] or its path is NULL", j);
+	    not_reached();
+	}
+	result_cache_add_str(cache, i_p->fts_path);
+	result_cache_add_intmax(cache, (intmax_t)i_p->st_size);
+	result_cache_add_intmax(cache, (intmax_t)i_p->st_mode);
+	result_cache_add_stat(cache, i_p->orig_path);
+    }
+    return;
+}
+
+
 /*
  * usage - print usage to stderr
  *
@@ -652,6 +770,8 @@ usage(int exitcode, char const *prog, char const *str)
  *	filename	    name of JSON file in submission_dir
  *	sem		    != NULL ==> pointer to a JSON semantic table
  *			    NULL => do not perform any semantic table checks
+ *	find		    compiled matcher for sem (see jsemtblgen -C)
+ *			    NULL => match with json_sem_find()
  *
  * returns:
  *	true ==> all is OK
@@ -661,7 +781,8 @@ usage(int exitcode, char const *prog, char const *str)
  * syntax, and finally JSON semantic analysis will be performed.
  */
 static bool
-chk_json(FILE *err, char const *submission_dir, char const *filename, struct json_sem *sem)
+chk_json(FILE *err, char const *submission_dir, char const *filename, struct json_sem *sem,
+	 int (*find)(struct json *node, unsigned int depth, struct json_sem *sem))
 {
     FILE *stream = NULL;				/* file stream for the JSON file or NULL */
     struct json *tree = NULL;				/* JSON parse tree or NULL ==> not parsed or invalid JSON */
@@ -718,7 +839,7 @@ chk_json(FILE *err, char const *submission_dir, char const *filename, struct jso
 	/*
 	 * perform JSON semantic analysis on the .auth.json JSON parse tree
 	 */
-	all_err_count = json_sem_check(tree, JSON_DEFAULT_MAX_DEPTH, sem, &count_err, &val_err, NULL);
+	all_err_count = json_sem_check_find(tree, JSON_DEFAULT_MAX_DEPTH, sem, find, &count_err, &val_err, NULL);
 
 	/*
 	 * firewall for semantic analysis
@@ -80,6 +80,11 @@
  */
 #include "soup/walk.h"
 
+/*
+ * result_cache - content addressed cache of tool verdicts and reports
+ */
+#include "soup/result_cache.h"
+
 /*
  * macros
  */
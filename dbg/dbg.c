@@ -227,6 +227,12 @@ fmsg_write(FILE *stream, char const *caller, char const *fmt, va_list ap)
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write message to stream
      */
@@ -256,6 +262,8 @@ fmsg_write(FILE *stream, char const *caller, char const *fmt, va_list ap)
 		      __func__, caller, fmt);
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
@@ -380,6 +388,12 @@ fdbg_write(FILE *stream, char const *caller, int level, char const *fmt, va_list
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write debug header
      */
@@ -420,6 +434,8 @@ fdbg_write(FILE *stream, char const *caller, int level, char const *fmt, va_list
 		      __func__, caller, level, fmt);
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
@@ -553,6 +569,12 @@ fwarn_write(FILE *stream, char const *caller, char const *name, char const *fmt,
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write warning header to stream
      */
@@ -597,6 +619,8 @@ fwarn_write(FILE *stream, char const *caller, char const *name, char const *fmt,
 			       caller, __func__, caller, name, fmt, strerror(errno));
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
@@ -735,6 +759,12 @@ fwarnp_write(FILE *stream, char const *caller, char const *name, char const *fmt
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write warning header to stream
      */
@@ -779,6 +809,8 @@ fwarnp_write(FILE *stream, char const *caller, char const *name, char const *fmt
 			       caller, __func__, caller, name, fmt, strerror(errno));
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
@@ -936,6 +968,12 @@ ferr_write(FILE *stream, int error_code, char const *caller,
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write error diagnostic header to stream
      */
@@ -976,6 +1014,8 @@ ferr_write(FILE *stream, int error_code, char const *caller,
 			       __func__, caller, error_code, name, fmt);
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
@@ -1117,6 +1157,12 @@ ferrp_write(FILE *stream, int error_code, char const *caller,
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write error diagnostic warning header to stream
      */
@@ -1157,6 +1203,8 @@ ferrp_write(FILE *stream, int error_code, char const *caller,
 		      __func__, caller, error_code, name, fmt);
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
@@ -1314,6 +1362,12 @@ fusage_write(FILE *stream, int error_code, char const *caller, char const *fmt,
      */
     saved_errno = errno;
 
+    /*
+     * lock the stream so that the whole message is written at once, even
+     * when other threads write to the same stream
+     */
+    flockfile(stream);
+
     /*
      * write the usage message to stream
      */
@@ -1344,6 +1398,8 @@ fusage_write(FILE *stream, int error_code, char const *caller, char const *fmt,
 		      __func__, caller, error_code, fmt);
     }
 
+    funlockfile(stream);
+
     /*
      * restore previous errno value
      */
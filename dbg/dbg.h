@@ -41,7 +41,7 @@
 /*
  * definitions
  */
-#define DBG_VERSION "3.2.1 2023-09-28"          /* format: major.minor YYYY-MM-DD */
+#define DBG_VERSION "3.2.2 2026-10-19"          /* format: major.minor YYYY-MM-DD */
 
 /*
  * dbg basename
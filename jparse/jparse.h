@@ -93,6 +93,36 @@
 #include "jparse.tab.h"
 #endif
 
+/*
+ * json_event - JSON event (SAX style) parser
+ */
+#include "json_event.h"
+
+/*
+ * json_push - incremental (push) JSON parser
+ */
+#include "json_push.h"
+
+/*
+ * json_ndjson - JSON Lines (NDJSON) record reader
+ */
+#include "json_ndjson.h"
+
+/*
+ * json_snap - binary snapshot of a JSON parse tree
+ */
+#include "json_snap.h"
+
+/*
+ * json_pindex - persistent index of the paths of a JSON file
+ */
+#include "json_pindex.h"
+
+/*
+ * json_pointer - JSON Pointer (RFC 6901) resolution
+ */
+#include "json_pointer.h"
+
 
 /*
  * globals
@@ -103,10 +133,14 @@ extern const char *const jparse_utf8_version;		/* jparse utf8 version format: ma
 extern const char *const jparse_tool_version;		/* jparse version format: major.minor YYYY-MM-DD */
 /* lexer and parser specific variables */
 extern int jparse_debug;
+extern bool jparse_fast_lex;	/* true ==> scan JSON in memory with the hand-written scanner, not flex */
 
 struct json_extra
 {
     char const *filename;	/* filename being parsed ("-" means stdin) */
+    int line_offset;		/* number of lines in the file before the JSON, 0 ==> JSON starts the file */
+    bool fast_lex;		/* true ==> scan with the hand-written scanner, see jparse_fast_lex */
+    bool lazy_loc;		/* true ==> locate tokens only when needed, see jparse_locate() */
 };
 
 /*
@@ -122,10 +156,25 @@ extern void jparse_error(JPARSE_LTYPE *yyltype, struct json **tree, yyscan_t sca
 /*
  * function prototypes for jparse.l
  */
+extern void jparse_locate(JPARSE_LTYPE *lloc, yyscan_t scanner);
 extern struct json *parse_json(char const *ptr, size_t len, char const *filename, bool *is_valid);
 extern struct json *parse_json_str(char const *ptr, size_t len, bool *is_valid);
 extern struct json *parse_json_stream(FILE *stream, char const *filename, bool *is_valid);
 extern struct json *parse_json_file(char const *name, bool *is_valid);
+extern struct json *parse_json_arena(char const *ptr, size_t len, char const *filename, bool *is_valid);
+extern struct json *parse_json_file_arena(char const *filename, bool *is_valid);
+extern struct json *parse_json_zero_copy(char const *ptr, size_t len, char const *filename, bool *is_valid);
+extern struct json *parse_json_file_zero_copy(char const *filename, bool *is_valid);
+extern bool parse_json_events(char const *ptr, size_t len, char const *filename, struct json_event_cb const *cb,
+			      void *data);
+extern bool parse_json_stream_events(FILE *stream, char const *filename, struct json_event_cb const *cb, void *data);
+extern bool parse_json_file_events(char const *filename, struct json_event_cb const *cb, void *data);
+extern struct json *parse_json_file_push(char const *filename, size_t chunk, struct json_event_cb const *cb, void *data,
+					 bool *is_valid);
+extern struct json *parse_json_ndjson_record(char const *ptr, size_t len, char const *filename, int line,
+					     bool *is_valid);
+extern bool parse_json_ndjson_record_events(char const *ptr, size_t len, char const *filename, int line,
+					    struct json_event_cb const *cb, void *data);
 
 
 #endif /* INCLUDE_JPARSE_H */
@@ -829,7 +829,13 @@ static const flex_int32_t yy_rule_can_match_eol[16] =
 #include "jparse.h"
 
 extern int jparse_lex(JPARSE_STYPE *yylval_param, JPARSE_LTYPE *yylloc_param, yyscan_t scanner);
-static YY_BUFFER_STATE bs;
+
+/*
+ * The flex scanner is jparse_flex_lex(): jparse_lex(), which the parser calls,
+ * runs either it or the hand-written scanner, see jparse_fast_scan().
+ */
+#undef YY_DECL
+#define YY_DECL static int jparse_flex_lex(JPARSE_STYPE *yylval_param, JPARSE_LTYPE *yylloc_param, yyscan_t yyscanner)
 
 /*
  * locations in the file / json block
@@ -850,32 +856,20 @@ static YY_BUFFER_STATE bs;
  * a tab we check if first_column is 0 or if last_column is 0 and if either one
  * is 0, we explicitly set the respective variable to 1. Otherwise we increment
  * the first_column and last_column.
+ *
+ * This is now done by jparse_loc_token().  As the lines and columns are only
+ * needed to report errors, when the JSON is in memory YY_USER_ACTION only adds
+ * the length of the token to the byte offset of the location, and
+ * jparse_locate() computes the lines and columns when they are needed.  JSON
+ * scanned from a stream is still located as each token is scanned, as the
+ * bytes before the current buffer are not there to be scanned again.
  */
+static void jparse_loc_token(JPARSE_LTYPE *lloc, struct json_extra const *extra, char const *text, size_t len);
 #define YY_USER_ACTION \
-			yylloc->filename = yyextra != NULL ? yyextra->filename:""; \
-			yylloc->first_line = yylloc->last_line + 1; \
-			yylloc->first_column = yylloc->last_column; \
-			for (char *p = yytext; *p; ++p) { \
-			    if (*p == '\n') { \
-				yylloc->last_line++; \
-				yylloc->last_column = 0; \
-			    } \
-			    else if (*p == '\t') { \
-				yylloc->last_column += 8; \
-			    } \
-			    else { \
-				if (yylloc->first_column == 0 || yylloc->last_column == 0) { \
-				    if (yylloc->first_column == 0) { \
-					yylloc->first_column = 1; \
-				    } \
-				    if (yylloc->last_column == 0) { \
-					yylloc->last_column = 1; \
-				    } \
-				} else { \
-				    yylloc->last_column++; \
-				    yylloc->first_column++; \
-				} \
-			    } \
+			yylloc->last_byte += (size_t)yyleng; \
+			if (yyextra == NULL || !yyextra->lazy_loc) { \
+			    jparse_loc_token(yylloc, yyextra, yytext, (size_t)yyleng); \
+			    yylloc->loc_byte = yylloc->last_byte; \
 			}
 #line 826 "jparse.c"
 /*
@@ -1454,8 +1448,11 @@ YY_RULE_SETUP
 			    /*
                              * invalid token: any other character (regexp ".")
                              */
-			    dbg(DBG_LOW, "at line %d column %d: invalid token: 0x%02x = <%c>", yylloc->first_line,
-                                    yylloc->first_column, *yytext, *yytext);
+			    if (dbg_allowed(DBG_LOW)) {
+				jparse_locate(yylloc, yyscanner);
+				dbg(DBG_LOW, "at line %d column %d: invalid token: 0x%02x = <%c>", yylloc->first_line,
+				    yylloc->first_column, *yytext, *yytext);
+			    }
 
 			    /*
 			     * Returning 'token' (return token;) is a hack for
@@ -2666,6 +2663,18 @@ void yyfree (void * ptr , yyscan_t yyscanner)
 static bool exists(char const *path);
 static bool is_file(char const *path);
 static bool is_read(char const *path);
+static struct json *json_arena_root(struct json *tree, struct json_arena *arena);
+static struct json *parse_json_scan(char const *ptr, size_t len, char const *filename, bool *is_valid,
+				    struct json_input *input, int line_offset);
+static struct json *parse_json_input(struct json_input *input, char const *filename, bool *is_valid);
+static struct json *parse_json_stream_read(FILE *stream, char const *filename, bool zero_copy, bool *is_valid);
+static struct json *parse_json_file_open(char const *filename, bool zero_copy, bool *is_valid);
+static bool json_events_scan(yyscan_t scanner, struct json_event_cb const *cb, void *data);
+static bool parse_json_events_scan(char const *ptr, size_t len, char const *filename, int line_offset,
+				   struct json_event_cb const *cb, void *data);
+static int jparse_flex_lex(JPARSE_STYPE *yylval_param, JPARSE_LTYPE *yylloc_param, yyscan_t yyscanner);
+static char *fast_token(char *p, char *end, int *tok);
+static int jparse_fast_scan(JPARSE_LTYPE *lloc, yyscan_t yyscanner);
 
 
 /*
@@ -2917,11 +2926,43 @@ low_byte_scan(char const *data, size_t len, size_t *low_bytes, size_t *nul_bytes
  */
 struct json *
 parse_json(char const *ptr, size_t len, char const *filename, bool *is_valid)
+{
+    /*
+     * scan a copy of the JSON blob
+     */
+    return parse_json_scan(ptr, len, filename, is_valid, NULL, 0);
+}
+
+
+/*
+ * parse_json_scan - parse a JSON blob, scanning either a copy of it or in place
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of JSON blob
+ *	len	    - length of the JSON blob
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	is_valid    - non-NULL pointer to boolean to set depending on JSON validity
+ *	input	    - retained input buffer holding ptr and len to scan in place, or
+ *		      NULL ==> scan a copy of the JSON blob
+ *	line_offset - number of lines in the file before the JSON blob, 0 ==>
+ *		      the JSON blob starts the file
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: See parse_json() for details on errors.
+ */
+static struct json *
+parse_json_scan(char const *ptr, size_t len, char const *filename, bool *is_valid, struct json_input *input,
+		int line_offset)
 {
     struct json *tree = NULL;		/* the JSON parse tree */
     int ret = 0;			/* jparse_parse() return value */
     yyscan_t scanner;			/* scanner instance: is a void * */
-    struct json_extra extra;
+    YY_BUFFER_STATE bs = NULL;		/* buffer of the scanner instance */
+    struct json_extra extra;		/* extra data of the scanner instance */
 
     /*
      * firewall
@@ -2976,11 +3017,22 @@ parse_json(char const *ptr, size_t len, char const *filename, bool *is_valid)
 	return NULL;
     }
     extra.filename = filename;
+    extra.line_offset = line_offset;
+    extra.fast_lex = jparse_fast_lex;
+    extra.lazy_loc = true;		/* the JSON is in memory: see jparse_locate() */
 
     /*
      * scan the blob
      */
-    bs = yy_scan_bytes(ptr, (int)len, scanner);
+    if (input != NULL) {
+	/*
+	 * scan in place: json_input_adopt() ended the data with the two NUL
+	 * bytes that yy_scan_buffer() requires
+	 */
+	bs = yy_scan_buffer(input->data, (yy_size_t)(input->len + 2), scanner);
+    } else {
+	bs = yy_scan_bytes(ptr, (int)len, scanner);
+    }
     if (bs == NULL) {
 	/*
 	 * if unable to scan the bytes it indicates an internal error and
@@ -3167,7 +3219,7 @@ parse_json_str(char const *ptr, size_t len, bool *is_valid)
 
 
 /*
- * parse_json_stream - parse an open file stream for JSON data
+ * parse_json_stream_read - read and parse an open file stream for JSON data
  *
  * Given an open file stream, we will read in all data (until EOF) and
  * then parse that data as if it were JSON.
@@ -3175,6 +3227,7 @@ parse_json_str(char const *ptr, size_t len, bool *is_valid)
  * given:
  *	stream      - open file stream containing JSON data
  *	filename    - name of file or NULL for stdin
+ *	zero_copy   - true ==> scan the data read in place, see parse_json_zero_copy()
  *	is_valid    - non-NULL printer to boolean to set depending on json validity
  *
  * return:
@@ -3195,10 +3248,11 @@ parse_json_str(char const *ptr, size_t len, bool *is_valid)
  *       all the problems can be given at the end if the verbosity level is high
  *       enough (or otherwise if this information is requested).
  */
-struct json *
-parse_json_stream(FILE *stream, char const *filename, bool *is_valid)
+static struct json *
+parse_json_stream_read(FILE *stream, char const *filename, bool zero_copy, bool *is_valid)
 {
     struct json *tree = NULL;		/* the JSON parse tree */
+    struct json_input *input = NULL;	/* retained input buffer when scanning data in place */
     char *data = NULL;			/* used to determine if there are NUL bytes in the file */
     size_t len = 0;			/* length of data read */
     bool low_byte_detected = false;	/* true ==> byte values [\x00-\x08\x0e-\x1f] detected in data */
@@ -3346,7 +3400,18 @@ parse_json_stream(FILE *stream, char const *filename, bool *is_valid)
     /*
      * JSON parse the data from the file
      */
-    tree = parse_json(data, len, filename, is_valid);
+    if (zero_copy) {
+	/*
+	 * scan the data in place, the retained input buffer owns data from now on
+	 */
+	input = json_input_adopt(data, len);
+	data = NULL;
+	tree = parse_json_input(input, filename, is_valid);
+	json_input_free(input);
+	input = NULL;
+    } else {
+	tree = parse_json(data, len, filename, is_valid);
+    }
 
     /* free data */
     if (data != NULL) {
@@ -3367,6 +3432,29 @@ parse_json_stream(FILE *stream, char const *filename, bool *is_valid)
 }
 
 
+/*
+ * parse_json_stream - parse an open file stream for JSON data
+ *
+ * Given an open file stream, we will read in all data (until EOF) and
+ * then parse that data as if it were JSON.
+ *
+ * given:
+ *	stream      - open file stream containing JSON data
+ *	filename    - name of file or NULL for stdin
+ *	is_valid    - non-NULL printer to boolean to set depending on json validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: See parse_json_stream_read() for details on errors.
+ */
+struct json *
+parse_json_stream(FILE *stream, char const *filename, bool *is_valid)
+{
+    return parse_json_stream_read(stream, filename, false, is_valid);
+}
+
+
 /* NOTE: The following function is a static duplicate from from mkicccentry toolkit */
 /*
  * exists - if a path exists
@@ -3513,10 +3601,11 @@ is_read(char const *path)
 
 
 /*
- * parse_json_file	    - parse a JSON file in a given filename
+ * parse_json_file_open - open and parse a JSON file in a given filename
  *
  * given:
  *	filename    - filename of file to parse
+ *	zero_copy   - true ==> scan the data read in place, see parse_json_zero_copy()
  *	is_valid    - non-NULL printer to boolean to set depending on json validity
  *
  * return:
@@ -3534,8 +3623,8 @@ is_read(char const *path)
  *	 be given at the end if the verbosity level is high enough (or otherwise if
  *	 this information is requested).
  */
-struct json *
-parse_json_file(char const *filename, bool *is_valid)
+static struct json *
+parse_json_file_open(char const *filename, bool zero_copy, bool *is_valid)
 {
     struct json *tree = NULL;		/* the JSON parse tree */
     FILE *stream = NULL;		/* file stream to read from */
@@ -3682,7 +3771,7 @@ parse_json_file(char const *filename, bool *is_valid)
     /*
      * JSON parse the open stream
      */
-    tree = parse_json_stream(stream, filename, is_valid);
+    tree = parse_json_stream_read(stream, filename, zero_copy, is_valid);
 
     /*
      * return the JSON parse tree tree
@@ -3690,3 +3779,1240 @@ parse_json_file(char const *filename, bool *is_valid)
     return tree;
 }
 
+
+/*
+ * parse_json_file	    - parse a JSON file in a given filename
+ *
+ * given:
+ *	filename    - filename of file to parse
+ *	is_valid    - non-NULL printer to boolean to set depending on json validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: See parse_json_file_open() for details on errors.
+ */
+struct json *
+parse_json_file(char const *filename, bool *is_valid)
+{
+    return parse_json_file_open(filename, false, is_valid);
+}
+
+
+
+/*
+ * json_arena_root - move the root of an arena allocated JSON parse tree out of the arena
+ *
+ * The root of an arena allocated JSON parse tree is moved into a calloc()ed
+ * struct json that owns the arena.  This way the caller frees the tree the
+ * same way as any other JSON parse tree:
+ *
+ *	json_tree_free(tree, max_depth);
+ *	free(tree);
+ *
+ * with json_tree_free() freeing the whole arena in one call.
+ *
+ * given:
+ *	tree	    - JSON parse tree allocated from arena, or NULL
+ *	arena	    - arena of the JSON parse tree
+ *
+ * return:
+ *	pointer to a calloc()ed root of the JSON parse tree, or
+ *	NULL if tree is NULL in which case the arena is freed
+ *
+ * NOTE: This function does not return on calloc error.
+ */
+static struct json *
+json_arena_root(struct json *tree, struct json_arena *arena)
+{
+    struct json *root = NULL;		/* calloc()ed root of the JSON parse tree */
+    struct json **set = NULL;		/* children of the root */
+    intmax_t len = 0;			/* number of children of the root */
+    intmax_t i;
+
+    /*
+     * case: nothing was parsed, the arena is of no use
+     */
+    if (tree == NULL) {
+	json_arena_free(arena);
+	return NULL;
+    }
+
+    /*
+     * move the root out of the arena
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    root = calloc(1, sizeof(*root));
+    if (root == NULL) {
+	errp(61, __func__, "calloc error allocating %zu bytes", sizeof(*root));
+	not_reached();
+    }
+    *root = *tree;
+    root->parent = NULL;
+    root->arena = arena;
+
+    /*
+     * relink the children of the root
+     */
+    switch (root->type) {
+    case JTYPE_OBJECT:
+	set = root->item.object.set;
+	len = root->item.object.len;
+	break;
+    case JTYPE_ARRAY:
+	set = root->item.array.set;
+	len = root->item.array.len;
+	break;
+    case JTYPE_ELEMENTS:
+	set = root->item.elements.set;
+	len = root->item.elements.len;
+	break;
+    default:
+	break;
+    }
+    for (i = 0; set != NULL && i < len; ++i) {
+	if (set[i] != NULL) {
+	    set[i]->parent = root;
+	}
+    }
+
+    return root;
+}
+
+
+/*
+ * parse_json_arena - parse a JSON blob of a given length into an arena
+ *
+ * This function is like parse_json() except that the JSON parse tree nodes,
+ * strings and node sets are all allocated from a single arena (see struct
+ * json_arena in json_parse.h) which makes parsing faster and lets
+ * json_tree_free() free the entire tree in one call.
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of JSON blob
+ *	len	    - length of the JSON blob
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	is_valid    - non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: Only the returned root is calloc()ed.  Free the tree with:
+ *
+ *	json_tree_free(tree, max_depth);
+ *	free(tree);
+ *
+ *	 Nodes of the tree must not be freed on their own, and the tree must not
+ *	 be modified so that nodes not in the arena are linked into it.
+ *
+ * NOTE: See parse_json() for details on errors.
+ */
+struct json *
+parse_json_arena(char const *ptr, size_t len, char const *filename, bool *is_valid)
+{
+    struct json_arena *arena = NULL;	/* arena of the JSON parse tree */
+    struct json_arena *prev = NULL;	/* previously set arena */
+    struct json *tree = NULL;		/* the JSON parse tree */
+
+    /*
+     * parse into a new arena
+     */
+    arena = json_arena_create(0);
+    prev = json_arena_set(arena);
+    tree = parse_json(ptr, len, filename, is_valid);
+    (void) json_arena_set(prev);
+
+    /*
+     * return the JSON parse tree
+     */
+    return json_arena_root(tree, arena);
+}
+
+
+/*
+ * parse_json_file_arena - parse a JSON file in a given filename into an arena
+ *
+ * This function is like parse_json_file() except that the JSON parse tree is
+ * allocated from a single arena.  See parse_json_arena() for details.
+ *
+ * given:
+ *	filename    - filename of file to parse
+ *	is_valid    - non-NULL printer to boolean to set depending on json validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: See parse_json_file() for details on errors.
+ */
+struct json *
+parse_json_file_arena(char const *filename, bool *is_valid)
+{
+    struct json_arena *arena = NULL;	/* arena of the JSON parse tree */
+    struct json_arena *prev = NULL;	/* previously set arena */
+    struct json *tree = NULL;		/* the JSON parse tree */
+
+    /*
+     * parse into a new arena
+     */
+    arena = json_arena_create(0);
+    prev = json_arena_set(arena);
+    tree = parse_json_file(filename, is_valid);
+    (void) json_arena_set(prev);
+
+    /*
+     * return the JSON parse tree
+     */
+    return json_arena_root(tree, arena);
+}
+
+
+/*
+ * parse_json_input - parse a retained input buffer in place into an arena
+ *
+ * The JSON strings without escapes and the JSON numbers of the JSON parse tree
+ * reference the data of input instead of being copied.  The arena takes a
+ * reference to input so that the data stays valid as long as the tree does.
+ *
+ * given:
+ *	input	    - retained input buffer to scan in place
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	is_valid    - non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: The data of input is modified by the scan, see json_input_terminate().
+ */
+static struct json *
+parse_json_input(struct json_input *input, char const *filename, bool *is_valid)
+{
+    struct json_arena *arena = NULL;	/* arena of the JSON parse tree */
+    struct json_arena *prev = NULL;	/* previously set arena */
+    struct json *tree = NULL;		/* the JSON parse tree */
+
+    /*
+     * parse in place into a new arena that references input
+     */
+    arena = json_arena_create(0);
+    arena->input = json_input_ref(input);
+    prev = json_arena_set(arena);
+    tree = parse_json_scan(input->data, input->len, filename, is_valid, input, 0);
+    (void) json_arena_set(prev);
+
+    /*
+     * now that the scan is done, NUL terminate the JSON numbers in place
+     */
+    tree = json_arena_root(tree, arena);
+    json_input_terminate(tree);
+
+    /*
+     * return the JSON parse tree
+     */
+    return tree;
+}
+
+
+/*
+ * parse_json_zero_copy - parse a JSON blob of a given length without copying its tokens
+ *
+ * This function is like parse_json_arena() except that the JSON blob is copied
+ * once into a retained input buffer (see struct json_input in json_parse.h)
+ * which is scanned in place.  JSON strings without escapes and JSON numbers
+ * reference the input buffer instead of being copied into the tree.
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of JSON blob
+ *	len	    - length of the JSON blob
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	is_valid    - non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: Free the tree as for parse_json_arena().  The input buffer is freed
+ *	 along with the arena.
+ *
+ * NOTE: See parse_json() for details on errors.
+ */
+struct json *
+parse_json_zero_copy(char const *ptr, size_t len, char const *filename, bool *is_valid)
+{
+    struct json_input *input = NULL;	/* retained input buffer */
+    struct json *tree = NULL;		/* the JSON parse tree */
+
+    /*
+     * let parse_json() report a NULL ptr or is_valid
+     */
+    if (ptr == NULL || is_valid == NULL) {
+	return parse_json(ptr, len, filename, is_valid);
+    }
+
+    /*
+     * parse a retained copy of the JSON blob in place
+     */
+    input = json_input_create(ptr, len);
+    tree = parse_json_input(input, filename, is_valid);
+    json_input_free(input);
+    input = NULL;
+
+    /*
+     * return the JSON parse tree
+     */
+    return tree;
+}
+
+
+/*
+ * parse_json_file_zero_copy - parse a JSON file in a given filename without copying its tokens
+ *
+ * This function is like parse_json_file_arena() except that the data read from
+ * the file becomes the retained input buffer of the tree: it is scanned in
+ * place and is not copied again.  See parse_json_zero_copy() for details.
+ *
+ * given:
+ *	filename    - filename of file to parse
+ *	is_valid    - non-NULL printer to boolean to set depending on json validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: See parse_json_file() for details on errors.
+ */
+struct json *
+parse_json_file_zero_copy(char const *filename, bool *is_valid)
+{
+    /*
+     * have parse_json_stream_read() scan the data it reads in place
+     */
+    return parse_json_file_open(filename, true, is_valid);
+}
+
+
+/*
+ * json_events_scan - feed the tokens of a scanner to a JSON event parser
+ *
+ * given:
+ *	scanner	    scanner instance with its input set up
+ *	cb	    pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	    data pointer given to each callback
+ *
+ * return:
+ *	true ==> JSON is valid,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: This function reports syntax errors the same way the parser does, via
+ *	 jparse_error().
+ */
+static bool
+json_events_scan(yyscan_t scanner, struct json_event_cb const *cb, void *data)
+{
+    struct json_event_parser ep;	/* JSON event parser */
+    JPARSE_LTYPE lloc;			/* location of the current token */
+    JPARSE_STYPE lval = NULL;		/* semantic value (not used by the scanner) */
+    int tok = JPARSE_EOF;		/* current token */
+    bool valid = false;			/* true ==> JSON is valid so far */
+
+    /*
+     * start at the beginning, as jparse_parse() does, which is after the
+     * lines that come before the JSON in its file (see %initial-action in
+     * jparse.y)
+     */
+    memset(&lloc, 0, sizeof(lloc));
+    if (jparse_get_extra(scanner) != NULL) {
+	lloc.last_line = jparse_get_extra(scanner)->line_offset;
+    }
+    jparse_set_column(0, scanner);
+    jparse_set_lineno(1, scanner);
+    json_event_init(&ep, cb, data);
+
+    /*
+     * feed every token, up to and including end of file, to the event parser
+     */
+    do {
+	tok = jparse_lex(&lval, &lloc, scanner);
+	ep.located = (lloc.last_byte >= (size_t)jparse_get_leng(scanner));
+	ep.offset = ep.located ? lloc.last_byte - (size_t)jparse_get_leng(scanner) : 0;
+	valid = json_event_token(&ep, tok, jparse_get_text(scanner), (size_t)jparse_get_leng(scanner));
+    } while (valid && tok != JPARSE_EOF);
+
+    /*
+     * report why the JSON is not valid
+     */
+    if (!valid) {
+	if (ep.stopped) {
+	    json_dbg(JSON_DBG_LOW, __func__, "%s", ep.error);
+	} else if (ep.error != NULL) {
+	    jparse_error(&lloc, NULL, scanner, "%s", ep.error);
+	} else {
+	    jparse_error(&lloc, NULL, scanner, "syntax error, unexpected %s", json_event_token_name(tok));
+	}
+    } else if (json_dbg_allowed(JSON_DBG_LOW)) {
+	json_dbg(JSON_DBG_LOW, __func__, "valid JSON");
+    }
+
+    json_event_free(&ep);
+    return valid;
+}
+
+
+/*
+ * parse_json_events - parse a JSON blob of a given length into JSON events
+ *
+ * This function is like parse_json() except that no JSON parse tree is formed:
+ * instead the callbacks of cb are called as the JSON blob is scanned, see
+ * struct json_event_cb in json_event.h.
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of JSON blob
+ *	len	    - length of the JSON blob
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	cb	    - pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	    - data pointer given to each callback
+ *
+ * return:
+ *	true ==> JSON is valid,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: This function only warns on error.
+ */
+bool
+parse_json_events(char const *ptr, size_t len, char const *filename, struct json_event_cb const *cb, void *data)
+{
+    /*
+     * scan the JSON blob, which starts the file
+     */
+    return parse_json_events_scan(ptr, len, filename, 0, cb, data);
+}
+
+
+/*
+ * parse_json_events_scan - parse a JSON blob that starts at a given line into JSON events
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of JSON blob
+ *	len	    - length of the JSON blob
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	line_offset - number of lines in the file before the JSON blob, 0 ==>
+ *		      the JSON blob starts the file
+ *	cb	    - pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	    - data pointer given to each callback
+ *
+ * return:
+ *	true ==> JSON is valid,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: See parse_json_events() for details.
+ */
+static bool
+parse_json_events_scan(char const *ptr, size_t len, char const *filename, int line_offset,
+		       struct json_event_cb const *cb, void *data)
+{
+    yyscan_t scanner;			/* scanner instance: is a void * */
+    struct json_extra extra;		/* scanner extra data */
+    YY_BUFFER_STATE buf;		/* scanner buffer of the JSON blob */
+    bool valid = false;			/* true ==> JSON is valid */
+    int ret = 0;			/* jparse_lex_init_extra() return value */
+
+    /*
+     * firewall
+     */
+    if (ptr == NULL) {
+	werr(62, __func__, "ptr is NULL");
+	return false;
+    }
+    if (filename != NULL && *filename == '-') {
+        filename = "-";
+    }
+
+    /*
+     * initialise scanner
+     */
+    errno = 0;
+    ret = jparse_lex_init_extra(&extra, &scanner);
+    if (ret != 0) {
+	werrp(63, __func__, "jparse_lex_init_extra failed");
+	return false;
+    }
+    extra.filename = filename;
+    extra.line_offset = line_offset;
+    extra.fast_lex = jparse_fast_lex;
+    extra.lazy_loc = true;		/* the JSON is in memory: see jparse_locate() */
+    buf = yy_scan_bytes(ptr, (int)len, scanner);
+    if (buf == NULL) {
+	werr(64, __func__, "unable to scan string");
+	jparse_lex_destroy(scanner);
+	return false;
+    }
+
+    /*
+     * scan the blob into JSON events
+     */
+    valid = json_events_scan(scanner, cb, data);
+
+    /*
+     * free the scanner
+     */
+    yy_delete_buffer(buf, scanner);
+    jparse_lex_destroy(scanner);
+    return valid;
+}
+
+
+/*
+ * parse_json_stream_events - parse an open JSON stream into JSON events
+ *
+ * This function is like parse_json_events() except that the JSON is scanned
+ * from an open stream, a scanner buffer at a time, instead of first reading
+ * the entire stream into memory: a JSON document of any size is parsed in
+ * constant memory (apart from the nesting depth and the longest JSON string).
+ *
+ * Unlike parse_json_stream(), the data is not pre-scanned for low bytes
+ * before parsing.  Low bytes outside of JSON strings are invalid tokens and
+ * JSON strings with NUL bytes are rejected by the JSON event parser.
+ *
+ * given:
+ *	stream	    - open file stream that has JSON data in it
+ *	filename    - filename or NULL for stdin
+ *	cb	    - pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	    - data pointer given to each callback
+ *
+ * return:
+ *	true ==> JSON is valid,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: The stream is fclose()d (or, for stdin, clearerr()ed).
+ *
+ * NOTE: This function only warns on error.
+ */
+bool
+parse_json_stream_events(FILE *stream, char const *filename, struct json_event_cb const *cb, void *data)
+{
+    yyscan_t scanner;			/* scanner instance: is a void * */
+    struct json_extra extra;		/* scanner extra data */
+    YY_BUFFER_STATE buf;		/* scanner buffer of the stream */
+    bool valid = false;			/* true ==> JSON is valid */
+    int ret = 0;			/* jparse_lex_init_extra() return value */
+
+    /*
+     * firewall
+     */
+    if (filename == NULL) {
+	filename = "-";
+    }
+    if (stream == NULL) {
+	werr(65, __func__, "stream is NULL");
+	return false;
+    }
+
+    /*
+     * initialise scanner to read from the stream
+     */
+    errno = 0;
+    ret = jparse_lex_init_extra(&extra, &scanner);
+    if (ret != 0) {
+	werrp(66, __func__, "jparse_lex_init_extra failed");
+	clearerr_or_fclose(stream);
+	return false;
+    }
+    extra.filename = filename;
+    extra.line_offset = 0;
+    extra.fast_lex = false;		/* the hand-written scanner only scans JSON in memory */
+    extra.lazy_loc = false;		/* locate each token as it is scanned */
+    buf = yy_create_buffer(stream, YY_BUF_SIZE, scanner);
+    yy_switch_to_buffer(buf, scanner);
+
+    /*
+     * scan the stream into JSON events
+     */
+    valid = json_events_scan(scanner, cb, data);
+
+    /*
+     * free the scanner and the stream
+     */
+    if (ferror(stream)) {
+	warnp(__func__, "error reading stream: %s", filename);
+	valid = false;
+    }
+    yy_delete_buffer(buf, scanner);
+    jparse_lex_destroy(scanner);
+    clearerr_or_fclose(stream);
+    return valid;
+}
+
+
+/*
+ * parse_json_file_events - parse a JSON file in a given filename into JSON events
+ *
+ * See parse_json_stream_events() for details.
+ *
+ * given:
+ *	filename    - filename of file to parse, "-" ==> stdin
+ *	cb	    - pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	    - data pointer given to each callback
+ *
+ * return:
+ *	true ==> JSON is valid,
+ *	false ==> JSON is not valid, the file could not be read or a callback
+ *		  stopped the parse
+ *
+ * NOTE: This function only warns on error.
+ */
+bool
+parse_json_file_events(char const *filename, struct json_event_cb const *cb, void *data)
+{
+    FILE *stream = NULL;		/* file stream to read from */
+
+    /*
+     * firewall
+     */
+    if (filename == NULL) {
+	werr(67, __func__, "passed NULL filename");
+	return false;
+    }
+    if (*filename == '\0') { /* strlen(filename) == 0 */
+	werr(68, __func__, "passed empty filename");
+	return false;
+    }
+
+    /*
+     * if file is "-", then we will parse stdin
+     */
+    if (strcmp(filename, "-") == 0) {
+	stream = stdin;
+
+    /*
+     * case: will read from a file
+     */
+    } else {
+	if (!exists(filename)) {
+	    werr(69, __func__, "passed filename that's not actually a file: %s", filename);
+	    return false;
+	}
+	if (!is_file(filename)) {
+	    werr(70, __func__, "passed filename not a normal file: %s", filename);
+	    return false;
+	}
+	if (!is_read(filename)) {
+	    werr(71, __func__, "passed filename not a readable file: %s", filename);
+	    return false;
+	}
+	errno = 0;
+	stream = fopen(filename, "r");
+	if (stream == NULL) {
+	    werrp(72, __func__, "couldn't open file %s, ignoring", filename);
+	    return false;
+	}
+    }
+
+    /*
+     * scan the open stream into JSON events
+     */
+    return parse_json_stream_events(stream, filename, cb, data);
+}
+
+
+/*
+ * parse_json_file_push - parse a JSON file with a JSON push parser
+ *
+ * given:
+ *	filename    name of the file to parse, "-" ==> stdin
+ *	chunk	    maximum length of a chunk, 0 ==> BUFSIZ
+ *	cb	    pointer to the JSON event callbacks, or NULL ==> form a JSON parse tree
+ *	data	    data pointer given to each callback
+ *	is_valid    non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * returns:
+ *	pointer to the JSON parse tree when cb is NULL and the JSON is valid, else NULL
+ *
+ * NOTE: This function does not return on NULL is_valid.
+ */
+struct json *
+parse_json_file_push(char const *filename, size_t chunk, struct json_event_cb const *cb, void *data, bool *is_valid)
+{
+    FILE *stream = NULL;		/* file stream to read from */
+
+    /*
+     * firewall
+     */
+    if (is_valid == NULL) {
+	err(73, __func__, "is_valid is NULL");
+	not_reached();
+    }
+    *is_valid = false;
+    if (filename == NULL) {
+	werr(74, __func__, "passed NULL filename");
+	return NULL;
+    }
+    if (*filename == '\0') { /* strlen(filename) == 0 */
+	werr(75, __func__, "passed empty filename");
+	return NULL;
+    }
+
+    /*
+     * if file is "-", then we will parse stdin
+     */
+    if (strcmp(filename, "-") == 0) {
+	stream = stdin;
+
+    /*
+     * case: will read from a file
+     */
+    } else {
+	if (!exists(filename)) {
+	    werr(76, __func__, "passed filename that's not actually a file: %s", filename);
+	    return NULL;
+	}
+	if (!is_file(filename)) {
+	    werr(77, __func__, "passed filename not a normal file: %s", filename);
+	    return NULL;
+	}
+	if (!is_read(filename)) {
+	    werr(78, __func__, "passed filename not a readable file: %s", filename);
+	    return NULL;
+	}
+	errno = 0;
+	stream = fopen(filename, "r");
+	if (stream == NULL) {
+	    werrp(79, __func__, "couldn't open file %s, ignoring", filename);
+	    return NULL;
+	}
+    }
+
+    /*
+     * push each chunk of the open stream
+     */
+    return parse_json_stream_push(stream, filename, chunk, cb, data, is_valid);
+}
+
+
+/*
+ * parse_json_ndjson_record - parse a record of a JSON Lines (NDJSON) file
+ *
+ * This function is like parse_json() except that syntax errors are reported
+ * at the line of the file where the record is, rather than at the line in the
+ * record.
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of the record
+ *	len	    - length of the record
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	line	    - line number of the record in the file, starting at 1
+ *	is_valid    - non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * return:
+ *	pointer to a JSON parse tree
+ *
+ * NOTE: See parse_json() for details on errors.
+ */
+struct json *
+parse_json_ndjson_record(char const *ptr, size_t len, char const *filename, int line, bool *is_valid)
+{
+    /*
+     * scan a copy of the record, after the lines that come before it
+     */
+    return parse_json_scan(ptr, len, filename, is_valid, NULL, line > 1 ? line - 1 : 0);
+}
+
+
+/*
+ * parse_json_ndjson_record_events - parse a record of a JSON Lines (NDJSON) file into JSON events
+ *
+ * This function is like parse_json_events() except that syntax errors are
+ * reported at the line of the file where the record is, rather than at the
+ * line in the record.
+ *
+ * given:
+ *
+ *	ptr	    - pointer to start of the record
+ *	len	    - length of the record
+ *	filename    - filename, empty string or "-" for stdin or NULL to
+ *	              indicate it is a string
+ *	line	    - line number of the record in the file, starting at 1
+ *	cb	    - pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	    - data pointer given to each callback
+ *
+ * return:
+ *	true ==> JSON is valid,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: This function only warns on error.
+ */
+bool
+parse_json_ndjson_record_events(char const *ptr, size_t len, char const *filename, int line,
+				struct json_event_cb const *cb, void *data)
+{
+    /*
+     * scan the record into JSON events, after the lines that come before it
+     */
+    return parse_json_events_scan(ptr, len, filename, line > 1 ? line - 1 : 0, cb, data);
+}
+
+
+/*
+ * hand-written scanner
+ *
+ * The flex scanner runs a table driven DFA over each byte of the JSON.  When
+ * the JSON is in memory the hand-written scanner below is used instead (if
+ * jparse_fast_lex is true): it classifies the first byte of each token with a
+ * lookup table and skips runs of whitespace, newlines and digits in bulk, and
+ * the bodies of JSON strings many bytes at a time with json_string_span().
+ *
+ * The hand-written scanner returns the same tokens, with the same text, as the
+ * flex scanner does: it matches the longest text that a rule of the flex
+ * scanner matches, including the way that JSON_STRING matches up to the last "
+ * that is reached through \" sequences.  It uses the buffer and the text, length
+ * and hold character of the flex scanner, so that jparse_get_text() and
+ * jparse_get_leng() work as before and each token is NUL terminated in the same
+ * way.  Like YY_USER_ACTION for JSON in memory it only tracks the byte offset
+ * of the location: because it splits the JSON into the same tokens,
+ * jparse_locate() uses it (fast_token()) to find the lines and columns of the
+ * tokens, whichever scanner scanned them.
+ */
+
+/*
+ * jparse_fast_lex - true ==> scan JSON in memory with the hand-written scanner
+ *
+ * Compile with -DJPARSE_FAST_LEX to make the hand-written scanner the default.
+ *
+ * NOTE: like the verbosity levels, this is a process wide setting that should
+ *	 be set before any thread parses JSON.
+ */
+#if defined(JPARSE_FAST_LEX)
+bool jparse_fast_lex = true;
+#else
+bool jparse_fast_lex = false;
+#endif
+
+/*
+ * byte classes of the hand-written scanner: the token that a byte starts
+ */
+enum fast_class {
+    FAST_INVALID = 0,	/* invalid token: any other byte */
+    FAST_WS,		/* JSON_WS: [ \t\r] */
+    FAST_NL,		/* JSON_NL: \n */
+    FAST_STRING,	/* JSON_STRING: " */
+    FAST_NUMBER,	/* JSON_NUMBER: - or [0-9] */
+    FAST_TRUE,		/* JSON_TRUE: t */
+    FAST_FALSE,		/* JSON_FALSE: f */
+    FAST_NULL,		/* JSON_NULL: n */
+    FAST_PUNCT,		/* {, }, [, ], : or , */
+};
+
+static unsigned char const fast_class[256] = {
+    ['\t'] = FAST_WS, ['\r'] = FAST_WS, [' '] = FAST_WS,
+    ['\n'] = FAST_NL,
+    ['"'] = FAST_STRING,
+    ['-'] = FAST_NUMBER,
+    ['0'] = FAST_NUMBER, ['1'] = FAST_NUMBER, ['2'] = FAST_NUMBER, ['3'] = FAST_NUMBER, ['4'] = FAST_NUMBER,
+    ['5'] = FAST_NUMBER, ['6'] = FAST_NUMBER, ['7'] = FAST_NUMBER, ['8'] = FAST_NUMBER, ['9'] = FAST_NUMBER,
+    ['t'] = FAST_TRUE, ['f'] = FAST_FALSE, ['n'] = FAST_NULL,
+    ['{'] = FAST_PUNCT, ['}'] = FAST_PUNCT, ['['] = FAST_PUNCT, [']'] = FAST_PUNCT, [':'] = FAST_PUNCT,
+    [','] = FAST_PUNCT,
+};
+
+/*
+ * fast_digit - true ==> byte is [0-9]
+ */
+#define fast_digit(c) ((unsigned char)((c) - '0') < 10)
+
+/*
+ * FAST_IGNORED - fast_token() found whitespace or newlines, which are not tokens
+ */
+#define FAST_IGNORED (-1)
+
+
+/*
+ * fast_token - find the next token of the hand-written scanner
+ *
+ * given:
+ *	p	    first byte of the token, < end
+ *	end	    end of the JSON
+ *	tok	    pointer to the token found
+ *
+ * return:
+ *	the byte after the token, with *tok set to the token, as the flex
+ *	scanner would return it, or to FAST_IGNORED for a run of whitespace or of
+ *	newlines
+ *
+ * NOTE: The JSON must be followed by a NUL byte (as the flex buffer is), so
+ *	 that a run of bytes may be looked at one byte past end.
+ */
+static char *
+fast_token(char *p, char *end, int *tok)
+{
+    char *start = p;			/* first byte of the token */
+    char *quote = NULL;			/* last " of a JSON string */
+
+    switch (fast_class[(unsigned char)*p]) {
+    case FAST_WS:
+	/*
+	 * whitespace (JSON_WS): ignored
+	 */
+	do {
+	    ++p;
+	} while (fast_class[(unsigned char)*p] == FAST_WS && p < end);
+	*tok = FAST_IGNORED;
+	return p;
+
+    case FAST_NL:
+	/*
+	 * newlines (JSON_NL): ignored
+	 */
+	do {
+	    ++p;
+	} while (*p == '\n' && p < end);
+	*tok = FAST_IGNORED;
+	return p;
+
+    case FAST_STRING:
+	/*
+	 * string (JSON_STRING): \"([^"\x01-\x1f]|\\\")*\"
+	 *
+	 * The longest match ends at the last " that is reached: a " ends the
+	 * string unless it follows a \, in which case it may also be part of
+	 * the string.
+	 */
+	for (++p; ; ++p) {
+	    /*
+	     * skip the bytes up to the next ", \ or control byte at once
+	     */
+	    p += json_string_span(p, (size_t)(end - p));
+	    if (p >= end) {
+		break;
+	    } else if (*p == '"') {
+		quote = p;
+		if (p[-1] != '\\') {
+		    break;
+		}
+	    } else if (*p != '\\' && *p != '\0') {
+		break;
+	    }
+	}
+	if (quote == NULL) {
+	    /*
+	     * unterminated: an invalid token of the "
+	     */
+	    *tok = token;
+	    return start + 1;
+	}
+	*tok = JSON_STRING;
+	return quote + 1;
+
+    case FAST_NUMBER:
+	/*
+	 * number (JSON_NUMBER): -?([1-9][0-9]*|0)("."[0-9]+)?([Ee][-+]?[0-9]+)?
+	 */
+	if (*p == '-') {
+	    ++p;
+	}
+	if (*p == '0') {
+	    ++p;
+	} else if (fast_digit(*p) && p < end) {
+	    do {
+		++p;
+	    } while (fast_digit(*p) && p < end);
+	} else {
+	    /*
+	     * a - that does not start a number: an invalid token of the -
+	     */
+	    *tok = token;
+	    return start + 1;
+	}
+	if (*p == '.' && p + 1 < end && fast_digit(p[1])) {
+	    p += 2;
+	    while (fast_digit(*p) && p < end) {
+		++p;
+	    }
+	}
+	if ((*p == 'e' || *p == 'E') && p < end) {
+	    quote = p + 1;
+	    if ((*quote == '-' || *quote == '+') && quote < end) {
+		++quote;
+	    }
+	    if (fast_digit(*quote) && quote < end) {
+		p = quote + 1;
+		while (fast_digit(*p) && p < end) {
+		    ++p;
+		}
+	    }
+	}
+	*tok = JSON_NUMBER;
+	return p;
+
+    case FAST_TRUE:
+	/*
+	 * true (JSON_TRUE)
+	 */
+	if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+	    *tok = JSON_TRUE;
+	    return p + 4;
+	}
+	break;
+
+    case FAST_FALSE:
+	/*
+	 * false (JSON_FALSE)
+	 */
+	if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+	    *tok = JSON_FALSE;
+	    return p + 5;
+	}
+	break;
+
+    case FAST_NULL:
+	/*
+	 * null object (JSON_NULL)
+	 */
+	if (end - p >= 4 && memcmp(p, "null", 4) == 0) {
+	    *tok = JSON_NULL;
+	    return p + 4;
+	}
+	break;
+
+    case FAST_PUNCT:
+	/*
+	 * {, }, [, ], : or ,
+	 */
+	switch (*p) {
+	case '{':
+	    *tok = JSON_OPEN_BRACE;
+	    break;
+	case '}':
+	    *tok = JSON_CLOSE_BRACE;
+	    break;
+	case '[':
+	    *tok = JSON_OPEN_BRACKET;
+	    break;
+	case ']':
+	    *tok = JSON_CLOSE_BRACKET;
+	    break;
+	case ':':
+	    *tok = JSON_COLON;
+	    break;
+	default:
+	    *tok = JSON_COMMA;
+	    break;
+	}
+	return p + 1;
+
+    default:
+	break;
+    }
+
+    /*
+     * invalid token: any other byte
+     */
+    *tok = token;
+    return p + 1;
+}
+
+
+/*
+ * jparse_fast_scan - hand-written scanner: return the next token
+ *
+ * given:
+ *	lloc	    location of the token
+ *	yyscanner   scanner instance, scanning a buffer in memory
+ *
+ * return:
+ *	the next token, as the flex scanner would return it, or JPARSE_EOF
+ *
+ * NOTE: See the comment above jparse_fast_lex.
+ */
+static int
+jparse_fast_scan(JPARSE_LTYPE *lloc, yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;	/* flex scanner state */
+    char *buf = YY_CURRENT_BUFFER_LVALUE->yy_ch_buf;		/* start of the JSON */
+    char *end = buf + yyg->yy_n_chars;				/* end of the JSON */
+    char *p = yyg->yy_c_buf_p;		/* current byte */
+    char *start = NULL;			/* first byte of the current token */
+    int tok = JPARSE_EOF;		/* token to return */
+
+    /*
+     * restore the byte after the previous token, as the flex scanner does
+     */
+    *p = yyg->yy_hold_char;
+
+    /*
+     * find the next token, skipping whitespace and newlines
+     */
+    for (start = p; p < end; start = p) {
+	p = fast_token(p, end, &tok);
+	if (tok != FAST_IGNORED) {
+	    break;
+	}
+	if (*start != '\n' && json_dbg_allowed(JSON_DBG_VVHIGH)) {
+	    (void) json_dbg(JSON_DBG_VVHIGH, __func__, "\nignoring %d whitespace%s\n",
+			    (int)(p - start), p - start == 1 ? "":"s");
+	}
+	tok = JPARSE_EOF;
+    }
+
+    /*
+     * set the text of the token, as YY_DO_BEFORE_ACTION does: at the end of
+     * the JSON the text is empty
+     */
+    yyg->yytext_ptr = start;
+    yyleng = (int)(p - start);
+    yyg->yy_hold_char = *p;
+    *p = '\0';
+    yyg->yy_c_buf_p = p;
+
+    /*
+     * the location is only the byte offset, see jparse_locate()
+     */
+    lloc->last_byte = (size_t)(p - buf);
+    if (tok == token && dbg_allowed(DBG_LOW)) {
+	jparse_locate(lloc, yyscanner);
+	dbg(DBG_LOW, "at line %d column %d: invalid token: 0x%02x = <%c>", lloc->first_line,
+	    lloc->first_column, *start, *start);
+    }
+    return tok;
+}
+
+
+/*
+ * jparse_loc_token - locate a token
+ *
+ * This is what YY_USER_ACTION once did for every token: see the comment above
+ * YY_USER_ACTION.
+ *
+ * given:
+ *	lloc	    location of the previous token, to set to the token's
+ *	extra	    extra data of the scanner or NULL
+ *	text	    text of the token
+ *	len	    length of the token
+ */
+static void
+jparse_loc_token(JPARSE_LTYPE *lloc, struct json_extra const *extra, char const *text, size_t len)
+{
+    char const *p;		/* current byte of the token */
+
+    lloc->filename = extra != NULL ? extra->filename : "";
+    lloc->first_line = lloc->last_line + 1;
+    lloc->first_column = lloc->last_column;
+    for (p = text; p < text + len && *p; ++p) {
+	if (*p == '\n') {
+	    lloc->last_line++;
+	    lloc->last_column = 0;
+	} else if (*p == '\t') {
+	    lloc->last_column += 8;
+	} else {
+	    if (lloc->first_column == 0 || lloc->last_column == 0) {
+		if (lloc->first_column == 0) {
+		    lloc->first_column = 1;
+		}
+		if (lloc->last_column == 0) {
+		    lloc->last_column = 1;
+		}
+	    } else {
+		lloc->last_column++;
+		lloc->first_column++;
+	    }
+	}
+    }
+}
+
+
+/*
+ * jparse_locate - compute the line and column of the last token scanned
+ *
+ * When the JSON is in memory the scanners only track the byte offset of the
+ * end of the last token scanned, lloc->last_byte.  This function locates the
+ * tokens from lloc->loc_byte, where it last stopped (or the start of the JSON),
+ * to lloc->last_byte, splitting the JSON into tokens with fast_token() and
+ * locating each with jparse_loc_token(), so that the lines and columns of lloc
+ * are what they would be had every token been located as it was scanned.
+ *
+ * given:
+ *	lloc	    location of the last token scanned
+ *	scanner	    scanner instance
+ *
+ * NOTE: For JSON scanned from a stream every token is located as it is
+ *	 scanned and this function does nothing.
+ */
+void
+jparse_locate(JPARSE_LTYPE *lloc, yyscan_t scanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)scanner;	/* flex scanner state */
+    struct json_extra const *extra = NULL;	/* extra data of the scanner */
+    char *buf = NULL;			/* start of the JSON */
+    char *end = NULL;			/* end of the JSON */
+    char *p = NULL;			/* first byte of the token to locate */
+    char *next = NULL;			/* byte after the token to locate */
+    int tok = 0;			/* token found (not used) */
+
+    /*
+     * firewall
+     */
+    if (lloc == NULL || scanner == NULL) {
+	return;
+    }
+    extra = yyextra;
+    if (extra == NULL || !extra->lazy_loc || lloc->loc_byte >= lloc->last_byte ||
+	YY_CURRENT_BUFFER == NULL || lloc->last_byte > (size_t)yyg->yy_n_chars) {
+	return;
+    }
+    buf = YY_CURRENT_BUFFER_LVALUE->yy_ch_buf;
+    end = buf + yyg->yy_n_chars;
+
+    /*
+     * put back the byte after the last token, which the scanner replaced with
+     * a NUL byte, so that the tokens are found as they were scanned
+     */
+    *yyg->yy_c_buf_p = yyg->yy_hold_char;
+
+    /*
+     * locate each token since the last time
+     */
+    for (p = buf + lloc->loc_byte; p < buf + lloc->last_byte; p = next) {
+	next = fast_token(p, end, &tok);
+	jparse_loc_token(lloc, extra, p, (size_t)(next - p));
+    }
+    lloc->loc_byte = lloc->last_byte;
+
+    /*
+     * NUL terminate the text of the last token again
+     */
+    *yyg->yy_c_buf_p = '\0';
+}
+
+
+/*
+ * jparse_lex - return the next token to the parser
+ *
+ * given:
+ *	yylval_param	semantic value (not used by the scanner)
+ *	yylloc_param	location of the token
+ *	yyscanner	scanner instance
+ *
+ * return:
+ *	the next token
+ *
+ * NOTE: The hand-written scanner, jparse_fast_scan(), is used when the extra
+ *	 data of the scanner says so, which parse_json() and friends do when
+ *	 jparse_fast_lex is true and the JSON is in memory, and otherwise the
+ *	 flex scanner, jparse_flex_lex(), is used.
+ */
+int
+jparse_lex(JPARSE_STYPE *yylval_param, JPARSE_LTYPE *yylloc_param, yyscan_t yyscanner)
+{
+    struct json_extra const *extra = jparse_get_extra(yyscanner);	/* extra data of the scanner */
+
+    if (extra != NULL && extra->fast_lex) {
+	return jparse_fast_scan(yylloc_param, yyscanner);
+    }
+    return jparse_flex_lex(yylval_param, yylloc_param, yyscanner);
+}
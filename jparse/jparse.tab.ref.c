@@ -128,7 +128,7 @@
 #define yynerrs         jparse_nerrs
 
 /* First part of user prologue.  */
-#line 79 "./jparse.y"
+#line 96 "./jparse.y"
 
 
 /*
@@ -584,9 +584,9 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,   237,   237,   295,   326,   357,   388,   419,   454,   488,
-     524,   555,   585,   619,   658,   694,   725,   755,   789,   827,
-     860,   902
+       0,   256,   256,   314,   345,   376,   407,   438,   473,   507,
+     543,   574,   604,   638,   677,   713,   744,   774,   808,   846,
+     879,   921
 };
 #endif
 
@@ -1333,6 +1333,19 @@ YYLTYPE yylloc = yyloc_default;
 
   yychar = JPARSE_EMPTY; /* Cause a token to be read.  */
 
+
+/* User initialization code.  */
+#line 89 "./jparse.y"
+{
+    struct json_extra *extra = jparse_get_extra(scanner);
+
+    if (extra != NULL) {
+	yylloc.last_line = extra->line_offset;
+    }
+}
+
+#line 1294 "jparse.tab.c"
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
@@ -1549,7 +1562,7 @@ yyreduce:
     switch (yyn)
       {
   case 2: /* json: json_element  */
-#line 238 "./jparse.y"
+#line 257 "./jparse.y"
     {
 	/*
 	 * $$ = $json
@@ -1603,11 +1616,11 @@ yyreduce:
 					      "json: json_element");
 	}
     }
-#line 1553 "jparse.tab.c"
+#line 1566 "jparse.tab.c"
     break;
 
   case 3: /* json_value: json_object  */
-#line 296 "./jparse.y"
+#line 315 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1636,11 +1649,11 @@ yyreduce:
 					       "json_value: json_object");
 	}
     }
-#line 1586 "jparse.tab.c"
+#line 1599 "jparse.tab.c"
     break;
 
   case 4: /* json_value: json_array  */
-#line 327 "./jparse.y"
+#line 346 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1669,11 +1682,11 @@ yyreduce:
 					       "json_value: json_array");
 	}
     }
-#line 1619 "jparse.tab.c"
+#line 1632 "jparse.tab.c"
     break;
 
   case 5: /* json_value: json_string  */
-#line 358 "./jparse.y"
+#line 377 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1702,11 +1715,11 @@ yyreduce:
 					       "json_value: json_string");
 	}
     }
-#line 1652 "jparse.tab.c"
+#line 1665 "jparse.tab.c"
     break;
 
   case 6: /* json_value: json_number  */
-#line 389 "./jparse.y"
+#line 408 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1735,11 +1748,11 @@ yyreduce:
 					       "json_value: json_number");
 	}
     }
-#line 1685 "jparse.tab.c"
+#line 1698 "jparse.tab.c"
     break;
 
   case 7: /* json_value: "true"  */
-#line 420 "./jparse.y"
+#line 439 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1772,11 +1785,11 @@ yyreduce:
 					       "json_value: JSON_TRUE");
 	}
     }
-#line 1722 "jparse.tab.c"
+#line 1735 "jparse.tab.c"
     break;
 
   case 8: /* json_value: "false"  */
-#line 455 "./jparse.y"
+#line 474 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1808,11 +1821,11 @@ yyreduce:
 					     "json_value: JSON_FALSE");
 	}
     }
-#line 1758 "jparse.tab.c"
+#line 1771 "jparse.tab.c"
     break;
 
   case 9: /* json_value: "null"  */
-#line 489 "./jparse.y"
+#line 508 "./jparse.y"
     {
 	/*
 	 * $$ = $json_value
@@ -1844,11 +1857,11 @@ yyreduce:
 					       "json_value: JSON_NULL");
 	}
     }
-#line 1794 "jparse.tab.c"
+#line 1807 "jparse.tab.c"
     break;
 
   case 10: /* json_object: "{" json_members "}"  */
-#line 525 "./jparse.y"
+#line 544 "./jparse.y"
     {
 	/*
 	 * $$ = $json_object
@@ -1877,11 +1890,11 @@ yyreduce:
 					       "json_object: JSON_OPEN_BRACE json_members JSON_CLOSE_BRACE");
 	}
     }
-#line 1827 "jparse.tab.c"
+#line 1840 "jparse.tab.c"
     break;
 
   case 11: /* json_object: "{" "}"  */
-#line 556 "./jparse.y"
+#line 575 "./jparse.y"
     {
 	/*
 	 * $$ = $json_object
@@ -1907,11 +1920,11 @@ yyreduce:
 					       "json_object: JSON_OPEN_BRACE JSON_CLOSE_BRACE");
 	}
     }
-#line 1857 "jparse.tab.c"
+#line 1870 "jparse.tab.c"
     break;
 
   case 12: /* json_members: json_member  */
-#line 586 "./jparse.y"
+#line 605 "./jparse.y"
     {
 	/*
 	 * $$ = $json_members
@@ -1943,11 +1956,11 @@ yyreduce:
 					      "json_members: json_member");
 	}
     }
-#line 1893 "jparse.tab.c"
+#line 1906 "jparse.tab.c"
     break;
 
   case 13: /* json_members: json_members "," json_member  */
-#line 620 "./jparse.y"
+#line 639 "./jparse.y"
     {
 	/*
 	 * $$ = $json_members
@@ -1982,11 +1995,11 @@ yyreduce:
 					       "json_members: json_members JSON_COMMA json_member");
 	}
     }
-#line 1932 "jparse.tab.c"
+#line 1945 "jparse.tab.c"
     break;
 
   case 14: /* json_member: json_string ":" json_element  */
-#line 659 "./jparse.y"
+#line 678 "./jparse.y"
     {
 	/*
 	 * $$ = $json_member
@@ -2018,11 +2031,11 @@ yyreduce:
 					       "json_member: json_string JSON_COLON json_element");
 	}
     }
-#line 1968 "jparse.tab.c"
+#line 1981 "jparse.tab.c"
     break;
 
   case 15: /* json_array: "[" json_elements "]"  */
-#line 695 "./jparse.y"
+#line 714 "./jparse.y"
     {
 	/*
 	 * $$ = $json_array
@@ -2051,11 +2064,11 @@ yyreduce:
 					       "json_array: JSON_OPEN_BRACKET json_elements JSON_CLOSE_BRACKET");
 	}
     }
-#line 2001 "jparse.tab.c"
+#line 2014 "jparse.tab.c"
     break;
 
   case 16: /* json_array: "[" "]"  */
-#line 726 "./jparse.y"
+#line 745 "./jparse.y"
     {
 	/*
 	 * $$ = $json_array
@@ -2081,11 +2094,11 @@ yyreduce:
 					       "json_array: JSON_OPEN_BRACKET JSON_CLOSE_BRACKET");
 	}
     }
-#line 2031 "jparse.tab.c"
+#line 2044 "jparse.tab.c"
     break;
 
   case 17: /* json_elements: json_element  */
-#line 756 "./jparse.y"
+#line 775 "./jparse.y"
     {
 	/*
 	 * $$ = $json_elements
@@ -2117,11 +2130,11 @@ yyreduce:
 					       "json_elements: json_element");
 	}
     }
-#line 2067 "jparse.tab.c"
+#line 2080 "jparse.tab.c"
     break;
 
   case 18: /* json_elements: json_elements "," json_element  */
-#line 790 "./jparse.y"
+#line 809 "./jparse.y"
     {
 	/*
 	 * $$ = $json_elements
@@ -2155,11 +2168,11 @@ yyreduce:
 					       "json_elements: json_elements JSON_COMMA json_element");
 	}
     }
-#line 2105 "jparse.tab.c"
+#line 2118 "jparse.tab.c"
     break;
 
   case 19: /* json_element: json_value  */
-#line 828 "./jparse.y"
+#line 847 "./jparse.y"
     {
 	/*
 	 * $$ = $json_element
@@ -2188,11 +2201,11 @@ yyreduce:
 					       "json_element: json_value");
 	}
     }
-#line 2138 "jparse.tab.c"
+#line 2151 "jparse.tab.c"
     break;
 
   case 20: /* json_string: JSON_STRING  */
-#line 861 "./jparse.y"
+#line 880 "./jparse.y"
     {
 	/*
 	 * $$ = $json_string
@@ -2230,11 +2243,11 @@ yyreduce:
 					       "json_string: JSON_STRING");
 	}
     }
-#line 2180 "jparse.tab.c"
+#line 2193 "jparse.tab.c"
     break;
 
   case 21: /* json_number: JSON_NUMBER  */
-#line 903 "./jparse.y"
+#line 922 "./jparse.y"
     {
 	/*
 	 * $$ = $json_number
@@ -2266,11 +2279,11 @@ yyreduce:
 					       "json_number: JSON_NUMBER");
 	}
     }
-#line 2216 "jparse.tab.c"
+#line 2229 "jparse.tab.c"
     break;
 
 
-#line 2220 "jparse.tab.c"
+#line 2233 "jparse.tab.c"
 
         default: break;
       }
@@ -2477,7 +2490,7 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 937 "./jparse.y"
+#line 956 "./jparse.y"
 
 
 
@@ -2519,12 +2532,20 @@ yyerror(JPARSE_LTYPE *yyltype, struct json **node, yyscan_t scanner, char const
 
     /*
      * generate an error message for the JSON parser and scanner
+     *
+     * NOTE: stderr is locked so that the message is written at once, even
+     *	     when other threads are parsing and reporting errors too.
      */
+    flockfile(stderr);
     vfpr(stderr, __func__, format, ap);
     if (node != NULL && *node != NULL) {
 	fprint(stderr, " node type %s", json_item_type_name(*node));
     }
     if (yyltype != NULL) {
+	    /*
+	     * compute the line and column of the token, see jparse_locate()
+	     */
+	    jparse_locate(yyltype, scanner);
 	    if (yyltype->filename != NULL && *yyltype->filename != '\0') {
 		fprint(stderr, " in file %s", yyltype->filename);
 	    }
@@ -2553,6 +2574,7 @@ yyerror(JPARSE_LTYPE *yyltype, struct json **node, yyscan_t scanner, char const
             warnp(__func__, "called from %s: unexpected fflush error while flushing stream", __func__);
         }
     }
+    funlockfile(stderr);
 
     /*
      * stdarg variable argument list clean up
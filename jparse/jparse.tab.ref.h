@@ -107,7 +107,7 @@
 extern int jparse_debug;
 #endif
 /* "%code requires" blocks.  */
-#line 123 "./jparse.y"
+#line 140 "./jparse.y"
 
     #if !defined(JPARSE_LTYPE_IS_DECLARED)
     struct JPARSE_LTYPE
@@ -117,6 +117,8 @@ extern int jparse_debug;
 	int last_line;
 	int last_column;
 	char const *filename;
+	size_t last_byte;	/* byte offset of the end of the last token scanned */
+	size_t loc_byte;	/* byte offset up to which lines and columns are computed */
     };
     typedef struct JPARSE_LTYPE JPARSE_LTYPE;
     #define JPARSE_LTYPE_IS_DECLARED 1
@@ -144,7 +146,7 @@ extern int jparse_debug;
     typedef void * yyscan_t;
 
 
-#line 94 "jparse.tab.h"
+#line 96 "jparse.tab.h"
 
 /* Token kinds.  */
 #ifndef JPARSE_TOKENTYPE
@@ -198,7 +200,7 @@ struct JPARSE_LTYPE
 int jparse_parse (struct json **tree, yyscan_t scanner);
 
 /* "%code provides" blocks.  */
-#line 115 "./jparse.y"
+#line 132 "./jparse.y"
 
 #ifndef YY_DECL
 #define YY_DECL int jparse_lex(JPARSE_STYPE *yylval_param, JPARSE_LTYPE *yylloc_param, yyscan_t yyscanner)
@@ -206,6 +208,6 @@ int jparse_parse (struct json **tree, yyscan_t scanner);
 YY_DECL;
 #endif
 
-#line 156 "jparse.tab.h"
+#line 158 "jparse.tab.h"
 
 #endif /* !YY_JPARSE_JPARSE_TAB_H_INCLUDED  */
@@ -76,6 +76,23 @@
  *	%param { yyscan_t scanner }
  */
 %param { yyscan_t scanner }
+
+/*
+ * Start the location after the lines that come before the JSON in its file,
+ * for instance the previous records of a JSON Lines (NDJSON) file, so that
+ * error messages report the line in the file (see YY_USER_ACTION in
+ * jparse.l):
+ *
+ *	%initial-action { ... }
+ */
+%initial-action
+{
+    struct json_extra *extra = jparse_get_extra(scanner);
+
+    if (extra != NULL) {
+	@$.last_line = extra->line_offset;
+    }
+}
 %{
 
 /*
@@ -129,6 +146,8 @@ YY_DECL;
 	int last_line;
 	int last_column;
 	char const *filename;
+	size_t last_byte;	/* byte offset of the end of the last token scanned */
+	size_t loc_byte;	/* byte offset up to which lines and columns are computed */
     };
     typedef struct JPARSE_LTYPE JPARSE_LTYPE;
     #define JPARSE_LTYPE_IS_DECLARED 1
@@ -975,12 +994,20 @@ yyerror(JPARSE_LTYPE *yyltype, struct json **node, yyscan_t scanner, char const
 
     /*
      * generate an error message for the JSON parser and scanner
+     *
+     * NOTE: stderr is locked so that the message is written at once, even
+     *	     when other threads are parsing and reporting errors too.
      */
+    flockfile(stderr);
     vfpr(stderr, __func__, format, ap);
     if (node != NULL && *node != NULL) {
 	fprint(stderr, " node type %s", json_item_type_name(*node));
     }
     if (yyltype != NULL) {
+	    /*
+	     * compute the line and column of the token, see jparse_locate()
+	     */
+	    jparse_locate(yyltype, scanner);
 	    if (yyltype->filename != NULL && *yyltype->filename != '\0') {
 		fprint(stderr, " in file %s", yyltype->filename);
 	    }
@@ -1009,6 +1036,7 @@ yyerror(JPARSE_LTYPE *yyltype, struct json **node, yyscan_t scanner, char const
             warnp(__func__, "called from %s: unexpected fflush error while flushing stream", __func__);
         }
     }
+    funlockfile(stderr);
 
     /*
      * stdarg variable argument list clean up
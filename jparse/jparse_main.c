@@ -48,6 +48,8 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <locale.h>
+#include <errno.h>
+#include <time.h>
 
 /*
  * jparse_main - tool that parses a block of JSON input
@@ -59,12 +61,14 @@
  * definitions
  */
 #define REQUIRED_ARGS (1)	/* number of required arguments on the command line */
+#define JPARSE_POOL_MAX_WORKERS (1024)	/* maximum number of -W workers */
 
 /*
  * usage message
  */
 static const char * const usage_msg =
-    "usage: %s [-h] [-v level] [-J level] [-q] [-V] [-s] arg...\n"
+    "usage: %s [-h] [-v level] [-J level] [-q] [-V] [-s] [-A] [-z] [-E] [-P chunk] [-W workers] [-N] [-F]\n"
+    "\t\t[-o snapfile] [-m] arg...\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
     "\t-v level\tset verbosity level (def level: %d)\n"
@@ -72,8 +76,20 @@ static const char * const usage_msg =
     "\t-q\t\tquiet mode: silence msg(), warn(), warnp() if -v 0 (def: loud :-) )\n"
     "\t-V\t\tprint version strings and exit\n"
     "\t-s\t\targ is a string (def: arg is a filename)\n"
+    "\t-A\t\tallocate each JSON parse tree from a single arena (def: allocate each node)\n"
+    "\t-z\t\tscan arg in place, strings and numbers reference it (implies -A) (def: copy tokens)\n"
+    "\t-E\t\tvalidate with JSON events, in constant memory, w/o forming a JSON parse tree\n"
+    "\t-P chunk\tpush arg to an incremental parser, chunk bytes at a time (def: parse arg at once)\n"
+    "\t-W workers\tparse file args on a pool of workers (0 ==> one per CPU), report each in order (def: one at a time)\n"
+    "\t-N\t\targ is JSON Lines (NDJSON): validate and report each line as a JSON document\n"
+    "\t-F\t\tscan JSON in memory with the hand-written scanner (def: scan with the flex scanner)\n"
+    "\t-o snapfile\twrite a binary snapshot of the JSON parse tree of the only arg to snapfile\n"
+    "\t-m\t\targ is a binary snapshot to load (def: arg is JSON)\n"
     "\n"
     "\targ\t\tparse JSON for string (if -s), file (w/o -s), or stdin (if arg is -)\n"
+    "\t\t\twith -W, a directory arg is walked for files ending in .json\n"
+    "\t\t\twith -N, -W parses the records of each file arg on the pool of workers\n"
+    "\t\t\twith -m, load the snapshot in file arg, as written by -o\n"
     "\n"
     "Exit codes:\n"
     "    0\tJSON is valid\n"
@@ -88,9 +104,27 @@ static const char * const usage_msg =
     "jparse library version: %s";
 
 
+/*
+ * JSON event callbacks of -P -E: none, only validate
+ */
+static struct json_event_cb const validate_cb = {
+    NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+
+
 /*
  * static functions
  */
+static int pool_fts_cmp(const FTSENT **a, const FTSENT **b);
+static void pool_add_path(struct dyn_array *paths, char const *path);
+static bool pool_parse_file(struct jparse_pool const *pool, char const *path);
+static void *pool_worker(void *arg);
+static intmax_t pool_run(struct jparse_pool *pool, uintmax_t workers, uintmax_t *bytes);
+static int parse_files_pool(char const *program, char **args, int arg_count, struct jparse_pool *pool,
+			    uintmax_t workers);
+static bool ndjson_parse_record(bool events, char const *rec, size_t len, char const *filename, int line);
+static int parse_files_ndjson(char const *program, char **args, int arg_count, struct jparse_pool *pool,
+			      bool pool_flag_used, uintmax_t workers);
 static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
 
 
@@ -102,6 +136,20 @@ main(int argc, char **argv)
     extern int optind;		    /* argv index of the next arg */
     char *input = NULL;		    /* argument to process */
     bool string_flag_used = false;  /* true ==> -S string was used */
+    bool arena_flag_used = false;   /* true ==> -A was used */
+    bool zero_copy_flag_used = false; /* true ==> -z was used */
+    bool event_flag_used = false;   /* true ==> -E was used */
+    bool push_flag_used = false;    /* true ==> -P was used */
+    bool pool_flag_used = false;    /* true ==> -W was used */
+    bool ndjson_flag_used = false;  /* true ==> -N was used */
+    bool snap_flag_used = false;    /* true ==> -m was used */
+    char const *snapfile = NULL;    /* -o snapshot file to write or NULL */
+    uintmax_t chunk = 0;	    /* -P chunk length */
+    uintmax_t workers = 0;	    /* -W number of workers, 0 ==> one per CPU */
+    struct jparse_pool pool;	    /* -W worker pool */
+    struct jparse_push *push = NULL; /* -P -s JSON push parser */
+    size_t len = 0;		    /* -P -s length of arg */
+    size_t off = 0;		    /* -P -s offset of the next chunk of arg */
     bool valid_json = false;	    /* true ==> JSON parse was valid */
     int exit_code = 0;              /* exit code depends on if any JSON is invalid */
     struct json *tree = NULL;	    /* JSON parse tree or NULL */
@@ -117,7 +165,7 @@ main(int argc, char **argv)
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:qVsJ:")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:qVsJ:AzEP:W:NFo:m")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 0 */
 	    usage(2, program, ""); /*ooo*/
@@ -157,6 +205,44 @@ main(int argc, char **argv)
 	case 's':
 	    string_flag_used = true;
 	    break;
+	case 'A':
+	    arena_flag_used = true;
+	    break;
+	case 'z':
+	    zero_copy_flag_used = true;
+	    arena_flag_used = true;
+	    break;
+	case 'E':
+	    event_flag_used = true;
+	    break;
+	case 'P':		/* -P chunk - push arg to an incremental parser */
+	    if (!string_to_uintmax(optarg, &chunk) || chunk == 0 || chunk > SIZE_MAX) {
+		usage(3, program, "invalid -P chunk"); /*ooo*/
+		not_reached();
+	    }
+	    push_flag_used = true;
+	    break;
+	case 'W':		/* -W workers - parse file args on a pool of workers */
+	    if (strcmp(optarg, "0") == 0) {
+		workers = 0;	/* one per CPU */
+	    } else if (!string_to_uintmax(optarg, &workers) || workers > JPARSE_POOL_MAX_WORKERS) {
+		usage(3, program, "invalid -W workers"); /*ooo*/
+		not_reached();
+	    }
+	    pool_flag_used = true;
+	    break;
+	case 'N':
+	    ndjson_flag_used = true;
+	    break;
+	case 'F':		/* -F - scan JSON in memory with the hand-written scanner */
+	    jparse_fast_lex = true;
+	    break;
+	case 'o':		/* -o snapfile - write a binary snapshot of the JSON parse tree */
+	    snapfile = optarg;
+	    break;
+	case 'm':		/* -m - args are binary snapshots to load */
+	    snap_flag_used = true;
+	    break;
 	case ':':   /* option requires an argument */
 	case '?':   /* illegal option */
 	default:    /* anything else but should not actually happen */
@@ -174,11 +260,53 @@ main(int argc, char **argv)
 	usage(3, program, "wrong number of arguments"); /*ooo*/
 	not_reached();
     }
+    if (pool_flag_used == true && string_flag_used == true) {
+	usage(3, program, "-W cannot be used with -s"); /*ooo*/
+	not_reached();
+    }
+    if (ndjson_flag_used == true && (string_flag_used || arena_flag_used || push_flag_used)) {
+	usage(3, program, "-N cannot be used with -s, -A, -z or -P"); /*ooo*/
+	not_reached();
+    }
+    if (snapfile != NULL && (event_flag_used || push_flag_used || pool_flag_used || ndjson_flag_used || snap_flag_used)) {
+	usage(3, program, "-o cannot be used with -E, -P, -W, -N or -m"); /*ooo*/
+	not_reached();
+    }
+    if (snapfile != NULL && argc - optind != 1) {
+	usage(3, program, "-o requires exactly one arg"); /*ooo*/
+	not_reached();
+    }
+    if (snap_flag_used == true &&
+	(string_flag_used || arena_flag_used || event_flag_used || push_flag_used || pool_flag_used || ndjson_flag_used)) {
+	usage(3, program, "-m cannot be used with -s, -A, -z, -E, -P, -W or -N"); /*ooo*/
+	not_reached();
+    }
+
+    /*
+     * case: -N - validate each record of JSON Lines (NDJSON) file arguments
+     */
+    if (ndjson_flag_used == true) {
+	memset(&pool, 0, sizeof(pool));
+	pool.events = event_flag_used;
+	pool.ndjson = true;
+	exit_code = parse_files_ndjson(program, argv + optind, argc - optind, &pool, pool_flag_used, workers);
+
+    /*
+     * case: -W - parse file arguments on a pool of workers
+     */
+    } else if (pool_flag_used == true) {
+	memset(&pool, 0, sizeof(pool));
+	pool.arena = arena_flag_used;
+	pool.zero_copy = zero_copy_flag_used;
+	pool.events = event_flag_used;
+	pool.push = push_flag_used;
+	pool.chunk = (size_t)chunk;
+	exit_code = parse_files_pool(program, argv + optind, argc - optind, &pool, workers);
 
     /*
      * case: process arguments on command line
      */
-    if (argc - optind > 0) {
+    } else if (argc - optind > 0) {
 	/*
 	 * process each argument in order
 	 */
@@ -187,16 +315,87 @@ main(int argc, char **argv)
 	     * obtain argument string
 	     */
 	    input = argv[i];
+            /*
+             * case: -m - load arg as a binary snapshot
+             */
+            if (snap_flag_used == true) {
+
+                dbg(DBG_HIGH, "Calling json_snap_load(\"%s\", &valid_json):", input);
+                tree = json_snap_load(input, &valid_json);
+                if (tree == NULL || !valid_json) {
+                    warn(program, "snapshot is not valid: %s", input);
+                    exit_code = 1;
+                } else {
+                    json_tree_free(tree, JSON_INFINITE_DEPTH);
+                    free(tree);
+                    tree = NULL;
+                }
+
+            /*
+             * case: -P - push arg to an incremental parser, a chunk at a time
+             */
+            } else if (push_flag_used == true) {
+
+                if (string_flag_used == true) {
+                    dbg(DBG_HIGH, "Calling jparse_push_feed() on %s in chunks of %ju bytes:", input, chunk);
+                    push = jparse_push_create(NULL, event_flag_used ? &validate_cb : NULL, NULL);
+                    len = strlen(input);
+                    for (off = 0; off < len; off += (size_t)chunk) {
+                        if (!jparse_push_feed(push, input + off, len - off < chunk ? len - off : (size_t)chunk)) {
+                            break;
+                        }
+                    }
+                    tree = jparse_push_finish(push, &valid_json);
+                    push = NULL;
+                } else {
+                    dbg(DBG_HIGH, "Calling parse_json_file_push(\"%s\", %ju, ...):", input, chunk);
+                    tree = parse_json_file_push(input, (size_t)chunk, event_flag_used ? &validate_cb : NULL,
+                                                NULL, &valid_json);
+                }
+                if (!valid_json || (tree == NULL && !event_flag_used)) {
+                    warn(program, "JSON is not valid for %s: %s", string_flag_used ? "string" : "file", input);
+                    exit_code = 1;
+                }
+                if (tree != NULL) {
+                    json_tree_free(tree, JSON_INFINITE_DEPTH);
+                    free(tree);
+                    tree = NULL;
+                }
+
+            /*
+             * case: -E - validate arg with JSON events
+             */
+            } else if (event_flag_used == true) {
+
+                if (string_flag_used == true) {
+                    dbg(DBG_HIGH, "Calling parse_json_events(%s, %zu, NULL, NULL, NULL):",
+                                  input, strlen(input));
+                    valid_json = parse_json_events(input, strlen(input), NULL, NULL, NULL);
+                } else {
+                    dbg(DBG_HIGH, "Calling parse_json_file_events(\"%s\", NULL, NULL):", input);
+                    valid_json = parse_json_file_events(input, NULL, NULL);
+                }
+                if (!valid_json) {
+                    warn(program, "JSON is not valid for %s: %s", string_flag_used ? "string" : "file", input);
+                    exit_code = 1;
+                }
+
             /*
              * case: process -s arg
              */
-            if (string_flag_used == true) {
+            } else if (string_flag_used == true) {
 
                 /* parse arg as a block of json input */
                 dbg(DBG_HIGH, "Calling parse_json_str(%s, %zu, &valid_json):",
                               input, strlen(input));
 
-                tree = parse_json_str(input, strlen(input), &valid_json);
+                if (zero_copy_flag_used == true) {
+                    tree = parse_json_zero_copy(input, strlen(input), NULL, &valid_json);
+                } else if (arena_flag_used == true) {
+                    tree = parse_json_arena(input, strlen(input), NULL, &valid_json);
+                } else {
+                    tree = parse_json_str(input, strlen(input), &valid_json);
+                }
                 if (tree == NULL || !valid_json) {
                     warn(program, "JSON parse tree is NULL for string: \"%s\"", input);
                     exit_code = 1;
@@ -205,6 +404,10 @@ main(int argc, char **argv)
                  * free the JSON parse tree
                  */
                 else {
+                    if (snapfile != NULL && !json_snap_write(tree, snapfile)) {
+                        err(22, program, "cannot write snapshot: %s", snapfile); /*ooo*/
+                        not_reached();
+                    }
                     json_tree_free(tree, JSON_INFINITE_DEPTH);
                     free(tree);
                     tree = NULL;
@@ -218,7 +421,13 @@ main(int argc, char **argv)
                 /* parse arg as a json filename */
                 dbg(DBG_HIGH, "Calling parse_json_file(\"%s\", &valid_json):", input);
 
-                tree = parse_json_file(input, &valid_json);
+                if (zero_copy_flag_used == true) {
+                    tree = parse_json_file_zero_copy(input, &valid_json);
+                } else if (arena_flag_used == true) {
+                    tree = parse_json_file_arena(input, &valid_json);
+                } else {
+                    tree = parse_json_file(input, &valid_json);
+                }
                 if (tree == NULL || !valid_json) {
                     warn(program, "JSON parse tree is NULL for file: %s", input);
                     exit_code = 1;
@@ -227,6 +436,10 @@ main(int argc, char **argv)
                  * free the JSON parse tree
                  */
                 else {
+                    if (snapfile != NULL && !json_snap_write(tree, snapfile)) {
+                        err(22, program, "cannot write snapshot: %s", snapfile); /*ooo*/
+                        not_reached();
+                    }
                     json_tree_free(tree, JSON_INFINITE_DEPTH);
                     free(tree);
                     tree = NULL;
@@ -251,6 +464,672 @@ main(int argc, char **argv)
 }
 
 
+/*
+ * pool_fts_cmp - compare FTSENT fts_name strings via strcmp(3)
+ *
+ * Used so that the files of a directory walked for -W are in the same order
+ * however the directory is laid out.
+ *
+ * given:
+ *	a	pointer to pointer to 1st FTSENT to compare
+ *	b	pointer to pointer to 2nd FTSENT to compare
+ *
+ * returns:
+ *	< 0 if a < b, 0 if a == b, > 0 if a > b
+ */
+static int
+pool_fts_cmp(const FTSENT **a, const FTSENT **b)
+{
+    /*
+     * firewall
+     */
+    if (a == NULL || b == NULL || *a == NULL || *b == NULL) {
+	err(4, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    return strcmp((*a)->fts_name, (*b)->fts_name);
+}
+
+
+/*
+ * pool_add_path - add the files of a -W arg to the paths to parse
+ *
+ * A directory is walked, in name order, for files ending in .json.  Anything
+ * else, including a path that does not exist, is added as is so that it is
+ * reported, in input order, as not valid.
+ *
+ * given:
+ *	paths	dynamic array of malloced paths to parse
+ *	path	-W command line arg
+ *
+ * NOTE: This function does not return on error.
+ */
+static void
+pool_add_path(struct dyn_array *paths, char const *path)
+{
+    char *const path_set[2] = { (char *)path, NULL };	/* paths to walk */
+    struct stat st;		/* stat of path */
+    FTS *ftsp = NULL;		/* file hierarchy being walked */
+    FTSENT *ent = NULL;		/* file hierarchy entry */
+    char *copy = NULL;		/* malloced copy of a path */
+    size_t len;			/* length of a file name */
+    size_t suffix_len = sizeof(JPARSE_POOL_SUFFIX) - 1;	/* length of JPARSE_POOL_SUFFIX */
+
+    /*
+     * firewall
+     */
+    if (paths == NULL || path == NULL) {
+	err(5, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    /*
+     * case: not a directory - add as is
+     */
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) {
+	errno = 0;		/* pre-clear errno */
+	copy = strdup(path);
+	if (copy == NULL) {
+	    errp(6, __func__, "strdup of path failed: %s", path);
+	    not_reached();
+	}
+	(void) dyn_array_append_value(paths, &copy);
+	return;
+    }
+
+    /*
+     * case: directory - walk it for files ending in .json
+     */
+    errno = 0;			/* pre-clear errno */
+    ftsp = fts_open(path_set, FTS_COMFOLLOW | FTS_NOCHDIR | FTS_PHYSICAL, pool_fts_cmp);
+    if (ftsp == NULL) {
+	errp(7, __func__, "fts_open failed: %s", path);
+	not_reached();
+    }
+    while ((ent = fts_read(ftsp)) != NULL) {
+	switch (ent->fts_info) {
+	case FTS_F:		/* regular file */
+	    len = strlen(ent->fts_name);
+	    if (len < suffix_len || strcmp(ent->fts_name + len - suffix_len, JPARSE_POOL_SUFFIX) != 0) {
+		break;
+	    }
+	    errno = 0;		/* pre-clear errno */
+	    copy = strdup(ent->fts_path);
+	    if (copy == NULL) {
+		errp(8, __func__, "strdup of fts_path failed: %s", ent->fts_path);
+		not_reached();
+	    }
+	    (void) dyn_array_append_value(paths, &copy);
+	    break;
+	case FTS_DNR:		/* directory that cannot be read */
+	case FTS_ERR:		/* error */
+	case FTS_NS:		/* no stat(2) information */
+	    warn(__func__, "cannot walk: %s: %s", ent->fts_path, strerror(ent->fts_errno));
+	    errno = 0;		/* pre-clear errno */
+	    copy = strdup(ent->fts_path);
+	    if (copy == NULL) {
+		errp(9, __func__, "strdup of fts_path failed: %s", ent->fts_path);
+		not_reached();
+	    }
+	    (void) dyn_array_append_value(paths, &copy);
+	    break;
+	default:		/* directories, symlinks and the like are not parsed */
+	    break;
+	}
+    }
+    (void) fts_close(ftsp);
+    ftsp = NULL;
+}
+
+
+/*
+ * pool_parse_file - parse a file as the command line options of -W say
+ *
+ * given:
+ *	pool	-W worker pool
+ *	path	file to parse
+ *
+ * returns:
+ *	true ==> JSON is valid, false ==> JSON is not valid
+ */
+static bool
+pool_parse_file(struct jparse_pool const *pool, char const *path)
+{
+    struct json *tree = NULL;	/* JSON parse tree or NULL */
+    bool valid_json = false;	/* true ==> JSON parse was valid */
+
+    /*
+     * parse the file in the same way as without -W
+     */
+    if (pool->push == true) {
+	tree = parse_json_file_push(path, pool->chunk, pool->events ? &validate_cb : NULL, NULL, &valid_json);
+    } else if (pool->events == true) {
+	valid_json = parse_json_file_events(path, NULL, NULL);
+    } else if (pool->zero_copy == true) {
+	tree = parse_json_file_zero_copy(path, &valid_json);
+    } else if (pool->arena == true) {
+	tree = parse_json_file_arena(path, &valid_json);
+    } else {
+	tree = parse_json_file(path, &valid_json);
+    }
+    if (tree == NULL && !pool->events) {
+	valid_json = false;
+    }
+
+    /*
+     * free the JSON parse tree
+     */
+    if (tree != NULL) {
+	json_tree_free(tree, JSON_INFINITE_DEPTH);
+	free(tree);
+	tree = NULL;
+    }
+    return valid_json;
+}
+
+
+/*
+ * pool_worker - -W worker: parse the next file (or -N record) until there are none left
+ *
+ * given:
+ *	arg	pointer to the -W worker pool
+ *
+ * returns:
+ *	NULL
+ */
+static void *
+pool_worker(void *arg)
+{
+    struct jparse_pool *pool = arg;	/* -W worker pool */
+    struct stat st;		/* stat of the file */
+    intmax_t i;			/* file to parse */
+    off_t size;			/* size of the file */
+    bool valid;			/* true ==> JSON is valid */
+
+    /*
+     * firewall
+     */
+    if (pool == NULL) {
+	err(10, __func__, "called with NULL arg");
+	not_reached();
+    }
+
+    for (;;) {
+
+	/*
+	 * take the next file
+	 */
+	(void) pthread_mutex_lock(&pool->lock);
+	i = pool->next < pool->count ? pool->next++ : -1;
+	(void) pthread_mutex_unlock(&pool->lock);
+	if (i < 0) {
+	    break;
+	}
+
+	/*
+	 * parse it
+	 */
+	size = 0;
+	if (pool->ndjson == true) {
+	    size = (off_t)pool->file[i].len;
+	    valid = ndjson_parse_record(pool->events, pool->file[i].path, pool->file[i].len, pool->filename,
+					pool->file[i].line);
+	} else {
+	    if (stat(pool->file[i].path, &st) == 0 && S_ISREG(st.st_mode)) {
+		size = st.st_size;
+	    }
+	    valid = pool_parse_file(pool, pool->file[i].path);
+	}
+
+	/*
+	 * tell the main thread it is done
+	 */
+	(void) pthread_mutex_lock(&pool->lock);
+	pool->file[i].size = size;
+	pool->file[i].valid = valid;
+	pool->file[i].done = true;
+	(void) pthread_cond_broadcast(&pool->done_cond);
+	(void) pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+
+/*
+ * pool_run - run the -W worker pool over its files (or -N records)
+ *
+ * Each file (or record) is reported on stdout, in input order, as valid or
+ * invalid as soon as it and every file before it are done.
+ *
+ * given:
+ *	pool		-W worker pool with its files (or records) set
+ *	workers		number of workers, > 0
+ *	bytes		pointer to the number of bytes parsed to add to
+ *
+ * returns:
+ *	number of valid files (or records)
+ *
+ * NOTE: This function does not return on error.
+ */
+static intmax_t
+pool_run(struct jparse_pool *pool, uintmax_t workers, uintmax_t *bytes)
+{
+    pthread_t *thread = NULL;	/* worker threads */
+    intmax_t valid_count = 0;	/* number of valid files */
+    int ret;			/* libc function return */
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (pool == NULL || bytes == NULL) {
+	err(13, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    /*
+     * size the pool
+     */
+    if (workers > (uintmax_t)pool->count) {
+	workers = pool->count > 0 ? (uintmax_t)pool->count : 1;
+    }
+    pool->next = 0;
+    dbg(DBG_MED, "parsing %jd %s on %ju workers", pool->count, pool->ndjson ? "records" : "files", workers);
+
+    /*
+     * start the workers
+     */
+    ret = pthread_mutex_init(&pool->lock, NULL);
+    if (ret != 0) {
+	errno = ret;
+	errp(14, __func__, "pthread_mutex_init failed");
+	not_reached();
+    }
+    ret = pthread_cond_init(&pool->done_cond, NULL);
+    if (ret != 0) {
+	errno = ret;
+	errp(15, __func__, "pthread_cond_init failed");
+	not_reached();
+    }
+    errno = 0;			/* pre-clear errno */
+    thread = calloc((size_t)workers, sizeof(*thread));
+    if (thread == NULL) {
+	errp(16, __func__, "calloc of %ju workers failed", workers);
+	not_reached();
+    }
+    for (i = 0; i < (intmax_t)workers; ++i) {
+	ret = pthread_create(&thread[i], NULL, pool_worker, pool);
+	if (ret != 0) {
+	    errno = ret;
+	    errp(17, __func__, "pthread_create of worker %jd failed", i);
+	    not_reached();
+	}
+    }
+
+    /*
+     * report each file (or record), in input order, once it is done
+     */
+    for (i = 0; i < pool->count; ++i) {
+	(void) pthread_mutex_lock(&pool->lock);
+	while (!pool->file[i].done) {
+	    (void) pthread_cond_wait(&pool->done_cond, &pool->lock);
+	}
+	(void) pthread_mutex_unlock(&pool->lock);
+
+	if (pool->ndjson == true) {
+	    print("%s\t%s:%d\n", pool->file[i].valid ? "valid" : "invalid", pool->filename, pool->file[i].line);
+	} else {
+	    print("%s\t%s\n", pool->file[i].valid ? "valid" : "invalid", pool->file[i].path);
+	}
+	*bytes += (uintmax_t)pool->file[i].size;
+	if (pool->file[i].valid) {
+	    ++valid_count;
+	}
+    }
+
+    /*
+     * wait for the workers
+     */
+    for (i = 0; i < (intmax_t)workers; ++i) {
+	ret = pthread_join(thread[i], NULL);
+	if (ret != 0) {
+	    errno = ret;
+	    errp(18, __func__, "pthread_join of worker %jd failed", i);
+	    not_reached();
+	}
+    }
+
+    /*
+     * free storage
+     */
+    (void) pthread_cond_destroy(&pool->done_cond);
+    (void) pthread_mutex_destroy(&pool->lock);
+    free(thread);
+    thread = NULL;
+
+    return valid_count;
+}
+
+
+/*
+ * parse_files_pool - -W: parse file arguments on a pool of workers
+ *
+ * Each file is reported on stdout, in input order, as valid or invalid as soon
+ * as it and every file before it are done, followed by the total throughput.
+ *
+ * given:
+ *	program		our name
+ *	args		file or directory arguments
+ *	arg_count	number of args
+ *	pool		-W worker pool with its command line options set
+ *	workers		number of workers, 0 ==> one per CPU
+ *
+ * returns:
+ *	0 ==> all JSON is valid, 1 ==> some JSON is not valid
+ *
+ * NOTE: This function does not return on error.
+ */
+static int
+parse_files_pool(char const *program, char **args, int arg_count, struct jparse_pool *pool, uintmax_t workers)
+{
+    struct dyn_array *paths = NULL;	/* malloced paths to parse */
+    struct timespec start;	/* when the workers started */
+    struct timespec end;	/* when the last file was done */
+    double secs = 0.0;		/* seconds from start to end */
+    uintmax_t bytes = 0;	/* total size of the files */
+    intmax_t valid_count = 0;	/* number of valid files */
+    long cpus;			/* number of online CPUs */
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (program == NULL || args == NULL || pool == NULL) {
+	err(11, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    /*
+     * gather the paths to parse, in input order
+     */
+    paths = dyn_array_create(sizeof(char *), JPARSE_POOL_PATH_CHUNK, JPARSE_POOL_PATH_CHUNK, true);
+    for (i = 0; i < arg_count; ++i) {
+	pool_add_path(paths, args[i]);
+    }
+    pool->count = dyn_array_tell(paths);
+    errno = 0;			/* pre-clear errno */
+    pool->file = calloc((size_t)pool->count + 1, sizeof(*pool->file));
+    if (pool->file == NULL) {
+	errp(12, __func__, "calloc of %jd files failed", pool->count);
+	not_reached();
+    }
+    for (i = 0; i < pool->count; ++i) {
+	pool->file[i].path = dyn_array_value(paths, char *, i);
+    }
+    dyn_array_free(paths);
+    paths = NULL;
+
+    /*
+     * size the pool
+     */
+    if (workers == 0) {
+	cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	workers = cpus > 0 ? (uintmax_t)cpus : 1;
+    }
+    if (workers > (uintmax_t)pool->count) {
+	workers = pool->count > 0 ? (uintmax_t)pool->count : 1;
+    }
+
+    /*
+     * parse the files on the pool of workers
+     */
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    valid_count = pool_run(pool, workers, &bytes);
+    (void) clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /*
+     * report the throughput
+     */
+    secs = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    if (secs <= 0.0) {
+	secs = 1e-9;
+    }
+    print("%s: %jd files: %jd valid, %jd invalid: %ju bytes in %.3f seconds on %ju workers: %.2f MB/s, %.1f files/s\n",
+	  program, pool->count, valid_count, pool->count - valid_count, bytes, secs, workers,
+	  (double)bytes / 1e6 / secs, (double)pool->count / secs);
+
+    /*
+     * free storage
+     */
+    for (i = 0; i < pool->count; ++i) {
+	if (pool->file[i].path != NULL) {
+	    free(pool->file[i].path);
+	    pool->file[i].path = NULL;
+	}
+    }
+    free(pool->file);
+    pool->file = NULL;
+
+    return valid_count == pool->count ? 0 : 1;
+}
+
+
+/*
+ * ndjson_parse_record - -N: parse a record of a JSON Lines (NDJSON) file
+ *
+ * given:
+ *	events		true ==> -E: validate with JSON events
+ *	rec		the record
+ *	len		length of the record
+ *	filename	file the record is from
+ *	line		line number of the record
+ *
+ * returns:
+ *	true ==> JSON is valid, false ==> JSON is not valid
+ */
+static bool
+ndjson_parse_record(bool events, char const *rec, size_t len, char const *filename, int line)
+{
+    struct json *tree = NULL;	/* JSON parse tree or NULL */
+    bool valid_json = false;	/* true ==> JSON parse was valid */
+
+    /*
+     * parse the record in the same way as a file without -N
+     */
+    if (events == true) {
+	return parse_json_ndjson_record_events(rec, len, filename, line, NULL, NULL);
+    }
+    tree = parse_json_ndjson_record(rec, len, filename, line, &valid_json);
+    if (tree == NULL) {
+	return false;
+    }
+
+    /*
+     * free the JSON parse tree
+     */
+    json_tree_free(tree, JSON_INFINITE_DEPTH);
+    free(tree);
+    tree = NULL;
+    return valid_json;
+}
+
+
+/*
+ * parse_files_ndjson - -N: validate each record of JSON Lines (NDJSON) file arguments
+ *
+ * Each record is reported on stdout, in input order, as valid or invalid with
+ * the file and line number it is on, followed by the total throughput.
+ *
+ * Without -W each record is parsed where it is in the line buffer of the
+ * record reader, so the memory needed is that of the longest record.  With -W,
+ * a batch of JPARSE_NDJSON_BATCH records per worker is copied out of the line
+ * buffer and parsed on the pool of workers before the next batch is read, so
+ * the memory needed is that of a batch of the longest records.
+ *
+ * given:
+ *	program		our name
+ *	args		file arguments, "-" ==> stdin
+ *	arg_count	number of args
+ *	pool		-W worker pool with its command line options set
+ *	pool_flag_used	true ==> -W: parse the records on a pool of workers
+ *	workers		number of workers, 0 ==> one per CPU
+ *
+ * returns:
+ *	0 ==> all JSON is valid, 1 ==> some JSON is not valid
+ *
+ * NOTE: This function does not return on error.
+ */
+static int
+parse_files_ndjson(char const *program, char **args, int arg_count, struct jparse_pool *pool,
+		   bool pool_flag_used, uintmax_t workers)
+{
+    struct json_ndjson nd;	/* JSON Lines (NDJSON) record reader */
+    FILE *stream = NULL;	/* file stream to read from */
+    struct timespec start;	/* when the first record was read */
+    struct timespec end;	/* when the last record was done */
+    double secs = 0.0;		/* seconds from start to end */
+    uintmax_t bytes = 0;	/* total size of the records */
+    intmax_t records = 0;	/* number of records */
+    intmax_t valid_count = 0;	/* number of valid records */
+    int exit_code = 0;		/* 1 ==> a file could not be read */
+    intmax_t batch = 0;		/* -W: number of records per batch */
+    char *rec = NULL;		/* current record */
+    size_t len = 0;		/* length of rec */
+    int line = 0;		/* line number of rec */
+    bool more = true;		/* true ==> there may be more records */
+    long cpus;			/* number of online CPUs */
+    intmax_t i;
+    intmax_t j;
+
+    /*
+     * firewall
+     */
+    if (program == NULL || args == NULL || pool == NULL) {
+	err(19, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    /*
+     * size the pool and allocate a batch of records
+     */
+    if (pool_flag_used == true) {
+	if (workers == 0) {
+	    cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	    workers = cpus > 0 ? (uintmax_t)cpus : 1;
+	}
+	batch = (intmax_t)workers * JPARSE_NDJSON_BATCH;
+	errno = 0;			/* pre-clear errno */
+	pool->file = calloc((size_t)batch + 1, sizeof(*pool->file));
+	if (pool->file == NULL) {
+	    errp(20, __func__, "calloc of %jd records failed", batch);
+	    not_reached();
+	}
+    } else {
+	workers = 1;
+    }
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < arg_count; ++i) {
+
+	/*
+	 * open the file
+	 */
+	if (strcmp(args[i], "-") == 0) {
+	    stream = stdin;
+	} else {
+	    errno = 0;			/* pre-clear errno */
+	    stream = fopen(args[i], "r");
+	    if (stream == NULL) {
+		warnp(program, "couldn't open file: %s", args[i]);
+		exit_code = 1;
+		continue;
+	    }
+	}
+	json_ndjson_init(&nd, stream, args[i]);
+
+	/*
+	 * case: -W - parse a batch of records at a time on the pool of workers
+	 */
+	if (pool_flag_used == true) {
+	    pool->filename = args[i];
+	    do {
+		/*
+		 * copy the next batch of records out of the line buffer
+		 */
+		for (pool->count = 0; pool->count < batch; ++pool->count) {
+		    more = json_ndjson_next(&nd, &rec, &len, &line);
+		    if (!more) {
+			break;
+		    }
+		    errno = 0;			/* pre-clear errno */
+		    pool->file[pool->count].path = malloc(len + 1);
+		    if (pool->file[pool->count].path == NULL) {
+			errp(21, __func__, "malloc of %zu byte record failed", len + 1);
+			not_reached();
+		    }
+		    memcpy(pool->file[pool->count].path, rec, len + 1);
+		    pool->file[pool->count].len = len;
+		    pool->file[pool->count].line = line;
+		    pool->file[pool->count].done = false;
+		}
+
+		/*
+		 * parse and report the batch
+		 */
+		if (pool->count > 0) {
+		    valid_count += pool_run(pool, workers, &bytes);
+		    records += pool->count;
+		}
+		for (j = 0; j < pool->count; ++j) {
+		    free(pool->file[j].path);
+		    pool->file[j].path = NULL;
+		}
+	    } while (more);
+
+	/*
+	 * case: parse each record in place
+	 */
+	} else {
+	    while (json_ndjson_next(&nd, &rec, &len, &line)) {
+		if (ndjson_parse_record(pool->events, rec, len, args[i], line)) {
+		    print("valid\t%s:%d\n", args[i], line);
+		    ++valid_count;
+		} else {
+		    print("invalid\t%s:%d\n", args[i], line);
+		}
+		bytes += (uintmax_t)len;
+		++records;
+	    }
+	}
+	json_ndjson_free(&nd);
+    }
+    (void) clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /*
+     * report the throughput
+     */
+    secs = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    if (secs <= 0.0) {
+	secs = 1e-9;
+    }
+    print("%s: %jd records: %jd valid, %jd invalid: %ju bytes in %.3f seconds on %ju workers: "
+	  "%.2f MB/s, %.1f records/s\n",
+	  program, records, valid_count, records - valid_count, bytes, secs, workers,
+	  (double)bytes / 1e6 / secs, (double)records / secs);
+
+    /*
+     * free storage
+     */
+    if (pool->file != NULL) {
+	free(pool->file);
+	pool->file = NULL;
+    }
+
+    return valid_count == records ? exit_code : 1;
+}
+
+
 /*
  * usage - print usage to stderr
  *
@@ -44,6 +44,10 @@
 #    define  INCLUDE_JPARSE_MAIN_H
 
 
+#include <pthread.h>
+#include <sys/types.h>
+
+
 /*
  * dbg - info, debug, warning, error, and usage message facility
  */
@@ -82,5 +86,55 @@
  */
 #define JPARSE_BASENAME "jparse"
 
+/*
+ * -W worker pool definitions
+ */
+#define JPARSE_POOL_PATH_CHUNK (1024)	/* number of paths to allocate at a time */
+#define JPARSE_POOL_SUFFIX ".json"	/* files found by walking a directory must end in this */
+#define JPARSE_NDJSON_BATCH (64)	/* -N -W: number of records per worker to read at a time */
+
+
+/*
+ * struct jparse_pool_file - a file (or with -N, a record) validated by the -W worker pool
+ */
+struct jparse_pool_file
+{
+    char *path;			/* path of the file, or with -N the malloced record */
+    size_t len;			/* -N: length of the record */
+    int line;			/* -N: line number of the record */
+    off_t size;			/* size of the file (or record) in bytes, 0 if unknown */
+    bool valid;			/* true ==> JSON is valid */
+    bool done;			/* true ==> file has been parsed, valid and size are set */
+};
+
+/*
+ * struct jparse_pool - -W worker pool that validates many files at once
+ *
+ * The workers take the next file to parse, in input order, under lock.  The
+ * main thread waits for each file, in input order, to be done before it
+ * reports it, so files are reported in input order however many workers there
+ * are and however long each file takes to parse.
+ *
+ * With -N, the pool is given a batch of records of a JSON Lines (NDJSON) file
+ * at a time instead of files, so that only a batch of records is in memory at
+ * once.
+ */
+struct jparse_pool
+{
+    struct jparse_pool_file *file;	/* files to parse, in input order */
+    intmax_t count;		/* number of files */
+    intmax_t next;		/* next file for a worker to parse */
+    pthread_mutex_t lock;	/* lock for next and for the done and valid of each file */
+    pthread_cond_t done_cond;	/* signaled when a file is done */
+
+    bool arena;			/* true ==> -A: allocate each JSON parse tree from a single arena */
+    bool zero_copy;		/* true ==> -z: scan each file in place */
+    bool events;		/* true ==> -E: validate with JSON events */
+    bool push;			/* true ==> -P: push each file to an incremental parser */
+    size_t chunk;		/* -P chunk length */
+    bool ndjson;		/* true ==> -N: file holds records of filename */
+    char const *filename;	/* -N: JSON Lines (NDJSON) file the records are from */
+};
+
 
 #endif /* INCLUDE_JPARSE_MAIN_H */
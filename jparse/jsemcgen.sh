@@ -45,6 +45,7 @@ export J_FLAG="0"
 export Q_FLAG=
 export S_FLAG=
 export I_FLAG=
+export C_FLAG=
 export NAME=
 export DEFAULT_FUNC=
 export PREFIX=
@@ -59,7 +60,7 @@ export UNKNOWN_FUNC=
 export JSEMTBLGEN="./jsemtblgen"
 export JSEMTBLGEN_ARGS=
 export PATCH_TOOL=
-export JSEMCGEN_VERSION="2.0.0 2025-02-28"
+export JSEMCGEN_VERSION="2.1.0 2026-10-19"
 
 # attempt to fetch system specific paths to tools we need
 #
@@ -82,7 +83,7 @@ if [[ -z "$PATCH_TOOL" ]]; then
     PATCH_TOOL="/usr/bin/patch"
 fi
 
-export USAGE="usage: $0 [-h] [-v level] [-J level] [-q] [-V] [-s] [-I] [-N name] [-D def_func] [-P prefix]
+export USAGE="usage: $0 [-h] [-v level] [-J level] [-q] [-V] [-s] [-I] [-C] [-N name] [-D def_func] [-P prefix]
 	[-1 func] [-S func] [-B func] [-0 func] [-M func] [-O func] [-A func] [-U func]
 	[-j jsemtblgen] [-p patch_tool] file.json head patch tail out
 
@@ -94,6 +95,7 @@ export USAGE="usage: $0 [-h] [-v level] [-J level] [-q] [-V] [-s] [-I] [-N name]
 	-s		file.json is a string (def: arg is a filename)
 
 	-I		output as .h include file (def: output as .c src)
+	-C		also output name_find(), a compiled matcher for the table (def: do not)
 
 	-N name		name of the semantics table (def: sem_tbl)
 
@@ -140,7 +142,7 @@ jsemcgen.sh version: $JSEMCGEN_VERSION"
 
 # parse args
 #
-while getopts :hv:J:qVsIN:D:P:1:S:B:0:M:O:A:U:j:p: flag; do
+while getopts :hv:J:qVsICN:D:P:1:S:B:0:M:O:A:U:j:p: flag; do
     case "$flag" in
     h)	echo "$USAGE" 1>&2
 	exit 2
@@ -163,6 +165,9 @@ while getopts :hv:J:qVsIN:D:P:1:S:B:0:M:O:A:U:j:p: flag; do
     I)	I_FLAG="-I";
 	JSEMTBLGEN_ARGS="$JSEMTBLGEN_ARGS -I";
 	;;
+    C)	C_FLAG="-C";
+	JSEMTBLGEN_ARGS="$JSEMTBLGEN_ARGS -C";
+	;;
     N)	NAME="$OPTARG";
 	JSEMTBLGEN_ARGS="$JSEMTBLGEN_ARGS -N '$NAME'";
 	;;
@@ -245,6 +250,7 @@ if [[ $V_FLAG -ge 5 ]]; then
     echo "$0: debug[5]: Q_FLAG: $Q_FLAG" 1>&2
     echo "$0: debug[5]: S_FLAG: $S_FLAG" 1>&2
     echo "$0: debug[5]: I_FLAG: $I_FLAG" 1>&2
+    echo "$0: debug[5]: C_FLAG: $C_FLAG" 1>&2
     echo "$0: debug[5]: NAME: $NAME" 1>&2
     echo "$0: debug[5]: DEFAULT_FUNC: $DEFAULT_FUNC" 1>&2
     echo "$0: debug[5]: PREFIX: $PREFIX" 1>&2
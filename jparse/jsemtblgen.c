@@ -67,6 +67,7 @@
  * static globals
  */
 static bool h_mode = false;		/* -I - true ==> output as .h include file, false ==> output as .c src */
+static bool c_mode = false;		/* -C - true ==> also output the compiled matcher name_find() */
 static char *tbl_name = "sem_tbl";	/* -N name - name of the semantic table */
 static char *def_func = NULL;		/* -D def_func - validate with def_func() unless overridden */
 static char *prefix = NULL;		/* -P prefix - validate JTYPE_MEMBER with prefix_name() or NULL */
@@ -83,7 +84,7 @@ static char *unknown_func = NULL;	/* -U func - validate nodes with unknown types
  * usage message
  */
 static const char * const usage_msg0 =
-    "usage: %s [-h] [-v level] [-J level] [-q] [-V] [-s] [-I] [-N name] [-D def_func] [-P prefix]\n"
+    "usage: %s [-h] [-v level] [-J level] [-q] [-V] [-s] [-I] [-C] [-N name] [-D def_func] [-P prefix]\n"
     "\t\t    [-1 func] [-S func] [-B func] [-0 func] [-M func] [-O func] [-A func] [-U func] json_arg\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
@@ -94,6 +95,10 @@ static const char * const usage_msg0 =
     "\t-s\t\targ is a string (def: arg is a filename)\n"
     "\n"
     "\t-I\t\toutput as .h include file (def: output as .c src)\n"
+    "\t-C\t\talso output name_find(), a compiled matcher for the table (def: do not)\n"
+    "\n"
+    "\t\t\tNOTE: name_find() returns what json_sem_find() returns for the table,\n"
+    "\t\t\t      switching on depth and type, with a perfect hash of member names.\n"
     "\n"
     "\t-N name\t\tname of the semantics table (def: sem_tbl)\n"
     "\n"
@@ -268,6 +273,7 @@ static int sem_cmp(void const *a, void const *b);
 static char *alloc_c_funct_name(char const *prefix, char const *str);
 static bool append_unique_str(struct dyn_array *tbl, char *str);
 static void print_sem_c_src(struct dyn_array *tbl, char *tbl_name, char *cap_tbl_name);
+static void print_sem_c_find(struct dyn_array *tbl, char *tbl_name);
 static void print_sem_h_src(struct dyn_array *tbl, char *tbl_name, char *cap_tbl_name);
 static Word *find_member(Word *table, const char *string);
 static bool test_reserved(const char *string);
@@ -300,7 +306,7 @@ main(int argc, char **argv)
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:J:qVsIN:D:P:1:S:B:0:M:O:A:U:")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:J:qVsICN:D:P:1:S:B:0:M:O:A:U:")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 0 */
 	    usage(2, program, ""); /*ooo*/
@@ -343,6 +349,9 @@ main(int argc, char **argv)
 	case 'I':
 	    h_mode = true;
 	    break;
+	case 'C':		/* -C - also output the compiled matcher name_find() */
+	    c_mode = true;
+	    break;
 	case 'N':		/* -N name - name of the semantic table */
 	    tbl_name = optarg;
 	    break;
@@ -482,6 +491,9 @@ main(int argc, char **argv)
 	print_sem_h_src(tbl, tbl_name, cap_tbl_name);
     } else {
 	print_sem_c_src(tbl, tbl_name, cap_tbl_name);
+	if (c_mode == true) {
+	    print_sem_c_find(tbl, tbl_name);
+	}
     }
 
     /*
@@ -1221,6 +1233,252 @@ print_sem_c_src(struct dyn_array *tbl, char *tbl_name, char *cap_tbl_name)
 }
 
 
+/*
+ * print_sem_c_find - print a compiled matcher for a sorted semantic table
+ *
+ * The function printed, tbl_name_find(), returns the same index into the
+ * table that json_sem_find() returns for a JSON node, without searching the
+ * table: it switches on the depth and type of the node and, for a JTYPE_MEMBER,
+ * on a perfect hash of the names of the members at that depth.  Which entry
+ * of the table is the first match is worked out here, so the entries must not
+ * be reordered, nor their depth, type or name changed, once printed.  Changing
+ * the min, max or validate of an entry is fine.
+ *
+ * given:
+ *	tbl		dynamic array of semantic table entries sorted by print_sem_c_src()
+ *	tbl_name	name of the semantic table
+ *
+ * NOTE: This function does not return if given NULL pointers or on error.
+ */
+static void
+print_sem_c_find(struct dyn_array *tbl, char *tbl_name)
+{
+    struct json_sem *p = NULL;	/* semantic table entry of a depth */
+    struct json_sem *q = NULL;	/* semantic table entry of a type at that depth */
+    char **names = NULL;	/* C string of the name of each JTYPE_MEMBER entry with a name or NULL */
+    uint32_t *hash = NULL;	/* hash of each name */
+    intmax_t *member = NULL;	/* entries with a distinct name at a depth */
+    intmax_t members = 0;	/* number of entries in member */
+    intmax_t wild = -1;		/* first JTYPE_MEMBER entry at a depth with no name or -1 */
+    intmax_t match = -1;	/* first entry a name matches */
+    bool has_member = false;	/* true ==> table has a JTYPE_MEMBER entry */
+    bool first = false;		/* true ==> first name of a hash slot */
+    uint32_t mod = 0;		/* modulus of the hash of names */
+    uint32_t slot = 0;		/* hash slot */
+    intmax_t len = 0;		/* number of semantic table entries */
+    intmax_t i;
+    intmax_t j;
+    intmax_t k;
+    intmax_t m;
+
+    /*
+     * firewall
+     */
+    if (tbl == NULL) {
+	err(34, __func__, "tbl is NULL");
+	not_reached();
+    }
+    if (tbl_name == NULL) {
+	err(35, __func__, "tbl_name is NULL");
+	not_reached();
+    }
+
+    /*
+     * form the name, as printed in the table, and its hash for each named JTYPE_MEMBER entry
+     */
+    len = dyn_array_tell(tbl);
+    errno = 0;		/* pre-clear errno for errp() */
+    names = calloc((size_t)len + 1, sizeof(*names));
+    hash = calloc((size_t)len + 1, sizeof(*hash));
+    member = calloc((size_t)len + 1, sizeof(*member));
+    if (names == NULL || hash == NULL || member == NULL) {
+	errp(36, __func__, "calloc of name arrays of %jd entries failed", len);
+	not_reached();
+    }
+    for (i=0; i < len; ++i) {
+	p = dyn_array_addr(tbl, struct json_sem, i);
+	if (p->type == JTYPE_MEMBER) {
+	    has_member = true;
+	    if (p->name != NULL && p->name_len > 0) {
+		names[i] = alloc_c_funct_name(NULL, p->name);
+		hash[i] = json_object_hash(names[i], strlen(names[i]));
+	    }
+	}
+    }
+
+    /*
+     * print the function header
+     */
+    print("\n\n/*\n * %s_find - find the first match of a JSON node in %s[]\n *\n", tbl_name, tbl_name);
+    print(" * This function was generated by jsemtblgen -C: it returns what json_sem_find()\n"
+	  " * returns for %s[], without searching the table.\n", tbl_name);
+    print(" *\n * given:\n"
+	  " *\tnode\t\tpointer to a JSON parse tree\n"
+	  " *\tdepth\t\tdepth of node in the JSON parse tree (0 ==> tree root)\n"
+	  " *\tsem\t\tpointer to %s[]\n", tbl_name);
+    print(" *\n * returns:\n"
+	  " *\t>=0 ==> index into %s[] for first match\n"
+	  " *\t-1  ==> no %s[] match found\n"
+	  " *\t< -1 ==> invalid JSON node, or NULL ptr\n */\n", tbl_name, tbl_name);
+    print("int\n%s_find(struct json *node, unsigned int depth, struct json_sem *sem)\n{\n", tbl_name);
+    if (has_member == true) {
+	prstr("    char *name = NULL;\t\t/* name of JTYPE_MEMBER node or NULL */\n\n");
+    }
+    prstr("    /*\n     * firewall - args\n     */\n"
+	  "    if (node == NULL) {\n\twarn(__func__, \"node is NULL\");\n\treturn -2;\n    }\n"
+	  "    if (sem == NULL) {\n\twarn(__func__, \"sem is NULL\");\n\treturn -3;\n    }\n\n");
+    prstr("    /*\n     * obtain information about the JSON node\n     */\n");
+    if (has_member == true) {
+	prstr("    if (node->type == JTYPE_MEMBER) {\n"
+	      "\tname = sem_member_name_decoded_str(node, depth, sem, __func__, NULL);\n"
+	      "    } else if (sem_node_valid(node, depth, sem, __func__, NULL) == false) {\n");
+    } else {
+	prstr("    if (node->type != JTYPE_MEMBER && sem_node_valid(node, depth, sem, __func__, NULL) == false) {\n");
+    }
+    prstr("\twarn(__func__, \"JSON node is invalid\");\n\treturn -4;\n    }\n\n");
+
+    /*
+     * print a case for each depth in the table
+     */
+    prstr("    /*\n     * match depth, type and, for JTYPE_MEMBER, name\n     */\n");
+    prstr("    switch (depth) {\n");
+    for (i=0; i < len; ++i) {
+	p = dyn_array_addr(tbl, struct json_sem, i);
+	for (k=0; k < i && dyn_array_addr(tbl, struct json_sem, k)->depth != p->depth; ++k) {
+	    /* look for an earlier entry of this depth */
+	}
+	if (k < i) {
+	    continue;	/* depth already printed */
+	}
+	print("    case %u:\n\tswitch (node->type) {\n", p->depth);
+
+	/*
+	 * print a case for each type at this depth, in table order
+	 */
+	for (j=i; j < len; ++j) {
+	    q = dyn_array_addr(tbl, struct json_sem, j);
+	    if (q->depth != p->depth) {
+		continue;
+	    }
+	    for (k=i; k < j && (dyn_array_addr(tbl, struct json_sem, k)->depth != q->depth ||
+				dyn_array_addr(tbl, struct json_sem, k)->type != q->type); ++k) {
+		/* look for an earlier entry of this depth and type */
+	    }
+	    if (k < j) {
+		continue;	/* type already printed */
+	    }
+	    print("\tcase %s:\n", json_type_name(q->type));
+
+	    /*
+	     * case: not JTYPE_MEMBER - the first entry of the depth and type matches
+	     */
+	    if (q->type != JTYPE_MEMBER) {
+		print("\t    return %jd;\n", j);
+		continue;
+	    }
+
+	    /*
+	     * case: JTYPE_MEMBER - note the first entry with no name and the first entry of each name
+	     */
+	    wild = -1;
+	    members = 0;
+	    for (k=j; k < len; ++k) {
+		struct json_sem *r = dyn_array_addr(tbl, struct json_sem, k);	/* entry to consider */
+
+		if (r->depth != q->depth || r->type != JTYPE_MEMBER) {
+		    continue;
+		}
+		if (names[k] == NULL) {
+		    if (wild < 0) {
+			wild = k;
+		    }
+		    continue;
+		}
+		for (m=0; m < members && strcmp(names[member[m]], names[k]) != 0; ++m) {
+		    /* look for an earlier entry of this name */
+		}
+		if (m == members) {
+		    member[members++] = k;
+		}
+	    }
+	    print("\t    if (name == NULL) {\n\t\treturn %jd;\n\t    }\n", j);
+
+	    /*
+	     * find the smallest modulus that hashes each name to its own slot
+	     *
+	     * If there is none (two names with the same hash), names that share
+	     * a slot are compared in turn.
+	     */
+	    if (members > 0) {
+		for (mod = (uint32_t)members; mod <= (uint32_t)members * 64; ++mod) {
+		    for (k=1; k < members; ++k) {
+			for (m=0; m < k && hash[member[m]] % mod != hash[member[k]] % mod; ++m) {
+			    /* look for an earlier name in the same slot */
+			}
+			if (m < k) {
+			    break;	/* two names in the same slot */
+			}
+		    }
+		    if (k >= members) {
+			break;	/* perfect hash */
+		    }
+		}
+		if (mod > (uint32_t)members * 64) {
+		    mod = (uint32_t)members;
+		}
+
+		/*
+		 * print the names by slot
+		 */
+		print("\t    switch (json_object_hash(name, strlen(name)) %% %u) {\n", mod);
+		for (slot=0; slot < mod; ++slot) {
+		    first = true;
+		    for (k=0; k < members; ++k) {
+			if (hash[member[k]] % mod != slot) {
+			    continue;
+			}
+			if (first == true) {
+			    print("\t    case %u:\n", slot);
+			    first = false;
+			}
+			match = member[k];
+			if (wild >= 0 && wild < match) {
+			    match = wild;
+			}
+			print("\t\tif (strcmp(name, \"%s\") == 0) {\n\t\t    return %jd;\n\t\t}\n", names[member[k]], match);
+		    }
+		    if (first == false) {
+			prstr("\t\tbreak;\n");
+		    }
+		}
+		prstr("\t    default:\n\t\tbreak;\n\t    }\n");
+	    }
+	    print("\t    return %jd;\n", wild);
+	}
+	prstr("\tdefault:\n\t    break;\n\t}\n\tbreak;\n");
+    }
+    prstr("    default:\n\tbreak;\n    }\n\n");
+    prstr("    /*\n     * no match for the JSON node\n     */\n    return -1;\n}\n");
+
+    /*
+     * free the names
+     */
+    for (i=0; i < len; ++i) {
+	if (names[i] != NULL) {
+	    free(names[i]);
+	    names[i] = NULL;
+	}
+    }
+    free(names);
+    names = NULL;
+    free(hash);
+    hash = NULL;
+    free(member);
+    member = NULL;
+    return;
+}
+
+
 /*
  * print_sem_h_src - print a sorted semantic table as a .h include file
  *
@@ -1457,6 +1715,13 @@ print_sem_h_src(struct dyn_array *tbl, char *tbl_name, char *cap_tbl_name)
     }
     dyn_array_free(unique_tbl);
 
+    /*
+     * print the compiled matcher prototype if -C
+     */
+    if (c_mode == true) {
+	print("\nextern int %s_find(struct json *node, unsigned int depth, struct json_sem *sem);\n", tbl_name);
+    }
+
     /*
      * print semantic table trailer
      */
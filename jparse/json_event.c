@@ -0,0 +1,521 @@
+/*
+ * json_event - JSON event (SAX style) parser
+ *
+ * "Because sometimes you only want to hear about the tree, not to climb it." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+
+/*
+ * jparse - JSON parser
+ */
+#include "jparse.h"
+
+/*
+ * json_event - JSON event (SAX style) parser
+ */
+#include "json_event.h"
+
+
+/*
+ * static functions
+ */
+static bool json_event_push(struct json_event_parser *ep, bool object);
+static bool json_event_buf(struct json_event_parser *ep, size_t len);
+static bool json_event_string(struct json_event_parser *ep, char const *text, size_t len, size_t *retlen);
+
+
+/*
+ * json_event_init - initialise a JSON event parser
+ *
+ * given:
+ *	ep	pointer to the JSON event parser to initialise
+ *	cb	pointer to the JSON event callbacks, or NULL ==> only validate
+ *	data	data pointer given to each callback
+ *
+ * NOTE: This function does not return on NULL ep.
+ *
+ * NOTE: Free the memory of the JSON event parser with json_event_free().
+ */
+void
+json_event_init(struct json_event_parser *ep, struct json_event_cb const *cb, void *data)
+{
+    /*
+     * firewall
+     */
+    if (ep == NULL) {
+	err(10, __func__, "ep is NULL");
+	not_reached();
+    }
+
+    /*
+     * expect a single JSON value at the top level
+     */
+    memset(ep, 0, sizeof(*ep));
+    ep->cb = cb;
+    ep->data = data;
+    ep->state = JSON_EVENT_VALUE;
+    return;
+}
+
+
+/*
+ * json_event_push - enter a JSON object or array
+ *
+ * given:
+ *	ep	pointer to a JSON event parser
+ *	object	true ==> entering a JSON object, false ==> entering a JSON array
+ *
+ * returns:
+ *	true
+ *
+ * NOTE: This function does not return on realloc error.
+ */
+static bool
+json_event_push(struct json_event_parser *ep, bool object)
+{
+    bool *in_object = NULL;	/* reallocated nesting levels */
+
+    /*
+     * allocate more nesting levels if needed
+     */
+    if (ep->depth >= ep->max_depth) {
+	errno = 0;		/* pre-clear errno for errp() */
+	in_object = realloc(ep->in_object, (ep->max_depth + JSON_EVENT_STACK_CHUNK) * sizeof(*in_object));
+	if (in_object == NULL) {
+	    errp(11, __func__, "realloc of %zu nesting levels failed", ep->max_depth + JSON_EVENT_STACK_CHUNK);
+	    not_reached();
+	}
+	ep->in_object = in_object;
+	ep->max_depth += JSON_EVENT_STACK_CHUNK;
+    }
+    ep->in_object[ep->depth++] = object;
+    return true;
+}
+
+
+/*
+ * json_event_buf - make sure the string buffer of a JSON event parser is large enough
+ *
+ * given:
+ *	ep	pointer to a JSON event parser
+ *	len	length of the string (not counting the final NUL byte) to hold
+ *
+ * returns:
+ *	true
+ *
+ * NOTE: This function does not return on realloc error.
+ */
+static bool
+json_event_buf(struct json_event_parser *ep, size_t len)
+{
+    char *buf = NULL;		/* reallocated string buffer */
+
+    if (ep->buf == NULL || len + 1 > ep->buf_len) {
+	errno = 0;		/* pre-clear errno for errp() */
+	buf = realloc(ep->buf, len + 1);
+	if (buf == NULL) {
+	    errp(12, __func__, "realloc of %zu bytes failed", len + 1);
+	    not_reached();
+	}
+	ep->buf = buf;
+	ep->buf_len = len + 1;
+    }
+    return true;
+}
+
+
+/*
+ * json_event_string - decode a JSON string token into the string buffer
+ *
+ * given:
+ *	ep	pointer to a JSON event parser
+ *	text	JSON string token, including the surrounding double quotes
+ *	len	length of text
+ *	retlen	where to store the length of the decoded string
+ *
+ * returns:
+ *	true ==> JSON string is valid and decoded into ep->buf,
+ *	false ==> JSON string is not valid, ep->error is set
+ */
+static bool
+json_event_string(struct json_event_parser *ep, char const *text, size_t len, size_t *retlen)
+{
+    char *str = NULL;		/* decoded JSON string with \-escapes */
+    size_t mlen = 0;		/* length of the decoded JSON string */
+
+    /*
+     * ignore the surrounding double quotes
+     */
+    if (len < 2) {
+	ep->error = "JSON string token is too short";
+	return false;
+    }
+    ++text;
+    len -= 2;
+
+    /*
+     * the scanner accepts NUL bytes in a JSON string when it does not scan
+     * a pre-scanned block of memory (see low_byte_scan() in jparse.l)
+     */
+    if (memchr(text, '\0', len) != NULL) {
+	ep->error = "NUL byte in JSON string";
+	return false;
+    }
+
+    /*
+     * validate the JSON string
+     */
+    if (!json_decode_len(text, len, &mlen)) {
+	ep->error = "invalid JSON string";
+	return false;
+    }
+
+    /*
+     * case: no \-escapes - the JSON string is its own decoding
+     */
+    if (mlen == len) {
+	(void) json_event_buf(ep, len);
+	memcpy(ep->buf, text, len);
+
+    /*
+     * case: decode the \-escapes
+     */
+    } else {
+	str = json_decode(text, len, false, &mlen);
+	if (str == NULL) {
+	    ep->error = "invalid JSON string";
+	    return false;
+	}
+	(void) json_event_buf(ep, mlen);
+	memcpy(ep->buf, str, mlen);
+	free(str);
+	str = NULL;
+    }
+    ep->buf[mlen] = '\0';
+    *retlen = mlen;
+    return true;
+}
+
+
+/*
+ * json_event_token - feed a JSON scanner token to a JSON event parser
+ *
+ * given:
+ *	ep	pointer to a JSON event parser
+ *	tok	JSON scanner token, JPARSE_EOF ==> end of the JSON document
+ *	text	text of the token
+ *	len	length of text
+ *
+ * returns:
+ *	true ==> token accepted (or, for JPARSE_EOF, the JSON document is valid),
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * Once this function returns false the JSON event parser stays in the
+ * JSON_EVENT_ERROR state and ep->error, when not NULL, tells why.  When
+ * ep->error is NULL the token was not expected, see json_event_token_name().
+ *
+ * NOTE: This function does not return on NULL ep.
+ */
+bool
+json_event_token(struct json_event_parser *ep, int tok, char const *text, size_t len)
+{
+    struct json_event_cb const *cb = NULL;	/* JSON event callbacks or NULL */
+    bool value = false;				/* true ==> a JSON value is expected */
+    bool ok = true;				/* false ==> callback stopped the parse */
+    enum item_type type = JTYPE_UNSET;		/* type of a JSON value */
+    size_t str_len = 0;				/* length of a decoded JSON string */
+
+    /*
+     * firewall
+     */
+    if (ep == NULL) {
+	err(13, __func__, "ep is NULL");
+	not_reached();
+    }
+    if (ep->state == JSON_EVENT_ERROR) {
+	return false;
+    }
+    if (ep->state == JSON_EVENT_DONE) {
+	ep->state = JSON_EVENT_ERROR;
+	ep->error = "token after the end of the JSON document";
+	return false;
+    }
+    if (text == NULL) {
+	text = "";
+	len = 0;
+    }
+    cb = ep->cb;
+    value = (ep->state == JSON_EVENT_VALUE || ep->state == JSON_EVENT_VALUE_OR_END);
+
+    /*
+     * report where the token is, when known
+     */
+    if (cb != NULL && cb->token != NULL && ep->located && tok != JPARSE_EOF) {
+	ok = cb->token(ep->data, ep->offset, len);
+	if (!ok) {
+	    goto accepted;
+	}
+    }
+
+    /*
+     * act on the token
+     */
+    switch (tok) {
+    case JSON_OPEN_BRACE:
+	if (!value) {
+	    break;
+	}
+	(void) json_event_push(ep, true);
+	ep->state = JSON_EVENT_NAME_OR_END;
+	if (cb != NULL && cb->start_object != NULL) {
+	    ok = cb->start_object(ep->data);
+	}
+	goto accepted;
+
+    case JSON_OPEN_BRACKET:
+	if (!value) {
+	    break;
+	}
+	(void) json_event_push(ep, false);
+	ep->state = JSON_EVENT_VALUE_OR_END;
+	if (cb != NULL && cb->start_array != NULL) {
+	    ok = cb->start_array(ep->data);
+	}
+	goto accepted;
+
+    case JSON_CLOSE_BRACE:
+	if (ep->state != JSON_EVENT_NAME_OR_END &&
+	    (ep->state != JSON_EVENT_NEXT || ep->depth == 0 || !ep->in_object[ep->depth-1])) {
+	    break;
+	}
+	--ep->depth;
+	ep->state = JSON_EVENT_NEXT;
+	if (cb != NULL && cb->end_object != NULL) {
+	    ok = cb->end_object(ep->data);
+	}
+	goto accepted;
+
+    case JSON_CLOSE_BRACKET:
+	if (ep->state != JSON_EVENT_VALUE_OR_END &&
+	    (ep->state != JSON_EVENT_NEXT || ep->depth == 0 || ep->in_object[ep->depth-1])) {
+	    break;
+	}
+	--ep->depth;
+	ep->state = JSON_EVENT_NEXT;
+	if (cb != NULL && cb->end_array != NULL) {
+	    ok = cb->end_array(ep->data);
+	}
+	goto accepted;
+
+    case JSON_COMMA:
+	if (ep->state != JSON_EVENT_NEXT || ep->depth == 0) {
+	    break;
+	}
+	ep->state = ep->in_object[ep->depth-1] ? JSON_EVENT_NAME : JSON_EVENT_VALUE;
+	goto accepted;
+
+    case JSON_COLON:
+	if (ep->state != JSON_EVENT_COLON) {
+	    break;
+	}
+	ep->state = JSON_EVENT_VALUE;
+	goto accepted;
+
+    case JSON_STRING:
+	/*
+	 * case: name of a JSON member
+	 */
+	if (ep->state == JSON_EVENT_NAME || ep->state == JSON_EVENT_NAME_OR_END) {
+	    if (!json_event_string(ep, text, len, &str_len)) {
+		ep->state = JSON_EVENT_ERROR;
+		return false;
+	    }
+	    ep->state = JSON_EVENT_COLON;
+	    if (cb != NULL && cb->member_name != NULL) {
+		ok = cb->member_name(ep->data, ep->buf, str_len);
+	    }
+	    goto accepted;
+	}
+
+	/*
+	 * case: JSON string value
+	 */
+	if (!value) {
+	    break;
+	}
+	if (!json_event_string(ep, text, len, &str_len)) {
+	    ep->state = JSON_EVENT_ERROR;
+	    return false;
+	}
+	ep->state = JSON_EVENT_NEXT;
+	if (cb != NULL && cb->value != NULL) {
+	    ok = cb->value(ep->data, JTYPE_STRING, ep->buf, str_len);
+	}
+	goto accepted;
+
+    case JSON_NUMBER:
+	type = JTYPE_NUMBER;
+	/*fallthrough*/
+    case JSON_TRUE:	/*fallthrough*/
+    case JSON_FALSE:
+	if (type == JTYPE_UNSET) {
+	    type = JTYPE_BOOL;
+	}
+	/*fallthrough*/
+    case JSON_NULL:
+	if (type == JTYPE_UNSET) {
+	    type = JTYPE_NULL;
+	}
+	if (!value) {
+	    break;
+	}
+	ep->state = JSON_EVENT_NEXT;
+	if (cb != NULL && cb->value != NULL) {
+	    ok = cb->value(ep->data, type, text, len);
+	}
+	goto accepted;
+
+    case JPARSE_EOF:
+	if (ep->state != JSON_EVENT_NEXT || ep->depth > 0) {
+	    break;
+	}
+	ep->state = JSON_EVENT_DONE;
+	return true;
+
+    default:
+	break;
+    }
+
+    /*
+     * the token was not expected
+     */
+    ep->state = JSON_EVENT_ERROR;
+    return false;
+
+accepted:
+    /*
+     * the token was accepted: check if the callback stopped the parse
+     */
+    if (!ok) {
+	ep->state = JSON_EVENT_ERROR;
+	ep->error = "JSON event callback stopped the parse";
+	ep->stopped = true;
+	return false;
+    }
+    return true;
+}
+
+
+/*
+ * json_event_token_name - name of a JSON scanner token
+ *
+ * given:
+ *	tok	JSON scanner token
+ *
+ * returns:
+ *	name of the token as bison names it in its syntax error messages
+ */
+char const *
+json_event_token_name(int tok)
+{
+    switch (tok) {
+    case JPARSE_EOF:
+	return "end of file";
+    case JSON_OPEN_BRACE:
+	return "\"{\"";
+    case JSON_CLOSE_BRACE:
+	return "\"}\"";
+    case JSON_OPEN_BRACKET:
+	return "\"[\"";
+    case JSON_CLOSE_BRACKET:
+	return "\"]\"";
+    case JSON_COMMA:
+	return "\",\"";
+    case JSON_COLON:
+	return "\":\"";
+    case JSON_NULL:
+	return "\"null\"";
+    case JSON_TRUE:
+	return "\"true\"";
+    case JSON_FALSE:
+	return "\"false\"";
+    case JSON_STRING:
+	return "JSON_STRING";
+    case JSON_NUMBER:
+	return "JSON_NUMBER";
+    case token:
+	return "token";
+    default:
+	break;
+    }
+    return "invalid token";
+}
+
+
+/*
+ * json_event_free - free the memory of a JSON event parser
+ *
+ * given:
+ *	ep	pointer to a JSON event parser, or NULL
+ *
+ * NOTE: The JSON event parser itself is not freed.
+ */
+void
+json_event_free(struct json_event_parser *ep)
+{
+    if (ep == NULL) {
+	return;
+    }
+    if (ep->in_object != NULL) {
+	free(ep->in_object);
+	ep->in_object = NULL;
+    }
+    if (ep->buf != NULL) {
+	free(ep->buf);
+	ep->buf = NULL;
+    }
+    ep->max_depth = 0;
+    ep->buf_len = 0;
+    ep->depth = 0;
+    return;
+}
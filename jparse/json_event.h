@@ -0,0 +1,163 @@
+/*
+ * json_event - JSON event (SAX style) parser
+ *
+ * "Because sometimes you only want to hear about the tree, not to climb it." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+#if !defined(INCLUDE_JSON_EVENT_H)
+#    define  INCLUDE_JSON_EVENT_H
+
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#else
+  #include <c_bool.h>
+  #include <c_compat.h>
+  #include <dbg.h>
+#endif
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "util.h"
+
+/*
+ * json_parse - JSON parser support code
+ */
+#include "json_parse.h"
+
+
+/*
+ * definitions
+ */
+#define JSON_EVENT_STACK_CHUNK (64)	/* number of nesting levels to allocate at a time */
+
+
+/*
+ * JSON event callbacks
+ *
+ * Each callback is given the data pointer that was given to the event parser.
+ * A NULL callback is not called.  When a callback returns false the parse is
+ * stopped and the JSON is reported as not valid.
+ *
+ * The name given to member_name() and the string given to value() for a
+ * JSON string are the decoded, NUL terminated JSON string (which may also
+ * contain NUL bytes, hence len).  For a JSON number, boolean or null, value()
+ * is given the JSON text of the value.  These strings are only valid during
+ * the callback.
+ *
+ * The token() callback is given the byte offset and length of each token in
+ * the JSON, before any other callback for the token is called, so that the
+ * JSON text of a value can be found again: a JSON object starts at the offset
+ * of the token of start_object() and ends after the token of end_object().  It
+ * is only called when the offsets are known, which they are when the JSON is
+ * scanned by the JSON scanner (parse_json_events() and friends), but not when
+ * it is fed to a push parser.
+ */
+struct json_event_cb
+{
+    bool (*start_object)(void *data);	/* called on { */
+    bool (*end_object)(void *data);	/* called on } */
+    bool (*start_array)(void *data);	/* called on [ */
+    bool (*end_array)(void *data);	/* called on ] */
+    bool (*member_name)(void *data, char const *name, size_t len);
+					/* called on the name of a JSON member */
+    bool (*value)(void *data, enum item_type type, char const *str, size_t len);
+					/* called on a JSON string, number, boolean or null */
+    bool (*token)(void *data, size_t offset, size_t len);
+					/* called before each token, with its byte offset in the JSON */
+};
+
+/*
+ * JSON event parser states - what the next token must be
+ */
+enum json_event_state {
+    JSON_EVENT_VALUE = 0,	/* a JSON value */
+    JSON_EVENT_VALUE_OR_END,	/* a JSON value or ] (just after [) */
+    JSON_EVENT_NAME,		/* the name of a JSON member */
+    JSON_EVENT_NAME_OR_END,	/* the name of a JSON member or } (just after {) */
+    JSON_EVENT_COLON,		/* the : after the name of a JSON member */
+    JSON_EVENT_NEXT,		/* , or the end of the enclosing object or array, or end of file */
+    JSON_EVENT_DONE,		/* nothing: the JSON document is complete and valid */
+    JSON_EVENT_ERROR,		/* nothing: the JSON document is not valid */
+};
+
+/*
+ * JSON event parser
+ *
+ * The event parser is fed the tokens of the JSON scanner, one at a time, and
+ * calls the JSON event callbacks without forming a JSON parse tree.  The only
+ * memory it needs is one bool per nesting level and a buffer for the longest
+ * JSON string.
+ */
+struct json_event_parser
+{
+    struct json_event_cb const *cb;	/* JSON event callbacks or NULL */
+    void *data;				/* data pointer given to each callback */
+    enum json_event_state state;	/* what the next token must be */
+    bool *in_object;			/* for each nesting level: true ==> object, false ==> array */
+    size_t depth;			/* current nesting level, 0 ==> top level */
+    size_t max_depth;			/* number of nesting levels allocated in in_object */
+    char *buf;				/* buffer for the current JSON string or NULL */
+    size_t buf_len;			/* allocated length of buf */
+    char const *error;			/* static reason why the JSON is not valid, or NULL */
+    bool stopped;			/* true ==> a callback stopped the parse */
+    bool located;			/* true ==> offset is the byte offset of the token being fed */
+    size_t offset;			/* byte offset in the JSON of the token being fed, if located */
+};
+
+
+/*
+ * external function declarations
+ */
+extern void json_event_init(struct json_event_parser *ep, struct json_event_cb const *cb, void *data);
+extern bool json_event_token(struct json_event_parser *ep, int tok, char const *text, size_t len);
+extern char const *json_event_token_name(int tok);
+extern void json_event_free(struct json_event_parser *ep);
+
+#endif /* INCLUDE_JSON_EVENT_H */
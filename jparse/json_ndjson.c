@@ -0,0 +1,229 @@
+/*
+ * json_ndjson - JSON Lines (NDJSON) record reader
+ *
+ * "Because sometimes JSON comes one line at a time." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+
+/*
+ * jparse - JSON parser
+ */
+#include "jparse.h"
+
+/*
+ * json_ndjson - JSON Lines (NDJSON) record reader
+ */
+#include "json_ndjson.h"
+
+
+/*
+ * json_ndjson_init - initialise a JSON Lines (NDJSON) record reader
+ *
+ * given:
+ *	nd	    pointer to the record reader to initialise
+ *	stream	    open stream to read the records from
+ *	filename    filename for error messages or NULL for stdin
+ *
+ * NOTE: This function does not return on NULL nd or NULL stream.
+ *
+ * NOTE: Free the line buffer and close the stream with json_ndjson_free().
+ */
+void
+json_ndjson_init(struct json_ndjson *nd, FILE *stream, char const *filename)
+{
+    /*
+     * firewall
+     */
+    if (nd == NULL) {
+	err(10, __func__, "nd is NULL");
+	not_reached();
+    }
+    if (stream == NULL) {
+	err(11, __func__, "stream is NULL");
+	not_reached();
+    }
+    if (filename == NULL) {
+	filename = "-";
+    }
+
+    /*
+     * nothing has been read yet
+     */
+    memset(nd, 0, sizeof(*nd));
+    nd->stream = stream;
+    nd->filename = filename;
+    return;
+}
+
+
+/*
+ * json_ndjson_next - read the next record of a JSON Lines (NDJSON) stream
+ *
+ * The newline (and a carriage return before it) that ends the line is not part
+ * of the record.  Lines with nothing but whitespace are skipped.
+ *
+ * given:
+ *	nd	    pointer to an initialised record reader
+ *	rec	    pointer to set to the start of the record (NUL terminated)
+ *	len	    pointer to set to the length of the record
+ *	line	    pointer to set to the line number of the record, or NULL
+ *
+ * return:
+ *	true ==> *rec, *len (and *line) are set to the next record,
+ *	false ==> end of file or a read error
+ *
+ * NOTE: The record is in the line buffer of nd: it is only valid until the
+ *	 next call to json_ndjson_next() or json_ndjson_free().
+ *
+ * NOTE: This function does not return on NULL pointers, and only warns on a
+ *	 read error.
+ */
+bool
+json_ndjson_next(struct json_ndjson *nd, char **rec, size_t *len, int *line)
+{
+    ssize_t readlen = 0;		/* getline(3) return value */
+    size_t end = 0;			/* length of the line without the newline */
+    size_t i = 0;			/* index into the line */
+
+    /*
+     * firewall
+     */
+    if (nd == NULL || nd->stream == NULL) {
+	err(12, __func__, "nd is NULL or not initialised");
+	not_reached();
+    }
+    if (rec == NULL || len == NULL) {
+	err(13, __func__, "rec and/or len is NULL");
+	not_reached();
+    }
+
+    /*
+     * read lines until one has more than whitespace
+     */
+    while (true) {
+	errno = 0;
+	readlen = getline(&nd->buf, &nd->size, nd->stream);
+	if (readlen < 0) {
+	    if (ferror(nd->stream)) {
+		warnp(__func__, "error reading line %d of: %s", nd->line + 1, nd->filename);
+	    }
+	    return false;
+	}
+	++nd->line;
+	nd->bytes += (uintmax_t)readlen;
+
+	/*
+	 * drop the newline and a carriage return before it
+	 */
+	end = (size_t)readlen;
+	if (end > 0 && nd->buf[end-1] == '\n') {
+	    --end;
+	}
+	if (end > 0 && nd->buf[end-1] == '\r') {
+	    --end;
+	}
+	nd->buf[end] = '\0';
+
+	/*
+	 * skip blank lines
+	 */
+	for (i = 0; i < end; ++i) {
+	    if (nd->buf[i] != ' ' && nd->buf[i] != '\t' && nd->buf[i] != '\r') {
+		break;
+	    }
+	}
+	if (i < end) {
+	    break;
+	}
+	dbg(DBG_VVHIGH, "skipping blank line %d of: %s", nd->line, nd->filename);
+    }
+
+    /*
+     * return the record, in place
+     */
+    ++nd->records;
+    *rec = nd->buf;
+    *len = end;
+    if (line != NULL) {
+	*line = nd->line;
+    }
+    return true;
+}
+
+
+/*
+ * json_ndjson_free - free a JSON Lines (NDJSON) record reader
+ *
+ * given:
+ *	nd	    pointer to the record reader to free
+ *
+ * NOTE: The stream is fclose()d (or, for stdin, clearerr()ed).
+ */
+void
+json_ndjson_free(struct json_ndjson *nd)
+{
+    /*
+     * firewall
+     */
+    if (nd == NULL) {
+	return;
+    }
+
+    /*
+     * free the line buffer and close the stream
+     */
+    if (nd->buf != NULL) {
+	free(nd->buf);
+	nd->buf = NULL;
+    }
+    nd->size = 0;
+    if (nd->stream != NULL) {
+	clearerr_or_fclose(nd->stream);
+	nd->stream = NULL;
+    }
+    return;
+}
@@ -0,0 +1,100 @@
+/*
+ * json_ndjson - JSON Lines (NDJSON) record reader
+ *
+ * "Because sometimes JSON comes one line at a time." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+#if !defined(INCLUDE_JSON_NDJSON_H)
+#    define  INCLUDE_JSON_NDJSON_H
+
+
+#include <stdio.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#else
+  #include <c_bool.h>
+  #include <c_compat.h>
+  #include <dbg.h>
+#endif
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "util.h"
+
+
+/*
+ * JSON Lines (NDJSON) record reader
+ *
+ * A JSON Lines file has one JSON document (a record) per line.  The reader
+ * reads the stream one line at a time into a single buffer that is reused for
+ * every record, so the memory needed is that of the longest record no matter
+ * how many records there are.  A record is not copied out of the buffer: it
+ * is only valid until the next call to json_ndjson_next().
+ */
+struct json_ndjson
+{
+    FILE *stream;			/* open stream the records are read from */
+    char const *filename;		/* filename for error messages ("-" means stdin) */
+    char *buf;				/* line buffer, grown by getline(3) to the longest line */
+    size_t size;			/* allocated size of buf */
+    int line;				/* line number of the last line read, 0 ==> none read */
+    intmax_t records;			/* number of records returned */
+    uintmax_t bytes;			/* number of bytes read */
+};
+
+
+/*
+ * external function declarations
+ */
+extern void json_ndjson_init(struct json_ndjson *nd, FILE *stream, char const *filename);
+extern bool json_ndjson_next(struct json_ndjson *nd, char **rec, size_t *len, int *line);
+extern void json_ndjson_free(struct json_ndjson *nd);
+
+#endif /* INCLUDE_JSON_NDJSON_H */
@@ -51,7 +51,9 @@
 #include <limits.h>
 #include <inttypes.h>
 #include <math.h>
+#include <float.h>
 #include <string.h>
+#include <sys/mman.h>
 
 /*
  * util - common utility functions for the JSON parser
@@ -68,13 +70,57 @@
  */
 #include "json_util.h"
 
+/*
+ * fast path of the conversion of JSON numbers
+ *
+ * A JSON floating point or e-notation number whose significant digits fit in
+ * the mantissa of a C floating point type, and whose power of ten is itself
+ * exactly representable in that type, is converted exactly by one multiply or
+ * divide (this is known as Clinger's fast path).  Anything else is converted
+ * by strtold(3) or strtod(3).
+ *
+ * JSON_FAST_DIGITS is the most significant digits that always fit in a uint64_t.
+ *
+ * JSON_FAST_LDBL_POW10_MAX and JSON_FAST_DBL_POW10_MAX are the largest n such
+ * that 10^n is exact in a long double and a double: that is 5^n < 2^MANT_DIG.
+ * A value of -1 disables the fast path for that type.
+ */
+#define JSON_FAST_DIGITS (19)
+#if LDBL_MANT_DIG >= 64
+#define JSON_FAST_LDBL_POW10_MAX (27)
+#elif LDBL_MANT_DIG >= 53
+#define JSON_FAST_LDBL_POW10_MAX (22)
+#else
+#define JSON_FAST_LDBL_POW10_MAX (-1)
+#endif
+#if DBL_MANT_DIG >= 53 && defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+#define JSON_FAST_DBL_POW10_MAX (22)
+#else
+#define JSON_FAST_DBL_POW10_MAX (-1)	/* double rounding is possible if double is evaluated wider */
+#endif
+
 /* for json string decoding */
 static char *decode_json_string(char const *ptr, size_t len, size_t mlen, size_t *retlen);
+static char const *json_decode_esc(char *esc, char const *ptr, size_t len);
 /* for json number strings */
 static bool json_process_decimal(struct json_number *item, char const *str, size_t len);
 static bool json_process_floating(struct json_number *item, char const *str, size_t len);
+static bool json_fast_decimal(char const *str, size_t len, uintmax_t *ret);
+static bool json_fast_scan(char const *str, size_t len, bool *negative, uint64_t *mant, int *exp10);
+static bool json_fast_longdouble(char const *str, size_t len, long double *ret);
+static bool json_fast_double(char const *str, size_t len, double *ret);
 /* for convert JSON encoded string to C string */
 static void posix_safe_chk(char const *str, size_t len, bool *slash, bool *posix_safe, bool *first_alphanum, bool *upper);
+/* for arena allocated JSON parse trees */
+static _Thread_local struct json_arena *json_arena_cur = NULL;	/* this thread's arena for json_alloc() etc., NULL ==> calloc() */
+static void *json_calloc(size_t nmemb, size_t size);
+static struct json **json_arena_set_append(struct json_arena *arena, struct json **set, intmax_t len, struct json *node);
+static struct json_object_index *json_object_index_alloc(struct json *node, size_t size);
+static struct json_object_index *json_object_index_add(struct json *node, struct json_object_index *index,
+						       struct json *member);
+/* for zero-copy JSON parse trees */
+static bool json_input_span(struct json_arena const *arena, char const *ptr, size_t len);
+static void json_input_terminate_node(struct json *node, unsigned int depth, void *ctx);
 
 
 /*
@@ -229,6 +275,7 @@ json_encode(char const *ptr, size_t len, size_t *retlen, bool skip_quote)
     char *beyond = NULL;    /* beyond the end of the allocated encoding string */
     ssize_t mlen = 0;	    /* length of allocated encoded string */
     char *p;		    /* next place to encode */
+    size_t span;	    /* bytes from i that are their own encoding */
     size_t i;
 
     /*
@@ -245,8 +292,18 @@ json_encode(char const *ptr, size_t len, size_t *retlen, bool skip_quote)
 
     /*
      * count the bytes that will be in the encoded allocated string
+     *
+     * Runs of bytes that are their own encoding (see json_encode_span()) are
+     * counted in bulk: only the bytes that are escaped are looked up in
+     * byte2asciistr[].
      */
     for (i=0; i < len; ++i) {
+	span = json_encode_span(ptr+i, len-i);
+	mlen += (ssize_t)span;
+	i += span;
+	if (i >= len) {
+	    break;
+	}
 	mlen += byte2asciistr[(uint8_t)(ptr[i])].len;
     }
     if (mlen < 0) { /* paranoia */
@@ -290,8 +347,31 @@ json_encode(char const *ptr, size_t len, size_t *retlen, bool skip_quote)
 
     /*
      * JSON encode each byte
+     *
+     * As above, runs of bytes that are their own encoding are copied in bulk.
      */
     for (p=ret; i < len; ++i) {
+	span = json_encode_span(ptr+i, len-i);
+	if (span > 0) {
+	    if (p+span > beyond) {
+		/* error - clear allocated length */
+		if (retlen != NULL) {
+		    *retlen = 0;
+		}
+		if (ret != NULL) {
+		    free(ret);
+		    ret = NULL;
+		}
+		warn(__func__, "copy ran beyond end of allocated encoded string");
+		return NULL;
+	    }
+	    memcpy(p, ptr+i, span);
+	    p += span;
+	    i += span;
+	    if (i >= len) {
+		break;
+	    }
+	}
 	if (p+byte2asciistr[(uint8_t)(ptr[i])].len > beyond) {
 	    /* error - clear allocated length */
 	    if (retlen != NULL) {
@@ -1306,6 +1386,13 @@ chkbyte2asciistr(void)
 	    not_reached();
 	}
 
+	/* json_encode() copies the bytes json_encode_span() passes over as they are */
+	if ((json_encode_span(str, 1) == 1) != (byte2asciistr[i].len == 1 && byte2asciistr[i].enc[0] == str[0])) {
+	    err(57, __func__, "json_encode_span() of 0x%02x disagrees with byte2asciistr[0x%02x].len: %zu",
+			      i, i, byte2asciistr[i].len);
+	    not_reached();
+	}
+
 	/* free the allocated encoded string */
 	if (mstr != NULL) {
 	    free(mstr);
@@ -1325,6 +1412,35 @@ chkbyte2asciistr(void)
 }
 
 
+/*
+ * json_decode_esc - copy the bytes of a \-escape that json_decode() looks at
+ *
+ * The hex digits of a \uxxxx (or \uxxxx\uxxxx) escape are read with sscanf(),
+ * which needs a NUL terminated string: given the block itself, sscanf() would
+ * find the length of ALL the rest of the block (and beyond, if the block is not
+ * NUL terminated) for each \u.  Instead the at most JSON_DECODE_ESC_MAX bytes of
+ * the escape that are within the block are copied to esc and NUL terminated.
+ *
+ * given:
+ *	esc	buffer of at least JSON_DECODE_ESC_MAX+1 bytes
+ *	ptr	start of the \-escape
+ *	len	bytes left in the block from ptr onward
+ *
+ * returns:
+ *	esc
+ */
+static char const *
+json_decode_esc(char *esc, char const *ptr, size_t len)
+{
+    if (len > JSON_DECODE_ESC_MAX) {
+	len = JSON_DECODE_ESC_MAX;
+    }
+    memcpy(esc, ptr, len);
+    esc[len] = '\0';
+    return esc;
+}
+
+
 /*
  * decode_json_string - return the decoding of a JSON encoded block of memory
  *
@@ -1355,6 +1471,8 @@ decode_json_string(char const *ptr, size_t len, size_t mlen, size_t *retlen)
     int32_t surrogate = 0;
     char *utf8 = NULL;
     int scanned = 0;
+    size_t span = 0;	    /* number of bytes to copy as they are */
+    char esc[JSON_DECODE_ESC_MAX + 1];	/* NUL terminated copy of a \uxxxx escape */
 
     /*
      * firewall
@@ -1410,6 +1528,34 @@ decode_json_string(char const *ptr, size_t len, size_t mlen, size_t *retlen)
 	    return NULL;
 	}
 
+	/*
+	 * copy the bytes up to the next \-escape (or ", or control byte) at once
+	 */
+	span = json_string_span(ptr + i, len - i);
+	if (span > 0) {
+	    /*
+	     * paranoia
+	     */
+	    if (span > (size_t)(beyond - p)) {
+		/* error - clear allocated length and buffer */
+		if (retlen != NULL) {
+		    *retlen = 0;
+		}
+		free(ret);
+		ret = NULL;
+
+		warn(__func__, "ran beyond end of decoded string");
+		return NULL;
+	    }
+	    memcpy(p, ptr + i, span);
+	    p += span;
+	    utf8 += span;
+	    i += span;
+	    if (i >= len) {
+		break;
+	    }
+	}
+
 	/*
 	 * examine the current character
 	 */
@@ -1502,7 +1648,7 @@ decode_json_string(char const *ptr, size_t len, size_t mlen, size_t *retlen)
 		 * we check for a second \uxxxx first, in case it is a surrogate
 		 * pair
 		 */
-		scanned = sscanf(ptr + i + 2, "%4x\\u%4x", &xa, &xb);
+		scanned = sscanf(json_decode_esc(esc, ptr + i, len - i) + 2, "%4x\\u%4x", &xa, &xb);
 		if (scanned == EOF) {
 		    /* error - clear allocated length and free buffer */
 		    if (retlen != NULL) {
@@ -1644,33 +1790,25 @@ decode_json_string(char const *ptr, size_t len, size_t mlen, size_t *retlen)
 
 
 /*
- * json_decode - return the decoding of a JSON encoded block of memory
+ * json_decode_len - validate a JSON encoded block of memory and return its decoded length
  *
  * given:
- *	ptr	    start of memory block to decode
+ *	ptr	    start of memory block to decode, w/o any surrounding double quotes
  *	len	    length of block to decode in bytes
- *	quote       true ==> require surrounding double quotes ("s)
- *	retlen	    address of where to store allocated length, if retlen != NULL
- *
+ *	mlen	    address of where to store the length of the decoded block
  *
  * returns:
- *	allocated JSON decoding of a block, or NULL ==> error
- *	NOTE: retlen, if non-NULL, is set to 0 on error
- *
- * NOTE: this does not convert a Unicode character like a letter with a
- * diacritic or an emoji to its code point. In fact, for reasons we do not
- * comprehend, the following is perfectly valid JSON:
+ *	true ==> block is a valid JSON encoding, *mlen set,
+ *	false ==> block is not a valid JSON encoding
  *
- *      { "🔥" "🐉" }
- *
- * Instead, if one were to pass to this function the string "\\", it would
- * return "\\\\", for example.
+ * NOTE: This function does not allocate memory.  It is the first pass of
+ *	 json_decode() and it is also used by json_conv_string() and the JSON event
+ *	 parser (see json_event.c) to validate a JSON string without decoding it.
  */
-char *
-json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
+bool
+json_decode_len(char const *ptr, size_t len, size_t *mlen)
 {
-    char *ret = NULL;	    /* allocated encoding string or NULL */
-    size_t mlen = 0;	    /* length of allocated encoded string */
+    size_t count = 0;	    /* length of the decoded block */
     char n = 0;		    /* next character beyond a \\ */
     char c = 0;		    /* character to decode or third hex character after \u */
     uint32_t xa = 0;        /* first hex number for \uxxxx (if surrogates) */
@@ -1679,40 +1817,19 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
     int scanned = 0;	    /* for sscanf() */
     size_t i;
     size_t bytes = 0;	    /* for utf8len() */
+    size_t span = 0;	    /* number of bytes that count as 1 each */
+    char esc[JSON_DECODE_ESC_MAX + 1];	/* NUL terminated copy of a \uxxxx escape */
 
     /*
      * firewall
      */
     if (ptr == NULL) {
-	/* error - clear allocated length */
-	if (retlen != NULL) {
-	    *retlen = 0;
-	}
 	warn(__func__, "called with NULL ptr");
-	return NULL;
+	return false;
     }
-
-    if (quote) {
-	/*
-	 * firewall
-	 */
-	if (len < 2) {
-	    warn(__func__, "quote === true: called with len: %zu < 2", len);
-	    return NULL;
-	}
-	if (ptr[0] != '"') {
-	    warn(__func__, "quote === true: string does NOT start with a \"");
-	    return NULL;
-	}
-	if (ptr[len-1] != '"') {
-	    warn(__func__, "quote === true: string does NOT end with a \"");
-	    return NULL;
-	}
-	/*
-	 * ignore JSON surrounding '"'s
-	 */
-	++ptr;
-	len -= 2;
+    if (mlen == NULL) {
+	warn(__func__, "called with NULL mlen");
+	return false;
     }
 
     /*
@@ -1720,6 +1837,16 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
      */
     for (i=0; i < len; ++i) {
 
+	/*
+	 * count the bytes up to the next \-escape (or ", or control byte) at once
+	 */
+	span = json_string_span(ptr + i, len - i);
+	count += span;
+	i += span;
+	if (i >= len) {
+	    break;
+	}
+
 	/*
 	 * examine the current character
 	 */
@@ -1741,19 +1868,15 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 	    case '\r':  /*fallthrough*/
 	    case '"':   /*fallthrough*/
 	    case '\\':
-		/* error - clear allocated length */
-		if (retlen != NULL) {
-		    *retlen = 0;
-		}
 		warn(__func__, "found non-\\-escaped char: 0x%02x", (uint8_t)c);
-		return NULL;
+		return false;
 		break;
 
 	    /*
 	     * count a valid character
 	     */
 	    default:
-		++mlen;
+		++count;
 		break;
 	    }
 
@@ -1766,12 +1889,8 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 	     * there must be at least one more character beyond \
 	     */
 	    if (i+1 >= len) {
-		/* error - clear allocated length */
-		if (retlen != NULL) {
-		    *retlen = 0;
-		}
 		warn(__func__, "found \\ at end of buffer, missing next character");
-		return NULL;
+		return false;
 	    }
 
 	    /*
@@ -1794,7 +1913,7 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 		/*
 		 * count \c escaped pair as 1 character
 		 */
-		++mlen;
+		++count;
 		++i;
 		break;
 
@@ -1806,36 +1925,24 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 		 * there must be at least five more characters beyond \
 		 */
 		if (i+5 >= len) {
-		    /* error - clear allocated length */
-		    if (retlen != NULL) {
-			*retlen = 0;
-		    }
 		    warn(__func__, "found \\u, but not enough for 4 hex chars at end of buffer");
-		    return NULL;
+		    return false;
 		}
 		xa = 0;
 		xb = 0;
-		scanned = sscanf(ptr + i + 2, "%4x\\u%4x", &xa, &xb);
+		scanned = sscanf(json_decode_esc(esc, ptr + i, len - i) + 2, "%4x\\u%4x", &xa, &xb);
 		if (scanned == EOF) {
-		    /* error - clear allocated length and free buffer */
-		    if (retlen != NULL) {
-			*retlen = 0;
-		    }
-
 		    warn(__func__, "reached EOF trying to scan for hex bytes");
-		    return NULL;
+		    return false;
 		} else if (scanned == 1 || (scanned == 2 && surrogate_pair_to_codepoint((int32_t)xa, (int32_t)xb) < 0)) {
 		    surrogate = xa;
-		    bytes = utf8len(ptr + i, surrogate);
-		    if (bytes <= 0) {
-			if (retlen != NULL) {
-			    *retlen = 0;
-			}
+		    bytes = utf8len(esc, surrogate);
+		    if (bytes <= 0 || bytes == (size_t)-1) {
 			/* utf8len() already warns */
-			return NULL;
+			return false;
 		    }
 		    dbg(DBG_VVHIGH, "UTF-8 bytes: %zu", bytes);
-		    mlen += bytes;
+		    count += bytes;
 		    i += 5;
 		} else if (scanned == 2) {
 		    /*
@@ -1844,12 +1951,9 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 		     */
 		    surrogate = surrogate_pair_to_codepoint((int32_t)xa, (int32_t)xb);
 		    if (surrogate < 0) {
-			if (retlen != NULL) {
-			    *retlen = 0;
-			}
 			warn(__func__, "surrogate pair invalid: \\u%X\\u%X", xa, xb);
 
-			return NULL;
+			return false;
 		    }
 
 		    /*
@@ -1857,15 +1961,12 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 		     * try counting the bytes needed.
 		     */
 		    bytes = utf8len(NULL, surrogate);
-		    if (bytes <= 0) {
-			if (retlen != NULL) {
-			    *retlen = 0;
-			}
+		    if (bytes <= 0 || bytes == (size_t)-1) {
 			/* utf8len() already warns */
-			return NULL;
+			return false;
 		    }
 		    dbg(DBG_VVHIGH, "UTF-8 bytes: %zu", bytes);
-		    mlen += bytes;
+		    count += bytes;
 
 		    /*
 		     * we skip 11 instead of 5 because 5 + LITLEN("\\uxxxx") is
@@ -1873,12 +1974,8 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 		     */
 		    i += 11;
 		} else {
-		    /* error - clear allocated length and free buffer */
-		    if (retlen != NULL) {
-			*retlen = 0;
-		    }
 		    warn(__func__, "did not read \\uxxxx hex value");
-		    return NULL;
+		    return false;
 		}
 
 		break;
@@ -1887,71 +1984,53 @@ json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 	     * found invalid JSON \-escape character
 	     */
 	    default:
-		/* error - clear allocated length */
-		if (retlen != NULL) {
-		    *retlen = 0;
-		}
 		warn(__func__, "found invalid JSON \\-escape: followed by 0x%02x", (uint8_t)c);
-		return NULL;
+		return false;
 	    }
 	}
     }
 
-   /*
-     * decode JSON string
-     */
-    ret = decode_json_string(ptr, (uintmax_t)len, (uintmax_t)mlen, retlen);
-
     /*
-     * return result, if not NULL
+     * return the decoded length
      */
-    if (ret != NULL) {
-	dbg(DBG_VVVHIGH, "returning from json_decode(ptr, %zu, *%zu, %s): %s",
-			 len, mlen, booltostr(quote), ret);
-    } else {
-	dbg(DBG_VVVHIGH, "in json_decode(): decode_json_string(ptr, %zu, *%zu) returned NULL",
-			 len, mlen);
-	if (retlen != NULL) {
-	    *retlen = 0;
-	}
-	return NULL;
-    }
-    return ret;
+    *mlen = count;
+    return true;
 }
 
 
 /*
- * json_decode_str - return a JSON decoding of a string
- *
- * This is a simplified interface for json_decode().
+ * json_decode - return the decoding of a JSON encoded block of memory
  *
  * given:
- *	str	    NUL terminated C-style string to decode
- *	quote       assume double quotes surrounding the string
+ *	ptr	    start of memory block to decode
+ *	len	    length of block to decode in bytes
+ *	quote       true ==> require surrounding double quotes ("s)
  *	retlen	    address of where to store allocated length, if retlen != NULL
  *
+ *
  * returns:
  *	allocated JSON decoding of a block, or NULL ==> error
+ *	NOTE: retlen, if non-NULL, is set to 0 on error
  *
- * NOTE: retlen, if non-NULL, is set to 0 on error
+ * NOTE: this does not convert a Unicode character like a letter with a
+ * diacritic or an emoji to its code point. In fact, for reasons we do not
+ * comprehend, the following is perfectly valid JSON:
  *
- * NOTE: This function assumes that str is a valid C-style string with a terminating
- *	 NUL byte.  This code assumes that the first NUL byte found is the end of
- *	 the string.  When working with raw binary data, or data that could have
- *	 a NUL byte inside the block of memory (instead at the very end), this
- *	 function should NOT be used.  In such cases, json_decode() should
- *	 be used instead!
+ *      { "🔥" "🐉" }
+ *
+ * Instead, if one were to pass to this function the string "\\", it would
+ * return "\\\\", for example.
  */
 char *
-json_decode_str(char const *str, bool quote, size_t *retlen)
+json_decode(char const *ptr, size_t len, bool quote, size_t *retlen)
 {
-    void *ret = NULL;	    /* allocated decoding string or NULL */
-    size_t len = 0;	    /* length of string to decode */
+    char *ret = NULL;	    /* allocated encoding string or NULL */
+    size_t mlen = 0;	    /* length of allocated encoded string */
 
     /*
      * firewall
      */
-    if (str == NULL) {
+    if (ptr == NULL) {
 	/* error - clear allocated length */
 	if (retlen != NULL) {
 	    *retlen = 0;
@@ -1960,42 +2039,222 @@ json_decode_str(char const *str, bool quote, size_t *retlen)
 	return NULL;
     }
 
-    if (retlen != NULL) {
+    if (quote) {
 	/*
-	 * set *retlen = 0
+	 * firewall
 	 */
-	*retlen = 0;
+	if (len < 2) {
+	    warn(__func__, "quote === true: called with len: %zu < 2", len);
+	    return NULL;
+	}
+	if (ptr[0] != '"') {
+	    warn(__func__, "quote === true: string does NOT start with a \"");
+	    return NULL;
+	}
+	if (ptr[len-1] != '"') {
+	    warn(__func__, "quote === true: string does NOT end with a \"");
+	    return NULL;
+	}
+	/*
+	 * ignore JSON surrounding '"'s
+	 */
+	++ptr;
+	len -= 2;
     }
 
-    len = strlen(str);
-
     /*
-     * convert to json_decode() call
+     * count the bytes that will be in the decoded allocated string
      */
-    ret = json_decode(str, len, quote, retlen);
-    if (ret == NULL) {
-        if (retlen != NULL) {
-            *retlen = 0;
-        }
-	dbg(DBG_VVHIGH, "returning NULL for decoding of: <%s>", str);
-    } else {
-	dbg(DBG_VVHIGH, "string: <%s> JSON decoded", str);
+    if (json_decode_len(ptr, len, &mlen) == false) {
+	/* error - clear allocated length */
 	if (retlen != NULL) {
-	    dbg(DBG_VVHIGH, "retlen for <%s> is %zu", str, *retlen);
+	    *retlen = 0;
 	}
+	return NULL;
     }
 
-
+   /*
+     * decode JSON string
+     */
+    ret = decode_json_string(ptr, (uintmax_t)len, (uintmax_t)mlen, retlen);
 
     /*
-     * return decoded result or NULL
+     * return result, if not NULL
      */
+    if (ret != NULL) {
+	dbg(DBG_VVVHIGH, "returning from json_decode(ptr, %zu, *%zu, %s): %s",
+			 len, mlen, booltostr(quote), ret);
+    } else {
+	dbg(DBG_VVVHIGH, "in json_decode(): decode_json_string(ptr, %zu, *%zu) returned NULL",
+			 len, mlen);
+	if (retlen != NULL) {
+	    *retlen = 0;
+	}
+	return NULL;
+    }
     return ret;
 }
 
 
 /*
- * json_parse_string - parse a json string
+ * json_decode_cut - find where a block of a JSON encoded string may be cut for decoding
+ *
+ * A JSON encoded string that is too large to decode at once (for instance
+ * jstrdecode -S) can be decoded in pieces, as long as no piece ends inside a
+ * \-escape.  This function returns the length of the longest prefix of the
+ * block that ends between two escapes (or other bytes) and in which every
+ * \-escape has all of the bytes that json_decode() looks at: the 12 bytes of a
+ * \uxxxx\uxxxx surrogate pair, JSON_DECODE_ESC_MAX, even if the escape turns
+ * out to be shorter.  The bytes from the cut onward must be decoded along with
+ * the bytes that follow them.
+ *
+ * given:
+ *	ptr	start of a block of a JSON encoded string, without any enclosing "
+ *	len	length of the block in bytes
+ *
+ * returns:
+ *	length of the prefix of the block that can be decoded on its own,
+ *	0 ==> NULL ptr, or the block starts with an escape that needs more bytes
+ *
+ * NOTE: This function does not check the escapes: json_decode() does that
+ *	 when the prefix is decoded.
+ */
+size_t
+json_decode_cut(char const *ptr, size_t len)
+{
+    char esc[JSON_DECODE_ESC_MAX + 1];	/* NUL terminated copy of a \uxxxx escape */
+    uint32_t xa = 0;			/* first hex number for \uxxxx (if surrogates) */
+    uint32_t xb = 0;			/* second hex number for \uxxxx (if surrogates) */
+    int scanned = 0;			/* for sscanf() */
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (ptr == NULL) {
+	warn(__func__, "called with NULL ptr");
+	return 0;
+    }
+
+    /*
+     * step over the block, an escape at a time
+     */
+    for (i = 0; i < len; ) {
+
+	/*
+	 * skip to the next \ (or ", or control byte)
+	 */
+	i += json_string_span(ptr + i, len - i);
+	if (i >= len) {
+	    break;
+	}
+	if (ptr[i] != '\\') {
+	    ++i;
+	    continue;
+	}
+
+	/*
+	 * cut before an escape that may not be all here
+	 */
+	if (len - i < JSON_DECODE_ESC_MAX) {
+	    return i;
+	}
+
+	/*
+	 * step over the escape: like json_decode_len(), a \uxxxx followed by a
+	 * \uxxxx that together are a valid surrogate pair is one escape
+	 */
+	if (ptr[i+1] != 'u') {
+	    i += 2;
+	    continue;
+	}
+	scanned = sscanf(json_decode_esc(esc, ptr + i, len - i) + 2, "%4x\\u%4x", &xa, &xb);
+	if (scanned == 2 && surrogate_pair_to_codepoint((int32_t)xa, (int32_t)xb) >= 0) {
+	    i += 12;
+	} else {
+	    i += 6;
+	}
+    }
+    return len;
+}
+
+
+/*
+ * json_decode_str - return a JSON decoding of a string
+ *
+ * This is a simplified interface for json_decode().
+ *
+ * given:
+ *	str	    NUL terminated C-style string to decode
+ *	quote       assume double quotes surrounding the string
+ *	retlen	    address of where to store allocated length, if retlen != NULL
+ *
+ * returns:
+ *	allocated JSON decoding of a block, or NULL ==> error
+ *
+ * NOTE: retlen, if non-NULL, is set to 0 on error
+ *
+ * NOTE: This function assumes that str is a valid C-style string with a terminating
+ *	 NUL byte.  This code assumes that the first NUL byte found is the end of
+ *	 the string.  When working with raw binary data, or data that could have
+ *	 a NUL byte inside the block of memory (instead at the very end), this
+ *	 function should NOT be used.  In such cases, json_decode() should
+ *	 be used instead!
+ */
+char *
+json_decode_str(char const *str, bool quote, size_t *retlen)
+{
+    void *ret = NULL;	    /* allocated decoding string or NULL */
+    size_t len = 0;	    /* length of string to decode */
+
+    /*
+     * firewall
+     */
+    if (str == NULL) {
+	/* error - clear allocated length */
+	if (retlen != NULL) {
+	    *retlen = 0;
+	}
+	warn(__func__, "called with NULL ptr");
+	return NULL;
+    }
+
+    if (retlen != NULL) {
+	/*
+	 * set *retlen = 0
+	 */
+	*retlen = 0;
+    }
+
+    len = strlen(str);
+
+    /*
+     * convert to json_decode() call
+     */
+    ret = json_decode(str, len, quote, retlen);
+    if (ret == NULL) {
+        if (retlen != NULL) {
+            *retlen = 0;
+        }
+	dbg(DBG_VVHIGH, "returning NULL for decoding of: <%s>", str);
+    } else {
+	dbg(DBG_VVHIGH, "string: <%s> JSON decoded", str);
+	if (retlen != NULL) {
+	    dbg(DBG_VVHIGH, "retlen for <%s> is %zu", str, *retlen);
+	}
+    }
+
+
+
+    /*
+     * return decoded result or NULL
+     */
+    return ret;
+}
+
+
+/*
+ * json_parse_string - parse a json string
  *
  * given:
  *
@@ -2346,6 +2605,9 @@ json_parse_member(struct json *name, struct json *value)
  * returns:
  *	pointer to an initialized the JSON parse tree item
  *
+ * NOTE: If an arena has been set by json_arena_set(), the item is allocated
+ *	 from that arena and item->arena is set to that arena.
+ *
  * NOTE: This function will not return on calloc error.
  * NOTE: This function will not return NULL.
  */
@@ -2377,7 +2639,7 @@ json_alloc(enum item_type type)
      * allocate the JSON parse tree item
      */
     errno = 0;			/* pre-clear errno for errp() */
-    ret = calloc(1, sizeof(*ret));
+    ret = json_calloc(1, sizeof(*ret));
     if (ret == NULL) {
 	errp(11, __func__, "calloc #0 error allocating %zu bytes", sizeof(*ret));
 	not_reached();
@@ -2388,6 +2650,7 @@ json_alloc(enum item_type type)
      */
     ret->type = type;
     ret->parent = NULL;
+    ret->arena = json_arena_cur;
 
     /*
      * paranoia - explicitly elements in the "struct json_foo" structure
@@ -2477,6 +2740,7 @@ json_alloc(enum item_type type)
 	    item->converted = false;
 	    item->set = NULL;
 	    item->s = NULL;
+	    item->index = NULL;
 	};
 	break;
     case JTYPE_ARRAY:
@@ -2513,664 +2777,1962 @@ json_alloc(enum item_type type)
 
 
 /*
- * json_process_decimal - process a JSON integer string
- *
- * We will fill out the struct json_number item assuming that ptr, with length len,
- * points to a JSON integer string of base 10 ASCII as allowed by the so-called JSON spec.
+ * json_arena_create - create an empty arena for a JSON parse tree
  *
  * given:
- *	item	pointer to a JSON number structure (struct json_number*)
- *	str	JSON integer as a NUL terminated C-style string
- *	len	length of the JSON number that is not whitespace
- *
- * NOTE: This function assumes that str points to the start of a JSON number, NOT whitespace.
+ *	chunk_size	default size in bytes of the chunks of the arena,
+ *			0 ==> use JSON_ARENA_CHUNK
  *
- * NOTE: This function assumes that str is a NUL terminated string,
- *	 even if the NUL is well beyond the end of the JSON number.
+ * returns:
+ *	pointer to an allocated empty arena
  *
- * NOTE: While it is OK if str has trailing whitespace, str[len-1] must be an
- *	 ASCII digit.  It is assumed that str[len-1] is the final JSON number character.
+ * NOTE: No chunk is allocated until the first call to json_arena_alloc().
  *
- * NOTE: although we use the term ASCII, isascii() is not used because it was
- * removed from POSIX. Instead we cast the arg to the ctype.h functions/macros
- * (the is*() ones) to an unsigned char because the standard states that,
- * although the arg is an int, it is undefined if it is not representable as an
- * unsigned char or EOF.
+ * NOTE: This function will not return on calloc error.
+ * NOTE: This function will not return NULL.
  */
-static bool
-json_process_decimal(struct json_number *item, char const *str, size_t len)
+struct json_arena *
+json_arena_create(size_t chunk_size)
 {
-    char *endptr;			/* first invalid character or str */
-    size_t str_len = 0;			/* length as a C string, of str */
+    struct json_arena *arena = NULL;	    /* arena to return */
 
     /*
-     * firewall
+     * allocate the arena
      */
-    if (item == NULL) {
-	warn(__func__, "called with NULL item");
-	return false;	/* processing failed */
-    }
-    if (str == NULL) {
-	warn(__func__, "called with NULL str");
-	return false;	/* processing failed */
-    }
-    if (len <= 0) {
-	warn(__func__, "called with len: %zu <= 0", len);
-	return false;	/* processing failed */
-    }
-    if (str[0] == '\0') {
-	warn(__func__, "called with empty string");
-	return false;	/* processing failed */
-    }
-    if (!isdigit((unsigned char)str[len-1])) {
-	warn(__func__, "str[%zu-1] is not an ASCII digit: 0x%02x for str: %s", len, (int)str[len-1], str);
-	return false;	/* processing failed */
-    }
-    str_len = strlen(str);
-    if (str_len < len) {
-	warn(__func__, "strlen(%s): %zu < len arg: %zu", str, str_len, len);
-	return false;	/* processing failed */
+    errno = 0;			/* pre-clear errno for errp() */
+    arena = calloc(1, sizeof(*arena));
+    if (arena == NULL) {
+	errp(45, __func__, "calloc error allocating %zu bytes", sizeof(*arena));
+	not_reached();
     }
 
     /*
-     * determine if JSON integer negative
+     * initialize the arena
      */
-    if (str[0] == '-') {
-
-	/* parse JSON integer that is < 0 */
-	item->is_negative = true;
+    arena->chunk = NULL;
+    arena->chunk_size = (chunk_size > 0) ? chunk_size : JSON_ARENA_CHUNK;
+    arena->allocs = 0;
+    arena->bytes = 0;
+    arena->chunks = 0;
+    arena->input = NULL;
 
-        /*
-	 * JSON spec detail: lone - invalid JSON
-	 */
-	if (len <= 1 || str[1] == '\0') {
-	    dbg(DBG_HIGH, "in %s(): called with just -: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
+    return arena;
+}
 
-        /*
-	 * JSON spec detail: leading -0 followed by digits - invalid JSON
-	 */
-	} else if (len > 2 && str[1] == '0' && isdigit((unsigned char)str[2])) {
-	    dbg(DBG_HIGH, "in %s(): called with -0 followed by more digits: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-	}
 
-    /* case: JSON integer is >= 0 */
-    } else {
+/*
+ * json_arena_alloc - allocate zeroized storage from an arena
+ *
+ * given:
+ *	arena	arena to allocate from
+ *	size	number of bytes to allocate
+ *
+ * returns:
+ *	pointer to size bytes of zeroized storage, aligned to JSON_ARENA_ALIGN
+ *
+ * A new chunk is added to the arena when the current chunk is too full.
+ * An allocation larger than the default chunk size is given a chunk of its own.
+ *
+ * NOTE: Storage returned by this function must NOT be passed to free(3).
+ *	 It is freed when the arena is freed by json_arena_free().
+ *
+ * NOTE: This function will not return on NULL arena or calloc error.
+ * NOTE: This function will not return NULL.
+ */
+void *
+json_arena_alloc(struct json_arena *arena, size_t size)
+{
+    struct json_arena_chunk *chunk = NULL;  /* chunk to allocate from */
+    size_t chunk_size = 0;		    /* size of a new chunk */
+    void *ret = NULL;			    /* storage to return */
 
-	/* parse JSON integer that is >= 0 */
-	item->is_negative = false;
+    /*
+     * firewall
+     */
+    if (arena == NULL) {
+	err(46, __func__, "arena is NULL");
+	not_reached();
+    }
 
-        /*
-	 * JSON spec detail: leading 0 followed by digits - invalid JSON
-	 */
-	if (len > 1 && str[0] == '0' && isdigit((unsigned char)str[1])) {
-	    dbg(DBG_HIGH, "in %s(): called with 0 followed by more digits: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-	}
+    /*
+     * round size up so that the next allocation is also aligned
+     */
+    if (size == 0) {
+	size = 1;
+    }
+    if (size > SIZE_MAX - JSON_ARENA_ALIGN) {
+	err(47, __func__, "cannot allocate %zu bytes from an arena", size);
+	not_reached();
     }
+    size = (size + JSON_ARENA_ALIGN - 1) & ~(JSON_ARENA_ALIGN - 1);
 
     /*
-     * attempt to convert to the largest possible integer
+     * add a new chunk if the current chunk is missing or too full
      */
-    if (item->is_negative) {
+    chunk = arena->chunk;
+    if (chunk == NULL || chunk->size - chunk->used < size) {
 
-	/* case: negative, try for largest signed integer */
+	chunk_size = (size > arena->chunk_size) ? size : arena->chunk_size;
 	errno = 0;			/* pre-clear errno for errp() */
-	item->as_maxint = strtoimax(str, &endptr, 10);
-	if (errno == ERANGE || errno == EINVAL || endptr == str || endptr == NULL) {
-	    if (errno == ERANGE) {
-		dbg(DBG_VVVHIGH, "negative integer out of range, strtoimax failed to convert");
-	    } else {
-		dbg(DBG_VVVHIGH, "invalid negative integer, strtoimax failed to convert");
-	    }
-	    return false;	/* processing failed */
+	chunk = calloc(1, sizeof(*chunk) + chunk_size);
+	if (chunk == NULL) {
+	    errp(48, __func__, "calloc error allocating %zu bytes", sizeof(*chunk) + chunk_size);
+	    not_reached();
 	}
-	item->maxint_sized = true;
-	dbg(DBG_VVVHIGH, "strtoimax for <%s> returned: %zd", str, item->as_maxint);
+	chunk->size = chunk_size;
+	chunk->used = 0;
 
-	/* case int8_t: range check */
-	if (item->as_maxint >= (intmax_t)INT8_MIN && item->as_maxint <= (intmax_t)INT8_MAX) {
-	    item->int8_sized = true;
-	    item->as_int8 = (int8_t)item->as_maxint;
+	/*
+	 * an oversized allocation does not replace the chunk being filled
+	 */
+	if (arena->chunk != NULL && chunk_size > arena->chunk_size) {
+	    chunk->next = arena->chunk->next;
+	    arena->chunk->next = chunk;
+	} else {
+	    chunk->next = arena->chunk;
+	    arena->chunk = chunk;
 	}
+	++arena->chunks;
+	json_dbg(JSON_DBG_VVHIGH, __func__, "added arena chunk #%ju of %zu bytes", arena->chunks, chunk_size);
+    }
 
-	/* case uint8_t: cannot be because JSON string is < 0 */
-	item->uint8_sized = false;
+    /*
+     * carve out the storage
+     *
+     * NOTE: chunks are calloc()ed and never reused so the storage is already zeroized.
+     */
+    ret = (char *)chunk->data + chunk->used;
+    chunk->used += size;
+    ++arena->allocs;
+    arena->bytes += size;
 
-	/* case int16_t: range check */
-	if (item->as_maxint >= (intmax_t)INT16_MIN && item->as_maxint <= (intmax_t)INT16_MAX) {
-	    item->int16_sized = true;
-	    item->as_int16 = (int16_t)item->as_maxint;
-	}
+    return ret;
+}
 
-	/* case uint16_t: cannot be because JSON string is < 0 */
-	item->uint16_sized = false;
 
-	/* case int32_t: range check */
-	if (item->as_maxint >= (intmax_t)INT32_MIN && item->as_maxint <= (intmax_t)INT32_MAX) {
-	    item->int32_sized = true;
-	    item->as_int32 = (int32_t)item->as_maxint;
-	}
+/*
+ * json_arena_free - free an arena and all storage allocated from it
+ *
+ * given:
+ *	arena	arena to free
+ *
+ * NOTE: After this call any JSON parse tree node, string or node set allocated
+ *	 from the arena is no longer valid.  The arena itself is also freed.
+ *
+ * NOTE: This function does nothing if arena == NULL.
+ */
+void
+json_arena_free(struct json_arena *arena)
+{
+    struct json_arena_chunk *chunk = NULL;  /* chunk to free */
+    struct json_arena_chunk *next = NULL;   /* next chunk to free */
 
-	/* case uint32_t: cannot be because JSON string is < 0 */
-	item->uint32_sized = false;
+    /*
+     * firewall - nothing to do for a NULL arena
+     */
+    if (arena == NULL) {
+	return;
+    }
 
-	/* case int64_t: range check */
-	if (item->as_maxint >= (intmax_t)INT64_MIN && item->as_maxint <= (intmax_t)INT64_MAX) {
-	    item->int64_sized = true;
-	    item->as_int64 = (int64_t)item->as_maxint;
-	}
+    json_dbg(JSON_DBG_VHIGH, __func__, "freeing arena: %ju chunks, %ju allocations, %ju bytes",
+			      arena->chunks, arena->allocs, arena->bytes);
 
-	/* case uint64_t: cannot be because JSON string is < 0 */
-	item->uint64_sized = false;
+    /*
+     * free the chunks of the arena
+     */
+    for (chunk = arena->chunk; chunk != NULL; chunk = next) {
+	next = chunk->next;
+	free(chunk);
+    }
 
-	/* case int: range check */
-	if (item->as_maxint >= (intmax_t)INT_MIN && item->as_maxint <= (intmax_t)INT_MAX) {
-	    item->int_sized = true;
-	    item->as_int = (int)item->as_maxint;
-	}
+    /*
+     * release the input buffer referenced by the tree, if any
+     */
+    json_input_free(arena->input);
+    arena->input = NULL;
 
-	/* case unsigned int: cannot be because JSON string is < 0 */
-	item->uint_sized = false;
+    /*
+     * free the arena
+     */
+    memset(arena, 0, sizeof(*arena));
+    free(arena);
+    return;
+}
 
-	/* case long: range check */
-	if (item->as_maxint >= (intmax_t)LONG_MIN && item->as_maxint <= (intmax_t)LONG_MAX) {
-	    item->long_sized = true;
-	    item->as_long = (long)item->as_maxint;
-	}
 
-	/* case unsigned long: cannot be because JSON string is < 0 */
-	item->ulong_sized = false;
+/*
+ * json_arena_set - set the arena used to allocate JSON parse tree nodes
+ *
+ * While an arena is set, json_alloc(), the json_conv_*() functions and the
+ * json_create_*() and json_*_add_*() functions allocate the nodes, strings
+ * and node sets from the arena instead of calloc()ing them.
+ *
+ * The arena is set for the calling thread only, so that threads may each
+ * parse into their own arena at the same time.
+ *
+ * given:
+ *	arena	arena to allocate from, or NULL ==> go back to calloc()
+ *
+ * returns:
+ *	the previously set arena, or NULL if no arena was set
+ *
+ * NOTE: Most callers want parse_json_arena() and friends instead.
+ */
+struct json_arena *
+json_arena_set(struct json_arena *arena)
+{
+    struct json_arena *prev = json_arena_cur;	/* previously set arena */
 
-	/* case long long: range check */
-	if (item->as_maxint >= (intmax_t)LLONG_MIN && item->as_maxint <= (intmax_t)LLONG_MAX) {
-	    item->longlong_sized = true;
-	    item->as_longlong = (long long)item->as_maxint;
-	}
+    json_arena_cur = arena;
+    return prev;
+}
 
-	/* case unsigned long long: cannot be because JSON string is < 0 */
-	item->ulonglong_sized = false;
 
-	/* case size_t: cannot be because JSON string is < 0 */
-	item->size_sized = false;
+/*
+ * json_calloc - allocate zeroized storage for a JSON parse tree
+ *
+ * given:
+ *	nmemb	number of elements
+ *	size	size of an element
+ *
+ * returns:
+ *	storage from the current arena if one is set, else calloc()ed storage
+ *
+ * NOTE: Like calloc(3) this function returns NULL on calloc error.
+ */
+static void *
+json_calloc(size_t nmemb, size_t size)
+{
+    /*
+     * case: no arena, use calloc
+     */
+    if (json_arena_cur == NULL) {
+	return calloc(nmemb, size);
+    }
 
-	/* case ssize_t: range check */
-	if (item->as_maxint >= (intmax_t)SSIZE_MIN && item->as_maxint <= (intmax_t)SSIZE_MAX) {
-	    item->ssize_sized = true;
-	    item->as_ssize = (ssize_t)item->as_maxint;
-	}
+    /*
+     * case: allocate from the arena
+     */
+    if (size > 0 && nmemb > SIZE_MAX / size) {
+	errno = ENOMEM;
+	return NULL;
+    }
+    return json_arena_alloc(json_arena_cur, nmemb * size);
+}
 
-	/* case off_t: range check */
-	if (item->as_maxint >= (intmax_t)OFF_MIN && item->as_maxint <= (intmax_t)OFF_MAX) {
-	    item->off_sized = true;
-	    item->as_off = (off_t)item->as_maxint;
-	}
 
-	/* case intmax_t: was handled by the above call to strtoimax() */
+/*
+ * json_arena_set_append - append a node to an arena allocated node set
+ *
+ * Arena allocated JSON objects, arrays and elements have no dynamic array:
+ * their node set is allocated from the arena with room for JSON_CHUNK nodes
+ * and doubled in size whenever it becomes full.  As the length is always
+ * known the capacity of the set need not be stored: a set is full when its
+ * length is JSON_CHUNK times a power of 2.
+ *
+ * given:
+ *	arena	arena of the node that owns the set
+ *	set	the node set, or NULL if not yet allocated
+ *	len	number of nodes in the set
+ *	node	node to append
+ *
+ * returns:
+ *	the node set, which might have been moved
+ *
+ * NOTE: This function will not return on error.
+ */
+static struct json **
+json_arena_set_append(struct json_arena *arena, struct json **set, intmax_t len, struct json *node)
+{
+    struct json **new_set = NULL;	    /* grown node set */
+    intmax_t cap = 0;			    /* capacity of the set */
 
-	/* case uintmax_t: cannot be because JSON string is < 0 */
-	item->umaxint_sized = false;
+    /*
+     * firewall
+     */
+    if (arena == NULL) {
+	err(49, __func__, "arena is NULL");
+	not_reached();
+    }
+    if (len < 0) {
+	err(50, __func__, "len: %jd < 0", len);
+	not_reached();
+    }
 
+    /*
+     * determine the current capacity of the set
+     */
+    if (set == NULL) {
+	cap = 0;
     } else {
-
-	/* case: positive, try for largest unsigned integer */
-	errno = 0;			/* pre-clear errno for errp() */
-	item->as_umaxint = strtoumax(str, &endptr, 10);
-	if (errno == ERANGE || errno == EINVAL || endptr == str || endptr == NULL) {
-	    if (errno == ERANGE) {
-		dbg(DBG_VVVHIGH, "positive integer out of range, strtoumax failed to convert");
-	    } else {
-		dbg(DBG_VVVHIGH, "invalid positive integer, strtoumax failed to convert");
-	    }
-	    return false;	/* processing failed */
-	}
-	item->umaxint_sized = true;
-	dbg(DBG_VVVHIGH, "strtoumax for <%s> returned: %ju", str, item->as_umaxint);
-
-	/* case int8_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)INT8_MAX) {
-	    item->int8_sized = true;
-	    item->as_int8 = (int8_t)item->as_umaxint;
+	for (cap = JSON_CHUNK; cap < len; cap *= 2) {
+	    ;
 	}
+    }
 
-	/* case uint8_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)UINT8_MAX) {
-	    item->uint8_sized = true;
-	    item->as_uint8 = (uint8_t)item->as_umaxint;
+    /*
+     * grow the set if it is full
+     */
+    if (len >= cap) {
+	cap = (cap == 0) ? JSON_CHUNK : cap * 2;
+	new_set = json_arena_alloc(arena, (size_t)cap * sizeof(*new_set));
+	if (set != NULL && len > 0) {
+	    memcpy(new_set, set, (size_t)len * sizeof(*new_set));
 	}
+	set = new_set;
+	dbg(DBG_HIGH, "in %s(): arena node set grown to %jd nodes", __func__, cap);
+    }
 
-	/* case int16_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)INT16_MAX) {
-	    item->int16_sized = true;
-	    item->as_int16 = (int16_t)item->as_umaxint;
-	}
+    /*
+     * append the node
+     */
+    set[len] = node;
+    return set;
+}
 
-	/* case uint16_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)UINT16_MAX) {
-	    item->uint16_sized = true;
-	    item->as_uint16 = (uint16_t)item->as_umaxint;
-	}
 
-	/* case int32_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)INT32_MAX) {
-	    item->int32_sized = true;
-	    item->as_int32 = (int32_t)item->as_umaxint;
-	}
+/*
+ * json_input_create - create a retained input buffer holding a copy of a JSON document
+ *
+ * given:
+ *	ptr	pointer to the JSON document
+ *	len	length of the JSON document
+ *
+ * returns:
+ *	pointer to a struct json_input with one reference
+ *
+ * NOTE: This function will not return on NULL ptr or malloc error.
+ * NOTE: This function will not return NULL.
+ */
+struct json_input *
+json_input_create(char const *ptr, size_t len)
+{
+    char *data = NULL;		    /* malloced copy of the JSON document */
 
-	/* case uint32_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)UINT32_MAX) {
-	    item->uint32_sized = true;
-	    item->as_uint32 = (uint32_t)item->as_umaxint;
-	}
+    /*
+     * firewall
+     */
+    if (ptr == NULL) {
+	err(52, __func__, "called with NULL ptr");
+	not_reached();
+    }
 
-	/* case int64_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)INT64_MAX) {
-	    item->int64_sized = true;
-	    item->as_int64 = (int64_t)item->as_umaxint;
-	}
+    /*
+     * copy the JSON document, leaving room for the two NUL bytes
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    data = malloc(len+1+1);
+    if (data == NULL) {
+	errp(53, __func__, "malloc error allocating %zu bytes", len+1+1);
+	not_reached();
+    }
+    memcpy(data, ptr, len);
 
-	/* case uint64_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)UINT64_MAX) {
-	    item->uint64_sized = true;
-	    item->as_uint64 = (uint64_t)item->as_umaxint;
-	}
+    return json_input_adopt(data, len);
+}
 
-	/* case int: bounds check */
-	if (item->as_umaxint <= (uintmax_t)INT_MAX) {
-	    item->int_sized = true;
-	    item->as_int = (int)item->as_umaxint;
-	}
 
-	/* case unsigned int: bounds check */
-	if (item->as_umaxint <= (uintmax_t)UINT_MAX) {
-	    item->uint_sized = true;
-	    item->as_uint = (unsigned int)item->as_umaxint;
-	}
+/*
+ * json_input_adopt - create a retained input buffer from a malloced JSON document
+ *
+ * The input buffer takes ownership of data, which is realloc()ed so that the
+ * JSON document is followed by two NUL bytes (as needed to scan it in place).
+ *
+ * given:
+ *	data	malloced JSON document, such as returned by read_all()
+ *	len	length of the JSON document in data
+ *
+ * returns:
+ *	pointer to a struct json_input with one reference
+ *
+ * NOTE: data must not be used or freed by the caller after this call.
+ *
+ * NOTE: This function will not return on NULL data or malloc error.
+ * NOTE: This function will not return NULL.
+ */
+struct json_input *
+json_input_adopt(char *data, size_t len)
+{
+    struct json_input *input = NULL;	    /* input buffer to return */
 
-	/* case long: bounds check */
-	if (item->as_umaxint <= (uintmax_t)LONG_MAX) {
-	    item->long_sized = true;
-	    item->as_long = (long)item->as_umaxint;
-	}
+    /*
+     * firewall
+     */
+    if (data == NULL) {
+	err(54, __func__, "called with NULL data");
+	not_reached();
+    }
 
-	/* case unsigned long: bounds check */
-	if (item->as_umaxint <= (uintmax_t)ULONG_MAX) {
-	    item->ulong_sized = true;
-	    item->as_ulong = (unsigned long)item->as_umaxint;
-	}
+    /*
+     * allocate the input buffer
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    input = calloc(1, sizeof(*input));
+    if (input == NULL) {
+	errp(55, __func__, "calloc error allocating %zu bytes", sizeof(*input));
+	not_reached();
+    }
 
-	/* case long long: bounds check */
-	if (item->as_umaxint <= (uintmax_t)LLONG_MAX) {
-	    item->longlong_sized = true;
-	    item->as_longlong = (long long)item->as_umaxint;
-	}
+    /*
+     * terminate the JSON document with two NUL bytes
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    input->data = realloc(data, len+1+1);
+    if (input->data == NULL) {
+	errp(56, __func__, "realloc error allocating %zu bytes", len+1+1);
+	not_reached();
+    }
+    input->data[len] = '\0';
+    input->data[len+1] = '\0';
+    input->len = len;
+    input->refs = 1;
 
-	/* case unsigned long long: bounds check */
-	if (item->as_umaxint <= (uintmax_t)ULLONG_MAX) {
-	    item->ulonglong_sized = true;
-	    item->as_ulonglong = (unsigned long long)item->as_umaxint;
-	}
+    return input;
+}
 
-	/* case ssize_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)SSIZE_MAX) {
-	    item->ssize_sized = true;
-	    item->as_ssize = (ssize_t)item->as_umaxint;
-	}
 
-	/* case size_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)SIZE_MAX) {
-	    item->size_sized = true;
-	    item->as_size = (size_t)item->as_umaxint;
-	}
+/*
+ * json_input_ref - take a reference to a retained input buffer
+ *
+ * given:
+ *	input	input buffer, or NULL
+ *
+ * returns:
+ *	input
+ */
+struct json_input *
+json_input_ref(struct json_input *input)
+{
+    if (input != NULL) {
+	++input->refs;
+    }
+    return input;
+}
 
-	/* case off_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)OFF_MAX) {
-	    item->off_sized = true;
-	    item->as_off = (off_t)item->as_umaxint;
-	}
 
-	/* case intmax_t: bounds check */
-	if (item->as_umaxint <= (uintmax_t)INTMAX_MAX) {
-	    item->maxint_sized = true;
-	    item->as_maxint = (intmax_t)item->as_umaxint;
-	}
+/*
+ * json_input_free - release a reference to a retained input buffer
+ *
+ * The input buffer is freed when the last reference is released.
+ *
+ * given:
+ *	input	input buffer, or NULL
+ */
+void
+json_input_free(struct json_input *input)
+{
+    /*
+     * firewall - nothing to do for a NULL input buffer
+     */
+    if (input == NULL) {
+	return;
+    }
 
-	/* case uintmax_t: was handled by the above call to strtoumax() */
+    /*
+     * release the reference
+     */
+    if (input->refs > 1) {
+	--input->refs;
+	return;
     }
 
     /*
-     * processing was successful
+     * free the last reference
      */
-    return true;
+    if (input->data != NULL) {
+	if (input->mapped) {
+	    if (munmap(input->data, input->len) != 0) {
+		warnp(__func__, "munmap of %zu bytes failed", input->len);
+	    }
+	} else {
+	    free(input->data);
+	}
+	input->data = NULL;
+    }
+    memset(input, 0, sizeof(*input));
+    free(input);
+    return;
 }
 
 
 /*
- * json_process_floating - process JSON floating point or e-notation string
- *
- * We will fill out the struct json_number item assuming that ptr, with length len,
- * points to a JSON floating point string as allowed by the so-called JSON spec.
- * The JSON floating point string can be with a JSON float (what the spec calls
- * integer + faction + exponent).
+ * json_input_span - determine if a token lies in the input buffer of an arena
  *
  * given:
- *	item	pointer to a JSON number structure (struct json_number*)
- *	str	JSON floating point or JSON e-notation value as a NUL terminated C-style string
- *	len	length of the JSON number that is not whitespace
- *
- * NOTE: This function assumes that str points to the start of a JSON number, NOT whitespace.
+ *	arena	arena of the JSON parse tree node, or NULL
+ *	ptr	start of the token
+ *	len	length of the token
  *
- * NOTE: This function assumes that str is a NUL terminated string,
- *	 even if the NUL is well beyond the end of the JSON number.
+ * returns:
+ *	true ==> token can be referenced in place, false ==> token must be copied
+ */
+static bool
+json_input_span(struct json_arena const *arena, char const *ptr, size_t len)
+{
+    struct json_input const *input = NULL;	/* input buffer of the arena */
+
+    if (arena == NULL || arena->input == NULL || ptr == NULL) {
+	return false;
+    }
+    input = arena->input;
+    return ptr >= input->data && len <= input->len && ptr <= input->data + (input->len - len);
+}
+
+
+/*
+ * json_input_terminate_node - NUL terminate a JSON number that references the input buffer
  *
- * NOTE: While it is OK if str has trailing whitespace, str[len-1] must be an
- *	 ASCII digit.  It is assumed that str[len-1] is the final JSON number
- *	 character.
+ * While a document is being scanned in place, the scanner NUL terminates the
+ * current token only until the next token is scanned.  Once the scan is done,
+ * this function overwrites the delimiter after a JSON number with a NUL byte.
+ * In the unusual case (only possible with invalid JSON) where the byte after
+ * the number is part of another token, the number is copied instead.
  *
- * NOTE: although we use the term ASCII, isascii() is not used because it was
- * removed from POSIX. Instead we cast the arg to the ctype.h functions/macros
- * (the is*() ones) to an unsigned char because the standard states that,
- * although the arg is an int, it is undefined if it is not representable as an
- * unsigned char or EOF.
+ * given:
+ *	node	pointer to a JSON parse tree node
+ *	depth	current tree depth (0 ==> top of tree)
+ *	ctx	callback context (not used)
  */
-static bool
-json_process_floating(struct json_number *item, char const *str, size_t len)
+static void
+json_input_terminate_node(struct json *node, unsigned int depth, void *ctx)
 {
-    char *endptr;			/* first invalid character or str */
-    char *e_found = NULL;		/* strchr() search for e */
-    char *cap_e_found = NULL;		/* strchr() search for E */
-    char *e = NULL;			/* strrchr() search for second e or E */
-    char *dot_found = NULL;		/* strchr() search for '.' */
-    char *dot = NULL;			/* strrchr() search for '.' */
-    size_t str_len = 0;			/* length as a C string, of str */
+    struct json_number *item = NULL;	    /* JSON number item inside JSON parser tree node */
+    char *as_str = NULL;		    /* copy of as_str */
+
+    UNUSED_ARG(depth);
+    UNUSED_ARG(ctx);
 
     /*
-     * firewall
+     * only JSON numbers that reference the input buffer need to be terminated
      */
-    if (item == NULL) {
-	warn(__func__, "called with NULL item");
-	return false;	/* processing failed */
-    }
-    if (str == NULL) {
-	warn(__func__, "called with NULL str");
-	return false;	/* processing failed */
-    }
-    if (len <= 0) {
-	warn(__func__, "called with len: %zu <= 0", len);
-	return false;	/* processing failed */
-    }
-    if (str[0] == '\0') {
-	warn(__func__, "called with empty string");
-	return false;	/* processing failed */
-    }
-    if (!isdigit((unsigned char)str[len-1])) {
-	warn(__func__, "str[%zu-1] is not an ASCII digit: 0x%02x for str: %s", len, (int)str[len-1], str);
-	return false;	/* processing failed */
+    if (node == NULL || node->type != JTYPE_NUMBER) {
+	return;
     }
-    str_len = strlen(str);
-    if (str_len < len) {
-	warn(__func__, "strlen(%s): %zu < len arg: %zu", str, str_len, len);
-	return false;	/* processing failed */
+    item = &(node->item.number);
+    if (!json_input_span(node->arena, item->as_str, item->as_str_len)) {
+	return;
     }
 
     /*
-     * JSON spec detail: floating point numbers cannot start with .
+     * terminate in place when the delimiter is not part of another token
      */
-    if (str[0] == '.') {
-	dbg(DBG_HIGH, "in %s(): floating point numbers cannot start with .: <%s>",
-		       __func__, str);
-	return false;	/* processing failed */
+    switch (item->as_str[item->as_str_len]) {
+    case '\0':	/*fallthrough*/
+    case ' ':	/*fallthrough*/
+    case '\t':	/*fallthrough*/
+    case '\n':	/*fallthrough*/
+    case '\r':	/*fallthrough*/
+    case ',':	/*fallthrough*/
+    case ':':	/*fallthrough*/
+    case ']':	/*fallthrough*/
+    case '}':
+	item->as_str[item->as_str_len] = '\0';
+	break;
 
     /*
-     * JSON spec detail: floating point numbers cannot end with .
+     * otherwise copy the JSON number into the arena
      */
-    } else if (str[len-1] == '.') {
-	dbg(DBG_HIGH, "in %s(): floating point numbers cannot end with .: <%s>",
-		      __func__, str);
-	return false;	/* processing failed */
+    default:
+	as_str = json_arena_alloc(node->arena, item->as_str_len+1+1);
+	memcpy(as_str, item->as_str, item->as_str_len);
+	if (item->first != NULL) {
+	    item->first = as_str + (item->first - item->as_str);
+	}
+	item->as_str = as_str;
+	break;
+    }
+    return;
+}
+
+
+/*
+ * json_input_terminate - NUL terminate the JSON numbers of a zero-copy JSON parse tree
+ *
+ * See json_input_terminate_node() for details.
+ *
+ * given:
+ *	tree	pointer to a JSON parse tree parsed in place in a struct json_input
+ *
+ * NOTE: This function must be called once the scan of the input buffer is done
+ *	 and before any as_str of a JSON number of the tree is used.
+ */
+void
+json_input_terminate(struct json *tree)
+{
+    if (tree == NULL) {
+	return;
+    }
+    json_tree_walk_ctx(tree, JSON_INFINITE_DEPTH, 0, false, json_input_terminate_node, NULL);
+    return;
+}
+
+
+/*
+ * json_fast_decimal - convert the digits of a JSON integer without strtoumax(3)
+ *
+ * given:
+ *	str	JSON integer, after any leading -
+ *	len	length of str
+ *	ret	pointer to the magnitude of the JSON integer
+ *
+ * returns:
+ *	true ==> str is all ASCII digits and *ret is its value,
+ *	false ==> str has something else or overflows a uintmax_t, use strtoumax(3)
+ */
+static bool
+json_fast_decimal(char const *str, size_t len, uintmax_t *ret)
+{
+    uintmax_t val = 0;			/* value of the digits so far */
+    unsigned int digit = 0;		/* value of the current digit */
+    size_t i;
 
     /*
-     * JSON spec detail: floating point numbers cannot end with -
+     * firewall
      */
-    } else if (str[len-1] == '-') {
-	dbg(DBG_HIGH, "in %s(): floating point numbers cannot end with -: <%s>",
-		      __func__, str);
-	return false;	/* processing failed */
+    if (str == NULL || ret == NULL || len <= 0) {
+	return false;
+    }
 
     /*
-     * JSON spec detail: floating point numbers cannot end with +
+     * accumulate the digits, watching for overflow
      */
-    } else if (str[len-1] == '+') {
-	dbg(DBG_HIGH, "in %s(): floating point numbers cannot end with +: <%s>",
-		      __func__, str);
-	return false;	/* processing failed */
+    for (i = 0; i < len; ++i) {
+	digit = (unsigned int)((unsigned char)str[i] - '0');
+	if (digit > 9) {
+	    return false;	/* not an ASCII digit */
+	}
+	if (val > (UINTMAX_MAX - digit) / 10) {
+	    return false;	/* out of range: let strtoumax() say so */
+	}
+	val = val * 10 + digit;
+    }
+    *ret = val;
+    return true;
+}
+
+
+/*
+ * json_fast_scan - split a JSON floating point or e-notation number for the fast path
+ *
+ * The number is split into its sign, its significant digits as an integer and
+ * its power of ten, such that the number is (-1)^negative * mant * 10^exp10.
+ *
+ * given:
+ *	str		JSON floating point or e-notation number
+ *	len		length of the JSON number in str
+ *	negative	pointer to true ==> number < 0
+ *	mant		pointer to the significant digits
+ *	exp10		pointer to the power of ten
+ *
+ * returns:
+ *	true ==> str is -?digits[.digits][(e|E)[+-]digits], without more than
+ *		 JSON_FAST_DIGITS significant digits, and it has been split,
+ *	false ==> str must be converted by the C library
+ *
+ * NOTE: This function assumes the JSON syntax checks of json_process_floating()
+ *	 have been done: it only checks as much as it needs to be safe.
+ */
+static bool
+json_fast_scan(char const *str, size_t len, bool *negative, uint64_t *mant, int *exp10)
+{
+    char const *p = str;		/* next byte of str */
+    char const *end = str + len;	/* beyond the end of str */
+    uint64_t val = 0;			/* significant digits so far */
+    int digits = 0;			/* number of significant digits so far */
+    int power = 0;			/* power of ten of val */
+    int expval = 0;			/* value of the exponent */
+    bool expneg = false;		/* true ==> exponent is < 0 */
+    bool fraction = false;		/* true ==> after the . */
+    bool any = false;			/* true ==> a digit was found before any exponent */
 
     /*
-     * JSON spec detail: floating point numbers must end in a digit
+     * firewall
      */
-    } else if (!isdigit((unsigned char)str[len-1])) {
-	dbg(DBG_HIGH, "in %s(): floating point numbers must end in a digit: <%s>",
-		       __func__, str);
-	return false;	/* processing failed */
+    if (str == NULL || negative == NULL || mant == NULL || exp10 == NULL || len <= 0) {
+	return false;
     }
 
-    /* detect dot */
-    dot_found = strchr(str, '.');
-    /* if dot found see if there's another one */
-    if (dot_found != NULL) {
-	dot = strrchr(str, '.');
-	if (dot != NULL && dot != dot_found) {
-	    dbg(DBG_HIGH, "in %s(): floating point numbers cannot have two '.'s: <%s>",
-		      __func__, str);
-	    return false;	/* processing failed */
-	}
-	item->is_floating = true;
+    /*
+     * sign
+     */
+    *negative = false;
+    if (*p == '-') {
+	*negative = true;
+	++p;
     }
 
     /*
-     * detect use of e notation
+     * integer and fraction digits
      */
-    e_found = strchr(str, 'e');
-    cap_e_found = strchr(str, 'E');
-    /* case: both e and E found */
-    if (e_found != NULL && cap_e_found != NULL) {
-
-	dbg(DBG_HIGH, "in %s(): floating point numbers cannot use both e and E: <%s>",
-		      __func__, str);
-	return false;	/* processing failed */
-
-    /* case: just e found, no E */
-    } else if (e_found != NULL) {
-
-	/* firewall - search for two 'e's */
-	e = strrchr(str, 'e');
-	if (e_found != e) {
-	    dbg(DBG_HIGH, "in %s(): floating point numbers cannot have more than one e: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
+    for (; p < end; ++p) {
+	if (*p == '.') {
+	    if (fraction) {
+		return false;
+	    }
+	    fraction = true;
+	    continue;
+	} else if (!isdigit((unsigned char)*p)) {
+	    break;
 	}
+	any = true;
 
-	/* note e notation */
-	item->is_e_notation = true;
-
-    /* case: just E found, no e */
-    } else if (cap_e_found != NULL) {
-
-	/* firewall - search for two 'E's */
-	e = strrchr(str, 'E');
-	if (cap_e_found != e) {
-	    dbg(DBG_HIGH, "in %s(): floating point numbers cannot have more than one E: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
+	/* leading zeros are not significant, but after the . they scale */
+	if (val == 0 && *p == '0') {
+	    if (fraction) {
+		--power;
+	    }
+	    continue;
+	}
+	if (digits >= JSON_FAST_DIGITS) {
+	    return false;	/* too many significant digits for the fast path */
+	}
+	val = val * 10 + (uint64_t)(*p - '0');
+	++digits;
+	if (fraction) {
+	    --power;
 	}
-
-	/* note e notation */
-	item->is_e_notation = true;
-    } else {
-	/* case: neither 'e' nor 'E' found */
-	item->is_e_notation = false;
     }
-
+    if (!any) {
+	return false;
+    }
 
     /*
-     * perform additional JSON number checks on e notation
-     *
-     * NOTE: If item->is_e_notation == true, then e points to the e or E
+     * exponent
      */
-    if (item->is_e_notation == true) {
-
-	/*
-	 * JSON spec detail: e notation number cannot start with e or E
-	 */
-	if (e == str) {
-	    dbg(DBG_HIGH, "in %s(): e notation numbers cannot start with e or E: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-
-	/*
-	 * JSON spec detail: e notation number cannot end with e or E
-	 */
-	} else if (e == &(str[len-1])) {
-	    dbg(DBG_HIGH, "in %s(): e notation numbers cannot end with e or E: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-
-	/*
-	 * JSON spec detail: e notation number cannot have e or E after .
-	 */
-	} else if (e > str && e[-1] == '.') {
-	    dbg(DBG_HIGH, "in %s(): e notation numbers cannot have '.' before e or E: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-
-	/*
-	 * JSON spec detail: e notation number must have digit before e or E
-	 */
-	} else if (e > str && (!isdigit((unsigned char)e[-1]))) {
-	    dbg(DBG_HIGH, "in %s(): e notation numbers must have digit before e or E: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-
-	/*
-	 * case: e notation number with a leading + in the exponent
-	 *
-	 * NOTE: From "floating point numbers cannot end with +" we know + is not at the end.
-	 */
-	} else if (e[1] == '+') {
-
-	    /*
-	     * JSON spec detail: e notation number with e+ or E+ must be followed by a digit
-	     */
-	    if (e+1 < &(str[len-1]) && !isdigit((unsigned char)e[2])) {
-		dbg(DBG_HIGH, "in %s(): :e notation number with e+ or E+ must be followed by a digit <%s>",
-			      __func__, str);
-		return false;	/* processing failed */
+    if (p < end && (*p == 'e' || *p == 'E')) {
+	++p;
+	if (p < end && (*p == '+' || *p == '-')) {
+	    expneg = (*p == '-');
+	    ++p;
+	}
+	if (p >= end) {
+	    return false;
+	}
+	for (; p < end && isdigit((unsigned char)*p); ++p) {
+	    /* any exponent this large is far outside the fast path */
+	    if (expval < 100000) {
+		expval = expval * 10 + (*p - '0');
 	    }
+	}
+	power += (expneg ? -expval : expval);
+    }
 
-	/*
-	 * case: e notation number with a leading - in the exponent
-	 *
-	 * NOTE: From "floating point numbers cannot end with -" we know - is not at the end.
-	 */
-	} else if (e[1] == '-') {
+    /*
+     * the whole number must have been scanned
+     */
+    if (p != end) {
+	return false;
+    }
+    *mant = val;
+    *exp10 = power;
+    return true;
+}
 
-	    /*
-	     * JSON spec detail: e notation number with e- or E- must be followed by a digit
-	     */
-	    if (e+1 < &(str[len-1]) && (!isdigit((unsigned char)e[2]))) {
-		dbg(DBG_HIGH, "in %s(): :e notation number with e- or E- must be followed by a digit <%s>",
-			      __func__, str);
-		return false;	/* processing failed */
-	    }
 
-	/*
-	 * JSON spec detail: e notation number must have + or - or digit after e or E
-	 */
-	} else if (!isdigit((unsigned char)e[1])) {
-	    dbg(DBG_HIGH, "in %s(): e notation numbers must follow e or E with + or - or digit: <%s>",
-			  __func__, str);
-	    return false;	/* processing failed */
-	}
-    }
+/*
+ * json_fast_longdouble - convert a JSON floating point number to a long double exactly without strtold(3)
+ *
+ * given:
+ *	str	JSON floating point or e-notation number
+ *	len	length of the JSON number in str
+ *	ret	pointer to the converted value
+ *
+ * returns:
+ *	true ==> *ret is the same value that strtold(3) would return,
+ *	false ==> the number is outside the fast path, use strtold(3)
+ */
+static bool
+json_fast_longdouble(char const *str, size_t len, long double *ret)
+{
+#if JSON_FAST_LDBL_POW10_MAX >= 0
+    static long double const pow10[] = {
+	1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+	1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+	1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+    };
+    bool negative = false;		/* true ==> number < 0 */
+    uint64_t mant = 0;			/* significant digits */
+    int exp10 = 0;			/* power of ten */
+    long double val;			/* converted value */
 
     /*
-     * convert to largest floating point value
+     * firewall
      */
-    errno = 0;			/* pre-clear errno for errp() */
-    item->as_longdouble = strtold(str, &endptr);
-    if (errno == ERANGE || endptr == str || endptr == NULL) {
-	if (errno == ERANGE) {
-	    /* if range problem we know it's parsable */
-	    item->parsed = true;
-	}
-	dbg(DBG_VVVHIGH, "strtold failed to convert");
-	return false;	/* processing failed */
+    if (ret == NULL) {
+	return false;
+    }
+    if (!json_fast_scan(str, len, &negative, &mant, &exp10)) {
+	return false;
     }
-    item->longdouble_sized = true;
-    item->as_longdouble_int = (item->as_longdouble == floorl(item->as_longdouble));
-    dbg(DBG_VVVHIGH, "strtold for <%s> returned as %%Lg: %.22Lg", str, item->as_longdouble);
-    dbg(DBG_VVVHIGH, "strtold for <%s> returned as %%Le: %.22Le", str, item->as_longdouble);
-    dbg(DBG_VVVHIGH, "strtold for <%s> returned as %%Lf: %.22Lf", str, item->as_longdouble);
-    dbg(DBG_VVVHIGH, "strtold returned an integer value: %s", booltostr(item->as_longdouble_int));
 
     /*
-     * note if value < 0
+     * the significant digits must be exact in a long double
      */
-    if (item->as_longdouble < 0) {
-	item->is_negative = true;
+#if LDBL_MANT_DIG < 64
+    if ((mant >> LDBL_MANT_DIG) != 0) {
+	return false;
     }
+#endif
 
     /*
-     * convert to double
+     * one rounding: an exact integer times or divided by an exact power of ten
      */
-    errno = 0;			/* pre-clear conversion test */
-    item->as_double = strtod(str, &endptr);
-    if (errno == ERANGE || endptr == str || endptr == NULL) {
-	if (errno == ERANGE) {
-	    /* if range problem we know it's parsable */
-	    item->parsed = true;
-	}
-	item->double_sized = false;
-	dbg(DBG_VVVHIGH, "strtod for <%s> failed", str);
+    if (mant == 0) {
+	val = 0.0L;
+    } else if (exp10 >= 0 && exp10 <= JSON_FAST_LDBL_POW10_MAX) {
+	val = (long double)mant * pow10[exp10];
+    } else if (exp10 < 0 && -exp10 <= JSON_FAST_LDBL_POW10_MAX) {
+	val = (long double)mant / pow10[-exp10];
     } else {
-	item->double_sized = true;
-	item->parsed = true;
-	item->as_double_int = (item->as_double == floor(item->as_double));
-	dbg(DBG_VVVHIGH, "strtod for <%s> returned as %%lg: %.22lg", str, item->as_double);
-	dbg(DBG_VVVHIGH, "strtod for <%s> returned as %%le: %.22le", str, item->as_double);
-	dbg(DBG_VVVHIGH, "strtod for <%s> returned as %%lf: %.22lf", str, item->as_double);
-	dbg(DBG_VVVHIGH, "strtod returned an integer value: %s", booltostr(item->as_double_int));
+	return false;
     }
+    *ret = (negative ? -val : val);
+    return true;
+#else
+    (void) str;
+    (void) len;
+    (void) ret;
+    return false;
+#endif
+}
+
+
+/*
+ * json_fast_double - convert a JSON floating point number to a double exactly without strtod(3)
+ *
+ * given:
+ *	str	JSON floating point or e-notation number
+ *	len	length of the JSON number in str
+ *	ret	pointer to the converted value
+ *
+ * returns:
+ *	true ==> *ret is the same value that strtod(3) would return,
+ *	false ==> the number is outside the fast path, use strtod(3)
+ */
+static bool
+json_fast_double(char const *str, size_t len, double *ret)
+{
+#if JSON_FAST_DBL_POW10_MAX >= 0
+    static double const pow10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+	1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+	1e20, 1e21, 1e22
+    };
+    bool negative = false;		/* true ==> number < 0 */
+    uint64_t mant = 0;			/* significant digits */
+    int exp10 = 0;			/* power of ten */
+    double val;				/* converted value */
 
     /*
-     * convert to float
+     * firewall
      */
-    errno = 0;			/* pre-clear conversion test */
-    item->as_float = strtof(str, &endptr);
-    if (errno == ERANGE || endptr == str || endptr == NULL) {
-	if (errno == ERANGE) {
-	    /* if range issue we know it's parsable */
-	    item->parsed = true;
-	}
-	item->float_sized = false;
-	dbg(DBG_VVVHIGH, "strtof for <%s> failed", str);
-    } else {
-	item->parsed = true;
-	item->float_sized = true;
-	item->as_float_int = (item->as_longdouble == floorl(item->as_longdouble));
-	dbg(DBG_VVVHIGH, "strtof for <%s> returned as %%g: %.22g", str, (double)item->as_float);
-	dbg(DBG_VVVHIGH, "strtof for <%s> returned as %%e: %.22e", str, (double)item->as_float);
-	dbg(DBG_VVVHIGH, "strtof for <%s> returned as %%f: %.22f", str, (double)item->as_float);
-	dbg(DBG_VVVHIGH, "strtof returned an integer value: %s", booltostr(item->as_float_int));
+    if (ret == NULL) {
+	return false;
+    }
+    if (!json_fast_scan(str, len, &negative, &mant, &exp10)) {
+	return false;
     }
 
     /*
-     * processing was successful
+     * the significant digits must be exact in a double
      */
+    if ((mant >> DBL_MANT_DIG) != 0) {
+	return false;
+    }
+
+    /*
+     * one rounding: an exact integer times or divided by an exact power of ten
+     */
+    if (mant == 0) {
+	val = 0.0;
+    } else if (exp10 >= 0 && exp10 <= JSON_FAST_DBL_POW10_MAX) {
+	val = (double)mant * pow10[exp10];
+    } else if (exp10 < 0 && -exp10 <= JSON_FAST_DBL_POW10_MAX) {
+	val = (double)mant / pow10[-exp10];
+    } else {
+	return false;
+    }
+    *ret = (negative ? -val : val);
+    return true;
+#else
+    (void) str;
+    (void) len;
+    (void) ret;
+    return false;
+#endif
+}
+
+
+/*
+ * json_process_decimal - process a JSON integer string
+ *
+ * We will fill out the struct json_number item assuming that ptr, with length len,
+ * points to a JSON integer string of base 10 ASCII as allowed by the so-called JSON spec.
+ *
+ * given:
+ *	item	pointer to a JSON number structure (struct json_number*)
+ *	str	JSON integer as a NUL terminated C-style string
+ *	len	length of the JSON number that is not whitespace
+ *
+ * NOTE: This function assumes that str points to the start of a JSON number, NOT whitespace.
+ *
+ * NOTE: This function assumes that str is a NUL terminated string,
+ *	 even if the NUL is well beyond the end of the JSON number.
+ *
+ * NOTE: While it is OK if str has trailing whitespace, str[len-1] must be an
+ *	 ASCII digit.  It is assumed that str[len-1] is the final JSON number character.
+ *
+ * NOTE: although we use the term ASCII, isascii() is not used because it was
+ * removed from POSIX. Instead we cast the arg to the ctype.h functions/macros
+ * (the is*() ones) to an unsigned char because the standard states that,
+ * although the arg is an int, it is undefined if it is not representable as an
+ * unsigned char or EOF.
+ */
+static bool
+json_process_decimal(struct json_number *item, char const *str, size_t len)
+{
+    char *endptr;			/* first invalid character or str */
+    size_t str_len = 0;			/* length as a C string, of str */
+    uintmax_t mag = 0;			/* magnitude of the JSON integer by the fast path */
+
+    /*
+     * firewall
+     */
+    if (item == NULL) {
+	warn(__func__, "called with NULL item");
+	return false;	/* processing failed */
+    }
+    if (str == NULL) {
+	warn(__func__, "called with NULL str");
+	return false;	/* processing failed */
+    }
+    if (len <= 0) {
+	warn(__func__, "called with len: %zu <= 0", len);
+	return false;	/* processing failed */
+    }
+    if (str[0] == '\0') {
+	warn(__func__, "called with empty string");
+	return false;	/* processing failed */
+    }
+    if (!isdigit((unsigned char)str[len-1])) {
+	warn(__func__, "str[%zu-1] is not an ASCII digit: 0x%02x for str: %s", len, (int)str[len-1], str);
+	return false;	/* processing failed */
+    }
+    str_len = strlen(str);
+    if (str_len < len) {
+	warn(__func__, "strlen(%s): %zu < len arg: %zu", str, str_len, len);
+	return false;	/* processing failed */
+    }
+
+    /*
+     * determine if JSON integer negative
+     */
+    if (str[0] == '-') {
+
+	/* parse JSON integer that is < 0 */
+	item->is_negative = true;
+
+        /*
+	 * JSON spec detail: lone - invalid JSON
+	 */
+	if (len <= 1 || str[1] == '\0') {
+	    dbg(DBG_HIGH, "in %s(): called with just -: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+
+        /*
+	 * JSON spec detail: leading -0 followed by digits - invalid JSON
+	 */
+	} else if (len > 2 && str[1] == '0' && isdigit((unsigned char)str[2])) {
+	    dbg(DBG_HIGH, "in %s(): called with -0 followed by more digits: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+	}
+
+    /* case: JSON integer is >= 0 */
+    } else {
+
+	/* parse JSON integer that is >= 0 */
+	item->is_negative = false;
+
+        /*
+	 * JSON spec detail: leading 0 followed by digits - invalid JSON
+	 */
+	if (len > 1 && str[0] == '0' && isdigit((unsigned char)str[1])) {
+	    dbg(DBG_HIGH, "in %s(): called with 0 followed by more digits: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+	}
+    }
+
+    /*
+     * attempt to convert to the largest possible integer
+     *
+     * NOTE: conversions into narrower C integer types are made on demand by
+     *	     json_number_to_conv() and the json_number_*() accessor functions.
+     *
+     * First try to convert the digits directly, which is all that is needed
+     * for every JSON integer that is in range.  Only those out of range (or
+     * with something other than digits) are left for strtoimax() and
+     * strtoumax() to convert or reject.
+     */
+    if (item->is_negative && json_fast_decimal(str+1, len-1, &mag) && mag <= (uintmax_t)INTMAX_MAX + 1) {
+
+	/* case: negative, in the range of the largest signed integer */
+	item->as_maxint = (mag > (uintmax_t)INTMAX_MAX) ? INTMAX_MIN : -(intmax_t)mag;
+	item->maxint_sized = true;
+	item->umaxint_sized = false;
+	dbg(DBG_VVVHIGH, "fast conversion of <%s> returned: %jd", str, item->as_maxint);
+
+    } else if (!item->is_negative && json_fast_decimal(str, len, &mag)) {
+
+	/* case: positive, in the range of the largest unsigned integer */
+	item->as_umaxint = mag;
+	item->umaxint_sized = true;
+	item->maxint_sized = (item->as_umaxint <= (uintmax_t)INTMAX_MAX);
+	dbg(DBG_VVVHIGH, "fast conversion of <%s> returned: %ju", str, item->as_umaxint);
+
+    } else if (item->is_negative) {
+
+	/* case: negative, try for largest signed integer */
+	errno = 0;			/* pre-clear errno for errp() */
+	item->as_maxint = strtoimax(str, &endptr, 10);
+	if (errno == ERANGE || errno == EINVAL || endptr == str || endptr == NULL) {
+	    if (errno == ERANGE) {
+		dbg(DBG_VVVHIGH, "negative integer out of range, strtoimax failed to convert");
+	    } else {
+		dbg(DBG_VVVHIGH, "invalid negative integer, strtoimax failed to convert");
+	    }
+	    return false;	/* processing failed */
+	}
+	item->maxint_sized = true;
+	dbg(DBG_VVVHIGH, "strtoimax for <%s> returned: %zd", str, item->as_maxint);
+
+	/* case uintmax_t: cannot be because JSON string is < 0 */
+	item->umaxint_sized = false;
+
+    } else {
+
+	/* case: positive, try for largest unsigned integer */
+	errno = 0;			/* pre-clear errno for errp() */
+	item->as_umaxint = strtoumax(str, &endptr, 10);
+	if (errno == ERANGE || errno == EINVAL || endptr == str || endptr == NULL) {
+	    if (errno == ERANGE) {
+		dbg(DBG_VVVHIGH, "positive integer out of range, strtoumax failed to convert");
+	    } else {
+		dbg(DBG_VVVHIGH, "invalid positive integer, strtoumax failed to convert");
+	    }
+	    return false;	/* processing failed */
+	}
+	item->umaxint_sized = true;
+	dbg(DBG_VVVHIGH, "strtoumax for <%s> returned: %ju", str, item->as_umaxint);
+
+	/*
+	 * case intmax_t: bounds check
+	 *
+	 * NOTE: as_maxint shares storage with as_umaxint, and the value is the same.
+	 */
+	item->maxint_sized = (item->as_umaxint <= (uintmax_t)INTMAX_MAX);
+    }
+
+    /*
+     * processing was successful
+     */
+    return true;
+}
+
+
+/*
+ * json_process_floating - process JSON floating point or e-notation string
+ *
+ * We will fill out the struct json_number item assuming that ptr, with length len,
+ * points to a JSON floating point string as allowed by the so-called JSON spec.
+ * The JSON floating point string can be with a JSON float (what the spec calls
+ * integer + faction + exponent).
+ *
+ * given:
+ *	item	pointer to a JSON number structure (struct json_number*)
+ *	str	JSON floating point or JSON e-notation value as a NUL terminated C-style string
+ *	len	length of the JSON number that is not whitespace
+ *
+ * NOTE: This function assumes that str points to the start of a JSON number, NOT whitespace.
+ *
+ * NOTE: This function assumes that str is a NUL terminated string,
+ *	 even if the NUL is well beyond the end of the JSON number.
+ *
+ * NOTE: While it is OK if str has trailing whitespace, str[len-1] must be an
+ *	 ASCII digit.  It is assumed that str[len-1] is the final JSON number
+ *	 character.
+ *
+ * NOTE: although we use the term ASCII, isascii() is not used because it was
+ * removed from POSIX. Instead we cast the arg to the ctype.h functions/macros
+ * (the is*() ones) to an unsigned char because the standard states that,
+ * although the arg is an int, it is undefined if it is not representable as an
+ * unsigned char or EOF.
+ */
+static bool
+json_process_floating(struct json_number *item, char const *str, size_t len)
+{
+    char *endptr;			/* first invalid character or str */
+    char *e_found = NULL;		/* strchr() search for e */
+    char *cap_e_found = NULL;		/* strchr() search for E */
+    char *e = NULL;			/* strrchr() search for second e or E */
+    char *dot_found = NULL;		/* strchr() search for '.' */
+    char *dot = NULL;			/* strrchr() search for '.' */
+    size_t str_len = 0;			/* length as a C string, of str */
+
+    /*
+     * firewall
+     */
+    if (item == NULL) {
+	warn(__func__, "called with NULL item");
+	return false;	/* processing failed */
+    }
+    if (str == NULL) {
+	warn(__func__, "called with NULL str");
+	return false;	/* processing failed */
+    }
+    if (len <= 0) {
+	warn(__func__, "called with len: %zu <= 0", len);
+	return false;	/* processing failed */
+    }
+    if (str[0] == '\0') {
+	warn(__func__, "called with empty string");
+	return false;	/* processing failed */
+    }
+    if (!isdigit((unsigned char)str[len-1])) {
+	warn(__func__, "str[%zu-1] is not an ASCII digit: 0x%02x for str: %s", len, (int)str[len-1], str);
+	return false;	/* processing failed */
+    }
+    str_len = strlen(str);
+    if (str_len < len) {
+	warn(__func__, "strlen(%s): %zu < len arg: %zu", str, str_len, len);
+	return false;	/* processing failed */
+    }
+
+    /*
+     * JSON spec detail: floating point numbers cannot start with .
+     */
+    if (str[0] == '.') {
+	dbg(DBG_HIGH, "in %s(): floating point numbers cannot start with .: <%s>",
+		       __func__, str);
+	return false;	/* processing failed */
+
+    /*
+     * JSON spec detail: floating point numbers cannot end with .
+     */
+    } else if (str[len-1] == '.') {
+	dbg(DBG_HIGH, "in %s(): floating point numbers cannot end with .: <%s>",
+		      __func__, str);
+	return false;	/* processing failed */
+
+    /*
+     * JSON spec detail: floating point numbers cannot end with -
+     */
+    } else if (str[len-1] == '-') {
+	dbg(DBG_HIGH, "in %s(): floating point numbers cannot end with -: <%s>",
+		      __func__, str);
+	return false;	/* processing failed */
+
+    /*
+     * JSON spec detail: floating point numbers cannot end with +
+     */
+    } else if (str[len-1] == '+') {
+	dbg(DBG_HIGH, "in %s(): floating point numbers cannot end with +: <%s>",
+		      __func__, str);
+	return false;	/* processing failed */
+
+    /*
+     * JSON spec detail: floating point numbers must end in a digit
+     */
+    } else if (!isdigit((unsigned char)str[len-1])) {
+	dbg(DBG_HIGH, "in %s(): floating point numbers must end in a digit: <%s>",
+		       __func__, str);
+	return false;	/* processing failed */
+    }
+
+    /* detect dot */
+    dot_found = strchr(str, '.');
+    /* if dot found see if there's another one */
+    if (dot_found != NULL) {
+	dot = strrchr(str, '.');
+	if (dot != NULL && dot != dot_found) {
+	    dbg(DBG_HIGH, "in %s(): floating point numbers cannot have two '.'s: <%s>",
+		      __func__, str);
+	    return false;	/* processing failed */
+	}
+	item->is_floating = true;
+    }
+
+    /*
+     * detect use of e notation
+     */
+    e_found = strchr(str, 'e');
+    cap_e_found = strchr(str, 'E');
+    /* case: both e and E found */
+    if (e_found != NULL && cap_e_found != NULL) {
+
+	dbg(DBG_HIGH, "in %s(): floating point numbers cannot use both e and E: <%s>",
+		      __func__, str);
+	return false;	/* processing failed */
+
+    /* case: just e found, no E */
+    } else if (e_found != NULL) {
+
+	/* firewall - search for two 'e's */
+	e = strrchr(str, 'e');
+	if (e_found != e) {
+	    dbg(DBG_HIGH, "in %s(): floating point numbers cannot have more than one e: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+	}
+
+	/* note e notation */
+	item->is_e_notation = true;
+
+    /* case: just E found, no e */
+    } else if (cap_e_found != NULL) {
+
+	/* firewall - search for two 'E's */
+	e = strrchr(str, 'E');
+	if (cap_e_found != e) {
+	    dbg(DBG_HIGH, "in %s(): floating point numbers cannot have more than one E: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+	}
+
+	/* note e notation */
+	item->is_e_notation = true;
+    } else {
+	/* case: neither 'e' nor 'E' found */
+	item->is_e_notation = false;
+    }
+
+
+    /*
+     * perform additional JSON number checks on e notation
+     *
+     * NOTE: If item->is_e_notation == true, then e points to the e or E
+     */
+    if (item->is_e_notation == true) {
+
+	/*
+	 * JSON spec detail: e notation number cannot start with e or E
+	 */
+	if (e == str) {
+	    dbg(DBG_HIGH, "in %s(): e notation numbers cannot start with e or E: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+
+	/*
+	 * JSON spec detail: e notation number cannot end with e or E
+	 */
+	} else if (e == &(str[len-1])) {
+	    dbg(DBG_HIGH, "in %s(): e notation numbers cannot end with e or E: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+
+	/*
+	 * JSON spec detail: e notation number cannot have e or E after .
+	 */
+	} else if (e > str && e[-1] == '.') {
+	    dbg(DBG_HIGH, "in %s(): e notation numbers cannot have '.' before e or E: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+
+	/*
+	 * JSON spec detail: e notation number must have digit before e or E
+	 */
+	} else if (e > str && (!isdigit((unsigned char)e[-1]))) {
+	    dbg(DBG_HIGH, "in %s(): e notation numbers must have digit before e or E: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+
+	/*
+	 * case: e notation number with a leading + in the exponent
+	 *
+	 * NOTE: From "floating point numbers cannot end with +" we know + is not at the end.
+	 */
+	} else if (e[1] == '+') {
+
+	    /*
+	     * JSON spec detail: e notation number with e+ or E+ must be followed by a digit
+	     */
+	    if (e+1 < &(str[len-1]) && !isdigit((unsigned char)e[2])) {
+		dbg(DBG_HIGH, "in %s(): :e notation number with e+ or E+ must be followed by a digit <%s>",
+			      __func__, str);
+		return false;	/* processing failed */
+	    }
+
+	/*
+	 * case: e notation number with a leading - in the exponent
+	 *
+	 * NOTE: From "floating point numbers cannot end with -" we know - is not at the end.
+	 */
+	} else if (e[1] == '-') {
+
+	    /*
+	     * JSON spec detail: e notation number with e- or E- must be followed by a digit
+	     */
+	    if (e+1 < &(str[len-1]) && (!isdigit((unsigned char)e[2]))) {
+		dbg(DBG_HIGH, "in %s(): :e notation number with e- or E- must be followed by a digit <%s>",
+			      __func__, str);
+		return false;	/* processing failed */
+	    }
+
+	/*
+	 * JSON spec detail: e notation number must have + or - or digit after e or E
+	 */
+	} else if (!isdigit((unsigned char)e[1])) {
+	    dbg(DBG_HIGH, "in %s(): e notation numbers must follow e or E with + or - or digit: <%s>",
+			  __func__, str);
+	    return false;	/* processing failed */
+	}
+    }
+
+    /*
+     * convert to largest floating point value
+     *
+     * Most JSON numbers have few digits and a small exponent and so are
+     * converted exactly by json_fast_longdouble().  The rest are converted by
+     * strtold().
+     */
+    if (json_fast_longdouble(str, len, &item->as_longdouble)) {
+	dbg(DBG_VVVHIGH, "fast conversion of <%s> succeeded", str);
+    } else {
+	errno = 0;			/* pre-clear errno for errp() */
+	item->as_longdouble = strtold(str, &endptr);
+	if (errno == ERANGE || endptr == str || endptr == NULL) {
+	    if (errno == ERANGE) {
+		/* if range problem we know it's parsable */
+		item->parsed = true;
+	    }
+	    dbg(DBG_VVVHIGH, "strtold failed to convert");
+	    return false;	/* processing failed */
+	}
+    }
+    item->longdouble_sized = true;
+    item->as_longdouble_int = (item->as_longdouble == floorl(item->as_longdouble));
+    dbg(DBG_VVVHIGH, "strtold for <%s> returned as %%Lg: %.22Lg", str, item->as_longdouble);
+    dbg(DBG_VVVHIGH, "strtold for <%s> returned as %%Le: %.22Le", str, item->as_longdouble);
+    dbg(DBG_VVVHIGH, "strtold for <%s> returned as %%Lf: %.22Lf", str, item->as_longdouble);
+    dbg(DBG_VVVHIGH, "strtold returned an integer value: %s", booltostr(item->as_longdouble_int));
+
+    /*
+     * note if value < 0
+     */
+    if (item->as_longdouble < 0) {
+	item->is_negative = true;
+    }
+
+    /*
+     * NOTE: conversions into double and float are made on demand by
+     *	     json_number_to_conv() and the json_number_*() accessor functions.
+     */
+    item->parsed = true;
+
+    /*
+     * processing was successful
+     */
+    return true;
+}
+
+
+/*
+ * json_number_to_conv - convert a parsed JSON number into every C type
+ *
+ * Only the canonical C value (intmax_t and/or uintmax_t for a JSON integer,
+ * long double for a JSON floating point or e-notation number) is kept in a
+ * struct json_number.  This function fills in a struct json_number_conv with
+ * the conversion of that JSON number into every C integer and floating point
+ * type.
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	conv	pointer to the struct json_number_conv to fill in
+ *
+ * returns:
+ *	true ==> conv was filled in,
+ *	false ==> NULL pointer
+ *
+ * NOTE: conv->as_str and conv->first point into item->as_str.  They are not
+ *	 copies and so they must not be freed.
+ */
+bool
+json_number_to_conv(struct json_number const *item, struct json_number_conv *conv)
+{
+    char *endptr;			/* first invalid character or str */
+    char const *str = NULL;		/* first non-whitespace character of the JSON number */
+
+    /*
+     * firewall
+     */
+    if (item == NULL) {
+	warn(__func__, "called with NULL item");
+	return false;
+    }
+    if (conv == NULL) {
+	warn(__func__, "called with NULL conv");
+	return false;
+    }
+
+    /*
+     * copy the fields in common
+     */
+    memset(conv, 0, sizeof(*conv));
+    conv->parsed = item->parsed;
+    conv->converted = item->converted;
+    conv->as_str = item->as_str;
+    conv->first = item->first;
+    conv->as_str_len = item->as_str_len;
+    conv->number_len = item->number_len;
+    conv->is_negative = item->is_negative;
+    conv->is_floating = item->is_floating;
+    conv->is_e_notation = item->is_e_notation;
+    conv->is_integer = item->is_integer;
+    str = item->first;
+
+    /*
+     * case: JSON integer
+     */
+    if (item->is_integer && (item->maxint_sized || item->umaxint_sized)) {
+
+	/*
+	 * copy the canonical value
+	 */
+	if (item->is_negative) {
+	    conv->maxint_sized = item->maxint_sized;
+	    conv->as_maxint = item->as_maxint;
+	} else {
+	    conv->umaxint_sized = item->umaxint_sized;
+	    conv->as_umaxint = item->as_umaxint;
+	}
+
+	/*
+	 * convert to the narrower integer types
+	 */
+	if (conv->is_negative) {
+
+	    /* case int8_t: range check */
+	    if (conv->as_maxint >= (intmax_t)INT8_MIN && conv->as_maxint <= (intmax_t)INT8_MAX) {
+		conv->int8_sized = true;
+		conv->as_int8 = (int8_t)conv->as_maxint;
+	    }
+
+	    /* case uint8_t: cannot be because JSON string is < 0 */
+	    conv->uint8_sized = false;
+
+	    /* case int16_t: range check */
+	    if (conv->as_maxint >= (intmax_t)INT16_MIN && conv->as_maxint <= (intmax_t)INT16_MAX) {
+		conv->int16_sized = true;
+		conv->as_int16 = (int16_t)conv->as_maxint;
+	    }
+
+	    /* case uint16_t: cannot be because JSON string is < 0 */
+	    conv->uint16_sized = false;
+
+	    /* case int32_t: range check */
+	    if (conv->as_maxint >= (intmax_t)INT32_MIN && conv->as_maxint <= (intmax_t)INT32_MAX) {
+		conv->int32_sized = true;
+		conv->as_int32 = (int32_t)conv->as_maxint;
+	    }
+
+	    /* case uint32_t: cannot be because JSON string is < 0 */
+	    conv->uint32_sized = false;
+
+	    /* case int64_t: range check */
+	    if (conv->as_maxint >= (intmax_t)INT64_MIN && conv->as_maxint <= (intmax_t)INT64_MAX) {
+		conv->int64_sized = true;
+		conv->as_int64 = (int64_t)conv->as_maxint;
+	    }
+
+	    /* case uint64_t: cannot be because JSON string is < 0 */
+	    conv->uint64_sized = false;
+
+	    /* case int: range check */
+	    if (conv->as_maxint >= (intmax_t)INT_MIN && conv->as_maxint <= (intmax_t)INT_MAX) {
+		conv->int_sized = true;
+		conv->as_int = (int)conv->as_maxint;
+	    }
+
+	    /* case unsigned int: cannot be because JSON string is < 0 */
+	    conv->uint_sized = false;
+
+	    /* case long: range check */
+	    if (conv->as_maxint >= (intmax_t)LONG_MIN && conv->as_maxint <= (intmax_t)LONG_MAX) {
+		conv->long_sized = true;
+		conv->as_long = (long)conv->as_maxint;
+	    }
+
+	    /* case unsigned long: cannot be because JSON string is < 0 */
+	    conv->ulong_sized = false;
+
+	    /* case long long: range check */
+	    if (conv->as_maxint >= (intmax_t)LLONG_MIN && conv->as_maxint <= (intmax_t)LLONG_MAX) {
+		conv->longlong_sized = true;
+		conv->as_longlong = (long long)conv->as_maxint;
+	    }
+
+	    /* case unsigned long long: cannot be because JSON string is < 0 */
+	    conv->ulonglong_sized = false;
+
+	    /* case size_t: cannot be because JSON string is < 0 */
+	    conv->size_sized = false;
+
+	    /* case ssize_t: range check */
+	    if (conv->as_maxint >= (intmax_t)SSIZE_MIN && conv->as_maxint <= (intmax_t)SSIZE_MAX) {
+		conv->ssize_sized = true;
+		conv->as_ssize = (ssize_t)conv->as_maxint;
+	    }
+
+	    /* case off_t: range check */
+	    if (conv->as_maxint >= (intmax_t)OFF_MIN && conv->as_maxint <= (intmax_t)OFF_MAX) {
+		conv->off_sized = true;
+		conv->as_off = (off_t)conv->as_maxint;
+	    }
+
+	    /* case intmax_t: copied from the canonical value above */
+
+	    /* case uintmax_t: cannot be because JSON string is < 0 */
+	    conv->umaxint_sized = false;
+
+	} else {
+
+	    /* case int8_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)INT8_MAX) {
+		conv->int8_sized = true;
+		conv->as_int8 = (int8_t)conv->as_umaxint;
+	    }
+
+	    /* case uint8_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)UINT8_MAX) {
+		conv->uint8_sized = true;
+		conv->as_uint8 = (uint8_t)conv->as_umaxint;
+	    }
+
+	    /* case int16_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)INT16_MAX) {
+		conv->int16_sized = true;
+		conv->as_int16 = (int16_t)conv->as_umaxint;
+	    }
+
+	    /* case uint16_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)UINT16_MAX) {
+		conv->uint16_sized = true;
+		conv->as_uint16 = (uint16_t)conv->as_umaxint;
+	    }
+
+	    /* case int32_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)INT32_MAX) {
+		conv->int32_sized = true;
+		conv->as_int32 = (int32_t)conv->as_umaxint;
+	    }
+
+	    /* case uint32_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)UINT32_MAX) {
+		conv->uint32_sized = true;
+		conv->as_uint32 = (uint32_t)conv->as_umaxint;
+	    }
+
+	    /* case int64_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)INT64_MAX) {
+		conv->int64_sized = true;
+		conv->as_int64 = (int64_t)conv->as_umaxint;
+	    }
+
+	    /* case uint64_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)UINT64_MAX) {
+		conv->uint64_sized = true;
+		conv->as_uint64 = (uint64_t)conv->as_umaxint;
+	    }
+
+	    /* case int: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)INT_MAX) {
+		conv->int_sized = true;
+		conv->as_int = (int)conv->as_umaxint;
+	    }
+
+	    /* case unsigned int: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)UINT_MAX) {
+		conv->uint_sized = true;
+		conv->as_uint = (unsigned int)conv->as_umaxint;
+	    }
+
+	    /* case long: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)LONG_MAX) {
+		conv->long_sized = true;
+		conv->as_long = (long)conv->as_umaxint;
+	    }
+
+	    /* case unsigned long: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)ULONG_MAX) {
+		conv->ulong_sized = true;
+		conv->as_ulong = (unsigned long)conv->as_umaxint;
+	    }
+
+	    /* case long long: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)LLONG_MAX) {
+		conv->longlong_sized = true;
+		conv->as_longlong = (long long)conv->as_umaxint;
+	    }
+
+	    /* case unsigned long long: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)ULLONG_MAX) {
+		conv->ulonglong_sized = true;
+		conv->as_ulonglong = (unsigned long long)conv->as_umaxint;
+	    }
+
+	    /* case ssize_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)SSIZE_MAX) {
+		conv->ssize_sized = true;
+		conv->as_ssize = (ssize_t)conv->as_umaxint;
+	    }
+
+	    /* case size_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)SIZE_MAX) {
+		conv->size_sized = true;
+		conv->as_size = (size_t)conv->as_umaxint;
+	    }
+
+	    /* case off_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)OFF_MAX) {
+		conv->off_sized = true;
+		conv->as_off = (off_t)conv->as_umaxint;
+	    }
+
+	    /* case intmax_t: bounds check */
+	    if (conv->as_umaxint <= (uintmax_t)INTMAX_MAX) {
+		conv->maxint_sized = true;
+		conv->as_maxint = (intmax_t)conv->as_umaxint;
+	    }
+
+	    /* case uintmax_t: copied from the canonical value above */
+	}
+    }
+
+    /*
+     * case: JSON floating point or e-notation number
+     */
+    if ((item->is_floating || item->is_e_notation) && item->longdouble_sized) {
+
+	/*
+	 * copy the canonical value
+	 */
+	conv->longdouble_sized = true;
+	conv->as_longdouble = item->as_longdouble;
+	conv->as_longdouble_int = item->as_longdouble_int;
+
+	/*
+	 * convert to double
+	 */
+	errno = 0;			/* pre-clear conversion test */
+	if (json_fast_double(str, item->number_len, &conv->as_double)) {
+	    endptr = (char *)str + item->number_len;
+	} else {
+	    conv->as_double = strtod(str, &endptr);
+	}
+	if (errno == ERANGE || endptr == str || endptr == NULL) {
+	    if (errno == ERANGE) {
+		/* if range problem we know it's parsable */
+		conv->parsed = true;
+	    }
+	    conv->double_sized = false;
+	    dbg(DBG_VVVHIGH, "strtod for <%s> failed", str);
+	} else {
+	    conv->double_sized = true;
+	    conv->parsed = true;
+	    conv->as_double_int = (conv->as_double == floor(conv->as_double));
+	    dbg(DBG_VVVHIGH, "strtod for <%s> returned as %%lg: %.22lg", str, conv->as_double);
+	    dbg(DBG_VVVHIGH, "strtod for <%s> returned as %%le: %.22le", str, conv->as_double);
+	    dbg(DBG_VVVHIGH, "strtod for <%s> returned as %%lf: %.22lf", str, conv->as_double);
+	    dbg(DBG_VVVHIGH, "strtod returned an integer value: %s", booltostr(conv->as_double_int));
+	}
+
+	/*
+	 * convert to float
+	 */
+	errno = 0;			/* pre-clear conversion test */
+	conv->as_float = strtof(str, &endptr);
+	if (errno == ERANGE || endptr == str || endptr == NULL) {
+	    if (errno == ERANGE) {
+		/* if range issue we know it's parsable */
+		conv->parsed = true;
+	    }
+	    conv->float_sized = false;
+	    dbg(DBG_VVVHIGH, "strtof for <%s> failed", str);
+	} else {
+	    conv->parsed = true;
+	    conv->float_sized = true;
+	    conv->as_float_int = (conv->as_longdouble == floorl(conv->as_longdouble));
+	    dbg(DBG_VVVHIGH, "strtof for <%s> returned as %%g: %.22g", str, (double)conv->as_float);
+	    dbg(DBG_VVVHIGH, "strtof for <%s> returned as %%e: %.22e", str, (double)conv->as_float);
+	    dbg(DBG_VVVHIGH, "strtof for <%s> returned as %%f: %.22f", str, (double)conv->as_float);
+	    dbg(DBG_VVVHIGH, "strtof returned an integer value: %s", booltostr(conv->as_float_int));
+	}
+    }
+    return true;
+}
+
+
+/*
+ * json_number_conv - return every C conversion of a JSON number node
+ *
+ * The struct json_number_conv is allocated (from the arena of the node if the
+ * node is arena allocated) and filled in by json_number_to_conv() the first
+ * time this function is called for the node.  Later calls return the same
+ * struct json_number_conv.
+ *
+ * given:
+ *	node	pointer to a JTYPE_NUMBER JSON parse tree node
+ *
+ * returns:
+ *	pointer to the struct json_number_conv of the node,
+ *	NULL ==> node is NULL or not a JTYPE_NUMBER
+ *
+ * NOTE: This function will not return on calloc error.
+ * NOTE: The struct json_number_conv is freed along with the node.
+ */
+struct json_number_conv *
+json_number_conv(struct json *node)
+{
+    struct json_number *item = NULL;	    /* JSON number item inside JSON parser tree node */
+
+    /*
+     * firewall
+     */
+    if (node == NULL) {
+	warn(__func__, "called with NULL node");
+	return NULL;
+    }
+    if (node->type != JTYPE_NUMBER) {
+	warn(__func__, "node type is not JTYPE_NUMBER: %s", json_type_name(node->type));
+	return NULL;
+    }
+    item = &(node->item.number);
+
+    /*
+     * convert on first use
+     */
+    if (item->conv == NULL) {
+	if (node->arena != NULL) {
+	    item->conv = json_arena_alloc(node->arena, sizeof(*(item->conv)));
+	} else {
+	    errno = 0;			/* pre-clear errno for errp() */
+	    item->conv = calloc(1, sizeof(*(item->conv)));
+	    if (item->conv == NULL) {
+		errp(51, __func__, "calloc of struct json_number_conv failed");
+		not_reached();
+	    }
+	}
+	(void) json_number_to_conv(item, item->conv);
+    }
+    return item->conv;
+}
+
+
+/*
+ * json_number_intmax - return a JSON integer as an intmax_t
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is an integer that fits into an intmax_t,
+ *	false ==> JSON number cannot be converted, or NULL item
+ */
+bool
+json_number_intmax(struct json_number const *item, intmax_t *ret)
+{
+    /*
+     * firewall
+     */
+    if (item == NULL || !item->converted || !item->is_integer || !item->maxint_sized) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = item->as_maxint;
+    }
+    return true;
+}
+
+
+/*
+ * json_number_uintmax - return a JSON integer as an uintmax_t
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is an integer that fits into an uintmax_t,
+ *	false ==> JSON number cannot be converted, or NULL item
+ */
+bool
+json_number_uintmax(struct json_number const *item, uintmax_t *ret)
+{
+    /*
+     * firewall
+     */
+    if (item == NULL || !item->converted || !item->is_integer || !item->umaxint_sized) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = item->as_umaxint;
+    }
+    return true;
+}
+
+
+/*
+ * json_number_int - return a JSON integer as an int
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is an integer that fits into an int,
+ *	false ==> JSON number cannot be converted, or NULL item
+ */
+bool
+json_number_int(struct json_number const *item, int *ret)
+{
+    intmax_t val = 0;		/* canonical value */
+
+    if (!json_number_intmax(item, &val) || val < (intmax_t)INT_MIN || val > (intmax_t)INT_MAX) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = (int)val;
+    }
+    return true;
+}
+
+
+/*
+ * json_number_uint - return a JSON integer as an unsigned int
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is an integer that fits into an unsigned int,
+ *	false ==> JSON number cannot be converted, or NULL item
+ */
+bool
+json_number_uint(struct json_number const *item, unsigned int *ret)
+{
+    uintmax_t val = 0;		/* canonical value */
+
+    if (!json_number_uintmax(item, &val) || val > (uintmax_t)UINT_MAX) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = (unsigned int)val;
+    }
+    return true;
+}
+
+
+/*
+ * json_number_size - return a JSON integer as a size_t
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is an integer that fits into a size_t,
+ *	false ==> JSON number cannot be converted, or NULL item
+ */
+bool
+json_number_size(struct json_number const *item, size_t *ret)
+{
+    uintmax_t val = 0;		/* canonical value */
+
+    if (!json_number_uintmax(item, &val) || val > (uintmax_t)SIZE_MAX) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = (size_t)val;
+    }
+    return true;
+}
+
+
+/*
+ * json_number_longdouble - return a JSON floating point number as a long double
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is a floating point or e-notation number that fits
+ *		 into a long double,
+ *	false ==> JSON number cannot be converted, or NULL item
+ */
+bool
+json_number_longdouble(struct json_number const *item, long double *ret)
+{
+    /*
+     * firewall
+     */
+    if (item == NULL || !item->converted || !item->longdouble_sized) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = item->as_longdouble;
+    }
+    return true;
+}
+
+
+/*
+ * json_number_double - return a JSON floating point number as a double
+ *
+ * given:
+ *	item	pointer to a JSON number as parsed by json_conv_number()
+ *	ret	where to store the value, if ret != NULL
+ *
+ * returns:
+ *	true ==> JSON number is a floating point or e-notation number that fits
+ *		 into a double,
+ *	false ==> JSON number cannot be converted, or NULL item
+ *
+ * NOTE: The JSON number string is converted by strtod(3) so that the value
+ *	 is correctly rounded, rather than being rounded twice via the long double.
+ */
+bool
+json_number_double(struct json_number const *item, double *ret)
+{
+    char *endptr;			/* first invalid character or str */
+    double val = 0.0;			/* converted value */
+
+    /*
+     * firewall
+     */
+    if (item == NULL || !item->converted || !item->longdouble_sized || item->first == NULL) {
+	return false;
+    }
+
+    errno = 0;			/* pre-clear conversion test */
+    val = strtod(item->first, &endptr);
+    if (errno == ERANGE || endptr == item->first || endptr == NULL) {
+	return false;
+    }
+
+    if (ret != NULL) {
+	*ret = val;
+    }
     return true;
 }
 
@@ -3239,37 +4801,13 @@ json_conv_number(char const *ptr, size_t len)
     item->is_negative = false;
     item->is_floating = false;
     item->is_e_notation = false;
-    /* integer values */
     item->is_integer = false;
-    item->int8_sized = false;
-    item->uint8_sized = false;
-    item->int16_sized = false;
-    item->uint16_sized = false;
-    item->int32_sized = false;
-    item->uint32_sized = false;
-    item->int64_sized = false;
-    item->uint64_sized = false;
-    item->int_sized = false;
-    item->uint_sized = false;
-    item->long_sized = false;
-    item->ulong_sized = false;
-    item->longlong_sized = false;
-    item->ulonglong_sized = false;
-    item->ssize_sized = false;
-    item->size_sized = false;
-    item->off_sized = false;
     item->maxint_sized = false;
     item->umaxint_sized = false;
-    /* floating point values */
-    item->float_sized = false;
-    item->as_float = 0.0f;
-    item->as_float_int = false;
-    item->double_sized = false;
-    item->as_double = 0.0;
-    item->as_double_int = false;
     item->longdouble_sized = false;
-    item->as_longdouble = 0.0L;
     item->as_longdouble_int = false;
+    item->conv = NULL;
+    item->as_longdouble = 0.0L;		/* also zeros as_maxint and as_umaxint */
 
     /*
      * firewall
@@ -3289,17 +4827,29 @@ json_conv_number(char const *ptr, size_t len)
     }
 
     /*
-     * duplicate the JSON integer string
+     * case: zero-copy - reference the JSON number in the input buffer
+     *
+     * NOTE: The scanner NUL terminates the token while it is being converted.
+     *	     Once the scan is done json_input_terminate() NUL terminates it
+     *	     for good.
      */
-    errno = 0;			/* pre-clear errno for errp() */
-    item->as_str = calloc(len+1+1, sizeof(*(item->as_str)));
-    if (item->as_str == NULL) {
-	errp(13, __func__, "calloc #1 error allocating %zu bytes", (len+1+1));
-	not_reached();
+    if (json_input_span(ret->arena, ptr, len) && ptr[len] == '\0') {
+	item->as_str = (char *)ptr;
+
+    /*
+     * otherwise duplicate the JSON integer string
+     */
+    } else {
+	errno = 0;			/* pre-clear errno for errp() */
+	item->as_str = json_calloc(len+1+1, sizeof(*(item->as_str)));
+	if (item->as_str == NULL) {
+	    errp(13, __func__, "calloc #1 error allocating %zu bytes", (len+1+1));
+	    not_reached();
+	}
+	strncpy(item->as_str, ptr, len);
+	item->as_str[len] = '\0';	/* paranoia */
+	item->as_str[len+1] = '\0';	/* paranoia */
     }
-    strncpy(item->as_str, ptr, len);
-    item->as_str[len] = '\0';	/* paranoia */
-    item->as_str[len+1] = '\0';	/* paranoia */
 
     /*
      * ignore whitespace
@@ -3362,8 +4912,10 @@ json_conv_number(char const *ptr, size_t len)
 
     /*
      * case: JSON number is an e-notation number
+     *
+     * NOTE: A floating point number in e-notation was processed above.
      */
-    if (e_notation) {
+    if (e_notation && !floating_notation) {
 
 	/* process JSON number as floating point or e-notation number */
 	success = json_process_floating(item, item->first, item->number_len);
@@ -3677,6 +5229,7 @@ json_conv_string(char const *ptr, size_t len, bool quote)
     item->posix_safe = false;
     item->first_alphanum = false;
     item->upper = false;
+    item->posix_chked = false;
 
     /*
      * firewall
@@ -3718,45 +5271,93 @@ json_conv_string(char const *ptr, size_t len, bool quote)
     }
 
     /*
-     * duplicate the JSON string
+     * case: zero-copy - reference the JSON string in the input buffer
+     *
+     * NOTE: The closing '"' has already been scanned, so it is overwritten
+     *	     with the NUL byte that terminates as_str.
      */
-    errno = 0;			/* pre-clear errno for errp() */
-    item->as_str = calloc(len+1+1, sizeof(*(item->as_str)));
-    if (item->as_str == NULL) {
-	errp(17, __func__, "calloc #1 error allocating %zu bytes", (len+1+1));
-	not_reached();
+    if (item->quote && json_input_span(ret->arena, ptr, len+1)) {
+	item->as_str = (char *)ptr;
+	item->as_str[len] = '\0';
+
+    /*
+     * otherwise duplicate the JSON string
+     */
+    } else {
+	errno = 0;			/* pre-clear errno for errp() */
+	item->as_str = json_calloc(len+1+1, sizeof(*(item->as_str)));
+	if (item->as_str == NULL) {
+	    errp(17, __func__, "calloc #1 error allocating %zu bytes", (len+1+1));
+	    not_reached();
+	}
+	strncpy(item->as_str, ptr, len);
+	item->as_str[len] = '\0';	/* paranoia */
+	item->as_str[len+1] = '\0';	/* paranoia */
     }
-    strncpy(item->as_str, ptr, len);
-    item->as_str[len] = '\0';	/* paranoia */
-    item->as_str[len+1] = '\0';	/* paranoia */
 
     /*
-     * decode the JSON encoded string
+     * validate the JSON encoded string and determine the length of its decoding
      */
-    /* decode the entire string */
-    item->str = json_decode(item->as_str, len, quote, &(item->str_len));
-    if (item->str == NULL) {
+    if (json_decode_len(item->as_str, len, &(item->str_len)) == false) {
+	item->str_len = 0;
 	warn(__func__, "quote === %s: JSON string decode failed for: <%s>",
 		       booltostr(quote), item->as_str);
 	return ret;
     }
+
+    /*
+     * case: no \-escapes - the decoded string is as_str itself
+     *
+     * NOTE: Every \-escape decodes into fewer bytes than it was encoded with, so
+     *	     when the decoded length is the encoded length there was no \-escape
+     *	     and there is nothing to decode.
+     */
+    if (item->str_len == len) {
+	item->str = item->as_str;
+
+    /*
+     * case: \-escapes found - decode the JSON encoded string
+     *
+     * NOTE: Only the decoding can fully validate \uxxxx escapes, so a JSON string
+     *	     with \-escapes is always decoded here.
+     */
+    } else {
+	item->str = json_decode(item->as_str, len, quote, &(item->str_len));
+	if (item->str == NULL) {
+	    warn(__func__, "quote === %s: JSON string decode failed for: <%s>",
+			   booltostr(quote), item->as_str);
+	    return ret;
+	}
+
+	/*
+	 * move the decoded string into the arena, if the node is arena allocated
+	 */
+	if (ret->arena != NULL) {
+	    char *str = json_arena_alloc(ret->arena, item->str_len+1);
+
+	    memcpy(str, item->str, item->str_len+1);
+	    free(item->str);
+	    item->str = str;
+	}
+    }
     item->parsed = true;	/* JSON parsed successful */
     item->converted = true;	/* JSON decoding successful */
 
     /*
      * determine if decoded string is identical to the original JSON encoded string
      *
-     * NOTE: We use memcmp() because there might be NUL bytes in the 'char *'
-     * and strcmp() would stop at the first '\0'.
+     * NOTE: A decoded string with the length of the original JSON encoded
+     *	     string had no \-escapes, so there is no need to compare bytes.
      */
-    if (item->as_str_len == item->str_len && memcmp(item->as_str, item->str, item->as_str_len) == 0) {
+    if (item->as_str_len == item->str_len) {
 	item->same = true;	/* decoded string same an original JSON encoded string (perhaps sans '"'s) */
     }
 
     /*
-     * determine POSIX state of the decoded string
+     * NOTE: The POSIX state of the decoded string (slash, posix_safe,
+     *	     first_alphanum and upper) is only determined when first needed,
+     *	     see json_string_posix().
      */
-    posix_safe_chk(item->str, item->str_len, &item->slash, &item->posix_safe, &item->first_alphanum, &item->upper);
     json_dbg(JSON_DBG_VHIGH, __func__, "JSON return type: %s", json_item_type_name(ret));
 
     /*
@@ -3766,6 +5367,51 @@ json_conv_string(char const *ptr, size_t len, bool quote)
 }
 
 
+/*
+ * json_string_posix - determine the POSIX state of the decoded string of a JSON string node
+ *
+ * The slash, posix_safe, first_alphanum and upper booleans of the JSON string
+ * are determined the first time this function is called for the node.
+ *
+ * given:
+ *	node	pointer to a JTYPE_STRING JSON parse tree node
+ *
+ * returns:
+ *	true ==> slash, posix_safe, first_alphanum and upper are set,
+ *	false ==> node is NULL, not a JTYPE_STRING, or not converted
+ */
+bool
+json_string_posix(struct json *node)
+{
+    struct json_string *item = NULL;	    /* JSON string item inside JSON parser tree node */
+
+    /*
+     * firewall
+     */
+    if (node == NULL) {
+	warn(__func__, "called with NULL node");
+	return false;
+    }
+    if (node->type != JTYPE_STRING) {
+	warn(__func__, "node type is not JTYPE_STRING: %s", json_type_name(node->type));
+	return false;
+    }
+    item = &(node->item.string);
+    if (!CONVERTED_PARSED_JSON_NODE(item) || item->str == NULL) {
+	return false;
+    }
+
+    /*
+     * determine POSIX state of the decoded string on first use
+     */
+    if (item->posix_chked == false) {
+	posix_safe_chk(item->str, item->str_len, &item->slash, &item->posix_safe, &item->first_alphanum, &item->upper);
+	item->posix_chked = true;
+    }
+    return true;
+}
+
+
 /*
  * json_conv_string_str - convert JSON encoded string to C string
  *
@@ -3888,7 +5534,7 @@ json_conv_bool(char const *ptr, size_t len)
      * duplicate the JSON encoded string
      */
     errno = 0;			/* pre-clear errno for errp() */
-    item->as_str = calloc(len+1+1, sizeof(*(item->as_str)));
+    item->as_str = json_calloc(len+1+1, sizeof(*(item->as_str)));
     if (item->as_str == NULL) {
 	errp(20, __func__, "calloc #1 error allocating %zu bytes", (len+1+1));
 	not_reached();
@@ -4043,7 +5689,7 @@ json_conv_null(char const *ptr, size_t len)
      * duplicate the JSON string
      */
     errno = 0;			/* pre-clear errno for errp() */
-    item->as_str = calloc(len+1+1, sizeof(*(item->as_str)));
+    item->as_str = json_calloc(len+1+1, sizeof(*(item->as_str)));
     if (item->as_str == NULL) {
 	errp(23, __func__, "calloc #1 error allocating %zu bytes", (len+1+1));
 	not_reached();
@@ -4309,21 +5955,31 @@ json_create_object(void)
     item->len = 0;
     item->set = NULL;
     item->s = NULL;
+    item->index = NULL;
 
     /*
-     * create a dynamic array to store JSON objects
+     * case: arena allocated node - store JSON objects in an arena allocated set
      */
-    item->s = dyn_array_create(sizeof (struct json *), JSON_CHUNK, JSON_CHUNK, true);
-    if (item->s == NULL) {
-	errp(29, __func__, "dyn_array_create() returned NULL");
-	not_reached();
-    }
+    if (ret->arena != NULL) {
+	item->set = json_arena_alloc(ret->arena, JSON_CHUNK * sizeof(*(item->set)));
+	item->len = 0;
 
     /*
-     * initialize accounting for the object
+     * case: calloc()ed node - create a dynamic array to store JSON objects
      */
-    item->len = dyn_array_tell(item->s);
-    item->set = dyn_array_addr(item->s, struct json *, 0);
+    } else {
+	item->s = dyn_array_create(sizeof (struct json *), JSON_CHUNK, JSON_CHUNK, true);
+	if (item->s == NULL) {
+	    errp(29, __func__, "dyn_array_create() returned NULL");
+	    not_reached();
+	}
+
+	/*
+	 * initialize accounting for the object
+	 */
+	item->len = dyn_array_tell(item->s);
+	item->set = dyn_array_addr(item->s, struct json *, 0);
+    }
     item->converted = true;
     item->parsed = true;
 
@@ -4391,7 +6047,7 @@ json_object_add_member(struct json *node, struct json *member)
      * point to object
      */
     item = &(node->item.object);
-    if (item->s == NULL) {
+    if (item->s == NULL && node->arena == NULL) {
 	err(34, __func__, "item->s is NULL");
 	not_reached();
     }
@@ -4402,19 +6058,35 @@ json_object_add_member(struct json *node, struct json *member)
     member->parent = node;
 
     /*
-     * append member
+     * case: arena allocated node - append member to the arena allocated set
      */
-    moved = dyn_array_append_value(item->s, &member);
-    if (moved == true) {
-	dbg(DBG_HIGH, "in %s(): dyn_array_append_value moved data",
-		      __func__);
+    if (node->arena != NULL) {
+	item->set = json_arena_set_append(node->arena, item->set, item->len, member);
+	++item->len;
+
+    /*
+     * case: calloc()ed node - append member to the dynamic array
+     */
+    } else {
+	moved = dyn_array_append_value(item->s, &member);
+	if (moved == true) {
+	    dbg(DBG_HIGH, "in %s(): dyn_array_append_value moved data",
+			  __func__);
+	}
+
+	/*
+	 * update accounting for the object
+	 */
+	item->len = dyn_array_tell(item->s);
+	item->set = dyn_array_addr(item->s, struct json *, 0);
     }
 
     /*
-     * update accounting for the object
+     * keep the index of the members by name, if there is one, up to date
      */
-    item->len = dyn_array_tell(item->s);
-    item->set = dyn_array_addr(item->s, struct json *, 0);
+    if (item->index != NULL) {
+	item->index = json_object_index_add(node, item->index, member);
+    }
 
     json_dbg(JSON_DBG_VHIGH, __func__, "JSON object node type: %s", json_item_type_name(node));
     json_dbg(JSON_DBG_VHIGH, __func__, "JSON object member type: %s", json_item_type_name(member));
@@ -4423,6 +6095,305 @@ json_object_add_member(struct json *node, struct json *member)
 }
 
 
+/*
+ * json_object_hash - hash a decoded JSON member name
+ *
+ * This is the 32 bit FNV-1a hash of the bytes of the name.  Besides the
+ * index of an object, it is used by the index of a JSON semantic table (see
+ * json_sem_find()).
+ *
+ * given:
+ *	name	decoded JSON member name (need not be NUL terminated)
+ *	len	length of name in bytes
+ *
+ * returns:
+ *	hash of name
+ */
+uint32_t
+json_object_hash(char const *name, size_t len)
+{
+    uint32_t hash = (uint32_t)2166136261U;	/* FNV-1a 32 bit offset basis */
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+	hash ^= (uint8_t)name[i];
+	hash *= (uint32_t)16777619U;		/* FNV-1a 32 bit prime */
+    }
+    return hash;
+}
+
+
+/*
+ * json_object_index_alloc - allocate an empty JSON object member index
+ *
+ * given:
+ *	node	JSON node of the JSON object the index is for
+ *	size	number of slots, a power of 2
+ *
+ * returns:
+ *	allocated empty index: calloc()ed or, if node is arena allocated,
+ *	allocated from the arena of node
+ *
+ * NOTE: This function does not return on calloc error.
+ */
+static struct json_object_index *
+json_object_index_alloc(struct json *node, size_t size)
+{
+    struct json_object_index *index = NULL;	/* allocated index */
+    size_t bytes = sizeof(*index) + size * sizeof(index->slot[0]);	/* size of the index */
+
+    /*
+     * case: arena allocated node - storage is already zeroed
+     */
+    if (node->arena != NULL) {
+	index = json_arena_alloc(node->arena, bytes);
+
+    /*
+     * case: calloc()ed node
+     */
+    } else {
+	errno = 0;		/* pre-clear errno for errp() */
+	index = calloc(1, bytes);
+	if (index == NULL) {
+	    errp(250, __func__, "calloc of %zu byte JSON object index failed", bytes);
+	    not_reached();
+	}
+    }
+    index->size = size;
+    index->count = 0;
+    index->dups = 0;
+    return index;
+}
+
+
+/*
+ * json_object_index_add - add a JSON member to a JSON object member index
+ *
+ * If the index already has a member with the same name, the member is only
+ * counted as a duplicate: json_object_get() returns the first member with a
+ * given name.  An index that would become more than half full is first
+ * replaced by an index twice the size.
+ *
+ * given:
+ *	node	JSON node of the JSON object the index is for
+ *	index	index of the members of node
+ *	member	JSON node of the JSON member to add
+ *
+ * returns:
+ *	index, or the index that replaced it
+ *
+ * NOTE: A member that is not a converted JTYPE_MEMBER is not indexed.
+ *
+ * NOTE: This function does not return on calloc error.
+ */
+static struct json_object_index *
+json_object_index_add(struct json *node, struct json_object_index *index, struct json *member)
+{
+    struct json_object_index *grown = NULL;	/* index twice the size */
+    struct json_member *item = NULL;		/* member being added */
+    struct json_member *slot_item = NULL;	/* member in a slot */
+    uint32_t hash = 0;				/* hash of the member name */
+    size_t mask = 0;				/* slot number mask */
+    size_t i;
+
+    /*
+     * only converted JSON members with a decoded name are indexed
+     */
+    if (member == NULL || member->type != JTYPE_MEMBER) {
+	return index;
+    }
+    item = &(member->item.member);
+    if (item->name_str == NULL) {
+	return index;
+    }
+
+    /*
+     * grow the index before it becomes more than half full
+     */
+    if ((index->count + 1) * 2 > index->size) {
+	grown = json_object_index_alloc(node, index->size * 2);
+	mask = grown->size - 1;
+	for (i = 0; i < index->size; ++i) {
+	    size_t j;
+
+	    if (index->slot[i].member == NULL) {
+		continue;
+	    }
+	    for (j = index->slot[i].hash & mask; grown->slot[j].member != NULL; j = (j + 1) & mask) {
+		;
+	    }
+	    grown->slot[j] = index->slot[i];
+	}
+	grown->count = index->count;
+	grown->dups = index->dups;
+	if (node->arena == NULL) {
+	    free(index);
+	}
+	index = grown;
+    }
+
+    /*
+     * find the slot of the name, or the empty slot for it
+     */
+    hash = json_object_hash(item->name_str, item->name_str_len);
+    mask = index->size - 1;
+    for (i = hash & mask; index->slot[i].member != NULL; i = (i + 1) & mask) {
+	slot_item = &(index->slot[i].member->item.member);
+	if (index->slot[i].hash == hash && slot_item->name_str_len == item->name_str_len &&
+	    memcmp(slot_item->name_str, item->name_str, item->name_str_len) == 0) {
+
+	    /*
+	     * case: duplicate name - keep the first member with the name
+	     */
+	    ++index->dups;
+	    json_dbg(JSON_DBG_MED, __func__, "JSON object member name is a duplicate: <%s>", item->name_str);
+	    return index;
+	}
+    }
+
+    /*
+     * index the member
+     */
+    index->slot[i].hash = hash;
+    index->slot[i].member = member;
+    ++index->count;
+    return index;
+}
+
+
+/*
+ * json_object_index - index the members of a JSON object by name
+ *
+ * Build the index of the members of a JSON object by decoded name, if the
+ * object does not have one yet.  Once built, json_object_add_member() adds
+ * each new member to the index, counting the members whose name is a
+ * duplicate.  json_object_get() builds the index as needed: this function is
+ * for building it explicitly, for instance before the JSON parse tree is
+ * shared among threads (a lookup in an object with no index yet builds the
+ * index), or before adding members to find duplicate names as they are added.
+ *
+ * given:
+ *	node	JSON node of a JSON object
+ *
+ * returns:
+ *	index of the members of node, or NULL ==> node is NULL or not a JTYPE_OBJECT
+ *
+ * NOTE: This function does not return on calloc error.
+ */
+struct json_object_index *
+json_object_index(struct json *node)
+{
+    struct json_object *item = NULL;	/* JSON object */
+    size_t size = 0;			/* number of slots */
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (node == NULL || node->type != JTYPE_OBJECT) {
+	return NULL;
+    }
+    item = &(node->item.object);
+    if (item->index != NULL) {
+	return item->index;
+    }
+
+    /*
+     * allocate an index with room for all of the members
+     */
+    for (size = JSON_OBJECT_INDEX_MIN * 2; (intmax_t)(size / 2) < item->len; size *= 2) {
+	;
+    }
+    item->index = json_object_index_alloc(node, size);
+
+    /*
+     * index the members in order
+     */
+    if (item->set != NULL) {
+	for (i = 0; i < item->len; ++i) {
+	    item->index = json_object_index_add(node, item->index, item->set[i]);
+	}
+    }
+    json_dbg(JSON_DBG_VHIGH, __func__, "indexed %zu names of %jd JSON object members, %jd duplicate(s)",
+			     item->index->count, item->len, item->index->dups);
+    return item->index;
+}
+
+
+/*
+ * json_object_get - find a JSON member of a JSON object by name
+ *
+ * Return the first member of a JSON object with a given decoded name, the same
+ * member that comparing the name of every member in order would find.  In an
+ * object with at least JSON_OBJECT_INDEX_MIN members the member is looked up
+ * in the index of the object (built on the first lookup if needed), otherwise
+ * the names of the members are compared.
+ *
+ * given:
+ *	node	JSON node of a JSON object
+ *	name	decoded JSON member name (need not be NUL terminated)
+ *	len	length of name in bytes
+ *
+ * returns:
+ *	JSON node of the JTYPE_MEMBER with the name,
+ *	NULL ==> no such member, or NULL arg or node is not a JTYPE_OBJECT
+ *
+ * NOTE: This function does not return on calloc error.
+ */
+struct json *
+json_object_get(struct json *node, char const *name, size_t len)
+{
+    struct json_object *item = NULL;		/* JSON object */
+    struct json_object_index *index = NULL;	/* index of members of the object */
+    struct json_member *member = NULL;		/* member being compared */
+    uint32_t hash = 0;				/* hash of name */
+    size_t mask = 0;				/* slot number mask */
+    size_t i;
+    intmax_t j;
+
+    /*
+     * firewall
+     */
+    if (node == NULL || name == NULL || node->type != JTYPE_OBJECT) {
+	return NULL;
+    }
+    item = &(node->item.object);
+    if (item->set == NULL || item->len <= 0) {
+	return NULL;
+    }
+
+    /*
+     * case: small object - compare the name of each member
+     */
+    if (item->index == NULL && item->len < JSON_OBJECT_INDEX_MIN) {
+	for (j = 0; j < item->len; ++j) {
+	    if (item->set[j] == NULL || item->set[j]->type != JTYPE_MEMBER) {
+		continue;
+	    }
+	    member = &(item->set[j]->item.member);
+	    if (member->name_str != NULL && member->name_str_len == len && memcmp(member->name_str, name, len) == 0) {
+		return item->set[j];
+	    }
+	}
+	return NULL;
+    }
+
+    /*
+     * look the name up in the index
+     */
+    index = json_object_index(node);
+    hash = json_object_hash(name, len);
+    mask = index->size - 1;
+    for (i = hash & mask; index->slot[i].member != NULL; i = (i + 1) & mask) {
+	member = &(index->slot[i].member->item.member);
+	if (index->slot[i].hash == hash && member->name_str_len == len && memcmp(member->name_str, name, len) == 0) {
+	    return index->slot[i].member;
+	}
+    }
+    return NULL;
+}
+
+
 /*
  * json_create_elements - allocate an empty JSON elements
  *
@@ -4464,19 +6435,28 @@ json_create_elements(void)
     item->s = NULL;
 
     /*
-     * create a dynamic array to store JSON values
+     * case: arena allocated node - store JSON values in an arena allocated set
      */
-    item->s = dyn_array_create(sizeof (struct json *), JSON_CHUNK, JSON_CHUNK, true);
-    if (item->s == NULL) {
-	errp(36, __func__, "dyn_array_create() returned NULL");
-	not_reached();
-    }
+    if (ret->arena != NULL) {
+	item->set = json_arena_alloc(ret->arena, JSON_CHUNK * sizeof(*(item->set)));
+	item->len = 0;
 
     /*
-     * initialize accounting for the array
+     * case: calloc()ed node - create a dynamic array to store JSON values
      */
-    item->len = dyn_array_tell(item->s);
-    item->set = dyn_array_addr(item->s, struct json *, 0);
+    } else {
+	item->s = dyn_array_create(sizeof (struct json *), JSON_CHUNK, JSON_CHUNK, true);
+	if (item->s == NULL) {
+	    errp(36, __func__, "dyn_array_create() returned NULL");
+	    not_reached();
+	}
+
+	/*
+	 * initialize accounting for the array
+	 */
+	item->len = dyn_array_tell(item->s);
+	item->set = dyn_array_addr(item->s, struct json *, 0);
+    }
     item->converted = true;
     item->parsed = true;
 
@@ -4557,7 +6537,7 @@ json_elements_add_value(struct json *node, struct json *value)
      * point to array
      */
     item = &(node->item.elements);
-    if (item->s == NULL) {
+    if (item->s == NULL && node->arena == NULL) {
 	err(42, __func__, "item->s is NULL");
 	not_reached();
     }
@@ -4568,19 +6548,28 @@ json_elements_add_value(struct json *node, struct json *value)
     value->parent = node;
 
     /*
-     * append value
+     * case: arena allocated node - append value to the arena allocated set
      */
-    moved = dyn_array_append_value(item->s, &value);
-    if (moved == true) {
-	dbg(DBG_HIGH, "in %s(): dyn_array_append_value moved data",
-		      __func__);
-    }
+    if (node->arena != NULL) {
+	item->set = json_arena_set_append(node->arena, item->set, item->len, value);
+	++item->len;
 
     /*
-     * update accounting for the array
+     * case: calloc()ed node - append value to the dynamic array
      */
-    item->len = dyn_array_tell(item->s);
-    item->set = dyn_array_addr(item->s, struct json *, 0);
+    } else {
+	moved = dyn_array_append_value(item->s, &value);
+	if (moved == true) {
+	    dbg(DBG_HIGH, "in %s(): dyn_array_append_value moved data",
+			  __func__);
+	}
+
+	/*
+	 * update accounting for the array
+	 */
+	item->len = dyn_array_tell(item->s);
+	item->set = dyn_array_addr(item->s, struct json *, 0);
+    }
     return node;
 }
 
@@ -4629,19 +6618,28 @@ json_create_array(void)
     item->s = NULL;
 
     /*
-     * create a dynamic array to store JSON arrays
+     * case: arena allocated node - store JSON arrays in an arena allocated set
      */
-    item->s = dyn_array_create(sizeof (struct json *), JSON_CHUNK, JSON_CHUNK, true);
-    if (item->s == NULL) {
-	errp(44, __func__, "dyn_array_create() returned NULL");
-	not_reached();
-    }
+    if (ret->arena != NULL) {
+	item->set = json_arena_alloc(ret->arena, JSON_CHUNK * sizeof(*(item->set)));
+	item->len = 0;
 
     /*
-     * initialize accounting for the array
+     * case: calloc()ed node - create a dynamic array to store JSON arrays
      */
-    item->len = dyn_array_tell(item->s);
-    item->set = dyn_array_addr(item->s, struct json *, 0);
+    } else {
+	item->s = dyn_array_create(sizeof (struct json *), JSON_CHUNK, JSON_CHUNK, true);
+	if (item->s == NULL) {
+	    errp(44, __func__, "dyn_array_create() returned NULL");
+	    not_reached();
+	}
+
+	/*
+	 * initialize accounting for the array
+	 */
+	item->len = dyn_array_tell(item->s);
+	item->set = dyn_array_addr(item->s, struct json *, 0);
+    }
     item->converted = true;
     item->parsed = true;
 
@@ -42,6 +42,8 @@
 #    define  INCLUDE_JSON_PARSE_H
 
 
+#include <stddef.h>	/* for max_align_t */
+
 /*
  * util - common utility functions for the JSON parser
  */
@@ -74,6 +76,7 @@
  * definitions
  */
 #define JSON_BYTE_VALUES (BYTE_VALUES) /* to make the purpose clearer we have the JSON_ prefix */
+#define JSON_DECODE_ESC_MAX (12)	/* longest \-escape json_decode() looks at: a \uxxxx\uxxxx surrogate pair */
 
 
 /*
@@ -128,14 +131,19 @@ struct byte2asciistr
  * the number of bytes, starting with first, that contain the actual
  * JSON number string.
  *
- * If is_floating == false, then the JSON number was attempted to be converted
- * as an integer.  In this case the "integer values" fields will be used and
- * the "floating point values" fields will be unused (set to false, or 0.0);
+ * Only the canonical C value of the JSON number is kept in the JSON parse
+ * tree node: a JSON integer is converted to an intmax_t (as_maxint, if
+ * maxint_sized == true) and/or an uintmax_t (as_umaxint, if umaxint_sized ==
+ * true) while a JSON floating point or e-notation number is converted to a
+ * long double (as_longdouble, if longdouble_sized == true).  The conversions
+ * into the narrower C types (int8_t, int, size_t, float, double etc.) are only
+ * made when asked for, by the json_number_*() accessor functions or by
+ * json_number_conv() and json_number_to_conv() which fill in a struct
+ * json_number_conv (see below) with every conversion.
  *
- * If is_floating == true then, then the JSON number was attempted to be converted
- * as a floating point value. In this case the "floating point values" fields
- * will be used, and the "integer values" fields will be unused (set to false,
- * or 0).
+ * NOTE: a JSON integer is never converted to a long double and a JSON floating
+ *	 point or e-notation number is never converted to an integer, so as_maxint,
+ *	 as_umaxint and as_longdouble share the same storage.
  *
  * A JSON number string is of the form:
  *
@@ -160,6 +168,60 @@ struct json_number
     bool parsed;		/* true ==> able to parse correctly */
     bool converted;		/* true ==> able to convert JSON number string to some form of C value */
 
+    bool is_negative;		/* true ==> value < 0 */
+
+    bool is_floating;		/* true ==> as_str had a '.' in it such as 1.234, false ==> no '.' found */
+    bool is_e_notation;		/* true ==> e notation used such as 1e10, false ==> no e notation found */
+    bool is_integer;		/* true ==> converted to some integer type below */
+
+    bool maxint_sized;		/* true ==> converted JSON integer to C maxint_t */
+    bool umaxint_sized;		/* true ==> converted JSON integer to C umaxint_t */
+    bool longdouble_sized;	/* true ==> converted JSON float to C long double */
+    bool as_longdouble_int;	/* if longdouble_sized == true, true ==> as_longdouble is an integer */
+
+    char *as_str;		/* allocated copy of the original allocated JSON number, NUL terminated */
+    char *first;		/* first whitespace character */
+
+    size_t as_str_len;		/* length of as_str */
+    size_t number_len;		/* length of JSON number, w/o leading or trailing whitespace and NUL bytes */
+
+    struct json_number_conv *conv;	/* every C conversion, once json_number_conv() is called, or NULL */
+
+    /* canonical value */
+
+    union {
+	intmax_t as_maxint;	/* JSON integer value in as_maxint form, if maxint_sized == true */
+	uintmax_t as_umaxint;	/* JSON integer value in as_umaxint form, if umaxint_sized == true */
+	long double as_longdouble;	/* JSON floating point value in long double form, if longdouble_sized  == true */
+    };
+};
+
+
+/*
+ * every C conversion of a JSON number
+ *
+ * This structure holds the conversion of a JSON number into every C integer
+ * and floating point type, as made, on demand, by json_number_conv() and
+ * json_number_to_conv().  The fields common with struct json_number have the
+ * same meaning and value as those in the struct json_number converted.
+ *
+ * If is_integer == true, then the JSON number was attempted to be converted
+ * as an integer.  In this case the "integer values" fields will be used and
+ * the "floating point values" fields will be unused (set to false, or 0.0);
+ *
+ * If is_floating == true or is_e_notation == true then, then the JSON number
+ * was attempted to be converted as a floating point value. In this case the
+ * "floating point values" fields will be used, and the "integer values" fields
+ * will be unused (set to false, or 0).
+ *
+ * NOTE: as_str and first point to the as_str of the struct json_number
+ *	 converted, they are not copies.
+ */
+struct json_number_conv
+{
+    bool parsed;		/* true ==> able to parse correctly */
+    bool converted;		/* true ==> able to convert JSON number string to some form of C value */
+
     char *as_str;		/* allocated copy of the original allocated JSON number, NUL terminated */
     char *first;		/* first whitespace character */
 
@@ -266,6 +328,11 @@ struct json_number
  * NOTE: We let the conversion function decide whether the string is actually
  * invalid according to the JSON standard so the regex above is for the parser
  * even if it allows things in the string that JSON does not allow.
+ *
+ * When the JSON string has no \-escapes there is nothing to decode: str
+ * points to as_str instead of an allocated copy.  The slash, posix_safe,
+ * first_alphanum and upper booleans are only valid once posix_chked == true:
+ * use json_string_posix() to determine them.
  */
 struct json_string
 {
@@ -273,7 +340,7 @@ struct json_string
     bool converted;		/* true ==> able to decode JSON string, false ==> str is invalid or not decoded */
 
     char *as_str;		/* allocated non-decoded JSON string, NUL terminated (perhaps sans JSON '"'s) */
-    char *str;			/* allocated decoded JSON string, NUL terminated */
+    char *str;			/* allocated decoded JSON string, NUL terminated, or as_str if no \-escapes */
 
     size_t as_str_len;		/* length of as_str, not including final NUL */
     size_t str_len;		/* length of str, not including final NUL */
@@ -286,6 +353,7 @@ struct json_string
     bool posix_safe;		/* true ==> all chars are POSIX portable safe plus + and maybe / after decoding */
     bool first_alphanum;	/* true ==> first char is alphanumeric after decoding */
     bool upper;			/* true ==> UPPER case chars found after decoding */
+    bool posix_chked;		/* true ==> slash, posix_safe, first_alphanum and upper have been determined */
 };
 
 
@@ -379,6 +447,39 @@ struct json_member
 };
 
 
+/*
+ * JSON object member index
+ *
+ * A hash index of the members of a JSON object by their decoded name, so that
+ * json_object_get() does not have to compare the name of every member.  The
+ * index of an object is built by json_object_get() on the first lookup in an
+ * object with at least JSON_OBJECT_INDEX_MIN members (or by json_object_index()),
+ * not while parsing, and is then kept up to date by json_object_add_member().
+ * Only the first of the members with the same name is indexed: the others are
+ * counted in dups.
+ *
+ * The slots are open addressed (linear probing), and there are always at
+ * least twice as many slots as indexed names.  The index is a single
+ * allocation: it is calloc()ed, or for an arena allocated JSON object,
+ * allocated from the arena.
+ */
+#define JSON_OBJECT_INDEX_MIN (16)	/* index members of an object with at least this many members on lookup */
+
+struct json_object_slot
+{
+    uint32_t hash;		/* hash of the decoded member name */
+    struct json *member;	/* JSON member, NULL ==> empty slot */
+};
+
+struct json_object_index
+{
+    size_t size;		/* number of slots, a power of 2 */
+    size_t count;		/* number of member names indexed */
+    intmax_t dups;		/* number of members with the same name as an earlier member */
+    struct json_object_slot slot[];	/* hash table of members */
+};
+
+
 /*
  * JSON object
  *
@@ -403,6 +504,7 @@ struct json_object
     struct json **set;		/* set of JSON members belonging to the object */
 
     struct dyn_array *s;	/* dynamic array managed storage for the JSON object */
+    struct json_object_index *index;	/* index of members by decoded name, NULL ==> no index yet */
 };
 
 
@@ -478,6 +580,70 @@ enum item_type {
     JTYPE_ELEMENTS,	    /* JSON item for building a JSON array */
 };
 
+/*
+ * struct json_arena - region from which an entire JSON parse tree is allocated
+ *
+ * When a JSON document is parsed with parse_json_arena() (and friends), every
+ * JSON parse tree node, every string (as_str and the decoded str) and every
+ * child node set of a JSON object, array or elements is carved out of a
+ * chain of large chunks instead of being calloc()ed one at a time.  The whole
+ * tree is then freed, by json_tree_free(), by freeing the chunks: there is no
+ * need to walk the tree.
+ *
+ * Storage obtained from an arena is never freed on its own.  A child node set
+ * that must grow is copied to a new set twice the size, leaving the old set
+ * in the arena until the arena is freed.
+ */
+#define JSON_ARENA_CHUNK (64*1024)	/* default size of an arena chunk in bytes */
+#define JSON_ARENA_ALIGN (sizeof(max_align_t))	/* alignment of storage returned by json_arena_alloc() */
+
+struct json_arena_chunk
+{
+    struct json_arena_chunk *next;	/* previously filled chunk or NULL */
+    size_t size;			/* size of data[] in bytes */
+    size_t used;			/* bytes of data[] already handed out */
+    max_align_t data[];			/* chunk storage */
+};
+
+struct json_arena
+{
+    struct json_arena_chunk *chunk;	/* chunk being filled, linked to those already filled */
+    size_t chunk_size;			/* default size of a new chunk in bytes */
+    uintmax_t allocs;			/* number of allocations made from the arena */
+    uintmax_t bytes;			/* number of bytes allocated from the arena */
+    uintmax_t chunks;			/* number of chunks in the arena */
+    struct json_input *input;		/* input buffer referenced by the tree (zero-copy parse), or NULL */
+};
+
+
+/*
+ * struct json_input - retained, reference counted JSON input buffer
+ *
+ * When a JSON document is parsed with parse_json_zero_copy() (and friends),
+ * the document is scanned in place, in the data of a struct json_input, and
+ * the as_str of the JSON strings and JSON numbers of the JSON parse tree
+ * point into that data instead of being copies.  The byte after each such
+ * token (the closing '"' of a JSON string or the delimiter after a JSON number)
+ * is overwritten with a NUL byte so that as_str remains a NUL terminated string.
+ *
+ * The arena of the JSON parse tree holds a reference to the input buffer, so
+ * the input buffer is freed along with the tree.  Code that wants to keep
+ * using as_str strings after the tree has been freed can take a reference of
+ * its own with json_input_ref() and release it with json_input_free().
+ *
+ * The tree loaded from a snapshot by json_snap_load() (see json_snap.h) holds
+ * the read-only mapping of the snapshot file as its input buffer: data is then
+ * unmapped instead of freed.
+ */
+struct json_input
+{
+    size_t refs;			/* number of references to the input buffer */
+    size_t len;				/* length of the JSON document in data */
+    char *data;				/* malloced JSON document followed by two NUL bytes */
+    bool mapped;			/* true ==> data is a mmap(2)ed snapshot of len bytes */
+};
+
+
 /*
  * struct json - item for the JSON parse tree
  *
@@ -501,6 +667,11 @@ struct json
      * JSON parse tree links
      */
     struct json *parent;	/* parent node in the JSON parse tree, or NULL if tree root or unlinked */
+
+    /*
+     * JSON parse tree storage
+     */
+    struct json_arena *arena;	/* arena holding this node, or NULL if node was calloc()ed */
 };
 
 
@@ -532,6 +703,8 @@ extern char *json_encode_str(char const *str, size_t *retlen, bool skip_quote);
 extern void chkbyte2asciistr(void);
 extern void jdecencchk(int entertainment);
 extern char *json_decode(char const *ptr, size_t len, bool quote, size_t *retlen);
+extern bool json_decode_len(char const *ptr, size_t len, size_t *mlen);
+extern size_t json_decode_cut(char const *ptr, size_t len);
 extern char *json_decode_str(char const *str, bool quote, size_t *retlen);
 extern struct json *json_parse_string(char const *string, size_t len);
 extern struct json *json_parse_bool(char const *string);
@@ -544,6 +717,7 @@ extern struct json *json_conv_number(char const *ptr, size_t len);
 extern struct json *json_conv_number_str(char const *str, size_t *retlen);
 extern struct json *json_conv_string(char const *ptr, size_t len, bool quote);
 extern struct json *json_conv_string_str(char const *str, size_t *retlen, bool quote);
+extern bool json_string_posix(struct json *node);
 extern struct json *json_conv_bool(char const *ptr, size_t len);
 extern struct json *json_conv_bool_str(char const *str, size_t *retlen);
 extern struct json *json_conv_null(char const *ptr, size_t len);
@@ -551,9 +725,30 @@ extern struct json *json_conv_null_str(char const *str, size_t *retlen);
 extern struct json *json_conv_member(struct json *name, struct json *value);
 extern struct json *json_create_object(void);
 extern struct json *json_object_add_member(struct json *node, struct json *member);
+extern uint32_t json_object_hash(char const *name, size_t len);
+extern struct json_object_index *json_object_index(struct json *node);
+extern struct json *json_object_get(struct json *node, char const *name, size_t len);
 extern struct json *json_create_elements(void);
 extern struct json *json_elements_add_value(struct json *node, struct json *value);
 extern struct json *json_create_array(void);
+extern bool json_number_to_conv(struct json_number const *item, struct json_number_conv *conv);
+extern struct json_number_conv *json_number_conv(struct json *node);
+extern bool json_number_intmax(struct json_number const *item, intmax_t *ret);
+extern bool json_number_uintmax(struct json_number const *item, uintmax_t *ret);
+extern bool json_number_int(struct json_number const *item, int *ret);
+extern bool json_number_uint(struct json_number const *item, unsigned int *ret);
+extern bool json_number_size(struct json_number const *item, size_t *ret);
+extern bool json_number_double(struct json_number const *item, double *ret);
+extern bool json_number_longdouble(struct json_number const *item, long double *ret);
+extern struct json_arena *json_arena_create(size_t chunk_size);
+extern void *json_arena_alloc(struct json_arena *arena, size_t size);
+extern void json_arena_free(struct json_arena *arena);
+extern struct json_arena *json_arena_set(struct json_arena *arena);
+extern struct json_input *json_input_create(char const *ptr, size_t len);
+extern struct json_input *json_input_adopt(char *data, size_t len);
+extern struct json_input *json_input_ref(struct json_input *input);
+extern void json_input_free(struct json_input *input);
+extern void json_input_terminate(struct json *tree);
 
 
 #endif /* INCLUDE_JSON_PARSE_H */
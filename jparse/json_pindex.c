@@ -0,0 +1,1065 @@
+/*
+ * json_pindex - persistent index of the paths of a JSON file
+ *
+ * "Because the fastest JSON to parse is the JSON you do not have to parse." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/*
+ * jparse - JSON parser
+ */
+#include "jparse.h"
+
+/*
+ * json_pindex - persistent index of the paths of a JSON file
+ */
+#include "json_pindex.h"
+
+
+/*
+ * static functions
+ */
+static bool pindex_begin(struct json_pindex_build *b, enum item_type type);
+static bool pindex_start_object(void *data);
+static bool pindex_start_array(void *data);
+static bool pindex_end(void *data);
+static bool pindex_member_name(void *data, char const *name, size_t len);
+static bool pindex_value(void *data, enum item_type type, char const *str, size_t len);
+static bool pindex_token(void *data, size_t offset, size_t len);
+static int pindex_cmp(const void *a, const void *b);
+static bool pindex_valid(char const *indexname, char const *map, size_t size);
+static bool pindex_hash(char const *filename, int fd, uint64_t *hash);
+static uint64_t pindex_fnv(uint64_t hash, void const *buf, size_t len);
+static char const *pindex_path(struct json_pindex const *pindex, uint64_t num, size_t *len);
+
+
+/*
+ * JSON event callbacks that form the entries of a path index
+ */
+static struct json_event_cb const pindex_cb = {
+    pindex_start_object,
+    pindex_end,
+    pindex_start_array,
+    pindex_end,
+    pindex_member_name,
+    pindex_value,
+    pindex_token,
+};
+
+
+/*
+ * json_pindex_path_add - add a name to a JSON Pointer
+ *
+ * A / is added to the path, then the name with each ~ written as ~0 and each /
+ * written as ~1 (see RFC 6901).
+ *
+ * given:
+ *	path	    dynamic array of char of the JSON Pointer, not NUL terminated
+ *	name	    decoded JSON member name or decimal JSON array index
+ *	len	    length of name
+ *
+ * NOTE: This function does not return on NULL arg.
+ */
+void
+json_pindex_path_add(struct dyn_array *path, char const *name, size_t len)
+{
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (path == NULL || name == NULL) {
+	err(10, __func__, "path and/or name is NULL");
+	not_reached();
+    }
+
+    (void) dyn_array_append_value(path, "/");
+    for (i = 0; i < len; ++i) {
+	switch (name[i]) {
+	case '~':
+	    (void) dyn_array_append_set(path, "~0", 2);
+	    break;
+	case '/':
+	    (void) dyn_array_append_set(path, "~1", 2);
+	    break;
+	default:
+	    (void) dyn_array_append_value(path, (void *)&name[i]);
+	    break;
+	}
+    }
+}
+
+
+/*
+ * pindex_begin - form the entry of a JSON value that starts with the current token
+ *
+ * given:
+ *	b	    pointer to the state of json_pindex_write()
+ *	type	    JSON type of the value
+ *
+ * return:
+ *	true
+ */
+static bool
+pindex_begin(struct json_pindex_build *b, enum item_type type)
+{
+    struct json_pindex_entry entry;	/* entry of the value */
+    struct json_pindex_frame frame;	/* frame of a JSON object or array */
+    struct json_pindex_frame *parent = NULL;	/* frame of the JSON object or array of the value */
+    char index[sizeof("-9223372036854775808")];	/* decimal JSON array index */
+    int ret = 0;			/* snprintf() return */
+
+    /*
+     * the path of the value is the path of its parent and its name or index
+     */
+    if (dyn_array_tell(b->frames) > 0) {
+	parent = dyn_array_addr(b->frames, struct json_pindex_frame, dyn_array_tell(b->frames) - 1);
+	(void) dyn_array_seek(b->path, (off_t)parent->path_len, SEEK_SET);
+	if (parent->in_object) {
+	    json_pindex_path_add(b->path, dyn_array_first(b->name, char), (size_t)dyn_array_tell(b->name));
+	} else {
+	    ret = snprintf(index, sizeof(index), "%jd", parent->count);
+	    if (ret <= 0 || (size_t)ret >= sizeof(index)) {
+		err(11, __func__, "snprintf of JSON array index %jd failed", parent->count);
+		not_reached();
+	    }
+	    json_pindex_path_add(b->path, index, (size_t)ret);
+	}
+	++parent->count;
+    } else {
+	(void) dyn_array_seek(b->path, 0, SEEK_SET);
+    }
+
+    /*
+     * form the entry, with the path in the pool
+     */
+    memset(&entry, 0, sizeof(entry));
+    entry.path = (uint64_t)dyn_array_tell(b->pool);
+    entry.path_len = (uint64_t)dyn_array_tell(b->path);
+    entry.offset = (uint64_t)b->offset;
+    entry.len = (uint64_t)b->len;
+    entry.type = (uint32_t)type;
+    if (dyn_array_tell(b->path) > 0) {
+	(void) dyn_array_append_set(b->pool, dyn_array_first(b->path, char), dyn_array_tell(b->path));
+    }
+    (void) dyn_array_append_value(b->pool, "");
+
+    /*
+     * the length of a JSON object or array is known at its end
+     */
+    if (type == JTYPE_OBJECT || type == JTYPE_ARRAY) {
+	memset(&frame, 0, sizeof(frame));
+	frame.path_len = (size_t)dyn_array_tell(b->path);
+	frame.in_object = (type == JTYPE_OBJECT);
+	frame.count = 0;
+	frame.entry = dyn_array_tell(b->entries);
+	(void) dyn_array_append_value(b->frames, &frame);
+    }
+    (void) dyn_array_append_value(b->entries, &entry);
+    return true;
+}
+
+
+/*
+ * pindex_start_object - JSON event callback for {
+ *
+ * given:
+ *	data	    pointer to the state of json_pindex_write()
+ *
+ * return:
+ *	true
+ */
+static bool
+pindex_start_object(void *data)
+{
+    return pindex_begin((struct json_pindex_build *)data, JTYPE_OBJECT);
+}
+
+
+/*
+ * pindex_start_array - JSON event callback for [
+ *
+ * given:
+ *	data	    pointer to the state of json_pindex_write()
+ *
+ * return:
+ *	true
+ */
+static bool
+pindex_start_array(void *data)
+{
+    return pindex_begin((struct json_pindex_build *)data, JTYPE_ARRAY);
+}
+
+
+/*
+ * pindex_end - JSON event callback for } or ]
+ *
+ * The JSON text of the JSON object or array ends with the current token.
+ *
+ * given:
+ *	data	    pointer to the state of json_pindex_write()
+ *
+ * return:
+ *	true ==> the length of the JSON object or array was set,
+ *	false ==> no JSON object or array was begun
+ */
+static bool
+pindex_end(void *data)
+{
+    struct json_pindex_build *b = (struct json_pindex_build *)data;	/* state of json_pindex_write() */
+    struct json_pindex_frame frame;		/* frame of the JSON object or array */
+    struct json_pindex_entry *entry = NULL;	/* entry of the JSON object or array */
+
+    if (dyn_array_tell(b->frames) <= 0) {
+	return false;
+    }
+    (void) dyn_array_pop(b->frames, &frame);
+    entry = dyn_array_addr(b->entries, struct json_pindex_entry, frame.entry);
+    entry->len = (uint64_t)(b->offset + b->len) - entry->offset;
+    return true;
+}
+
+
+/*
+ * pindex_member_name - JSON event callback for the name of a JSON member
+ *
+ * given:
+ *	data	    pointer to the state of json_pindex_write()
+ *	name	    decoded JSON member name
+ *	len	    length of name
+ *
+ * return:
+ *	true
+ */
+static bool
+pindex_member_name(void *data, char const *name, size_t len)
+{
+    struct json_pindex_build *b = (struct json_pindex_build *)data;	/* state of json_pindex_write() */
+
+    (void) dyn_array_seek(b->name, 0, SEEK_SET);
+    if (len > 0) {
+	(void) dyn_array_append_set(b->name, (void *)name, (intmax_t)len);
+    }
+    return true;
+}
+
+
+/*
+ * pindex_value - JSON event callback for a JSON string, number, boolean or null
+ *
+ * given:
+ *	data	    pointer to the state of json_pindex_write()
+ *	type	    JSON type of the value
+ *	str	    decoded JSON string, or JSON text (not used)
+ *	len	    length of str (not used)
+ *
+ * return:
+ *	true
+ */
+static bool
+pindex_value(void *data, enum item_type type, char const *str, size_t len)
+{
+    UNUSED_ARG(str);
+    UNUSED_ARG(len);
+    return pindex_begin((struct json_pindex_build *)data, type);
+}
+
+
+/*
+ * pindex_token - JSON event callback for the location of each token
+ *
+ * given:
+ *	data	    pointer to the state of json_pindex_write()
+ *	offset	    byte offset of the token in the JSON file
+ *	len	    length of the token
+ *
+ * return:
+ *	true
+ */
+static bool
+pindex_token(void *data, size_t offset, size_t len)
+{
+    struct json_pindex_build *b = (struct json_pindex_build *)data;	/* state of json_pindex_write() */
+
+    b->offset = offset;
+    b->len = len;
+    return true;
+}
+
+
+/*
+ * pindex_cmp - compare two path index entries by path, then by offset
+ *
+ * given:
+ *	a	    pointer to a struct json_pindex_sort
+ *	b	    pointer to a struct json_pindex_sort
+ *
+ * return:
+ *	<0, 0 or >0 as a is before, the same as or after b
+ */
+static int
+pindex_cmp(const void *a, const void *b)
+{
+    struct json_pindex_sort const *sa = (struct json_pindex_sort const *)a;	/* first entry */
+    struct json_pindex_sort const *sb = (struct json_pindex_sort const *)b;	/* second entry */
+    struct json_pindex_entry const *ea = sa->entry;	/* first entry */
+    struct json_pindex_entry const *eb = sb->entry;	/* second entry */
+    int ret = 0;					/* memcmp() return */
+
+    ret = memcmp(sa->path, sb->path, (size_t)(ea->path_len < eb->path_len ? ea->path_len : eb->path_len));
+    if (ret != 0) {
+	return ret;
+    }
+    if (ea->path_len != eb->path_len) {
+	return ea->path_len < eb->path_len ? -1 : 1;
+    }
+    if (ea->offset != eb->offset) {
+	return ea->offset < eb->offset ? -1 : 1;
+    }
+    return 0;
+}
+
+
+/*
+ * json_pindex_write - form the path index of a JSON file
+ *
+ * The JSON file is scanned once into JSON events (see parse_json_file_events()),
+ * without forming a JSON parse tree, and the path index of every JSON value is
+ * written to a temporary file that is then renamed to indexname (see
+ * tmp_file_open()), so that a process using the path index at the same time
+ * never sees a partial one.
+ *
+ * given:
+ *	filename    JSON file to index (not stdin)
+ *	indexname   path index file to write
+ *
+ * return:
+ *	JSON_PINDEX_OK ==> path index written,
+ *	JSON_PINDEX_INVALID ==> JSON file is not valid JSON or has no JSON value,
+ *	JSON_PINDEX_CHANGED ==> JSON file changed while it was indexed,
+ *	JSON_PINDEX_ERROR ==> JSON file could not be read or the path index
+ *			      could not be written
+ *
+ * NOTE: Only JSON_PINDEX_INVALID means that the JSON file is not valid JSON:
+ *	 a JSON file that changed, or whose path index could not be written,
+ *	 may still be parsed without a path index.
+ *
+ * NOTE: This function does not return on NULL arg.
+ */
+enum json_pindex_status
+json_pindex_write(char const *filename, char const *indexname)
+{
+    struct json_pindex_build b;		/* state while the JSON events arrive */
+    struct json_pindex_hdr hdr;		/* path index header */
+    struct json_pindex_sort sort;	/* entry to sort */
+    struct dyn_array *sorted = NULL;	/* struct json_pindex_sort of each entry, sorted by path */
+    struct stat before;			/* JSON file status before it is indexed */
+    struct stat after;			/* JSON file status after it is indexed */
+    FILE *stream = NULL;		/* open temporary path index file */
+    char *tmpname = NULL;		/* name of the temporary path index file */
+    uint64_t hash = 0;			/* FNV-1a hash of the JSON file, if it was just written */
+    time_t formed = 0;			/* time the path index was formed */
+    int fd = -1;			/* JSON file open for hashing */
+    enum json_pindex_status ret = JSON_PINDEX_OK;	/* return value */
+    bool ok = true;			/* true ==> path index written in full so far */
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (filename == NULL || indexname == NULL) {
+	err(12, __func__, "filename and/or indexname is NULL");
+	not_reached();
+    }
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (stat(filename, &before) != 0) {
+	warnp(__func__, "cannot stat JSON file: %s", filename);
+	return JSON_PINDEX_ERROR;
+    }
+    if (!S_ISREG(before.st_mode)) {
+	warn(__func__, "JSON file is not a regular file: %s", filename);
+	return JSON_PINDEX_ERROR;
+    }
+
+    /*
+     * hash a JSON file that changed this second, before it is indexed, so that
+     * json_pindex_open() finds it stale if it changes again this second
+     */
+    if (before.st_ctime >= time(NULL)) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) {
+	    warnp(__func__, "cannot open JSON file: %s", filename);
+	    return JSON_PINDEX_ERROR;
+	}
+	ok = pindex_hash(filename, fd, &hash);
+	(void) close(fd);
+	if (!ok) {
+	    return JSON_PINDEX_ERROR;
+	}
+    }
+
+    /*
+     * form the entries from the JSON events of the JSON file
+     */
+    memset(&b, 0, sizeof(b));
+    b.entries = dyn_array_create(sizeof(struct json_pindex_entry), JSON_PINDEX_CHUNK, JSON_PINDEX_CHUNK, true);
+    b.pool = dyn_array_create(sizeof(char), JSON_PINDEX_CHUNK, JSON_PINDEX_CHUNK, false);
+    b.frames = dyn_array_create(sizeof(struct json_pindex_frame), JSON_PINDEX_CHUNK, JSON_PINDEX_CHUNK, false);
+    b.path = dyn_array_create(sizeof(char), JSON_PINDEX_CHUNK, JSON_PINDEX_CHUNK, false);
+    b.name = dyn_array_create(sizeof(char), JSON_PINDEX_CHUNK, JSON_PINDEX_CHUNK, false);
+    if (!parse_json_file_events(filename, &pindex_cb, &b)) {
+	warn(__func__, "JSON is not valid, not indexed: %s", filename);
+	ret = JSON_PINDEX_INVALID;
+    } else if (dyn_array_tell(b.entries) <= 0) {
+	warn(__func__, "JSON file has no JSON value, not indexed: %s", filename);
+	ret = JSON_PINDEX_INVALID;
+    } else {
+	errno = 0;		/* pre-clear errno for warnp() */
+	if (stat(filename, &after) != 0) {
+	    warnp(__func__, "cannot stat JSON file: %s", filename);
+	    ret = JSON_PINDEX_ERROR;
+	} else if (after.st_size != before.st_size || after.st_mtime != before.st_mtime ||
+		   after.st_ctime != before.st_ctime || after.st_ino != before.st_ino) {
+	    warn(__func__, "JSON file changed while it was indexed: %s", filename);
+	    ret = JSON_PINDEX_CHANGED;
+	}
+	formed = time(NULL);
+    }
+
+    /*
+     * sort the entries by path and write the path index
+     */
+    if (ret == JSON_PINDEX_OK) {
+	sorted = dyn_array_create(sizeof(struct json_pindex_sort), JSON_PINDEX_CHUNK, dyn_array_tell(b.entries), false);
+	for (i = 0; i < dyn_array_tell(b.entries); ++i) {
+	    sort.entry = dyn_array_addr(b.entries, struct json_pindex_entry, i);
+	    sort.path = dyn_array_first(b.pool, char) + sort.entry->path;
+	    (void) dyn_array_append_value(sorted, &sort);
+	}
+	dyn_array_qsort(sorted, pindex_cmp);
+
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, JSON_PINDEX_MAGIC, JSON_PINDEX_MAGIC_LEN);
+	hdr.version = JSON_PINDEX_VERSION;
+	hdr.endian = JSON_PINDEX_ENDIAN;
+	hdr.entry_size = (uint32_t)sizeof(struct json_pindex_entry);
+	hdr.json_size = (uint64_t)before.st_size;
+	hdr.json_mtime = (int64_t)before.st_mtime;
+	hdr.json_ctime = (int64_t)before.st_ctime;
+	hdr.json_ino = (uint64_t)before.st_ino;
+	hdr.formed = (int64_t)formed;
+	if (hdr.json_ctime >= hdr.formed) {
+	    hdr.json_hash = hash;
+	}
+	hdr.entries = (uint64_t)dyn_array_tell(b.entries);
+	hdr.entry_off = (uint64_t)sizeof(hdr);
+	hdr.pool_len = (uint64_t)dyn_array_tell(b.pool);
+	hdr.pool_off = hdr.entry_off + hdr.entries * sizeof(struct json_pindex_entry);
+	hdr.file_len = hdr.pool_off + hdr.pool_len;
+	hdr.checksum = JSON_PINDEX_FNV_BASIS;
+	for (i = 0; i < dyn_array_tell(sorted); ++i) {
+	    hdr.checksum = pindex_fnv(hdr.checksum, dyn_array_value(sorted, struct json_pindex_sort, i).entry,
+				      sizeof(struct json_pindex_entry));
+	}
+	hdr.checksum = pindex_fnv(hdr.checksum, dyn_array_first(b.pool, char), (size_t)hdr.pool_len);
+	json_dbg(JSON_DBG_MED, __func__, "writing path index %s: %ju entries, %ju pool bytes, %ju bytes",
+			       indexname, (uintmax_t)hdr.entries, (uintmax_t)hdr.pool_len, (uintmax_t)hdr.file_len);
+
+	/*
+	 * write a temporary file that is renamed over the path index, as
+	 * another process may have the path index mapped
+	 */
+	stream = tmp_file_open(indexname, &tmpname);
+	if (stream == NULL) {
+	    ok = false;
+	} else {
+	    errno = 0;		/* pre-clear errno for warnp() */
+	    if (fwrite(&hdr, sizeof(hdr), 1, stream) != 1) {
+		ok = false;
+	    }
+	    for (i = 0; ok && i < dyn_array_tell(sorted); ++i) {
+		if (fwrite(dyn_array_value(sorted, struct json_pindex_sort, i).entry, sizeof(struct json_pindex_entry), 1,
+			   stream) != 1) {
+		    ok = false;
+		}
+	    }
+	    if (ok && fwrite(dyn_array_first(b.pool, char), 1, (size_t)hdr.pool_len, stream) != (size_t)hdr.pool_len) {
+		ok = false;
+	    }
+	    if (!ok) {
+		warnp(__func__, "error writing path index: %s", tmpname);
+	    }
+	    ok = tmp_file_close(stream, tmpname, indexname, ok);
+	    stream = NULL;
+	    tmpname = NULL;
+	}
+	if (!ok) {
+	    ret = JSON_PINDEX_ERROR;
+	}
+    }
+
+    /*
+     * free storage
+     */
+    dyn_array_free(b.entries);
+    dyn_array_free(b.pool);
+    dyn_array_free(b.frames);
+    dyn_array_free(b.path);
+    dyn_array_free(b.name);
+    if (sorted != NULL) {
+	dyn_array_free(sorted);
+    }
+    return ret;
+}
+
+
+/*
+ * pindex_valid - determine if a mapped path index is valid
+ *
+ * Besides the header, the checksum of the entries and the path pool is
+ * checked, and so is every entry: its path must be a NUL terminated string of
+ * the path pool, its JSON text must be inside the JSON file that was indexed,
+ * it must be of a JSON value type and it must not be before the entry before
+ * it, so that json_pindex_find() and json_pindex_parse() can trust it.
+ *
+ * given:
+ *	indexname   path index file for warning messages
+ *	map	    mapped path index file
+ *	size	    size of the path index file
+ *
+ * return:
+ *	true ==> path index is valid, false ==> path index is not valid
+ *
+ * NOTE: This function warns about the first problem found.
+ */
+static bool
+pindex_valid(char const *indexname, char const *map, size_t size)
+{
+    struct json_pindex_hdr const *hdr = NULL;	/* path index header */
+    struct json_pindex_entry const *entry = NULL;	/* entries */
+    struct json_pindex_sort prev;	/* entry before the entry being checked */
+    struct json_pindex_sort cur;	/* entry being checked */
+    char const *pool = NULL;		/* path pool */
+    uint64_t i;
+
+    if (size < sizeof(*hdr)) {
+	warn(__func__, "path index is too short: %s", indexname);
+	return false;
+    }
+    hdr = (struct json_pindex_hdr const *)map;
+    if (memcmp(hdr->magic, JSON_PINDEX_MAGIC, JSON_PINDEX_MAGIC_LEN) != 0) {
+	warn(__func__, "not a path index: %s", indexname);
+	return false;
+    }
+    if (hdr->version != JSON_PINDEX_VERSION || hdr->endian != JSON_PINDEX_ENDIAN ||
+	hdr->entry_size != sizeof(struct json_pindex_entry)) {
+	warn(__func__, "path index was written by another version or machine: %s", indexname);
+	return false;
+    }
+    if (hdr->file_len != size || hdr->entry_off != sizeof(*hdr) || hdr->entries == 0 ||
+	hdr->entries > (size - sizeof(*hdr)) / sizeof(struct json_pindex_entry) ||
+	hdr->pool_off != hdr->entry_off + hdr->entries * sizeof(struct json_pindex_entry) ||
+	hdr->pool_len != size - hdr->pool_off) {
+	warn(__func__, "path index is corrupt: %s", indexname);
+	return false;
+    }
+    if (pindex_fnv(JSON_PINDEX_FNV_BASIS, map + hdr->entry_off, size - (size_t)hdr->entry_off) != hdr->checksum) {
+	warn(__func__, "path index checksum does not match: %s", indexname);
+	return false;
+    }
+
+    /*
+     * check every entry
+     */
+    entry = (struct json_pindex_entry const *)(map + hdr->entry_off);
+    pool = map + hdr->pool_off;
+    memset(&prev, 0, sizeof(prev));
+    for (i = 0; i < hdr->entries; ++i) {
+	cur.entry = &entry[i];
+	if (cur.entry->path >= hdr->pool_len || cur.entry->path_len >= hdr->pool_len - cur.entry->path ||
+	    pool[cur.entry->path + cur.entry->path_len] != '\0' ||
+	    cur.entry->len == 0 || cur.entry->offset >= hdr->json_size || cur.entry->len > hdr->json_size - cur.entry->offset ||
+	    (cur.entry->type != JTYPE_NUMBER && cur.entry->type != JTYPE_STRING && cur.entry->type != JTYPE_BOOL &&
+	     cur.entry->type != JTYPE_NULL && cur.entry->type != JTYPE_OBJECT && cur.entry->type != JTYPE_ARRAY) ||
+	    cur.entry->unused != 0) {
+	    warn(__func__, "entry %ju of path index is corrupt: %s", (uintmax_t)i, indexname);
+	    return false;
+	}
+	cur.path = pool + cur.entry->path;
+	if (prev.entry != NULL && pindex_cmp(&prev, &cur) > 0) {
+	    warn(__func__, "entry %ju of path index is out of order: %s", (uintmax_t)i, indexname);
+	    return false;
+	}
+	prev = cur;
+    }
+    return true;
+}
+
+
+/*
+ * pindex_hash - form the 64 bit FNV-1a hash of a JSON file
+ *
+ * given:
+ *	filename    JSON file for warning messages
+ *	fd	    JSON file open for reading
+ *	hash	    pointer to set to the hash
+ *
+ * return:
+ *	true ==> hash set, false ==> JSON file could not be read
+ */
+static bool
+pindex_hash(char const *filename, int fd, uint64_t *hash)
+{
+    char buf[BUFSIZ];			/* bytes of the JSON file */
+    uint64_t h = JSON_PINDEX_FNV_BASIS;	/* hash so far */
+    off_t offset = 0;			/* offset of buf in the JSON file */
+    ssize_t ret;			/* bytes read */
+
+    for (;;) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	ret = pread(fd, buf, sizeof(buf), offset);
+	if (ret < 0 && errno == EINTR) {
+	    continue;
+	} else if (ret < 0) {
+	    warnp(__func__, "cannot read offset %jd of: %s", (intmax_t)offset, filename);
+	    return false;
+	} else if (ret == 0) {
+	    break;
+	}
+	h = pindex_fnv(h, buf, (size_t)ret);
+	offset += (off_t)ret;
+    }
+    *hash = h;
+    return true;
+}
+
+
+/*
+ * pindex_fnv - add bytes to a 64 bit FNV-1a hash
+ *
+ * given:
+ *	hash	    hash so far, JSON_PINDEX_FNV_BASIS ==> no bytes so far
+ *	buf	    bytes to add
+ *	len	    number of bytes to add
+ *
+ * return:
+ *	hash of the bytes so far and the bytes of buf
+ */
+static uint64_t
+pindex_fnv(uint64_t hash, void const *buf, size_t len)
+{
+    unsigned char const *p = (unsigned char const *)buf;	/* byte to add */
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+	hash ^= (uint64_t)p[i];
+	hash *= JSON_PINDEX_FNV_PRIME;
+    }
+    return hash;
+}
+
+
+/*
+ * json_pindex_open - open the path index of a JSON file
+ *
+ * given:
+ *	filename    JSON file that was indexed
+ *	indexname   path index file written by json_pindex_write()
+ *	stale	    non-NULL pointer to set to true if the path index must be
+ *		    formed again, because it does not exist, is not valid, or
+ *		    the JSON file changed (see the path index comment in
+ *		    json_pindex.h)
+ *
+ * return:
+ *	pointer to the open path index, close it with json_pindex_close(),
+ *	NULL ==> the path index cannot be used (see stale)
+ *
+ * NOTE: This function does not return on NULL arg or allocation error.
+ */
+struct json_pindex *
+json_pindex_open(char const *filename, char const *indexname, bool *stale)
+{
+    struct json_pindex *pindex = NULL;	/* open path index */
+    struct json_pindex_hdr const *hdr = NULL;	/* path index header */
+    struct stat sb;			/* file status */
+    char *map = NULL;			/* mapped path index file */
+    size_t size = 0;			/* size of the path index file */
+    uint64_t hash = 0;			/* FNV-1a hash of the JSON file */
+    int fd = -1;			/* open path index file */
+    int json_fd = -1;			/* open JSON file */
+
+    /*
+     * firewall
+     */
+    if (filename == NULL || indexname == NULL || stale == NULL) {
+	err(13, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    *stale = false;
+
+    /*
+     * open the JSON file, so that the file checked is the file read
+     */
+    errno = 0;			/* pre-clear errno for warnp() */
+    json_fd = open(filename, O_RDONLY);
+    if (json_fd < 0) {
+	warnp(__func__, "cannot open JSON file: %s", filename);
+	return NULL;
+    }
+
+    /*
+     * map the path index
+     */
+    errno = 0;			/* pre-clear errno for warnp() */
+    fd = open(indexname, O_RDONLY);
+    if (fd < 0) {
+	if (errno != ENOENT) {
+	    warnp(__func__, "cannot open path index: %s", indexname);
+	}
+	(void) close(json_fd);
+	*stale = true;
+	return NULL;
+    }
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (fstat(fd, &sb) != 0) {
+	warnp(__func__, "cannot stat path index: %s", indexname);
+	(void) close(fd);
+	(void) close(json_fd);
+	return NULL;
+    }
+    if (!S_ISREG(sb.st_mode) || sb.st_size <= 0 || (uintmax_t)sb.st_size > (uintmax_t)SIZE_MAX) {
+	warn(__func__, "path index is not a regular file of a usable size: %s", indexname);
+	(void) close(fd);
+	(void) close(json_fd);
+	*stale = true;
+	return NULL;
+    }
+    size = (size_t)sb.st_size;
+    errno = 0;			/* pre-clear errno for warnp() */
+    map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+	warnp(__func__, "cannot mmap %zu bytes of path index: %s", size, indexname);
+	(void) close(fd);
+	(void) close(json_fd);
+	return NULL;
+    }
+    (void) close(fd);
+    if (!pindex_valid(indexname, map, size)) {
+	(void) munmap(map, size);
+	(void) close(json_fd);
+	*stale = true;
+	return NULL;
+    }
+    hdr = (struct json_pindex_hdr const *)map;
+
+    /*
+     * the path index is stale if the JSON file changed since it was indexed
+     */
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (fstat(json_fd, &sb) != 0) {
+	warnp(__func__, "cannot stat JSON file: %s", filename);
+	(void) munmap(map, size);
+	(void) close(json_fd);
+	return NULL;
+    }
+    if ((uint64_t)sb.st_size != hdr->json_size || (int64_t)sb.st_mtime != hdr->json_mtime ||
+	(int64_t)sb.st_ctime != hdr->json_ctime || (uint64_t)sb.st_ino != hdr->json_ino) {
+	json_dbg(JSON_DBG_MED, __func__, "path index %s is stale: %s changed", indexname, filename);
+	(void) munmap(map, size);
+	(void) close(json_fd);
+	*stale = true;
+	return NULL;
+    }
+
+    /*
+     * a path index formed in the second that the JSON file last changed is
+     * stale unless the JSON file still has the hash it had when indexed
+     */
+    if (hdr->json_ctime >= hdr->formed) {
+	if (!pindex_hash(filename, json_fd, &hash) || hash != hdr->json_hash) {
+	    json_dbg(JSON_DBG_MED, __func__, "path index %s is stale: %s hash changed", indexname, filename);
+	    (void) munmap(map, size);
+	    (void) close(json_fd);
+	    *stale = true;
+	    return NULL;
+	}
+    }
+
+    /*
+     * form the open path index
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    pindex = calloc(1, sizeof(*pindex));
+    if (pindex == NULL) {
+	errp(14, __func__, "calloc error allocating %zu bytes", sizeof(*pindex));
+	not_reached();
+    }
+    errno = 0;			/* pre-clear errno for errp() */
+    pindex->filename = strdup(filename);
+    if (pindex->filename == NULL) {
+	errp(15, __func__, "strdup of filename failed");
+	not_reached();
+    }
+    pindex->map = map;
+    pindex->size = size;
+    pindex->hdr = hdr;
+    pindex->entry = (struct json_pindex_entry const *)(map + hdr->entry_off);
+    pindex->pool = map + hdr->pool_off;
+    pindex->fd = json_fd;
+    json_dbg(JSON_DBG_MED, __func__, "opened path index %s: %ju entries", indexname, (uintmax_t)hdr->entries);
+    return pindex;
+}
+
+
+/*
+ * pindex_path - path of an entry of an open path index
+ *
+ * given:
+ *	pindex	    pointer to an open path index
+ *	num	    entry number
+ *	len	    pointer to set to the length of the path
+ *
+ * return:
+ *	path of the entry, NULL ==> the entry is not valid
+ */
+static char const *
+pindex_path(struct json_pindex const *pindex, uint64_t num, size_t *len)
+{
+    struct json_pindex_entry const *entry = &pindex->entry[num];	/* entry */
+
+    if (entry->path >= pindex->hdr->pool_len || entry->path_len >= pindex->hdr->pool_len - entry->path) {
+	return NULL;
+    }
+    *len = (size_t)entry->path_len;
+    return pindex->pool + entry->path;
+}
+
+
+/*
+ * json_pindex_find - find the entries of a JSON Pointer in an open path index
+ *
+ * given:
+ *	pindex	    pointer to an open path index
+ *	path	    JSON Pointer (see json_pindex_path_add()), "" ==> the JSON document
+ *	len	    length of path
+ *	first	    pointer to set to the number of the first entry with the path
+ *	count	    pointer to set to the number of entries with the path, 0 ==> none
+ *
+ * return:
+ *	true ==> *first and *count are set,
+ *	false ==> an entry of the path index is not valid
+ *
+ * NOTE: This function does not return on NULL arg.
+ */
+bool
+json_pindex_find(struct json_pindex const *pindex, char const *path, size_t len, uint64_t *first, uint64_t *count)
+{
+    char const *p = NULL;	/* path of an entry */
+    size_t plen = 0;		/* length of p */
+    uint64_t lo = 0;		/* first entry that may have the path */
+    uint64_t hi = 0;		/* entry after the last entry that may have the path */
+    uint64_t mid = 0;		/* entry being compared */
+    int ret = 0;		/* comparison of p with path */
+
+    /*
+     * firewall
+     */
+    if (pindex == NULL || path == NULL || first == NULL || count == NULL) {
+	err(16, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    *first = 0;
+    *count = 0;
+
+    /*
+     * find the first entry that is not before the path
+     */
+    lo = 0;
+    hi = pindex->hdr->entries;
+    while (lo < hi) {
+	mid = lo + (hi - lo) / 2;
+	p = pindex_path(pindex, mid, &plen);
+	if (p == NULL) {
+	    warn(__func__, "entry %ju of the path index of %s is not valid", (uintmax_t)mid, pindex->filename);
+	    return false;
+	}
+	ret = memcmp(p, path, plen < len ? plen : len);
+	if (ret < 0 || (ret == 0 && plen < len)) {
+	    lo = mid + 1;
+	} else {
+	    hi = mid;
+	}
+    }
+
+    /*
+     * count the entries with the path
+     */
+    *first = lo;
+    for (mid = lo; mid < pindex->hdr->entries; ++mid) {
+	p = pindex_path(pindex, mid, &plen);
+	if (p == NULL || plen != len || memcmp(p, path, len) != 0) {
+	    break;
+	}
+	++*count;
+    }
+    return true;
+}
+
+
+/*
+ * json_pindex_parse - parse the JSON text of an entry of an open path index
+ *
+ * Only the JSON text of the value of the entry is read from the JSON file, and
+ * parsed with parse_json().
+ *
+ * given:
+ *	pindex	    pointer to an open path index
+ *	num	    entry number, as found by json_pindex_find()
+ *	is_valid    non-NULL pointer to set to true if the JSON text is valid JSON
+ *
+ * return:
+ *	JSON parse tree of the value, free it with json_tree_free() and free(3),
+ *	NULL ==> the entry is not valid or the JSON text cannot be read
+ *
+ * NOTE: This function does not return on NULL arg or malloc error.
+ */
+struct json *
+json_pindex_parse(struct json_pindex const *pindex, uint64_t num, bool *is_valid)
+{
+    struct json_pindex_entry const *entry = NULL;	/* entry */
+    struct json *tree = NULL;	/* JSON parse tree of the value */
+    char *buf = NULL;		/* JSON text of the value */
+    size_t len = 0;		/* length of the JSON text */
+    size_t done = 0;		/* bytes of the JSON text read so far */
+    ssize_t ret = 0;		/* pread() return */
+
+    /*
+     * firewall
+     */
+    if (pindex == NULL || is_valid == NULL) {
+	err(17, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    *is_valid = false;
+    if (num >= pindex->hdr->entries) {
+	warn(__func__, "no entry %ju in the path index of %s", (uintmax_t)num, pindex->filename);
+	return NULL;
+    }
+    entry = &pindex->entry[num];
+    if (entry->len == 0 || entry->offset >= pindex->hdr->json_size || entry->len > pindex->hdr->json_size - entry->offset ||
+	(uintmax_t)entry->len >= (uintmax_t)SIZE_MAX) {
+	warn(__func__, "entry %ju of the path index of %s is not valid", (uintmax_t)num, pindex->filename);
+	return NULL;
+    }
+    len = (size_t)entry->len;
+
+    /*
+     * read the JSON text of the value
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    buf = malloc(len + 1);
+    if (buf == NULL) {
+	errp(18, __func__, "malloc of %zu bytes failed", len + 1);
+	not_reached();
+    }
+    while (done < len) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	ret = pread(pindex->fd, buf + done, len - done, (off_t)(entry->offset + done));
+	if (ret <= 0) {
+	    if (ret < 0 && errno == EINTR) {
+		continue;
+	    }
+	    warnp(__func__, "cannot read %zu bytes at offset %ju of: %s", len, (uintmax_t)entry->offset, pindex->filename);
+	    free(buf);
+	    return NULL;
+	}
+	done += (size_t)ret;
+    }
+    buf[len] = '\0';
+
+    /*
+     * parse only the JSON text of the value
+     */
+    tree = parse_json(buf, len, pindex->filename, is_valid);
+    free(buf);
+    return tree;
+}
+
+
+/*
+ * json_pindex_close - close an open path index
+ *
+ * given:
+ *	pindex	    pointer to the path index opened by json_pindex_open(), or NULL
+ */
+void
+json_pindex_close(struct json_pindex *pindex)
+{
+    if (pindex == NULL) {
+	return;
+    }
+    if (pindex->map != NULL) {
+	(void) munmap((void *)pindex->map, pindex->size);
+	pindex->map = NULL;
+    }
+    if (pindex->fd >= 0) {
+	(void) close(pindex->fd);
+	pindex->fd = -1;
+    }
+    if (pindex->filename != NULL) {
+	free(pindex->filename);
+	pindex->filename = NULL;
+    }
+    free(pindex);
+}
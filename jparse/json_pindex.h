@@ -0,0 +1,225 @@
+/*
+ * json_pindex - persistent index of the paths of a JSON file
+ *
+ * "Because the fastest JSON to parse is the JSON you do not have to parse." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+#if !defined(INCLUDE_JSON_PINDEX_H)
+#    define  INCLUDE_JSON_PINDEX_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#else
+  #include <c_bool.h>
+  #include <c_compat.h>
+  #include <dbg.h>
+#endif
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "util.h"
+
+
+/*
+ * persistent index of the paths of a JSON file
+ *
+ * A path index is a file, kept beside a JSON file, that json_pindex_write()
+ * forms from one pass of JSON events over the JSON file.  It has an entry for
+ * every JSON value of the file: the JSON Pointer (RFC 6901) of the value, its
+ * JSON type, and the byte offset and length of its JSON text in the file.  A
+ * JSON Pointer is "" for the whole JSON document, and /name or /index for a
+ * JSON member or JSON array element of the value before it, where a ~ in a
+ * name is written as ~0 and a / as ~1.
+ *
+ * A path index file is made of:
+ *
+ *	struct json_pindex_hdr	    the header
+ *	struct json_pindex_entry[]  an entry for every JSON value, sorted by path
+ *	char[]			    pool of the NUL terminated paths
+ *
+ * json_pindex_open() maps a path index with mmap(2), and json_pindex_find()
+ * finds the entries of a path with a binary search, so that only the JSON text
+ * of the values found needs to be read and parsed, by json_pindex_parse(),
+ * instead of the whole JSON file.  Entries with the same path (the members of
+ * a JSON object with the same name) are in the order of the JSON file.
+ *
+ * The header records the size, modification time, status change time and
+ * inode number of the JSON file that was indexed: json_pindex_open() reports a
+ * path index whose JSON file no longer has them as stale, to be formed again.
+ * As writing a file sets its status change time to the current time, which
+ * cannot be set back, a JSON file rewritten with the same size and then given
+ * its old modification time (as touch -r does) is found to be changed.  Only a
+ * JSON file that changes again in the same second that it last changed goes
+ * unseen that way, so when a path index is formed in that second (the JSON
+ * file was just written), the header also records a 64 bit FNV-1a hash of the
+ * JSON file, and json_pindex_open() reports the path index as stale unless the
+ * JSON file still has that hash.
+ *
+ * The header also records a 64 bit FNV-1a hash of the entries and the path
+ * pool, and json_pindex_open() checks it and the bounds of every entry, so
+ * that a path index that was damaged is reported as stale and formed again,
+ * instead of its entries being trusted.
+ * Like a snapshot (see json_snap.h), a path index is for the machine that
+ * wrote it.
+ */
+#define JSON_PINDEX_MAGIC "JPARPIDX"	/* first 8 bytes of a path index, w/o the NUL */
+#define JSON_PINDEX_MAGIC_LEN (8)	/* length of JSON_PINDEX_MAGIC */
+#define JSON_PINDEX_VERSION (3)		/* path index format version */
+#define JSON_PINDEX_ENDIAN (0x01020304U)	/* byte order marker, as written by the host */
+#define JSON_PINDEX_CHUNK (1024)	/* entries (or pool bytes) to add to a dynamic array at a time */
+#define JSON_PINDEX_FNV_BASIS ((uint64_t)14695981039346656037U)	/* FNV-1a 64 bit offset basis */
+#define JSON_PINDEX_FNV_PRIME ((uint64_t)1099511628211U)		/* FNV-1a 64 bit prime */
+
+/*
+ * what json_pindex_write() did
+ */
+enum json_pindex_status {
+    JSON_PINDEX_OK = 0,		/* path index written */
+    JSON_PINDEX_INVALID,	/* JSON file is not valid JSON, or has no JSON value */
+    JSON_PINDEX_CHANGED,	/* JSON file changed while it was indexed */
+    JSON_PINDEX_ERROR,		/* JSON file could not be read, or the path index could not be written */
+};
+
+struct json_pindex_hdr
+{
+    char magic[JSON_PINDEX_MAGIC_LEN];	/* JSON_PINDEX_MAGIC */
+    uint32_t version;			/* JSON_PINDEX_VERSION */
+    uint32_t endian;			/* JSON_PINDEX_ENDIAN */
+    uint32_t entry_size;		/* sizeof(struct json_pindex_entry) */
+    uint32_t unused;			/* 0 */
+    uint64_t json_size;			/* size of the JSON file indexed */
+    int64_t json_mtime;			/* modification time of the JSON file indexed */
+    int64_t json_ctime;			/* status change time of the JSON file indexed */
+    uint64_t json_ino;			/* inode number of the JSON file indexed */
+    int64_t formed;			/* time the path index was formed */
+    uint64_t json_hash;			/* FNV-1a hash of the JSON file if json_ctime >= formed, else 0 */
+    uint64_t entries;			/* number of entries, > 0 */
+    uint64_t entry_off;			/* file offset of entry 0 */
+    uint64_t pool_len;			/* length of the path pool */
+    uint64_t pool_off;			/* file offset of the path pool */
+    uint64_t file_len;			/* length of the path index file */
+    uint64_t checksum;			/* FNV-1a hash of the entries and the path pool */
+};
+
+struct json_pindex_entry
+{
+    uint64_t path;			/* pool offset of the JSON Pointer of the value */
+    uint64_t path_len;			/* length of the JSON Pointer */
+    uint64_t offset;			/* byte offset of the JSON text of the value in the JSON file */
+    uint64_t len;			/* length of the JSON text of the value */
+    uint32_t type;			/* enum item_type of the value */
+    uint32_t unused;			/* 0 */
+};
+
+/*
+ * an open path index
+ */
+struct json_pindex
+{
+    char const *map;			/* mapped path index file */
+    size_t size;			/* size of the path index file */
+    struct json_pindex_hdr const *hdr;	/* header */
+    struct json_pindex_entry const *entry;	/* entries */
+    char const *pool;			/* path pool */
+    char *filename;			/* malloced name of the JSON file */
+    int fd;				/* JSON file open for reading */
+};
+
+/*
+ * JSON object or array being indexed by json_pindex_write()
+ */
+struct json_pindex_frame
+{
+    size_t path_len;			/* length of the path of the JSON object or array */
+    bool in_object;			/* true ==> JSON object, false ==> JSON array */
+    intmax_t count;			/* number of children so far */
+    intmax_t entry;			/* entry of the JSON object or array */
+};
+
+/*
+ * entry of json_pindex_write() being sorted by path
+ */
+struct json_pindex_sort
+{
+    char const *path;			/* path of the entry, in the path pool */
+    struct json_pindex_entry const *entry;	/* entry */
+};
+
+/*
+ * state of json_pindex_write() while the JSON events of the JSON file arrive
+ */
+struct json_pindex_build
+{
+    struct dyn_array *entries;		/* struct json_pindex_entry of each JSON value so far */
+    struct dyn_array *pool;		/* path pool */
+    struct dyn_array *frames;		/* struct json_pindex_frame of each open JSON object or array */
+    struct dyn_array *path;		/* path of the current JSON value, not NUL terminated */
+    struct dyn_array *name;		/* name of the next JSON member, not NUL terminated */
+    size_t offset;			/* byte offset of the current token */
+    size_t len;				/* length of the current token */
+};
+
+
+/*
+ * external function declarations
+ */
+extern enum json_pindex_status json_pindex_write(char const *filename, char const *indexname);
+extern struct json_pindex *json_pindex_open(char const *filename, char const *indexname, bool *stale);
+extern bool json_pindex_find(struct json_pindex const *pindex, char const *path, size_t len, uint64_t *first,
+			     uint64_t *count);
+extern struct json *json_pindex_parse(struct json_pindex const *pindex, uint64_t num, bool *is_valid);
+extern void json_pindex_close(struct json_pindex *pindex);
+extern void json_pindex_path_add(struct dyn_array *path, char const *name, size_t len);
+
+#endif /* INCLUDE_JSON_PINDEX_H */
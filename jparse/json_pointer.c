@@ -0,0 +1,478 @@
+/*
+ * json_pointer - JSON Pointer (RFC 6901) resolution
+ *
+ * "Because a path you compile once is a path you do not parse again." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * jparse - JSON parser
+ */
+#include "jparse.h"
+
+
+/*
+ * static functions
+ */
+static struct json *pointer_step(struct json *node, struct json_pointer_token const *token);
+static int pointer_token_cmp(struct json_pointer_token const *a, struct json_pointer_token const *b);
+static int pointer_cmp(const void *a, const void *b);
+
+
+/*
+ * json_pointer_compile - compile a JSON Pointer into its tokens
+ *
+ * given:
+ *	pointer	    JSON Pointer, such as "/authors/0/name" (need not be NUL terminated)
+ *	len	    length of pointer in bytes
+ *
+ * returns:
+ *	compiled JSON Pointer, free it with json_pointer_free(),
+ *	NULL ==> pointer is not a JSON Pointer: it is not empty and does not
+ *		 start with /, or it has a ~ not followed by 0 or 1
+ *
+ * NOTE: This function does not return on NULL pointer or malloc error.
+ */
+struct json_pointer *
+json_pointer_compile(char const *pointer, size_t len)
+{
+    struct json_pointer *ptr = NULL;	/* compiled JSON Pointer */
+    struct json_pointer_token *token = NULL;	/* token being decoded */
+    char *p = NULL;			/* next byte of the pool */
+    size_t tokens = 0;			/* number of tokens */
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (pointer == NULL) {
+	err(10, __func__, "pointer is NULL");
+	not_reached();
+    }
+    if (len > 0 && pointer[0] != '/') {
+	warn(__func__, "JSON Pointer does not start with /");
+	return NULL;
+    }
+
+    /*
+     * count the tokens and check the escapes
+     */
+    for (i = 0; i < len; ++i) {
+	if (pointer[i] == '/') {
+	    ++tokens;
+	} else if (pointer[i] == '~' && (i + 1 >= len || (pointer[i+1] != '0' && pointer[i+1] != '1'))) {
+	    warn(__func__, "JSON Pointer has a ~ that is not ~0 or ~1 at byte %zu", i);
+	    return NULL;
+	}
+    }
+
+    /*
+     * allocate the pointer, its tokens and its pool
+     *
+     * NOTE: A decoded token is no longer than its encoded form, and the pool
+     *	     has room for the NUL after each token in place of its /.
+     */
+    ptr = calloc(1, sizeof(*ptr));
+    if (ptr == NULL) {
+	err(11, __func__, "calloc of struct json_pointer failed");
+	not_reached();
+    }
+    ptr->tokens = tokens;
+    ptr->pool = malloc(len + 1);
+    if (ptr->pool == NULL) {
+	err(12, __func__, "malloc of %zu byte pool failed", len + 1);
+	not_reached();
+    }
+    if (tokens > 0) {
+	ptr->token = calloc(tokens, sizeof(ptr->token[0]));
+	if (ptr->token == NULL) {
+	    err(13, __func__, "calloc of %zu tokens failed", tokens);
+	    not_reached();
+	}
+    }
+
+    /*
+     * decode each token into the pool
+     */
+    p = ptr->pool;
+    token = ptr->token;
+    for (i = 0; i < len; ++i) {
+	if (pointer[i] == '/') {
+	    if (token != ptr->token) {
+		token[-1].len = (size_t)(p - token[-1].name);
+		*p++ = '\0';
+	    }
+	    token->name = p;
+	    ++token;
+	} else if (pointer[i] == '~') {
+	    *p++ = (pointer[++i] == '0') ? '~' : '/';
+	} else {
+	    *p++ = pointer[i];
+	}
+    }
+    if (token != ptr->token) {
+	token[-1].len = (size_t)(p - token[-1].name);
+    }
+    *p = '\0';
+
+    /*
+     * note the tokens that are JSON array indexes
+     *
+     * NOTE: An index larger than INTMAX_MAX cannot refer to an element, and
+     *	     so is only a member name.
+     */
+    for (token = ptr->token; token < ptr->token + tokens; ++token) {
+	if (token->len == 0 || (token->len > 1 && token->name[0] == '0')) {
+	    continue;
+	}
+	token->is_index = true;
+	for (i = 0; i < token->len; ++i) {
+	    if (token->name[i] < '0' || token->name[i] > '9' ||
+		token->index > (INTMAX_MAX - (token->name[i] - '0')) / 10) {
+		token->is_index = false;
+		token->index = 0;
+		break;
+	    }
+	    token->index = token->index * 10 + (token->name[i] - '0');
+	}
+    }
+    return ptr;
+}
+
+
+/*
+ * pointer_step - take the step of a token from a JSON node
+ *
+ * given:
+ *	node	    JSON node, NULL ==> nothing to step from
+ *	token	    token of a compiled JSON Pointer
+ *
+ * returns:
+ *	JSON value that the token refers to in node,
+ *	NULL ==> node has no such member or element, or is not a JSON object or array
+ */
+static struct json *
+pointer_step(struct json *node, struct json_pointer_token const *token)
+{
+    struct json *member = NULL;		/* JTYPE_MEMBER with the name of the token */
+
+    if (node == NULL) {
+	return NULL;
+    }
+    switch (node->type) {
+    case JTYPE_OBJECT:
+	member = json_object_get(node, token->name, token->len);
+	return member != NULL ? member->item.member.value : NULL;
+    case JTYPE_ARRAY:
+	if (!token->is_index || token->index >= node->item.array.len || node->item.array.set == NULL) {
+	    return NULL;
+	}
+	return node->item.array.set[token->index];
+    default:
+	return NULL;
+    }
+}
+
+
+/*
+ * json_pointer_get - find the JSON value a compiled JSON Pointer refers to
+ *
+ * given:
+ *	ptr	    compiled JSON Pointer (see json_pointer_compile())
+ *	tree	    JSON parse tree
+ *
+ * returns:
+ *	JSON value the pointer refers to (tree for the pointer ""),
+ *	NULL ==> the tree has no such value, or NULL arg
+ *
+ * NOTE: The member of a JSON object with duplicate names is the first one, as
+ *	 found by json_object_get(), which may index the JSON object.
+ */
+struct json *
+json_pointer_get(struct json_pointer const *ptr, struct json *tree)
+{
+    struct json *node = tree;		/* JSON value being stepped from */
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (ptr == NULL || tree == NULL) {
+	return NULL;
+    }
+
+    for (i = 0; node != NULL && i < ptr->tokens; ++i) {
+	node = pointer_step(node, &ptr->token[i]);
+    }
+    return node;
+}
+
+
+/*
+ * pointer_token_cmp - compare two tokens of compiled JSON Pointers
+ *
+ * given:
+ *	a	    first token
+ *	b	    second token
+ *
+ * returns:
+ *	<0, 0 or >0 as a is before, the same as or after b
+ */
+static int
+pointer_token_cmp(struct json_pointer_token const *a, struct json_pointer_token const *b)
+{
+    int ret = 0;			/* memcmp() return */
+
+    ret = memcmp(a->name, b->name, a->len < b->len ? a->len : b->len);
+    if (ret != 0) {
+	return ret;
+    }
+    if (a->len != b->len) {
+	return a->len < b->len ? -1 : 1;
+    }
+    return 0;
+}
+
+
+/*
+ * pointer_cmp - compare two JSON Pointers by their tokens, for dyn_array_qsort()
+ *
+ * A pointer is before the pointers it is a leading part of.
+ *
+ * given:
+ *	a	    pointer to the first struct json_pointer_sort
+ *	b	    pointer to the second struct json_pointer_sort
+ *
+ * returns:
+ *	<0, 0 or >0 as a is before, the same as or after b
+ */
+static int
+pointer_cmp(const void *a, const void *b)
+{
+    struct json_pointer const *pa = ((struct json_pointer_sort const *)a)->ptr;	/* first pointer */
+    struct json_pointer const *pb = ((struct json_pointer_sort const *)b)->ptr;	/* second pointer */
+    int ret = 0;			/* pointer_token_cmp() return */
+    size_t i;
+
+    for (i = 0; i < pa->tokens && i < pb->tokens; ++i) {
+	ret = pointer_token_cmp(&pa->token[i], &pb->token[i]);
+	if (ret != 0) {
+	    return ret;
+	}
+    }
+    if (pa->tokens != pb->tokens) {
+	return pa->tokens < pb->tokens ? -1 : 1;
+    }
+    return 0;
+}
+
+
+/*
+ * json_pointer_get_all - find the JSON values a set of compiled JSON Pointers refer to
+ *
+ * The pointers are sorted by their tokens, and each pointer starts from the
+ * JSON values found for the leading tokens it shares with the pointer before
+ * it, so a step shared by many pointers (such as /authors/0 of /authors/0/name
+ * and /authors/0/email) is taken once.
+ *
+ * given:
+ *	ptrs	    array of count compiled JSON Pointers (see json_pointer_compile())
+ *	count	    number of pointers
+ *	tree	    JSON parse tree
+ *	found	    array of count JSON values: found[i] is set to the JSON value
+ *		    ptrs[i] refers to, or NULL if the tree has no such value
+ *
+ * returns:
+ *	number of pointers that refer to a JSON value of the tree
+ *
+ * NOTE: This function does not return on NULL arg or a NULL pointer in ptrs.
+ */
+size_t
+json_pointer_get_all(struct json_pointer const * const *ptrs, size_t count, struct json *tree, struct json **found)
+{
+    struct dyn_array *sorted = NULL;	/* struct json_pointer_sort of each pointer, sorted by tokens */
+    struct dyn_array *path = NULL;	/* struct json * found for each leading token of the previous pointer */
+    struct json_pointer_sort sort;	/* pointer being added to sorted */
+    struct json_pointer const *prev = NULL;	/* previous pointer in sorted order */
+    struct json_pointer const *ptr = NULL;	/* pointer being resolved */
+    struct json *node = NULL;		/* JSON value being stepped from */
+    size_t ret = 0;			/* number of pointers found */
+    size_t same;			/* number of leading tokens ptr shares with prev */
+    size_t i;
+    size_t j;
+
+    /*
+     * firewall
+     */
+    if (ptrs == NULL || found == NULL) {
+	err(14, __func__, "ptrs and/or found is NULL");
+	not_reached();
+    }
+    if (count == 0) {
+	return 0;
+    }
+
+    /*
+     * sort the pointers by their tokens
+     */
+    sorted = dyn_array_create(sizeof(struct json_pointer_sort), JSON_POINTER_CHUNK, (intmax_t)count, false);
+    for (i = 0; i < count; ++i) {
+	if (ptrs[i] == NULL) {
+	    err(15, __func__, "ptrs[%zu] is NULL", i);
+	    not_reached();
+	}
+	sort.ptr = ptrs[i];
+	sort.num = i;
+	(void) dyn_array_append_value(sorted, &sort);
+    }
+    dyn_array_qsort(sorted, pointer_cmp);
+
+    /*
+     * resolve each pointer from the values of the leading tokens it shares
+     *
+     * NOTE: path holds tree and then the JSON value found for each token of
+     *	     prev, NULL from the first token that refers to no value.
+     */
+    path = dyn_array_create(sizeof(struct json *), JSON_POINTER_CHUNK, JSON_POINTER_CHUNK, false);
+    (void) dyn_array_append_value(path, &tree);
+    for (i = 0; i < count; ++i) {
+	ptr = dyn_array_value(sorted, struct json_pointer_sort, i).ptr;
+
+	/*
+	 * count the leading tokens shared with the previous pointer
+	 */
+	same = 0;
+	if (prev != NULL) {
+	    while (same < ptr->tokens && same < prev->tokens &&
+		   pointer_token_cmp(&ptr->token[same], &prev->token[same]) == 0) {
+		++same;
+	    }
+	}
+
+	/*
+	 * take the steps of the other tokens
+	 */
+	(void) dyn_array_seek(path, (off_t)(same + 1), SEEK_SET);
+	node = dyn_array_value(path, struct json *, same);
+	for (j = same; j < ptr->tokens; ++j) {
+	    node = pointer_step(node, &ptr->token[j]);
+	    (void) dyn_array_append_value(path, &node);
+	}
+	found[dyn_array_value(sorted, struct json_pointer_sort, i).num] = node;
+	if (node != NULL) {
+	    ++ret;
+	}
+	prev = ptr;
+    }
+
+    /*
+     * free storage
+     */
+    dyn_array_free(path);
+    dyn_array_free(sorted);
+    return ret;
+}
+
+
+/*
+ * json_pointer_find - find the JSON value a JSON Pointer string refers to
+ *
+ * This is json_pointer_compile(), json_pointer_get() and json_pointer_free()
+ * for a pointer that is used once: compile a pointer that is used again.
+ *
+ * given:
+ *	tree	    JSON parse tree
+ *	pointer	    NUL terminated JSON Pointer
+ *
+ * returns:
+ *	JSON value the pointer refers to,
+ *	NULL ==> the tree has no such value, pointer is not a JSON Pointer, or NULL arg
+ */
+struct json *
+json_pointer_find(struct json *tree, char const *pointer)
+{
+    struct json_pointer *ptr = NULL;	/* compiled JSON Pointer */
+    struct json *node = NULL;		/* JSON value found */
+
+    /*
+     * firewall
+     */
+    if (tree == NULL || pointer == NULL) {
+	return NULL;
+    }
+
+    ptr = json_pointer_compile(pointer, strlen(pointer));
+    if (ptr == NULL) {
+	return NULL;
+    }
+    node = json_pointer_get(ptr, tree);
+    json_pointer_free(ptr);
+    return node;
+}
+
+
+/*
+ * json_pointer_free - free a compiled JSON Pointer
+ *
+ * given:
+ *	ptr	    compiled JSON Pointer, NULL ==> do nothing
+ */
+void
+json_pointer_free(struct json_pointer *ptr)
+{
+    if (ptr == NULL) {
+	return;
+    }
+    if (ptr->token != NULL) {
+	free(ptr->token);
+	ptr->token = NULL;
+    }
+    if (ptr->pool != NULL) {
+	free(ptr->pool);
+	ptr->pool = NULL;
+    }
+    free(ptr);
+}
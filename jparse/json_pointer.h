@@ -0,0 +1,127 @@
+/*
+ * json_pointer - JSON Pointer (RFC 6901) resolution
+ *
+ * "Because a path you compile once is a path you do not parse again." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+#if !defined(INCLUDE_JSON_POINTER_H)
+#    define  INCLUDE_JSON_POINTER_H
+
+
+#include <stdint.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#else
+  #include <c_bool.h>
+  #include <c_compat.h>
+  #include <dbg.h>
+#endif
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "util.h"
+
+
+/*
+ * compiled JSON Pointer
+ *
+ * A JSON Pointer (RFC 6901) refers to a JSON value of a JSON document: "" is
+ * the whole JSON document, and each /token after it is a JSON member name of
+ * the JSON object, or the index of an element of the JSON array, that the
+ * pointer before it refers to.  In a token ~1 stands for / and ~0 for ~.
+ *
+ * json_pointer_compile() decodes a pointer once into its tokens, so a pointer
+ * that is used many times, such as a fixed path into a .auth.json or
+ * .info.json file, is not decoded again: json_pointer_get() takes one step per
+ * token, finding a member with json_object_get() (in constant time in a large
+ * JSON object, see struct json_object_index) and an element by its index.
+ *
+ * json_pointer_get_all() resolves a set of pointers in one pass over the tree:
+ * the pointers are sorted by their tokens, and the steps of the leading tokens
+ * a pointer shares with the pointer before it are not taken again.
+ */
+#define JSON_POINTER_CHUNK (16)		/* pointers to add to a dynamic array at a time */
+
+struct json_pointer_token
+{
+    char const *name;			/* decoded token, NUL terminated, in the pool of the pointer */
+    size_t len;				/* length of name in bytes */
+    bool is_index;			/* true ==> token is a JSON array index: 0, or digits w/o a leading 0 */
+    intmax_t index;			/* JSON array index if is_index */
+};
+
+struct json_pointer
+{
+    size_t tokens;			/* number of tokens, 0 ==> the whole JSON document */
+    struct json_pointer_token *token;	/* tokens in order, NULL ==> no tokens */
+    char *pool;				/* decoded tokens, each NUL terminated */
+};
+
+/*
+ * pointer of json_pointer_get_all() being sorted by its tokens
+ */
+struct json_pointer_sort
+{
+    struct json_pointer const *ptr;	/* compiled JSON Pointer */
+    size_t num;				/* number of the pointer in the set */
+};
+
+
+/*
+ * external function declarations
+ */
+extern struct json_pointer *json_pointer_compile(char const *pointer, size_t len);
+extern struct json *json_pointer_get(struct json_pointer const *ptr, struct json *tree);
+extern size_t json_pointer_get_all(struct json_pointer const * const *ptrs, size_t count, struct json *tree,
+				   struct json **found);
+extern struct json *json_pointer_find(struct json *tree, char const *pointer);
+extern void json_pointer_free(struct json_pointer *ptr);
+
+#endif /* INCLUDE_JSON_POINTER_H */
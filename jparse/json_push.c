@@ -0,0 +1,1044 @@
+/*
+ * json_push - incremental (push) JSON parser
+ *
+ * "Because sometimes JSON arrives one drip at a time." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+
+#include <unistd.h>
+
+/*
+ * jparse - JSON parser
+ */
+#include "jparse.h"
+
+/*
+ * json_push - incremental (push) JSON parser
+ */
+#include "json_push.h"
+
+
+/*
+ * static functions
+ */
+static void json_push_tok_add(struct jparse_push *ctx, char c);
+static bool json_push_emit(struct jparse_push *ctx, int tok, char const *text, size_t len);
+static void json_push_loc_start(struct jparse_push *ctx);
+static void json_push_loc_add(struct jparse_push *ctx, char c);
+static size_t json_push_number_len(char const *str, size_t len);
+static bool json_push_end_token(struct jparse_push *ctx);
+static void json_push_free(struct jparse_push *ctx);
+static void json_push_open(struct jparse_push *ctx, struct json *node);
+static void json_push_add_node(struct jparse_push *ctx, struct json *node);
+static bool json_push_start_object(void *data);
+static bool json_push_end_object(void *data);
+static bool json_push_start_array(void *data);
+static bool json_push_end_array(void *data);
+static bool json_push_member_name(void *data, char const *name, size_t len);
+static bool json_push_value(void *data, enum item_type type, char const *str, size_t len);
+
+
+/*
+ * JSON event callbacks that form a JSON parse tree, the same way jparse.y does
+ */
+static struct json_event_cb const json_push_tree_cb = {
+    json_push_start_object,
+    json_push_end_object,
+    json_push_start_array,
+    json_push_end_array,
+    json_push_member_name,
+    json_push_value,
+    NULL,
+};
+
+
+/*
+ * jparse_push_create - create a JSON push parser
+ *
+ * given:
+ *	filename    filename for error messages, or NULL
+ *	cb	    pointer to the JSON event callbacks, or
+ *		    NULL ==> form a JSON parse tree, returned by jparse_push_finish()
+ *	data	    data pointer given to each callback
+ *
+ * returns:
+ *	pointer to a calloc()ed JSON push parser
+ *
+ * NOTE: Feed the JSON document with jparse_push_feed() and then call
+ *	 jparse_push_finish() which also frees the JSON push parser.
+ *
+ * NOTE: This function does not return on calloc error.
+ */
+struct jparse_push *
+jparse_push_create(char const *filename, struct json_event_cb const *cb, void *data)
+{
+    struct jparse_push *ctx = NULL;	/* JSON push parser to return */
+
+    /*
+     * allocate the JSON push parser
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    ctx = calloc(1, sizeof(*ctx));
+    if (ctx == NULL) {
+	errp(10, __func__, "calloc of %zu bytes failed", sizeof(*ctx));
+	not_reached();
+    }
+    ctx->cb = cb;
+    ctx->data = data;
+    ctx->filename = filename;
+    ctx->kind = JSON_PUSH_NONE;
+
+    /*
+     * without callbacks the JSON event parser forms a JSON parse tree
+     */
+    if (cb != NULL) {
+	json_event_init(&ctx->ep, cb, data);
+    } else {
+	json_event_init(&ctx->ep, &json_push_tree_cb, ctx);
+    }
+    return ctx;
+}
+
+
+/*
+ * json_push_tok_add - add a byte to the current (partial) token
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *	c	byte to add
+ *
+ * NOTE: This function does not return on realloc error.
+ */
+static void
+json_push_tok_add(struct jparse_push *ctx, char c)
+{
+    char *tok = NULL;		/* reallocated token */
+    size_t size = 0;		/* new allocated size of the token */
+
+    /*
+     * grow the token, leaving room for the NUL byte, if needed
+     */
+    if (ctx->tok_len + 1 >= ctx->tok_size) {
+	size = ctx->tok_size * 2;
+	if (size < JSON_PUSH_TOKEN_CHUNK) {
+	    size = JSON_PUSH_TOKEN_CHUNK;
+	}
+	errno = 0;		/* pre-clear errno for errp() */
+	tok = realloc(ctx->tok, size);
+	if (tok == NULL) {
+	    errp(11, __func__, "realloc of %zu bytes failed", size);
+	    not_reached();
+	}
+	ctx->tok = tok;
+	ctx->tok_size = size;
+    }
+    ctx->tok[ctx->tok_len++] = c;
+    ctx->tok[ctx->tok_len] = '\0';
+    return;
+}
+
+
+/*
+ * json_push_emit - feed a complete token to the JSON event parser
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *	tok	JSON scanner token
+ *	text	NUL terminated text of the token
+ *	len	length of text
+ *
+ * returns:
+ *	true ==> token accepted,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: Syntax errors are reported in the same form as jparse_error().
+ */
+static bool
+json_push_emit(struct jparse_push *ctx, int tok, char const *text, size_t len)
+{
+    struct json_event_parser *ep = &ctx->ep;	/* JSON event parser */
+
+    /*
+     * feed the token
+     */
+    ctx->text = text;
+    ctx->text_len = len;
+    if (json_event_token(ep, tok, text, len)) {
+	return true;
+    }
+    ctx->failed = true;
+
+    /*
+     * report why the JSON is not valid
+     */
+    if (ep->stopped) {
+	json_dbg(JSON_DBG_LOW, __func__, "%s", ep->error);
+	return false;
+    }
+    flockfile(stderr);	/* write the whole message at once, even with other threads */
+    if (ep->error != NULL) {
+	fprint(stderr, "%s", ep->error);
+    } else {
+	fprint(stderr, "syntax error, unexpected %s", json_event_token_name(tok));
+    }
+    if (ctx->tok_line > 0 && ctx->filename != NULL && *ctx->filename != '\0') {
+	/* as with jparse.l, the filename is only known once a token has been scanned */
+	fprint(stderr, " in file %s", ctx->filename);
+    }
+    fprint(stderr, " at line %d column %d: %s\n", ctx->tok_line, ctx->tok_column,
+	   *text != '\0' ? text : "empty text");
+    funlockfile(stderr);
+    return false;
+}
+
+
+/*
+ * json_push_loc_start - start the location of a token
+ *
+ * The location of each token, including whitespace, is tracked the same way
+ * as the YY_USER_ACTION macro of jparse.l does, so that the JSON push parser
+ * reports the same error locations as the JSON scanner.
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ */
+static void
+json_push_loc_start(struct jparse_push *ctx)
+{
+    ctx->tok_line = ctx->last_line + 1;
+    ctx->tok_column = ctx->last_column;
+    return;
+}
+
+
+/*
+ * json_push_loc_add - add a byte of the current token to its location
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *	c	byte of the current token
+ */
+static void
+json_push_loc_add(struct jparse_push *ctx, char c)
+{
+    if (c == '\0') {
+	/* as with yytext in YY_USER_ACTION, a NUL byte ends the token text */
+	return;
+    } else if (c == '\n') {
+	ctx->last_line++;
+	ctx->last_column = 0;
+    } else if (c == '\t') {
+	ctx->last_column += 8;
+    } else if (ctx->tok_column == 0 || ctx->last_column == 0) {
+	if (ctx->tok_column == 0) {
+	    ctx->tok_column = 1;
+	}
+	if (ctx->last_column == 0) {
+	    ctx->last_column = 1;
+	}
+    } else {
+	ctx->last_column++;
+	ctx->tok_column++;
+    }
+    return;
+}
+
+
+/*
+ * json_push_number_len - length of the longest JSON number at the start of a string
+ *
+ * A JSON number matches the JSON_NUMBER pattern of jparse.l:
+ *
+ *	-?(0|[1-9][0-9]*)(\.[0-9]+)?([Ee][-+]?[0-9]+)?
+ *
+ * given:
+ *	str	string to check
+ *	len	length of str
+ *
+ * returns:
+ *	length of the JSON number at the start of str, 0 ==> no JSON number
+ */
+static size_t
+json_push_number_len(char const *str, size_t len)
+{
+    size_t i = 0;		/* index into str */
+    size_t end = 0;		/* end of the JSON number so far */
+    size_t digits = 0;		/* start of a run of digits */
+
+    /*
+     * integer part
+     */
+    if (i < len && str[i] == '-') {
+	++i;
+    }
+    if (i < len && str[i] == '0') {
+	++i;
+    } else {
+	for (digits = i; i < len && isdigit((unsigned char)str[i]); ++i) {
+	    /* skip digits */
+	}
+	if (i == digits) {
+	    return 0;
+	}
+    }
+    end = i;
+
+    /*
+     * optional fraction
+     */
+    if (i < len && str[i] == '.') {
+	for (digits = ++i; i < len && isdigit((unsigned char)str[i]); ++i) {
+	    /* skip digits */
+	}
+	if (i == digits) {
+	    return end;
+	}
+	end = i;
+    }
+
+    /*
+     * optional exponent
+     */
+    if (i < len && (str[i] == 'e' || str[i] == 'E')) {
+	++i;
+	if (i < len && (str[i] == '-' || str[i] == '+')) {
+	    ++i;
+	}
+	for (digits = i; i < len && isdigit((unsigned char)str[i]); ++i) {
+	    /* skip digits */
+	}
+	if (i > digits) {
+	    end = i;
+	}
+    }
+    return end;
+}
+
+
+/*
+ * json_push_end_token - feed a run of number or literal bytes that has ended
+ *
+ * The run is split into tokens the same way the JSON scanner splits it: the
+ * longest JSON number, true, false or null, else a single byte invalid token.
+ * For example "2ee0" is the JSON number 2 followed by the invalid token e.
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *
+ * returns:
+ *	true ==> all tokens accepted,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ */
+static bool
+json_push_end_token(struct jparse_push *ctx)
+{
+    char *str = ctx->tok;	/* start of the next token of the run */
+    size_t len = ctx->tok_len;	/* bytes of the run left */
+    size_t n = 0;		/* length of the next token */
+    int tok = token;		/* JSON scanner token, token ==> invalid token */
+    char save = '\0';		/* byte after the next token */
+    bool ok = true;		/* false ==> token not accepted */
+    size_t i;
+
+    ctx->kind = JSON_PUSH_NONE;
+    ctx->tok_len = 0;
+    while (len > 0 && ok) {
+	/*
+	 * determine the next token
+	 */
+	if (*str == '-' || isdigit((unsigned char)*str)) {
+	    n = json_push_number_len(str, len);
+	    tok = JSON_NUMBER;
+	} else if (len >= 4 && strncmp(str, "true", 4) == 0) {
+	    n = 4;
+	    tok = JSON_TRUE;
+	} else if (len >= 5 && strncmp(str, "false", 5) == 0) {
+	    n = 5;
+	    tok = JSON_FALSE;
+	} else if (len >= 4 && strncmp(str, "null", 4) == 0) {
+	    n = 4;
+	    tok = JSON_NULL;
+	} else {
+	    n = 0;
+	}
+	if (n == 0) {
+	    n = 1;
+	    tok = token;
+	}
+
+	/*
+	 * feed the token, NUL terminated in place
+	 */
+	json_push_loc_start(ctx);
+	for (i = 0; i < n; ++i) {
+	    json_push_loc_add(ctx, str[i]);
+	}
+	save = str[n];
+	str[n] = '\0';
+	ok = json_push_emit(ctx, tok, str, n);
+	str[n] = save;
+	str += n;
+	len -= n;
+    }
+    return ok;
+}
+
+
+/*
+ * jparse_push_feed - feed the next chunk of a JSON document to a JSON push parser
+ *
+ * Every token that is complete is fed to the JSON event parser, calling the
+ * JSON event callbacks or adding to the JSON parse tree.  A token that is not
+ * complete at the end of the chunk is kept until the next chunk.
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *	buf	next chunk of the JSON document
+ *	len	length of buf
+ *
+ * returns:
+ *	true ==> JSON is valid so far,
+ *	false ==> JSON is not valid or a callback stopped the parse
+ *
+ * NOTE: This function does not return on NULL ctx.
+ */
+bool
+jparse_push_feed(struct jparse_push *ctx, char const *buf, size_t len)
+{
+    char c = '\0';		/* current byte */
+    size_t n = 0;		/* length of a JSON string */
+    size_t i;
+    size_t j;
+
+    /*
+     * firewall
+     */
+    if (ctx == NULL) {
+	err(12, __func__, "ctx is NULL");
+	not_reached();
+    }
+    if (ctx->failed) {
+	return false;
+    }
+    if (buf == NULL) {
+	return len == 0;
+    }
+
+    /*
+     * scan the chunk
+     */
+    for (i = 0; i < len && !ctx->failed; ++i) {
+	c = buf[i];
+
+	/*
+	 * continue the current token
+	 */
+	switch (ctx->kind) {
+	case JSON_PUSH_STRING:
+	    /*
+	     * a JSON string may not contain bytes in [\x01-\x1f]: the JSON
+	     * scanner then finds the opening " to be an invalid token
+	     *
+	     * NOTE: as with the JSON scanner, a NUL byte is left to the
+	     *	     JSON event parser to reject.
+	     */
+	    if (c != '\0' && (unsigned char)c < 0x20) {
+		json_push_loc_start(ctx);
+		json_push_loc_add(ctx, '"');
+		(void) json_push_emit(ctx, token, "\"", 1);
+		continue;
+	    }
+	    json_push_tok_add(ctx, c);
+	    if (ctx->escape) {
+		ctx->escape = false;
+	    } else if (c == '\\') {
+		ctx->escape = true;
+	    } else if (c == '"') {
+		json_push_loc_start(ctx);
+		n = strlen(ctx->tok);	/* as with YY_USER_ACTION, the location ends at a NUL byte */
+		for (j = 0; j < n; ++j) {
+		    json_push_loc_add(ctx, ctx->tok[j]);
+		}
+		n = ctx->tok_len;
+		ctx->kind = JSON_PUSH_NONE;
+		ctx->tok_len = 0;
+		(void) json_push_emit(ctx, JSON_STRING, ctx->tok, n);
+	    }
+	    continue;
+
+	case JSON_PUSH_NUMBER:
+	case JSON_PUSH_LITERAL:
+	    if (isdigit((unsigned char)c) || islower((unsigned char)c) ||
+		c == '.' || c == 'E' || c == '-' || c == '+') {
+		json_push_tok_add(ctx, c);
+		continue;
+	    }
+	    if (!json_push_end_token(ctx)) {
+		continue;
+	    }
+	    break;
+
+	case JSON_PUSH_WS:
+	    if (c == ' ' || c == '\t' || c == '\r') {
+		json_push_loc_add(ctx, c);
+		continue;
+	    }
+	    break;
+
+	case JSON_PUSH_NL:
+	    if (c == '\n') {
+		json_push_loc_add(ctx, c);
+		continue;
+	    }
+	    break;
+
+	default:
+	    break;
+	}
+
+	/*
+	 * start the next token
+	 */
+	ctx->kind = JSON_PUSH_NONE;
+	ctx->tok_len = 0;
+	switch (c) {
+	case ' ':	/*fallthrough*/
+	case '\t':	/*fallthrough*/
+	case '\r':
+	    ctx->kind = JSON_PUSH_WS;
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    break;
+	case '\n':
+	    ctx->kind = JSON_PUSH_NL;
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    break;
+	case '{':
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    (void) json_push_emit(ctx, JSON_OPEN_BRACE, "{", 1);
+	    break;
+	case '}':
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    (void) json_push_emit(ctx, JSON_CLOSE_BRACE, "}", 1);
+	    break;
+	case '[':
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    (void) json_push_emit(ctx, JSON_OPEN_BRACKET, "[", 1);
+	    break;
+	case ']':
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    (void) json_push_emit(ctx, JSON_CLOSE_BRACKET, "]", 1);
+	    break;
+	case ',':
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    (void) json_push_emit(ctx, JSON_COMMA, ",", 1);
+	    break;
+	case ':':
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, c);
+	    (void) json_push_emit(ctx, JSON_COLON, ":", 1);
+	    break;
+	case '"':
+	    ctx->kind = JSON_PUSH_STRING;
+	    ctx->escape = false;
+	    json_push_tok_add(ctx, c);
+	    break;
+	default:
+	    if (c == '-' || isdigit((unsigned char)c)) {
+		ctx->kind = JSON_PUSH_NUMBER;
+		json_push_tok_add(ctx, c);
+	    } else if (islower((unsigned char)c)) {
+		ctx->kind = JSON_PUSH_LITERAL;
+		json_push_tok_add(ctx, c);
+	    } else {
+		/*
+		 * invalid token: any other byte
+		 */
+		json_push_tok_add(ctx, c);
+		ctx->tok_len = 0;
+		json_push_loc_start(ctx);
+		json_push_loc_add(ctx, c);
+		(void) json_push_emit(ctx, token, ctx->tok, 1);
+	    }
+	    break;
+	}
+    }
+    return !ctx->failed;
+}
+
+
+/*
+ * jparse_push_finish - end the JSON document of a JSON push parser
+ *
+ * given:
+ *	ctx	    pointer to a JSON push parser, which is freed
+ *	is_valid    non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * returns:
+ *	pointer to the JSON parse tree when the JSON push parser was created
+ *	without JSON event callbacks and the JSON is valid, else NULL
+ *
+ * NOTE: Free the JSON parse tree as one returned by parse_json().
+ *
+ * NOTE: This function does not return on NULL ctx or is_valid.
+ */
+struct json *
+jparse_push_finish(struct jparse_push *ctx, bool *is_valid)
+{
+    struct json *tree = NULL;	/* JSON parse tree to return */
+
+    /*
+     * firewall
+     */
+    if (ctx == NULL) {
+	err(13, __func__, "ctx is NULL");
+	not_reached();
+    }
+    if (is_valid == NULL) {
+	err(14, __func__, "is_valid is NULL");
+	not_reached();
+    }
+
+    /*
+     * end the last token, then the JSON document
+     */
+    if (!ctx->failed) {
+	if (ctx->kind == JSON_PUSH_STRING) {
+	    /* unterminated JSON string: the opening " is an invalid token */
+	    json_push_loc_start(ctx);
+	    json_push_loc_add(ctx, '"');
+	    (void) json_push_emit(ctx, token, "\"", 1);
+	} else if (ctx->kind == JSON_PUSH_NUMBER || ctx->kind == JSON_PUSH_LITERAL) {
+	    (void) json_push_end_token(ctx);
+	}
+    }
+    if (!ctx->failed) {
+	/* as with the JSON scanner, end of file is at the location of the last token */
+	(void) json_push_emit(ctx, JPARSE_EOF, "", 0);
+    }
+    *is_valid = !ctx->failed;
+
+    /*
+     * hand over the JSON parse tree, if valid
+     */
+    if (*is_valid) {
+	tree = ctx->tree;
+	ctx->tree = NULL;
+    }
+    json_push_free(ctx);
+    return tree;
+}
+
+
+/*
+ * json_push_free - free a JSON push parser
+ *
+ * Any JSON parse tree that was not handed over, including the open objects
+ * and arrays of a JSON document that is not valid, is freed too.
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ */
+static void
+json_push_free(struct jparse_push *ctx)
+{
+    size_t i;
+
+    /*
+     * free the JSON parse tree and its open objects, arrays and member names
+     */
+    for (i = 0; i < ctx->depth; ++i) {
+	if (ctx->stack[i] != NULL) {
+	    json_tree_free(ctx->stack[i], JSON_INFINITE_DEPTH);
+	    free(ctx->stack[i]);
+	    ctx->stack[i] = NULL;
+	}
+	if (ctx->name[i] != NULL) {
+	    json_tree_free(ctx->name[i], JSON_INFINITE_DEPTH);
+	    free(ctx->name[i]);
+	    ctx->name[i] = NULL;
+	}
+    }
+    if (ctx->tree != NULL) {
+	json_tree_free(ctx->tree, JSON_INFINITE_DEPTH);
+	free(ctx->tree);
+	ctx->tree = NULL;
+    }
+    if (ctx->stack != NULL) {
+	free(ctx->stack);
+	ctx->stack = NULL;
+    }
+    if (ctx->name != NULL) {
+	free(ctx->name);
+	ctx->name = NULL;
+    }
+
+    /*
+     * free the rest of the JSON push parser
+     */
+    json_event_free(&ctx->ep);
+    if (ctx->tok != NULL) {
+	free(ctx->tok);
+	ctx->tok = NULL;
+    }
+    free(ctx);
+    return;
+}
+
+
+/*
+ * json_push_add_node - add a complete JSON value to the JSON parse tree
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *	node	complete JSON value
+ */
+static void
+json_push_add_node(struct jparse_push *ctx, struct json *node)
+{
+    struct json *parent = NULL;		/* open object or array */
+    struct json *member = NULL;		/* JSON member of an open object */
+
+    /*
+     * case: top level JSON value
+     */
+    if (ctx->depth == 0) {
+	ctx->tree = node;
+	return;
+    }
+
+    /*
+     * case: value of a JSON member
+     */
+    parent = ctx->stack[ctx->depth-1];
+    if (parent->type == JTYPE_OBJECT) {
+	member = json_parse_member(ctx->name[ctx->depth-1], node);
+	ctx->name[ctx->depth-1] = NULL;
+	(void) json_object_add_member(parent, member);
+
+    /*
+     * case: JSON array element
+     */
+    } else {
+	(void) json_elements_add_value(parent, node);
+    }
+    return;
+}
+
+
+/*
+ * json_push_open - open a JSON object or array (elements) of the JSON parse tree
+ *
+ * given:
+ *	ctx	pointer to a JSON push parser
+ *	node	new JSON object or JSON elements
+ *
+ * NOTE: This function does not return on realloc error.
+ */
+static void
+json_push_open(struct jparse_push *ctx, struct json *node)
+{
+    struct json **stack = NULL;		/* reallocated open objects and arrays */
+    struct json **name = NULL;		/* reallocated member names */
+
+    /*
+     * allocate more nesting levels if needed
+     */
+    if (ctx->depth >= ctx->max_depth) {
+	errno = 0;		/* pre-clear errno for errp() */
+	stack = realloc(ctx->stack, (ctx->max_depth + JSON_EVENT_STACK_CHUNK) * sizeof(*stack));
+	if (stack == NULL) {
+	    errp(15, __func__, "realloc of %zu nesting levels failed", ctx->max_depth + JSON_EVENT_STACK_CHUNK);
+	    not_reached();
+	}
+	ctx->stack = stack;
+	errno = 0;		/* pre-clear errno for errp() */
+	name = realloc(ctx->name, (ctx->max_depth + JSON_EVENT_STACK_CHUNK) * sizeof(*name));
+	if (name == NULL) {
+	    errp(16, __func__, "realloc of %zu nesting levels failed", ctx->max_depth + JSON_EVENT_STACK_CHUNK);
+	    not_reached();
+	}
+	ctx->name = name;
+	ctx->max_depth += JSON_EVENT_STACK_CHUNK;
+    }
+    ctx->stack[ctx->depth] = node;
+    ctx->name[ctx->depth] = NULL;
+    ++ctx->depth;
+    return;
+}
+
+
+/*
+ * json_push_start_object - JSON event callback: open a JSON object of the JSON parse tree
+ *
+ * given:
+ *	data	pointer to the JSON push parser
+ *
+ * returns:
+ *	true
+ */
+static bool
+json_push_start_object(void *data)
+{
+    json_push_open(data, json_create_object());
+    return true;
+}
+
+
+/*
+ * json_push_end_object - JSON event callback: close a JSON object of the JSON parse tree
+ *
+ * given:
+ *	data	pointer to the JSON push parser
+ *
+ * returns:
+ *	true
+ */
+static bool
+json_push_end_object(void *data)
+{
+    struct jparse_push *ctx = data;	/* JSON push parser */
+    struct json *node = NULL;		/* closed JSON object */
+
+    node = ctx->stack[--ctx->depth];
+    ctx->stack[ctx->depth] = NULL;
+    json_push_add_node(ctx, node);
+    return true;
+}
+
+
+/*
+ * json_push_start_array - JSON event callback: open a JSON array of the JSON parse tree
+ *
+ * given:
+ *	data	pointer to the JSON push parser
+ *
+ * returns:
+ *	true
+ */
+static bool
+json_push_start_array(void *data)
+{
+    json_push_open(data, json_create_elements());
+    return true;
+}
+
+
+/*
+ * json_push_end_array - JSON event callback: close a JSON array of the JSON parse tree
+ *
+ * given:
+ *	data	pointer to the JSON push parser
+ *
+ * returns:
+ *	true
+ */
+static bool
+json_push_end_array(void *data)
+{
+    struct jparse_push *ctx = data;	/* JSON push parser */
+    struct json *node = NULL;		/* closed JSON array */
+
+    node = ctx->stack[--ctx->depth];
+    ctx->stack[ctx->depth] = NULL;
+    json_push_add_node(ctx, json_parse_array(node));
+    return true;
+}
+
+
+/*
+ * json_push_member_name - JSON event callback: name of a JSON member of the JSON parse tree
+ *
+ * given:
+ *	data	pointer to the JSON push parser
+ *	name	decoded name (not used: the encoded token is converted instead)
+ *	len	length of name (not used)
+ *
+ * returns:
+ *	true
+ */
+static bool
+json_push_member_name(void *data, char const *name, size_t len)
+{
+    struct jparse_push *ctx = data;	/* JSON push parser */
+
+    UNUSED_ARG(name);
+    UNUSED_ARG(len);
+
+    ctx->name[ctx->depth-1] = json_parse_string(ctx->text, ctx->text_len);
+    return true;
+}
+
+
+/*
+ * json_push_value - JSON event callback: JSON value of the JSON parse tree
+ *
+ * given:
+ *	data	pointer to the JSON push parser
+ *	type	type of the JSON value
+ *	str	decoded JSON string or text of the JSON value (not used: the token is converted instead)
+ *	len	length of str (not used)
+ *
+ * returns:
+ *	true
+ */
+static bool
+json_push_value(void *data, enum item_type type, char const *str, size_t len)
+{
+    struct jparse_push *ctx = data;	/* JSON push parser */
+    struct json *node = NULL;		/* JSON value */
+
+    UNUSED_ARG(str);
+    UNUSED_ARG(len);
+
+    /*
+     * convert the token as jparse.y does
+     */
+    switch (type) {
+    case JTYPE_STRING:
+	node = json_parse_string(ctx->text, ctx->text_len);
+	break;
+    case JTYPE_NUMBER:
+	node = json_parse_number(ctx->text);
+	break;
+    case JTYPE_BOOL:
+	node = json_parse_bool(ctx->text);
+	break;
+    default:
+	node = json_parse_null(ctx->text);
+	break;
+    }
+    json_push_add_node(ctx, node);
+    return true;
+}
+
+
+/*
+ * parse_json_stream_push - parse an open JSON stream with a JSON push parser
+ *
+ * The stream is read with read(2), a chunk at a time, and each chunk is fed
+ * to the JSON push parser as soon as it is read: a slow producer, such as a
+ * pipe from a decompressor, is parsed while it is producing.
+ *
+ * given:
+ *	stream	    open file stream that has JSON data in it, and that has not
+ *		    been read from with stdio
+ *	filename    filename for error messages, or NULL
+ *	chunk	    maximum length of a chunk, 0 ==> BUFSIZ
+ *	cb	    pointer to the JSON event callbacks, or NULL ==> form a JSON parse tree
+ *	data	    data pointer given to each callback
+ *	is_valid    non-NULL pointer to boolean to set depending on JSON validity
+ *
+ * returns:
+ *	pointer to the JSON parse tree when cb is NULL and the JSON is valid, else NULL
+ *
+ * NOTE: The stream is fclose()d (or, for stdin, clearerr()ed).
+ *
+ * NOTE: This function does not return on NULL is_valid or on malloc error.
+ */
+struct json *
+parse_json_stream_push(FILE *stream, char const *filename, size_t chunk,
+		       struct json_event_cb const *cb, void *data, bool *is_valid)
+{
+    struct jparse_push *ctx = NULL;	/* JSON push parser */
+    char *buf = NULL;			/* chunk read from the stream */
+    ssize_t n = 0;			/* length of the chunk read */
+    bool read_ok = true;		/* false ==> read error */
+
+    /*
+     * firewall
+     */
+    if (is_valid == NULL) {
+	err(17, __func__, "is_valid is NULL");
+	not_reached();
+    }
+    if (stream == NULL) {
+	werr(18, __func__, "stream is NULL");
+	*is_valid = false;
+	return NULL;
+    }
+    if (chunk == 0) {
+	chunk = BUFSIZ;
+    }
+    errno = 0;			/* pre-clear errno for errp() */
+    buf = malloc(chunk);
+    if (buf == NULL) {
+	errp(19, __func__, "malloc of %zu bytes failed", chunk);
+	not_reached();
+    }
+
+    /*
+     * feed each chunk as it is read
+     */
+    ctx = jparse_push_create(filename, cb, data);
+    do {
+	errno = 0;		/* pre-clear errno for werrp() */
+	n = read(fileno(stream), buf, chunk);
+	if (n < 0) {
+	    if (errno == EINTR) {
+		continue;
+	    }
+	    werrp(20, __func__, "error reading stream: %s", filename != NULL ? filename : "-");
+	    read_ok = false;
+	    break;
+	}
+    } while (n != 0 && jparse_push_feed(ctx, buf, (size_t)n));
+
+    /*
+     * end the JSON document
+     */
+    free(buf);
+    buf = NULL;
+    clearerr_or_fclose(stream);
+    if (!read_ok) {
+	ctx->failed = true;
+    }
+    return jparse_push_finish(ctx, is_valid);
+}
+
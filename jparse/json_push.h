@@ -0,0 +1,146 @@
+/*
+ * json_push - incremental (push) JSON parser
+ *
+ * "Because sometimes JSON arrives one drip at a time." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+#if !defined(INCLUDE_JSON_PUSH_H)
+#    define  INCLUDE_JSON_PUSH_H
+
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#else
+  #include <c_bool.h>
+  #include <c_compat.h>
+  #include <dbg.h>
+#endif
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "util.h"
+
+/*
+ * json_parse - JSON parser support code
+ */
+#include "json_parse.h"
+
+/*
+ * json_event - JSON event (SAX style) parser
+ */
+#include "json_event.h"
+
+
+/*
+ * definitions
+ */
+#define JSON_PUSH_TOKEN_CHUNK (64)	/* minimum number of bytes to allocate for a partial token */
+
+/*
+ * kinds of token that may continue into the next chunk
+ */
+enum json_push_kind {
+    JSON_PUSH_NONE = 0,		/* between tokens */
+    JSON_PUSH_STRING,		/* inside a JSON string */
+    JSON_PUSH_NUMBER,		/* inside a run of bytes that starts with a JSON number */
+    JSON_PUSH_LITERAL,		/* inside a run of bytes that starts with a lower case letter */
+    JSON_PUSH_WS,		/* inside whitespace */
+    JSON_PUSH_NL,		/* inside newlines */
+};
+
+/*
+ * JSON push parser
+ *
+ * A JSON push parser is fed a JSON document in chunks of any size, as they
+ * arrive, by jparse_push_feed().  Complete tokens are fed to a JSON event
+ * parser (see json_event.h) as soon as they are scanned so only the token
+ * that is split across two chunks is kept.  The JSON push parser either calls
+ * the given JSON event callbacks or forms the same JSON parse tree as
+ * parse_json() which is returned by jparse_push_finish().
+ */
+struct jparse_push
+{
+    struct json_event_parser ep;	/* JSON event parser the tokens are fed to */
+    struct json_event_cb const *cb;	/* JSON event callbacks, or NULL ==> form a JSON parse tree */
+    void *data;				/* data pointer given to each callback */
+    char const *filename;		/* filename for error messages, or NULL */
+
+    enum json_push_kind kind;		/* kind of the current partial token */
+    bool escape;			/* true ==> previous byte of a JSON string was a \ */
+    char *tok;				/* current (partial) token, NUL terminated */
+    size_t tok_len;			/* length of tok */
+    size_t tok_size;			/* allocated size of tok */
+    char const *text;			/* text of the token being fed to the JSON event parser */
+    size_t text_len;			/* length of text */
+
+    int last_line;			/* location as tracked by YY_USER_ACTION in jparse.l: last line */
+    int last_column;			/* location as tracked by YY_USER_ACTION in jparse.l: last column */
+    int tok_line;			/* location of the current token as reported by jparse.l: line */
+    int tok_column;			/* location of the current token as reported by jparse.l: column */
+
+    struct json **stack;		/* JSON parse tree: open objects and arrays (elements) */
+    struct json **name;			/* JSON parse tree: member name of each open object or NULL */
+    size_t depth;			/* JSON parse tree: number of open objects and arrays */
+    size_t max_depth;			/* JSON parse tree: allocated length of stack and name */
+    struct json *tree;			/* JSON parse tree: root, or NULL */
+
+    bool failed;			/* true ==> JSON is not valid or a callback stopped the parse */
+};
+
+
+/*
+ * external function declarations
+ */
+extern struct jparse_push *jparse_push_create(char const *filename, struct json_event_cb const *cb, void *data);
+extern bool jparse_push_feed(struct jparse_push *ctx, char const *buf, size_t len);
+extern struct json *jparse_push_finish(struct jparse_push *ctx, bool *is_valid);
+extern struct json *parse_json_stream_push(FILE *stream, char const *filename, size_t chunk,
+					   struct json_event_cb const *cb, void *data, bool *is_valid);
+
+#endif /* INCLUDE_JSON_PUSH_H */
@@ -108,7 +108,16 @@ static struct json_sem_val_err sem_val_err_NULL =
 /*
  * static functions
  */
-static void sem_walk(struct json *node, unsigned int depth, va_list ap);
+static void sem_walk(struct json *node, unsigned int depth, void *ctx);
+static uint32_t sem_key_hash(int kind, unsigned int depth, enum item_type type, char const *name);
+static bool sem_key_match(struct json_sem const *sem, int kind, unsigned int depth, enum item_type type,
+			  char const *name);
+static int sem_index_find(struct json_sem_index const *index, int kind, unsigned int depth, enum item_type type,
+			  char const *name);
+static void sem_index_add(struct json_sem_index *index, int kind, int i);
+static struct json_sem_index *sem_index_build(struct json_sem const *sem);
+static int sem_find_linear(unsigned int depth, enum item_type type, char const *name, struct json_sem const *sem);
+static int sem_find(struct json *node, unsigned int depth, struct json_sem *sem, struct json_sem_index const *index);
 
 
 /*
@@ -618,7 +627,7 @@ sem_node_valid(struct json const *node, unsigned int depth, struct json_sem *sem
 		}
 		return false;
 	    }
-	    if (item->s == NULL) {
+	    if (item->s == NULL && node->arena == NULL) {
 		if (val_err != NULL) {
 		    *val_err = werr_sem_val(37, node, depth, sem, name, "JTYPE_OBJECT node: s is NULL");
 		}
@@ -653,7 +662,7 @@ sem_node_valid(struct json const *node, unsigned int depth, struct json_sem *sem
 		}
 		return false;
 	    }
-	    if (item->s == NULL) {
+	    if (item->s == NULL && node->arena == NULL) {
 		if (val_err != NULL) {
 		    *val_err = werr_sem_val(41, node, depth, sem, name, "JTYPE_ARRAY node: s is NULL");
 		}
@@ -688,7 +697,7 @@ sem_node_valid(struct json const *node, unsigned int depth, struct json_sem *sem
 		}
 		return false;
 	    }
-	    if (item->s == NULL) {
+	    if (item->s == NULL && node->arena == NULL) {
 		if (val_err != NULL) {
 		    *val_err = werr_sem_val(45, node, depth, sem, name, "JTYPE_ARRAY node: s is NULL");
 		}
@@ -1258,7 +1267,7 @@ sem_member_value_unsigned(struct json const *node, unsigned int depth, struct js
 		     char const *name, struct json_sem_val_err **val_err)
 {
     struct json *value = NULL;			/* value of JTYPE_MEMBER */
-    struct json_number *unum = NULL;		/* JTYPE_MEMBER value as JTYPE_NUMBER */
+    struct json_number_conv *unum = NULL;	/* JTYPE_MEMBER value as converted JTYPE_NUMBER */
 
     /*
      * obtain JTYPE_MEMBER value
@@ -1282,8 +1291,8 @@ sem_member_value_unsigned(struct json const *node, unsigned int depth, struct js
 	}
 	return NULL;
     }
-    unum = &(value->item.number);
-    if (!VALID_JSON_NODE(unum)) {
+    unum = json_number_conv(value);
+    if (unum == NULL || !VALID_JSON_NODE(unum)) {
 	if (val_err != NULL) {
 	    *val_err = werr_sem_val(67, node, depth, sem, name, "node value JTYPE_NUMBER converted is false");
 	}
@@ -1336,7 +1345,7 @@ sem_member_value_int(struct json const *node, unsigned int depth, struct json_se
 		     char const *name, struct json_sem_val_err **val_err)
 {
     struct json *value = NULL;			/* value of JTYPE_MEMBER */
-    struct json_number *inum = NULL;		/* JTYPE_MEMBER value as JTYPE_NUMBER */
+    struct json_number_conv *inum = NULL;	/* JTYPE_MEMBER value as converted JTYPE_NUMBER */
 
     /*
      * obtain JTYPE_MEMBER value
@@ -1360,8 +1369,8 @@ sem_member_value_int(struct json const *node, unsigned int depth, struct json_se
 	}
 	return NULL;
     }
-    inum = &(value->item.number);
-    if (!VALID_JSON_NODE(inum)) {
+    inum = json_number_conv(value);
+    if (inum == NULL || !VALID_JSON_NODE(inum)) {
 	if (val_err != NULL) {
 	    *val_err = werr_sem_val(70, node, depth, sem, name, "node value JTYPE_NUMBER converted is false");
 	}
@@ -1413,7 +1422,7 @@ sem_member_value_size_t(struct json const *node, unsigned int depth, struct json
 			         char const *name, struct json_sem_val_err **val_err)
 {
     struct json *value = NULL;			/* value of JTYPE_MEMBER */
-    struct json_number *snum = NULL;		/* JTYPE_MEMBER value as JTYPE_NUMBER */
+    struct json_number_conv *snum = NULL;	/* JTYPE_MEMBER value as converted JTYPE_NUMBER */
 
     /*
      * obtain JTYPE_MEMBER value
@@ -1437,8 +1446,8 @@ sem_member_value_size_t(struct json const *node, unsigned int depth, struct json
 	}
 	return NULL;
     }
-    snum = &(value->item.number);
-    if (!VALID_JSON_NODE(snum)) {
+    snum = json_number_conv(value);
+    if (snum == NULL || !VALID_JSON_NODE(snum)) {
 	if (val_err != NULL) {
 	    *val_err = werr_sem_val(73, node, depth, sem, name, "node value JTYPE_NUMBER converted is false");
 	}
@@ -1680,6 +1689,7 @@ sem_object_find_name(struct json const *node, unsigned int depth, struct json_se
 		     char const *memname)
 {
     struct json_object const *item = NULL;	/* JSON member */
+    struct json *s = NULL;			/* JTYPE_MEMBER with the name */
     bool valid = false;				/* true ==> JSON node is converted and valid JTYPE */
     intmax_t i;
 
@@ -1734,13 +1744,33 @@ sem_object_find_name(struct json const *node, unsigned int depth, struct json_se
 	return NULL;
     }
 
+    /*
+     * look the named member up by name first
+     *
+     * NOTE: json_object_get() finds the same member as the search below, in
+     *	     constant time for an object with many members.  The search below
+     *	     is still done when there is no such member, to report the same
+     *	     error as before for an invalid set member.  The lookup may build
+     *	     the index of node, the one change it makes to node.
+     */
+    s = json_object_get((struct json *)node, memname, strlen(memname));
+    if (s != NULL) {
+	valid = sem_node_valid(s, depth+1, sem, name, val_err);
+	if (valid == false) {
+	    /* sem_node_valid() will have set *val_err */
+	    return NULL;
+	}
+	return s;
+    }
+
     /*
      * search the JSON member array for the named member
      */
     for (i=0; i < item->len; ++i) {
-	struct json *s = item->set[i];		/* set member under the JTYPE_OBJECT */
 	char *smemname = NULL;			/* name of set member */
 
+	s = item->set[i];			/* set member under the JTYPE_OBJECT */
+
 	/*
 	 * firewall - validate set member (must be a valid JTYPE_MEMBER with non-NULL
 	 */
@@ -1932,54 +1962,215 @@ json_sem_count_chk(struct json_sem *sem, struct dyn_array *count_err)
 
 
 /*
- * json_sem_find - given JSON node, find first match in JSON semantic table
+ * sem_key_hash - hash a key of the index of a JSON semantic table
+ *
+ * given:
+ *	kind		JSON_SEM_KEY_ANY, JSON_SEM_KEY_WILD or JSON_SEM_KEY_NAME
+ *	depth		JSON parse tree node depth
+ *	type		type of JSON node
+ *	name		if kind == JSON_SEM_KEY_NAME, decoded member name, else NULL
+ *
+ * returns:
+ *	hash of the key
+ */
+static uint32_t
+sem_key_hash(int kind, unsigned int depth, enum item_type type, char const *name)
+{
+    uint32_t hash;		/* hash of the key */
+
+    /*
+     * hash the name, if any, and mix in the rest of the key
+     */
+    hash = json_object_hash(name, name == NULL ? 0 : strlen(name));
+    hash = (hash ^ (uint32_t)kind) * (uint32_t)16777619U;
+    hash = (hash ^ (uint32_t)depth) * (uint32_t)16777619U;
+    hash = (hash ^ (uint32_t)type) * (uint32_t)16777619U;
+    return hash;
+}
+
+
+/*
+ * sem_key_match - determine if a JSON semantic table entry matches a key
+ *
+ * given:
+ *	sem		pointer to a JSON semantic table entry
+ *	kind		JSON_SEM_KEY_ANY, JSON_SEM_KEY_WILD or JSON_SEM_KEY_NAME
+ *	depth		JSON parse tree node depth
+ *	type		type of JSON node
+ *	name		if kind == JSON_SEM_KEY_NAME, decoded member name, else NULL
+ *
+ * returns:
+ *	true ==> the entry matches the key in the same way as in sem_find_linear()
+ *	false ==> the entry does not match the key
+ */
+static bool
+sem_key_match(struct json_sem const *sem, int kind, unsigned int depth, enum item_type type, char const *name)
+{
+    if (sem->depth != depth || sem->type != type) {
+	return false;
+    }
+    switch (kind) {
+    case JSON_SEM_KEY_ANY:
+	return true;
+    case JSON_SEM_KEY_WILD:
+	return sem->name_len == 0;
+    case JSON_SEM_KEY_NAME:
+	return sem->type == JTYPE_MEMBER && sem->name_len > 0 && sem->name != NULL && name != NULL &&
+	       strcmp(name, sem->name) == 0;
+    default:
+	break;
+    }
+    return false;
+}
+
+
+/*
+ * sem_index_find - find a key in the index of a JSON semantic table
+ *
+ * given:
+ *	index		index of a JSON semantic table
+ *	kind		JSON_SEM_KEY_ANY, JSON_SEM_KEY_WILD or JSON_SEM_KEY_NAME
+ *	depth		JSON parse tree node depth
+ *	type		type of JSON node
+ *	name		if kind == JSON_SEM_KEY_NAME, decoded member name, else NULL
+ *
+ * returns:
+ *	>=0 ==> index of the first entry of the table that matches the key
+ *	-1  ==> no entry of the table matches the key
+ */
+static int
+sem_index_find(struct json_sem_index const *index, int kind, unsigned int depth, enum item_type type,
+	       char const *name)
+{
+    struct json_sem_slot const *slot = NULL;	/* slot being probed */
+    uint32_t hash;				/* hash of the key */
+    size_t i;
+
+    hash = sem_key_hash(kind, depth, type, name);
+    for (i = (size_t)hash & (index->size - 1); index->slot[i].sem_index >= 0; i = (i + 1) & (index->size - 1)) {
+	slot = &index->slot[i];
+	if (slot->hash == hash && slot->kind == kind &&
+	    sem_key_match(&index->sem[slot->sem_index], kind, depth, type, name)) {
+	    return slot->sem_index;
+	}
+    }
+    return -1;
+}
+
+
+/*
+ * sem_index_add - add a JSON semantic table entry to the index of the table
+ *
+ * The entries must be added in table order: an entry is not added if an
+ * earlier entry already has the same key, so that the index finds the first
+ * matching entry as sem_find_linear() does.
+ *
+ * given:
+ *	index		index of a JSON semantic table with room for the key
+ *	kind		JSON_SEM_KEY_ANY, JSON_SEM_KEY_WILD or JSON_SEM_KEY_NAME
+ *	i		index of the entry in the table
+ */
+static void
+sem_index_add(struct json_sem_index *index, int kind, int i)
+{
+    struct json_sem const *sem = &index->sem[i];	/* entry to add */
+    char const *name = kind == JSON_SEM_KEY_NAME ? sem->name : NULL;	/* name of the key or NULL */
+    uint32_t hash;					/* hash of the key */
+    size_t j;
+
+    /*
+     * do nothing if an earlier entry has the same key
+     */
+    if (sem_index_find(index, kind, sem->depth, sem->type, name) >= 0) {
+	return;
+    }
+
+    /*
+     * use the first empty slot from where the key hashes
+     */
+    hash = sem_key_hash(kind, sem->depth, sem->type, name);
+    for (j = (size_t)hash & (index->size - 1); index->slot[j].sem_index >= 0; j = (j + 1) & (index->size - 1)) {
+	/* slot in use */
+    }
+    index->slot[j].hash = hash;
+    index->slot[j].kind = kind;
+    index->slot[j].sem_index = i;
+    return;
+}
+
+
+/*
+ * sem_index_build - build the index of a JSON semantic table
  *
  * given:
- *	node		pointer to a JSON parse tree
- *	depth		depth of node in the JSON parse tree (0 ==> tree root)
  *	sem		pointer to a JSON semantic table (ends with a JTYPE_UNSET JSON type)
  *
  * returns:
- *	>=0 ==> index into JSON semantic table for first match
- *	-1  ==> no JSON semantic table match found
- *	< -1 ==> invalid JSON node, or NULL ptr, or internal error
+ *	calloc()ed index of the table, or NULL on calloc failure
  */
-int
-json_sem_find(struct json *node, unsigned int depth, struct json_sem *sem)
+static struct json_sem_index *
+sem_index_build(struct json_sem const *sem)
 {
-    bool test = false;		/* JSON node test result */
-    char *name = NULL;		/* name of JTYPE_MEMBER node or NULL */
-    enum item_type type;	/* type of JSON node */
+    struct json_sem_index *index = NULL;	/* index being built */
+    size_t size = JSON_SEM_INDEX_MIN;		/* number of slots */
     int i;
 
     /*
-     * firewall - args
+     * each entry has at most 2 keys, keep the index at most half full
      */
-    if (node == NULL) {
-	warn(__func__, "node is NULL");
-	return -2;
+    for (i=0; sem[i].type != JTYPE_UNSET; ++i) {
+	/* count entries */
     }
-    if (sem == NULL) {
-	warn(__func__, "sem is NULL");
-	return -3;
+    while (size < (size_t)i * 4) {
+	size *= 2;
     }
 
     /*
-     * obtain information about the JSON node
+     * allocate an empty index
      */
-    type = node->type;
-    if (type == JTYPE_MEMBER) {
-        /* sem_member_name_decoded_str() call checks args via sem_chk_null_args() */
-	/* sem_member_name_decoded_str() also calls sem_node_valid() */
-	/* determine name of JTYPE_MEMBER or return NULL */
-	name = sem_member_name_decoded_str(node, depth, sem, __func__, NULL);
-    } else {
-	test = sem_node_valid(node, depth, sem, __func__, NULL);
-	if (test == false) {
-	    warn(__func__, "JSON node is invalid");
-	    return -4;
+    index = calloc(1, sizeof(*index) + size * sizeof(index->slot[0]));
+    if (index == NULL) {
+	warn(__func__, "calloc of JSON semantic table index of %zu slots failed", size);
+	return NULL;
+    }
+    index->sem = sem;
+    index->size = size;
+    for (i=0; (size_t)i < size; ++i) {
+	index->slot[i].sem_index = -1;
+    }
+
+    /*
+     * index the entries in table order
+     */
+    for (i=0; sem[i].type != JTYPE_UNSET; ++i) {
+	sem_index_add(index, JSON_SEM_KEY_ANY, i);
+	if (sem[i].name_len == 0) {
+	    sem_index_add(index, JSON_SEM_KEY_WILD, i);
+	} else if (sem[i].type == JTYPE_MEMBER && sem[i].name != NULL) {
+	    sem_index_add(index, JSON_SEM_KEY_NAME, i);
 	}
     }
+    return index;
+}
+
+
+/*
+ * sem_find_linear - find the first match of a JSON node by scanning a JSON semantic table
+ *
+ * given:
+ *	depth		depth of the JSON node in the JSON parse tree (0 ==> tree root)
+ *	type		type of the JSON node
+ *	name		decoded name if the JSON node is a JTYPE_MEMBER or NULL
+ *	sem		pointer to a JSON semantic table (ends with a JTYPE_UNSET JSON type)
+ *
+ * returns:
+ *	>=0 ==> index into JSON semantic table for first match
+ *	-1  ==> no JSON semantic table match found
+ */
+static int
+sem_find_linear(unsigned int depth, enum item_type type, char const *name, struct json_sem const *sem)
+{
+    int i;
 
     /*
      * search the JSON semantic table
@@ -2022,15 +2213,122 @@ json_sem_find(struct json *node, unsigned int depth, struct json_sem *sem)
 }
 
 
+/*
+ * json_sem_find - given JSON node, find first match in JSON semantic table
+ *
+ * The table is scanned in order.  json_sem_check() finds the same match
+ * through an index of the table by depth, type and member name, which it
+ * builds once for the tree it checks: see sem_find().
+ *
+ * given:
+ *	node		pointer to a JSON parse tree
+ *	depth		depth of node in the JSON parse tree (0 ==> tree root)
+ *	sem		pointer to a JSON semantic table (ends with a JTYPE_UNSET JSON type)
+ *
+ * returns:
+ *	>=0 ==> index into JSON semantic table for first match
+ *	-1  ==> no JSON semantic table match found
+ *	< -1 ==> invalid JSON node, or NULL ptr, or internal error
+ */
+int
+json_sem_find(struct json *node, unsigned int depth, struct json_sem *sem)
+{
+    return sem_find(node, depth, sem, NULL);
+}
+
+
+/*
+ * sem_find - given JSON node, find first match in JSON semantic table or its index
+ *
+ * given:
+ *	node		pointer to a JSON parse tree
+ *	depth		depth of node in the JSON parse tree (0 ==> tree root)
+ *	sem		pointer to a JSON semantic table (ends with a JTYPE_UNSET JSON type)
+ *	index		index of sem built by sem_index_build(), or NULL ==> scan sem
+ *
+ * returns:
+ *	>=0 ==> index into JSON semantic table for first match
+ *	-1  ==> no JSON semantic table match found
+ *	< -1 ==> invalid JSON node, or NULL ptr, or internal error
+ */
+static int
+sem_find(struct json *node, unsigned int depth, struct json_sem *sem, struct json_sem_index const *index)
+{
+    bool test = false;		/* JSON node test result */
+    char *name = NULL;		/* name of JTYPE_MEMBER node or NULL */
+    enum item_type type;	/* type of JSON node */
+    int named = -1;		/* first entry with the name of the JTYPE_MEMBER or -1 */
+    int wild = -1;		/* first JTYPE_MEMBER entry with no name or -1 */
+
+    /*
+     * firewall - args
+     */
+    if (node == NULL) {
+	warn(__func__, "node is NULL");
+	return -2;
+    }
+    if (sem == NULL) {
+	warn(__func__, "sem is NULL");
+	return -3;
+    }
+
+    /*
+     * obtain information about the JSON node
+     */
+    type = node->type;
+    if (type == JTYPE_MEMBER) {
+        /* sem_member_name_decoded_str() call checks args via sem_chk_null_args() */
+	/* sem_member_name_decoded_str() also calls sem_node_valid() */
+	/* determine name of JTYPE_MEMBER or return NULL */
+	name = sem_member_name_decoded_str(node, depth, sem, __func__, NULL);
+    } else {
+	test = sem_node_valid(node, depth, sem, __func__, NULL);
+	if (test == false) {
+	    warn(__func__, "JSON node is invalid");
+	    return -4;
+	}
+    }
+
+    /*
+     * case: no index of the JSON semantic table - scan the table
+     */
+    if (index == NULL || index->sem != sem) {
+	return sem_find_linear(depth, type, name, sem);
+    }
+
+    /*
+     * case: non-JTYPE_MEMBER or JTYPE_MEMBER w/o name - first entry of the depth and type
+     */
+    if (type != JTYPE_MEMBER || name == NULL) {
+	return sem_index_find(index, JSON_SEM_KEY_ANY, depth, type, NULL);
+    }
+
+    /*
+     * case: JTYPE_MEMBER - first entry with the name or with no name
+     */
+    named = sem_index_find(index, JSON_SEM_KEY_NAME, depth, type, name);
+    wild = sem_index_find(index, JSON_SEM_KEY_WILD, depth, type, NULL);
+    if (named < 0) {
+	return wild;
+    } else if (wild < 0 || named < wild) {
+	return named;
+    }
+    return wild;
+}
+
+
+
 /*
  * sem_walk - JSON parse tree semantic tree check walk
  *
  * given:
  *	node	pointer to a JSON parser tree node to free
  *	depth	current tree depth (0 ==> top of tree)
- *	ap	variable argument list, required ap args:
+ *	ctx	pointer to a struct json_sem_walk:
  *
  *		sem		JSON semantic table (ends with a JTYPE_UNSET JSON type)
+ *		find		function that finds the first match of a node in sem
+ *		index		index of sem used in place of find, or NULL
  *		count_err	dynamic array of JSON semantic count errors
  *		val_err		dynamic array of JSON semantic validation errors
  *
@@ -2039,9 +2337,9 @@ json_sem_find(struct json *node, unsigned int depth, struct json_sem *sem)
  * NOTE: This function does nothing if the node type is invalid.
  */
 static void
-sem_walk(struct json *node, unsigned int depth, va_list ap)
+sem_walk(struct json *node, unsigned int depth, void *ctx)
 {
-    va_list ap2;			/* copy of va_list ap */
+    struct json_sem_walk *walk = ctx;	/* semantic table and error arrays */
     struct json_sem *sem = NULL;	/* JSON semantic table (ends with a JTYPE_UNSET JSON type) */
     struct dyn_array *count_err = NULL;	/* dynamic array of JSON semantic count errors */
     struct dyn_array *val_err = NULL;	/* dynamic array of JSON semantic validation errors */
@@ -2053,38 +2351,37 @@ sem_walk(struct json *node, unsigned int depth, va_list ap)
     /*
      * firewall - nothing to do for a NULL node
      */
-    if (node == NULL) {
+    if (node == NULL || walk == NULL) {
 	return;
     }
 
     /*
-     * duplicate va_list ap
+     * obtain the semantic table and error arrays
      */
-    va_copy(ap2, ap);
-
-    /*
-     * obtain the stream, json_dbg_used, and json_dbg args
-     */
-    sem = va_arg(ap2, struct json_sem *);
+    sem = walk->sem;
     if (sem == NULL) {
-	va_end(ap2); /* stdarg variable argument list cleanup */
 	return;
     }
-    count_err = va_arg(ap2, struct dyn_array *);
+    count_err = walk->count_err;
     if (count_err == NULL) {
-	va_end(ap2); /* stdarg variable argument list cleanup */
 	return;
     }
-    val_err = va_arg(ap2, struct dyn_array *);
+    val_err = walk->val_err;
     if (val_err == NULL) {
-	va_end(ap2); /* stdarg variable argument list cleanup */
+	return;
+    }
+    if (walk->find == NULL) {
 	return;
     }
 
     /*
-     * search for node match in the semantic table
+     * search for node match in the semantic table, through its index if we have one
      */
-    index = json_sem_find(node, depth, sem);
+    if (walk->index != NULL) {
+	index = sem_find(node, depth, sem, walk->index);
+    } else {
+	index = walk->find(node, depth, sem);
+    }
 
     /*
      * process search result
@@ -2201,11 +2498,6 @@ sem_walk(struct json *node, unsigned int depth, va_list ap)
 	/* save semantic count error */
 	dyn_array_append_value(count_err, &count);
     }
-
-    /*
-     * stdarg variable argument list cleanup
-     */
-    va_end(ap2);
     return;
 }
 
@@ -2264,9 +2556,42 @@ sem_walk(struct json *node, unsigned int depth, va_list ap)
 uintmax_t
 json_sem_check(struct json *node, unsigned int max_depth, struct json_sem *sem,
 	       struct dyn_array **pcount_err, struct dyn_array **pval_err, void *data)
+{
+    return json_sem_check_find(node, max_depth, sem, json_sem_find, pcount_err, pval_err, data);
+}
+
+
+/*
+ * json_sem_check_find - check a JSON parse tree against a JSON semantic table with a given matcher
+ *
+ * This is json_sem_check() with the function that finds the first match of
+ * each JSON node in the JSON semantic table given: typically a compiled
+ * matcher printed by jsemtblgen -C for the table, in place of json_sem_find().
+ *
+ * given:
+ *	node		pointer to a JSON parse tree
+ *	max_depth	maximum tree depth to descend, or 0 ==> infinite depth
+ *	sem		pointer to a JSON semantic table (ends with a JTYPE_UNSET JSON type)
+ *	find		function returning what json_sem_find() returns for sem,
+ *			    or NULL ==> use json_sem_find()
+ *	pcount_err	pointer to dynamic array of JSON semantic count errors
+ *	pval_err	pointer to dynamic array of JSON semantic validation errors
+ *	data		a void * of extra data in case one needs it, or NULL
+ *
+ * return:
+ *	0 ==> JSON parse tree is semantically consistent with the JSON semantic table,
+ *	> 0  ==> number of errors (count+validation+internal) found
+ *
+ * NOTE: See json_sem_check() for details.
+ */
+uintmax_t
+json_sem_check_find(struct json *node, unsigned int max_depth, struct json_sem *sem,
+		    int (*find)(struct json *node, unsigned int depth, struct json_sem *sem),
+		    struct dyn_array **pcount_err, struct dyn_array **pval_err, void *data)
 {
     struct dyn_array *count_err = NULL;		/* JSON semantic count errors */
     struct dyn_array *val_err = NULL;		/* JSON semantic validation errors */
+    struct json_sem_walk walk;			/* sem_walk() context */
     uintmax_t errors = 0;			/* number of errors (count+validation+internal) */
 
     /*
@@ -2346,7 +2671,20 @@ json_sem_check(struct json *node, unsigned int max_depth, struct json_sem *sem,
     /*
      * perform a semantic scan of the JSON parse tree
      */
-    json_tree_walk(node, max_depth, 0, true, sem_walk, sem, count_err, val_err);
+    walk.sem = sem;
+    walk.find = find != NULL ? find : json_sem_find;
+    walk.index = NULL;
+    if (walk.find == json_sem_find) {
+	/* index the table for this check only: NULL ==> scan the table */
+	walk.index = sem_index_build(sem);
+    }
+    walk.count_err = count_err;
+    walk.val_err = val_err;
+    json_tree_walk_ctx(node, max_depth, 0, true, sem_walk, &walk);
+    if (walk.index != NULL) {
+	free(walk.index);
+	walk.index = NULL;
+    }
 
     /*
      * check semantic table counts
@@ -82,6 +82,14 @@
  */
 #define INF (0)			/* special max value for no limit */
 #define INF_DEPTH (UINT_MAX)	/* no depth */
+#define JSON_SEM_INDEX_MIN (16)	/* minimum number of slots in a JSON semantic table index */
+
+/*
+ * kinds of keys in the index of a JSON semantic table
+ */
+#define JSON_SEM_KEY_ANY (0)	/* first entry with a given depth and type */
+#define JSON_SEM_KEY_WILD (1)	/* first entry with a given depth and type that has no name */
+#define JSON_SEM_KEY_NAME (2)	/* first JTYPE_MEMBER entry with a given depth and name */
 
 
  /*
@@ -140,6 +148,48 @@ struct json_sem
     void *data;                 /* extra data if needed */
 };
 
+/*
+ * index of a JSON semantic table - see sem_find()
+ *
+ * json_sem_check() builds the index of the table it checks a tree against,
+ * and keeps it in the struct json_sem_walk of that call only, so there is no
+ * state shared between calls.  The index must find what json_sem_find()
+ * returns: the first entry of the table that matches a JSON node.  For that,
+ * the index has a slot for the first entry of each
+ * depth and type (JSON_SEM_KEY_ANY), a slot for the first entry of each depth
+ * and type that matches any member name (JSON_SEM_KEY_WILD), and a slot for
+ * the first JTYPE_MEMBER entry of each depth and member name (JSON_SEM_KEY_NAME).
+ * The slots are found by hashing the kind, depth, type and name of the key
+ * with linear probing, and the entry a slot refers to is compared to the key
+ * because different keys can have the same hash.
+ */
+struct json_sem_slot
+{
+    uint32_t hash;		/* hash of the key - see sem_key_hash() */
+    int kind;			/* JSON_SEM_KEY_ANY, JSON_SEM_KEY_WILD or JSON_SEM_KEY_NAME */
+    int sem_index;		/* index of the first matching entry in the table or -1 ==> empty slot */
+};
+
+struct json_sem_index
+{
+    struct json_sem const *sem;	/* JSON semantic table that was indexed */
+    size_t size;		/* number of slots, a power of 2 */
+    struct json_sem_slot slot[];	/* slots of the index */
+};
+
+/*
+ * json_sem_check() tree walk context - see sem_walk()
+ */
+struct json_sem_walk
+{
+    struct json_sem *sem;		/* JSON semantic table (ends with a JTYPE_UNSET JSON type) */
+    int (*find)(struct json *node, unsigned int depth, struct json_sem *sem);
+					/* finds the first match of a node in sem - see json_sem_find() */
+    struct json_sem_index *index;	/* index of sem used in place of find, or NULL */
+    struct dyn_array *count_err;	/* dynamic array of JSON semantic count errors */
+    struct dyn_array *val_err;		/* dynamic array of JSON semantic validation errors */
+};
+
 
 /*
  * str_or_null - report if a JSON JTYPE_MEMBER value is a valid JSON_STRING or a valid JSON_NULL
@@ -201,6 +251,9 @@ extern int json_sem_find(struct json *node, unsigned int depth, struct json_sem
 extern void json_sem_count_chk(struct json_sem *sem, struct dyn_array *count_err);
 extern uintmax_t json_sem_check(struct json *node, unsigned int max_depth, struct json_sem *sem,
 				struct dyn_array **pcount_err, struct dyn_array **pval_err, void *data);
+extern uintmax_t json_sem_check_find(struct json *node, unsigned int max_depth, struct json_sem *sem,
+				     int (*find)(struct json *node, unsigned int depth, struct json_sem *sem),
+				     struct dyn_array **pcount_err, struct dyn_array **pval_err, void *data);
 extern void free_count_err(struct dyn_array *count_err);
 extern void free_val_err(struct dyn_array *val_err);
 extern void fprint_count_err(FILE *stream, char const *prefix, struct json_sem_count_err *sem_count_err, char const *postfix);
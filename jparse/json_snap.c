@@ -0,0 +1,925 @@
+/*
+ * json_snap - binary snapshot of a JSON parse tree
+ *
+ * "Because the fastest JSON to parse is JSON that was already parsed." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+/*
+ * jparse - JSON parser
+ */
+#include "jparse.h"
+
+/*
+ * json_snap - binary snapshot of a JSON parse tree
+ */
+#include "json_snap.h"
+
+
+/*
+ * definitions
+ */
+#define SNAP_VALUE_LEN (sizeof(long double) > sizeof(uintmax_t) ? sizeof(long double) : sizeof(uintmax_t))
+#define SNAP_CHUNK (1024)	/* nodes (or pool bytes) to add to a dynamic array at a time */
+
+
+/*
+ * static functions
+ */
+static size_t snap_str_len(uintmax_t as_str_len, bool quote);
+static void snap_pool_add(struct dyn_array *pool, char const *str, size_t len, uint64_t *off);
+static void snap_set_kids(struct json_snap_node *snap, struct json * const *set, intmax_t len,
+			  struct dyn_array *queue, uint64_t num);
+static bool snap_valid_str(struct json_snap_hdr const *hdr, char const *pool, uint64_t off, uint64_t len);
+static bool snap_valid(char const *filename, char const *map, size_t size);
+static void snap_fill(struct json *nodes, struct json_snap_node const *snap, uint64_t num, char const *pool,
+		      struct json **set);
+
+
+/*
+ * snap_str_len - length of the as_str of a JSON string
+ *
+ * The as_str_len of a JSON string parsed with its surrounding '"'s counts the
+ * '"'s, which are not in as_str.
+ *
+ * given:
+ *	as_str_len  as_str_len of the JSON string
+ *	quote	    quote of the JSON string
+ *
+ * return:
+ *	number of bytes in as_str, w/o the NUL terminator
+ */
+static size_t
+snap_str_len(uintmax_t as_str_len, bool quote)
+{
+    if (quote && as_str_len >= 2) {
+	return (size_t)(as_str_len - 2);
+    }
+    return (size_t)as_str_len;
+}
+
+
+/*
+ * snap_pool_add - add a NUL terminated string to the string pool of a snapshot
+ *
+ * given:
+ *	pool	    dynamic array of the string pool
+ *	str	    string to add
+ *	len	    length of str
+ *	off	    pointer to set to the pool offset of the string
+ *
+ * NOTE: This function does not return on NULL pointers.
+ */
+static void
+snap_pool_add(struct dyn_array *pool, char const *str, size_t len, uint64_t *off)
+{
+    char nul = '\0';		/* NUL byte that terminates the string */
+
+    /*
+     * firewall
+     */
+    if (pool == NULL || off == NULL) {
+	err(10, __func__, "pool and/or off is NULL");
+	not_reached();
+    }
+
+    /*
+     * a NULL string is written as the empty string
+     */
+    *off = (uint64_t)dyn_array_tell(pool);
+    if (str != NULL && len > 0) {
+	(void) dyn_array_append_set(pool, (void *)str, (intmax_t)len);
+    }
+    (void) dyn_array_append_value(pool, &nul);
+    return;
+}
+
+
+/*
+ * snap_set_kids - queue the children of a JSON parse tree node
+ *
+ * As the nodes are written in breadth-first order, the children of the node
+ * are written as consecutive nodes, starting at the current end of the queue.
+ *
+ * given:
+ *	snap	    snapshot node of the parent
+ *	set	    children of the parent
+ *	len	    number of children of the parent
+ *	queue	    dynamic array of the nodes to write
+ *	num	    node number of the parent
+ *
+ * NOTE: This function does not return on NULL pointers or a NULL child.
+ */
+static void
+snap_set_kids(struct json_snap_node *snap, struct json * const *set, intmax_t len,
+	      struct dyn_array *queue, uint64_t num)
+{
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (snap == NULL || queue == NULL) {
+	err(11, __func__, "snap and/or queue is NULL");
+	not_reached();
+    }
+    if (len < 0 || (len > 0 && set == NULL)) {
+	err(12, __func__, "node %ju has a set of %jd children that is NULL", (uintmax_t)num, len);
+	not_reached();
+    }
+
+    /*
+     * queue the children
+     */
+    snap->first = (uint64_t)dyn_array_tell(queue);
+    snap->len = (uint64_t)len;
+    for (i = 0; i < len; ++i) {
+	if (set[i] == NULL) {
+	    err(13, __func__, "child %jd of node %ju is NULL", i, (uintmax_t)num);
+	    not_reached();
+	}
+	(void) dyn_array_append_value(queue, (void *)&set[i]);
+    }
+    return;
+}
+
+
+/*
+ * json_snap_write - write a binary snapshot of a JSON parse tree
+ *
+ * The snapshot can be loaded by json_snap_load(), on this machine, into a JSON
+ * parse tree that is the same as tree.  See json_snap.h for the format.
+ *
+ * The snapshot is written to a temporary file that is then renamed to filename
+ * (see tmp_file_open()), so that a process loading the snapshot at the same
+ * time never maps a partial one.
+ *
+ * given:
+ *	tree	    JSON parse tree to write
+ *	filename    snapshot file to write (replaced if it exists)
+ *
+ * return:
+ *	true ==> snapshot written, false ==> snapshot not written
+ *
+ * NOTE: This function does not return on NULL pointers or on a malformed JSON
+ *	 parse tree, and only warns on an I/O error.
+ */
+bool
+json_snap_write(struct json const *tree, char const *filename)
+{
+    struct json_snap_hdr hdr;			/* snapshot header */
+    struct json_snap_node snap;			/* snapshot node being formed */
+    struct dyn_array *queue = NULL;		/* JSON parse tree nodes in breadth-first order */
+    struct dyn_array *nodes = NULL;		/* snapshot nodes in breadth-first order */
+    struct dyn_array *pool = NULL;		/* string pool */
+    struct json const *node = NULL;		/* JSON parse tree node being written */
+    FILE *stream = NULL;			/* open temporary snapshot file */
+    char *tmpname = NULL;			/* name of the temporary snapshot file */
+    bool ret = true;				/* return value */
+    intmax_t num;				/* node number of node */
+
+    /*
+     * firewall
+     */
+    if (tree == NULL || filename == NULL) {
+	err(14, __func__, "tree and/or filename is NULL");
+	not_reached();
+    }
+    if (SNAP_VALUE_LEN > JSON_SNAP_VALUE_SIZE) {
+	warn(__func__, "JSON number values of %zu bytes do not fit in a snapshot", (size_t)SNAP_VALUE_LEN);
+	return false;
+    }
+
+    /*
+     * form the snapshot nodes and string pool, breadth-first
+     */
+    queue = dyn_array_create(sizeof(struct json const *), SNAP_CHUNK, SNAP_CHUNK, false);
+    nodes = dyn_array_create(sizeof(struct json_snap_node), SNAP_CHUNK, SNAP_CHUNK, true);
+    pool = dyn_array_create(sizeof(char), SNAP_CHUNK*JSON_SNAP_VALUE_SIZE, SNAP_CHUNK*JSON_SNAP_VALUE_SIZE, false);
+    (void) dyn_array_append_value(queue, (void *)&tree);
+    for (num = 0; num < dyn_array_tell(queue); ++num) {
+	node = dyn_array_value(queue, struct json const *, num);
+
+	memset(&snap, 0, sizeof(snap));
+	snap.type = (uint32_t)node->type;
+	snap.parent = JSON_SNAP_NONE;	/* see below */
+	switch (node->type) {
+
+	case JTYPE_NUMBER:
+	    {
+		struct json_number const *item = &(node->item.number);
+
+		snap.flags = (item->parsed ? JSON_SNAP_PARSED : 0) |
+			     (item->converted ? JSON_SNAP_CONVERTED : 0) |
+			     (item->is_negative ? JSON_SNAP_NEGATIVE : 0) |
+			     (item->is_floating ? JSON_SNAP_FLOATING : 0) |
+			     (item->is_e_notation ? JSON_SNAP_E_NOTATION : 0) |
+			     (item->is_integer ? JSON_SNAP_INTEGER : 0) |
+			     (item->maxint_sized ? JSON_SNAP_MAXINT : 0) |
+			     (item->umaxint_sized ? JSON_SNAP_UMAXINT : 0) |
+			     (item->longdouble_sized ? JSON_SNAP_LONGDOUBLE : 0) |
+			     (item->as_longdouble_int ? JSON_SNAP_LONGDOUBLE_INT : 0);
+		snap_pool_add(pool, item->as_str, item->as_str_len, &snap.as_str);
+		snap.as_str_len = item->as_str_len;
+		if (item->as_str != NULL && item->first >= item->as_str && item->first <= item->as_str + item->as_str_len) {
+		    snap.str = (uint64_t)(item->first - item->as_str);
+		}
+		snap.str_len = (item->number_len <= item->as_str_len - snap.str) ? item->number_len : 0;
+		memcpy(snap.value, &(item->as_maxint), SNAP_VALUE_LEN);
+	    }
+	    break;
+
+	case JTYPE_STRING:
+	    {
+		struct json_string const *item = &(node->item.string);
+
+		snap.flags = (item->parsed ? JSON_SNAP_PARSED : 0) |
+			     (item->converted ? JSON_SNAP_CONVERTED : 0) |
+			     (item->quote ? JSON_SNAP_QUOTE : 0) |
+			     (item->same ? JSON_SNAP_SAME : 0) |
+			     (item->slash ? JSON_SNAP_SLASH : 0) |
+			     (item->posix_safe ? JSON_SNAP_POSIX_SAFE : 0) |
+			     (item->first_alphanum ? JSON_SNAP_FIRST_ALPHANUM : 0) |
+			     (item->upper ? JSON_SNAP_UPPER : 0) |
+			     (item->posix_chked ? JSON_SNAP_POSIX_CHKED : 0);
+		/*
+		 * NOTE: as_str_len counts the surrounding '"'s that are not in as_str
+		 */
+		snap_pool_add(pool, item->as_str, snap_str_len(item->as_str_len, item->quote), &snap.as_str);
+		snap.as_str_len = item->as_str_len;
+		/*
+		 * a str that is as_str is written once
+		 */
+		if (item->str == item->as_str && item->str_len == snap_str_len(item->as_str_len, item->quote)) {
+		    snap.str = snap.as_str;
+		} else {
+		    snap_pool_add(pool, item->str, item->str_len, &snap.str);
+		}
+		snap.str_len = item->str_len;
+	    }
+	    break;
+
+	case JTYPE_BOOL:
+	    snap.flags = (node->item.boolean.parsed ? JSON_SNAP_PARSED : 0) |
+			 (node->item.boolean.converted ? JSON_SNAP_CONVERTED : 0) |
+			 (node->item.boolean.value ? JSON_SNAP_VALUE : 0);
+	    snap_pool_add(pool, node->item.boolean.as_str, node->item.boolean.as_str_len, &snap.as_str);
+	    snap.as_str_len = node->item.boolean.as_str_len;
+	    break;
+
+	case JTYPE_NULL:
+	    snap.flags = (node->item.null.parsed ? JSON_SNAP_PARSED : 0) |
+			 (node->item.null.converted ? JSON_SNAP_CONVERTED : 0);
+	    snap_pool_add(pool, node->item.null.as_str, node->item.null.as_str_len, &snap.as_str);
+	    snap.as_str_len = node->item.null.as_str_len;
+	    break;
+
+	case JTYPE_MEMBER:
+	    {
+		struct json *kids[2];	/* name and value of the member */
+
+		if (node->item.member.name == NULL || node->item.member.name->type != JTYPE_STRING) {
+		    err(15, __func__, "member node %jd has no JSON string name", num);
+		    not_reached();
+		}
+		snap.flags = (node->item.member.parsed ? JSON_SNAP_PARSED : 0) |
+			     (node->item.member.converted ? JSON_SNAP_CONVERTED : 0);
+		kids[0] = node->item.member.name;
+		kids[1] = node->item.member.value;
+		snap_set_kids(&snap, kids, 2, queue, (uint64_t)num);
+	    }
+	    break;
+
+	case JTYPE_OBJECT:
+	    snap.flags = (node->item.object.parsed ? JSON_SNAP_PARSED : 0) |
+			 (node->item.object.converted ? JSON_SNAP_CONVERTED : 0);
+	    snap_set_kids(&snap, node->item.object.set, node->item.object.len, queue, (uint64_t)num);
+	    break;
+
+	case JTYPE_ARRAY:
+	    snap.flags = (node->item.array.parsed ? JSON_SNAP_PARSED : 0) |
+			 (node->item.array.converted ? JSON_SNAP_CONVERTED : 0);
+	    snap_set_kids(&snap, node->item.array.set, node->item.array.len, queue, (uint64_t)num);
+	    break;
+
+	case JTYPE_ELEMENTS:
+	    snap.flags = (node->item.elements.parsed ? JSON_SNAP_PARSED : 0) |
+			 (node->item.elements.converted ? JSON_SNAP_CONVERTED : 0);
+	    snap_set_kids(&snap, node->item.elements.set, node->item.elements.len, queue, (uint64_t)num);
+	    break;
+
+	default:
+	    err(16, __func__, "node %jd has invalid type: %d", num, (int)node->type);
+	    not_reached();
+	    break;
+	}
+	(void) dyn_array_append_value(nodes, &snap);
+    }
+
+    /*
+     * link each child to its parent
+     */
+    for (num = 0; num < dyn_array_tell(nodes); ++num) {
+	struct json_snap_node const *parent = dyn_array_addr(nodes, struct json_snap_node, num);
+	uint64_t kid;
+
+	for (kid = parent->first; kid < parent->first + parent->len; ++kid) {
+	    dyn_array_addr(nodes, struct json_snap_node, kid)->parent = (uint64_t)num;
+	}
+    }
+
+    /*
+     * form the header
+     */
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, JSON_SNAP_MAGIC, JSON_SNAP_MAGIC_LEN);
+    hdr.version = JSON_SNAP_VERSION;
+    hdr.endian = JSON_SNAP_ENDIAN;
+    hdr.node_size = (uint32_t)sizeof(struct json_snap_node);
+    hdr.ldbl_size = (uint32_t)sizeof(long double);
+    hdr.nodes = (uint64_t)dyn_array_tell(nodes);
+    hdr.node_off = (uint64_t)sizeof(hdr);
+    hdr.pool_len = (uint64_t)dyn_array_tell(pool);
+    hdr.pool_off = hdr.node_off + hdr.nodes * sizeof(struct json_snap_node);
+    hdr.file_len = hdr.pool_off + hdr.pool_len;
+    json_dbg(JSON_DBG_MED, __func__, "writing snapshot %s: %ju nodes, %ju pool bytes, %ju bytes",
+			   filename, (uintmax_t)hdr.nodes, (uintmax_t)hdr.pool_len, (uintmax_t)hdr.file_len);
+
+    /*
+     * write the snapshot to a temporary file that is renamed over the
+     * snapshot, as another process may have the snapshot mapped
+     */
+    stream = tmp_file_open(filename, &tmpname);
+    if (stream == NULL) {
+	ret = false;
+    } else {
+	errno = 0;		/* pre-clear errno for warnp() */
+	if (fwrite(&hdr, sizeof(hdr), 1, stream) != 1 ||
+	    fwrite(dyn_array_first(nodes, struct json_snap_node), sizeof(struct json_snap_node),
+		   (size_t)hdr.nodes, stream) != (size_t)hdr.nodes ||
+	    fwrite(dyn_array_first(pool, char), 1, (size_t)hdr.pool_len, stream) != (size_t)hdr.pool_len) {
+	    warnp(__func__, "error writing snapshot: %s", tmpname);
+	    ret = false;
+	}
+	ret = tmp_file_close(stream, tmpname, filename, ret);
+	stream = NULL;
+	tmpname = NULL;
+    }
+
+    /*
+     * free storage
+     */
+    dyn_array_free(queue);
+    dyn_array_free(nodes);
+    dyn_array_free(pool);
+    return ret;
+}
+
+
+/*
+ * snap_valid_str - determine if a string of a snapshot is in its string pool
+ *
+ * given:
+ *	hdr	    snapshot header
+ *	pool	    string pool of the snapshot
+ *	off	    pool offset of the string
+ *	len	    length of the string
+ *
+ * return:
+ *	true ==> string and its NUL terminator are in the pool, false ==> string is not valid
+ */
+static bool
+snap_valid_str(struct json_snap_hdr const *hdr, char const *pool, uint64_t off, uint64_t len)
+{
+    if (hdr == NULL || pool == NULL) {
+	return false;
+    }
+    if (off >= hdr->pool_len || len >= hdr->pool_len - off) {
+	return false;
+    }
+    return pool[off + len] == '\0';
+}
+
+
+/*
+ * snap_valid - determine if a mapped snapshot is valid
+ *
+ * Everything that json_snap_load() relies upon is checked: the header, that
+ * the nodes and string pool are in the file, that every string is a NUL
+ * terminated string in the pool, and that the nodes form a tree with the
+ * children of each node being consecutive nodes that refer back to it.
+ *
+ * given:
+ *	filename    snapshot file for warning messages
+ *	map	    mapped snapshot file
+ *	size	    size of the snapshot file
+ *
+ * return:
+ *	true ==> snapshot is valid, false ==> snapshot is not valid
+ *
+ * NOTE: This function warns about the first problem found.
+ */
+static bool
+snap_valid(char const *filename, char const *map, size_t size)
+{
+    struct json_snap_hdr const *hdr = NULL;	/* snapshot header */
+    struct json_snap_node const *snap = NULL;	/* snapshot nodes */
+    char const *pool = NULL;			/* string pool */
+    uint64_t num;				/* node number */
+    uint64_t kid;				/* node number of a child */
+    uint64_t kids = 0;				/* number of children of all the nodes */
+
+    /*
+     * firewall
+     */
+    if (filename == NULL || map == NULL) {
+	err(17, __func__, "filename and/or map is NULL");
+	not_reached();
+    }
+
+    /*
+     * check the header
+     */
+    if (size < sizeof(*hdr)) {
+	warn(__func__, "snapshot is too short: %s", filename);
+	return false;
+    }
+    hdr = (struct json_snap_hdr const *)map;
+    if (memcmp(hdr->magic, JSON_SNAP_MAGIC, JSON_SNAP_MAGIC_LEN) != 0) {
+	warn(__func__, "not a snapshot: %s", filename);
+	return false;
+    }
+    if (hdr->version != JSON_SNAP_VERSION || hdr->endian != JSON_SNAP_ENDIAN ||
+	hdr->node_size != sizeof(struct json_snap_node) || hdr->ldbl_size != sizeof(long double)) {
+	warn(__func__, "snapshot version %u was not written by this machine or version: %s",
+		       (unsigned int)hdr->version, filename);
+	return false;
+    }
+    if (hdr->file_len != (uint64_t)size || hdr->nodes == 0 || hdr->node_off < sizeof(*hdr) ||
+	hdr->node_off % sizeof(uint64_t) != 0 || hdr->node_off > hdr->file_len ||
+	hdr->nodes > (hdr->file_len - hdr->node_off) / sizeof(struct json_snap_node) ||
+	hdr->pool_off < hdr->node_off + hdr->nodes * sizeof(struct json_snap_node) ||
+	hdr->pool_off > hdr->file_len || hdr->pool_len != hdr->file_len - hdr->pool_off) {
+	warn(__func__, "snapshot nodes and/or string pool are not in the file: %s", filename);
+	return false;
+    }
+    snap = (struct json_snap_node const *)(map + hdr->node_off);
+    pool = map + hdr->pool_off;
+
+    /*
+     * check each node
+     */
+    for (num = 0; num < hdr->nodes; ++num) {
+
+	/*
+	 * the root has no parent and is not a member, every other node has an earlier node as parent
+	 */
+	if ((num == 0 && (snap[num].parent != JSON_SNAP_NONE || snap[num].type == JTYPE_MEMBER)) ||
+	    (num > 0 && snap[num].parent >= num)) {
+	    warn(__func__, "node %ju has an invalid parent: %s", (uintmax_t)num, filename);
+	    return false;
+	}
+
+	switch (snap[num].type) {
+	case JTYPE_NUMBER:
+	    if (!snap_valid_str(hdr, pool, snap[num].as_str, snap[num].as_str_len) ||
+		snap[num].str > snap[num].as_str_len || snap[num].str_len > snap[num].as_str_len - snap[num].str) {
+		warn(__func__, "JSON number node %ju has an invalid string: %s", (uintmax_t)num, filename);
+		return false;
+	    }
+	    break;
+	case JTYPE_STRING:
+	    if (!snap_valid_str(hdr, pool, snap[num].as_str,
+				snap_str_len(snap[num].as_str_len, (snap[num].flags & JSON_SNAP_QUOTE) != 0)) ||
+		!snap_valid_str(hdr, pool, snap[num].str, snap[num].str_len)) {
+		warn(__func__, "JSON string node %ju has an invalid string: %s", (uintmax_t)num, filename);
+		return false;
+	    }
+	    break;
+	case JTYPE_BOOL:
+	case JTYPE_NULL:
+	    if (!snap_valid_str(hdr, pool, snap[num].as_str, snap[num].as_str_len)) {
+		warn(__func__, "JSON node %ju has an invalid string: %s", (uintmax_t)num, filename);
+		return false;
+	    }
+	    break;
+	case JTYPE_MEMBER:
+	case JTYPE_OBJECT:
+	case JTYPE_ARRAY:
+	case JTYPE_ELEMENTS:
+	    break;
+	default:
+	    warn(__func__, "node %ju has an invalid type %u: %s", (uintmax_t)num, (unsigned int)snap[num].type,
+			   filename);
+	    return false;
+	}
+
+	/*
+	 * only containers have children, which must refer back to this node
+	 */
+	if (snap[num].len > 0) {
+	    if (snap[num].type != JTYPE_MEMBER && snap[num].type != JTYPE_OBJECT &&
+		snap[num].type != JTYPE_ARRAY && snap[num].type != JTYPE_ELEMENTS) {
+		warn(__func__, "node %ju of type %u has children: %s", (uintmax_t)num, (unsigned int)snap[num].type,
+			       filename);
+		return false;
+	    }
+	    if (snap[num].first <= num || snap[num].first >= hdr->nodes ||
+		snap[num].len > hdr->nodes - snap[num].first) {
+		warn(__func__, "node %ju has children that are not in the snapshot: %s", (uintmax_t)num, filename);
+		return false;
+	    }
+	    kids += snap[num].len;
+	    for (kid = snap[num].first; kid < snap[num].first + snap[num].len; ++kid) {
+		if (snap[kid].parent != num) {
+		    warn(__func__, "child %ju of node %ju has another parent: %s", (uintmax_t)kid, (uintmax_t)num,
+				   filename);
+		    return false;
+		}
+		/*
+		 * a JSON object has only members, nothing else has members
+		 */
+		if ((snap[num].type == JTYPE_OBJECT) != (snap[kid].type == JTYPE_MEMBER)) {
+		    warn(__func__, "child %ju of node %ju has an invalid type %u: %s", (uintmax_t)kid, (uintmax_t)num,
+				   (unsigned int)snap[kid].type, filename);
+		    return false;
+		}
+	    }
+	}
+	if (snap[num].type == JTYPE_MEMBER && (snap[num].len != 2 || snap[snap[num].first].type != JTYPE_STRING)) {
+	    warn(__func__, "member node %ju is not a JSON string name and a value: %s", (uintmax_t)num, filename);
+	    return false;
+	}
+    }
+
+    /*
+     * every node but the root is the child of a node
+     */
+    if (kids != hdr->nodes - 1) {
+	warn(__func__, "snapshot has %ju nodes that are not in the tree: %s", (uintmax_t)(hdr->nodes - 1 - kids), filename);
+	return false;
+    }
+    return true;
+}
+
+
+/*
+ * snap_fill - form a JSON parse tree node from a snapshot node
+ *
+ * given:
+ *	nodes	    JSON parse tree nodes, by node number
+ *	snap	    snapshot nodes, by node number
+ *	num	    node number of the node to form
+ *	pool	    string pool of the snapshot
+ *	set	    storage for the set of children of the node, if it is a container
+ *
+ * NOTE: The snapshot must have been checked by snap_valid().
+ *
+ * NOTE: This function does not return on NULL pointers.
+ */
+static void
+snap_fill(struct json *nodes, struct json_snap_node const *snap, uint64_t num, char const *pool,
+	  struct json **set)
+{
+    struct json *node = NULL;			/* JSON parse tree node to form */
+    struct json_snap_node const *from = NULL;	/* snapshot node to form it from */
+    bool parsed = false;			/* true ==> snapshot node was parsed */
+    bool converted = false;			/* true ==> snapshot node was converted */
+    intmax_t len = 0;				/* number of children */
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (nodes == NULL || snap == NULL || pool == NULL) {
+	err(18, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    node = &nodes[num];
+    from = &snap[num];
+    parsed = (from->flags & JSON_SNAP_PARSED) != 0;
+    converted = (from->flags & JSON_SNAP_CONVERTED) != 0;
+    len = (intmax_t)from->len;
+
+    /*
+     * link the children
+     */
+    for (i = 0; i < len; ++i) {
+	set[i] = &nodes[from->first + (uint64_t)i];
+    }
+
+    node->type = (enum item_type)from->type;
+    switch (node->type) {
+
+    case JTYPE_NUMBER:
+	{
+	    struct json_number *item = &(node->item.number);
+
+	    item->parsed = parsed;
+	    item->converted = converted;
+	    item->is_negative = (from->flags & JSON_SNAP_NEGATIVE) != 0;
+	    item->is_floating = (from->flags & JSON_SNAP_FLOATING) != 0;
+	    item->is_e_notation = (from->flags & JSON_SNAP_E_NOTATION) != 0;
+	    item->is_integer = (from->flags & JSON_SNAP_INTEGER) != 0;
+	    item->maxint_sized = (from->flags & JSON_SNAP_MAXINT) != 0;
+	    item->umaxint_sized = (from->flags & JSON_SNAP_UMAXINT) != 0;
+	    item->longdouble_sized = (from->flags & JSON_SNAP_LONGDOUBLE) != 0;
+	    item->as_longdouble_int = (from->flags & JSON_SNAP_LONGDOUBLE_INT) != 0;
+	    item->as_str = (char *)pool + from->as_str;
+	    item->as_str_len = (size_t)from->as_str_len;
+	    item->first = item->as_str + from->str;
+	    item->number_len = (size_t)from->str_len;
+	    item->conv = NULL;
+	    memcpy(&(item->as_maxint), from->value, SNAP_VALUE_LEN);
+	}
+	break;
+
+    case JTYPE_STRING:
+	{
+	    struct json_string *item = &(node->item.string);
+
+	    item->parsed = parsed;
+	    item->converted = converted;
+	    item->as_str = (char *)pool + from->as_str;
+	    item->as_str_len = (size_t)from->as_str_len;
+	    item->str = (char *)pool + from->str;
+	    item->str_len = (size_t)from->str_len;
+	    item->quote = (from->flags & JSON_SNAP_QUOTE) != 0;
+	    item->same = (from->flags & JSON_SNAP_SAME) != 0;
+	    item->slash = (from->flags & JSON_SNAP_SLASH) != 0;
+	    item->posix_safe = (from->flags & JSON_SNAP_POSIX_SAFE) != 0;
+	    item->first_alphanum = (from->flags & JSON_SNAP_FIRST_ALPHANUM) != 0;
+	    item->upper = (from->flags & JSON_SNAP_UPPER) != 0;
+	    item->posix_chked = (from->flags & JSON_SNAP_POSIX_CHKED) != 0;
+	}
+	break;
+
+    case JTYPE_BOOL:
+	node->item.boolean.parsed = parsed;
+	node->item.boolean.converted = converted;
+	node->item.boolean.as_str = (char *)pool + from->as_str;
+	node->item.boolean.as_str_len = (size_t)from->as_str_len;
+	node->item.boolean.value = (from->flags & JSON_SNAP_VALUE) != 0;
+	break;
+
+    case JTYPE_NULL:
+	node->item.null.parsed = parsed;
+	node->item.null.converted = converted;
+	node->item.null.as_str = (char *)pool + from->as_str;
+	node->item.null.as_str_len = (size_t)from->as_str_len;
+	node->item.null.value = NULL;
+	break;
+
+    case JTYPE_MEMBER:
+	{
+	    struct json_member *item = &(node->item.member);
+	    struct json_snap_node const *name = &snap[from->first];	/* snapshot node of the name */
+
+	    item->parsed = parsed;
+	    item->converted = converted;
+	    item->name = set[0];
+	    item->value = set[1];
+	    /*
+	     * the name node is formed after this node: use the strings of its snapshot node
+	     */
+	    item->name_as_str = (char *)pool + name->as_str;
+	    item->name_as_str_len = (size_t)name->as_str_len;
+	    item->name_str = (char *)pool + name->str;
+	    item->name_str_len = (size_t)name->str_len;
+	}
+	break;
+
+    case JTYPE_OBJECT:
+	node->item.object.parsed = parsed;
+	node->item.object.converted = converted;
+	node->item.object.len = len;
+	node->item.object.set = set;
+	node->item.object.s = NULL;
+	node->item.object.index = NULL;
+	break;
+
+    case JTYPE_ARRAY:
+	node->item.array.parsed = parsed;
+	node->item.array.converted = converted;
+	node->item.array.len = len;
+	node->item.array.set = set;
+	node->item.array.s = NULL;
+	break;
+
+    case JTYPE_ELEMENTS:
+	node->item.elements.parsed = parsed;
+	node->item.elements.converted = converted;
+	node->item.elements.len = len;
+	node->item.elements.set = set;
+	node->item.elements.s = NULL;
+	break;
+
+    default:
+	err(19, __func__, "snapshot node %ju has invalid type: %u", (uintmax_t)num, (unsigned int)from->type);
+	not_reached();
+	break;
+    }
+
+    /*
+     * link the node into the tree
+     */
+    node->parent = (from->parent == JSON_SNAP_NONE) ? NULL : &nodes[from->parent];
+    return;
+}
+
+
+/*
+ * json_snap_load - load a JSON parse tree from a binary snapshot
+ *
+ * The snapshot file, as written by json_snap_write(), is mapped read-only into
+ * memory and checked.  The JSON parse tree is then formed, in one pass over
+ * the nodes, in an arena whose input buffer is the mapping: the strings of the
+ * tree are those of the mapping, and no JSON is lexed, parsed, decoded or
+ * converted.  See json_snap.h for details.
+ *
+ * given:
+ *	filename    snapshot file to load
+ *	is_valid    if non-NULL, set to true if the snapshot was loaded, else false
+ *
+ * return:
+ *	JSON parse tree of the snapshot, or NULL if the snapshot is not valid
+ *
+ * NOTE: Free the JSON parse tree with json_tree_free() and then free(3).
+ *
+ * NOTE: This function does not return on a NULL filename or an allocation
+ *	 error, and warns if the snapshot cannot be read or is not valid.
+ */
+struct json *
+json_snap_load(char const *filename, bool *is_valid)
+{
+    struct json_snap_hdr const *hdr = NULL;	/* snapshot header */
+    struct json_snap_node const *snap = NULL;	/* snapshot nodes */
+    struct json_arena *arena = NULL;		/* arena of the JSON parse tree */
+    struct json_input *input = NULL;		/* mapping held by the arena */
+    struct json *nodes = NULL;			/* JSON parse tree nodes, by node number */
+    struct json **set = NULL;			/* sets of children of the nodes */
+    struct json *root = NULL;			/* calloc()ed root of the JSON parse tree */
+    struct stat sb;				/* snapshot file status */
+    char *map = NULL;				/* mapped snapshot file */
+    size_t size = 0;				/* size of the snapshot file */
+    size_t sets = 0;				/* number of children of all the nodes */
+    uint64_t num;				/* node number */
+    int fd = -1;				/* open snapshot file */
+
+    /*
+     * firewall
+     */
+    if (is_valid != NULL) {
+	*is_valid = false;
+    }
+    if (filename == NULL) {
+	err(20, __func__, "filename is NULL");
+	not_reached();
+    }
+
+    /*
+     * map the snapshot
+     */
+    errno = 0;			/* pre-clear errno for warnp() */
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+	warnp(__func__, "cannot open snapshot: %s", filename);
+	return NULL;
+    }
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (fstat(fd, &sb) != 0) {
+	warnp(__func__, "cannot stat snapshot: %s", filename);
+	(void) close(fd);
+	return NULL;
+    }
+    if (!S_ISREG(sb.st_mode) || sb.st_size <= 0 || (uintmax_t)sb.st_size > (uintmax_t)SIZE_MAX) {
+	warn(__func__, "snapshot is not a regular file of a usable size: %s", filename);
+	(void) close(fd);
+	return NULL;
+    }
+    size = (size_t)sb.st_size;
+    errno = 0;			/* pre-clear errno for warnp() */
+    map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+	warnp(__func__, "cannot mmap %zu bytes of snapshot: %s", size, filename);
+	(void) close(fd);
+	return NULL;
+    }
+    (void) close(fd);
+
+    /*
+     * check the snapshot
+     */
+    if (!snap_valid(filename, map, size)) {
+	(void) munmap(map, size);
+	return NULL;
+    }
+    hdr = (struct json_snap_hdr const *)map;
+    snap = (struct json_snap_node const *)(map + hdr->node_off);
+    for (num = 0; num < hdr->nodes; ++num) {
+	sets += (size_t)snap[num].len;
+    }
+    json_dbg(JSON_DBG_MED, __func__, "loading snapshot %s: %ju nodes, %ju pool bytes, %zu bytes",
+			   filename, (uintmax_t)hdr->nodes, (uintmax_t)hdr->pool_len, size);
+
+    /*
+     * the arena of the tree holds the mapping
+     */
+    arena = json_arena_create(0);
+    errno = 0;			/* pre-clear errno for errp() */
+    input = calloc(1, sizeof(*input));
+    if (input == NULL) {
+	errp(21, __func__, "calloc error allocating %zu bytes", sizeof(*input));
+	not_reached();
+    }
+    input->refs = 1;
+    input->len = size;
+    input->data = map;
+    input->mapped = true;
+    arena->input = input;
+
+    /*
+     * form the tree
+     */
+    if ((uintmax_t)hdr->nodes > (uintmax_t)(SIZE_MAX / sizeof(struct json)) ||
+	sets > SIZE_MAX / sizeof(struct json *)) {
+	err(22, __func__, "snapshot of %ju nodes is too large: %s", (uintmax_t)hdr->nodes, filename);
+	not_reached();
+    }
+    nodes = json_arena_alloc(arena, (size_t)hdr->nodes * sizeof(struct json));
+    set = json_arena_alloc(arena, sets * sizeof(struct json *));
+    for (num = 0; num < hdr->nodes; ++num) {
+	snap_fill(nodes, snap, num, map + hdr->pool_off, set);
+	nodes[num].arena = arena;
+	set += snap[num].len;
+    }
+
+    /*
+     * move the root out of the arena so that it owns the arena
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    root = calloc(1, sizeof(*root));
+    if (root == NULL) {
+	errp(23, __func__, "calloc error allocating %zu bytes", sizeof(*root));
+	not_reached();
+    }
+    *root = nodes[0];
+    for (num = snap[0].first; num < snap[0].first + snap[0].len; ++num) {
+	nodes[num].parent = root;
+    }
+    memset(&nodes[0], 0, sizeof(nodes[0]));
+
+    if (is_valid != NULL) {
+	*is_valid = true;
+    }
+    return root;
+}
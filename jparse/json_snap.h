@@ -0,0 +1,168 @@
+/*
+ * json_snap - binary snapshot of a JSON parse tree
+ *
+ * "Because the fastest JSON to parse is JSON that was already parsed." :-)
+ *
+ * Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+#if !defined(INCLUDE_JSON_SNAP_H)
+#    define  INCLUDE_JSON_SNAP_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+  #include "../dbg/c_bool.h"
+  #include "../dbg/c_compat.h"
+  #include "../dbg/dbg.h"
+#else
+  #include <c_bool.h>
+  #include <c_compat.h>
+  #include <dbg.h>
+#endif
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "util.h"
+
+
+/*
+ * binary snapshot of a JSON parse tree
+ *
+ * A snapshot is a JSON parse tree written by json_snap_write() in a form that
+ * json_snap_load() maps into memory with mmap(2) and turns back into a JSON
+ * parse tree without lexing, parsing, decoding or converting anything.  The
+ * loaded tree is the same as the tree that was written: the accessor functions
+ * and json_tree_walk() work on it as usual.
+ *
+ * A snapshot file is made of:
+ *
+ *	struct json_snap_hdr	    the header
+ *	struct json_snap_node[]	    a node for every node of the tree
+ *	char[]			    pool of the NUL terminated strings of the tree
+ *
+ * The nodes are written in breadth-first order, starting with the root as
+ * node 0, so that the children of a JSON object, JSON array or JSON member are
+ * consecutive nodes: a node refers to its children by the node number of the
+ * first child and the number of children, and to its strings by their offset
+ * in the string pool.
+ *
+ * The loaded tree is allocated from an arena (see struct json_arena in
+ * json_parse.h) and its strings point into the read-only mapping of the file,
+ * which the arena holds as its input buffer (see struct json_input).  Free it
+ * with json_tree_free() and free(3) as with any arena allocated tree.  Because
+ * the mapping is read-only, the strings of a loaded tree must not be modified.
+ *
+ * A snapshot is for the machine (and build of the library) that wrote it:
+ * json_snap_load() rejects a snapshot whose byte order, node size or long
+ * double size differ from its own.
+ */
+#define JSON_SNAP_MAGIC "JPARSNAP"	/* first 8 bytes of a snapshot, w/o the NUL */
+#define JSON_SNAP_MAGIC_LEN (8)		/* length of JSON_SNAP_MAGIC */
+#define JSON_SNAP_VERSION (1)		/* snapshot format version */
+#define JSON_SNAP_ENDIAN (0x01020304U)	/* byte order marker, as written by the host */
+#define JSON_SNAP_NONE (UINT64_MAX)	/* node number of no node: parent of the root */
+#define JSON_SNAP_VALUE_SIZE (16)	/* bytes of the canonical value of a JSON number */
+
+/*
+ * struct json_snap_node flags
+ */
+#define JSON_SNAP_PARSED	    (0x00000001U)   /* parsed is true */
+#define JSON_SNAP_CONVERTED	    (0x00000002U)   /* converted is true */
+#define JSON_SNAP_NEGATIVE	    (0x00000004U)   /* JSON number: is_negative */
+#define JSON_SNAP_FLOATING	    (0x00000008U)   /* JSON number: is_floating */
+#define JSON_SNAP_E_NOTATION	    (0x00000010U)   /* JSON number: is_e_notation */
+#define JSON_SNAP_INTEGER	    (0x00000020U)   /* JSON number: is_integer */
+#define JSON_SNAP_MAXINT	    (0x00000040U)   /* JSON number: maxint_sized */
+#define JSON_SNAP_UMAXINT	    (0x00000080U)   /* JSON number: umaxint_sized */
+#define JSON_SNAP_LONGDOUBLE	    (0x00000100U)   /* JSON number: longdouble_sized */
+#define JSON_SNAP_LONGDOUBLE_INT    (0x00000200U)   /* JSON number: as_longdouble_int */
+#define JSON_SNAP_QUOTE		    (0x00000400U)   /* JSON string: quote */
+#define JSON_SNAP_SAME		    (0x00000800U)   /* JSON string: same */
+#define JSON_SNAP_SLASH		    (0x00001000U)   /* JSON string: slash */
+#define JSON_SNAP_POSIX_SAFE	    (0x00002000U)   /* JSON string: posix_safe */
+#define JSON_SNAP_FIRST_ALPHANUM    (0x00004000U)   /* JSON string: first_alphanum */
+#define JSON_SNAP_UPPER		    (0x00008000U)   /* JSON string: upper */
+#define JSON_SNAP_POSIX_CHKED	    (0x00010000U)   /* JSON string: posix_chked */
+#define JSON_SNAP_VALUE		    (0x00020000U)   /* JSON boolean: value */
+
+struct json_snap_hdr
+{
+    char magic[JSON_SNAP_MAGIC_LEN];	/* JSON_SNAP_MAGIC */
+    uint32_t version;			/* JSON_SNAP_VERSION */
+    uint32_t endian;			/* JSON_SNAP_ENDIAN */
+    uint32_t node_size;			/* sizeof(struct json_snap_node) */
+    uint32_t ldbl_size;			/* sizeof(long double) */
+    uint64_t nodes;			/* number of nodes, > 0 */
+    uint64_t node_off;			/* file offset of node 0 */
+    uint64_t pool_len;			/* length of the string pool */
+    uint64_t pool_off;			/* file offset of the string pool */
+    uint64_t file_len;			/* length of the snapshot file */
+};
+
+struct json_snap_node
+{
+    uint32_t type;			/* enum item_type of the node */
+    uint32_t flags;			/* JSON_SNAP_* flags */
+    uint64_t parent;			/* node number of the parent, JSON_SNAP_NONE ==> root */
+    uint64_t first;			/* JSON object, array, member: node number of the first child */
+    uint64_t len;			/* JSON object, array, member: number of children */
+    uint64_t as_str;			/* pool offset of as_str */
+    uint64_t as_str_len;		/* length of as_str */
+    uint64_t str;			/* JSON string: pool offset of str, JSON number: offset of first in as_str */
+    uint64_t str_len;			/* JSON string: length of str, JSON number: number_len */
+    unsigned char value[JSON_SNAP_VALUE_SIZE];	/* JSON number: canonical value */
+};
+
+
+/*
+ * external function declarations
+ */
+extern bool json_snap_write(struct json const *tree, char const *filename);
+extern struct json *json_snap_load(char const *filename, bool *is_valid);
+
+#endif /* INCLUDE_JSON_SNAP_H */
@@ -45,6 +45,60 @@
 #include <ctype.h>
 #include "json_utf8.h"
 
+/*
+ * vectors for json_string_span() and json_encode_span()
+ *
+ * With GCC and clang the vector extensions let json_string_span() (and
+ * json_encode_span()) look at 16
+ * bytes at a time (compiled into SSE2 on x86-64 and NEON on AArch64) and, on
+ * x86-64 CPUs that have AVX2 (see json_string_span()), 32 bytes at a time,
+ * without any CPU specific include files.  Compile with -DJPARSE_NO_SIMD to
+ * only use the scalar code.
+ */
+#if !defined(JPARSE_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  #define JSON_SPAN_VECTOR
+  typedef unsigned char json_span_v16 __attribute__((vector_size(16)));
+  #if defined(__x86_64__)
+    #define JSON_SPAN_AVX2
+    typedef unsigned char json_span_v32 __attribute__((vector_size(32)));
+  #endif
+#endif
+
+
+/*
+ * static declarations
+ */
+static size_t json_span_scalar(char const *ptr, size_t len, bool const *table);
+#if defined(JSON_SPAN_VECTOR)
+static size_t json_span_vector(char const *ptr, size_t len, unsigned char extra, bool const *table);
+#endif
+#if defined(JSON_SPAN_AVX2)
+static size_t json_span_avx2(char const *ptr, size_t len, unsigned char extra, bool const *table);
+#endif
+
+/*
+ * bytes that end a span of a JSON string: ", \ and [\x00-\x1f]
+ */
+static bool const json_span_stop[256] = {
+    [0x00] = true, [0x01] = true, [0x02] = true, [0x03] = true, [0x04] = true, [0x05] = true, [0x06] = true,
+    [0x07] = true, [0x08] = true, [0x09] = true, [0x0a] = true, [0x0b] = true, [0x0c] = true, [0x0d] = true,
+    [0x0e] = true, [0x0f] = true, [0x10] = true, [0x11] = true, [0x12] = true, [0x13] = true, [0x14] = true,
+    [0x15] = true, [0x16] = true, [0x17] = true, [0x18] = true, [0x19] = true, [0x1a] = true, [0x1b] = true,
+    [0x1c] = true, [0x1d] = true, [0x1e] = true, [0x1f] = true, ['"'] = true, ['\\'] = true,
+};
+
+/*
+ * bytes that end a span of json_encode(): the above and \x7f, which it also escapes
+ */
+static bool const json_encode_stop[256] = {
+    [0x00] = true, [0x01] = true, [0x02] = true, [0x03] = true, [0x04] = true, [0x05] = true, [0x06] = true,
+    [0x07] = true, [0x08] = true, [0x09] = true, [0x0a] = true, [0x0b] = true, [0x0c] = true, [0x0d] = true,
+    [0x0e] = true, [0x0f] = true, [0x10] = true, [0x11] = true, [0x12] = true, [0x13] = true, [0x14] = true,
+    [0x15] = true, [0x16] = true, [0x17] = true, [0x18] = true, [0x19] = true, [0x1a] = true, [0x1b] = true,
+    [0x1c] = true, [0x1d] = true, [0x1e] = true, [0x1f] = true, ['"'] = true, ['\\'] = true, [0x7f] = true,
+};
+
 
 /*
  * count_utf8_bytes	- count bytes needed to decode/encode in str
@@ -392,3 +446,282 @@ is_surrogate_pair(const int32_t xa, const int32_t xb)
     }
     return false;
 }
+
+
+/*
+ * json_string_span - length of the leading bytes of a JSON string that need no attention
+ *
+ * Most of the bytes of a JSON string are copied or counted as they are: only a
+ * ", a \ or a control byte [\x00-\x1f] needs to be looked at on its own.  This
+ * function finds the first such byte 16 or (with AVX2) 32 bytes at a time,
+ * falling back to one byte at a time for the last few bytes, or when the
+ * compiler has no vector extensions.  Bytes >= 0x80, which is to say UTF-8
+ * multibyte sequences, are passed over like any other byte: the JSON parser
+ * does not change them.
+ *
+ * given:
+ *	ptr	pointer to the bytes of a JSON string
+ *	len	number of bytes at ptr
+ *
+ * returns:
+ *	the number of bytes from ptr before the first ", \ or control byte, or
+ *	len if there is none, or 0 if ptr is NULL
+ */
+size_t
+json_string_span(char const *ptr, size_t len)
+{
+    /*
+     * firewall
+     */
+    if (ptr == NULL) {
+	return 0;
+    }
+
+    /*
+     * NOTE: " as the extra byte to stop at is a no-op: it is already a stop byte
+     */
+#if defined(JSON_SPAN_AVX2)
+    if (len >= 32 && __builtin_cpu_supports("avx2")) {
+	return json_span_avx2(ptr, len, '"', json_span_stop);
+    }
+#endif
+#if defined(JSON_SPAN_VECTOR)
+    return json_span_vector(ptr, len, '"', json_span_stop);
+#else
+    return json_span_scalar(ptr, len, json_span_stop);
+#endif
+}
+
+
+/*
+ * json_encode_span - length of the leading bytes of a block that json_encode() copies as they are
+ *
+ * This is json_string_span() for the other direction: besides a ", a \ and a
+ * control byte [\x00-\x1f], json_encode() also escapes \x7f.  Every other byte
+ * is its own encoding and can be copied in bulk.
+ *
+ * given:
+ *	ptr	pointer to the bytes to encode
+ *	len	number of bytes at ptr
+ *
+ * returns:
+ *	the number of bytes from ptr before the first ", \, control byte or
+ *	\x7f, or len if there is none, or 0 if ptr is NULL
+ */
+size_t
+json_encode_span(char const *ptr, size_t len)
+{
+    /*
+     * firewall
+     */
+    if (ptr == NULL) {
+	return 0;
+    }
+
+#if defined(JSON_SPAN_AVX2)
+    if (len >= 32 && __builtin_cpu_supports("avx2")) {
+	return json_span_avx2(ptr, len, 0x7f, json_encode_stop);
+    }
+#endif
+#if defined(JSON_SPAN_VECTOR)
+    return json_span_vector(ptr, len, 0x7f, json_encode_stop);
+#else
+    return json_span_scalar(ptr, len, json_encode_stop);
+#endif
+}
+
+
+/*
+ * json_string_span_impl - name the code that json_string_span() and json_encode_span() use on this CPU
+ *
+ * returns:
+ *	"avx2" (32 bytes at a time), "vector" (16 bytes at a time) or "scalar"
+ */
+char const *
+json_string_span_impl(void)
+{
+#if defined(JSON_SPAN_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+	return "avx2";
+    }
+#endif
+#if defined(JSON_SPAN_VECTOR)
+    return "vector";
+#else
+    return "scalar";
+#endif
+}
+
+
+/*
+ * json_span_scalar - json_string_span() or json_encode_span() one byte at a time
+ *
+ * given:
+ *	ptr	pointer to the bytes of a JSON string
+ *	len	number of bytes at ptr
+ *	table	json_span_stop or json_encode_stop
+ *
+ * returns:
+ *	the number of bytes from ptr before the first stop byte, or len
+ */
+static size_t
+json_span_scalar(char const *ptr, size_t len, bool const *table)
+{
+    size_t i;
+
+    for (i = 0; i < len && !table[(unsigned char)ptr[i]]; ++i) {
+	/* nothing more to do */
+    }
+    return i;
+}
+
+
+#if defined(JSON_SPAN_VECTOR)
+/*
+ * json_span_vector - json_string_span() or json_encode_span() 16 bytes at a time
+ *
+ * Each byte of the comparisons is 0xff for a byte that ends the span and 0x00
+ * otherwise, so that the first such byte is the lowest set byte of the two
+ * (little endian) 64 bit halves of the vector.
+ *
+ * given:
+ *	ptr	pointer to the bytes of a JSON string
+ *	len	number of bytes at ptr
+ *	extra	byte that also ends the span besides ", \ and [\x00-\x1f]
+ *	table	json_span_stop or json_encode_stop, which must agree with extra
+ *
+ * returns:
+ *	the number of bytes from ptr before the first stop byte, or len
+ */
+static size_t
+json_span_vector(char const *ptr, size_t len, unsigned char extra, bool const *table)
+{
+    json_span_v16 bytes;	/* next 16 bytes */
+    json_span_v16 stop;		/* 0xff for each byte that ends the span */
+    uint64_t half[2];		/* stop as two 64 bit halves */
+    size_t i;
+
+    for (i = 0; i + 16 <= len; i += 16) {
+	memcpy(&bytes, ptr + i, sizeof(bytes));
+	stop = (json_span_v16)((bytes == '"') | (bytes == '\\') | (bytes <= 0x1f) | (bytes == extra));
+	memcpy(half, &stop, sizeof(half));
+	if ((half[0] | half[1]) != 0) {
+	    if (half[0] != 0) {
+		return i + (size_t)__builtin_ctzll(half[0]) / 8;
+	    }
+	    return i + 8 + (size_t)__builtin_ctzll(half[1]) / 8;
+	}
+    }
+    return i + json_span_scalar(ptr + i, len - i, table);
+}
+#endif
+
+
+#if defined(JSON_SPAN_AVX2)
+/*
+ * json_span_avx2 - json_string_span() or json_encode_span() 32 bytes at a time with AVX2
+ *
+ * given:
+ *	ptr	pointer to the bytes of a JSON string
+ *	len	number of bytes at ptr
+ *	extra	byte that also ends the span besides ", \ and [\x00-\x1f]
+ *	table	json_span_stop or json_encode_stop, which must agree with extra
+ *
+ * returns:
+ *	the number of bytes from ptr before the first stop byte, or len
+ *
+ * NOTE: This function must only be called when the CPU has AVX2.
+ */
+__attribute__((target("avx2"))) static size_t
+json_span_avx2(char const *ptr, size_t len, unsigned char extra, bool const *table)
+{
+    json_span_v32 bytes;	/* next 32 bytes */
+    json_span_v32 stop;		/* 0xff for each byte that ends the span */
+    uint64_t quarter[4];	/* stop as four 64 bit quarters */
+    size_t i;
+    size_t q;
+
+    for (i = 0; i + 32 <= len; i += 32) {
+	memcpy(&bytes, ptr + i, sizeof(bytes));
+	stop = (json_span_v32)((bytes == '"') | (bytes == '\\') | (bytes <= 0x1f) | (bytes == extra));
+	memcpy(quarter, &stop, sizeof(quarter));
+	if ((quarter[0] | quarter[1] | quarter[2] | quarter[3]) != 0) {
+	    for (q = 0; quarter[q] == 0; ++q) {
+		/* nothing more to do */
+	    }
+	    return i + q * 8 + (size_t)__builtin_ctzll(quarter[q]) / 8;
+	}
+    }
+    return i + json_span_vector(ptr + i, len - i, extra, table);
+}
+#endif
+
+
+/*
+ * chk_json_string_span - check json_string_span() and json_encode_span() against the scalar code
+ *
+ * For every byte value, at every position of strings of up to 72 bytes, at
+ * two alignments, json_string_span(), json_encode_span(), the scalar code and
+ * the 16 byte vector code must all find the right span.
+ *
+ * This function does not return on error.
+ */
+void
+chk_json_string_span(void)
+{
+    static char const fills[] = { 'a', (char)0xc3 };	/* ASCII and UTF-8 lead byte */
+    char buf[72 + 3 + 1];	/* strings to span */
+    size_t f;			/* index of the byte the rest of the string is made of */
+    size_t off;			/* alignment of the string in buf */
+    size_t len;			/* length of the string */
+    size_t pos;			/* position of the byte in the string */
+    size_t want;		/* span that must be found */
+    size_t span;		/* span found by json_string_span() */
+    unsigned int c;		/* byte value */
+
+    for (f = 0; f < sizeof(fills); ++f) {
+	memset(buf, fills[f], sizeof(buf));
+	for (off = 0; off < 4; off += 3) {
+	    for (len = 0; len <= 72; ++len) {
+		for (pos = 0; pos < len; ++pos) {
+		    for (c = 0; c <= 0xff; ++c) {
+			buf[off + pos] = (char)c;
+			want = json_span_stop[c] ? pos : len;
+			span = json_string_span(buf + off, len);
+			if (span != want || json_span_scalar(buf + off, len, json_span_stop) != want) {
+			    err(11, __func__, "%s span of %zu bytes with 0x%02x at %zu: %zu != %zu",
+				json_string_span_impl(), len, c, pos, span, want);
+			    not_reached();
+			}
+#if defined(JSON_SPAN_VECTOR)
+			span = json_span_vector(buf + off, len, '"', json_span_stop);
+			if (span != want) {
+			    err(12, __func__, "vector span of %zu bytes with 0x%02x at %zu: %zu != %zu",
+				len, c, pos, span, want);
+			    not_reached();
+			}
+#endif
+			want = json_encode_stop[c] ? pos : len;
+			span = json_encode_span(buf + off, len);
+			if (span != want || json_span_scalar(buf + off, len, json_encode_stop) != want) {
+			    err(13, __func__, "%s encode span of %zu bytes with 0x%02x at %zu: %zu != %zu",
+				json_string_span_impl(), len, c, pos, span, want);
+			    not_reached();
+			}
+#if defined(JSON_SPAN_VECTOR)
+			span = json_span_vector(buf + off, len, 0x7f, json_encode_stop);
+			if (span != want) {
+			    err(14, __func__, "vector encode span of %zu bytes with 0x%02x at %zu: %zu != %zu",
+				len, c, pos, span, want);
+			    not_reached();
+			}
+#endif
+		    }
+		    buf[off + pos] = fills[f];
+		}
+	    }
+	}
+    }
+    dbg(DBG_VVHIGH, "json_string_span() and json_encode_span() %s pass", json_string_span_impl());
+    return;
+}
@@ -68,12 +68,16 @@
 /*
  * official jparse UTF-8 version
  */
-#define JPARSE_UTF8_VERSION "2.1.4 2026-06-13"	/* format: major.minor YYYY-MM-DD */
+#define JPARSE_UTF8_VERSION "2.1.6 2026-10-19"	/* format: major.minor YYYY-MM-DD */
 
 extern size_t utf8len(const char *str, int32_t surrogate);
 extern int32_t surrogate_pair_to_codepoint(int32_t hi, int32_t lo);
 extern int codepoint_to_unicode(char *str, unsigned int val);
 extern uint32_t utf8_to_codepoint(const char *str);
 extern bool is_surrogate_pair(const int32_t xa, const int32_t xb);
+extern size_t json_string_span(char const *ptr, size_t len);
+extern size_t json_encode_span(char const *ptr, size_t len);
+extern char const *json_string_span_impl(void);
+extern void chk_json_string_span(void);
 
 #endif /* INCLUDE_JSON_UTF8_H */
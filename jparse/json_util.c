@@ -110,7 +110,7 @@ int const hexval[JSON_BYTE_VALUES] = {
 /*
  * static declarations
  */
-static void fprnumber(FILE *stream, char *prestr, struct json_number *item, char *midstr, char *poststr);
+static void fprnumber(FILE *stream, char *prestr, struct json_number *number, char *midstr, char *poststr);
 static void fprstring(FILE *stream, struct json_string *item);
 static void fprboolean(FILE *stream, struct json_boolean *item);
 static void fprnull(FILE *stream, struct json_null *item);
@@ -118,6 +118,12 @@ static void fprmember(FILE *stream, struct json_member *item);
 static void fprobject(FILE *stream, struct json_object *item);
 static void fprarray(FILE *stream, struct json_array *item);
 static void fprelements(FILE *stream, struct json_elements *item);
+static void json_walk_va(struct json *node, unsigned int depth, void *ctx);
+static bool json_walk_visit(struct json *node, unsigned int max_depth, unsigned int depth, bool post_order,
+			    void (*callback)(struct json *, unsigned int, void *), void *ctx);
+static bool json_walk_child(struct json *node, intmax_t i, struct json **child);
+static struct json_walk_frame *json_walk_push(struct json_walk_frame *stack, size_t *size, size_t top,
+					      struct json *node, unsigned int depth);
 
 
 /*
@@ -1160,9 +1166,34 @@ json_free(struct json *node, unsigned int depth, ...)
 void
 vjson_free(struct json *node, unsigned int depth, va_list ap)
 {
-    UNUSED_ARG(depth);
     UNUSED_ARG(ap);
 
+    json_free_ctx(node, depth, NULL);
+    return;
+}
+
+
+/*
+ * json_free_ctx - free storage of a single JSON parse tree node in callback form
+ *
+ * This is the json_tree_walk_ctx() callback form of json_free(): it is what
+ * json_tree_free() calls on each node of the tree.
+ *
+ * given:
+ *	node	pointer to a JSON parser tree node to free
+ *	depth	current tree depth (0 ==> top of tree)
+ *	ctx	callback context (not used)
+ *
+ * NOTE: This function does nothing if node == NULL.
+ *
+ * NOTE: This function does nothing if the node type is invalid.
+ */
+void
+json_free_ctx(struct json *node, unsigned int depth, void *ctx)
+{
+    UNUSED_ARG(depth);
+    UNUSED_ARG(ctx);
+
     /*
      * firewall - nothing to do for a NULL node
      */
@@ -1170,6 +1201,16 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
 	return;
     }
 
+    /*
+     * nothing to free for an arena allocated node
+     *
+     * The internals of an arena allocated node belong to the arena and are
+     * freed, along with the rest of the JSON parse tree, by json_tree_free().
+     */
+    if (node->arena != NULL) {
+	return;
+    }
+
     /*
      * free internals based in node type
      */
@@ -1190,6 +1231,10 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
 		free(item->as_str);
 		item->as_str = NULL;
 	    }
+	    if (item->conv != NULL) {
+		free(item->conv);
+		item->conv = NULL;
+	    }
 
 	    /* zeroize internal item storage */
 	    memset(item, 0, sizeof(struct json_number));
@@ -1202,15 +1247,15 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
 	{
 	    struct json_string *item = &(node->item.string);
 
-	    /* free internal storage */
+	    /* free internal storage - str is as_str when there was nothing to decode */
+	    if (item->str != NULL && item->str != item->as_str) {
+		free(item->str);
+	    }
+	    item->str = NULL;
 	    if (item->as_str != NULL) {
 		free(item->as_str);
 		item->as_str = NULL;
 	    }
-	    if (item->str != NULL) {
-		free(item->str);
-		item->str = NULL;
-	    }
 
 	    /* zeroize internal item storage */
 	    memset(item, 0, sizeof(struct json_string));
@@ -1279,6 +1324,10 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
 		item->set = NULL;
 		item->len = 0;
 	    }
+	    if (item->index != NULL) {
+		free(item->index);
+		item->index = NULL;
+	    }
 
 	    /* zeroize internal item storage */
 	    memset(item, 0, sizeof(struct json_object));
@@ -1343,7 +1392,7 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
 /*
  * json_tree_free - free storage of a JSON parse tree
  *
- * This function uses the json_tree_walk() interface to walk
+ * This function uses the json_tree_walk_ctx() interface to walk
  * the JSON parse tree and free all nodes under a given node.
  *
  * given:
@@ -1355,6 +1404,11 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
  * NOTE: This function will free the internals of a JSON parser tree node.
  *	 It is up to the caller to free the top level struct json if needed.
  *
+ * NOTE: If node is the root of a JSON parse tree formed by parse_json_arena()
+ *	 (and friends), the arena holding the tree is freed in a single call,
+ *	 without walking the tree, regardless of max_depth.  Any other arena
+ *	 allocated node is left alone as it belongs to the arena of its tree.
+ *
  * NOTE: If the pointer to allocated storage == NULL,
  *	 this function does nothing.
  *
@@ -1365,8 +1419,6 @@ vjson_free(struct json *node, unsigned int depth, va_list ap)
 void
 json_tree_free(struct json *node, unsigned int max_depth, ...)
 {
-    va_list ap;		/* variable argument list */
-
     /*
      * firewall - nothing to do for a NULL node
      */
@@ -1375,19 +1427,26 @@ json_tree_free(struct json *node, unsigned int max_depth, ...)
     }
 
     /*
-     * stdarg variable argument list setup
+     * case: arena allocated JSON parse tree
      */
-    va_start(ap, max_depth);
+    if (node->arena != NULL) {
 
-    /*
-     * free the JSON parse tree
-     */
-    vjson_tree_walk(node, max_depth, 0, true, vjson_free, ap);
+	/*
+	 * only the root of the tree owns the arena
+	 */
+	if (node->parent == NULL) {
+	    json_arena_free(node->arena);
+	    node->arena = NULL;
+	    node->type = JTYPE_UNSET;
+	    memset(&(node->item), 0, sizeof(node->item));
+	}
+	return;
+    }
 
     /*
-     * stdarg variable argument list cleanup
+     * free the JSON parse tree
      */
-    va_end(ap);
+    json_tree_walk_ctx(node, max_depth, 0, true, json_free_ctx, NULL);
     return;
 }
 
@@ -1468,13 +1527,16 @@ json_fprint(struct json *node, unsigned int depth, ...)
  * given:
  *	stream	    open stream on which to print information about a json_number
  *	prestr	    first string to print
- *	item	    pointer to struct json_number for which to print in stream
+ *	number	    pointer to struct json_number for which to print in stream
  *	midstr	    third string to print
  *	poststr	    if non-NULL, fourth string to print, NULL ==> print "((NULL))"
  */
 static void
-fprnumber(FILE *stream, char *prestr, struct json_number *item, char *midstr, char *poststr)
+fprnumber(FILE *stream, char *prestr, struct json_number *number, char *midstr, char *poststr)
 {
+    struct json_number_conv conv;	/* every C conversion of the JSON number */
+    struct json_number_conv *item = &conv;	/* JSON number conversions to print */
+
     /*
      * firewall - must be -J 3 or more
      */
@@ -1485,8 +1547,8 @@ fprnumber(FILE *stream, char *prestr, struct json_number *item, char *midstr, ch
 	warn(__func__, "stream is NULL");
 	return;
     }
-    if (item == NULL) {
-	warn(__func__, "item is NULL");
+    if (number == NULL) {
+	warn(__func__, "number is NULL");
 	return;
     }
     if (prestr == NULL) {
@@ -1502,6 +1564,11 @@ fprnumber(FILE *stream, char *prestr, struct json_number *item, char *midstr, ch
 	poststr = "((NULL poststr))";
     }
 
+    /*
+     * convert the JSON number into every C type for printing
+     */
+    (void) json_number_to_conv(number, &conv);
+
     /*
      * print the first prestr
      */
@@ -1614,8 +1681,16 @@ fprnumber(FILE *stream, char *prestr, struct json_number *item, char *midstr, ch
 
     /*
      * print the fourth poststr
+     *
+     * NOTE: while a JSON document is scanned in place (see
+     *	     parse_json_zero_copy()) the as_str of a JSON number is not yet NUL
+     *	     terminated so we only print as_str_len bytes of it.
      */
-    fprint(stream, "%s", poststr);
+    if (poststr == number->as_str) {
+	fprint(stream, "%.*s", (int)number->as_str_len, poststr);
+    } else {
+	fprint(stream, "%s", poststr);
+    }
     return;
 }
 
@@ -1915,7 +1990,8 @@ fprobject(FILE *stream, struct json_object *item)
         if (item->set == NULL) {
             fprstr(stream, "\tWarning: set == NULL");
         }
-        if (item->s == NULL) {
+        /* NOTE: arena allocated nodes have a set but no dynamic array */
+        if (item->s == NULL && item->set == NULL) {
             fprstr(stream, "\tWarning: s == NULL");
         }
 
@@ -1973,7 +2049,8 @@ fprarray(FILE *stream, struct json_array *item)
         if (item->set == NULL) {
             fprstr(stream, "\tWarning: set == NULL");
         }
-        if (item->s == NULL) {
+        /* NOTE: arena allocated nodes have a set but no dynamic array */
+        if (item->s == NULL && item->set == NULL) {
             fprstr(stream, "\tWarning: s == NULL");
         }
 
@@ -2032,7 +2109,8 @@ fprelements(FILE *stream, struct json_elements *item)
         if (item->set == NULL) {
             fprstr(stream, "\tWarning: set == NULL");
         }
-        if (item->s == NULL) {
+        /* NOTE: arena allocated nodes have a set but no dynamic array */
+        if (item->s == NULL && item->set == NULL) {
             fprstr(stream, "\tWarning: s == NULL");
         }
 
@@ -2088,9 +2166,7 @@ fprelements(FILE *stream, struct json_elements *item)
 void
 vjson_fprint(struct json *node, unsigned int depth, va_list ap)
 {
-    FILE *stream = NULL;	/* stream to print on */
-    int json_dbg_lvl = JSON_DBG_DEFAULT;	/* JSON debug level */
-    char const *tname = NULL;	/* name of the node type */
+    struct json_fprint_ctx pr;	/* stream and JSON debug level */
     va_list ap2;		/* copy of va_list ap */
 
     /*
@@ -2101,19 +2177,75 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
     }
 
     /*
-     * duplicate va_list ap
+     * obtain the stream and json_dbg_lvl args
      */
     va_copy(ap2, ap);
+    pr.stream = va_arg(ap2, FILE *);
+    pr.json_dbg_lvl = (pr.stream == NULL) ? JSON_DBG_DEFAULT : va_arg(ap2, int);
+    va_end(ap2); /* stdarg variable argument list cleanup */
 
     /*
-     * obtain the stream and json_dbg_lvl args
+     * print the node
+     */
+    json_fprint_ctx(node, depth, &pr);
+    return;
+}
+
+
+/*
+ * json_fprint_ctx - print a line about a JSON parse tree node in callback form
+ *
+ * This is the json_tree_walk_ctx() callback form of json_fprint(): it is what
+ * json_tree_print() calls on each node of the tree.
+ *
+ * See json_tree_print() to print lines for an entire JSON parse tree.
+ *
+ * If dbg_output_allowed == false, this function will not print.
+ *
+ * When json_dbg_lvl == JSON_DBG_FORCED, the printed prefix of:
+ *
+ *	JSON tree[%d]:
+ *
+ * is replaced with:
+ *
+ *	JSON tree node:
+ *
+ * given:
+ *	node	pointer to a JSON parser tree node to free
+ *	depth	current tree depth (0 ==> top of tree)
+ *	ctx	pointer to a struct json_fprint_ctx:
+ *
+ *		stream	    stream to print on
+ *		json_dbg_lvl   print message if JSON_DBG_FORCED
+ *			       OR if <= json_verbosity_level
+ *
+ * NOTE: This function does nothing if node == NULL.
+ *
+ * NOTE: This function does nothing if the node type is invalid.
+ */
+void
+json_fprint_ctx(struct json *node, unsigned int depth, void *ctx)
+{
+    struct json_fprint_ctx *pr = ctx;	/* stream and JSON debug level */
+    FILE *stream = NULL;	/* stream to print on */
+    int json_dbg_lvl = JSON_DBG_DEFAULT;	/* JSON debug level */
+    char const *tname = NULL;	/* name of the node type */
+
+    /*
+     * firewall - nothing to do for a NULL node
+     */
+    if (node == NULL || pr == NULL) {
+	return;
+    }
+
+    /*
+     * obtain the stream and json_dbg_lvl
      */
-    stream = va_arg(ap2, FILE *);
+    stream = pr->stream;
     if (stream == NULL) {
-	va_end(ap2); /* stdarg variable argument list cleanup */
 	return;
     }
-    json_dbg_lvl = va_arg(ap2, int);
+    json_dbg_lvl = pr->json_dbg_lvl;
 
     /*
      * check if JSON debug output is allowed
@@ -2121,7 +2253,6 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
     if (!dbg_output_allowed || (json_dbg_lvl != JSON_DBG_FORCED &&
         json_dbg_lvl > json_verbosity_level)) {
 	/* tree output disabled by json_verbosity_level */
-	va_end(ap2); /* stdarg variable argument list cleanup */
 	return;
     }
 
@@ -2140,7 +2271,6 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
     tname = json_item_type_name(node);
     if (tname == NULL) {
 	warn(__func__, "json_item_type_name returned NULL");
-	va_end(ap2); /* stdarg variable argument list cleanup */
 	return;
     }
     fprint(stream, "lvl: %u\ttype: %s", depth, tname);
@@ -2183,6 +2313,7 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
 	{
 	    struct json_string *item = &(node->item.string);
 
+	    (void) json_string_posix(node);
             fprstring(stream, item);
 	}
 	break;
@@ -2244,11 +2375,6 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
      * print final newline
      */
     fprstr(stream, "\n");
-
-    /*
-     * stdarg variable argument list cleanup
-     */
-    va_end(ap2);
     return;
 }
 
@@ -2256,7 +2382,7 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
 /*
  * json_tree_print - print lines for an entire JSON parse tree.
  *
- * This function uses the json_tree_walk() interface to walk
+ * This function uses the json_tree_walk_ctx() interface to walk
  * the JSON parse tree and print lines about all tree nodes.
  *
  * If dbg_output_allowed == false, this function will not print.
@@ -2293,13 +2419,14 @@ vjson_fprint(struct json *node, unsigned int depth, va_list ap)
  *
  * NOTE: This function does nothing if the node type is invalid.
  *
- * NOTE: this function is a wrapper to vjson_tree_walk() with the callback
- * vjson_fprint().
+ * NOTE: this function is a wrapper to json_tree_walk_ctx() with the callback
+ * json_fprint_ctx().
  */
 void
 json_tree_print(struct json *node, unsigned int max_depth, ...)
 {
     va_list ap;		/* variable argument list */
+    struct json_fprint_ctx pr;	/* stream and JSON debug level */
 
     /*
      * firewall - nothing to do for a NULL node
@@ -2309,19 +2436,20 @@ json_tree_print(struct json *node, unsigned int max_depth, ...)
     }
 
     /*
-     * stdarg variable argument list setup
+     * obtain the stream and json_dbg_lvl args
      */
     va_start(ap, max_depth);
+    pr.stream = va_arg(ap, FILE *);
+    pr.json_dbg_lvl = (pr.stream == NULL) ? JSON_DBG_DEFAULT : va_arg(ap, int);
+    va_end(ap); /* stdarg variable argument list cleanup */
+    if (pr.stream == NULL) {
+	return;
+    }
 
     /*
      * print the JSON parse tree
      */
-    vjson_tree_walk(node, max_depth, 0, true, vjson_fprint, ap);
-
-    /*
-     * stdarg variable argument list cleanup
-     */
-    va_end(ap);
+    json_tree_walk_ctx(node, max_depth, 0, true, json_fprint_ctx, &pr);
     return;
 }
 
@@ -2486,7 +2614,9 @@ json_tree_walk(struct json *node, unsigned int max_depth, unsigned int depth, bo
 /*
  * vjson_tree_walk - walk a JSON parse tree calling a function on each node in va_list form
  *
- * This is the va_list form of json_tree_walk().
+ * This is the va_list form of json_tree_walk().  The walk itself is done,
+ * without recursion, by json_tree_walk_ctx(): each vcallback call is passed
+ * the same ap.
  *
  * Walk a JSON parse tree, Depth-first Post-order (LRN).  See:
  *
@@ -2526,7 +2656,7 @@ void
 vjson_tree_walk(struct json *node, unsigned int max_depth, unsigned int depth, bool post_order,
 		void (*vcallback)(struct json *, unsigned int, va_list), va_list ap)
 {
-    int i;
+    struct json_walk_va va;	/* vcallback and its variable argument list */
 
     /*
      * firewall
@@ -2540,12 +2670,175 @@ vjson_tree_walk(struct json *node, unsigned int max_depth, unsigned int depth, b
 	return ;
     }
 
+    /*
+     * walk the tree, passing the same va_list to vcallback for each node
+     */
+    va.vcallback = vcallback;
+    va_copy(va.ap, ap);
+    json_tree_walk_ctx(node, max_depth, depth, post_order, json_walk_va, &va);
+    va_end(va.ap); /* stdarg variable argument list cleanup */
+    return;
+}
+
+
+/*
+ * json_walk_va - call a vjson_tree_walk() vcallback from json_tree_walk_ctx()
+ *
+ * given:
+ *	node	pointer to a JSON parse tree node
+ *	depth	current tree depth (0 ==> top of tree)
+ *	ctx	pointer to a struct json_walk_va
+ */
+static void
+json_walk_va(struct json *node, unsigned int depth, void *ctx)
+{
+    struct json_walk_va *va = ctx;	/* vcallback and its variable argument list */
+
+    (*va->vcallback)(node, depth, va->ap);
+    return;
+}
+
+
+/*
+ * json_tree_walk_ctx - walk a JSON parse tree calling a function on each node with a context
+ *
+ * This is json_tree_walk() with a plain context pointer instead of a variable
+ * argument list, and without recursion: the nodes from the top of the walk
+ * down to the current node are kept on an explicit stack allocated on the
+ * heap, so that the depth of the tree is not limited by the size of the C
+ * stack, and no va_list is copied for each node.  json_tree_free(),
+ * json_tree_print() and json_sem_check() walk the tree with this function,
+ * as does vjson_tree_walk() itself.
+ *
+ * Example use - free an entire JSON parse tree
+ *
+ *	json_tree_walk_ctx(tree, JSON_DEFAULT_MAX_DEPTH, 0, true, json_free_ctx, NULL);
+ *
+ * given:
+ *	node	    pointer to a JSON parse tree
+ *	max_depth   maximum tree depth to descend, or 0 ==> infinite depth
+ *			NOTE: Use JSON_INFINITE_DEPTH for infinite depth
+ *			NOTE: Consider use of JSON_DEFAULT_MAX_DEPTH for good default.
+ *	depth	    current tree depth (0 ==> top of tree)
+ *	post_order  true ==> walk tree in post-order (LRN), false ==> walk in pre-order (NLR)
+ *	callback    function to operate JSON parse tree node
+ *	ctx	    context passed as is to callback, may be NULL
+ *
+ * The nodes are visited in the same order, with the same depth, as by
+ * vjson_tree_walk().  If the tree depth > max_depth (and max_depth is not
+ * JSON_INFINITE_DEPTH), the node is neither operated on nor descended into.
+ *
+ * NOTE: This function warns but does not do anything if node or callback is NULL.
+ *
+ * NOTE: This function does not return on malloc error.
+ */
+void
+json_tree_walk_ctx(struct json *node, unsigned int max_depth, unsigned int depth, bool post_order,
+		   void (*callback)(struct json *, unsigned int, void *), void *ctx)
+{
+    struct json_walk_frame *stack = NULL;   /* nodes being walked, top of the walk first */
+    struct json_walk_frame *frame = NULL;   /* node being walked */
+    size_t size = 0;			    /* number of stack frames allocated */
+    size_t top = 0;			    /* number of stack frames in use */
+    struct json *child = NULL;		    /* next child node of the node being walked */
+    unsigned int child_depth = 0;	    /* tree depth of child */
+
+    /*
+     * firewall
+     */
+    if (node == NULL) {
+	warn(__func__, "node is NULL");
+	return;
+    }
+    if (callback == NULL) {
+	warn(__func__, "callback is NULL");
+	return;
+    }
+
+    /*
+     * operate on the node, done unless it has children to descend into
+     */
+    if (!json_walk_visit(node, max_depth, depth, post_order, callback, ctx)) {
+	return;
+    }
+    stack = json_walk_push(stack, &size, top++, node, depth);
+
+    /*
+     * walk down the tree until all the nodes under the node are done
+     */
+    while (top > 0) {
+	frame = &stack[top-1];
+
+	/*
+	 * case: descend into the next child of the node
+	 */
+	if (json_walk_child(frame->node, frame->next++, &child)) {
+	    child_depth = frame->depth + 1;
+	    if (json_walk_visit(child, max_depth, child_depth, post_order, callback, ctx)) {
+		stack = json_walk_push(stack, &size, top++, child, child_depth);
+	    }
+
+	/*
+	 * case: all children done
+	 */
+	} else {
+	    --top;
+
+	    /* finally perform function operation on the parent node */
+	    /* case: post-order (LRN) */
+	    if (post_order == true) {
+		(*callback)(frame->node, frame->depth, ctx);
+	    }
+	}
+    }
+
+    /*
+     * free the stack
+     */
+    free(stack);
+    stack = NULL;
+    return;
+}
+
+
+/*
+ * json_walk_visit - operate on a JSON parse tree node reached by json_tree_walk_ctx()
+ *
+ * A terminal JSON tree leaf node is operated on now.  Any other node is
+ * operated on now only when walking in pre-order (NLR): when walking in
+ * post-order (LRN), it is operated on by json_tree_walk_ctx() once all of
+ * its children are done.
+ *
+ * given:
+ *	node	    pointer to a JSON parse tree node
+ *	max_depth   maximum tree depth to descend, or 0 ==> infinite depth
+ *	depth	    tree depth of node
+ *	post_order  true ==> walk tree in post-order (LRN), false ==> walk in pre-order (NLR)
+ *	callback    function to operate JSON parse tree node
+ *	ctx	    context passed as is to callback
+ *
+ * returns:
+ *	true ==> node may have children to descend into,
+ *	false ==> node is done (or it is NULL, too deep or of an unknown type)
+ */
+static bool
+json_walk_visit(struct json *node, unsigned int max_depth, unsigned int depth, bool post_order,
+		void (*callback)(struct json *, unsigned int, void *), void *ctx)
+{
+    /*
+     * firewall
+     */
+    if (node == NULL) {
+	warn(__func__, "node is NULL");
+	return false;
+    }
+
     /*
      * do nothing if we are too deep
      */
     if (max_depth != JSON_INFINITE_DEPTH && depth > max_depth) {
 	warn(__func__, "tree walk descent stopped, tree depth: %u > max_depth: %u", depth, max_depth);
-	return;
+	return false;
     }
 
     /*
@@ -2561,114 +2854,130 @@ vjson_tree_walk(struct json *node, unsigned int max_depth, unsigned int depth, b
 
 	/* case: terminal JSON tree leaf node */
 	/* perform function operation on this terminal parse tree node */
-	(*vcallback)(node, depth, ap);
-	break;
+	(*callback)(node, depth, ctx);
+	return false;
 
     case JTYPE_MEMBER:	/* JSON item is a member */
+    case JTYPE_OBJECT:	/* JSON item is a { members } */
+    case JTYPE_ARRAY:	/* JSON item is a [ elements ] */
+    case JTYPE_ELEMENTS:	/* JSON items is zero or more JSON values */
+
 	/* case: pre-order (NLR) */
 	if (post_order == false) {
-	    (*vcallback)(node, depth, ap);
-	}
-
-	/* descend the tree */
-	{
-	    struct json_member *item = &(node->item.member);
-
-	    /* perform function operation on JSON member name (left branch) node */
-	    vjson_tree_walk(item->name, max_depth, depth+1, post_order, vcallback, ap);
-
-	    /* perform function operation on JSON member value (right branch) node */
-	    vjson_tree_walk(item->value, max_depth, depth+1, post_order, vcallback, ap);
+	    (*callback)(node, depth, ctx);
 	}
+	return true;
 
-	/* finally perform function operation on the parent node */
-	/* case: post-order (LRN) */
-	if (post_order == true) {
-	    (*vcallback)(node, depth, ap);
-	}
+    default:
+	warn(__func__, "node type is unknown: %d", node->type);
+	/* nothing we can traverse */
 	break;
+    }
+    return false;
+}
 
-    case JTYPE_OBJECT:	/* JSON item is a { members } */
-	/* case: pre-order (NLR) */
-	if (post_order == false) {
-	    (*vcallback)(node, depth, ap);
-	}
 
-	/* descend the tree */
-	{
-	    struct json_object *item = &(node->item.object);
+/*
+ * json_walk_child - obtain a child of a JSON parse tree node, in walk order
+ *
+ * The children of a JSON member are its name (left branch) and then its value
+ * (right branch).  The children of a JSON object, array or elements are the
+ * nodes of its set, in order.
+ *
+ * given:
+ *	node	pointer to a JSON parse tree node
+ *	i	index of the child, 0 ==> first child
+ *	child	pointer to where to store the child (which may be NULL)
+ *
+ * returns:
+ *	true ==> *child set to the child,
+ *	false ==> node has no child i
+ */
+static bool
+json_walk_child(struct json *node, intmax_t i, struct json **child)
+{
+    struct json **set = NULL;	/* set of child nodes */
+    intmax_t len = 0;		/* number of nodes in set */
 
-	    /* perform function operation on each object member in order */
-	    if (item->set != NULL) {
-		for (i=0; i < item->len; ++i) {
-		    vjson_tree_walk(item->set[i], max_depth, depth+1, post_order, vcallback, ap);
-		}
-	    }
-	}
+    switch (node->type) {
 
-	/* finally perform function operation on the parent node */
-	/* case: post-order (LRN) */
-	if (post_order == true) {
-	    (*vcallback)(node, depth, ap);
+    case JTYPE_MEMBER:	/* JSON item is a member */
+	if (i == 0) {
+	    *child = node->item.member.name;
+	    return true;
+	} else if (i == 1) {
+	    *child = node->item.member.value;
+	    return true;
 	}
+	return false;
+
+    case JTYPE_OBJECT:	/* JSON item is a { members } */
+	set = node->item.object.set;
+	len = node->item.object.len;
 	break;
 
     case JTYPE_ARRAY:	/* JSON item is a [ elements ] */
-	/* case: pre-order (NLR) */
-	if (post_order == false) {
-	    (*vcallback)(node, depth, ap);
-	}
-
-	/* descend the tree */
-	{
-	    struct json_array *item = &(node->item.array);
-
-	    /* perform function operation on each object member in order */
-	    if (item->set != NULL) {
-		for (i=0; i < item->len; ++i) {
-		    vjson_tree_walk(item->set[i], max_depth, depth+1, post_order, vcallback, ap);
-		}
-	    }
-	}
-
-	/* finally perform function operation on the parent node */
-	/* case: post-order (LRN) */
-	if (post_order == true) {
-	    (*vcallback)(node, depth, ap);
-	}
+	set = node->item.array.set;
+	len = node->item.array.len;
 	break;
 
     case JTYPE_ELEMENTS:	/* JSON items is zero or more JSON values */
-	/* case: pre-order (NLR) */
-	if (post_order == false) {
-	    (*vcallback)(node, depth, ap);
-	}
+	set = node->item.elements.set;
+	len = node->item.elements.len;
+	break;
 
-	/* descend the tree */
-	{
-	    struct json_elements *item = &(node->item.elements);
+    default:
+	return false;
+    }
+    if (set == NULL || i >= len) {
+	return false;
+    }
+    *child = set[i];
+    return true;
+}
 
-	    /* perform function operation on each object member in order */
-	    if (item->set != NULL) {
-		for (i=0; i < item->len; ++i) {
-		    vjson_tree_walk(item->set[i], max_depth, depth+1, post_order, vcallback, ap);
-		}
-	    }
-	}
 
-	/* finally perform function operation on the parent node */
-	/* case: post-order (LRN) */
-	if (post_order == true) {
-	    (*vcallback)(node, depth, ap);
-	}
-	break;
+/*
+ * json_walk_push - push a JSON parse tree node on the json_tree_walk_ctx() stack
+ *
+ * given:
+ *	stack	the stack, or NULL ==> no stack allocated yet
+ *	size	pointer to the number of stack frames allocated
+ *	top	number of stack frames in use
+ *	node	pointer to a JSON parse tree node to push
+ *	depth	tree depth of node
+ *
+ * returns:
+ *	stack, reallocated if it was full
+ *
+ * NOTE: This function does not return on realloc error.
+ */
+static struct json_walk_frame *
+json_walk_push(struct json_walk_frame *stack, size_t *size, size_t top, struct json *node, unsigned int depth)
+{
+    struct json_walk_frame *frames = NULL;	/* reallocated stack */
 
-    default:
-	warn(__func__, "node type is unknown: %d", node->type);
-	/* nothing we can traverse */
-	break;
+    /*
+     * grow the stack when it is full
+     */
+    if (top >= *size) {
+	errno = 0;		/* pre-clear errno for errp() */
+	frames = realloc(stack, (*size + JSON_WALK_STACK_CHUNK) * sizeof(*frames));
+	if (frames == NULL) {
+	    errp(161, __func__, "realloc of %zu stack frames failed", *size + JSON_WALK_STACK_CHUNK);
+	    not_reached();
+	}
+	stack = frames;
+	*size += JSON_WALK_STACK_CHUNK;
     }
-    return;
+
+    /*
+     * push the node
+     */
+    stack[top].node = node;
+    stack[top].depth = depth;
+    stack[top].next = 0;
+    return stack;
 }
 
 
@@ -2952,7 +3261,7 @@ json_util_parse_st_level_option(char *optarg, uintmax_t *num_level_spaces, bool
  *
  *	optarg	    - option argument to -t option
  *
- * Returns: bitvector of types requested.
+ * Returns: bitvector of types requested: only the types listed in optarg.
  *
  * NOTE: if optarg is NULL (which should never happen) or empty it returns the
  * default, JSON_UTIL_MATCH_TYPE_SIMPLE (as if '-t simple').
@@ -2962,14 +3271,14 @@ json_util_parse_st_level_option(char *optarg, uintmax_t *num_level_spaces, bool
 uintmax_t
 json_util_parse_match_types(char *optarg)
 {
-    uintmax_t type = JSON_UTIL_MATCH_TYPE_SIMPLE; /* default is simple: num, bool, str and null */
+    uintmax_t type = JSON_UTIL_MATCH_TYPE_NONE; /* types listed in optarg */
     char *saveptr = NULL;   /* for strtok_r() */
     char *dup = NULL;	    /* strdup()d copy of optarg */
     char *p = NULL;
 
     if (optarg == NULL || !*optarg) {
 	/* NULL or empty optarg, assume simple */
-	return type;
+	return JSON_UTIL_MATCH_TYPE_SIMPLE;
     }
     p = optarg;
 
@@ -3006,6 +3315,13 @@ json_util_parse_match_types(char *optarg)
 	    not_reached();
 	}
     }
+    free(dup);
+    dup = NULL;
+
+    /* a list of no types, such as ",", is the default */
+    if (type == JSON_UTIL_MATCH_TYPE_NONE) {
+	type = JSON_UTIL_MATCH_TYPE_SIMPLE;
+    }
 
     return type;
 }
@@ -96,6 +96,7 @@
 #define JSON_CHUNK (16)			/* number of pointers to allocate at a time in dynamic array */
 #define JSON_DEFAULT_MAX_DEPTH (256)	/* a sane parse tree depth to use */
 #define JSON_INFINITE_DEPTH (0)		/* no limit on parse tree depth to walk */
+#define JSON_WALK_STACK_CHUNK (64)	/* number of tree walk stack frames to allocate at a time */
 
 
 /*
@@ -112,6 +113,34 @@
 #define JSON_DBG_VVVVHIGH   (DBG_VVVVHIGH)  /* very very very very verbose debugging information related to parser */
 #define JSON_DBG_FORCED	    (-1)	    /* always print information, even if dbg_output_allowed == false */
 
+/*
+ * json_tree_walk_ctx() stack frame - a node being walked
+ */
+struct json_walk_frame
+{
+    struct json *node;		/* JSON parse tree node being walked */
+    unsigned int depth;		/* tree depth of node */
+    intmax_t next;		/* index of the next child of node to descend into */
+};
+
+/*
+ * vjson_tree_walk() context for json_tree_walk_ctx()
+ */
+struct json_walk_va
+{
+    void (*vcallback)(struct json *, unsigned int, va_list);	/* function to operate JSON parse tree node */
+    va_list ap;			/* variable argument list for vcallback */
+};
+
+/*
+ * json_fprint_ctx() context - see json_tree_print()
+ */
+struct json_fprint_ctx
+{
+    FILE *stream;		/* stream to print on */
+    int json_dbg_lvl;		/* print if JSON_DBG_FORCED OR if <= json_verbosity_level */
+};
+
 /* WARNING: the below enums, macros and structs are VERY subject to change, if they are not deleted */
 
 /* comparison enum - for json tools that might wish to compare JSON related values */
@@ -199,8 +228,10 @@ extern char const *json_get_type_str(struct json *node, bool encoded);
 extern struct json * open_json_dir_file(char const *dir, char const *filename);
 extern void json_free(struct json *node, unsigned int depth, ...);
 extern void vjson_free(struct json *node, unsigned int depth, va_list ap);
+extern void json_free_ctx(struct json *node, unsigned int depth, void *ctx);
 extern void json_fprint(struct json *node, unsigned int depth, ...);
 extern void vjson_fprint(struct json *node, unsigned int depth, va_list ap);
+extern void json_fprint_ctx(struct json *node, unsigned int depth, void *ctx);
 extern void json_tree_print(struct json *node, unsigned int max_depth, ...);
 extern void json_dbg_tree_print(int json_dbg_lvl, char const *name, struct json *tree, unsigned int max_depth);
 extern void json_tree_free(struct json *node, unsigned int max_depth, ...);
@@ -208,6 +239,8 @@ extern void json_tree_walk(struct json *node, unsigned int max_depth, unsigned i
 			   void (*vcallback)(struct json *, unsigned int, va_list), ...);
 extern void vjson_tree_walk(struct json *node, unsigned int max_depth, unsigned int depth, bool post_order,
 			    void (*vcallback)(struct json *, unsigned int, va_list), va_list ap);
+extern void json_tree_walk_ctx(struct json *node, unsigned int max_depth, unsigned int depth, bool post_order,
+			       void (*callback)(struct json *, unsigned int, void *), void *ctx);
 
 /* WARNING: the below functions are VERY subject to change, if they are not deleted */
 bool json_util_parse_number_range(const char *option, char *optarg, bool allow_negative, struct json_util_number *number);
@@ -48,6 +48,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <string.h>
 #include "jstr_util.h"
 
 /*
@@ -210,3 +211,104 @@ free_jstring_list(struct jstring **jstring_list)
 
     jstring_list = NULL;
 }
+
+/*
+ * parse_window - parse -S optarg
+ *
+ * given:
+ *	optarg		window size in bytes, 0 ==> JSTR_WINDOW_DEF
+ *
+ * returns:
+ *	parsed window size, or 0 on conversion error, NULL arg or too large a window
+ */
+size_t
+parse_window(char const *optarg)
+{
+    uintmax_t window = 0;	/* parsed window size */
+
+    /*
+     * firewall
+     */
+    if (optarg == NULL) {
+	return 0;
+    }
+
+    /*
+     * parse window
+     */
+    if (strcmp(optarg, "0") == 0) {
+	return JSTR_WINDOW_DEF;
+    }
+    if (!string_to_uintmax(optarg, &window) || window > JSTR_WINDOW_MAX) {
+	return 0;
+    }
+    return (size_t)window;
+}
+
+/*
+ * read_window - read the next window of a stream for the -S mode of the jstr tools
+ *
+ * Up to size bytes are read from the stream into buf: fewer only at the end of
+ * the stream.  If ignore_nl, newlines are dropped as they are read, so that
+ * the window is filled with the bytes that remain.
+ *
+ * given:
+ *	stream		open stream to read
+ *	buf		buffer to read into
+ *	size		number of bytes to read into buf
+ *	ignore_nl	true ==> drop all newline characters
+ *	len		pointer to the number of bytes read into buf
+ *	eof		pointer to true ==> end of the stream was reached
+ *
+ * returns:
+ *	true ==> *len bytes were read, false ==> NULL arg or read error
+ */
+bool
+read_window(FILE *stream, char *buf, size_t size, bool ignore_nl, size_t *len, bool *eof)
+{
+    size_t have = 0;	/* bytes in buf */
+    size_t got = 0;	/* bytes read by fread() */
+    size_t i;
+    size_t j;
+
+    /*
+     * firewall
+     */
+    if (stream == NULL || buf == NULL || len == NULL || eof == NULL) {
+	warn(__func__, "called with NULL arg(s)");
+	return false;
+    }
+    *len = 0;
+    *eof = false;
+
+    /*
+     * fill the window
+     */
+    while (have < size) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	got = fread(buf + have, 1, size - have, stream);
+	if (got == 0) {
+	    if (ferror(stream)) {
+		warnp(__func__, "error reading stream");
+		return false;
+	    }
+	    *eof = true;
+	    break;
+	}
+
+	/*
+	 * if -N, drop newlines from what was just read
+	 */
+	if (ignore_nl) {
+	    for (i = have, j = have; i < have + got; ++i) {
+		if (buf[i] != '\n') {
+		    buf[j++] = buf[i];
+		}
+	    }
+	    got = j - have;
+	}
+	have += got;
+    }
+    *len = have;
+    return true;
+}
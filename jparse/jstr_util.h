@@ -86,6 +86,13 @@
 #include "jparse.h"
 
 
+/*
+ * -S window sizes
+ */
+#define JSTR_WINDOW_DEF (64*1024)	/* -S 0 window in bytes */
+#define JSTR_WINDOW_MAX (1024*1024*1024)	/* largest -S window in bytes */
+
+
 /*
  * struct for jstr utilities
  */
@@ -109,6 +116,8 @@ extern struct jstring *alloc_jstr(char *string, size_t bufsiz);
 extern int parse_entertainment(char const *optarg);
 extern void free_jstring(struct jstring **jstr);
 extern void free_jstring_list(struct jstring **jstring_list);
+extern size_t parse_window(char const *optarg);
+extern bool read_window(FILE *stream, char *buf, size_t size, bool ignore_nl, size_t *len, bool *eof);
 
 
 #endif /* INCLUDE_JSTR_UTIL_H */
@@ -67,7 +67,7 @@
  * Use the usage() function to print the usage_msg([0-9]?)+ strings.
  */
 static const char * const usage_msg =
-    "usage: %s [-h] [-v level] [-j] [-J level] [-q] [-V] [-t] [-n] [-N] [-Q] [-e] [-d] [-E level] [arg ...]\n"
+    "usage: %s [-h] [-v level] [-j] [-J level] [-q] [-V] [-t] [-n] [-N] [-Q] [-e] [-d] [-S window] [-E level] [arg ...]\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
     "\t-v level\tset verbosity level (def level: %d)\n"
@@ -83,6 +83,8 @@ static const char * const usage_msg =
     "\t-e\t\tfor multiple args, enclose each decoded arg in escaped double quotes (def: do not)\n"
     "\t-d\t\tdo not require a leading and trailing double quote (def: do require)\n"
     "\t\t\t\tNOTE: -d and -j cannot be used together\n"
+    "\t-S window\tdecode stdin window bytes at a time, writing as it goes, in constant memory (0 ==> %zu)\n"
+    "\t\t\t\tNOTE: -S and -j cannot be used together\n"
     "\t-E level\tentertainment mode\n"
     "\n"
     "\t[arg ...]\tJSON decode args on command line (def: read stdin)\n"
@@ -106,6 +108,10 @@ static const char * const usage_msg =
  */
 static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
 static struct jstring *jstrdecode_stream(FILE *in_stream, bool ignore_nl, bool quote, bool json_parse);
+static bool jstrdecode_window(FILE *in_stream, size_t window, bool ignore_nl, bool quote);
+static bool write_decoded_strings(bool write_quote, bool esc_each, bool *quoted);
+static bool write_decoded_window(size_t window, bool ignore_nl, bool quote, bool write_quote, bool esc_each,
+				 bool *quoted);
 static struct jstring *add_decoded_string(char *string, size_t bufsiz);
 
 /*
@@ -358,6 +364,323 @@ jstrdecode_stream(FILE *in_stream, bool ignore_nl, bool quote, bool json_parse)
 }
 
 
+/*
+ * jstrdecode_window - decode an open file stream a window at a time (-S)
+ *
+ * Unlike jstrdecode_stream(), the stream is not read all at once: each window
+ * of the stream is decoded and written to stdout before the next is read, so
+ * that the output starts at once and the memory used does not grow with the
+ * size of the stream.  A window is only decoded up to where json_decode_cut()
+ * says it may be cut: a \-escape (or a \uxxxx\uxxxx surrogate pair) that
+ * might run past the end of the window is carried over to the front of the
+ * next one, as is the last byte, in case it is the closing double quote.
+ *
+ * given:
+ *	in_stream	open file stream to decode
+ *	window		bytes to read and decode at a time
+ *	ignore_nl	true ==> ignore all newline characters
+ *	quote		true ==> require leading and trailing double quotes
+ *
+ * returns:
+ *	true ==> decoding was successful,
+ *	false ==> error in decoding, or NULL stream, or read or write error
+ *
+ * NOTE: If an error is found, what was decoded before it has already been written.
+ */
+static bool
+jstrdecode_window(FILE *in_stream, size_t window, bool ignore_nl, bool quote)
+{
+    char *input = NULL;		/* window of the stream after what was carried over */
+    size_t size = 0;		/* size of input without the guard NUL byte */
+    size_t have = 0;		/* bytes in input */
+    size_t got = 0;		/* bytes read into input */
+    size_t start = 0;		/* first byte of input to decode */
+    size_t end = 0;		/* beyond the last byte of input that could be decoded */
+    size_t cut = 0;		/* beyond the last byte of input to decode now */
+    char *buf = NULL;		/* decode buffer */
+    size_t bufsiz = 0;		/* length of the buffer */
+    size_t outputlen = 0;	/* length of write of decode buffer */
+    uintmax_t total = 0;	/* bytes read from in_stream so far */
+    bool eof = false;		/* true ==> end of in_stream */
+    bool first = true;		/* true ==> first window */
+    bool ret = true;		/* true ==> decoding OK */
+
+    /*
+     * firewall
+     */
+    if (in_stream == NULL) {
+	warn(__func__, "in_stream is NULL");
+	return false;
+    }
+
+    /*
+     * allocate the window with room for what is carried over
+     */
+    size = window + JSON_DECODE_ESC_MAX;
+    errno = 0;			/* pre-clear errno for errp() */
+    input = calloc(size + 1, sizeof(*input));
+    if (input == NULL) {
+	errp(15, __func__, "calloc of %zu byte window failed", size + 1);
+	not_reached();
+    }
+
+    /*
+     * decode and write a window at a time
+     */
+    dbg(DBG_LOW, "about to decode data on input stream %zu bytes at a time", window);
+    do {
+
+	/*
+	 * fill the window after what was carried over
+	 */
+	if (!read_window(in_stream, input + have, size - have, ignore_nl, &got, &eof)) {
+	    warn(__func__, "error while reading data from input stream");
+	    ret = false;
+	    break;
+	}
+	have += got;
+	total += got;
+	input[have] = '\0';	/* as json_decode() may look beyond the bytes it decodes */
+
+	/*
+	 * the stream must start with a double quote unless -d
+	 */
+	start = 0;
+	if (first) {
+	    first = false;
+	    if (quote) {
+		if (eof && have < 2) {
+		    warn(__func__, "quote === true: stream length: %zu < 2", have);
+		    ret = false;
+		    break;
+		}
+		if (input[0] != '"') {
+		    warn(__func__, "quote === true: stream does NOT start with a \"");
+		    ret = false;
+		    break;
+		}
+		start = 1;
+	    }
+	}
+
+	/*
+	 * case: end of stream - decode the rest, which must end with a double quote unless -d
+	 */
+	if (eof) {
+	    end = have;
+	    if (quote) {
+		if (have <= 0 || input[have-1] != '"') {
+		    warn(__func__, "quote === true: stream does NOT end with a \"");
+		    ret = false;
+		    break;
+		}
+		--end;
+	    }
+	    cut = end;
+
+	/*
+	 * otherwise decode up to where the window can be cut, keeping back the
+	 * last byte in case it is the closing double quote
+	 */
+	} else {
+	    end = have - 1;
+	    cut = start + json_decode_cut(input + start, end - start);
+	}
+
+	/*
+	 * decode and write
+	 */
+	if (cut > start) {
+	    buf = json_decode(input + start, cut - start, false, &bufsiz);
+	    if (buf == NULL) {
+		warn(__func__, "error while decoding window ending at byte %ju", total);
+		ret = false;
+		break;
+	    }
+	    errno = 0;		/* pre-clear errno for warnp() */
+	    outputlen = fwrite(buf, 1, bufsiz, stdout);
+	    free(buf);
+	    buf = NULL;
+	    if (outputlen != bufsiz) {
+		warnp(__func__, "error: wrote %zu bytes out of expected %zu bytes", outputlen, bufsiz);
+		ret = false;
+		break;
+	    }
+	}
+
+	/*
+	 * carry what was not decoded over to the front of the window
+	 */
+	if (cut < start) {
+	    cut = start;
+	}
+	memmove(input, input + cut, have - cut);
+	have -= cut;
+    } while (!eof);
+    dbg(DBG_MED, "stream read length: %ju", total);
+
+    /*
+     * free the window
+     */
+    free(input);
+    input = NULL;
+    return ret;
+}
+
+
+/*
+ * write_decoded_strings - write and free the decoded strings so far
+ *
+ * Each decoded string of the json_decoded_strings list is written to stdout,
+ * preceded, before the first string written, by the starting double quote if
+ * requested.
+ *
+ * given:
+ *	write_quote	true ==> write enclosing double quotes (-Q)
+ *	esc_each	true ==> enclose each decoded string in escaped double quotes (-e)
+ *	quoted		pointer to true ==> starting double quote already written
+ *
+ * returns:
+ *	true ==> all were written,
+ *	false ==> NULL arg or write error
+ *
+ * NOTE: The list is empty on return.
+ */
+static bool
+write_decoded_strings(bool write_quote, bool esc_each, bool *quoted)
+{
+    struct jstring *jstr = NULL;    /* to iterate through list */
+    size_t outputlen;		/* length of write of decode buffer */
+    bool ret = true;		/* true ==> all written */
+
+    /*
+     * firewall
+     */
+    if (quoted == NULL) {
+	warn(__func__, "quoted is NULL");
+	return false;
+    }
+
+    /*
+     * write starting quote if requested and we have at least one decoded string
+     */
+    if (write_quote && !*quoted && json_decoded_strings != NULL && json_decoded_strings->jstr != NULL) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	if (fputc('"', stdout) != '"') {
+	    warnp(__func__, "fputc for starting quote returned error");
+	    ret = false;
+	}
+	*quoted = true;
+    }
+
+    /*
+     * now write each processed arg to stdout
+     */
+    for (jstr = json_decoded_strings; jstr != NULL; jstr = jstr->next) {
+	dbg(DBG_MED, "processing decoded JSON string of size: %zu", jstr->bufsiz);
+	/*
+	 * write starting escaped quote if requested
+	 */
+	if (esc_each) {
+	    fprint(stdout, "%s", "\\\"");
+	}
+	errno = 0;		/* pre-clear errno for warnp() */
+	outputlen = fwrite(jstr->jstr, 1, jstr->bufsiz, stdout);
+	if (outputlen != jstr->bufsiz) {
+	    warnp(__func__, "error: wrote %zu bytes out of expected %zd bytes",
+			    outputlen, jstr->bufsiz);
+	    ret = false;
+	}
+
+	/*
+	 * write ending escaped quote if requested
+	 */
+	if (esc_each) {
+	    fprint(stdout, "%s", "\\\"");
+	}
+    }
+
+    /*
+     * free list of decoded strings
+     */
+    free_jstring_list(&json_decoded_strings);
+    json_decoded_strings = NULL;
+    return ret;
+}
+
+
+/*
+ * write_decoded_window - decode and write stdin a window at a time (-S)
+ *
+ * Like write_decoded_strings(), the starting double quote is written before
+ * anything else if requested, but stdin is written as it is decoded by
+ * jstrdecode_window() rather than being added to the decoded strings list.
+ *
+ * given:
+ *	window		bytes to read and decode at a time
+ *	ignore_nl	true ==> ignore all newline characters
+ *	quote		true ==> ignore JSON double quotes: both stream[0] and stream[len-1]
+ *			must be '"'
+ *	write_quote	true ==> write enclosing double quotes (-Q)
+ *	esc_each	true ==> enclose each decoded string in escaped double quotes (-e)
+ *	quoted		pointer to true ==> starting double quote already written
+ *
+ * returns:
+ *	true ==> stdin was decoded and written,
+ *	false ==> NULL arg, decoding or write error
+ *
+ * NOTE: On a decoding error what was decoded before the error has already
+ *	 been written.
+ */
+static bool
+write_decoded_window(size_t window, bool ignore_nl, bool quote, bool write_quote, bool esc_each, bool *quoted)
+{
+    bool ret = true;		/* true ==> all decoded and written */
+
+    /*
+     * firewall
+     */
+    if (quoted == NULL) {
+	warn(__func__, "quoted is NULL");
+	return false;
+    }
+
+    /*
+     * write starting quote if requested and not already written
+     */
+    if (write_quote && !*quoted) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	if (fputc('"', stdout) != '"') {
+	    warnp(__func__, "fputc for starting quote returned error");
+	    ret = false;
+	}
+	*quoted = true;
+    }
+
+    /*
+     * write starting escaped quote if requested
+     */
+    if (esc_each) {
+	fprint(stdout, "%s", "\\\"");
+    }
+
+    /*
+     * decode and write stdin
+     */
+    if (!jstrdecode_window(stdin, window, ignore_nl, quote)) {
+	ret = false;
+    }
+
+    /*
+     * write ending escaped quote if requested
+     */
+    if (esc_each) {
+	fprint(stdout, "%s", "\\\"");
+    }
+    return ret;
+}
+
+
 int
 main(int argc, char **argv)
 {
@@ -368,7 +691,9 @@ main(int argc, char **argv)
     size_t inputlen;		/* length of input buffer */
     char *buf;			/* decode buffer */
     size_t bufsiz;		/* length of the buffer */
-    size_t outputlen;		/* length of write of decode buffer */
+    size_t window = 0;		/* -S window in bytes, 0 ==> read all of stdin */
+    bool quoted = false;	/* true ==> starting double quote written */
+    bool esc_each = false;	/* true ==> enclose each decoded string in escaped double quotes */
     int entertainment = 0;	/* have some fun :-) */
     bool success = true;	/* true ==> encoding OK, false ==> error while encoding */
     bool nloutput = true;	/* true ==> output newline after JSON decode */
@@ -394,7 +719,7 @@ main(int argc, char **argv)
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:jJ:qVtnNQedE:")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:jJ:qVtnNQedS:E:")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 2 */
 	    usage(2, program, ""); /*ooo*/
@@ -454,6 +779,9 @@ main(int argc, char **argv)
 	    print("%s: Beginning chkbyte2asciistr test of the byte2asciistr table...\n", program);
 	    chkbyte2asciistr();
 	    print("%s: ... passed byte2asciistr table test\n", program);
+	    print("%s: Beginning json_string_span test of the %s code...\n", program, json_string_span_impl());
+	    chk_json_string_span();
+	    print("%s: ... passed json_string_span test\n", program);
 	    print("%s: Beginning jdecencchk...\n", program);
 	    jdecencchk(entertainment);
 	    print("%s: ... passed jdecencchk\n", program);
@@ -472,6 +800,13 @@ main(int argc, char **argv)
 	case 'e':
 	    esc_quotes = true;
 	    break;
+	case 'S':		/* -S window - decode stdin a window at a time */
+	    window = parse_window(optarg);
+	    if (window <= 0) {
+		usage(3, program, "invalid -S window"); /*ooo*/
+		not_reached();
+	    }
+	    break;
 	case ':':   /* option requires an argument */
 	case '?':   /* illegal option */
 	default:    /* anything else but should not actually happen */
@@ -494,6 +829,15 @@ main(int argc, char **argv)
         usage(3, program, "-j and -d cannot be used together"); /*ooo*/
         not_reached();
     }
+    /*
+     * -j and -S cannot be used together because -j parses all of the input
+     * before any of it is decoded.
+     */
+    if (json_parse && window > 0) {
+        usage(3, program, "-j and -S cannot be used together"); /*ooo*/
+        not_reached();
+    }
+    esc_each = (esc_quotes && argc - optind > 1);
     dbg(DBG_LOW, "argc: %d", argc);
     dbg(DBG_LOW, "optind: %d", optind);
     dbg(DBG_LOW, "arg count: %d", argc - optind);
@@ -503,6 +847,7 @@ main(int argc, char **argv)
     dbg(DBG_LOW, "escaped quotes: %s", booltostr(esc_quotes));
     dbg(DBG_LOW, "ignore surrounding quotes: %s", booltostr(quote));
     dbg(DBG_LOW, "parse JSON encoded string before decoding: %s", booltostr(json_parse));
+    dbg(DBG_LOW, "-S window: %zu", window);
 
     /*
      * case: process arguments on command line
@@ -520,6 +865,20 @@ main(int argc, char **argv)
 
 	    if (!strcmp(input, "-")) {
 
+		/*
+		 * if -S, write what came before and then stdin as it is decoded
+		 */
+		if (window > 0) {
+		    if (!write_decoded_strings(write_quote, esc_each, &quoted)) {
+			success = false;
+		    }
+		    if (!write_decoded_window(window, ignore_nl, quote, write_quote, esc_each, &quoted)) {
+			warn(__func__, "failed to decode string from stdin");
+			success = false;
+		    }
+		    continue;
+		}
+
 		/*
 		 * decode stdin
 		 *
@@ -611,6 +970,19 @@ main(int argc, char **argv)
 	    }
 	}
 
+    /*
+     * case: process data on stdin
+     */
+    /*
+     * case: -S, decode and write stdin a window at a time as it is read
+     */
+    } else if (window > 0) {
+
+	if (!write_decoded_window(window, ignore_nl, quote, write_quote, esc_each, &quoted)) {
+	    warn(__func__, "error while decoding processing stdin");
+	    success = false;
+	}
+
     /*
      * case: process data on stdin
      */
@@ -630,52 +1002,19 @@ main(int argc, char **argv)
 	    }
 	}
 
-    /*
-     * write starting quote if requested and we have at least one decoded string
-     */
-    if (write_quote && json_decoded_strings && json_decoded_strings->jstr != NULL) {
-	errno = 0;		/* pre-clear errno for warnp() */
-	ret = fputc('"', stdout);
-	if (ret != '"') {
-	    warnp(__func__, "fputc for starting quote returned error");
-	    success = false;
-	}
-    }
-
     /*
      * now write each processed arg to stdout
+     *
+     * NOTE: with -S, what came before stdin has already been written
      */
-    for (jstr = json_decoded_strings; jstr != NULL; jstr = jstr->next) {
-	dbg(DBG_MED, "processing decoded JSON string of size: %zu", jstr->bufsiz);
-	/*
-	 * write starting escaped quote if requested
-	 */
-	if (esc_quotes && argc - optind > 1) {
-	    fprint(stdout, "%s", "\\\"");
-	}
-	buf = jstr->jstr;
-	bufsiz = (uintmax_t)jstr->bufsiz;
-	dbg(DBG_MED, "bufsiz: %zu", bufsiz);
-	errno = 0;		/* pre-clear errno for warnp() */
-	outputlen = fwrite(buf, 1, bufsiz, stdout);
-	if (outputlen != bufsiz) {
-	    warnp(__func__, "error: wrote %zu bytes out of expected %zd bytes",
-			    outputlen, bufsiz);
-	    success = false;
-	}
-
-	/*
-	 * write ending escaped quote if requested
-	 */
-	if (esc_quotes && argc - optind > 1) {
-	    fprint(stdout, "%s", "\\\"");
-	}
+    if (!write_decoded_strings(write_quote, esc_each, &quoted)) {
+	success = false;
     }
 
     /*
-     * write starting quote if requested and we have at least one decoded string
+     * write ending quote if the starting quote was written
      */
-    if (write_quote && json_decoded_strings && json_decoded_strings->jstr != NULL) {
+    if (quoted) {
 	errno = 0;		/* pre-clear errno for warnp() */
 	ret = fputc('"', stdout);
 	if (ret != '"') {
@@ -696,12 +1035,6 @@ main(int argc, char **argv)
 	}
     }
 
-    /*
-     * free list of decoded strings
-     */
-    free_jstring_list(&json_decoded_strings);
-    json_decoded_strings = NULL;
-
     /*
      * All Done!!! All Done!!! -- Jessica Noll, Age 2
      */
@@ -751,7 +1084,8 @@ usage(int exitcode, char const *prog, char const *str)
     }
 
 
-    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, JSON_DBG_DEFAULT, JSTRDECODE_BASENAME, JSTRDECODE_VERSION,
+    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, JSON_DBG_DEFAULT, (size_t)JSTR_WINDOW_DEF,
+	    JSTRDECODE_BASENAME, JSTRDECODE_VERSION,
 	    JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION);
     exit(exitcode); /*ooo*/
     not_reached();
@@ -67,7 +67,7 @@
  * Use the usage() function to print the usage_msg([0-9]?)+ strings.
  */
 static const char * const usage_msg =
-    "usage: %s [-h] [-v level] [-q] [-V] [-t] [-n] [-N] [-Q] [-e] [-E level] [arg ...]\n"
+    "usage: %s [-h] [-v level] [-q] [-V] [-t] [-n] [-N] [-Q] [-e] [-S window] [-E level] [arg ...]\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
     "\t-v level\tset verbosity level: (def level: %d)\n"
@@ -78,6 +78,8 @@ static const char * const usage_msg =
     "\t-N\t\tignore all newline characters in input\n"
     "\t-Q\t\tskip double quotes that enclose each arg's concatenation\n"
     "\t-e\t\tskip double quotes that enclose each arg\n"
+    "\t-S window\tencode stdin window bytes at a time, writing as it goes, in constant memory (0 ==> %zu)\n"
+    "\t\t\t\tNOTE: -S cannot be used with -Q or -e\n"
     "\t-E level\tentertainment mode\n"
     "\n"
     "\t[arg ...]\tJSON encode the concatenation of args (def: encode stdin)\n"
@@ -102,6 +104,8 @@ static const char * const usage_msg =
 static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
 static struct jstring *jstrencode_stream(FILE *in_stream, bool skip_enclosing, bool ignore_first, bool remove_last,
 	bool ignore_nl);
+static bool jstrencode_window(FILE *in_stream, size_t window, bool ignore_nl);
+static bool write_encoded_strings(bool *quoted);
 static struct jstring *add_encoded_string(char *string, size_t bufsiz);
 
 /*
@@ -405,6 +409,162 @@ jstrencode_stream(FILE *in_stream, bool skip_enclosing, bool ignore_first, bool
 }
 
 
+/*
+ * jstrencode_window - encode an open file stream a window at a time (-S)
+ *
+ * Unlike jstrencode_stream(), the stream is not read all at once: each window
+ * of the stream is encoded and written to stdout before the next is read, so
+ * that the output starts at once and the memory used does not grow with the
+ * size of the stream.  As every byte is encoded on its own, a window may end
+ * anywhere.
+ *
+ * given:
+ *	in_stream	open file stream to encode
+ *	window		bytes to read and encode at a time
+ *	ignore_nl	true ==> ignore all newline characters
+ *
+ * returns:
+ *	true ==> encoding was successful,
+ *	false ==> error in encoding, or NULL stream, or read or write error
+ *
+ * NOTE: If an error is found, what was encoded before it has already been written.
+ */
+static bool
+jstrencode_window(FILE *in_stream, size_t window, bool ignore_nl)
+{
+    char *input = NULL;		/* window of the stream */
+    size_t inputlen = 0;	/* length of the window */
+    char *buf = NULL;		/* encode buffer */
+    size_t bufsiz = 0;		/* length of the buffer */
+    size_t outputlen = 0;	/* length of write of encode buffer */
+    uintmax_t total = 0;	/* bytes read from in_stream so far */
+    bool eof = false;		/* true ==> end of in_stream */
+    bool ret = true;		/* true ==> encoding OK */
+
+    /*
+     * firewall
+     */
+    if (in_stream == NULL) {
+	warn(__func__, "in_stream is NULL");
+	return false;
+    }
+
+    /*
+     * allocate the window
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    input = calloc(window + 1, sizeof(*input));
+    if (input == NULL) {
+	errp(13, __func__, "calloc of %zu byte window failed", window + 1);
+	not_reached();
+    }
+
+    /*
+     * encode and write a window at a time
+     */
+    dbg(DBG_LOW, "about to encode data on input stream %zu bytes at a time", window);
+    do {
+	if (!read_window(in_stream, input, window, ignore_nl, &inputlen, &eof)) {
+	    warn(__func__, "error while reading data from input stream");
+	    ret = false;
+	    break;
+	}
+	total += inputlen;
+	if (inputlen <= 0) {
+	    continue;
+	}
+	buf = json_encode(input, inputlen, &bufsiz, false);
+	if (buf == NULL) {
+	    warn(__func__, "error while encoding window ending at byte %ju", total);
+	    ret = false;
+	    break;
+	}
+	errno = 0;		/* pre-clear errno for warnp() */
+	outputlen = fwrite(buf, 1, bufsiz, stdout);
+	free(buf);
+	buf = NULL;
+	if (outputlen != bufsiz) {
+	    warnp(__func__, "error: wrote %zu bytes out of expected %zu bytes", outputlen, bufsiz);
+	    ret = false;
+	    break;
+	}
+    } while (!eof);
+    dbg(DBG_MED, "stream read length: %ju", total);
+
+    /*
+     * free the window
+     */
+    free(input);
+    input = NULL;
+    return ret;
+}
+
+
+/*
+ * write_encoded_strings - write and free the encoded strings so far
+ *
+ * Each encoded string of the json_encoded_strings list is written to stdout,
+ * preceded, before the first string written, by the starting double quote.
+ *
+ * given:
+ *	quoted		pointer to true ==> starting double quote already written
+ *
+ * returns:
+ *	true ==> all were written,
+ *	false ==> NULL arg or write error
+ *
+ * NOTE: The list is empty on return.
+ */
+static bool
+write_encoded_strings(bool *quoted)
+{
+    struct jstring *jstr = NULL;    /* to iterate through list */
+    size_t outputlen;		/* length of write of encode buffer */
+    bool ret = true;		/* true ==> all written */
+
+    /*
+     * firewall
+     */
+    if (quoted == NULL) {
+	warn(__func__, "quoted is NULL");
+	return false;
+    }
+
+    /*
+     * if we have at least one encoded string, write a single double quote
+     */
+    if (!*quoted && json_encoded_strings != NULL && json_encoded_strings->jstr != NULL) {
+	errno = 0;		/* pre-clear errno for warnp() */
+	if (fputc('"', stdout) != '"') {
+	    warnp(__func__, "fputc for starting quote returned error");
+	    ret = false;
+	}
+	*quoted = true;
+    }
+
+    /*
+     * now write each processed arg to stdout
+     */
+    for (jstr = json_encoded_strings; jstr != NULL; jstr = jstr->next) {
+	if (jstr->jstr != NULL) {
+	    errno = 0;		/* pre-clear errno for warnp() */
+	    outputlen = fwrite(jstr->jstr, 1, jstr->bufsiz, stdout);
+	    if (outputlen != jstr->bufsiz) {
+		warnp(__func__, "error: wrote %zu bytes out of expected %zu bytes", outputlen, jstr->bufsiz);
+		ret = false;
+	    }
+	}
+    }
+
+    /*
+     * free list of encoded strings
+     */
+    free_jstring_list(&json_encoded_strings);
+    json_encoded_strings = NULL;
+    return ret;
+}
+
+
 int
 main(int argc, char **argv)
 {
@@ -415,7 +575,8 @@ main(int argc, char **argv)
     size_t inputlen = 0;	/* length of input buffer */
     char *buf;			/* encode buffer */
     size_t bufsiz;		/* length of the buffer */
-    size_t outputlen;		/* length of write of encode buffer */
+    size_t window = 0;		/* -S window in bytes, 0 ==> read all of stdin */
+    bool quoted = false;	/* true ==> starting double quote written */
     int entertainment = 0;	/* have some fun :-) */
     bool success = true;	/* true ==> encoding OK, false ==> error while encoding */
     bool nloutput = true;	/* true ==> output newline after JSON encode */
@@ -437,7 +598,7 @@ main(int argc, char **argv)
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:qVtnNQeE:")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:qVtnNQeS:E:")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 2 */
 	    usage(2, program, ""); /*ooo*/
@@ -481,6 +642,9 @@ main(int argc, char **argv)
 	    print("%s: Beginning chkbyte2asciistr test of the byte2asciistr table...\n", program);
 	    chkbyte2asciistr();
 	    print("%s: ... passed byte2asciistr table test\n", program);
+	    print("%s: Beginning json_string_span test of the %s code...\n", program, json_string_span_impl());
+	    chk_json_string_span();
+	    print("%s: ... passed json_string_span test\n", program);
 	    print("%s: Beginning jdecencchk...\n", program);
 	    jdecencchk(entertainment);
 	    print("%s: ... passed jdecencchk\n", program);
@@ -499,6 +663,13 @@ main(int argc, char **argv)
 	case 'e':
 	    skip_each = true;
 	    break;
+	case 'S':		/* -S window - encode stdin a window at a time */
+	    window = parse_window(optarg);
+	    if (window <= 0) {
+		usage(3, program, "invalid -S window"); /*ooo*/
+		not_reached();
+	    }
+	    break;
 	case ':':   /* option requires an argument */
 	case '?':   /* illegal option */
 	default:    /* anything else but should not actually happen */
@@ -516,6 +687,15 @@ main(int argc, char **argv)
     dbg(DBG_LOW, "-e: skip double quotes that enclose each arg: %s", booltostr(skip_each));
     dbg(DBG_LOW, "-n: do not print a final newline in output: %s", booltostr(nloutput));
     dbg(DBG_LOW, "-q: silence warnings: %s", booltostr(msg_warn_silent));
+    dbg(DBG_LOW, "-S: window: %zu", window);
+
+    /*
+     * -Q and -e depend on the last byte of stdin which -S writes before it is read
+     */
+    if (window > 0 && (skip_concat_quotes || skip_each)) {
+	usage(3, program, "-S cannot be used with -Q or -e"); /*ooo*/
+	not_reached();
+    }
 
 
     /*
@@ -539,6 +719,28 @@ main(int argc, char **argv)
 		 */
 		dbg(DBG_LOW, "encoding from stdin");
 
+		/*
+		 * if -S, write what came before and then stdin as it is encoded
+		 */
+		if (window > 0) {
+		    if (!write_encoded_strings(&quoted)) {
+			success = false;
+		    }
+		    if (!quoted) {
+			errno = 0;		/* pre-clear errno for warnp() */
+			if (fputc('"', stdout) != '"') {
+			    warnp(__func__, "fputc for starting quote returned error");
+			    success = false;
+			}
+			quoted = true;
+		    }
+		    if (!jstrencode_window(stdin, window, ignore_nl)) {
+			warn(__func__, "failed to encode string from stdin");
+			success = false;
+		    }
+		    continue;
+		}
+
 		/*
 		 * NOTE: the function jstrencode_stream() adds the allocated
 		 * struct jstring * to the list of encoded JSON strings
@@ -552,6 +754,7 @@ main(int argc, char **argv)
 		} else {
 		    dbg(DBG_LOW, "encoded buf size: %zu", jstr->bufsiz);
 		}
+		continue;
 
 	    } else {
 
@@ -680,64 +883,58 @@ main(int argc, char **argv)
     } else {
 
 	/*
-	 * read all of stdin
+	 * if -S, encode stdin a window at a time as it is read
 	 */
 	dbg(DBG_LOW, "encoding from stdin");
+	if (window > 0) {
+	    errno = 0;		/* pre-clear errno for warnp() */
+	    if (fputc('"', stdout) != '"') {
+		warnp(__func__, "fputc for starting quote returned error");
+		success = false;
+	    }
+	    quoted = true;
+	    if (!jstrencode_window(stdin, window, ignore_nl)) {
+		warn(__func__, "error while encoding processing stdin");
+		success = false;
+	    }
+
 	/*
-	 * NOTE: jstrencode_stream() adds the allocated struct jstring * to the
-	 * encoded JSON strings list
+	 * otherwise read all of stdin
 	 */
-	jstr = jstrencode_stream(stdin, skip_concat_quotes, skip_each, skip_each, ignore_nl);
-	if (jstr != NULL) {
-	    dbg(DBG_MED, "encode length: %zu", jstr->bufsiz);
 	} else {
-	    warn(__func__, "error while encoding processing stdin");
-	    success = false;
+	    /*
+	     * NOTE: jstrencode_stream() adds the allocated struct jstring * to the
+	     * encoded JSON strings list
+	     */
+	    jstr = jstrencode_stream(stdin, skip_concat_quotes, skip_each, skip_each, ignore_nl);
+	    if (jstr != NULL) {
+		dbg(DBG_MED, "encode length: %zu", jstr->bufsiz);
+	    } else {
+		warn(__func__, "error while encoding processing stdin");
+		success = false;
+	    }
 	}
     }
 
     /*
-     * if we have at least one encoded string, write a single double quote
-     */
-    if (json_encoded_strings && json_encoded_strings->jstr != NULL && json_encoded_strings->jstr != NULL) {
-	errno = 0;		/* pre-clear errno for warnp() */
-	ret = fputc('"', stdout);
-	if (ret != '"') {
-	    warnp(__func__, "fputc for starting quote returned error");
-	    success = false;
-	}
-    }
-    /*
-     * now write each processed arg to stdout
+     * write each encoded string not yet written, after a single double quote
      */
-    for (jstr = json_encoded_strings; jstr != NULL; jstr = jstr->next) {
-	if (jstr->jstr != NULL) {
-	    buf = jstr->jstr;
-	    bufsiz = (uintmax_t)jstr->bufsiz;
-	    errno = 0;		/* pre-clear errno for warnp() */
-	    outputlen = fwrite(buf, 1, bufsiz, stdout);
-	    if (outputlen != bufsiz) {
-		warnp(__func__, "error: wrote %zu bytes out of expected %zu bytes", outputlen, bufsiz);
-		success = false;
-	    }
-	}
+    if (!write_encoded_strings(&quoted)) {
+	success = false;
     }
 
     /*
-     * if we have at least one encoded string, write a single double quote
+     * if we wrote a starting double quote, write a single double quote
      */
-    if (json_encoded_strings && json_encoded_strings->jstr != NULL && json_encoded_strings->jstr != NULL) {
+    if (quoted) {
 	errno = 0;		/* pre-clear errno for warnp() */
 	ret = fputc('"', stdout);
 	if (ret != '"') {
-	    warnp(__func__, "fputc for starting quote returned error");
+	    warnp(__func__, "fputc for ending quote returned error");
 	    success = false;
 	}
     }
 
-
-
-
     /*
      * unless -n, output newline
      */
@@ -750,12 +947,6 @@ main(int argc, char **argv)
 	}
     }
 
-    /*
-     * free list of encoded strings
-     */
-    free_jstring_list(&json_encoded_strings);
-    json_encoded_strings = NULL;
-
     /*
      * All Done!!! All Done!!! -- Jessica Noll, Age 2
      */
@@ -803,7 +994,7 @@ usage(int exitcode, char const *prog, char const *str)
     if (*str != '\0') {
 	fprintf_usage(DO_NOT_EXIT, stderr, "%s\n", str);
     }
-    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, JSTRENCODE_BASENAME, JSTRENCODE_VERSION,
+    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, (size_t)JSTR_WINDOW_DEF, JSTRENCODE_BASENAME, JSTRENCODE_VERSION,
 	    JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION);
     exit(exitcode); /*ooo*/
     not_reached();
@@ -101,7 +101,7 @@
 /*
  * official jstrencode version
  */
-#define JSTRENCODE_VERSION "2.2.3 2025-06-26"	/* format: major.minor YYYY-MM-DD */
+#define JSTRENCODE_VERSION "2.2.5 2026-10-19"	/* format: major.minor YYYY-MM-DD */
 
 /*
  * jstrencode tool basename
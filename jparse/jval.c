@@ -51,9 +51,9 @@
 #include <string.h>
 
 /*
- * jval - XXX - fill out - XXX
+ * jval - use XPath for JSON to analyse, transform and selectively extract data from JSON
  */
-#include "jparse_main.h"
+#include "jval.h"
 
 
 /*
@@ -61,26 +61,49 @@
  *
  */
 #define REQUIRED_ARGS (2)	/* number of required arguments on the command line */
+#define JVAL_BIT(i) (((uint64_t)1) << (i))	/* bit of step i in a set of steps */
 
 /*
  * usage message
  */
 static const char * const usage_msg =
-    "usage: %s [-h] [-v level] [-J level] [-q] [-V] [-use-jparse] file.json pattern\n"
+    "usage: %s [-h] [-v level] [-J level] [-q] [-V] [-N] [-S] [-I index] [-use-jparse] file.json pattern\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
     "\t-v level\tset verbosity level (def level: %d)\n"
     "\t-J level\tset JSON verbosity level (def level: %d)\n"
     "\t-q\t\tquiet mode: silence msg(), warn(), warnp() if -v 0 (def: loud :-) )\n"
     "\t-V\t\tprint version strings and exit\n"
+    "\t-N\t\tfile.json is JSON Lines (NDJSON): each line is a JSON document\n"
+    "\t-S\t\tstream: match JSON events as they are parsed, without forming a JSON parse tree\n"
+    "\t-I index\tlook the pattern up in the path index file index of file.json, which is\n"
+    "\t\t\tformed when it does not exist or file.json changed since it was formed,\n"
+    "\t\t\tand parse only the values found (pattern must be names only: no *, // or [...]);\n"
+    "\t\t\tfile.json is parsed whole if the path index cannot be formed or used\n"
     "\n"
     "\t-use-jparse\tDo nothing: verify this tool came from the jparse toolset.\n"
     "\n"
     "\tfile.json\tJSON input file\n"
     "\t\t\tNOTE: if file.json is - (dash) read from standard input.\n"
-    "\t\t\tNOTE: if file.json is . (dot) do not read any file, perform an internal test\n"
-    "\t\t\tand exit accordingly.\n"
-    "\tpattern\t\tXPath Expression\n"
+    "\tpattern\t\tXPath Expression: each match is printed as compact JSON on a line of its own\n"
+    "\n"
+    "\t\t\t/\t\tthe whole JSON document\n"
+    "\t\t\t/name\t\tJSON member name (or JSON array index) of the JSON document\n"
+    "\t\t\t/a/name\t\tJSON member name (or JSON array index) of what /a matched\n"
+    "\t\t\t//name\t\tJSON member name (or JSON array index) at any depth\n"
+    "\t\t\t*\t\tany JSON member or JSON array element, in place of name\n"
+    "\t\t\t\\c\t\tthe character c in name, such as \\/ or \\*\n"
+    "\n"
+    "\t\t\tA name (or *) may be followed by any of these predicates:\n"
+    "\n"
+    "\t\t\t[type=types]\tcomma separated types: int, float, exp, num, bool, str,\n"
+    "\t\t\t\t\tnull, simple, object and array\n"
+    "\t\t\t[num=range]\tJSON integer in range\n"
+    "\t\t\t[index=range]\tposition in the JSON object or JSON array (from 0) in range\n"
+    "\n"
+    "\t\t\twhere range is: n, min:max, min: or :max\n"
+    "\t\t\tNOTE: [index=min:-n] is up through the number of members or elements less n,\n"
+    "\t\t\tand cannot be used with -S.\n"
     "\n"
     "Exit codes:\n"
     "    0\tJSON is valid\n"
@@ -99,6 +122,37 @@ static const char * const usage_msg =
  * static functions
  */
 static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
+static bool jval_compile_pred(struct jval_plan *plan, struct jval_step *step, char *pred, char const *pattern);
+static uintmax_t jval_types(enum item_type type, char const *text, size_t len, struct json const *node);
+static bool jval_step_match(struct jval_query *q, struct jval_step const *step, struct jval_frame const *parent,
+			    intmax_t pos, enum item_type type, uintmax_t bits, char const *text, size_t len,
+			    struct json const *node, struct json **conv);
+static void jval_write(struct jval_query *q, char const *text, size_t len);
+static void jval_write_str(struct jval_query *q, char const *str, size_t len, bool name);
+static void jval_write_value(struct jval_query *q, enum item_type type, char const *text, size_t len);
+static void jval_done(struct jval_query *q);
+static bool jval_tree_begin(struct jval_query *q, struct json *node);
+static void jval_tree_index(struct jval_query *q, struct jval_walk *w);
+static struct jval_plan const jval_root_plan;	/* plan of the pattern /: all of a JSON value */
+static bool jval_start_object(void *data);
+static bool jval_end_container(void *data);
+static bool jval_start_array(void *data);
+static bool jval_member_name(void *data, char const *name, size_t len);
+static bool jval_value(void *data, enum item_type type, char const *str, size_t len);
+
+
+/*
+ * JSON event callbacks that evaluate a query plan over a stream (-S)
+ */
+static struct json_event_cb const jval_stream_cb = {
+    jval_start_object,
+    jval_end_container,
+    jval_start_array,
+    jval_end_container,
+    jval_member_name,
+    jval_value,
+    NULL,
+};
 
 
 int
@@ -113,6 +167,16 @@ main(int argc, char **argv)
     int exit_code = 0;              /* exit code depends on if any JSON is invalid */
     struct json *tree = NULL;	    /* JSON parse tree or NULL */
     bool opt_error = false;		/* fchk_inval_opt() return */
+    bool ndjson_flag_used = false;  /* true ==> -N was used */
+    bool stream_flag_used = false;  /* true ==> -S was used */
+    char const *index_path = NULL;  /* -I path index file, or NULL */
+    struct json_ndjson nd;	    /* -N JSON Lines (NDJSON) record reader */
+    FILE *stream = NULL;	    /* -N file stream to read from */
+    char *rec = NULL;		    /* -N current record */
+    size_t len = 0;		    /* -N length of rec */
+    int line = 0;		    /* -N line number of rec */
+    static struct jval_plan plan;   /* compiled pattern */
+    struct jval_query q;	    /* evaluation of the compiled pattern */
     int i;
 
     /*
@@ -124,7 +188,7 @@ main(int argc, char **argv)
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:qVJ:u:")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:qVJ:u:NSI:")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 0 */
 	    usage(2, program, ""); /*ooo*/
@@ -160,13 +224,22 @@ main(int argc, char **argv)
 	    msg_warn_silent = true;
 	    break;
 	case 'V':		/* -V - print version strings and exit */
-	    print("%s version: %s\n", JPARSE_BASENAME, JPARSE_TOOL_VERSION);
+	    print("%s version: %s\n", JPARSE_BASENAME, JVAL_VERSION);
 	    print("jparse utils version: %s\n", JPARSE_UTILS_VERSION);
 	    print("jparse UTF-8 version: %s\n", JPARSE_UTF8_VERSION);
 	    print("jparse library version: %s\n", JPARSE_LIBRARY_VERSION);
 	    exit(2); /*ooo*/
 	    not_reached();
 	    break;
+	case 'N':
+	    ndjson_flag_used = true;
+	    break;
+	case 'S':
+	    stream_flag_used = true;
+	    break;
+	case 'I':
+	    index_path = optarg;
+	    break;
 	case ':':   /* option requires an argument */
 	case '?':   /* illegal option */
 	default:    /* anything else but should not actually happen */
@@ -197,25 +270,131 @@ main(int argc, char **argv)
 	usage(3, program, "pattern NULL or empty"); /*ooo*/
 	not_reached();
     }
-    dbg(DBG_HIGH, "Calling parse_json_file(\"%s\", &valid_json):", json_path);
-    tree = parse_json_file(json_path, &valid_json);
-    if (tree == NULL || !valid_json) {
-        warn(program, "JSON parse tree is NULL for file: %s", json_path);
-        exit_code = 1;
+
+    /*
+     * compile the pattern once, before any JSON is parsed
+     */
+    if (!jval_compile(pattern, &plan)) {
+	usage(3, program, "invalid pattern"); /*ooo*/
+	not_reached();
+    }
+    if (stream_flag_used && plan.need_len) {
+	usage(3, program, "-S cannot be used with [index=min:-n]"); /*ooo*/
+	not_reached();
+    }
+    if (index_path != NULL) {
+	if (ndjson_flag_used || stream_flag_used) {
+	    usage(3, program, "-I cannot be used with -N or -S"); /*ooo*/
+	    not_reached();
+	}
+	if (strcmp(json_path, "-") == 0) {
+	    usage(3, program, "-I cannot be used with standard input"); /*ooo*/
+	    not_reached();
+	}
+	if (!jval_plan_is_path(&plan)) {
+	    usage(3, program, "-I needs a pattern of names only: no *, // or predicates"); /*ooo*/
+	    not_reached();
+	}
     }
+    dbg(DBG_MED, "compiled pattern %s into %zu step(s)", pattern, plan.steps);
+    jval_query_init(&q, &plan, stdout);
+
+    /*
+     * case: -N - parse each record of a JSON Lines (NDJSON) file
+     */
+    if (ndjson_flag_used == true) {
+	if (strcmp(json_path, "-") == 0) {
+	    stream = stdin;
+	} else {
+	    errno = 0;			/* pre-clear errno */
+	    stream = fopen(json_path, "r");
+	    if (stream == NULL) {
+		errp(1, program, "couldn't open file: %s", json_path); /*ooo*/
+		not_reached();
+	    }
+	}
+	json_ndjson_init(&nd, stream, json_path);
+	while (json_ndjson_next(&nd, &rec, &len, &line)) {
+	    jval_query_reset(&q);
+
+	    /*
+	     * case: -S - match the JSON events of the record as they are parsed
+	     */
+	    if (stream_flag_used) {
+		dbg(DBG_HIGH, "Calling parse_json_ndjson_record_events() on line %d of: %s", line, json_path);
+		valid_json = parse_json_ndjson_record_events(rec, len, json_path, line, &jval_stream_cb, &q);
+		if (!valid_json) {
+		    warn(program, "JSON is not valid for record at line %d of file: %s", line, json_path);
+		    exit_code = 1;
+		}
+		continue;
+	    }
+
+	    dbg(DBG_HIGH, "Calling parse_json_ndjson_record() on line %d of: %s", line, json_path);
+	    tree = parse_json_ndjson_record(rec, len, json_path, line, &valid_json);
+	    if (tree == NULL || !valid_json) {
+		warn(program, "JSON is not valid for record at line %d of file: %s", line, json_path);
+		exit_code = 1;
+	    } else {
+		jval_tree(&q, tree);
+	    }
+	    /*
+	     * free the JSON parse tree
+	     */
+	    if (tree != NULL) {
+		json_tree_free(tree, JSON_INFINITE_DEPTH);
+		free(tree);
+		tree = NULL;
+	    }
+	}
+	dbg(DBG_HIGH, "parsed %jd records of: %s", nd.records, json_path);
+	json_ndjson_free(&nd);
+
+    /*
+     * case: -I - look the pattern up in the path index of file.json
+     */
+    } else if (index_path != NULL) {
+	dbg(DBG_HIGH, "Calling jval_index(&q, \"%s\", \"%s\"):", json_path, index_path);
+	if (!jval_index(&q, json_path, index_path)) {
+	    warn(program, "JSON is not valid for file: %s", json_path);
+	    exit_code = 1;
+	}
+
+    /*
+     * case: -S - match the JSON events of file.json as they are parsed
+     */
+    } else if (stream_flag_used == true) {
+	dbg(DBG_HIGH, "Calling parse_json_file_events(\"%s\", &jval_stream_cb, &q):", json_path);
+	valid_json = parse_json_file_events(json_path, &jval_stream_cb, &q);
+	if (!valid_json) {
+	    warn(program, "JSON is not valid for file: %s", json_path);
+	    exit_code = 1;
+	}
+
     /*
-     * free the JSON parse tree
+     * case: parse file.json as a single JSON document
      */
-    else {
-        dbg(DBG_HIGH, "%s is valid JSON", strcmp(json_path,"-")?json_path:"stdin");
-        /*
-         * XXX - write the XPath code here (or call a function to do so), before
-         * freeing the tree - XXX
-         */
-        json_tree_free(tree, JSON_INFINITE_DEPTH);
-        free(tree);
-        tree = NULL;
+    } else {
+	dbg(DBG_HIGH, "Calling parse_json_file(\"%s\", &valid_json):", json_path);
+	tree = parse_json_file(json_path, &valid_json);
+	if (tree == NULL || !valid_json) {
+	    warn(program, "JSON parse tree is NULL for file: %s", json_path);
+	    exit_code = 1;
+	}
+	/*
+	 * match the pattern and free the JSON parse tree
+	 */
+	else {
+	    dbg(DBG_HIGH, "%s is valid JSON", strcmp(json_path,"-")?json_path:"stdin");
+	    jval_tree(&q, tree);
+	    json_tree_free(tree, JSON_INFINITE_DEPTH);
+	    free(tree);
+	    tree = NULL;
+	}
     }
+    dbg(DBG_MED, "%ju match(es) of pattern: %s", q.matches, pattern);
+    jval_query_free(&q);
+    jval_plan_free(&plan);
 
     /*
      * firewall - JSON parser must have returned a valid JSON parse tree
@@ -272,8 +451,1246 @@ usage(int exitcode, char const *prog, char const *str)
 	fprintf_usage(DO_NOT_EXIT, stderr, "%s\n", str);
     }
     fprintf_usage(exitcode, stderr, usage_msg, prog,
-		  DBG_DEFAULT, JSON_DBG_DEFAULT, JPARSE_BASENAME, JPARSE_TOOL_VERSION, JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION,
+		  DBG_DEFAULT, JSON_DBG_DEFAULT, JPARSE_BASENAME, JVAL_VERSION, JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION,
                   JPARSE_LIBRARY_VERSION);
     exit(exitcode); /*ooo*/
     not_reached();
 }
+
+
+/*
+ * jval_compile - compile a pattern into a query plan
+ *
+ * See the jval query plan comment in jval.h for the pattern syntax.  The
+ * leading / of the first step may be left out.
+ *
+ * given:
+ *	pattern	    pattern to compile
+ *	plan	    pointer to the query plan to fill in
+ *
+ * returns:
+ *	true ==> pattern compiled into plan, free it with jval_plan_free()
+ *	false ==> pattern is invalid (after a warning), or NULL arg
+ *
+ * NOTE: A [num=range] or [index=range] with an invalid range, or a [type=types]
+ *	 with an unknown type, is a command line error: this function does not
+ *	 return (see json_util_parse_number_range() and json_util_parse_match_types()).
+ *
+ * NOTE: This function does not return on malloc error.
+ */
+bool
+jval_compile(char const *pattern, struct jval_plan *plan)
+{
+    struct jval_step *step = NULL;	/* step being compiled */
+    char const *p = NULL;		/* next character of the pattern */
+    char const *end = NULL;		/* ] of a predicate */
+    char *pred = NULL;			/* malloced predicate, between [ and ] */
+    bool escaped = false;		/* true ==> a character of the name was \ escaped */
+    bool ok = false;			/* true ==> predicate is valid */
+    size_t n = 0;
+
+    /*
+     * firewall
+     */
+    if (pattern == NULL || plan == NULL) {
+	warn(__func__, "called with NULL arg(s)");
+	return false;
+    }
+    memset(plan, 0, sizeof(*plan));
+
+    /*
+     * case: / is the whole JSON document
+     */
+    if (strcmp(pattern, "/") == 0) {
+	return true;
+    }
+
+    /*
+     * compile each step
+     */
+    for (p = pattern; *p != '\0'; ) {
+	if (plan->steps >= JVAL_MAX_STEPS) {
+	    warn(__func__, "pattern has more than %d steps: %s", JVAL_MAX_STEPS, pattern);
+	    jval_plan_free(plan);
+	    return false;
+	}
+	step = &plan->step[plan->steps++];
+
+	/*
+	 * / or // before the step
+	 */
+	if (*p == '/') {
+	    ++p;
+	    if (*p == '/') {
+		step->descendant = true;
+		++p;
+	    }
+	}
+
+	/*
+	 * name of the step, up to the next / or [
+	 */
+	errno = 0;		/* pre-clear errno for errp() */
+	step->name = calloc(strlen(p) + 1, sizeof(char));
+	if (step->name == NULL) {
+	    errp(4, __func__, "calloc of name of step %zu failed", plan->steps);
+	    not_reached();
+	}
+	escaped = false;
+	for (n = 0; *p != '\0' && *p != '/' && *p != '['; ++n) {
+	    if (*p == '\\' && p[1] != '\0') {
+		escaped = true;
+		++p;
+	    }
+	    step->name[n] = *p++;
+	}
+	step->name_len = n;
+	if (n == 0) {
+	    warn(__func__, "step %zu has no name in pattern: %s", plan->steps, pattern);
+	    jval_plan_free(plan);
+	    return false;
+	}
+	if (n == 1 && step->name[0] == '*' && !escaped) {
+	    step->any = true;
+	} else if (n <= 18 && strspn(step->name, "0123456789") == n && (n == 1 || step->name[0] != '0')) {
+	    step->is_index = string_to_intmax(step->name, &step->index);
+	}
+
+	/*
+	 * predicates of the step
+	 */
+	while (*p == '[') {
+	    end = strchr(p, ']');
+	    if (end == NULL) {
+		warn(__func__, "[ of step %zu has no ] in pattern: %s", plan->steps, pattern);
+		jval_plan_free(plan);
+		return false;
+	    }
+	    errno = 0;		/* pre-clear errno for errp() */
+	    pred = strndup(p + 1, (size_t)(end - p - 1));
+	    if (pred == NULL) {
+		errp(5, __func__, "strndup of predicate of step %zu failed", plan->steps);
+		not_reached();
+	    }
+	    ok = jval_compile_pred(plan, step, pred, pattern);
+	    free(pred);
+	    pred = NULL;
+	    if (!ok) {
+		jval_plan_free(plan);
+		return false;
+	    }
+	    p = end + 1;
+	}
+	if (*p != '\0' && *p != '/') {
+	    warn(__func__, "step %zu has a name after a predicate in pattern: %s", plan->steps, pattern);
+	    jval_plan_free(plan);
+	    return false;
+	}
+    }
+    return true;
+}
+
+
+/*
+ * jval_compile_pred - compile a predicate of a step
+ *
+ * given:
+ *	plan	    pointer to the query plan
+ *	step	    pointer to the step the predicate is of
+ *	pred	    predicate, without the [ and ]
+ *	pattern	    pattern, for warnings
+ *
+ * returns:
+ *	true ==> predicate compiled into step
+ *	false ==> predicate is invalid (after a warning)
+ */
+static bool
+jval_compile_pred(struct jval_plan *plan, struct jval_step *step, char *pred, char const *pattern)
+{
+    char *rest = NULL;		/* JSON_UTIL_MATCH_TYPE_* types of a [type=types] */
+    char *saveptr = NULL;	/* for strtok_r() */
+    char *p = NULL;
+
+    if (strncmp(pred, "type=", 5) == 0) {
+	/*
+	 * object and array are not JSON_UTIL_MATCH_TYPE_* types: pass the other types on
+	 */
+	errno = 0;		/* pre-clear errno for errp() */
+	rest = calloc(strlen(pred) + 1, sizeof(char));
+	if (rest == NULL) {
+	    errp(6, __func__, "calloc of types failed");
+	    not_reached();
+	}
+	for (p = strtok_r(pred + 5, ",", &saveptr); p != NULL; p = strtok_r(NULL, ",", &saveptr)) {
+	    if (strcmp(p, "object") == 0) {
+		step->types |= JVAL_MATCH_TYPE_OBJECT;
+	    } else if (strcmp(p, "array") == 0) {
+		step->types |= JVAL_MATCH_TYPE_ARRAY;
+	    } else {
+		if (*rest != '\0') {
+		    strcat(rest, ",");
+		}
+		strcat(rest, p);
+	    }
+	}
+	if (*rest != '\0') {
+	    step->types |= json_util_parse_match_types(rest);
+	}
+	free(rest);
+	rest = NULL;
+	if (step->types == JSON_UTIL_MATCH_TYPE_NONE) {
+	    warn(__func__, "[type=] of step %zu has no types in pattern: %s", plan->steps, pattern);
+	    return false;
+	}
+    } else if (strncmp(pred, "num=", 4) == 0) {
+	step->has_num = json_util_parse_number_range("[num=]", pred + 4, true, &step->num);
+    } else if (strncmp(pred, "index=", 6) == 0) {
+	step->has_pos = json_util_parse_number_range("[index=]", pred + 6, true, &step->pos);
+	if (step->pos.range.inclusive && step->pos.range.max < 0) {
+	    plan->need_len = true;
+	}
+    } else {
+	warn(__func__, "unknown predicate [%s] of step %zu in pattern: %s", pred, plan->steps, pattern);
+	return false;
+    }
+    return true;
+}
+
+
+/*
+ * jval_plan_free - free the storage of a query plan
+ *
+ * given:
+ *	plan	    pointer to the query plan compiled by jval_compile()
+ */
+void
+jval_plan_free(struct jval_plan *plan)
+{
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (plan == NULL) {
+	return;
+    }
+
+    for (i = 0; i < plan->steps && i < JVAL_MAX_STEPS; ++i) {
+	if (plan->step[i].name != NULL) {
+	    free(plan->step[i].name);
+	    plan->step[i].name = NULL;
+	}
+    }
+    plan->steps = 0;
+}
+
+
+/*
+ * jval_query_init - set up the evaluation of a query plan
+ *
+ * given:
+ *	q	    pointer to the query to set up
+ *	plan	    pointer to the query plan compiled by jval_compile()
+ *	out	    stream to write the matches to
+ *
+ * NOTE: This function does not return on NULL arg or allocation error.
+ */
+void
+jval_query_init(struct jval_query *q, struct jval_plan const *plan, FILE *out)
+{
+    /*
+     * firewall
+     */
+    if (q == NULL || plan == NULL || out == NULL) {
+	err(7, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    memset(q, 0, sizeof(*q));
+    q->plan = plan;
+    q->out = out;
+    q->frames = dyn_array_create(sizeof(struct jval_frame), JVAL_CHUNK, JVAL_CHUNK, false);
+    q->emits = dyn_array_create(sizeof(struct jval_emit), JVAL_CHUNK, JVAL_CHUNK, false);
+    q->open = dyn_array_create(sizeof(intmax_t), JVAL_CHUNK, JVAL_CHUNK, false);
+}
+
+
+/*
+ * jval_query_reset - forget a JSON document that was not evaluated in full
+ *
+ * After an invalid JSON document, JSON objects or arrays may have been begun
+ * but not ended.  A match partly written is ended with a newline, and the
+ * buffered matches are dropped.
+ *
+ * given:
+ *	q	    pointer to the query
+ */
+void
+jval_query_reset(struct jval_query *q)
+{
+    struct jval_emit *emit = NULL;	/* match being dropped */
+    intmax_t i;
+
+    /*
+     * firewall
+     */
+    if (q == NULL || q->frames == NULL || q->emits == NULL || q->open == NULL) {
+	return;
+    }
+
+    if (dyn_array_tell(q->open) > 0) {
+	(void) fputc('\n', q->out);
+    }
+    for (i = 0; i < dyn_array_tell(q->emits); ++i) {
+	emit = dyn_array_addr(q->emits, struct jval_emit, i);
+	if (emit->buf != NULL) {
+	    dyn_array_free(emit->buf);
+	    emit->buf = NULL;
+	}
+    }
+    dyn_array_clear(q->emits);
+    dyn_array_clear(q->open);
+    dyn_array_clear(q->frames);
+    q->name = NULL;
+    q->name_len = 0;
+}
+
+
+/*
+ * jval_query_free - free the storage of a query
+ *
+ * given:
+ *	q	    pointer to the query set up by jval_query_init()
+ */
+void
+jval_query_free(struct jval_query *q)
+{
+    /*
+     * firewall
+     */
+    if (q == NULL) {
+	return;
+    }
+
+    jval_query_reset(q);
+    if (q->frames != NULL) {
+	dyn_array_free(q->frames);
+	q->frames = NULL;
+    }
+    if (q->emits != NULL) {
+	dyn_array_free(q->emits);
+	q->emits = NULL;
+    }
+    if (q->open != NULL) {
+	dyn_array_free(q->open);
+	q->open = NULL;
+    }
+    if (q->name_buf != NULL) {
+	free(q->name_buf);
+	q->name_buf = NULL;
+    }
+    q->name_size = 0;
+    (void) fflush(q->out);
+}
+
+
+/*
+ * jval_types - type bits of a JSON value
+ *
+ * given:
+ *	type	    JSON type of the value
+ *	text	    JSON text of a JSON number
+ *	len	    length of text
+ *	node	    JSON parse tree node of the value, NULL ==> not known
+ *
+ * returns:
+ *	JSON_UTIL_MATCH_TYPE_* and JVAL_MATCH_TYPE_* bits of the value
+ */
+static uintmax_t
+jval_types(enum item_type type, char const *text, size_t len, struct json const *node)
+{
+    bool floating = false;	/* true ==> JSON number has a . */
+    bool e_notation = false;	/* true ==> JSON number has an e or E */
+    uintmax_t bits = JSON_UTIL_MATCH_TYPE_NUM;	/* bits of a JSON number */
+
+    switch (type) {
+    case JTYPE_OBJECT:
+	return JVAL_MATCH_TYPE_OBJECT;
+    case JTYPE_ARRAY:
+	return JVAL_MATCH_TYPE_ARRAY;
+    case JTYPE_STRING:
+	return JSON_UTIL_MATCH_TYPE_STR;
+    case JTYPE_BOOL:
+	return JSON_UTIL_MATCH_TYPE_BOOL;
+    case JTYPE_NULL:
+	return JSON_UTIL_MATCH_TYPE_NULL;
+    case JTYPE_NUMBER:
+	if (node != NULL) {
+	    floating = node->item.number.is_floating;
+	    e_notation = node->item.number.is_e_notation;
+	} else if (text != NULL) {
+	    floating = memchr(text, '.', len) != NULL;
+	    e_notation = memchr(text, 'e', len) != NULL || memchr(text, 'E', len) != NULL;
+	}
+	if (floating) {
+	    bits |= JSON_UTIL_MATCH_TYPE_FLOAT;
+	}
+	if (e_notation) {
+	    bits |= JSON_UTIL_MATCH_TYPE_EXP;
+	}
+	if (!floating && !e_notation) {
+	    bits |= JSON_UTIL_MATCH_TYPE_INT;
+	}
+	return bits;
+    default:
+	break;
+    }
+    return JSON_UTIL_MATCH_TYPE_NONE;
+}
+
+
+/*
+ * jval_step_match - determine if a JSON value matches a step
+ *
+ * given:
+ *	q	    pointer to the query
+ *	step	    pointer to the step
+ *	parent	    pointer to the frame of the JSON object or array of the value
+ *	pos	    position of the value in parent, from 0
+ *	type	    JSON type of the value
+ *	bits	    type bits of the value, from jval_types()
+ *	text	    JSON text of a JSON number
+ *	len	    length of text
+ *	node	    JSON parse tree node of the value, NULL ==> not known
+ *	conv	    pointer to the JSON number converted from text, NULL ==> not yet
+ *
+ * returns:
+ *	true ==> the value matches the step
+ *	false ==> the value does not match the step
+ *
+ * NOTE: If node is NULL, a JSON number is converted into *conv the first time
+ *	 it is needed: the caller must free *conv.
+ */
+static bool
+jval_step_match(struct jval_query *q, struct jval_step const *step, struct jval_frame const *parent,
+		intmax_t pos, enum item_type type, uintmax_t bits, char const *text, size_t len,
+		struct json const *node, struct json **conv)
+{
+    struct json_util_number range;	/* [num=range] or [index=range] */
+
+    /*
+     * name or array index
+     */
+    if (!step->any) {
+	if (parent->in_object) {
+	    if (q->name == NULL || q->name_len != step->name_len || memcmp(q->name, step->name, step->name_len) != 0) {
+		return false;
+	    }
+	} else if (!step->is_index || pos != step->index) {
+	    return false;
+	}
+    }
+
+    /*
+     * predicates
+     */
+    if (step->types != JSON_UTIL_MATCH_TYPE_NONE && (step->types & bits) == 0) {
+	return false;
+    }
+    if (step->has_pos) {
+	range = step->pos;
+	if (!json_util_number_in_range(pos, parent->len, &range)) {
+	    return false;
+	}
+    }
+    if (step->has_num) {
+	if (type != JTYPE_NUMBER) {
+	    return false;
+	}
+	if (node == NULL) {
+	    if (*conv == NULL && text != NULL) {
+		*conv = json_conv_number(text, len);
+	    }
+	    node = *conv;
+	}
+	if (node == NULL || !node->item.number.is_integer || !node->item.number.maxint_sized) {
+	    return false;
+	}
+	range = step->num;
+	if (!json_util_number_in_range(node->item.number.as_maxint, 0, &range)) {
+	    return false;
+	}
+    }
+    return true;
+}
+
+
+/*
+ * jval_write - write text to every match being written
+ *
+ * given:
+ *	q	    pointer to the query
+ *	text	    text to write
+ *	len	    length of text
+ */
+static void
+jval_write(struct jval_query *q, char const *text, size_t len)
+{
+    struct jval_emit *emit = NULL;	/* match being written */
+    intmax_t i;
+
+    for (i = 0; i < dyn_array_tell(q->open); ++i) {
+	emit = dyn_array_addr(q->emits, struct jval_emit, dyn_array_value(q->open, intmax_t, i));
+	if (emit->buf != NULL) {
+	    (void) dyn_array_append_set(emit->buf, (void *)text, (intmax_t)len);
+	} else if (len > 0 && fwrite(text, 1, len, q->out) != len) {
+	    warnp(__func__, "error writing match");
+	}
+    }
+}
+
+
+/*
+ * jval_write_str - write a JSON string to every match being written
+ *
+ * given:
+ *	q	    pointer to the query
+ *	str	    decoded JSON string
+ *	len	    length of str
+ *	name	    true ==> the name of a JSON member: write a : after it
+ *
+ * NOTE: This function does not return on a JSON encoding error.
+ */
+static void
+jval_write_str(struct jval_query *q, char const *str, size_t len, bool name)
+{
+    char *enc = NULL;		/* JSON encoded str */
+    size_t enc_len = 0;		/* length of enc */
+
+    enc = json_encode(str, len, &enc_len, false);
+    if (enc == NULL) {
+	err(8, __func__, "json_encode of a JSON string of length %zu failed", len);
+	not_reached();
+    }
+    jval_write(q, "\"", 1);
+    jval_write(q, enc, enc_len);
+    jval_write(q, name ? "\":" : "\"", name ? 2 : 1);
+    free(enc);
+}
+
+
+/*
+ * jval_write_value - write the start of a JSON value to every match being written
+ *
+ * given:
+ *	q	    pointer to the query
+ *	type	    JSON type of the value
+ *	text	    decoded JSON string, or JSON text of a JSON number, boolean or null
+ *	len	    length of text
+ */
+static void
+jval_write_value(struct jval_query *q, enum item_type type, char const *text, size_t len)
+{
+    switch (type) {
+    case JTYPE_OBJECT:
+	jval_write(q, "{", 1);
+	break;
+    case JTYPE_ARRAY:
+	jval_write(q, "[", 1);
+	break;
+    case JTYPE_STRING:
+	jval_write_str(q, text, len, false);
+	break;
+    default:
+	jval_write(q, text, len);
+	break;
+    }
+}
+
+
+/*
+ * jval_done - finish the innermost match being written
+ *
+ * When the outermost match is done, its line is ended and the matches inside
+ * it, which were buffered, are written after it in the order they started in.
+ *
+ * given:
+ *	q	    pointer to the query
+ */
+static void
+jval_done(struct jval_query *q)
+{
+    struct jval_emit *emit = NULL;	/* match done */
+    intmax_t idx = 0;			/* index of emit */
+    intmax_t i;
+
+    if (dyn_array_tell(q->open) <= 0) {
+	err(9, __func__, "no match is being written");
+	not_reached();
+    }
+    (void) dyn_array_pop(q->open, &idx);
+    emit = dyn_array_addr(q->emits, struct jval_emit, idx);
+    emit->done = true;
+    if (emit->buf != NULL) {
+	return;
+    }
+
+    /*
+     * end the outermost match and write the matches inside it
+     */
+    (void) fputc('\n', q->out);
+    for (i = idx + 1; i < dyn_array_tell(q->emits); ++i) {
+	emit = dyn_array_addr(q->emits, struct jval_emit, i);
+	if (dyn_array_tell(emit->buf) > 0 &&
+	    fwrite(dyn_array_first(emit->buf, char), 1, (size_t)dyn_array_tell(emit->buf), q->out) !=
+	    (size_t)dyn_array_tell(emit->buf)) {
+	    warnp(__func__, "error writing match");
+	}
+	(void) fputc('\n', q->out);
+	dyn_array_free(emit->buf);
+	emit->buf = NULL;
+    }
+    dyn_array_clear(q->emits);
+}
+
+
+/*
+ * jval_begin - evaluate the start of a JSON value
+ *
+ * The value is the next child of the innermost JSON object or array begun but
+ * not ended, or the whole JSON document if there is none.  The name of a JSON
+ * member must be in q->name.  A JSON object or array must later be ended by
+ * jval_end(), after its children are begun (and ended).
+ *
+ * given:
+ *	q	    pointer to the query
+ *	type	    JSON type of the value
+ *	text	    decoded JSON string, or JSON text of a JSON number, boolean or null
+ *	len	    length of text
+ *	node	    JSON parse tree node of the value, NULL ==> stream
+ *
+ * returns:
+ *	true ==> the children of the value may match or be written, so must be begun
+ *	false ==> the children of the value may be skipped
+ *
+ * NOTE: This function does not return on NULL arg or an internal error.
+ */
+bool
+jval_begin(struct jval_query *q, enum item_type type, char const *text, size_t len, struct json const *node)
+{
+    struct jval_plan const *plan = NULL;	/* compiled pattern */
+    struct jval_frame *parent = NULL;		/* frame of the JSON object or array of the value */
+    struct jval_frame frame;			/* frame of a JSON object or array value */
+    struct jval_emit emit;			/* match of the value */
+    struct json *conv = NULL;			/* JSON number converted for a [num=range] */
+    uintmax_t bits = JSON_UTIL_MATCH_TYPE_NONE;	/* type bits of the value */
+    uint64_t set = 0;				/* steps the children of the value are matched against */
+    intmax_t pos = 0;				/* position of the value in parent */
+    intmax_t idx = 0;				/* index of emit */
+    intmax_t depth = 0;				/* nesting level of the value */
+    bool matched = false;			/* true ==> the value matches the pattern */
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (q == NULL || q->plan == NULL || q->frames == NULL || q->emits == NULL || q->open == NULL) {
+	err(10, __func__, "called with NULL arg(s) or a query that was not set up");
+	not_reached();
+    }
+    if (text == NULL && type != JTYPE_OBJECT && type != JTYPE_ARRAY) {
+	err(11, __func__, "called with NULL text for a JSON value of type %d", (int)type);
+	not_reached();
+    }
+    plan = q->plan;
+
+    /*
+     * match the value against the steps its parent reached
+     */
+    depth = dyn_array_tell(q->frames);
+    if (depth > 0) {
+	parent = dyn_array_addr(q->frames, struct jval_frame, depth - 1);
+	pos = parent->count++;
+	if (parent->set != 0) {
+	    bits = jval_types(type, text, len, node);
+	    for (i = 0; i < plan->steps; ++i) {
+		if ((parent->set & JVAL_BIT(i)) == 0) {
+		    continue;
+		}
+		if (plan->step[i].descendant) {
+		    set |= JVAL_BIT(i);
+		}
+		if (jval_step_match(q, &plan->step[i], parent, pos, type, bits, text, len, node, &conv)) {
+		    set |= JVAL_BIT(i + 1);
+		}
+	    }
+	    if (conv != NULL) {
+		json_tree_free(conv, JSON_INFINITE_DEPTH);
+		free(conv);
+		conv = NULL;
+	    }
+	}
+    } else {
+	set = JVAL_BIT(0);
+    }
+    matched = (set & JVAL_BIT(plan->steps)) != 0;
+    set &= ~JVAL_BIT(plan->steps);
+
+    /*
+     * write the value to the matches it is inside of
+     */
+    if (dyn_array_tell(q->open) > 0 && parent != NULL) {
+	if (parent->count > 1) {
+	    jval_write(q, ",", 1);
+	}
+	if (parent->in_object && q->name != NULL) {
+	    jval_write_str(q, q->name, q->name_len, true);
+	}
+    }
+    q->name = NULL;
+    q->name_len = 0;
+    if (matched) {
+	++q->matches;
+	memset(&emit, 0, sizeof(emit));
+	if (dyn_array_tell(q->open) > 0) {
+	    emit.buf = dyn_array_create(sizeof(char), JVAL_BUF_CHUNK, JVAL_BUF_CHUNK, false);
+	}
+	emit.depth = (size_t)depth;
+	idx = dyn_array_tell(q->emits);
+	(void) dyn_array_append_value(q->emits, &emit);
+	(void) dyn_array_append_value(q->open, &idx);
+    }
+    if (dyn_array_tell(q->open) > 0) {
+	jval_write_value(q, type, text, len);
+    }
+
+    /*
+     * begin the children of a JSON object or array, or finish a simple match
+     */
+    if (type == JTYPE_OBJECT || type == JTYPE_ARRAY) {
+	memset(&frame, 0, sizeof(frame));
+	frame.set = set;
+	frame.in_object = (type == JTYPE_OBJECT);
+	frame.count = 0;
+	frame.len = -1;
+	if (node != NULL) {
+	    frame.len = (type == JTYPE_OBJECT) ? node->item.object.len : node->item.array.len;
+	}
+	(void) dyn_array_append_value(q->frames, &frame);
+    } else if (matched) {
+	jval_done(q);
+    }
+    return set != 0 || dyn_array_tell(q->open) > 0;
+}
+
+
+/*
+ * jval_end - evaluate the end of a JSON object or array
+ *
+ * given:
+ *	q	    pointer to the query
+ *
+ * NOTE: This function does not return on NULL arg or an internal error.
+ */
+void
+jval_end(struct jval_query *q)
+{
+    struct jval_frame frame;		/* frame of the JSON object or array ended */
+    struct jval_emit *emit = NULL;	/* innermost match being written */
+    intmax_t depth = 0;			/* nesting level of the JSON object or array */
+
+    /*
+     * firewall
+     */
+    if (q == NULL || q->frames == NULL || q->emits == NULL || q->open == NULL) {
+	err(12, __func__, "called with NULL arg(s) or a query that was not set up");
+	not_reached();
+    }
+    if (dyn_array_tell(q->frames) <= 0) {
+	err(13, __func__, "no JSON object or array was begun");
+	not_reached();
+    }
+
+    (void) dyn_array_pop(q->frames, &frame);
+    depth = dyn_array_tell(q->frames);
+    if (dyn_array_tell(q->open) > 0) {
+	jval_write(q, frame.in_object ? "}" : "]", 1);
+	emit = dyn_array_addr(q->emits, struct jval_emit, dyn_array_value(q->open, intmax_t, dyn_array_tell(q->open) - 1));
+	if ((intmax_t)emit->depth == depth) {
+	    jval_done(q);
+	}
+    }
+}
+
+
+/*
+ * jval_tree - evaluate a query plan over a JSON parse tree
+ *
+ * The tree is walked in document order without recursion.  The children of a
+ * JSON object or array that cannot match (and are not inside a match) are
+ * skipped.  When the children of a large JSON object are only matched against
+ * a name, the member is found with json_object_get() instead.
+ *
+ * given:
+ *	q	    pointer to the query
+ *	tree	    JSON parse tree
+ *
+ * NOTE: This function does not return on NULL arg or an internal error.
+ */
+void
+jval_tree(struct jval_query *q, struct json *tree)
+{
+    struct dyn_array *walk = NULL;	/* struct jval_walk of each JSON object or array being walked */
+    struct jval_walk w;			/* JSON object or array to walk */
+    struct jval_walk *top = NULL;	/* innermost JSON object or array being walked */
+    struct json *node = NULL;		/* next value to begin, NULL ==> none */
+    struct json *child = NULL;		/* child of top */
+    struct json **set = NULL;		/* children of top */
+    intmax_t len = 0;			/* number of children of top */
+
+    /*
+     * firewall
+     */
+    if (q == NULL || tree == NULL) {
+	err(14, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    walk = dyn_array_create(sizeof(struct jval_walk), JVAL_CHUNK, JVAL_CHUNK, false);
+    for (node = tree; ; ) {
+	/*
+	 * begin the next value, and walk its children if they may match
+	 */
+	if (node != NULL) {
+	    if (jval_tree_begin(q, node)) {
+		if (node->type == JTYPE_OBJECT || node->type == JTYPE_ARRAY) {
+		    memset(&w, 0, sizeof(w));
+		    w.node = node;
+		    w.next = 0;
+		    jval_tree_index(q, &w);
+		    (void) dyn_array_append_value(walk, &w);
+		}
+	    } else if (node->type == JTYPE_OBJECT || node->type == JTYPE_ARRAY) {
+		jval_end(q);
+	    }
+	    node = NULL;
+	}
+
+	/*
+	 * find the next child of the innermost JSON object or array
+	 */
+	if (dyn_array_tell(walk) <= 0) {
+	    break;
+	}
+	top = dyn_array_addr(walk, struct jval_walk, dyn_array_tell(walk) - 1);
+	if (top->node->type == JTYPE_OBJECT) {
+	    set = top->node->item.object.set;
+	    len = top->node->item.object.len;
+	} else {
+	    set = top->node->item.array.set;
+	    len = top->node->item.array.len;
+	}
+	if (top->indexed) {
+	    child = top->only;
+	    top->only = NULL;
+	} else if (set != NULL && top->next < len) {
+	    child = set[top->next++];
+	} else {
+	    child = NULL;
+	}
+	if (child == NULL) {
+	    jval_end(q);
+	    (void) dyn_array_pop(walk, NULL);
+	    continue;
+	}
+	if (child->type == JTYPE_MEMBER) {
+	    q->name = child->item.member.name_str;
+	    q->name_len = child->item.member.name_str_len;
+	    node = child->item.member.value;
+	} else {
+	    node = child;
+	}
+	if (node == NULL) {
+	    err(15, __func__, "JSON member or element with no value");
+	    not_reached();
+	}
+    }
+    dyn_array_free(walk);
+}
+
+
+/*
+ * jval_tree_begin - evaluate the start of a JSON parse tree node
+ *
+ * given:
+ *	q	    pointer to the query
+ *	node	    JSON parse tree node
+ *
+ * returns:
+ *	the return of jval_begin() for the node
+ *
+ * NOTE: This function does not return on a JSON parse tree node of a type
+ *	 that is not a JSON value.
+ */
+static bool
+jval_tree_begin(struct jval_query *q, struct json *node)
+{
+    switch (node->type) {
+    case JTYPE_NUMBER:
+	return jval_begin(q, node->type, node->item.number.first, node->item.number.number_len, node);
+    case JTYPE_STRING:
+	return jval_begin(q, node->type, node->item.string.str, node->item.string.str_len, node);
+    case JTYPE_BOOL:
+	return jval_begin(q, node->type, node->item.boolean.as_str, node->item.boolean.as_str_len, node);
+    case JTYPE_NULL:
+	return jval_begin(q, node->type, node->item.null.as_str, node->item.null.as_str_len, node);
+    case JTYPE_OBJECT:
+    case JTYPE_ARRAY:
+	return jval_begin(q, node->type, NULL, 0, node);
+    default:
+	break;
+    }
+    err(16, __func__, "JSON parse tree node of type %s is not a JSON value", json_item_type_name(node));
+    not_reached();
+}
+
+
+/*
+ * jval_tree_index - find the member of a large JSON object by name, if that is all that can match
+ *
+ * When no match is being written, and the members of a JSON object with at
+ * least JSON_OBJECT_INDEX_MIN members are only matched against one name (no
+ * *, // or [index=range]), then json_object_get() finds the only member that
+ * can match, unless the object has members with the same name.
+ *
+ * given:
+ *	q	    pointer to the query
+ *	w	    pointer to the walk of the JSON object or array just begun
+ */
+static void
+jval_tree_index(struct jval_query *q, struct jval_walk *w)
+{
+    struct jval_plan const *plan = q->plan;	/* compiled pattern */
+    struct jval_frame const *frame = NULL;	/* frame of the JSON object */
+    struct jval_step const *step = NULL;	/* step the members are matched against */
+    struct jval_step const *name = NULL;	/* step of the one name */
+    struct json_object const *item = NULL;	/* JSON object */
+    struct json *member = NULL;			/* member with the name */
+    size_t i;
+
+    w->indexed = false;
+    w->only = NULL;
+    if (w->node->type != JTYPE_OBJECT || w->node->item.object.len < JSON_OBJECT_INDEX_MIN ||
+	dyn_array_tell(q->open) > 0 || dyn_array_tell(q->frames) <= 0) {
+	return;
+    }
+    frame = dyn_array_addr(q->frames, struct jval_frame, dyn_array_tell(q->frames) - 1);
+    for (i = 0; i < plan->steps; ++i) {
+	if ((frame->set & JVAL_BIT(i)) == 0) {
+	    continue;
+	}
+	step = &plan->step[i];
+	if (step->descendant || step->any || step->has_pos) {
+	    return;
+	}
+	if (name != NULL && (name->name_len != step->name_len || memcmp(name->name, step->name, step->name_len) != 0)) {
+	    return;
+	}
+	name = step;
+    }
+    if (name == NULL) {
+	return;
+    }
+
+    member = json_object_get(w->node, name->name, name->name_len);
+    item = &(w->node->item.object);
+    if (item->index == NULL || item->index->dups != 0) {
+	return;
+    }
+    w->indexed = true;
+    w->only = member;
+}
+
+
+/*
+ * jval_start_object - JSON event callback for { of a stream
+ *
+ * given:
+ *	data	    pointer to the query
+ *
+ * returns:
+ *	true
+ */
+static bool
+jval_start_object(void *data)
+{
+    (void) jval_begin((struct jval_query *)data, JTYPE_OBJECT, NULL, 0, NULL);
+    return true;
+}
+
+
+/*
+ * jval_start_array - JSON event callback for [ of a stream
+ *
+ * given:
+ *	data	    pointer to the query
+ *
+ * returns:
+ *	true
+ */
+static bool
+jval_start_array(void *data)
+{
+    (void) jval_begin((struct jval_query *)data, JTYPE_ARRAY, NULL, 0, NULL);
+    return true;
+}
+
+
+/*
+ * jval_end_container - JSON event callback for } or ] of a stream
+ *
+ * given:
+ *	data	    pointer to the query
+ *
+ * returns:
+ *	true
+ */
+static bool
+jval_end_container(void *data)
+{
+    jval_end((struct jval_query *)data);
+    return true;
+}
+
+
+/*
+ * jval_member_name - JSON event callback for the name of a JSON member of a stream
+ *
+ * The name is only valid during the callback, so it is copied for the value
+ * of the member that follows.
+ *
+ * given:
+ *	data	    pointer to the query
+ *	name	    decoded JSON member name
+ *	len	    length of name
+ *
+ * returns:
+ *	true
+ *
+ * NOTE: This function does not return on realloc error.
+ */
+static bool
+jval_member_name(void *data, char const *name, size_t len)
+{
+    struct jval_query *q = (struct jval_query *)data;	/* query */
+    char *buf = NULL;					/* reallocated name_buf */
+
+    if (len + 1 > q->name_size) {
+	errno = 0;		/* pre-clear errno for errp() */
+	buf = realloc(q->name_buf, len + 1);
+	if (buf == NULL) {
+	    errp(17, __func__, "realloc of member name of length %zu failed", len);
+	    not_reached();
+	}
+	q->name_buf = buf;
+	q->name_size = len + 1;
+    }
+    memcpy(q->name_buf, name, len);
+    q->name_buf[len] = '\0';
+    q->name = q->name_buf;
+    q->name_len = len;
+    return true;
+}
+
+
+/*
+ * jval_value - JSON event callback for a JSON string, number, boolean or null of a stream
+ *
+ * given:
+ *	data	    pointer to the query
+ *	type	    JSON type of the value
+ *	str	    decoded JSON string, or JSON text of a JSON number, boolean or null
+ *	len	    length of str
+ *
+ * returns:
+ *	true
+ */
+static bool
+jval_value(void *data, enum item_type type, char const *str, size_t len)
+{
+    (void) jval_begin((struct jval_query *)data, type, str, len, NULL);
+    return true;
+}
+
+
+/*
+ * jval_plan_is_path - determine if a query plan is a path of names only
+ *
+ * given:
+ *	plan	    pointer to the query plan
+ *
+ * returns:
+ *	true ==> every step is a name, with no *, // or predicate,
+ *	false ==> plan is not a path, or plan is NULL
+ */
+bool
+jval_plan_is_path(struct jval_plan const *plan)
+{
+    size_t i;
+
+    if (plan == NULL) {
+	return false;
+    }
+    for (i = 0; i < plan->steps; ++i) {
+	if (plan->step[i].any || plan->step[i].descendant || plan->step[i].types != JSON_UTIL_MATCH_TYPE_NONE ||
+	    plan->step[i].has_num || plan->step[i].has_pos) {
+	    return false;
+	}
+    }
+    return true;
+}
+
+
+/*
+ * jval_index - evaluate a path with the path index of a JSON file
+ *
+ * The path of the plan is looked up, as a JSON Pointer, in the path index of
+ * the JSON file, and only the JSON text of each value found is read and
+ * parsed.  The path index is formed (again) first if it does not exist, is not
+ * valid, or the JSON file changed since it was formed: see json_pindex_open().
+ *
+ * The path index is only a faster way to the values: if it cannot be formed
+ * or used (the JSON file changed while it was indexed, the path index could
+ * not be written, or another process replaced it or changed the JSON file
+ * since), the whole JSON file is parsed into a JSON parse tree and the query
+ * is evaluated over it, as without -I.  The JSON text of every value found is
+ * parsed before any value is written, so that a value is never written twice.
+ *
+ * given:
+ *	q	    pointer to the query, whose plan is a path (see jval_plan_is_path())
+ *	filename    JSON file
+ *	indexname   path index file of the JSON file
+ *
+ * returns:
+ *	true ==> the values found were written,
+ *	false ==> the JSON file is not valid JSON
+ *
+ * NOTE: This function does not return on NULL arg.
+ */
+bool
+jval_index(struct jval_query *q, char const *filename, char const *indexname)
+{
+    struct jval_query root;		/* query that writes all of each value found */
+    struct json_pindex *pindex = NULL;	/* open path index */
+    struct dyn_array *path = NULL;	/* JSON Pointer of the path */
+    struct dyn_array *trees = NULL;	/* struct json * JSON parse tree of each value found */
+    struct json *tree = NULL;		/* JSON parse tree of a value found, or of the JSON file */
+    enum json_pindex_status status;	/* what json_pindex_write() did */
+    uint64_t first = 0;			/* first entry of the path */
+    uint64_t count = 0;			/* number of entries of the path */
+    uint64_t num;			/* entry number */
+    bool stale = false;			/* true ==> path index must be formed */
+    bool valid = false;			/* true ==> JSON text is valid */
+    bool found = false;			/* true ==> the values were found with the path index */
+    intmax_t j;
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (q == NULL || q->plan == NULL || filename == NULL || indexname == NULL) {
+	err(18, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (!jval_plan_is_path(q->plan)) {
+	err(19, __func__, "pattern is not a path of names only");
+	not_reached();
+    }
+
+    /*
+     * open the path index, forming it if needed
+     */
+    pindex = json_pindex_open(filename, indexname, &stale);
+    if (pindex == NULL && stale) {
+	dbg(DBG_MED, "forming path index %s of: %s", indexname, filename);
+	status = json_pindex_write(filename, indexname);
+	if (status == JSON_PINDEX_INVALID) {
+	    return false;
+	} else if (status == JSON_PINDEX_OK) {
+	    pindex = json_pindex_open(filename, indexname, &stale);
+	}
+    }
+
+    /*
+     * look up the JSON Pointer of the path and parse each value found
+     */
+    if (pindex != NULL) {
+	path = dyn_array_create(sizeof(char), JVAL_BUF_CHUNK, JVAL_BUF_CHUNK, false);
+	for (i = 0; i < q->plan->steps; ++i) {
+	    json_pindex_path_add(path, q->plan->step[i].name, q->plan->step[i].name_len);
+	}
+	if (json_pindex_find(pindex, dyn_array_first(path, char), (size_t)dyn_array_tell(path), &first, &count)) {
+	    dbg(DBG_HIGH, "path index %s has %ju value(s) of the path", indexname, (uintmax_t)count);
+	    trees = dyn_array_create(sizeof(struct json *), JVAL_BUF_CHUNK, JVAL_BUF_CHUNK, false);
+	    found = true;
+	    for (num = first; found && num < first + count; ++num) {
+		tree = json_pindex_parse(pindex, num, &valid);
+		if (tree == NULL || !valid) {
+		    warn(__func__, "JSON text of entry %ju of path index %s is not valid", (uintmax_t)num, indexname);
+		    found = false;
+		    if (tree != NULL) {
+			json_tree_free(tree, JSON_INFINITE_DEPTH);
+			free(tree);
+		    }
+		} else {
+		    (void) dyn_array_append_value(trees, &tree);
+		}
+		tree = NULL;
+	    }
+	}
+	json_pindex_close(pindex);
+	pindex = NULL;
+	dyn_array_free(path);
+	path = NULL;
+    }
+
+    /*
+     * write each value found, and free the JSON parse trees
+     */
+    if (trees != NULL) {
+	jval_query_init(&root, &jval_root_plan, q->out);
+	for (j = 0; j < dyn_array_tell(trees); ++j) {
+	    tree = dyn_array_value(trees, struct json *, j);
+	    if (found) {
+		jval_tree(&root, tree);
+	    }
+	    json_tree_free(tree, JSON_INFINITE_DEPTH);
+	    free(tree);
+	    tree = NULL;
+	}
+	q->matches += root.matches;
+	jval_query_free(&root);
+	dyn_array_free(trees);
+	trees = NULL;
+    }
+    if (found) {
+	return true;
+    }
+
+    /*
+     * the path index cannot be used: parse the whole JSON file
+     */
+    dbg(DBG_MED, "cannot use path index %s, parsing: %s", indexname, filename);
+    tree = parse_json_file(filename, &valid);
+    if (tree == NULL || !valid) {
+	if (tree != NULL) {
+	    json_tree_free(tree, JSON_INFINITE_DEPTH);
+	    free(tree);
+	}
+	return false;
+    }
+    jval_tree(q, tree);
+    json_tree_free(tree, JSON_INFINITE_DEPTH);
+    free(tree);
+    return true;
+}
@@ -79,7 +79,7 @@
 /*
  * official jval version
  */
-#define JVAL_VERSION "0.1.0 2026-05-06"	/* format: major.minor YYYY-MM-DD */
+#define JVAL_VERSION "0.3.2 2026-10-19"	/* format: major.minor YYYY-MM-DD */
 
 
 /*
@@ -88,4 +88,141 @@
 #define JPARSE_BASENAME "jval"
 
 
-#endif /* INCLUDE_JPARSE_MAIN_H */
+/*
+ * jval query plan
+ *
+ * A pattern is compiled once, by jval_compile(), into a plan: a list of steps
+ * that select JSON values by their path from the top of the JSON document:
+ *
+ *	/		the whole JSON document
+ *	/step		a step that matches a child of the JSON document
+ *	/a/step		a step that matches a child of what /a matched
+ *	//step		a step that matches a descendant, at any depth
+ *
+ * where a step is one of:
+ *
+ *	name		JSON member named name (after JSON decoding); if name is a
+ *			decimal number, also the JSON array element with that index
+ *	*		any JSON member or JSON array element
+ *
+ * followed by zero or more predicates, each of which the match must satisfy:
+ *
+ *	[type=types]	value is one of the comma separated types: int, float,
+ *			exp, num, bool, str, null, simple (the types of
+ *			json_util_parse_match_types()) and object, array
+ *	[num=range]	value is an integer JSON number in range
+ *	[index=range]	position of the member or element in its parent (from 0) is in range
+ *
+ * where range is as parsed by json_util_parse_number_range(): n, min:max,
+ * min: or :max.  With [index=min:-n] the range is up through the number of
+ * children of the parent less n.  A \ escapes the next character of a name,
+ * as in a\/b for the name a/b or \* for the name *.
+ *
+ * The plan is evaluated as a set of steps, one bit per step, for each JSON
+ * value: bit i means that the steps before i matched the path to the value,
+ * so its children are matched against step i.  A child gets bit i+1 if it
+ * matches step i, and keeps bit i if step i is a // step.  A child with the bit
+ * of the last step matches the pattern.  As a child depends only on its parent,
+ * a plan can be evaluated over a JSON parse tree, where the children of a
+ * value with no bits need not be looked at, or over a stream of JSON events
+ * without forming a JSON parse tree.
+ */
+#define JVAL_MAX_STEPS (63)		/* maximum number of steps in a pattern */
+#define JVAL_MATCH_TYPE_OBJECT (128)	/* [type=object], beyond the JSON_UTIL_MATCH_TYPE_* types */
+#define JVAL_MATCH_TYPE_ARRAY (256)	/* [type=array], beyond the JSON_UTIL_MATCH_TYPE_* types */
+#define JVAL_CHUNK (64)			/* number of frames or matches to allocate at a time */
+#define JVAL_BUF_CHUNK (1024)		/* number of bytes of a buffered match to allocate at a time */
+
+struct jval_step
+{
+    bool descendant;			/* true ==> // step: matches at any depth */
+    bool any;				/* true ==> * step: matches any member or element */
+    char *name;				/* malloced name to match, if !any */
+    size_t name_len;			/* length of name */
+    bool is_index;			/* true ==> name is also a JSON array index */
+    intmax_t index;			/* JSON array index, if is_index */
+    uintmax_t types;			/* [type=types] as bits, 0 ==> any type */
+    bool has_num;			/* true ==> [num=range] was given */
+    struct json_util_number num;	/* [num=range] */
+    bool has_pos;			/* true ==> [index=range] was given */
+    struct json_util_number pos;	/* [index=range] */
+};
+
+struct jval_plan
+{
+    size_t steps;				/* number of steps, 0 ==> the pattern is / */
+    struct jval_step step[JVAL_MAX_STEPS];	/* steps of the pattern */
+    bool need_len;				/* true ==> [index=min:-n] needs the number of children */
+};
+
+/*
+ * jval query evaluation
+ *
+ * The plan is evaluated by jval_begin() and jval_end(), which are called for
+ * the start and end of each JSON value in document order, either as the JSON
+ * events of a stream or by jval_tree() as it walks a JSON parse tree.  A match
+ * is written as compact JSON on a line of its own.  A match is written as its
+ * JSON events arrive, unless it is inside another match being written, in
+ * which case it is buffered and written after it, so that matches are written
+ * in the order they start in.  The matches being written are nested, so they
+ * form a stack: the innermost match is the first one to be done.
+ *
+ * A pattern of names only (no *, // or predicates) is a path, the same as a
+ * JSON Pointer, so jval_index() can look it up in the path index of the JSON
+ * file (see json_pindex.h) and parse only the JSON text of the values found.
+ */
+struct jval_frame
+{
+    uint64_t set;			/* steps the children of the value are matched against */
+    bool in_object;			/* true ==> JSON object, false ==> JSON array */
+    intmax_t count;			/* number of children begun so far */
+    intmax_t len;			/* number of children, -1 ==> not known (stream) */
+};
+
+struct jval_emit
+{
+    struct dyn_array *buf;		/* text of a buffered match, NULL ==> written to the output stream */
+    size_t depth;			/* nesting level of the match */
+    bool done;				/* true ==> match has been written in full */
+};
+
+struct jval_query
+{
+    struct jval_plan const *plan;	/* compiled pattern */
+    FILE *out;				/* stream to write the matches to */
+    struct dyn_array *frames;		/* struct jval_frame of each JSON object or array begun but not ended */
+    struct dyn_array *emits;		/* struct jval_emit of each match being written */
+    struct dyn_array *open;		/* intmax_t index in emits of each match not done, innermost last */
+    char const *name;			/* name of the next member, NULL ==> none */
+    size_t name_len;			/* length of name */
+    char *name_buf;			/* malloced copy of a member name of a stream */
+    size_t name_size;			/* allocated size of name_buf */
+    uintmax_t matches;			/* number of matches */
+};
+
+
+struct jval_walk
+{
+    struct json *node;			/* JSON object or array being walked by jval_tree() */
+    intmax_t next;			/* index of the next child to walk */
+    bool indexed;			/* true ==> walk only the member found by name */
+    struct json *only;			/* member to walk if indexed, NULL ==> none (left) */
+};
+
+
+/*
+ * external function declarations
+ */
+extern bool jval_compile(char const *pattern, struct jval_plan *plan);
+extern void jval_plan_free(struct jval_plan *plan);
+extern void jval_query_init(struct jval_query *q, struct jval_plan const *plan, FILE *out);
+extern void jval_query_reset(struct jval_query *q);
+extern void jval_query_free(struct jval_query *q);
+extern bool jval_begin(struct jval_query *q, enum item_type type, char const *text, size_t len, struct json const *node);
+extern void jval_end(struct jval_query *q);
+extern void jval_tree(struct jval_query *q, struct json *tree);
+extern bool jval_plan_is_path(struct jval_plan const *plan);
+extern bool jval_index(struct jval_query *q, char const *filename, char const *indexname);
+
+
+#endif /* INCLUDE_JVAL_H */
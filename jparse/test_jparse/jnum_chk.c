@@ -114,7 +114,7 @@ main(int argc, char *argv[])
     bool error = false;		/* true ==> JSON conversion test suite error */
     bool strict = false;	/* true ==> strict testing for all struct integer element */
     struct json *node = NULL;	/* allocated JSON parser tree node */
-    struct json_number *item = NULL;	/* JSON parser tree node for a JSON number */
+    struct json_number_conv *item = NULL;	/* every C conversion of a JSON number */
     size_t len = 0;		/* length of str */
     int arg_count = 0;		/* number of args to process */
     bool opt_error = false;	/* fchk_inval_opt() return */
@@ -210,7 +210,7 @@ main(int argc, char *argv[])
                     json_type_name(JTYPE_NUMBER));
 	    not_reached();
 	}
-	item = &(node->item.number);
+	item = json_number_conv(node);
 
 	/*
 	 * compare conversion with test case
@@ -249,14 +249,14 @@ main(int argc, char *argv[])
 /*
  * chk_test - check a given test
  *
- * When strict == true, we will compare every node->item.number element
+ * When strict == true, we will compare every converted node->item.number element
  * with every *test element.  When strict == false, we will only compare
  * select struct json_number elements.
  *
  * given:
  *	testnum - test number being checked
  *	item	- pointer to struct json converted JSON number
- *	test	- pointer to test suite struct json_number
+ *	test	- pointer to test suite struct json_number_conv
  *	len	- converted JSON number length
  *	strict	- true ==> compare all struct json_member elements,
  *		  false ==> compare only select struct json_member elements
@@ -267,7 +267,7 @@ main(int argc, char *argv[])
  *		  NULL pointer given, or len was incorrect
  */
 static bool
-chk_test(size_t testnum, struct json_number *item, struct json_number *test, size_t len, bool strict)
+chk_test(size_t testnum, struct json_number_conv *item, struct json_number_conv *test, size_t len, bool strict)
 {
     bool test_error = false;	/* true ==> check failed */
 
@@ -332,7 +332,7 @@ main(int argc, char *argv[])
     /*
      * output test results
      */
-    prstr("struct json_number test_result[TEST_COUNT+1] = {\n");
+    prstr("struct json_number_conv test_result[TEST_COUNT+1] = {\n");
     for (i=0; i < count; ++i) {
 
 	/*
@@ -355,7 +355,7 @@ main(int argc, char *argv[])
 		    json_type_name(JTYPE_NUMBER));
 	    not_reached();
 	}
-	fpr_number(stdout, &node->item.number);
+	fpr_number(stdout, json_number_conv(node));
 
 	/*
 	 * print end of json_number structure
@@ -504,16 +504,16 @@ is_read(char const *path)
 
 /* NOTE: The following function is a static duplicate from from mkicccentry toolkit */
 /*
- * fpr_number - print the contents of struct json_number on a stream
+ * fpr_number - print the contents of struct json_number_conv on a stream
  *
  * given:
  *	stream		open stream to print on
- *	item		pointer to struct json_number to print
+ *	item		pointer to struct json_number_conv to print
  *
  * This function does not return on error.
  */
 static void
-fpr_number(FILE *stream, struct json_number *item)
+fpr_number(FILE *stream, struct json_number_conv *item)
 {
     /*
      * firewall
@@ -57,6 +57,12 @@
 # not invalid it is an error. Whether or not -f is used, as long as the default
 # error file is a regular readable file.
 #
+# If -l jval is used then jval is run on test_jparse/jval_test.json with each
+# pattern of test_jparse/jval_test.txt, without and with -S, and what it prints
+# must be the same as test_jparse/jval_test.out.  The patterns that are names
+# only are also run with -I, and the path index is checked to be formed again
+# (and only then) when the JSON file changes.
+#
 # Copyright (c) 2022-2026 by Cody Boone Ferguson and Landon Curt Noll. All
 # rights reserved.
 #
@@ -93,16 +99,20 @@
 #
 # setup
 #
-export JPARSE_TEST_VERSION="2.0.0 2025-02-28"	    # version format: major.minor YYYY-MM-DD */
+export JPARSE_TEST_VERSION="2.0.11 2026-10-19"	    # version format: major.minor YYYY-MM-DD */
 export CHK_TEST_FILE="./test_jparse/json_teststr.txt"
 export CHK_INVALID_TEST_FILE="./test_jparse/json_teststr_fail.txt"
 export JPARSE="./jparse"
 export PRINT_TEST="./test_jparse/print_test"
+export JVAL="./jval"
+export JVAL_TEST_JSON="./test_jparse/jval_test.json"
+export JVAL_TEST_FILE="./test_jparse/jval_test.txt"
+export JVAL_TEST_OUT="./test_jparse/jval_test.out"
 export JSON_TREE="./test_jparse/test_JSON"
 export PASS_FAIL="pass"
 export SUBDIR="."
 export USAGE="usage: $0 [-h] [-V] [-v level] [-D dbg_level] [-J level] [-q] [-j jparse]
-		[-p print_test] [-d json_tree] [-s subdir] [-Z topdir] [-k] [-f] [-L] [-F] [file ..]
+		[-p print_test] [-l jval] [-d json_tree] [-s subdir] [-Z topdir] [-k] [-f] [-L] [-F] [file ..]
 
     -h			print help and exit
     -V			print version and exit
@@ -112,6 +122,7 @@ export USAGE="usage: $0 [-h] [-V] [-v level] [-D dbg_level] [-J level] [-q] [-j
     -q			quiet mode: silence msg(), warn(), warnp() if -v 0 (def: loud :-) )
     -j jparse		path to jparse tool (def: $JPARSE)
     -p print_test	path to print_test tool (def: $PRINT_TEST)
+    -l jval		path to jval tool: run the jval pattern tests (def: do not run them)
     -d json_tree	read files under json_tree/subdir/good and json_tree/subdir/bad (def: $JSON_TREE)
 			    These subdirectories are expected:
 				json_tree/tree/subdir/bad
@@ -151,6 +162,8 @@ export FILE_FAILURE_SUMMARY=""
 export STRING_FAILURE_SUMMARY=""
 export PRINT_TEST_FLAG_USED=""
 export PRINT_TEST_FAILURE=""
+export JVAL_FLAG_USED=""
+export JVAL_FAILURE_SUMMARY=""
 export K_FLAG=""
 export D_FLAG=""
 export L_FLAG=""
@@ -159,7 +172,7 @@ export TOPDIR=
 
 # parse args
 #
-while getopts :hVv:D:J:qj:p:d:s:Z:kfLF flag; do
+while getopts :hVv:D:J:qj:p:l:d:s:Z:kfLF flag; do
     case "$flag" in
     h)	echo "$USAGE" 1>&2
 	exit 2
@@ -180,6 +193,9 @@ while getopts :hVv:D:J:qj:p:d:s:Z:kfLF flag; do
     p)	PRINT_TEST="$OPTARG";
 	PRINT_TEST_FLAG_USED="1"
 	;;
+    l)	JVAL="$OPTARG";
+	JVAL_FLAG_USED="1"
+	;;
     d)	JSON_TREE="$OPTARG"
 	D_FLAG="-d"
 	;;
@@ -237,6 +253,9 @@ if [[ $V_FLAG -ge 1 ]]; then
     if [[ -n "$PRINT_TEST_FLAG_USED" ]]; then
 	echo "$0: debug[1]: print_test: $PRINT_TEST" 1>&2
     fi
+    if [[ -n "$JVAL_FLAG_USED" ]]; then
+	echo "$0: debug[1]: jval: $JVAL" 1>&2
+    fi
 fi
 
 # check args
@@ -248,6 +267,9 @@ export ARGC="$#"
 export JSON_GOOD_TREE="$JSON_TREE/$SUBDIR/good"
 export JSON_BAD_TREE="$JSON_TREE/$SUBDIR/bad"
 export JSON_BAD_LOC_TREE="$JSON_TREE/$SUBDIR/bad_loc"
+# JSON Lines (NDJSON) files for the jparse -N tests: the JSON string test files next to the JSON tree
+export JSON_NDJSON_GOOD_FILE="$JSON_TREE/../json_teststr.txt"
+export JSON_NDJSON_BAD_FILE="$JSON_TREE/../json_teststr_fail.txt"
 
 # change to the top level directory as needed
 #
@@ -336,6 +358,30 @@ if [[ -n "$PRINT_TEST_FLAG_USED" ]]; then
     fi
 fi
 
+# if -l used, check that jval is an executable file and that its test files are
+# readable files
+#
+if [[ -n "$JVAL_FLAG_USED" ]]; then
+    if [[ ! -e $JVAL ]]; then
+	echo "$0: ERROR: jval not found: $JVAL"
+	exit 5
+    fi
+    if [[ ! -f $JVAL ]]; then
+	echo "$0: ERROR: jval not a regular file: $JVAL"
+	exit 5
+    fi
+    if [[ ! -x $JVAL ]]; then
+	echo "$0: ERROR: jval not executable: $JVAL"
+	exit 5
+    fi
+    for file in "$JVAL_TEST_JSON" "$JVAL_TEST_FILE" "$JVAL_TEST_OUT"; do
+	if [[ ! -f $file || ! -r $file ]]; then
+	    echo "$0: ERROR: jval test file not a readable file: $file" 1>&2
+	    exit 7
+	fi
+    done
+fi
+
 # if -d used, check that json_tree and its subdirectories are readable
 # directories.
 #
@@ -420,6 +466,32 @@ if [[ ! -w "$TMP_STDERR_FILE" ]]; then
     exit 36
 fi
 
+# We need a file to write the output of jval to in order to compare it with
+# what jval_test.out says it must be.
+#
+TMP_JVAL_FILE=$(mktemp -u .jparse_test.jval.XXXXXXXXXX)
+rm -f "$TMP_JVAL_FILE"
+touch "$TMP_JVAL_FILE"
+if [[ ! -e "$TMP_JVAL_FILE" ]]; then
+    echo "$0: could not create output file: $TMP_JVAL_FILE"
+    exit 37
+fi
+if [[ ! -w "$TMP_JVAL_FILE" ]]; then
+    echo "$0: output file not writable: $TMP_JVAL_FILE"
+    exit 38
+fi
+
+# We need a directory for the JSON file, path index and timestamp file of the
+# jval -I tests.
+#
+TMP_JVAL_DIR=$(mktemp -u .jparse_test.jval_index.XXXXXXXXXX)
+rm -rf "$TMP_JVAL_DIR"
+mkdir "$TMP_JVAL_DIR"
+if [[ ! -d "$TMP_JVAL_DIR" || ! -w "$TMP_JVAL_DIR" ]]; then
+    echo "$0: could not create writable directory: $TMP_JVAL_DIR"
+    exit 39
+fi
+
 # remove logfile so that each run starts out with an empty file
 #
 rm -f "$LOGFILE"
@@ -436,9 +508,9 @@ fi
 # remove or keep (some) temporary files
 #
 if [[ -z $K_FLAG ]]; then
-    trap "rm -f \$TMP_STDERR_FILE; exit" 0 1 2 3 15
+    trap "rm -f \$TMP_STDERR_FILE \$TMP_JVAL_FILE; rm -rf \$TMP_JVAL_DIR; exit" 0 1 2 3 15
 else
-    trap "rm -f \$TMP_STDERR_FILE; exit" 1 2 3 15
+    trap "rm -f \$TMP_STDERR_FILE \$TMP_JVAL_FILE; rm -rf \$TMP_JVAL_DIR; exit" 1 2 3 15
 fi
 
 # update_file_summary - updates file failure summary message
@@ -560,6 +632,18 @@ run_location_err_test()
 	echo "$0: debug[1]: fail test OK, $JPARSE -- $jparse_test_file matches error file" | tee -a -- "$LOGFILE"
     fi
 
+    # the hand-written scanner (-F) must report the same errors at the same locations
+    #
+    "$JPARSE" -F -- "$jparse_test_file" 2>"$TMP_STDERR_FILE" | tee -a -- "${LOGFILE}"
+    if ! cmp -s "$jparse_err_file" "$TMP_STDERR_FILE"; then
+	echo "$0: Warning: in run_location_err_test: FAIL: $JPARSE -F -- $jparse_test_file 2>$TMP_STDERR_FILE | tee -a -- ${LOGFILE}" 2>&1
+	echo "$0: Warning: in run_location_err_test: expected errors: $jparse_err_file do not match result of test: $TMP_STDERR_FILE" 1>&2
+	echo | tee -a -- "${LOGFILE}" 1>&2
+	EXIT_CODE=1
+    elif [[ "$V_FLAG" -ge 1 ]]; then
+	echo "$0: debug[1]: fail test OK, $JPARSE -F -- $jparse_test_file matches error file" | tee -a -- "$LOGFILE"
+    fi
+
     # return
     #
     return
@@ -738,6 +822,227 @@ run_print_test()
 
 
 
+# update_jval_summary - updates jval failure summary message
+#
+# We do this this way so a blank line is not put at the top.
+#
+# usage: update_jval_summary test
+update_jval_summary()
+{
+    if [[ "$#" -ne 1 ]]; then
+	echo "$0: ERROR: update_jval_summary: expected 1 arg, got $#" 1>&2
+	exit 13
+    fi
+
+    if [[ -z "$JVAL_FAILURE_SUMMARY" ]]; then
+	JVAL_FAILURE_SUMMARY="${1}"
+    else
+	JVAL_FAILURE_SUMMARY="$JVAL_FAILURE_SUMMARY
+${1}"
+    fi
+}
+
+# run_jval_test - run jval on each pattern of jval_test.txt, checking the output
+#
+# Each pattern, and what jval printed for it, is written after a line of the
+# form "== pattern".  What is written must be the same as jval_test.out.  As this
+# is done without and with -S, the JSON parse tree and the JSON event stream
+# must match the same JSON values in the same order.
+#
+# usage:
+#	run_jval_test jval [flag]
+#
+#	jval			path to the jval program
+#	flag			jval option to use (such as -S), if any
+#
+run_jval_test()
+{
+    # parse args
+    #
+    if [[ $# -lt 1 || $# -gt 2 ]]; then
+	echo "$0: ERROR: expected 1 or 2 args to run_jval_test, found $#" 1>&2
+	exit 14
+    fi
+    declare jval="$1"
+    declare -a flag=()
+    declare cmd="jval${2:+ $2}"
+    declare pattern
+    declare status
+
+    if [[ $# -eq 2 ]]; then
+	flag=("$2")
+    fi
+
+    # debugging
+    #
+    if [[ $V_FLAG -ge 9 ]]; then
+	echo "$0: debug[9]: in run_jval_test: jval: $jval" 1>&2
+	echo "$0: debug[9]: in run_jval_test: flag: ${flag[*]}" 1>&2
+    fi
+
+    # run jval on each pattern, skipping comments and empty lines
+    #
+    : > "$TMP_JVAL_FILE"
+    while read -r pattern; do
+	if [[ -z $pattern || $pattern == \#* ]]; then
+	    continue
+	fi
+	echo "$0: debug[3]: about to run test that must PASS: $jval${2:+ $2} -q -- $JVAL_TEST_JSON '$pattern'" >> "${LOGFILE}"
+	echo "== $pattern" >> "$TMP_JVAL_FILE"
+	"$jval" "${flag[@]}" -q -- "$JVAL_TEST_JSON" "$pattern" >> "$TMP_JVAL_FILE" 2>> "${LOGFILE}"
+	status="$?"
+	if [[ $status -ne 0 ]]; then
+	    echo "$0: in test that must PASS: $cmd '$pattern' FAIL, exit code: $status" 1>&2 >> "${LOGFILE}"
+	    update_jval_summary "$cmd $JVAL_TEST_JSON '$pattern'"
+	    EXIT_CODE=1
+	fi
+    done < "$JVAL_TEST_FILE"
+
+    # examine test result
+    #
+    if ! diff -u "$JVAL_TEST_OUT" "$TMP_JVAL_FILE" >> "${LOGFILE}" 2>&1; then
+	echo "$0: in test that must PASS: $cmd output differs from: $JVAL_TEST_OUT" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "$cmd $JVAL_TEST_JSON: output differs from: $JVAL_TEST_OUT"
+	EXIT_CODE=1
+    elif [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: $cmd output is the same as: $JVAL_TEST_OUT" 1>&2 >> "${LOGFILE}"
+    fi
+    echo >> "${LOGFILE}"
+
+    # return
+    #
+    return
+}
+
+# run_jval_index_test - run jval -I on a pattern, checking the output and if the path index was formed
+#
+# Before jval is run, the modification time of the path index (if it exists)
+# is set back to 2000, so that the path index was formed by jval if, and only
+# if, it is newer than the timestamp file, whose modification time is in 2001.
+# A path index formed again must be a new file renamed over the old one (a new
+# inode number), with no temporary file left beside it.
+#
+# usage:
+#	run_jval_index_test jval json pattern output formed
+#
+#	jval			path to the jval program
+#	json			JSON file
+#	pattern			pattern of names only
+#	output			what jval must print, without the final newline
+#	formed			1 ==> jval must form the path index, 0 ==> jval must use it as is
+#
+run_jval_index_test()
+{
+    # parse args
+    #
+    if [[ $# -ne 5 ]]; then
+	echo "$0: ERROR: expected 5 args to run_jval_index_test, found $#" 1>&2
+	exit 16
+    fi
+    declare jval="$1"
+    declare json="$2"
+    declare pattern="$3"
+    declare output="$4"
+    declare formed="$5"
+    declare index="$TMP_JVAL_DIR/index"
+    declare stamp="$TMP_JVAL_DIR/stamp"
+    declare inode=
+    declare status
+
+    # debugging
+    #
+    if [[ $V_FLAG -ge 9 ]]; then
+	echo "$0: debug[9]: in run_jval_index_test: jval: $jval" 1>&2
+	echo "$0: debug[9]: in run_jval_index_test: json: $json" 1>&2
+	echo "$0: debug[9]: in run_jval_index_test: pattern: $pattern" 1>&2
+	echo "$0: debug[9]: in run_jval_index_test: formed: $formed" 1>&2
+    fi
+
+    if [[ ! -e $stamp ]]; then
+	touch -t 200101010000 "$stamp"
+    fi
+    if [[ -e $index ]]; then
+	touch -t 200001010000 "$index"
+	inode=$(ls -i "$index" | awk '{print $1}')
+    fi
+    echo "$0: debug[3]: about to run test that must PASS: $jval -q -I $index -- $json '$pattern'" >> "${LOGFILE}"
+    "$jval" -q -I "$index" -- "$json" "$pattern" > "$TMP_JVAL_FILE" 2>> "${LOGFILE}"
+    status="$?"
+
+    # examine test result
+    #
+    if [[ $status -ne 0 ]]; then
+	echo "$0: in test that must PASS: jval -I '$pattern' FAIL, exit code: $status" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $json '$pattern': exit code $status"
+	EXIT_CODE=1
+    elif [[ $(< "$TMP_JVAL_FILE") != "$output" ]]; then
+	echo "$0: in test that must PASS: jval -I '$pattern' printed:" 1>&2 >> "${LOGFILE}"
+	cat "$TMP_JVAL_FILE" >> "${LOGFILE}"
+	echo "$0: instead of:" 1>&2 >> "${LOGFILE}"
+	echo "$output" >> "${LOGFILE}"
+	update_jval_summary "jval -I $json '$pattern': wrong output"
+	EXIT_CODE=1
+    elif [[ $formed -ne 0 && ! $index -nt $stamp ]]; then
+	echo "$0: in test that must PASS: jval -I '$pattern' did not form the path index" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $json '$pattern': path index not formed"
+	EXIT_CODE=1
+    elif [[ $formed -eq 0 && $index -nt $stamp ]]; then
+	echo "$0: in test that must PASS: jval -I '$pattern' formed the path index again" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $json '$pattern': path index formed again"
+	EXIT_CODE=1
+    elif [[ $formed -ne 0 && -n $inode && $(ls -i "$index" | awk '{print $1}') == "$inode" ]]; then
+	echo "$0: in test that must PASS: jval -I '$pattern' wrote the path index in place" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $json '$pattern': path index written in place"
+	EXIT_CODE=1
+    elif compgen -G "$index.*" > /dev/null; then
+	echo "$0: in test that must PASS: jval -I '$pattern' left a temporary path index: $(echo "$index".*)" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $json '$pattern': temporary path index left"
+	EXIT_CODE=1
+    fi
+
+    # return
+    #
+    return
+}
+
+# run_jval_usage_test - run jval on an invalid command line, making sure it is rejected
+#
+# usage:
+#	run_jval_usage_test jval arg ...
+#
+#	jval			path to the jval program
+#	arg ...			jval args that must be a command line error (exit code 3)
+#
+run_jval_usage_test()
+{
+    # parse args
+    #
+    if [[ $# -lt 2 ]]; then
+	echo "$0: ERROR: expected at least 2 args to run_jval_usage_test, found $#" 1>&2
+	exit 15
+    fi
+    declare jval="$1"
+    declare status
+    shift
+
+    echo "$0: debug[3]: about to run test that must FAIL: $jval $*" >> "${LOGFILE}"
+    "$jval" "$@" > "$TMP_JVAL_FILE" 2>> "${LOGFILE}"
+    status="$?"
+    if [[ $status -ne 3 ]]; then
+	echo "$0: in test that must FAIL: jval $* exit code: $status != 3" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval $*: exit code $status != 3"
+	EXIT_CODE=1
+    elif [[ -s $TMP_JVAL_FILE ]]; then
+	echo "$0: in test that must FAIL: jval $* wrote to stdout" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval $*: wrote to stdout"
+	EXIT_CODE=1
+    fi
+
+    # return
+    #
+    return
+}
+
 # run_string_test - run a single jparse test on a string
 #
 # usage:
@@ -952,6 +1257,262 @@ if [[ -n "$D_FLAG" ]]; then
 	run_file_test "$JPARSE" "$DBG_LEVEL" "$JSON_DBG_LEVEL" "$Q_FLAG" "$file" fail
     done < <(find "$JSON_BAD_TREE" -type f -name '*.json' -print)
 
+    # run tests that must PASS and FAIL again with the JSON parse tree in an arena
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -A tests: JSON files" 1>&2 >> "${LOGFILE}"
+    fi
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must pass: $JPARSE -A -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if ! "$JPARSE" -A -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must PASS: jparse -A FAIL" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print)
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must fail: $JPARSE -A -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if "$JPARSE" -A -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must FAIL: jparse -A OK, exit code 0" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_BAD_TREE" -type f -name '*.json' -print)
+
+    # run tests that must PASS and FAIL again with the JSON files scanned in place
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -z tests: JSON files" 1>&2 >> "${LOGFILE}"
+    fi
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must pass: $JPARSE -z -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if ! "$JPARSE" -z -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must PASS: jparse -z FAIL" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print)
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must fail: $JPARSE -z -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if "$JPARSE" -z -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must FAIL: jparse -z OK, exit code 0" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_BAD_TREE" -type f -name '*.json' -print)
+
+    # run tests that must PASS by writing a snapshot of the JSON parse tree of
+    # each good JSON file and loading it, and a test that must FAIL by loading
+    # a JSON file as a snapshot
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -o and -m tests: JSON files" 1>&2 >> "${LOGFILE}"
+    fi
+    SNAP_FILE="$TMP_STDERR_FILE"
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must pass: $JPARSE -o $SNAP_FILE -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if ! "$JPARSE" -o "$SNAP_FILE" -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must PASS: jparse -o FAIL" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	    continue
+	fi
+	echo "$0: debug[3]: about to run test that must pass: $JPARSE -m -q -- $SNAP_FILE >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if ! "$JPARSE" -m -q -- "$SNAP_FILE" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must PASS: jparse -m FAIL" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print)
+
+    # a snapshot written again must be a new file renamed over the old one, so
+    # that a jparse -m loading it at the same time never sees a partial one,
+    # and no temporary file may be left
+    #
+    SNAP_INODE=$(ls -i "$SNAP_FILE" | awk '{print $1}')
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must pass: $JPARSE -o $SNAP_FILE -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if ! "$JPARSE" -o "$SNAP_FILE" -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must PASS: jparse -o FAIL" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	elif [[ $(ls -i "$SNAP_FILE" | awk '{print $1}') == "$SNAP_INODE" ]]; then
+	    echo "$0: in test that must PASS: jparse -o wrote the snapshot in place" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	elif compgen -G "$SNAP_FILE.*" > /dev/null; then
+	    echo "$0: in test that must PASS: jparse -o left a temporary snapshot: $(echo "$SNAP_FILE".*)" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print | head -n 1)
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must fail: $JPARSE -m -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if "$JPARSE" -m -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must FAIL: jparse -m OK, exit code 0" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print | head -n 1)
+
+    # run tests that must PASS and FAIL again with JSON events instead of a JSON parse tree
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -E tests: JSON files" 1>&2 >> "${LOGFILE}"
+    fi
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must pass: $JPARSE -E -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if ! "$JPARSE" -E -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must PASS: jparse -E FAIL" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print)
+    while read -r file; do
+	echo "$0: debug[3]: about to run test that must fail: $JPARSE -E -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	if "$JPARSE" -E -q -- "$file" >> "${LOGFILE}" 2>&1; then
+	    echo "$0: in test that must FAIL: jparse -E OK, exit code 0" 1>&2 >> "${LOGFILE}"
+	    update_file_summary "$file"
+	    EXIT_CODE=1
+	fi
+    done < <(find "$JSON_BAD_TREE" -type f -name '*.json' -print)
+
+    # run tests that must PASS and FAIL again with a JSON push parser, a byte at a
+    # time forming a JSON parse tree and 7 bytes at a time with JSON events, and
+    # with the hand-written scanner, forming a JSON parse tree and with JSON events
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -P and -F tests: JSON files" 1>&2 >> "${LOGFILE}"
+    fi
+    while read -r file; do
+	for PUSH_OPTS in "-P 1" "-E -P 7" "-F" "-F -E"; do
+	    echo "$0: debug[3]: about to run test that must pass: $JPARSE $PUSH_OPTS -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	    # shellcheck disable=SC2086
+	    if ! "$JPARSE" $PUSH_OPTS -q -- "$file" >> "${LOGFILE}" 2>&1; then
+		echo "$0: in test that must PASS: jparse $PUSH_OPTS FAIL" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$file"
+		EXIT_CODE=1
+	    fi
+	done
+    done < <(find "$JSON_GOOD_TREE" -type f -name '*.json' -print)
+    while read -r file; do
+	for PUSH_OPTS in "-P 1" "-E -P 7" "-F" "-F -E"; do
+	    echo "$0: debug[3]: about to run test that must fail: $JPARSE $PUSH_OPTS -q -- $file >> ${LOGFILE} 2>&1" >> "${LOGFILE}"
+	    # shellcheck disable=SC2086
+	    if "$JPARSE" $PUSH_OPTS -q -- "$file" >> "${LOGFILE}" 2>&1; then
+		echo "$0: in test that must FAIL: jparse $PUSH_OPTS OK, exit code 0" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$file"
+		EXIT_CODE=1
+	    fi
+	done
+    done < <(find "$JSON_BAD_TREE" -type f -name '*.json' -print)
+
+    # run tests that must PASS and FAIL again on a pool of workers, walking the
+    # good and bad JSON trees, checking that every file is reported as it must be
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -W tests: JSON trees" 1>&2 >> "${LOGFILE}"
+    fi
+    POOL_OUT="$TMP_STDERR_FILE"
+    echo "$0: debug[3]: about to run test that must pass: $JPARSE -W 4 -q -- $JSON_GOOD_TREE > $POOL_OUT 2>> ${LOGFILE}" >> "${LOGFILE}"
+    if ! "$JPARSE" -W 4 -q -- "$JSON_GOOD_TREE" > "$POOL_OUT" 2>> "${LOGFILE}"; then
+	echo "$0: in test that must PASS: jparse -W 4 FAIL" 1>&2 >> "${LOGFILE}"
+	update_file_summary "$JSON_GOOD_TREE"
+	EXIT_CODE=1
+    elif [[ $(grep -c '^valid	' "$POOL_OUT") -ne $(find "$JSON_GOOD_TREE" -type f -name '*.json' -print | wc -l) ]]; then
+	echo "$0: in test that must PASS: jparse -W 4 did not report every file as valid" 1>&2 >> "${LOGFILE}"
+	update_file_summary "$JSON_GOOD_TREE"
+	EXIT_CODE=1
+    fi
+    cat "$POOL_OUT" >> "${LOGFILE}"
+    echo "$0: debug[3]: about to run test that must fail: $JPARSE -E -W 4 -q -- $JSON_BAD_TREE > $POOL_OUT 2>> ${LOGFILE}" >> "${LOGFILE}"
+    if "$JPARSE" -E -W 4 -q -- "$JSON_BAD_TREE" > "$POOL_OUT" 2>> "${LOGFILE}"; then
+	echo "$0: in test that must FAIL: jparse -E -W 4 OK, exit code 0" 1>&2 >> "${LOGFILE}"
+	update_file_summary "$JSON_BAD_TREE"
+	EXIT_CODE=1
+    elif [[ $(grep -c '^invalid	' "$POOL_OUT") -ne $(find "$JSON_BAD_TREE" -type f -name '*.json' -print | wc -l) ]]; then
+	echo "$0: in test that must FAIL: jparse -E -W 4 did not report every file as invalid" 1>&2 >> "${LOGFILE}"
+	update_file_summary "$JSON_BAD_TREE"
+	EXIT_CODE=1
+    fi
+    cat "$POOL_OUT" >> "${LOGFILE}"
+
+    # run tests that must PASS and FAIL on the JSON string test files as JSON
+    # Lines (NDJSON), one at a time and on a pool of workers, checking that
+    # every record is reported as it must be, at the line it is on
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse -N tests: $JSON_NDJSON_GOOD_FILE $JSON_NDJSON_BAD_FILE" 1>&2 >> "${LOGFILE}"
+    fi
+    if [[ ! -r $JSON_NDJSON_GOOD_FILE || ! -r $JSON_NDJSON_BAD_FILE ]]; then
+	echo "$0: debug[3]: skipping jparse -N tests: no JSON string test files next to: $JSON_TREE" >> "${LOGFILE}"
+    else
+	for NDJSON_OPTS in "-N" "-N -W 4"; do
+	    echo "$0: debug[3]: about to run test that must pass: $JPARSE $NDJSON_OPTS -q -- $JSON_NDJSON_GOOD_FILE > $POOL_OUT 2>> ${LOGFILE}" >> "${LOGFILE}"
+	    # shellcheck disable=SC2086
+	    if ! "$JPARSE" $NDJSON_OPTS -q -- "$JSON_NDJSON_GOOD_FILE" > "$POOL_OUT" 2>> "${LOGFILE}"; then
+		echo "$0: in test that must PASS: jparse $NDJSON_OPTS FAIL" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$JSON_NDJSON_GOOD_FILE"
+		EXIT_CODE=1
+	    elif [[ $(grep -c '^valid	' "$POOL_OUT") -ne $(grep -c -v '^[[:space:]]*$' "$JSON_NDJSON_GOOD_FILE") ]]; then
+		echo "$0: in test that must PASS: jparse $NDJSON_OPTS did not report every record as valid" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$JSON_NDJSON_GOOD_FILE"
+		EXIT_CODE=1
+	    fi
+	    cat "$POOL_OUT" >> "${LOGFILE}"
+	    echo "$0: debug[3]: about to run test that must fail: $JPARSE -E $NDJSON_OPTS -q -- $JSON_NDJSON_BAD_FILE > $POOL_OUT 2>> ${LOGFILE}" >> "${LOGFILE}"
+	    # shellcheck disable=SC2086
+	    if "$JPARSE" -E $NDJSON_OPTS -q -- "$JSON_NDJSON_BAD_FILE" > "$POOL_OUT" 2>> "${LOGFILE}"; then
+		echo "$0: in test that must FAIL: jparse -E $NDJSON_OPTS OK, exit code 0" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$JSON_NDJSON_BAD_FILE"
+		EXIT_CODE=1
+	    elif ! grep -q '^invalid	' "$POOL_OUT" ||
+		 [[ $(sed -n -e 's/^invalid	.*://p' "$POOL_OUT") != "$(grep -n -v '^[[:space:]]*$' "$JSON_NDJSON_BAD_FILE" | cut -d: -f1)" ]]; then
+		echo "$0: in test that must FAIL: jparse -E $NDJSON_OPTS did not report every record as invalid at its line" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$JSON_NDJSON_BAD_FILE"
+		EXIT_CODE=1
+	    fi
+	    cat "$POOL_OUT" >> "${LOGFILE}"
+	done
+    fi
+
+    # run tests with very deep nesting that must not crash jparse, with a small
+    # stack so that walking (or freeing or printing) a JSON parse tree with a
+    # recursion per level would crash: 5000 levels of arrays are valid JSON,
+    # 100000 levels may be valid or invalid (the parser limits the depth it
+    # accepts) but must be reported as one or the other, and 100000 levels
+    # never closed are invalid
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jparse deep nesting tests" 1>&2 >> "${LOGFILE}"
+    fi
+    DEEP_FILE="$TMP_STDERR_FILE"
+    for DEEP in 5000 100000 100000-open; do
+	printf '%*s' "${DEEP%-open}" '' | tr ' ' '[' > "$DEEP_FILE"
+	if [[ $DEEP != *-open ]]; then
+	    printf '%*s' "$DEEP" '' | tr ' ' ']' >> "$DEEP_FILE"
+	fi
+	for DEEP_OPTS in "" "-A" "-z" "-E" "-F" "-P 7" "-P 7 -A" "-P 4096 -J 3"; do
+	    echo "$0: debug[3]: about to run test that must not crash: (ulimit -s 256; $JPARSE${DEEP_OPTS:+ $DEEP_OPTS} -q -- $DEEP levels) > /dev/null 2>&1" >> "${LOGFILE}"
+	    # shellcheck disable=SC2086
+	    (ulimit -s 256 2>/dev/null; "$JPARSE" $DEEP_OPTS -q -- "$DEEP_FILE") > /dev/null 2>&1
+	    status="$?"
+	    if [[ $DEEP == 5000 && $status -ne 0 ]]; then
+		echo "$0: in test that must PASS: jparse${DEEP_OPTS:+ $DEEP_OPTS} on $DEEP levels exit code: $status" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$DEEP levels of arrays"
+		EXIT_CODE=1
+	    elif [[ $DEEP == *-open && $status -ne 1 ]]; then
+		echo "$0: in test that must FAIL: jparse${DEEP_OPTS:+ $DEEP_OPTS} on $DEEP levels exit code: $status" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$DEEP levels of arrays"
+		EXIT_CODE=1
+	    elif [[ $status -ne 0 && $status -ne 1 ]]; then
+		echo "$0: in test that must not crash: jparse${DEEP_OPTS:+ $DEEP_OPTS} on $DEEP levels exit code: $status" 1>&2 >> "${LOGFILE}"
+		update_file_summary "$DEEP levels of arrays"
+		EXIT_CODE=1
+	    fi
+	done
+    done
+
     # run tests that must FAIL with correct error locations, if -L not used
     if [[ -z "$L_FLAG" ]]; then
 	while read -r file; do
@@ -966,6 +1527,121 @@ if [[ -n "$PRINT_TEST_FLAG_USED" ]]; then
     run_print_test "$PRINT_TEST" "$DBG_LEVEL" "$Q_FLAG"
 fi
 
+# run jval tests if -l used
+#
+if [[ -n "$JVAL_FLAG_USED" ]]; then
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run jval tests: $JVAL_TEST_FILE" 1>&2 >> "${LOGFILE}"
+    fi
+
+    # each pattern must match the same JSON values without and with -S
+    #
+    run_jval_test "$JVAL"
+    run_jval_test "$JVAL" -S
+
+    # [index=min:-n] needs the number of members or elements, so it works on
+    # the JSON parse tree but -S must reject it
+    #
+    echo "$0: debug[3]: about to run test that must PASS: $JVAL -q -- $JVAL_TEST_JSON '/list/*[index=0:-6]'" >> "${LOGFILE}"
+    if ! "$JVAL" -q -- "$JVAL_TEST_JSON" '/list/*[index=0:-6]' > "$TMP_JVAL_FILE" 2>> "${LOGFILE}"; then
+	echo "$0: in test that must PASS: jval '/list/*[index=0:-6]' FAIL" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval $JVAL_TEST_JSON '/list/*[index=0:-6]'"
+	EXIT_CODE=1
+    elif [[ $(< "$TMP_JVAL_FILE") != $'10\n2.5\n1e3' ]]; then
+	echo "$0: in test that must PASS: jval '/list/*[index=0:-6]' did not match the first 3 elements" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval $JVAL_TEST_JSON '/list/*[index=0:-6]': wrong matches"
+	EXIT_CODE=1
+    fi
+    run_jval_usage_test "$JVAL" -S -q -- "$JVAL_TEST_JSON" '/list/*[index=0:-6]'
+
+    # invalid patterns must be rejected without and with -S
+    #
+    for pattern in '' '///name' '/list[' '/list/*[type=nope]' '/list/*[num=x]' '/list/*[nope=1]' '/list/*[index=1]x'; do
+	run_jval_usage_test "$JVAL" -q -- "$JVAL_TEST_JSON" "$pattern"
+	run_jval_usage_test "$JVAL" -S -q -- "$JVAL_TEST_JSON" "$pattern"
+    done
+
+    # each pattern of names only must match the same JSON values with -I: the
+    # first forms the path index and the others use it
+    #
+    JVAL_INDEX_JSON="$TMP_JVAL_DIR/jval_test.json"
+    cp -f "$JVAL_TEST_JSON" "$JVAL_INDEX_JSON"
+    JVAL_INDEX_FORMED=1
+    JVAL_ANY_RE='(^|[^\])[*]'
+    while read -r pattern; do
+	if [[ -z $pattern || $pattern == \#* || $pattern == *'['* || $pattern == *'//'* || $pattern =~ $JVAL_ANY_RE ]]; then
+	    continue
+	fi
+	run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" "$pattern" \
+	    "$(P="$pattern" awk '$0 == "== " ENVIRON["P"] { found = 1; next } /^== / { found = 0 } found' "$JVAL_TEST_OUT")" \
+	    "$JVAL_INDEX_FORMED"
+	JVAL_INDEX_FORMED=0
+    done < "$JVAL_TEST_FILE"
+
+    # a damaged path index must be formed again, not trusted: a byte in the
+    # middle (of the entries) and the last byte (the NUL of the last path in
+    # the path pool)
+    #
+    JVAL_INDEX_SIZE=$(wc -c < "$TMP_JVAL_DIR/index")
+    printf '\377' | dd of="$TMP_JVAL_DIR/index" bs=1 seek=$((JVAL_INDEX_SIZE / 2)) conv=notrunc 2>/dev/null
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /obj/y '42' 1
+    JVAL_INDEX_SIZE=$(wc -c < "$TMP_JVAL_DIR/index")
+    printf 'x' | dd of="$TMP_JVAL_DIR/index" bs=1 seek=$((JVAL_INDEX_SIZE - 1)) conv=notrunc 2>/dev/null
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /obj/y '42' 1
+
+    # the path index must be formed again when the JSON file changes size
+    #
+    sed -e 's/"top"/"changed"/' "$JVAL_TEST_JSON" > "$JVAL_INDEX_JSON"
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /name '"changed"' 1
+
+    # the path index must be formed again when the JSON file changes
+    # modification time, and only then
+    #
+    touch -t 200201010000 "$JVAL_INDEX_JSON"
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /name '"changed"' 1
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /obj/y '42' 0
+
+    # the path index must be formed again when the JSON file is rewritten with
+    # the same size and modification time: once with a path index formed a
+    # second after the JSON file last changed (the status change time of the
+    # JSON file changes), and once with a path index formed in the same second
+    # (the hash of the JSON file changes)
+    #
+    sleep 1
+    rm -f "$TMP_JVAL_DIR/index"
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /name '"changed"' 1
+    sed -e 's/"changed"/"CHANGED"/' "$JVAL_INDEX_JSON" > "$TMP_JVAL_DIR/rewrite.json"
+    cat "$TMP_JVAL_DIR/rewrite.json" > "$JVAL_INDEX_JSON"
+    touch -t 200201010000 "$JVAL_INDEX_JSON"
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /name '"CHANGED"' 1
+    sed -e 's/"CHANGED"/"Changed"/' "$JVAL_INDEX_JSON" > "$TMP_JVAL_DIR/rewrite.json"
+    cat "$TMP_JVAL_DIR/rewrite.json" > "$JVAL_INDEX_JSON"
+    touch -t 200201010000 "$JVAL_INDEX_JSON"
+    run_jval_index_test "$JVAL" "$JVAL_INDEX_JSON" /name '"Changed"' 1
+
+    # a path index that cannot be written is not invalid JSON: the JSON file
+    # must be parsed without it
+    #
+    echo "$0: debug[3]: about to run test that must PASS: $JVAL -q -I $TMP_JVAL_DIR/none/index -- $JVAL_INDEX_JSON /obj/y" >> "${LOGFILE}"
+    if ! "$JVAL" -q -I "$TMP_JVAL_DIR/none/index" -- "$JVAL_INDEX_JSON" /obj/y > "$TMP_JVAL_FILE" 2>> "${LOGFILE}"; then
+	echo "$0: in test that must PASS: jval -I with a path index that cannot be written FAIL" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $TMP_JVAL_DIR/none/index $JVAL_INDEX_JSON /obj/y"
+	EXIT_CODE=1
+    elif [[ $(< "$TMP_JVAL_FILE") != '42' ]]; then
+	echo "$0: in test that must PASS: jval -I with a path index that cannot be written did not match 42" 1>&2 >> "${LOGFILE}"
+	update_jval_summary "jval -I $TMP_JVAL_DIR/none/index $JVAL_INDEX_JSON /obj/y: wrong matches"
+	EXIT_CODE=1
+    fi
+
+    # -I must be rejected with patterns that are not names only, and with -N or -S
+    #
+    for pattern in '/list/*' '//name' '/name[type=str]' '/list[index=1]'; do
+	run_jval_usage_test "$JVAL" -q -I "$TMP_JVAL_DIR/index" -- "$JVAL_INDEX_JSON" "$pattern"
+    done
+    run_jval_usage_test "$JVAL" -q -S -I "$TMP_JVAL_DIR/index" -- "$JVAL_INDEX_JSON" /name
+    run_jval_usage_test "$JVAL" -q -N -I "$TMP_JVAL_DIR/index" -- "$JVAL_INDEX_JSON" /name
+fi
+
 if [[ -n "$FILE_FAILURE_SUMMARY" ]]; then
     echo "The following files failed: " | tee -a -- "${LOGFILE}"
     echo "--" | tee -a -- "${LOGFILE}"
@@ -981,10 +1657,17 @@ fi
 if [[ -n "$PRINT_TEST_FAILURE" ]]; then
     echo "NOTE: the print_test test failed. See the ${LOGFILE} file for details."
 fi
+if [[ -n "$JVAL_FAILURE_SUMMARY" ]]; then
+    echo "The following jval tests failed: " | tee -a -- "${LOGFILE}"
+    echo "--" | tee -a -- "${LOGFILE}"
+    echo "$JVAL_FAILURE_SUMMARY" | tee -a -- "${LOGFILE}"
+    echo "--" | tee -a -- "${LOGFILE}"
+fi
 
 # explicitly delete the temporary files if -k not used
 if [[ -z $K_FLAG ]]; then
-    rm -f "$TMP_STDERR_FILE"
+    rm -f "$TMP_STDERR_FILE" "$TMP_JVAL_FILE"
+    rm -rf "$TMP_JVAL_DIR"
 else
     echo
     echo "$0: keeping temporary files due to use of -k"
@@ -995,7 +1678,13 @@ else
     if [[ -e $TMP_STDERR_FILE ]]; then
 	echo -n " $TMP_STDERR_FILE"
     fi
+    if [[ -e $TMP_JVAL_FILE ]]; then
+	echo -n " $TMP_JVAL_FILE"
+    fi
     echo
+    if [[ -e $TMP_JVAL_DIR ]]; then
+	echo "rm -rf $TMP_JVAL_DIR"
+    fi
 fi
 
 # All Done!!! All Done!!! -- Jessica Noll, Age 2
@@ -0,0 +1,837 @@
+/*
+ * jparse_thread_test - parse JSON documents from many threads at once
+ *
+ * Every JSON document given on the command line is parsed, over and over, by
+ * a number of threads at the same time, using each of the ways the JSON
+ * parser can parse a document.  Each parse must come up with the same result
+ * as a parse of the same document by the main thread alone.
+ *
+ * "Because two threads should not know what the other one is parsing." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <locale.h>
+
+#include "../util.h"
+#include "../jparse.h"
+
+/*
+ * jparse_thread_test - parse JSON documents from many threads at once
+ */
+#include "jparse_thread_test.h"
+
+/*
+ * definitions
+ */
+#define REQUIRED_ARGS (1)	/* number of required arguments on the command line */
+#define FNV1A_64_BASIS ((uint64_t)0xcbf29ce484222325ULL)	/* FNV-1a 64 bit offset basis */
+#define FNV1A_64_PRIME ((uint64_t)0x100000001b3ULL)		/* FNV-1a 64 bit prime */
+
+
+/*
+ * usage message
+ *
+ * Use the usage() function to print the usage_msg([0-9]?)+ strings.
+ */
+static const char * const usage_msg =
+    "usage: %s [-h] [-v level] [-J level] [-V] [-e] [-t threads] [-n rounds] file.json ...\n"
+    "\n"
+    "\t-h\t\tprint help message and exit\n"
+    "\t-v level\tset verbosity level (def level: %d)\n"
+    "\t-J level\tset JSON verbosity level (def level: %d)\n"
+    "\t-V\t\tprint version strings and exit\n"
+    "\t-e\t\tdo not silence the messages about JSON that is not valid\n"
+    "\t-t threads\tnumber of threads (def: %d)\n"
+    "\t-n rounds\tnumber of times each thread parses every JSON document (def: %d)\n"
+    "\n"
+    "\tfile.json\tJSON document to parse, valid or not\n"
+    "\n"
+    "Exit codes:\n"
+    "\t0\t\tall is OK\n"
+    "\t1\t\tsome parse did not match the parse of the same JSON document by the main thread\n"
+    "\t2\t\t-h and help string printed or -V and version strings printed\n"
+    "\t3\t\tcommand line error\n"
+    "\t>=10\t\tinternal error\n"
+    "\n"
+    "%s version: %s\n"
+    "jparse utils version: %s\n"
+    "jparse UTF-8 version: %s\n"
+    "jparse library version: %s";
+
+
+/*
+ * static variables
+ */
+static struct json_event_cb const digest_cb;	/* JSON event callbacks that form an event digest */
+
+
+/*
+ * forward declarations
+ */
+static void digest_bytes(uint64_t *digest, void const *buf, size_t len);
+static bool digest_start_object(void *data);
+static bool digest_end_object(void *data);
+static bool digest_start_array(void *data);
+static bool digest_end_array(void *data);
+static bool digest_member_name(void *data, char const *name, size_t len);
+static bool digest_value(void *data, enum item_type type, char const *str, size_t len);
+static void vdigest_node(struct json *node, unsigned int depth, va_list ap);
+static uint64_t tree_digest(struct json *tree);
+static bool parse_doc(struct jparse_thread_doc const *doc, enum jparse_thread_mode mode, size_t chunk,
+		      uint64_t *digest);
+static void *jparse_thread(void *arg);
+static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
+
+
+/*
+ * JSON event callbacks that form an event digest
+ */
+static struct json_event_cb const digest_cb = {
+    digest_start_object,
+    digest_end_object,
+    digest_start_array,
+    digest_end_array,
+    digest_member_name,
+    digest_value,
+    NULL,
+};
+
+
+int
+main(int argc, char *argv[])
+{
+    char const *program = NULL;	/* our name */
+    extern char *optarg;	/* option argument */
+    extern int optind;		/* argv index of the next arg */
+    int arg_count = 0;		/* number of args to process */
+    bool opt_error = false;	/* fchk_inval_opt() return */
+    bool silence = true;	/* true ==> silence parser messages while the threads run */
+    int thread_count = JPARSE_THREAD_TEST_THREADS;	/* number of threads */
+    int rounds = JPARSE_THREAD_TEST_ROUNDS;	/* number of times each thread parses every JSON document */
+    struct jparse_thread_doc *doc = NULL;	/* JSON documents to parse */
+    struct jparse_thread *thread = NULL;	/* threads that parse the JSON documents */
+    struct json *tree = NULL;	/* JSON parse tree of the main thread */
+    FILE *stream = NULL;	/* open JSON document */
+    int saved_stderr = -1;	/* stderr while the threads run silenced, or -1 */
+    int null_fd = -1;		/* /dev/null open for writing */
+    uintmax_t parses = 0;	/* total number of parses */
+    uintmax_t mismatches = 0;	/* total number of parses that did not match */
+    int valid_count = 0;	/* number of valid JSON documents */
+    bool valid = false;		/* true ==> JSON parse tree of the main thread is valid */
+    intmax_t num = 0;		/* -t or -n option argument */
+    int ret;			/* libc function return */
+    int i;
+
+    /*
+     * use default locale based on LANG
+     */
+    (void) setlocale(LC_ALL, "");
+
+    /*
+     * firewall - paranoia
+     */
+    if (stdout == NULL) {
+	err(10, __func__, "stdout is NULL");
+	not_reached();
+    }
+    if (stderr == NULL) {
+	err(11, __func__, "stderr is NULL");
+	not_reached();
+    }
+
+    /*
+     * parse args
+     */
+    program = argv[0];
+    while ((i = getopt(argc, argv, ":hv:J:Vet:n:")) != -1) {
+	switch (i) {
+	case 'h':		/* -h - print help to stderr and exit 0 */
+	    usage(2, program, ""); /*ooo*/
+	    not_reached();
+	    break;
+	case 'v':		/* -v verbosity */
+	    /*
+	     * parse verbosity
+	     */
+	    verbosity_level = parse_verbosity(optarg);
+	    if (verbosity_level < 0) {
+		usage(3, program, "invalid -v verbosity"); /*ooo*/
+		not_reached();
+	    }
+	    break;
+	case 'J':		/* -J json_verbosity */
+	    /*
+	     * parse JSON verbosity level
+	     */
+	    json_verbosity_level = parse_verbosity(optarg);
+	    if (json_verbosity_level < 0) {
+		usage(3, program, "invalid -J json_verbosity"); /*ooo*/
+		not_reached();
+	    }
+	    break;
+	case 'V':		/* -V - print version strings and exit */
+	    print("jparse_thread_test version %s\n", JPARSE_THREAD_TEST_VERSION);
+	    print("jparse utils version: %s\n", JPARSE_UTILS_VERSION);
+	    print("jparse UTF-8 version: %s\n", JPARSE_UTF8_VERSION);
+	    print("jparse library version: %s\n", JPARSE_LIBRARY_VERSION);
+	    exit(2); /*ooo*/
+	    not_reached();
+	    break;
+	case 'e':		/* -e - do not silence parser messages */
+	    silence = false;
+	    break;
+	case 't':		/* -t threads - number of threads */
+	    if (!string_to_intmax(optarg, &num) || num < 1 || num > JPARSE_THREAD_TEST_MAX_THREADS) {
+		usage(3, program, "invalid -t threads"); /*ooo*/
+		not_reached();
+	    }
+	    thread_count = (int)num;
+	    break;
+	case 'n':		/* -n rounds - number of times each thread parses every JSON document */
+	    if (!string_to_intmax(optarg, &num) || num < 1 || num > INT_MAX) {
+		usage(3, program, "invalid -n rounds"); /*ooo*/
+		not_reached();
+	    }
+	    rounds = (int)num;
+	    break;
+	case ':':   /* option requires an argument */
+	case '?':   /* illegal option */
+	default:    /* anything else but should not actually happen */
+	    opt_error = fchk_inval_opt(stderr, program, i, optopt);
+	    if (opt_error) {
+		usage(3, program, ""); /*ooo*/
+		not_reached();
+	    } else {
+		fwarn(stderr, __func__, "getopt() return: %c optopt: %c", (char)i, (char)optopt);
+	    }
+	    break;
+	}
+    }
+    arg_count = argc - optind;
+    if (arg_count < REQUIRED_ARGS) {
+	usage(3, program, "wrong number of arguments"); /*ooo*/
+	not_reached();
+    }
+
+    /*
+     * read every JSON document
+     */
+    errno = 0;			/* pre-clear errno */
+    doc = calloc((size_t)arg_count, sizeof(*doc));
+    if (doc == NULL) {
+	errp(12, __func__, "calloc of %d JSON documents failed", arg_count);
+	not_reached();
+    }
+    for (i = 0; i < arg_count; ++i) {
+	doc[i].filename = argv[optind + i];
+	errno = 0;		/* pre-clear errno */
+	stream = fopen(doc[i].filename, "r");
+	if (stream == NULL) {
+	    errp(13, __func__, "cannot open: %s", doc[i].filename);
+	    not_reached();
+	}
+	doc[i].data = read_all(stream, &doc[i].len);
+	if (doc[i].data == NULL) {
+	    err(14, __func__, "cannot read: %s", doc[i].filename);
+	    not_reached();
+	}
+	clearerr_or_fclose(stream);
+	stream = NULL;
+    }
+
+    /*
+     * silence messages about JSON that is not valid while parsing
+     */
+    if (silence) {
+	fflush(stderr);
+	errno = 0;		/* pre-clear errno */
+	null_fd = open("/dev/null", O_WRONLY);
+	if (null_fd < 0) {
+	    errp(15, __func__, "cannot open /dev/null for writing");
+	    not_reached();
+	}
+	errno = 0;		/* pre-clear errno */
+	saved_stderr = dup(STDERR_FILENO);
+	if (saved_stderr < 0) {
+	    errp(16, __func__, "cannot dup stderr");
+	    not_reached();
+	}
+	errno = 0;		/* pre-clear errno */
+	if (dup2(null_fd, STDERR_FILENO) < 0) {
+	    errp(17, __func__, "cannot redirect stderr to /dev/null");
+	    not_reached();
+	}
+    }
+
+    /*
+     * parse every JSON document in the main thread alone
+     *
+     * NOTE: A JSON parse tree is only formed for valid JSON, as forming the
+     *	     JSON parse tree of some JSON that is not valid is a fatal error.
+     *	     Should the JSON parse tree of JSON with valid JSON events not be
+     *	     valid, the JSON document is only parsed into JSON events by the
+     *	     threads and the mismatch is reported once stderr is restored.
+     */
+    for (i = 0; i < arg_count; ++i) {
+	doc[i].event_digest = FNV1A_64_BASIS;
+	doc[i].valid = parse_json_events(doc[i].data, doc[i].len, doc[i].filename, &digest_cb, &doc[i].event_digest);
+	if (doc[i].valid) {
+	    tree = parse_json(doc[i].data, doc[i].len, doc[i].filename, &valid);
+	    if (tree != NULL && valid) {
+		++valid_count;
+		doc[i].tree_digest = tree_digest(tree);
+	    } else {
+		doc[i].valid = false;
+		doc[i].tree_mismatch = true;
+		++mismatches;
+	    }
+	    if (tree != NULL) {
+		json_tree_free(tree, JSON_INFINITE_DEPTH);
+		free(tree);
+		tree = NULL;
+	    }
+	}
+    }
+
+    /*
+     * start the threads
+     */
+    errno = 0;			/* pre-clear errno */
+    thread = calloc((size_t)thread_count, sizeof(*thread));
+    if (thread == NULL) {
+	errp(18, __func__, "calloc of %d threads failed", thread_count);
+	not_reached();
+    }
+    for (i = 0; i < thread_count; ++i) {
+	thread[i].id = i;
+	thread[i].rounds = rounds;
+	thread[i].doc = doc;
+	thread[i].doc_count = arg_count;
+	ret = pthread_create(&thread[i].thread, NULL, jparse_thread, &thread[i]);
+	if (ret != 0) {
+	    errno = ret;
+	    errp(19, __func__, "pthread_create of thread %d failed", i);
+	    not_reached();
+	}
+    }
+
+    /*
+     * wait for the threads
+     */
+    for (i = 0; i < thread_count; ++i) {
+	ret = pthread_join(thread[i].thread, NULL);
+	if (ret != 0) {
+	    errno = ret;
+	    errp(20, __func__, "pthread_join of thread %d failed", i);
+	    not_reached();
+	}
+	parses += thread[i].parses;
+	mismatches += thread[i].mismatches;
+    }
+
+    /*
+     * restore stderr
+     */
+    if (saved_stderr >= 0) {
+	fflush(stderr);
+	errno = 0;		/* pre-clear errno */
+	if (dup2(saved_stderr, STDERR_FILENO) < 0) {
+	    errp(21, __func__, "cannot restore stderr");
+	    not_reached();
+	}
+	(void) close(saved_stderr);
+	(void) close(null_fd);
+    }
+
+    /*
+     * report mismatches
+     */
+    dbg(DBG_LOW, "%d JSON documents, %d valid, %d threads, %d rounds", arg_count, valid_count, thread_count, rounds);
+    for (i = 0; i < arg_count; ++i) {
+	if (doc[i].tree_mismatch) {
+	    fwarn(stderr, __func__, "%s: JSON events are valid but the JSON parse tree is not", doc[i].filename);
+	} else {
+	    dbg(DBG_MED, "%s: %s JSON", doc[i].filename, doc[i].valid ? "valid" : "invalid");
+	}
+    }
+    for (i = 0; i < thread_count; ++i) {
+	if (thread[i].mismatches > 0) {
+	    fwarn(stderr, __func__, "thread %d: %ju of %ju parses did not match", i, thread[i].mismatches,
+		  thread[i].parses);
+	}
+    }
+    dbg(DBG_LOW, "%ju parses, %ju did not match", parses, mismatches);
+
+    /*
+     * free storage
+     */
+    for (i = 0; i < arg_count; ++i) {
+	if (doc[i].data != NULL) {
+	    free(doc[i].data);
+	    doc[i].data = NULL;
+	}
+    }
+    free(doc);
+    doc = NULL;
+    free(thread);
+    thread = NULL;
+
+    /*
+     * exit depending on mismatch count
+     */
+    if (mismatches > 0) {
+	fdbg(stderr, DBG_LOW, "One or more parses FAILED");
+	exit(1); /*ooo*/
+    }
+    fdbg(stderr, DBG_LOW, "All parses PASSED");
+    exit(0); /*ooo*/
+}
+
+
+/*
+ * digest_bytes - add bytes to an FNV-1a 64 bit digest
+ *
+ * given:
+ *	digest	pointer to the digest
+ *	buf	bytes to add
+ *	len	number of bytes to add
+ */
+static void
+digest_bytes(uint64_t *digest, void const *buf, size_t len)
+{
+    unsigned char const *p = buf;	/* next byte to add */
+    size_t i;
+
+    for (i = 0; i < len; ++i) {
+	*digest ^= p[i];
+	*digest *= FNV1A_64_PRIME;
+    }
+}
+
+
+/*
+ * digest_start_object - JSON event callback for {
+ *
+ * given:
+ *	data	pointer to the event digest
+ *
+ * returns:
+ *	true
+ */
+static bool
+digest_start_object(void *data)
+{
+    digest_bytes(data, "{", 1);
+    return true;
+}
+
+
+/*
+ * digest_end_object - JSON event callback for }
+ *
+ * given:
+ *	data	pointer to the event digest
+ *
+ * returns:
+ *	true
+ */
+static bool
+digest_end_object(void *data)
+{
+    digest_bytes(data, "}", 1);
+    return true;
+}
+
+
+/*
+ * digest_start_array - JSON event callback for [
+ *
+ * given:
+ *	data	pointer to the event digest
+ *
+ * returns:
+ *	true
+ */
+static bool
+digest_start_array(void *data)
+{
+    digest_bytes(data, "[", 1);
+    return true;
+}
+
+
+/*
+ * digest_end_array - JSON event callback for ]
+ *
+ * given:
+ *	data	pointer to the event digest
+ *
+ * returns:
+ *	true
+ */
+static bool
+digest_end_array(void *data)
+{
+    digest_bytes(data, "]", 1);
+    return true;
+}
+
+
+/*
+ * digest_member_name - JSON event callback for the name of a JSON member
+ *
+ * given:
+ *	data	pointer to the event digest
+ *	name	decoded name of the JSON member
+ *	len	length of name
+ *
+ * returns:
+ *	true
+ */
+static bool
+digest_member_name(void *data, char const *name, size_t len)
+{
+    digest_bytes(data, ":", 1);
+    digest_bytes(data, &len, sizeof(len));
+    digest_bytes(data, name, len);
+    return true;
+}
+
+
+/*
+ * digest_value - JSON event callback for a JSON string, number, boolean or null
+ *
+ * given:
+ *	data	pointer to the event digest
+ *	type	type of the JSON value
+ *	str	decoded JSON string or the JSON text of the value
+ *	len	length of str
+ *
+ * returns:
+ *	true
+ */
+static bool
+digest_value(void *data, enum item_type type, char const *str, size_t len)
+{
+    digest_bytes(data, &type, sizeof(type));
+    digest_bytes(data, &len, sizeof(len));
+    digest_bytes(data, str, len);
+    return true;
+}
+
+
+/*
+ * vdigest_node - add a JSON parse tree node to a JSON parse tree digest
+ *
+ * This is a callback for json_tree_walk().
+ *
+ * given:
+ *	node	pointer to a JSON parse tree node
+ *	depth	depth of the node in the JSON parse tree
+ *	ap	variable argument list, the first of which is a uint64_t * digest
+ */
+static void
+vdigest_node(struct json *node, unsigned int depth, va_list ap)
+{
+    va_list ap2;		/* copy of the variable argument list */
+    uint64_t *digest = NULL;	/* JSON parse tree digest */
+
+    /*
+     * firewall
+     */
+    if (node == NULL) {
+	return;
+    }
+
+    /*
+     * obtain the digest
+     */
+    va_copy(ap2, ap);
+    digest = va_arg(ap2, uint64_t *);
+    va_end(ap2);
+    if (digest == NULL) {
+	return;
+    }
+
+    /*
+     * add the node
+     */
+    digest_bytes(digest, &depth, sizeof(depth));
+    digest_bytes(digest, &node->type, sizeof(node->type));
+    switch (node->type) {
+    case JTYPE_NUMBER:
+	digest_bytes(digest, &node->item.number.as_str_len, sizeof(node->item.number.as_str_len));
+	digest_bytes(digest, node->item.number.as_str, node->item.number.as_str_len);
+	break;
+    case JTYPE_STRING:
+	digest_bytes(digest, &node->item.string.str_len, sizeof(node->item.string.str_len));
+	digest_bytes(digest, node->item.string.str, node->item.string.str_len);
+	break;
+    case JTYPE_BOOL:
+	digest_bytes(digest, &node->item.boolean.value, sizeof(node->item.boolean.value));
+	break;
+    case JTYPE_OBJECT:
+	digest_bytes(digest, &node->item.object.len, sizeof(node->item.object.len));
+	break;
+    case JTYPE_ARRAY:
+	digest_bytes(digest, &node->item.array.len, sizeof(node->item.array.len));
+	break;
+    default:
+	break;
+    }
+}
+
+
+/*
+ * tree_digest - form the digest of a JSON parse tree
+ *
+ * given:
+ *	tree	pointer to a JSON parse tree
+ *
+ * returns:
+ *	digest of the JSON parse tree
+ */
+static uint64_t
+tree_digest(struct json *tree)
+{
+    uint64_t digest = FNV1A_64_BASIS;	/* JSON parse tree digest */
+
+    json_tree_walk(tree, JSON_INFINITE_DEPTH, 0, false, vdigest_node, &digest);
+    return digest;
+}
+
+
+/*
+ * parse_doc - parse a JSON document in one of the ways the JSON parser can
+ *
+ * given:
+ *	doc	JSON document to parse
+ *	mode	way to parse the JSON document
+ *	chunk	length of the chunks given to a JSON push parser
+ *	digest	where to store the event digest or JSON parse tree digest
+ *
+ * returns:
+ *	true ==> JSON is valid, false ==> JSON is not valid
+ *
+ * NOTE: This function does not return on error.
+ */
+static bool
+parse_doc(struct jparse_thread_doc const *doc, enum jparse_thread_mode mode, size_t chunk, uint64_t *digest)
+{
+    struct jparse_push *push = NULL;	/* JSON push parser */
+    struct json *tree = NULL;		/* JSON parse tree */
+    bool valid = false;			/* true ==> JSON is valid */
+    size_t len;				/* length of the next chunk */
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (doc == NULL || digest == NULL || chunk == 0) {
+	err(22, __func__, "called with NULL arg(s) or zero chunk");
+	not_reached();
+    }
+
+    /*
+     * parse the JSON document
+     */
+    *digest = FNV1A_64_BASIS;
+    switch (mode) {
+    case JPARSE_THREAD_EVENTS:
+	valid = parse_json_events(doc->data, doc->len, doc->filename, &digest_cb, digest);
+	break;
+    case JPARSE_THREAD_PUSH_EVENTS:
+    case JPARSE_THREAD_PUSH_TREE:
+	push = jparse_push_create(doc->filename, mode == JPARSE_THREAD_PUSH_EVENTS ? &digest_cb : NULL, digest);
+	for (i = 0; i < doc->len; i += len) {
+	    len = doc->len - i < chunk ? doc->len - i : chunk;
+	    if (!jparse_push_feed(push, doc->data + i, len)) {
+		break;
+	    }
+	}
+	tree = jparse_push_finish(push, &valid);
+	push = NULL;
+	break;
+    case JPARSE_THREAD_TREE:
+	tree = parse_json(doc->data, doc->len, doc->filename, &valid);
+	break;
+    case JPARSE_THREAD_ARENA:
+	tree = parse_json_arena(doc->data, doc->len, doc->filename, &valid);
+	break;
+    case JPARSE_THREAD_ZERO_COPY:
+	tree = parse_json_zero_copy(doc->data, doc->len, doc->filename, &valid);
+	break;
+    default:
+	err(23, __func__, "unknown mode: %d", (int)mode);
+	not_reached();
+	break;
+    }
+
+    /*
+     * form the JSON parse tree digest and free the JSON parse tree
+     */
+    if (tree != NULL) {
+	if (valid) {
+	    *digest = tree_digest(tree);
+	}
+	json_tree_free(tree, JSON_INFINITE_DEPTH);
+	free(tree);
+	tree = NULL;
+    }
+    return valid;
+}
+
+
+/*
+ * jparse_thread - parse every JSON document, round after round
+ *
+ * Each JSON document is parsed in a way that changes with the thread, the
+ * round and the JSON document, so that at any moment the threads are parsing
+ * in different ways.  Only valid JSON is parsed into a JSON parse tree.
+ *
+ * given:
+ *	arg	pointer to the struct jparse_thread of this thread
+ *
+ * returns:
+ *	NULL
+ */
+static void *
+jparse_thread(void *arg)
+{
+    struct jparse_thread *thread = arg;	/* this thread */
+    struct jparse_thread_doc const *doc = NULL;	/* JSON document being parsed */
+    enum jparse_thread_mode mode;	/* way to parse the JSON document */
+    uint64_t digest = 0;		/* event digest or JSON parse tree digest */
+    uint64_t want = 0;			/* digest found by the main thread */
+    bool valid = false;			/* true ==> JSON is valid */
+    int round;
+    int i;
+
+    /*
+     * firewall
+     */
+    if (thread == NULL || thread->doc == NULL) {
+	err(24, __func__, "called with NULL arg");
+	not_reached();
+    }
+
+    for (round = 0; round < thread->rounds; ++round) {
+	for (i = 0; i < thread->doc_count; ++i) {
+	    doc = &thread->doc[i];
+
+	    /*
+	     * pick the way to parse the JSON document
+	     */
+	    if (doc->valid) {
+		mode = (enum jparse_thread_mode)((thread->id + round + i) % JPARSE_THREAD_MODES);
+	    } else {
+		mode = (enum jparse_thread_mode)((thread->id + round + i) % JPARSE_THREAD_EVENT_MODES);
+	    }
+	    want = mode < JPARSE_THREAD_EVENT_MODES ? doc->event_digest : doc->tree_digest;
+
+	    /*
+	     * parse and compare with the main thread
+	     */
+	    valid = parse_doc(doc, mode, 1 + (size_t)((thread->id + i) % 17), &digest);
+	    ++thread->parses;
+	    if (valid != doc->valid || (valid && digest != want)) {
+		++thread->mismatches;
+		dbg(DBG_LOW, "thread %d round %d mode %d: %s: mismatch", thread->id, round, (int)mode, doc->filename);
+	    }
+	}
+    }
+    return NULL;
+}
+
+
+/*
+ * usage - print usage to stderr
+ *
+ * Example:
+ *      usage(3, program, "wrong number of arguments");
+ *
+ * given:
+ *	exitcode        value to exit with
+ *	prog		our program name
+ *	str		top level usage message
+ *
+ * NOTE: We warn with extra newlines to help internal fault messages stand out.
+ *       Normally one should NOT include newlines in warn messages.
+ *
+ * This function does not return.
+ */
+static void
+usage(int exitcode, char const *prog, char const *str)
+{
+    /*
+     * firewall
+     */
+    if (prog == NULL) {
+	prog = JPARSE_THREAD_TEST_BASENAME;
+	fwarn(stderr, __func__, "\nin usage(): program was NULL, forcing it to be: %s\n", prog);
+    }
+    if (str == NULL) {
+	str = "((NULL str))";
+	fwarn(stderr, __func__, "\nin usage(): program was NULL, forcing it to be: %s\n", str);
+    }
+
+    /*
+     * print the formatted usage stream
+     */
+    if (*str != '\0') {
+	fprintf_usage(DO_NOT_EXIT, stderr, "%s\n", str);
+    }
+    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, JSON_DBG_DEFAULT, JPARSE_THREAD_TEST_THREADS,
+	    JPARSE_THREAD_TEST_ROUNDS, JPARSE_THREAD_TEST_BASENAME, JPARSE_THREAD_TEST_VERSION, JPARSE_UTILS_VERSION,
+	    JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION);
+    exit(exitcode); /*ooo*/
+    not_reached();
+}
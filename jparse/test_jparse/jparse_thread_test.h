@@ -0,0 +1,173 @@
+/*
+ * jparse_thread_test - parse JSON documents from many threads at once
+ *
+ * Every JSON document given on the command line is parsed, over and over, by
+ * a number of threads at the same time, using each of the ways the JSON
+ * parser can parse a document.  Each parse must come up with the same result
+ * as a parse of the same document by the main thread alone.
+ *
+ * "Because two threads should not know what the other one is parsing." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+#if !defined(INCLUDE_JPARSE_THREAD_TEST_H)
+#    define  INCLUDE_JPARSE_THREAD_TEST_H
+
+
+#include <stdint.h>
+#include <pthread.h>
+
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+#include "../../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+#include "../dbg/dbg.h"
+#else
+#include <dbg.h>
+#endif
+
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "../util.h"
+
+/*
+ * json_parse - JSON parser support code
+ */
+#include "../json_parse.h"
+
+/*
+ * json_util - general JSON parser utility support functions
+ */
+#include "../json_util.h"
+
+/*
+ * jparse - JSON parser
+ */
+#include "../jparse.h"
+
+/*
+ * version - JSON parser API and tool version
+ */
+#include "../version.h"
+
+/*
+ * json_utf8.h - JSON UTF-8 decoder
+ */
+#include "../json_utf8.h"
+
+/*
+ * json_push - incremental (push) JSON parser
+ */
+#include "../json_push.h"
+
+/*
+ * official jparse_thread_test version
+ */
+#define JPARSE_THREAD_TEST_VERSION "1.0.0 2026-10-19"	/* format: major.minor YYYY-MM-DD */
+
+/*
+ * jparse_thread_test tool basename
+ */
+#define JPARSE_THREAD_TEST_BASENAME "jparse_thread_test"
+
+/*
+ * definitions
+ */
+#define JPARSE_THREAD_TEST_THREADS (8)	/* default number of threads */
+#define JPARSE_THREAD_TEST_ROUNDS (4)	/* default number of times each thread parses every JSON document */
+#define JPARSE_THREAD_TEST_MAX_THREADS (1024)	/* maximum number of threads */
+
+
+/*
+ * ways a JSON document is parsed
+ */
+enum jparse_thread_mode {
+    JPARSE_THREAD_EVENTS = 0,	/* parse_json_events() */
+    JPARSE_THREAD_PUSH_EVENTS,	/* jparse_push_create() with JSON event callbacks */
+    JPARSE_THREAD_TREE,		/* parse_json() */
+    JPARSE_THREAD_ARENA,	/* parse_json_arena() */
+    JPARSE_THREAD_ZERO_COPY,	/* parse_json_zero_copy() */
+    JPARSE_THREAD_PUSH_TREE,	/* jparse_push_create() forming a JSON parse tree */
+};
+#define JPARSE_THREAD_MODES (6)		/* number of ways a JSON document is parsed */
+#define JPARSE_THREAD_EVENT_MODES (2)	/* number of ways that do not form a JSON parse tree */
+
+
+/*
+ * struct jparse_thread_doc - a JSON document to parse, and what parsing it must find
+ */
+struct jparse_thread_doc
+{
+    char const *filename;	/* name of the JSON document */
+    char *data;			/* contents of the JSON document */
+    size_t len;			/* length of data */
+    bool valid;			/* true ==> JSON is valid */
+    uint64_t event_digest;	/* digest of the JSON events of the JSON document */
+    uint64_t tree_digest;	/* digest of the JSON parse tree, if valid */
+    bool tree_mismatch;		/* true ==> JSON events are valid but the JSON parse tree is not */
+};
+
+/*
+ * struct jparse_thread - a thread that parses every JSON document
+ */
+struct jparse_thread
+{
+    pthread_t thread;		/* the thread */
+    int id;			/* thread number, from 0 */
+    int rounds;			/* number of times to parse every JSON document */
+    struct jparse_thread_doc const *doc;	/* JSON documents to parse */
+    int doc_count;		/* number of JSON documents */
+    uintmax_t parses;		/* number of parses done */
+    uintmax_t mismatches;	/* number of parses that did not match the main thread */
+};
+
+
+/*
+ * globals
+ *
+ */
+
+/*
+ * externals
+ */
+
+#endif /* INCLUDE_JPARSE_THREAD_TEST_H */
@@ -0,0 +1,905 @@
+/*
+ * json_lookup_test - test JSON Pointers and JSON member lookup
+ *
+ * A JSON document built into this tool is parsed, and JSON Pointers (RFC 6901)
+ * are resolved in its JSON parse tree: each pointer must compile (or not) and
+ * refer to the JSON value (or to no JSON value) that the test case says.
+ * JSON objects with fewer and more than JSON_OBJECT_INDEX_MIN members, with
+ * duplicate member names, are formed and their members looked up by name.
+ *
+ * "Because a pointer into JSON should not point into the blue." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+#include <stdio.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+
+#include "../util.h"
+#include "../jparse.h"
+
+/*
+ * json_lookup_test - test JSON Pointers and JSON member lookup
+ */
+#include "json_lookup_test.h"
+
+/*
+ * definitions
+ */
+#define REQUIRED_ARGS (0)	/* number of required arguments on the command line */
+#define LOOKUP_DESC_LEN (64)	/* size of a description of a JSON value */
+#define LOOKUP_NAME_LEN (32)	/* size of a JSON member name of an object test case */
+
+
+/*
+ * usage message
+ *
+ * Use the usage() function to print the usage_msg([0-9]?)+ strings.
+ */
+static const char * const usage_msg =
+    "usage: %s [-h] [-v level] [-J level] [-V] [-e]\n"
+    "\n"
+    "\t-h\t\tprint help message and exit\n"
+    "\t-v level\tset verbosity level (def level: %d)\n"
+    "\t-J level\tset JSON verbosity level (def level: %d)\n"
+    "\t-V\t\tprint version strings and exit\n"
+    "\t-e\t\tdo not silence the warnings about JSON Pointers that are not valid\n"
+    "\n"
+    "Exit codes:\n"
+    "\t0\t\tall tests are OK\n"
+    "\t1\t\tsome test failed\n"
+    "\t2\t\t-h and help string printed or -V and version strings printed\n"
+    "\t3\t\tcommand line error\n"
+    "\t>=10\t\tinternal error\n"
+    "\n"
+    "%s version: %s\n"
+    "jparse utils version: %s\n"
+    "jparse UTF-8 version: %s\n"
+    "jparse library version: %s";
+
+
+/*
+ * JSON document the test cases look up JSON values of
+ */
+static char const lookup_json[] =
+    "{\n"
+    "    \"a/b\" : \"slash\",\n"
+    "    \"m~n\" : \"tilde\",\n"
+    "    \"~1\" : \"escaped tilde one\",\n"
+    "    \"\" : \"empty name\",\n"
+    "    \" \" : \"space\",\n"
+    "    \"01\" : \"leading zero name\",\n"
+    "    \"arr\" : [ \"e0\", \"e1\", \"e2\", \"e3\", \"e4\", \"e5\", \"e6\", \"e7\", \"e8\", \"e9\", \"e10\" ],\n"
+    "    \"obj\" : { \"-\" : \"dash member\", \"0\" : \"zero member\", \"x\" : { \"y\" : \"deep\", \"n\" : 42 } },\n"
+    "    \"num\" : -1.5e3,\n"
+    "    \"nested\" : [ [ [ \"a00\" ], [ \"a10\", \"a11\" ] ], { \"k\" : [ \"k0\" ] } ]\n"
+    "}\n";
+
+/*
+ * JSON Pointer test cases
+ */
+static struct json_lookup_pointer const lookup_pointer[] = {
+    /* "" is the whole JSON document, "/" is the member with the empty name */
+    { "", true, "{10}" },
+    { "/", true, "empty name" },
+    { "/ ", true, "space" },
+
+    /* ~1 is / and ~0 is ~, and ~01 is ~1 (not /) as ~0 is decoded first */
+    { "/a~1b", true, "slash" },
+    { "/m~0n", true, "tilde" },
+    { "/~01", true, "escaped tilde one" },
+    { "/~10", true, NULL },
+    { "/a/b", true, NULL },
+
+    /* JSON array indexes */
+    { "/arr", true, "[11]" },
+    { "/arr/0", true, "e0" },
+    { "/arr/10", true, "e10" },
+    { "/arr/11", true, NULL },
+    { "/arr/99999999999999999999", true, NULL },
+    { "/arr/01", true, NULL },
+    { "/arr/00", true, NULL },
+    { "/arr/-", true, NULL },
+    { "/arr/-1", true, NULL },
+    { "/arr/+1", true, NULL },
+    { "/arr/1x", true, NULL },
+    { "/arr/x", true, NULL },
+    { "/arr/", true, NULL },
+    { "/arr/0/0", true, NULL },
+
+    /* a leading zero, - and digits are only member names in a JSON object */
+    { "/01", true, "leading zero name" },
+    { "/obj/-", true, "dash member" },
+    { "/obj/0", true, "zero member" },
+    { "/nested/1/0", true, NULL },
+
+    /* pointers that share leading tokens */
+    { "/obj", true, "{3}" },
+    { "/obj/x", true, "{2}" },
+    { "/obj/x/y", true, "deep" },
+    { "/obj/x/n", true, "42" },
+    { "/obj/x/y/z", true, NULL },
+    { "/num", true, "-1.5e3" },
+    { "/nested/0/1/1", true, "a11" },
+    { "/nested/0/1/0", true, "a10" },
+    { "/nested/0/0/0", true, "a00" },
+    { "/nested/1/k/0", true, "k0" },
+    { "/missing", true, NULL },
+    { "/missing/0", true, NULL },
+
+    /* not JSON Pointers: no leading /, or a ~ that is not ~0 or ~1 */
+    { "arr", false, NULL },
+    { "arr/0", false, NULL },
+    { "#/arr", false, NULL },
+    { "~0", false, NULL },
+    { "/~", false, NULL },
+    { "/~2", false, NULL },
+    { "/a~", false, NULL },
+    { "/arr~/0", false, NULL },
+};
+#define LOOKUP_POINTERS (sizeof(lookup_pointer) / sizeof(lookup_pointer[0]))	/* number of JSON Pointer test cases */
+
+/*
+ * JSON object test cases: number of distinct member names
+ *
+ * The JSON object of a test case has the members "m0" .. "m<n-1>" with the
+ * values 0 .. n-1 and, when n > 1, a second "m0" and "m<n-1>" with the value
+ * "dup", so that there are objects with fewer than, exactly and more than
+ * JSON_OBJECT_INDEX_MIN members.
+ */
+static int const lookup_object[] = {
+    1, 2, JSON_OBJECT_INDEX_MIN - 4, JSON_OBJECT_INDEX_MIN - 3, JSON_OBJECT_INDEX_MIN - 2,
+    JSON_OBJECT_INDEX_MIN - 1, JSON_OBJECT_INDEX_MIN, JSON_OBJECT_INDEX_MIN * 2, 1000
+};
+#define LOOKUP_OBJECTS (sizeof(lookup_object) / sizeof(lookup_object[0]))	/* number of JSON object test cases */
+
+/*
+ * static globals
+ */
+static bool silence = true;	/* true ==> silence warnings about JSON Pointers that are not valid */
+
+
+/*
+ * forward declarations
+ */
+static struct json_pointer *lookup_compile(char const *pointer, size_t len);
+static struct json *lookup_find(struct json *tree, char const *pointer);
+static char const *lookup_describe(struct json const *node, char *buf, size_t size);
+static uintmax_t test_pointer(struct json *tree);
+static uintmax_t test_pointer_get_all(struct json *tree);
+static struct json *lookup_first(struct json *node, char const *name, size_t len);
+static uintmax_t lookup_object_check(struct json *tree, int n, char const *how);
+static uintmax_t test_object(void);
+static void usage(int exitcode, char const *prog, char const *str) __attribute__((noreturn));
+
+
+int
+main(int argc, char *argv[])
+{
+    char const *program = NULL;	/* our name */
+    extern char *optarg;	/* option argument */
+    extern int optind;		/* argv index of the next arg */
+    int arg_count = 0;		/* number of args to process */
+    bool opt_error = false;	/* fchk_inval_opt() return */
+    struct json *tree = NULL;	/* JSON parse tree of lookup_json */
+    bool valid = false;		/* true ==> lookup_json is valid JSON */
+    uintmax_t failures = 0;	/* number of tests that failed */
+    int i;
+
+    /*
+     * use default locale based on LANG
+     */
+    (void) setlocale(LC_ALL, "");
+
+    /*
+     * firewall - paranoia
+     */
+    if (stdout == NULL) {
+	err(10, __func__, "stdout is NULL");
+	not_reached();
+    }
+    if (stderr == NULL) {
+	err(11, __func__, "stderr is NULL");
+	not_reached();
+    }
+
+    /*
+     * parse args
+     */
+    program = argv[0];
+    while ((i = getopt(argc, argv, ":hv:J:Ve")) != -1) {
+	switch (i) {
+	case 'h':		/* -h - print help to stderr and exit 0 */
+	    usage(2, program, ""); /*ooo*/
+	    not_reached();
+	    break;
+	case 'v':		/* -v verbosity */
+	    /*
+	     * parse verbosity
+	     */
+	    verbosity_level = parse_verbosity(optarg);
+	    if (verbosity_level < 0) {
+		usage(3, program, "invalid -v verbosity"); /*ooo*/
+		not_reached();
+	    }
+	    break;
+	case 'J':		/* -J json_verbosity */
+	    /*
+	     * parse JSON verbosity level
+	     */
+	    json_verbosity_level = parse_verbosity(optarg);
+	    if (json_verbosity_level < 0) {
+		usage(3, program, "invalid -J json_verbosity"); /*ooo*/
+		not_reached();
+	    }
+	    break;
+	case 'V':		/* -V - print version strings and exit */
+	    print("json_lookup_test version %s\n", JSON_LOOKUP_TEST_VERSION);
+	    print("jparse utils version: %s\n", JPARSE_UTILS_VERSION);
+	    print("jparse UTF-8 version: %s\n", JPARSE_UTF8_VERSION);
+	    print("jparse library version: %s\n", JPARSE_LIBRARY_VERSION);
+	    exit(2); /*ooo*/
+	    not_reached();
+	    break;
+	case 'e':		/* -e - do not silence warnings about JSON Pointers that are not valid */
+	    silence = false;
+	    break;
+	case ':':   /* option requires an argument */
+	case '?':   /* illegal option */
+	default:    /* anything else but should not actually happen */
+	    opt_error = fchk_inval_opt(stderr, program, i, optopt);
+	    if (opt_error) {
+		usage(3, program, ""); /*ooo*/
+		not_reached();
+	    } else {
+		fwarn(stderr, __func__, "getopt() return: %c optopt: %c", (char)i, (char)optopt);
+	    }
+	    break;
+	}
+    }
+    arg_count = argc - optind;
+    if (arg_count != REQUIRED_ARGS) {
+	usage(3, program, "wrong number of arguments"); /*ooo*/
+	not_reached();
+    }
+
+    /*
+     * parse the JSON document of the test cases
+     */
+    tree = parse_json(lookup_json, sizeof(lookup_json) - 1, JSON_LOOKUP_TEST_BASENAME, &valid);
+    if (tree == NULL || !valid) {
+	err(12, __func__, "JSON document of the test cases is not valid");
+	not_reached();
+    }
+
+    /*
+     * run the tests
+     */
+    failures += test_pointer(tree);
+    failures += test_pointer_get_all(tree);
+    failures += test_object();
+
+    /*
+     * free storage
+     */
+    json_tree_free(tree, JSON_INFINITE_DEPTH);
+    free(tree);
+    tree = NULL;
+
+    /*
+     * exit depending on failure count
+     */
+    if (failures > 0) {
+	fdbg(stderr, DBG_LOW, "%ju test(s) FAILED", failures);
+	exit(1); /*ooo*/
+    }
+    fdbg(stderr, DBG_LOW, "All tests PASSED");
+    exit(0); /*ooo*/
+}
+
+
+/*
+ * lookup_compile - compile a JSON Pointer of a test case
+ *
+ * json_pointer_compile() warns about a JSON Pointer that is not valid: unless
+ * -e, such a warning is silenced, but only while the pointer is compiled so
+ * that warnings about failed tests are never silenced.
+ *
+ * given:
+ *	pointer	JSON Pointer
+ *	len	length of pointer in bytes
+ *
+ * returns:
+ *	json_pointer_compile() return
+ */
+static struct json_pointer *
+lookup_compile(char const *pointer, size_t len)
+{
+    struct json_pointer *ptr = NULL;	/* compiled JSON Pointer */
+    bool output_allowed = warn_output_allowed;	/* warn_output_allowed before the compile */
+
+    if (silence) {
+	warn_output_allowed = false;
+    }
+    ptr = json_pointer_compile(pointer, len);
+    warn_output_allowed = output_allowed;
+    return ptr;
+}
+
+
+/*
+ * lookup_find - find the JSON value a JSON Pointer of a test case refers to
+ *
+ * json_pointer_find() compiles the JSON Pointer, so as with lookup_compile(),
+ * unless -e, a warning about a JSON Pointer that is not valid is silenced.
+ *
+ * given:
+ *	tree	JSON parse tree
+ *	pointer	JSON Pointer, NUL terminated
+ *
+ * returns:
+ *	json_pointer_find() return
+ */
+static struct json *
+lookup_find(struct json *tree, char const *pointer)
+{
+    struct json *node = NULL;	/* JSON value found */
+    bool output_allowed = warn_output_allowed;	/* warn_output_allowed before the find */
+
+    if (silence) {
+	warn_output_allowed = false;
+    }
+    node = json_pointer_find(tree, pointer);
+    warn_output_allowed = output_allowed;
+    return node;
+}
+
+
+/*
+ * lookup_describe - describe a JSON value as the test cases do
+ *
+ * given:
+ *	node	JSON value, NULL ==> no JSON value
+ *	buf	buffer for a description of a JSON object or array
+ *	size	size of buf
+ *
+ * returns:
+ *	the decoded JSON string, the JSON number as it was in the JSON document,
+ *	{len} for a JSON object, [len] for a JSON array, "(other)" for any other
+ *	JSON value, or NULL for no JSON value
+ */
+static char const *
+lookup_describe(struct json const *node, char *buf, size_t size)
+{
+    if (node == NULL) {
+	return NULL;
+    }
+    switch (node->type) {
+    case JTYPE_STRING:
+	return node->item.string.str;
+    case JTYPE_NUMBER:
+	return node->item.number.as_str;
+    case JTYPE_OBJECT:
+	(void) snprintf(buf, size, "{%jd}", node->item.object.len);
+	return buf;
+    case JTYPE_ARRAY:
+	(void) snprintf(buf, size, "[%jd]", node->item.array.len);
+	return buf;
+    default:
+	return "(other)";
+    }
+}
+
+
+/*
+ * test_pointer - test json_pointer_compile(), json_pointer_get() and json_pointer_find()
+ *
+ * Each JSON Pointer test case must compile (or not) as it says, and refer to
+ * the JSON value (or no JSON value) it says, both when compiled and through
+ * json_pointer_find().
+ *
+ * given:
+ *	tree	JSON parse tree of lookup_json
+ *
+ * returns:
+ *	number of test cases that failed
+ */
+static uintmax_t
+test_pointer(struct json *tree)
+{
+    char buf[LOOKUP_DESC_LEN];		/* description of a JSON object or array */
+    struct json_lookup_pointer const *c = NULL;	/* test case */
+    struct json_pointer *ptr = NULL;	/* compiled JSON Pointer */
+    struct json *node = NULL;		/* JSON value found */
+    char const *got = NULL;		/* description of the JSON value found */
+    uintmax_t failures = 0;		/* number of test cases that failed */
+    size_t i;
+
+    for (i = 0; i < LOOKUP_POINTERS; ++i) {
+	c = &lookup_pointer[i];
+
+	/*
+	 * the pointer must compile as the test case says
+	 */
+	ptr = lookup_compile(c->pointer, strlen(c->pointer));
+	if ((ptr != NULL) != c->valid) {
+	    fwarn(stderr, __func__, "JSON Pointer \"%s\": json_pointer_compile() %s", c->pointer,
+		  c->valid ? "failed" : "did not fail");
+	    ++failures;
+	    json_pointer_free(ptr);
+	    continue;
+	}
+
+	/*
+	 * the pointer must refer to the JSON value the test case says
+	 */
+	node = json_pointer_get(ptr, tree);
+	got = lookup_describe(node, buf, sizeof(buf));
+	if ((got == NULL) != (c->want == NULL) || (got != NULL && strcmp(got, c->want) != 0)) {
+	    fwarn(stderr, __func__, "JSON Pointer \"%s\": json_pointer_get() found %s, not %s", c->pointer,
+		  got != NULL ? got : "(no JSON value)", c->want != NULL ? c->want : "(no JSON value)");
+	    ++failures;
+	} else {
+	    dbg(DBG_MED, "JSON Pointer \"%s\": found %s", c->pointer, got != NULL ? got : "(no JSON value)");
+	}
+
+	/*
+	 * json_pointer_find() must find the same JSON value
+	 */
+	if (lookup_find(tree, c->pointer) != node) {
+	    fwarn(stderr, __func__, "JSON Pointer \"%s\": json_pointer_find() did not find what json_pointer_get() found",
+		  c->pointer);
+	    ++failures;
+	}
+	json_pointer_free(ptr);
+	ptr = NULL;
+    }
+
+    /*
+     * a JSON Pointer need not be NUL terminated: only len bytes are compiled
+     */
+    ptr = lookup_compile("/arr/10", strlen("/arr/1"));
+    got = lookup_describe(json_pointer_get(ptr, tree), buf, sizeof(buf));
+    if (got == NULL || strcmp(got, "e1") != 0) {
+	fwarn(stderr, __func__, "first 6 bytes of JSON Pointer \"/arr/10\": found %s, not e1",
+	      got != NULL ? got : "(no JSON value)");
+	++failures;
+    }
+    json_pointer_free(ptr);
+    ptr = NULL;
+
+    dbg(DBG_LOW, "%zu JSON Pointer test cases, %ju failed", LOOKUP_POINTERS, failures);
+    return failures;
+}
+
+
+/*
+ * test_pointer_get_all - test json_pointer_get_all()
+ *
+ * json_pointer_get_all() must find, for the valid JSON Pointers of the test
+ * cases, the same JSON values that json_pointer_get() finds for each of them,
+ * as they are (sorted by the test cases so that pointers sharing leading
+ * tokens are mostly next to each other), in reverse order, and with each
+ * pointer twice.
+ *
+ * given:
+ *	tree	JSON parse tree of lookup_json
+ *
+ * returns:
+ *	number of tests that failed
+ */
+static uintmax_t
+test_pointer_get_all(struct json *tree)
+{
+    struct json_pointer **ptrs = NULL;	/* compiled JSON Pointers, in the order of the set */
+    struct json **found = NULL;		/* JSON values json_pointer_get_all() found */
+    struct json *node = NULL;		/* JSON value json_pointer_get() found */
+    size_t count = 0;			/* number of valid JSON Pointers */
+    size_t want = 0;			/* number of JSON Pointers that refer to a JSON value */
+    size_t got = 0;			/* json_pointer_get_all() return */
+    uintmax_t failures = 0;		/* number of tests that failed */
+    int order;				/* 0 ==> test case order, 1 ==> reverse order, 2 ==> twice */
+    size_t set;				/* number of JSON Pointers in the set */
+    size_t i;
+
+    /*
+     * compile the valid JSON Pointers of the test cases
+     */
+    errno = 0;			/* pre-clear errno for errp() */
+    ptrs = calloc(LOOKUP_POINTERS * 2, sizeof(ptrs[0]));
+    found = calloc(LOOKUP_POINTERS * 2, sizeof(found[0]));
+    if (ptrs == NULL || found == NULL) {
+	errp(13, __func__, "calloc of %zu JSON Pointers failed", LOOKUP_POINTERS * 2);
+	not_reached();
+    }
+    for (i = 0; i < LOOKUP_POINTERS; ++i) {
+	if (lookup_pointer[i].valid) {
+	    ptrs[count] = lookup_compile(lookup_pointer[i].pointer, strlen(lookup_pointer[i].pointer));
+	    if (ptrs[count] == NULL) {
+		err(14, __func__, "JSON Pointer \"%s\" did not compile", lookup_pointer[i].pointer);
+		not_reached();
+	    }
+	    ++count;
+	}
+    }
+
+    /*
+     * resolve the set of JSON Pointers in each order
+     */
+    for (order = 0; order < 3; ++order) {
+	set = count;
+	if (order == 1) {
+	    for (i = 0; i < count / 2; ++i) {
+		struct json_pointer *tmp = ptrs[i];
+		ptrs[i] = ptrs[count - 1 - i];
+		ptrs[count - 1 - i] = tmp;
+	    }
+	} else if (order == 2) {
+	    for (i = 0; i < count; ++i) {
+		ptrs[count + i] = ptrs[i];
+	    }
+	    set = count * 2;
+	}
+	memset(found, 0, LOOKUP_POINTERS * 2 * sizeof(found[0]));
+	got = json_pointer_get_all((struct json_pointer const * const *)ptrs, set, tree, found);
+	want = 0;
+	for (i = 0; i < set; ++i) {
+	    node = json_pointer_get(ptrs[i], tree);
+	    if (node != NULL) {
+		++want;
+	    }
+	    if (found[i] != node) {
+		fwarn(stderr, __func__, "order %d: JSON Pointer %zu: json_pointer_get_all() did not find what "
+					"json_pointer_get() found", order, i);
+		++failures;
+	    }
+	}
+	if (got != want) {
+	    fwarn(stderr, __func__, "order %d: json_pointer_get_all() returned %zu, not %zu", order, got, want);
+	    ++failures;
+	}
+	dbg(DBG_MED, "order %d: json_pointer_get_all() found %zu of %zu JSON Pointers", order, got, set);
+    }
+
+    /*
+     * free storage
+     */
+    for (i = 0; i < count; ++i) {
+	json_pointer_free(ptrs[i]);
+	ptrs[i] = NULL;
+    }
+    free(ptrs);
+    free(found);
+
+    dbg(DBG_LOW, "json_pointer_get_all() tests, %ju failed", failures);
+    return failures;
+}
+
+
+/*
+ * lookup_first - find the first JSON member of a JSON object with a name
+ *
+ * Compare the name of every member in order, as json_object_get() must find
+ * the same member with or without an index.
+ *
+ * given:
+ *	node	JSON node of a JSON object
+ *	name	decoded JSON member name (need not be NUL terminated)
+ *	len	length of name in bytes
+ *
+ * returns:
+ *	JSON node of the first JTYPE_MEMBER with the name, NULL ==> no such member
+ */
+static struct json *
+lookup_first(struct json *node, char const *name, size_t len)
+{
+    struct json_member *member = NULL;	/* member being compared */
+    intmax_t i;
+
+    for (i = 0; i < node->item.object.len; ++i) {
+	member = &(node->item.object.set[i]->item.member);
+	if (member->name_str_len == len && memcmp(member->name_str, name, len) == 0) {
+	    return node->item.object.set[i];
+	}
+    }
+    return NULL;
+}
+
+
+/*
+ * lookup_object_check - look up every member name of a JSON object test case
+ *
+ * Each name must be found by json_object_get() as the first member with the
+ * name (not a later duplicate), names that are not in the object must not be
+ * found, and the index of the object must be built only for an object with at
+ * least JSON_OBJECT_INDEX_MIN members.
+ *
+ * given:
+ *	tree	JSON parse tree of the JSON object test case
+ *	n	number of distinct member names
+ *	how	how the JSON object was parsed or indexed, for warnings
+ *
+ * returns:
+ *	number of tests that failed
+ */
+static uintmax_t
+lookup_object_check(struct json *tree, int n, char const *how)
+{
+    char name[LOOKUP_NAME_LEN];		/* member name */
+    char want[LOOKUP_NAME_LEN];		/* JSON number of the member */
+    char buf[LOOKUP_DESC_LEN];		/* description of a JSON object or array */
+    static char const * const missing[] = { "m", "M0", "m0 ", " m0", "", "m00", "m-1" };	/* names not in any object */
+    struct json *member = NULL;		/* JSON member found */
+    char const *got = NULL;		/* description of the value of the member found */
+    bool indexed = false;		/* true ==> object had an index before the lookups */
+    uintmax_t failures = 0;		/* number of tests that failed */
+    size_t j;
+    int i;
+
+    indexed = tree->item.object.index != NULL;
+    for (i = 0; i < n; ++i) {
+
+	/*
+	 * the name must be found as the first member with the name
+	 */
+	(void) snprintf(name, sizeof(name), "m%d", i);
+	(void) snprintf(want, sizeof(want), "%d", i);
+	member = json_object_get(tree, name, strlen(name));
+	got = member == NULL ? NULL : lookup_describe(member->item.member.value, buf, sizeof(buf));
+	if (member == NULL || member != lookup_first(tree, name, strlen(name)) || got == NULL || strcmp(got, want) != 0) {
+	    fwarn(stderr, __func__, "%s object of %d names: \"%s\": json_object_get() found %s, not %s", how, n, name,
+		  got != NULL ? got : "(no JSON member)", want);
+	    ++failures;
+	}
+    }
+
+    /*
+     * names that are not in the object must not be found
+     */
+    (void) snprintf(name, sizeof(name), "m%d", n);
+    if (json_object_get(tree, name, strlen(name)) != NULL) {
+	fwarn(stderr, __func__, "%s object of %d names: found missing name \"%s\"", how, n, name);
+	++failures;
+    }
+    for (j = 0; j < sizeof(missing) / sizeof(missing[0]); ++j) {
+	if (json_object_get(tree, missing[j], strlen(missing[j])) != NULL) {
+	    fwarn(stderr, __func__, "%s object of %d names: found missing name \"%s\"", how, n, missing[j]);
+	    ++failures;
+	}
+    }
+    if (json_object_get(tree, "m0\0", 3) != NULL) {
+	fwarn(stderr, __func__, "%s object of %d names: found missing name \"m0\\0\"", how, n);
+	++failures;
+    }
+
+    /*
+     * a name need not be NUL terminated: only len bytes are compared
+     */
+    if (json_object_get(tree, "m0x", 2) != lookup_first(tree, "m0", 2)) {
+	fwarn(stderr, __func__, "%s object of %d names: first 2 bytes of \"m0x\" did not find \"m0\"", how, n);
+	++failures;
+    }
+
+    /*
+     * only an object with at least JSON_OBJECT_INDEX_MIN members is indexed by a lookup
+     */
+    if (!indexed && (tree->item.object.index != NULL) != (tree->item.object.len >= JSON_OBJECT_INDEX_MIN)) {
+	fwarn(stderr, __func__, "%s object of %jd members: json_object_get() %s an index", how, tree->item.object.len,
+	      tree->item.object.index != NULL ? "built" : "did not build");
+	++failures;
+    }
+    return failures;
+}
+
+
+/*
+ * test_object - test json_object_get() and json_object_index()
+ *
+ * For each JSON object test case, parsed both with parse_json() and with
+ * parse_json_arena(), every name is looked up with json_object_get(), then
+ * the object is indexed with json_object_index() and every name is looked up
+ * again.  The index must count the distinct names and the duplicates, and
+ * json_free() must free the index of a calloc()ed object.
+ *
+ * NOTE: Build with -fsanitize=address to find an index that is not freed, or
+ *	 one (from the arena) that is freed with free(3).
+ *
+ * returns:
+ *	number of tests that failed
+ */
+static uintmax_t
+test_object(void)
+{
+    struct json_object_index *index = NULL;	/* index of the JSON object */
+    struct json *tree = NULL;		/* JSON parse tree of the JSON object test case */
+    char *doc = NULL;			/* JSON document of the JSON object test case */
+    size_t size = 0;			/* size of doc */
+    size_t len = 0;			/* length of doc */
+    intmax_t dups = 0;			/* number of duplicate member names */
+    bool valid = false;			/* true ==> doc is valid JSON */
+    uintmax_t failures = 0;		/* number of tests that failed */
+    int arena;				/* 0 ==> parse_json(), 1 ==> parse_json_arena() */
+    size_t c;
+    int i;
+
+    for (c = 0; c < LOOKUP_OBJECTS; ++c) {
+
+	/*
+	 * form the JSON document of the test case
+	 */
+	size = (size_t)lookup_object[c] * LOOKUP_NAME_LEN + 2 * LOOKUP_NAME_LEN;
+	errno = 0;		/* pre-clear errno for errp() */
+	doc = calloc(size, 1);
+	if (doc == NULL) {
+	    errp(15, __func__, "calloc of %zu byte JSON document failed", size);
+	    not_reached();
+	}
+	len = 0;
+	for (i = 0; i < lookup_object[c]; ++i) {
+	    len += (size_t)snprintf(doc + len, size - len, "%s\"m%d\":%d", i == 0 ? "{" : ",", i, i);
+	}
+	if (lookup_object[c] > 1) {
+	    len += (size_t)snprintf(doc + len, size - len, ",\"m0\":\"dup\",\"m%d\":\"dup\"", lookup_object[c] - 1);
+	    dups = 2;
+	} else {
+	    dups = 0;
+	}
+	len += (size_t)snprintf(doc + len, size - len, "}");
+
+	for (arena = 0; arena < 2; ++arena) {
+
+	    /*
+	     * parse the JSON object
+	     */
+	    if (arena) {
+		tree = parse_json_arena(doc, len, JSON_LOOKUP_TEST_BASENAME, &valid);
+	    } else {
+		tree = parse_json(doc, len, JSON_LOOKUP_TEST_BASENAME, &valid);
+	    }
+	    if (tree == NULL || !valid || tree->type != JTYPE_OBJECT ||
+		tree->item.object.len != lookup_object[c] + dups) {
+		err(16, __func__, "JSON object of %d names is not valid", lookup_object[c]);
+		not_reached();
+	    }
+
+	    /*
+	     * look up the names, with an index built as needed
+	     */
+	    failures += lookup_object_check(tree, lookup_object[c], arena ? "arena" : "calloc");
+
+	    /*
+	     * index the object and look up the names again
+	     */
+	    index = json_object_index(tree);
+	    if (index == NULL || index != tree->item.object.index || index != json_object_index(tree)) {
+		fwarn(stderr, __func__, "object of %d names: json_object_index() did not return the index of the object",
+		      lookup_object[c]);
+		++failures;
+	    } else if (index->count != (size_t)lookup_object[c] || index->dups != dups ||
+		       index->size < index->count * 2 || (index->size & (index->size - 1)) != 0) {
+		fwarn(stderr, __func__, "object of %d names: index of %zu slots has %zu names and %jd duplicates, "
+					"not %d names and %jd duplicates", lookup_object[c], index->size, index->count,
+					index->dups, lookup_object[c], dups);
+		++failures;
+	    }
+	    failures += lookup_object_check(tree, lookup_object[c], arena ? "indexed arena" : "indexed calloc");
+
+	    /*
+	     * free the JSON parse tree
+	     *
+	     * json_free() must free the index of the calloc()ed object, and
+	     * json_tree_free() must free the arena that the index of the arena
+	     * allocated object is in.
+	     */
+	    if (!arena) {
+		json_free(tree, 0);
+		if (tree->item.object.index != NULL) {
+		    fwarn(stderr, __func__, "object of %d names: json_free() kept the index", lookup_object[c]);
+		    ++failures;
+		}
+	    }
+	    json_tree_free(tree, JSON_INFINITE_DEPTH);
+	    free(tree);
+	    tree = NULL;
+	}
+	free(doc);
+	doc = NULL;
+    }
+
+    /*
+     * not a JSON object
+     */
+    if (json_object_index(NULL) != NULL || json_object_get(NULL, "m0", 2) != NULL) {
+	fwarn(stderr, __func__, "json_object_index() or json_object_get() of NULL did not return NULL");
+	++failures;
+    }
+
+    dbg(DBG_LOW, "%zu JSON object test cases, %ju failed", LOOKUP_OBJECTS, failures);
+    return failures;
+}
+
+
+/*
+ * usage - print usage to stderr
+ *
+ * Example:
+ *      usage(3, program, "wrong number of arguments");
+ *
+ * given:
+ *	exitcode        value to exit with
+ *	prog		our program name
+ *	str		top level usage message
+ *
+ * NOTE: We warn with extra newlines to help internal fault messages stand out.
+ *       Normally one should NOT include newlines in warn messages.
+ *
+ * This function does not return.
+ */
+static void
+usage(int exitcode, char const *prog, char const *str)
+{
+    /*
+     * firewall
+     */
+    if (prog == NULL) {
+	prog = JSON_LOOKUP_TEST_BASENAME;
+	fwarn(stderr, __func__, "\nin usage(): program was NULL, forcing it to be: %s\n", prog);
+    }
+    if (str == NULL) {
+	str = "((NULL str))";
+	fwarn(stderr, __func__, "\nin usage(): program was NULL, forcing it to be: %s\n", str);
+    }
+
+    /*
+     * print the formatted usage stream
+     */
+    if (*str != '\0') {
+	fprintf_usage(DO_NOT_EXIT, stderr, "%s\n", str);
+    }
+    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, JSON_DBG_DEFAULT, JSON_LOOKUP_TEST_BASENAME,
+		  JSON_LOOKUP_TEST_VERSION, JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION);
+    exit(exitcode); /*ooo*/
+    not_reached();
+}
@@ -0,0 +1,134 @@
+/*
+ * json_lookup_test - test JSON Pointers and JSON member lookup
+ *
+ * A JSON document built into this tool is parsed, and JSON Pointers (RFC 6901)
+ * are resolved in its JSON parse tree: each pointer must compile (or not) and
+ * refer to the JSON value (or to no JSON value) that the test case says.
+ * JSON objects with fewer and more than JSON_OBJECT_INDEX_MIN members, with
+ * duplicate member names, are formed and their members looked up by name.
+ *
+ * "Because a pointer into JSON should not point into the blue." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE OR JSON.
+ *
+ * This JSON parser, library and tools were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+#if !defined(INCLUDE_JSON_LOOKUP_TEST_H)
+#    define  INCLUDE_JSON_LOOKUP_TEST_H
+
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#if defined(INTERNAL_INCLUDE)
+#include "../../dbg/dbg.h"
+#elif defined(INTERNAL_INCLUDE_2)
+#include "../dbg/dbg.h"
+#else
+#include <dbg.h>
+#endif
+
+
+/*
+ * util - common utility functions for the JSON parser
+ */
+#include "../util.h"
+
+/*
+ * json_parse - JSON parser support code
+ */
+#include "../json_parse.h"
+
+/*
+ * json_util - general JSON parser utility support functions
+ */
+#include "../json_util.h"
+
+/*
+ * jparse - JSON parser
+ */
+#include "../jparse.h"
+
+/*
+ * version - JSON parser API and tool version
+ */
+#include "../version.h"
+
+/*
+ * json_utf8.h - JSON UTF-8 decoder
+ */
+#include "../json_utf8.h"
+
+/*
+ * json_pointer - RFC 6901 JSON Pointer resolution of a JSON parse tree
+ */
+#include "../json_pointer.h"
+
+/*
+ * official json_lookup_test version
+ */
+#define JSON_LOOKUP_TEST_VERSION "1.0.0 2026-10-19"	/* format: major.minor YYYY-MM-DD */
+
+/*
+ * json_lookup_test tool basename
+ */
+#define JSON_LOOKUP_TEST_BASENAME "json_lookup_test"
+
+
+/*
+ * struct json_lookup_pointer - a JSON Pointer test case
+ *
+ * The JSON value a pointer refers to is described as by lookup_describe(): the
+ * decoded JSON string, the JSON number as it was in the JSON document, or a
+ * JSON object or array as {len} or [len].
+ */
+struct json_lookup_pointer
+{
+    char const *pointer;	/* JSON Pointer, NUL terminated */
+    bool valid;			/* true ==> pointer must compile */
+    char const *want;		/* description of the JSON value found, NULL ==> no JSON value */
+};
+
+
+/*
+ * globals
+ *
+ */
+
+/*
+ * externals
+ */
+
+#endif /* INCLUDE_JSON_LOOKUP_TEST_H */
@@ -431,6 +431,42 @@ else
     EXIT_CODE=4
 fi
 
+echo "$0: about to run test #14" 1>&2
+echo "printf '%s' '\"caf\\u00e9 \\ud83d\\ude00 \\\"x\\\"\"' | $JSTRDECODE -S 1 -n"
+EXPECTED='café 😀 "x"'
+RESULT="$(printf '%s' '"caf\u00e9 \ud83d\ude00 \"x\""' | $JSTRDECODE -S 1 -n)"
+if [[ "$RESULT" = "$EXPECTED" ]]; then
+    echo "$0: test #14 passed" 1>&2
+else
+    echo "$0: test #14 failed" 1>&2
+    echo "$0: test #14 EXPECTED: $EXPECTED"  1>&2
+    echo "$0: test #14 RESULT: $RESULT" 1>&2
+    EXIT_CODE=4
+fi
+
+echo "$0: about to run test #15" 1>&2
+echo "printf '%s' '\"b\"' | $JSTRDECODE -S 3 -Q -e -n '\"a\"' - '\"c\"'"
+EXPECTED='"\"a\"\"b\"\"c\""'
+RESULT="$(printf '%s' '"b"' | $JSTRDECODE -S 3 -Q -e -n '"a"' - '"c"')"
+if [[ "$RESULT" = "$EXPECTED" ]]; then
+    echo "$0: test #15 passed" 1>&2
+else
+    echo "$0: test #15 failed" 1>&2
+    echo "$0: test #15 EXPECTED: $EXPECTED"  1>&2
+    echo "$0: test #15 RESULT: $RESULT" 1>&2
+    EXIT_CODE=4
+fi
+
+echo "$0: about to run test #16" 1>&2
+echo "$JSTRENCODE -S 1 -n < $JSTRENCODE | $JSTRDECODE -S 7 -n > $TEST_FILE"
+"$JSTRENCODE" -S 1 -n < "$JSTRENCODE" | "$JSTRDECODE" -S 7 -n > "$TEST_FILE"
+if cmp -s "$JSTRENCODE" "$TEST_FILE"; then
+    echo "$0: test #16 passed" 1>&2
+else
+    echo "$0: test #16 failed" 1>&2
+    EXIT_CODE=4
+fi
+
 # All Done!!! All Done!!! -- Jessica Noll, Age 2
 #
 if [[ $EXIT_CODE == 0 ]]; then
@@ -39,8 +39,8 @@
 
 # setup
 #
-export RUN_JPARSE_TESTS_VERSION="2.0.1 2025-09-01"
-export USAGE="usage: $0 [-h] [-V] [-v level] [-D dbg_level] [-J json_level] [-j jparse] [-p pr_jparse_test] [-c jnum_chk] [-Z topdir]
+export RUN_JPARSE_TESTS_VERSION="2.0.4 2026-10-19"
+export USAGE="usage: $0 [-h] [-V] [-v level] [-D dbg_level] [-J json_level] [-j jparse] [-p pr_jparse_test] [-c jnum_chk] [-t jparse_thread_test] [-k json_lookup_test] [-l jval] [-Z topdir]
 
     -h			print help and exit
     -V			print version and exit
@@ -50,6 +50,9 @@ export USAGE="usage: $0 [-h] [-V] [-v level] [-D dbg_level] [-J json_level] [-j
     -j jparse		path to jparse
     -p pr_jparse_test	path to pr_jparse_test
     -c jnum_chk		path to jnum_chk
+    -t jparse_thread_test	path to jparse_thread_test
+    -k json_lookup_test	path to json_lookup_test
+    -l jval		path to jval (def: $JVAL)
     -Z topdir		top level build directory (def: try . or ..)
 
 Exit codes:
@@ -72,11 +75,14 @@ export TOPDIR=
 export JPARSE="./jparse"
 export PR_JPARSE_TEST="./test_jparse/pr_jparse_test"
 export JNUM_CHK="./test_jparse/jnum_chk"
+export JPARSE_THREAD_TEST="./test_jparse/jparse_thread_test"
+export JSON_LOOKUP_TEST="./test_jparse/json_lookup_test"
+export JVAL="./jval"
 
 
 # parse args
 #
-while getopts :hVv:D:J:j:p:c:Z: flag; do
+while getopts :hVv:D:J:j:p:c:t:k:l:Z: flag; do
     case "$flag" in
     h)	echo "$USAGE" 1>&2
 	exit 2
@@ -91,6 +97,12 @@ while getopts :hVv:D:J:j:p:c:Z: flag; do
 	;;
     c)	JNUM_CHK="$OPTARG";
 	;;
+    t)	JPARSE_THREAD_TEST="$OPTARG";
+	;;
+    k)	JSON_LOOKUP_TEST="$OPTARG";
+	;;
+    l)	JVAL="$OPTARG";
+	;;
     J)	J_FLAG="$OPTARG";
 	;;
     V)	echo "$RUN_JPARSE_TESTS_VERSION"
@@ -222,6 +234,22 @@ elif [[ ! -x "$JPARSE" ]]; then
     EXIT_CODE="5"
 fi
 
+# jval
+#
+if [[ -z "$JVAL" ]]; then
+    echo "$0: ERROR: \$JVAL empty, try a non-empty string for -l option" | tee -a -- "${LOGFILE}"
+    EXIT_CODE="5"
+elif [[ ! -e "$JVAL" ]]; then
+    echo "$0: ERROR: $JVAL file not found" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+elif [[ ! -f "$JVAL" ]]; then
+    echo "$0: ERROR: $JVAL is not a regular file" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+elif [[ ! -x "$JVAL" ]]; then
+    echo "$0: ERROR: $JVAL is not executable" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+fi
+
 # pr_jparse_test
 #
 if [[ -z "$PR_JPARSE_TEST" ]]; then
@@ -238,6 +266,38 @@ elif [[ ! -x "$PR_JPARSE_TEST" ]]; then
     EXIT_CODE="5"
 fi
 
+# jparse_thread_test
+#
+if [[ -z "$JPARSE_THREAD_TEST" ]]; then
+    echo "$0: ERROR: \$JPARSE_THREAD_TEST empty, try a non-empty string for -t option" | tee -a -- "${LOGFILE}"
+    EXIT_CODE="5"
+elif [[ ! -e "$JPARSE_THREAD_TEST" ]]; then
+    echo "$0: ERROR: $JPARSE_THREAD_TEST file not found" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+elif [[ ! -f "$JPARSE_THREAD_TEST" ]]; then
+    echo "$0: ERROR: $JPARSE_THREAD_TEST is not a regular file" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+elif [[ ! -x "$JPARSE_THREAD_TEST" ]]; then
+    echo "$0: ERROR: $JPARSE_THREAD_TEST is not executable" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+fi
+
+# json_lookup_test
+#
+if [[ -z "$JSON_LOOKUP_TEST" ]]; then
+    echo "$0: ERROR: \$JSON_LOOKUP_TEST empty, try a non-empty string for -k option" | tee -a -- "${LOGFILE}"
+    EXIT_CODE="5"
+elif [[ ! -e "$JSON_LOOKUP_TEST" ]]; then
+    echo "$0: ERROR: $JSON_LOOKUP_TEST file not found" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+elif [[ ! -f "$JSON_LOOKUP_TEST" ]]; then
+    echo "$0: ERROR: $JSON_LOOKUP_TEST is not a regular file" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+elif [[ ! -x "$JSON_LOOKUP_TEST" ]]; then
+    echo "$0: ERROR: $JSON_LOOKUP_TEST is not executable" | tee -a -- "$LOGFILE"
+    EXIT_CODE="5"
+fi
+
 # jnum_chk
 #
 if [[ -z "$JNUM_CHK" ]]; then
@@ -330,8 +390,8 @@ echo | tee -a -- "$LOGFILE"
 
 # test_jparse/jparse_test.sh
 #
-echo "RUNNING: ./test_jparse/jparse_test.sh -D ${D_FLAG} -v ${V_FLAG} -j $JPARSE -p $PR_JPARSE_TEST -d test_jparse/test_JSON -s . test_jparse/json_teststr.txt" | tee -a -- "${LOGFILE}"
-./test_jparse/jparse_test.sh -D "${V_FLAG}" -v "${V_FLAG}" -j "$JPARSE" -p "$PR_JPARSE_TEST" -d test_jparse/test_JSON \
+echo "RUNNING: ./test_jparse/jparse_test.sh -D ${D_FLAG} -v ${V_FLAG} -j $JPARSE -p $PR_JPARSE_TEST -l $JVAL -d test_jparse/test_JSON -s . test_jparse/json_teststr.txt" | tee -a -- "${LOGFILE}"
+./test_jparse/jparse_test.sh -D "${V_FLAG}" -v "${V_FLAG}" -j "$JPARSE" -p "$PR_JPARSE_TEST" -l "$JVAL" -d test_jparse/test_JSON \
     -s . test_jparse/json_teststr.txt | tee -a -- "${LOGFILE}"
 status="${PIPESTATUS[0]}"
 if [[ $status -ne 0 ]]; then
@@ -341,10 +401,10 @@ if [[ $status -ne 0 ]]; then
     EXIT_CODE="23"
     echo | tee -a -- "$LOGFILE"
     echo "EXIT_CODE set to: $EXIT_CODE" | tee -a -- "$LOGFILE"
-    echo "FAILED: ./jparse_test.sh -D $V_FLAG -v ${V_FLAG} -j $JPARSE -p $PR_JPARSE_TEST -d test_jparse/test_JSON -s . test_jparse/json_teststr.txt" \
+    echo "FAILED: ./jparse_test.sh -D $V_FLAG -v ${V_FLAG} -j $JPARSE -p $PR_JPARSE_TEST -l $JVAL -d test_jparse/test_JSON -s . test_jparse/json_teststr.txt" \
 	| tee -a -- "${LOGFILE}"
 else
-    echo "PASSED: ./jparse_test.sh -D $V_FLAG -v ${V_FLAG} -j $JPARSE -p $PR_JPARSE_TEST -d test_jparse/test_JSON -s . test_jparse/json_teststr.txt" | tee -a -- "${LOGFILE}"
+    echo "PASSED: ./jparse_test.sh -D $V_FLAG -v ${V_FLAG} -j $JPARSE -p $PR_JPARSE_TEST -l $JVAL -d test_jparse/test_JSON -s . test_jparse/json_teststr.txt" | tee -a -- "${LOGFILE}"
 fi
 
 echo | tee -a -- "${LOGFILE}"
@@ -419,6 +479,48 @@ else
 fi
 
 
+# jparse_thread_test
+#
+echo | tee -a -- "$LOGFILE"
+echo "RUNNING: $JPARSE_THREAD_TEST -v $V_FLAG -J $J_FLAG test_jparse/test_JSON/good/*.json test_jparse/test_JSON/bad/*.json" \
+    | tee -a -- "$LOGFILE"
+"$JPARSE_THREAD_TEST" -v "$V_FLAG" -J "$J_FLAG" test_jparse/test_JSON/good/*.json test_jparse/test_JSON/bad/*.json \
+    | tee -a -- "$LOGFILE"
+status="${PIPESTATUS[0]}"
+if [[ $status -ne 0 ]]; then
+    echo "$0: ERROR: $JPARSE_THREAD_TEST non-zero exit code: $status" 1>&2 | tee -a -- "$LOGFILE"
+    FAILURE_SUMMARY="$FAILURE_SUMMARY
+    $JPARSE_THREAD_TEST non-zero exit code: $status"
+    EXIT_CODE="28"
+    echo | tee -a -- "$LOGFILE"
+    echo "EXIT_CODE set to: $EXIT_CODE" | tee -a -- "$LOGFILE"
+    echo "FAILED: $JPARSE_THREAD_TEST -v $V_FLAG -J $J_FLAG test_jparse/test_JSON/good/*.json test_jparse/test_JSON/bad/*.json" \
+	| tee -a -- "$LOGFILE"
+else
+    echo "PASSED: $JPARSE_THREAD_TEST -v $V_FLAG -J $J_FLAG test_jparse/test_JSON/good/*.json test_jparse/test_JSON/bad/*.json" \
+	| tee -a -- "$LOGFILE"
+fi
+
+
+# json_lookup_test
+#
+echo | tee -a -- "$LOGFILE"
+echo "RUNNING: $JSON_LOOKUP_TEST -v $V_FLAG -J $J_FLAG" | tee -a -- "$LOGFILE"
+"$JSON_LOOKUP_TEST" -v "$V_FLAG" -J "$J_FLAG" | tee -a -- "$LOGFILE"
+status="${PIPESTATUS[0]}"
+if [[ $status -ne 0 ]]; then
+    echo "$0: ERROR: $JSON_LOOKUP_TEST non-zero exit code: $status" 1>&2 | tee -a -- "$LOGFILE"
+    FAILURE_SUMMARY="$FAILURE_SUMMARY
+    $JSON_LOOKUP_TEST non-zero exit code: $status"
+    EXIT_CODE="29"
+    echo | tee -a -- "$LOGFILE"
+    echo "EXIT_CODE set to: $EXIT_CODE" | tee -a -- "$LOGFILE"
+    echo "FAILED: $JSON_LOOKUP_TEST -v $V_FLAG -J $J_FLAG" | tee -a -- "$LOGFILE"
+else
+    echo "PASSED: $JSON_LOOKUP_TEST -v $V_FLAG -J $J_FLAG" | tee -a -- "$LOGFILE"
+fi
+
+
 # report overall status
 #
 if [[ $EXIT_CODE -ne 0 ]]; then
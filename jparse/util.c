@@ -992,3 +992,137 @@ find_text_str(char const *str, char **first)
      */
     return ret;
 }
+
+
+/*
+ * tmp_file_open - create a temporary file to be renamed over a file
+ *
+ * A file that another process may be reading, or have mapped with mmap(2),
+ * is not written again in place: it is written to a temporary file created
+ * with mkstemp(3) in the same directory, which tmp_file_close() then renames
+ * over the file, so that a reader sees either all of the old file or all of
+ * the new one.
+ *
+ * given:
+ *	name	    name of the file to write
+ *	tmpname	    pointer to set to the malloced name of the temporary file
+ *
+ * returns:
+ *	temporary file open for writing, NULL ==> it could not be created
+ *
+ * NOTE: This function does not return on NULL arg or malloc error.
+ */
+FILE *
+tmp_file_open(char const *name, char **tmpname)
+{
+    char *tmp = NULL;		/* name of the temporary file */
+    size_t size = 0;		/* size of tmp */
+    FILE *stream = NULL;	/* open temporary file */
+    int fd = -1;		/* mkstemp() return */
+
+    /*
+     * firewall
+     */
+    if (name == NULL || tmpname == NULL) {
+	err(10, __func__, "name and/or tmpname is NULL");
+	not_reached();
+    }
+    *tmpname = NULL;
+
+    /*
+     * create the temporary file beside the file
+     */
+    size = strlen(name) + sizeof(".XXXXXX");
+    errno = 0;			/* pre-clear errno for errp() */
+    tmp = malloc(size);
+    if (tmp == NULL) {
+	errp(11, __func__, "malloc of %zu bytes failed", size);
+	not_reached();
+    }
+    (void) snprintf(tmp, size, "%s.XXXXXX", name);
+    errno = 0;			/* pre-clear errno for warnp() */
+    fd = mkstemp(tmp);
+    if (fd < 0) {
+	warnp(__func__, "cannot create temporary file for: %s", name);
+	free(tmp);
+	return NULL;
+    }
+
+    /*
+     * mkstemp() creates a file only its owner can read: make it readable as
+     * fopen(3) with the usual umask of 022 would
+     */
+    (void) fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    errno = 0;			/* pre-clear errno for warnp() */
+    stream = fdopen(fd, "w");
+    if (stream == NULL) {
+	warnp(__func__, "cannot fdopen temporary file: %s", tmp);
+	(void) close(fd);
+	(void) unlink(tmp);
+	free(tmp);
+	return NULL;
+    }
+    *tmpname = tmp;
+    return stream;
+}
+
+
+/*
+ * tmp_file_close - close a temporary file and rename it over a file
+ *
+ * If the temporary file was written in full, it is flushed and synced to
+ * storage before it is renamed over the file, so that the file is never
+ * replaced by a partial file.  Otherwise, or if any of that fails, the
+ * temporary file is removed and the file is left as it was.
+ *
+ * given:
+ *	stream	    temporary file opened by tmp_file_open()
+ *	tmpname	    malloced name of the temporary file, freed by this function
+ *	name	    name of the file to rename the temporary file over
+ *	ok	    true ==> the temporary file was written in full
+ *
+ * returns:
+ *	true ==> the temporary file replaced the file,
+ *	false ==> the temporary file was removed
+ *
+ * NOTE: This function does not return on NULL arg.
+ */
+bool
+tmp_file_close(FILE *stream, char *tmpname, char const *name, bool ok)
+{
+    /*
+     * firewall
+     */
+    if (stream == NULL || tmpname == NULL || name == NULL) {
+	err(12, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    /*
+     * flush, sync and close the temporary file
+     */
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (ok && (fflush(stream) != 0 || fsync(fileno(stream)) != 0)) {
+	warnp(__func__, "cannot flush temporary file: %s", tmpname);
+	ok = false;
+    }
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (fclose(stream) != 0 && ok) {
+	warnp(__func__, "cannot close temporary file: %s", tmpname);
+	ok = false;
+    }
+
+    /*
+     * rename the temporary file over the file, or remove it
+     */
+    errno = 0;			/* pre-clear errno for warnp() */
+    if (ok && rename(tmpname, name) != 0) {
+	warnp(__func__, "cannot rename %s to: %s", tmpname, name);
+	ok = false;
+    }
+    if (!ok) {
+	(void) unlink(tmpname);
+    }
+    free(tmpname);
+    return ok;
+}
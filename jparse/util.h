@@ -190,4 +190,8 @@ extern size_t count_char(char const *str, int ch);
 extern size_t find_text(char const *ptr, size_t len, char **first);
 extern size_t find_text_str(char const *str, char **first);
 
+/* write a file that may be read at the same time */
+extern FILE *tmp_file_open(char const *name, char **tmpname);
+extern bool tmp_file_close(FILE *stream, char *tmpname, char const *name, bool ok);
+
 #endif				/* INCLUDE_JPARSE_UTIL_H */
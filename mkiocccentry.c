@@ -7320,6 +7320,8 @@ form_tarball(char const *workdir, char const *submission_dir, char const *tarbal
     struct stat buf;		/* stat of the tarball */
     int cwd = -1;		/* current working directory */
     int ret;			/* libc function return */
+    char *xz_opt = NULL;	/* malloced copy of XZ_OPT before we change it, or NULL */
+    char *new_xz_opt = NULL;	/* XZ_OPT with the xz block size */
 
     /*
      * firewall
@@ -7377,8 +7379,54 @@ form_tarball(char const *workdir, char const *submission_dir, char const *tarbal
     basename_tarball_path = base_name(tarball_path);
     dbg(DBG_HIGH, "about to perform: %s --format=v7 -cJf %s -- %s",
 		   tar, basename_tarball_path, basename_submission_dir);
+    /*
+     * have xz(1), via XZ_OPT, form a multi-block xz stream
+     *
+     * The xz block index allows txzchk -B and txzchk -X to locate and
+     * decompress only the xz blocks that hold a given file of the tarball.
+     * Any XZ_OPT the user has already set is kept ahead of our block size.
+     */
+    if (getenv("XZ_OPT") != NULL) {
+	errno = 0;		/* pre-clear errno for errp() */
+	xz_opt = strdup(getenv("XZ_OPT"));
+	if (xz_opt == NULL) {
+	    errp(250, __func__, "strdup of XZ_OPT failed");
+	    not_reached();
+	}
+    }
+    errno = 0;			/* pre-clear errno for errp() */
+    new_xz_opt = calloc(1, (xz_opt == NULL ? 0 : strlen(xz_opt) + 1) + sizeof("--block-size=") + sizeof(int)*3 + 1);
+    if (new_xz_opt == NULL) {
+	errp(251, __func__, "calloc of XZ_OPT failed");
+	not_reached();
+    }
+    sprintf(new_xz_opt, "%s%s--block-size=%d", xz_opt == NULL ? "" : xz_opt, xz_opt == NULL ? "" : " ",
+			XZ_TARBALL_BLOCK_SIZE);
+    errno = 0;			/* pre-clear errno for errp() */
+    if (setenv("XZ_OPT", new_xz_opt, 1) != 0) {
+	errp(252, __func__, "setenv XZ_OPT=%s failed", new_xz_opt);
+	not_reached();
+    }
+    dbg(DBG_HIGH, "XZ_OPT=%s", new_xz_opt);
     exit_code = shell_cmd(__func__, false, true, "tar --format=v7 -cJf % -- %",
 				    basename_tarball_path, basename_submission_dir);
+
+    /*
+     * restore XZ_OPT for the other tools we run
+     */
+    if (xz_opt != NULL) {
+	errno = 0;		/* pre-clear errno for errp() */
+	if (setenv("XZ_OPT", xz_opt, 1) != 0) {
+	    errp(253, __func__, "setenv XZ_OPT=%s failed", xz_opt);
+	    not_reached();
+	}
+	free(xz_opt);
+	xz_opt = NULL;
+    } else {
+	(void) unsetenv("XZ_OPT");
+    }
+    free(new_xz_opt);
+    new_xz_opt = NULL;
     if (exit_code != 0) {
 	err(41, __func__, "%s --format=v7 -cJf %s -- %s failed with exit code: %d",
 			   tar, basename_tarball_path, basename_submission_dir, WEXITSTATUS(exit_code));
@@ -146,6 +146,11 @@
  */
 #include "soup/walk.h"
 
+/*
+ * xz_index - for the xz block size of the compressed tarball
+ */
+#include "soup/xz_index.h"
+
 
 /*
  * definitions
@@ -27,7 +27,7 @@
 export V_FLAG="0"
 export JSEMTBLGEN="../jparse/jsemtblgen"
 export JSEMCGEN_SH="../jparse/jsemcgen.sh"
-export ALL_SEM_REF_VERSION="1.2.1 2023-03-14"
+export ALL_SEM_REF_VERSION="1.2.2 2026-10-19"
 
 export USAGE="usage: $0 [-h] [-v level] [-V] [-j jsemtblgen] [-J jsemcgen.sh] info.head.c info.tail.c info.head.h
 	info.tail.h auth.head.c auth.tail.c auth.head.h auth.tail.h info_dir auth_dir ref_dir
@@ -351,7 +351,7 @@ find "$INFO_DIR" -type f -name '*.json' -print 2>/dev/null | while read -r path;
     if [[ $V_FLAG -ge 5 ]]; then
 	echo "$0: debug[5]: about to execute: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_info -P chk -- $path . . . $TMP_FILE" 1>&2
     fi
-    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -N sem_info -P chk -- "$path" . . . "$TMP_FILE"
+    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -C -N sem_info -P chk -- "$path" . . . "$TMP_FILE"
     status="$?"
     if [[ $status -ne 0 ]]; then
 	echo "$0: ERROR: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_info -P chk -- $path . . . $TMP_FILE  exit code: $status" 1>&2
@@ -391,7 +391,7 @@ find "$INFO_DIR" -type f -name '*.json' -print 2>/dev/null | while read -r path;
     if [[ $V_FLAG -ge 5 ]]; then
 	echo "$0: debug[5]: about to execute: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_info -P chk -I -- $path . . . $TMP_FILE" 1>&2
     fi
-    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -N sem_info -P chk -I -- "$path" . . . "$TMP_FILE"
+    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -C -N sem_info -P chk -I -- "$path" . . . "$TMP_FILE"
     status="$?"
     if [[ $status -ne 0 ]]; then
 	echo "$0: ERROR: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_info -P chk -I -- $path . . . $TMP_FILE  exit code: $status" 1>&2
@@ -431,7 +431,7 @@ find "$AUTH_DIR" -type f -name '*.json' -print 2>/dev/null | while read -r path;
     if [[ $V_FLAG -ge 5 ]]; then
 	echo "$0: debug[5]: about to execute: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_auth -P chk -- $path . . . $TMP_FILE" 1>&2
     fi
-    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -N sem_auth -P chk -- "$path" . . . "$TMP_FILE"
+    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -C -N sem_auth -P chk -- "$path" . . . "$TMP_FILE"
     status="$?"
     if [[ $status -ne 0 ]]; then
 	echo "$0: ERROR: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_auth -P chk -- $path . . . $TMP_FILE  exit code: $status" 1>&2
@@ -471,7 +471,7 @@ find "$AUTH_DIR" -type f -name '*.json' -print 2>/dev/null | while read -r path;
     if [[ $V_FLAG -ge 5 ]]; then
 	echo "$0: debug[5]: about to execute: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_auth -P chk -I -- $path . . . $TMP_FILE" 1>&2
     fi
-    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -N sem_auth -P chk -I -- "$path" . . . "$TMP_FILE"
+    "$JSEMCGEN_SH" -j "$JSEMTBLGEN" -C -N sem_auth -P chk -I -- "$path" . . . "$TMP_FILE"
     status="$?"
     if [[ $status -ne 0 ]]; then
 	echo "$0: ERROR: $JSEMCGEN_SH -j $JSEMTBLGEN -N sem_auth -P chk -I -- $path . . . $TMP_FILE  exit code: $status" 1>&2
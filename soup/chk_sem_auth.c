@@ -80,3 +80,280 @@ struct json_sem sem_auth[SEM_AUTH_LEN+1] = {
   { 0,	JTYPE_OBJECT,	1,	1,	1,	38,	0,	NULL,	NULL,	NULL },
   { 0,	JTYPE_UNSET,	0,	0,	0,	-1,	0,	NULL,	NULL,	NULL }
 };
+
+
+/*
+ * sem_auth_find - find the first match of a JSON node in sem_auth[]
+ *
+ * This function was generated by jsemtblgen -C: it returns what json_sem_find()
+ * returns for sem_auth[], without searching the table.
+ *
+ * given:
+ *	node		pointer to a JSON parse tree
+ *	depth		depth of node in the JSON parse tree (0 ==> tree root)
+ *	sem		pointer to sem_auth[]
+ *
+ * returns:
+ *	>=0 ==> index into sem_auth[] for first match
+ *	-1  ==> no sem_auth[] match found
+ *	< -1 ==> invalid JSON node, or NULL ptr
+ */
+int
+sem_auth_find(struct json *node, unsigned int depth, struct json_sem *sem)
+{
+    char *name = NULL;		/* name of JTYPE_MEMBER node or NULL */
+
+    /*
+     * firewall - args
+     */
+    if (node == NULL) {
+	warn(__func__, "node is NULL");
+	return -2;
+    }
+    if (sem == NULL) {
+	warn(__func__, "sem is NULL");
+	return -3;
+    }
+
+    /*
+     * obtain information about the JSON node
+     */
+    if (node->type == JTYPE_MEMBER) {
+	name = sem_member_name_decoded_str(node, depth, sem, __func__, NULL);
+    } else if (sem_node_valid(node, depth, sem, __func__, NULL) == false) {
+	warn(__func__, "JSON node is invalid");
+	return -4;
+    }
+
+    /*
+     * match depth, type and, for JTYPE_MEMBER, name
+     */
+    switch (depth) {
+    case 5:
+	switch (node->type) {
+	case JTYPE_NUMBER:
+	    return 0;
+	case JTYPE_STRING:
+	    return 1;
+	case JTYPE_BOOL:
+	    return 2;
+	case JTYPE_NULL:
+	    return 3;
+	default:
+	    break;
+	}
+	break;
+    case 4:
+	switch (node->type) {
+	case JTYPE_MEMBER:
+	    if (name == NULL) {
+		return 4;
+	    }
+	    switch (json_object_hash(name, strlen(name)) % 48) {
+	    case 2:
+		if (strcmp(name, "github") == 0) {
+		    return 10;
+		}
+		break;
+	    case 4:
+		if (strcmp(name, "past_winning_author") == 0) {
+		    return 14;
+		}
+		break;
+	    case 10:
+		if (strcmp(name, "alt_url") == 0) {
+		    return 5;
+		}
+		break;
+	    case 14:
+		if (strcmp(name, "url") == 0) {
+		    return 15;
+		}
+		break;
+	    case 26:
+		if (strcmp(name, "author_number") == 0) {
+		    return 7;
+		}
+		break;
+	    case 34:
+		if (strcmp(name, "location_code") == 0) {
+		    return 11;
+		}
+		break;
+	    case 37:
+		if (strcmp(name, "default_handle") == 0) {
+		    return 8;
+		}
+		break;
+	    case 38:
+		if (strcmp(name, "name") == 0) {
+		    return 13;
+		}
+		break;
+	    case 39:
+		if (strcmp(name, "email") == 0) {
+		    return 9;
+		}
+		break;
+	    case 41:
+		if (strcmp(name, "affiliation") == 0) {
+		    return 4;
+		}
+		break;
+	    case 42:
+		if (strcmp(name, "mastodon") == 0) {
+		    return 12;
+		}
+		break;
+	    case 45:
+		if (strcmp(name, "author_handle") == 0) {
+		    return 6;
+		}
+		break;
+	    default:
+		break;
+	    }
+	    return -1;
+	default:
+	    break;
+	}
+	break;
+    case 3:
+	switch (node->type) {
+	case JTYPE_OBJECT:
+	    return 16;
+	default:
+	    break;
+	}
+	break;
+    case 2:
+	switch (node->type) {
+	case JTYPE_NUMBER:
+	    return 17;
+	case JTYPE_STRING:
+	    return 18;
+	case JTYPE_BOOL:
+	    return 19;
+	case JTYPE_ARRAY:
+	    return 20;
+	default:
+	    break;
+	}
+	break;
+    case 1:
+	switch (node->type) {
+	case JTYPE_MEMBER:
+	    if (name == NULL) {
+		return 21;
+	    }
+	    switch (json_object_hash(name, strlen(name)) % 65) {
+	    case 4:
+		if (strcmp(name, "authors") == 0) {
+		    return 26;
+		}
+		break;
+	    case 8:
+		if (strcmp(name, "IOCCC_auth_version") == 0) {
+		    return 21;
+		}
+		break;
+	    case 14:
+		if (strcmp(name, "chksubmit_version") == 0) {
+		    return 27;
+		}
+		break;
+	    case 15:
+		if (strcmp(name, "formed_timestamp_usec") == 0) {
+		    return 30;
+		}
+		break;
+	    case 16:
+		if (strcmp(name, "IOCCC_contest") == 0) {
+		    return 22;
+		}
+		break;
+	    case 17:
+		if (strcmp(name, "min_timestamp") == 0) {
+		    return 31;
+		}
+		break;
+	    case 26:
+		if (strcmp(name, "author_count") == 0) {
+		    return 25;
+		}
+		break;
+	    case 27:
+		if (strcmp(name, "IOCCC_contest_id") == 0) {
+		    return 23;
+		}
+		break;
+	    case 29:
+		if (strcmp(name, "fnamchk_version") == 0) {
+		    return 28;
+		}
+		break;
+	    case 31:
+		if (strcmp(name, "test_mode") == 0) {
+		    return 36;
+		}
+		break;
+	    case 36:
+		if (strcmp(name, "formed_timestamp") == 0) {
+		    return 29;
+		}
+		break;
+	    case 40:
+		if (strcmp(name, "no_comment") == 0) {
+		    return 33;
+		}
+		break;
+	    case 51:
+		if (strcmp(name, "timestamp_epoch") == 0) {
+		    return 37;
+		}
+		break;
+	    case 53:
+		if (strcmp(name, "tarball") == 0) {
+		    return 35;
+		}
+		break;
+	    case 57:
+		if (strcmp(name, "IOCCC_year") == 0) {
+		    return 24;
+		}
+		break;
+	    case 58:
+		if (strcmp(name, "submit_slot") == 0) {
+		    return 34;
+		}
+		break;
+	    case 61:
+		if (strcmp(name, "mkiocccentry_version") == 0) {
+		    return 32;
+		}
+		break;
+	    default:
+		break;
+	    }
+	    return -1;
+	default:
+	    break;
+	}
+	break;
+    case 0:
+	switch (node->type) {
+	case JTYPE_OBJECT:
+	    return 38;
+	default:
+	    break;
+	}
+	break;
+    default:
+	break;
+    }
+
+    /*
+     * no match for the JSON node
+     */
+    return -1;
+}
@@ -101,6 +101,8 @@ extern bool chk_test_mode(struct json const *node,
 extern bool chk_timestamp_epoch(struct json const *node,
 	unsigned int depth, struct json_sem *sem, struct json_sem_val_err **val_err);
 
+extern int sem_auth_find(struct json *node, unsigned int depth, struct json_sem *sem);
+
 #endif /* SEM_AUTH_LEN */
 
 
@@ -90,3 +90,339 @@ struct json_sem sem_info[SEM_INFO_LEN+1] = {
   { 0,	JTYPE_OBJECT,	1,	1,	1,	48,	0,	NULL,	NULL,	NULL },
   { 0,	JTYPE_UNSET,	0,	0,	0,	-1,	0,	NULL,	NULL,	NULL }
 };
+
+
+/*
+ * sem_info_find - find the first match of a JSON node in sem_info[]
+ *
+ * This function was generated by jsemtblgen -C: it returns what json_sem_find()
+ * returns for sem_info[], without searching the table.
+ *
+ * given:
+ *	node		pointer to a JSON parse tree
+ *	depth		depth of node in the JSON parse tree (0 ==> tree root)
+ *	sem		pointer to sem_info[]
+ *
+ * returns:
+ *	>=0 ==> index into sem_info[] for first match
+ *	-1  ==> no sem_info[] match found
+ *	< -1 ==> invalid JSON node, or NULL ptr
+ */
+int
+sem_info_find(struct json *node, unsigned int depth, struct json_sem *sem)
+{
+    char *name = NULL;		/* name of JTYPE_MEMBER node or NULL */
+
+    /*
+     * firewall - args
+     */
+    if (node == NULL) {
+	warn(__func__, "node is NULL");
+	return -2;
+    }
+    if (sem == NULL) {
+	warn(__func__, "sem is NULL");
+	return -3;
+    }
+
+    /*
+     * obtain information about the JSON node
+     */
+    if (node->type == JTYPE_MEMBER) {
+	name = sem_member_name_decoded_str(node, depth, sem, __func__, NULL);
+    } else if (sem_node_valid(node, depth, sem, __func__, NULL) == false) {
+	warn(__func__, "JSON node is invalid");
+	return -4;
+    }
+
+    /*
+     * match depth, type and, for JTYPE_MEMBER, name
+     */
+    switch (depth) {
+    case 5:
+	switch (node->type) {
+	case JTYPE_STRING:
+	    return 0;
+	default:
+	    break;
+	}
+	break;
+    case 4:
+	switch (node->type) {
+	case JTYPE_MEMBER:
+	    if (name == NULL) {
+		return 1;
+	    }
+	    switch (json_object_hash(name, strlen(name)) % 31) {
+	    case 1:
+		if (strcmp(name, "shell_script") == 0) {
+		    return 8;
+		}
+		break;
+	    case 7:
+		if (strcmp(name, "auth_JSON") == 0) {
+		    return 2;
+		}
+		break;
+	    case 9:
+		if (strcmp(name, "try_sh") == 0) {
+		    return 10;
+		}
+		break;
+	    case 10:
+		if (strcmp(name, "c_src") == 0) {
+		    return 4;
+		}
+		break;
+	    case 13:
+		if (strcmp(name, "extra_file") == 0) {
+		    return 5;
+		}
+		break;
+	    case 14:
+		if (strcmp(name, "Makefile") == 0) {
+		    return 1;
+		}
+		break;
+	    case 21:
+		if (strcmp(name, "c_alt_src") == 0) {
+		    return 3;
+		}
+		break;
+	    case 22:
+		if (strcmp(name, "info_JSON") == 0) {
+		    return 6;
+		}
+		break;
+	    case 29:
+		if (strcmp(name, "try_alt_sh") == 0) {
+		    return 9;
+		}
+		break;
+	    case 30:
+		if (strcmp(name, "remarks") == 0) {
+		    return 7;
+		}
+		break;
+	    default:
+		break;
+	    }
+	    return -1;
+	default:
+	    break;
+	}
+	break;
+    case 3:
+	switch (node->type) {
+	case JTYPE_OBJECT:
+	    return 11;
+	default:
+	    break;
+	}
+	break;
+    case 2:
+	switch (node->type) {
+	case JTYPE_NUMBER:
+	    return 12;
+	case JTYPE_STRING:
+	    return 13;
+	case JTYPE_BOOL:
+	    return 14;
+	case JTYPE_ARRAY:
+	    return 15;
+	default:
+	    break;
+	}
+	break;
+    case 1:
+	switch (node->type) {
+	case JTYPE_MEMBER:
+	    if (name == NULL) {
+		return 16;
+	    }
+	    switch (json_object_hash(name, strlen(name)) % 152) {
+	    case 3:
+		if (strcmp(name, "abstract") == 0) {
+		    return 21;
+		}
+		break;
+	    case 13:
+		if (strcmp(name, "rule_2b_override") == 0) {
+		    return 38;
+		}
+		break;
+	    case 26:
+		if (strcmp(name, "formed_timestamp_usec") == 0) {
+		    return 26;
+		}
+		break;
+	    case 28:
+		if (strcmp(name, "chksubmit_version") == 0) {
+		    return 22;
+		}
+		break;
+	    case 41:
+		if (strcmp(name, "tarball") == 0) {
+		    return 41;
+		}
+		break;
+	    case 49:
+		if (strcmp(name, "formed_timestamp") == 0) {
+		    return 25;
+		}
+		break;
+	    case 56:
+		if (strcmp(name, "txzchk_version") == 0) {
+		    return 46;
+		}
+		break;
+	    case 58:
+		if (strcmp(name, "Makefile_override") == 0) {
+		    return 20;
+		}
+		break;
+	    case 59:
+		if (strcmp(name, "mkiocccentry_version") == 0) {
+		    return 33;
+		}
+		break;
+	    case 64:
+		if (strcmp(name, "IOCCC_year") == 0) {
+		    return 19;
+		}
+		break;
+	    case 66:
+		if (strcmp(name, "found_clobber_rule") == 0) {
+		    return 29;
+		}
+		break;
+	    case 67:
+		if (strcmp(name, "rule_2a_size") == 0) {
+		    return 37;
+		}
+		break;
+	    case 68:
+		if (strcmp(name, "rule_2b_size") == 0) {
+		    return 39;
+		}
+		break;
+	    case 70:
+		if (strcmp(name, "fnamchk_version") == 0) {
+		    return 24;
+		}
+		break;
+	    case 73:
+		if (strcmp(name, "IOCCC_contest_id") == 0) {
+		    return 17;
+		}
+		break;
+	    case 74:
+		if (strcmp(name, "iocccsize_version") == 0) {
+		    return 30;
+		}
+		break;
+	    case 77:
+		if (strcmp(name, "test_mode") == 0) {
+		    return 42;
+		}
+		break;
+	    case 83:
+		if (strcmp(name, "empty_override") == 0) {
+		    return 23;
+		}
+		break;
+	    case 90:
+		if (strcmp(name, "found_all_rule") == 0) {
+		    return 27;
+		}
+		break;
+	    case 92:
+		if (strcmp(name, "ungetc_warning") == 0) {
+		    return 47;
+		}
+		break;
+	    case 100:
+		if (strcmp(name, "found_clean_rule") == 0) {
+		    return 28;
+		}
+		break;
+	    case 102:
+		if (strcmp(name, "IOCCC_info_version") == 0) {
+		    return 18;
+		}
+		break;
+	    case 106:
+		if (strcmp(name, "submit_slot") == 0) {
+		    return 40;
+		}
+		break;
+	    case 112:
+		if (strcmp(name, "no_comment") == 0) {
+		    return 34;
+		}
+		break;
+	    case 113:
+		if (strcmp(name, "timestamp_epoch") == 0) {
+		    return 43;
+		}
+		break;
+	    case 122:
+		if (strcmp(name, "rule_2a_override") == 0) {
+		    return 36;
+		}
+		break;
+	    case 128:
+		if (strcmp(name, "min_timestamp") == 0) {
+		    return 32;
+		}
+		break;
+	    case 129:
+		if (strcmp(name, "title") == 0) {
+		    return 44;
+		}
+		break;
+	    case 131:
+		if (strcmp(name, "IOCCC_contest") == 0) {
+		    return 16;
+		}
+		break;
+	    case 140:
+		if (strcmp(name, "manifest") == 0) {
+		    return 31;
+		}
+		break;
+	    case 149:
+		if (strcmp(name, "trigraph_warning") == 0) {
+		    return 45;
+		}
+		break;
+	    case 150:
+		if (strcmp(name, "rule_2a_mismatch") == 0) {
+		    return 35;
+		}
+		break;
+	    default:
+		break;
+	    }
+	    return -1;
+	default:
+	    break;
+	}
+	break;
+    case 0:
+	switch (node->type) {
+	case JTYPE_OBJECT:
+	    return 48;
+	default:
+	    break;
+	}
+	break;
+    default:
+	break;
+    }
+
+    /*
+     * no match for the JSON node
+     */
+    return -1;
+}
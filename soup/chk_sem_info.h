@@ -127,6 +127,8 @@ extern bool chk_txzchk_version(struct json const *node,
 extern bool chk_ungetc_warning(struct json const *node,
 	unsigned int depth, struct json_sem *sem, struct json_sem_val_err **val_err);
 
+extern int sem_info_find(struct json *node, unsigned int depth, struct json_sem *sem);
+
 #endif /* SEM_INFO_LEN */
 
 
@@ -0,0 +1,79 @@
+#!/usr/bin/env bash
+#
+# Copies of select limit_ioccc.h and version.h values for shell script use
+#
+export RUN_BISON_VERSION="2.0.0 2025-02-28"
+export MIN_BISON_VERSION="3.8.2"		# minimum bison version needed to build the JSON parser
+export RUN_FLEX_VERSION="2.0.0 2025-02-28"
+export MIN_FLEX_VERSION="2.6.4"		# minimum flex version needed to build the JSON parser
+export RULE_2A_SIZE="4993"
+export RULE_2B_SIZE="2503"
+export MAX_TARBALL_LEN="3999971"
+export MAX_SUM_FILELEN="27651*1024"
+export MAX_EXTRA_FILE_COUNT="31"
+export MAX_EXTRA_DIR_COUNT="13"
+export MAX_SUBMIT_SLOT="9"
+export MAX_SUBMIT_SLOT_CHARS="1"
+export MAX_AUTHORS="5"
+export MAX_AUTHORS_CHARS="1"
+export MAX_NAME_LEN="48"
+export MAX_EMAIL_LEN="48"
+export MAX_URL_LEN="64"
+export MAX_MASTODON_LEN="20+64"
+export MAX_GITHUB_LEN="16"
+export MAX_AFFILIATION_LEN="48"
+export MAX_TITLE_LEN="32"
+export MAX_ABSTRACT_LEN="64"
+export MAX_HANDLE="32"
+export UUID_LEN="36"
+export UUID_VERSION="4"
+export UUID_VARIANT_0="08"
+export UUID_VARIANT_1="09"
+export UUID_VARIANT_2="0"
+export UUID_VARIANT_3="0"
+export MAX_TIMESTAMP_LEN="48"
+export MAX_FILENAME_LEN="38"
+export MAX_PATH_DEPTH="4"
+export MAX_PATH_LEN="V7_TAR_LIMIT"
+export MIN_FORMED_TIMESTAMP_USEC="1"
+export MAX_FORMED_TIMESTAMP_USEC="999999"
+export MIN_TIMESTAMP="1762222634"
+export IOCCC_CONTEST="IOCCC29"
+export IOCCC_YEAR="2025"
+export IOCCC_STATUS_URL="://../."
+export IOCCC_ENTER_FAQ_URL="://../.#"
+export IOCCC_FIND_AUTHOR_HANDLE="://../.#__"
+export MKIOCCCENTRY_REPO_VERSION="2.11.8 2026-10-19"
+export SOUP_VERSION="2.4.4 2026-10-19"
+export IOCCCSIZE_VERSION="29.1.0 2025-11-18"
+export MIN_IOCCCSIZE_VERSION IOCCCSIZE_VERSION
+export MKIOCCCENTRY_VERSION="2.3.5 2026-06-17"
+export MIN_MKIOCCCENTRY_VERSION MKIOCCCENTRY_VERSION
+export MKIOCCCENTRY_ANSWERS_VERSION="MKIOCCCENTRY_ANSWERS_IOCCC29-1.0"
+export LOCATION_VERSION="2.0.0 2025-11-18"
+export INFO_VERSION="1.19 2025-11-03"
+export MIN_INFO_VERSION INFO_VERSION
+export AUTH_VERSION="1.24 2025-08-28"
+export MIN_AUTH_VERSION AUTH_VERSION
+export FNAMCHK_VERSION="2.2.0 2025-11-18"
+export MIN_FNAMCHK_VERSION FNAMCHK_VERSION
+export TXZCHK_VERSION="2.1.3 2026-10-19"
+export MIN_TXZCHK_VERSION TXZCHK_VERSION
+export CHKENTRY_VERSION="2.3.0 2025-11-30"
+export MIN_CHKENTRY_VERSION CHKENTRY_VERSION
+export CHKSUBMIT_VERSION="2.1.0 2025-11-30"
+export MIN_CHKSUBMIT_VERSION CHKSUBMIT_VERSION
+export ENTRY_VERSION="1.2 2024-09-25"
+export MIN_ENTRY_VERSION ENTRY_VERSION
+export AUTHOR_VERSION="1.1 2024-02-11"
+export MIN_AUTHOR_VERSION AUTHOR_VERSION
+export FILE_UTIL_TEST_VERSION="2.2.0 2025-11-18"
+export TRY_FTS_WALK_VERSION="2.0.0 2025-11-18"
+export TRY_WALK_SET_VERSION="2.0.0 2025-11-18"
+export TIMESTAMP_EPOCH="Thu Jan 01 00:00:00 1970 UTC"
+export JSON_PARSING_DIRECTIVE_NAME="no_comment"
+export JSON_PARSING_DIRECTIVE_VALUE="mandatory comment: because comments were removed from the original JSON spec"
+export DBG_VERSION="3.2.2 2026-10-19"
+export DYN_ARRAY_VERSION="2.5.3 2024-10-03"
+export DIGRAPHS=
+export TRIGRAPHS=
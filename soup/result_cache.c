@@ -0,0 +1,1249 @@
+/*
+ * result_cache - content addressed cache of tool verdicts and reports
+ *
+ * "Because asking the same question twice should not cost twice." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * This tool and the JSON parser were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <poll.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ * pr - stdio helper library
+ */
+#include "../dbg/dbg.h"
+#include "../pr/pr.h"
+
+/*
+ * file_util - common utility functions for file operations
+ */
+#include "file_util.h"
+
+/*
+ * result_cache - content addressed cache of tool verdicts and reports
+ */
+#include "result_cache.h"
+
+
+/*
+ * SHA-256 round constants - see FIPS 180-4 section 4.2.2
+ */
+static uint32_t const sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#define SHA256_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+
+/*
+ * the cache, if any, whose output is being captured
+ *
+ * If a tool exits (say via err()) while its output is being captured, the
+ * atexit(3) handler uses this to put the captured output back where it belongs.
+ */
+static struct result_cache *capture_cache = NULL;
+static bool capture_atexit = false;	/* true ==> result_cache_atexit() registered */
+
+
+/*
+ * static declarations
+ */
+static void sha256_block(struct sha256_ctx *ctx, uint8_t const *block);
+static void result_cache_key(struct result_cache *cache);
+static bool copy_stream(FILE *from, FILE *to, size_t len);
+static bool write_all(int fd, char const *buf, size_t len);
+static void result_cache_relay(int out_fd, int err_fd, int live_out, int live_err, int report);
+static void result_cache_release(struct result_cache *cache);
+static void result_cache_atexit(void);
+
+
+/*
+ * sha256_init - initialize a SHA-256 digest
+ *
+ * given:
+ *	ctx	pointer to the SHA-256 digest state to initialize
+ *
+ * NOTE: this function does not return on NULL ctx.
+ */
+void
+sha256_init(struct sha256_ctx *ctx)
+{
+    /*
+     * firewall
+     */
+    if (ctx == NULL) {
+	err(10, __func__, "ctx is NULL");
+	not_reached();
+    }
+
+    /*
+     * initial hash value - see FIPS 180-4 section 5.3.3
+     */
+    ctx->state[0] = 0x6a09e667;
+    ctx->state[1] = 0xbb67ae85;
+    ctx->state[2] = 0x3c6ef372;
+    ctx->state[3] = 0xa54ff53a;
+    ctx->state[4] = 0x510e527f;
+    ctx->state[5] = 0x9b05688c;
+    ctx->state[6] = 0x1f83d9ab;
+    ctx->state[7] = 0x5be0cd19;
+    ctx->bit_len = 0;
+    ctx->block_len = 0;
+    memset(ctx->block, 0, sizeof(ctx->block));
+    return;
+}
+
+
+/*
+ * sha256_block - process a single 64 byte SHA-256 message block
+ *
+ * given:
+ *	ctx	pointer to the SHA-256 digest state
+ *	block	pointer to SHA256_BLOCK_LEN bytes of message
+ */
+static void
+sha256_block(struct sha256_ctx *ctx, uint8_t const *block)
+{
+    uint32_t w[64];		/* message schedule */
+    uint32_t a, b, c, d, e, f, g, h;	/* working variables */
+    uint32_t t1, t2;
+    int i;
+
+    for (i=0; i < 16; ++i) {
+	w[i] = ((uint32_t)block[4*i] << 24) | ((uint32_t)block[4*i+1] << 16) |
+	       ((uint32_t)block[4*i+2] << 8) | (uint32_t)block[4*i+3];
+    }
+    for (i=16; i < 64; ++i) {
+	uint32_t s0 = SHA256_ROTR(w[i-15], 7) ^ SHA256_ROTR(w[i-15], 18) ^ (w[i-15] >> 3);
+	uint32_t s1 = SHA256_ROTR(w[i-2], 17) ^ SHA256_ROTR(w[i-2], 19) ^ (w[i-2] >> 10);
+
+	w[i] = w[i-16] + s0 + w[i-7] + s1;
+    }
+
+    a = ctx->state[0];
+    b = ctx->state[1];
+    c = ctx->state[2];
+    d = ctx->state[3];
+    e = ctx->state[4];
+    f = ctx->state[5];
+    g = ctx->state[6];
+    h = ctx->state[7];
+    for (i=0; i < 64; ++i) {
+	t1 = h + (SHA256_ROTR(e, 6) ^ SHA256_ROTR(e, 11) ^ SHA256_ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+	t2 = (SHA256_ROTR(a, 2) ^ SHA256_ROTR(a, 13) ^ SHA256_ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+	h = g;
+	g = f;
+	f = e;
+	e = d + t1;
+	d = c;
+	c = b;
+	b = a;
+	a = t1 + t2;
+    }
+    ctx->state[0] += a;
+    ctx->state[1] += b;
+    ctx->state[2] += c;
+    ctx->state[3] += d;
+    ctx->state[4] += e;
+    ctx->state[5] += f;
+    ctx->state[6] += g;
+    ctx->state[7] += h;
+    return;
+}
+
+
+/*
+ * sha256_update - add data to a SHA-256 digest
+ *
+ * given:
+ *	ctx	pointer to the SHA-256 digest state
+ *	data	pointer to data to add
+ *	len	length of data in bytes
+ *
+ * NOTE: this function does not return on NULL ctx or a NULL data with len > 0.
+ */
+void
+sha256_update(struct sha256_ctx *ctx, void const *data, size_t len)
+{
+    uint8_t const *p = data;	/* next byte to digest */
+    size_t n;			/* bytes to copy into the partial block */
+
+    /*
+     * firewall
+     */
+    if (ctx == NULL) {
+	err(11, __func__, "ctx is NULL");
+	not_reached();
+    }
+    if (data == NULL && len > 0) {
+	err(12, __func__, "data is NULL with len: %zu > 0", len);
+	not_reached();
+    }
+
+    ctx->bit_len += (uint64_t)len * 8;
+    while (len > 0) {
+	/*
+	 * case: full blocks can be digested directly from data
+	 */
+	if (ctx->block_len == 0 && len >= SHA256_BLOCK_LEN) {
+	    sha256_block(ctx, p);
+	    p += SHA256_BLOCK_LEN;
+	    len -= SHA256_BLOCK_LEN;
+	    continue;
+	}
+
+	/*
+	 * case: accumulate a partial block
+	 */
+	n = SHA256_BLOCK_LEN - ctx->block_len;
+	if (n > len) {
+	    n = len;
+	}
+	memcpy(ctx->block + ctx->block_len, p, n);
+	ctx->block_len += n;
+	p += n;
+	len -= n;
+	if (ctx->block_len == SHA256_BLOCK_LEN) {
+	    sha256_block(ctx, ctx->block);
+	    ctx->block_len = 0;
+	}
+    }
+    return;
+}
+
+
+/*
+ * sha256_final - finish a SHA-256 digest
+ *
+ * given:
+ *	ctx	pointer to the SHA-256 digest state
+ *	digest	where to store the SHA256_DIGEST_LEN byte digest
+ *
+ * NOTE: ctx must be re-initialized with sha256_init() before it is used again.
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+void
+sha256_final(struct sha256_ctx *ctx, uint8_t digest[SHA256_DIGEST_LEN])
+{
+    uint64_t bit_len;		/* message length in bits before padding */
+    int i;
+
+    /*
+     * firewall
+     */
+    if (ctx == NULL || digest == NULL) {
+	err(13, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    /*
+     * pad with a 1 bit, then 0 bits, then the 64 bit big endian message length
+     */
+    bit_len = ctx->bit_len;
+    ctx->block[ctx->block_len++] = 0x80;
+    if (ctx->block_len > SHA256_BLOCK_LEN - 8) {
+	memset(ctx->block + ctx->block_len, 0, SHA256_BLOCK_LEN - ctx->block_len);
+	sha256_block(ctx, ctx->block);
+	ctx->block_len = 0;
+    }
+    memset(ctx->block + ctx->block_len, 0, SHA256_BLOCK_LEN - 8 - ctx->block_len);
+    for (i=0; i < 8; ++i) {
+	ctx->block[SHA256_BLOCK_LEN - 1 - i] = (uint8_t)(bit_len >> (8 * i));
+    }
+    sha256_block(ctx, ctx->block);
+    ctx->block_len = 0;
+
+    /*
+     * store the digest in big endian order
+     */
+    for (i=0; i < 8; ++i) {
+	digest[4*i] = (uint8_t)(ctx->state[i] >> 24);
+	digest[4*i+1] = (uint8_t)(ctx->state[i] >> 16);
+	digest[4*i+2] = (uint8_t)(ctx->state[i] >> 8);
+	digest[4*i+3] = (uint8_t)ctx->state[i];
+    }
+    return;
+}
+
+
+/*
+ * result_cache_init - initialize a result cache
+ *
+ * If dir is NULL the cache is disabled and all other result_cache functions
+ * become no-ops (result_cache_lookup() always misses).  This allows a tool to
+ * call the cache functions unconditionally whether or not its cache option
+ * was given.
+ *
+ * The cache directory is created if needed and is converted into an absolute
+ * path so that the cache remains usable should the tool later chdir(2).
+ *
+ * given:
+ *	cache	pointer to the result cache to initialize
+ *	dir	cache directory, or NULL ==> cache disabled
+ *	tool	name of the tool using the cache
+ *	...	NULL terminated list of version strings
+ *
+ * Every string in the ... list is added to the cache key, so any change to
+ * any of the versions invalidates all previous cache entries of the tool.
+ *
+ * NOTE: this function does not return on NULL cache or tool or if the cache
+ *	 directory cannot be created.
+ */
+void
+result_cache_init(struct result_cache *cache, char const *dir, char const *tool, ...)
+{
+    va_list ap;			/* variable argument list */
+    char const *version;	/* next version string */
+    int root = -1;		/* open / for an absolute cache directory, -1 ==> current directory */
+
+    /*
+     * firewall
+     */
+    if (cache == NULL) {
+	err(14, __func__, "cache is NULL");
+	not_reached();
+    }
+    if (tool == NULL) {
+	err(15, __func__, "tool is NULL");
+	not_reached();
+    }
+
+    /*
+     * initialize the cache
+     */
+    memset(cache, 0, sizeof(*cache));
+    cache->enabled = false;
+    cache->dir = NULL;
+    cache->tool = tool;
+    cache->key_ready = false;
+    cache->capturing = false;
+    cache->report = NULL;
+    cache->relay = -1;
+    cache->saved_stdout = -1;
+    cache->saved_stderr = -1;
+    sha256_init(&cache->ctx);
+
+    /*
+     * case: cache not requested
+     */
+    if (dir == NULL) {
+	dbg(DBG_HIGH, "%s result cache disabled", tool);
+	return;
+    }
+    if (*dir == '\0') {
+	err(16, __func__, "cache directory is empty");
+	not_reached();
+    }
+
+    /*
+     * create the cache directory as needed and note its absolute path
+     */
+    if (!is_dir(dir)) {
+	/*
+	 * mkdirs() works relative to a directory, so an absolute path must start at /
+	 */
+	if (*dir == '/') {
+	    errno = 0;		/* pre-clear errno for errp() */
+	    root = open("/", O_RDONLY|O_DIRECTORY|O_CLOEXEC);
+	    if (root < 0) {
+		errp(27, __func__, "cannot open /");
+		not_reached();
+	    }
+	}
+	(void) mkdirs(root, dir, 0755);
+	if (root >= 0) {
+	    (void) close(root);
+	    root = -1;
+	}
+    }
+    errno = 0;		/* pre-clear errno for errp() */
+    cache->dir = realpath(dir, NULL);
+    if (cache->dir == NULL) {
+	errp(17, __func__, "cannot determine absolute path of cache directory: %s", dir);
+	not_reached();
+    }
+    if (!is_dir(cache->dir) || !is_write(cache->dir)) {
+	err(18, __func__, "cache directory is not a writable directory: %s", cache->dir);
+	not_reached();
+    }
+    cache->enabled = true;
+    dbg(DBG_MED, "%s result cache directory: %s", tool, cache->dir);
+
+    /*
+     * start the key with the tool name and versions
+     */
+    result_cache_add_str(cache, RESULT_CACHE_MAGIC);
+    result_cache_add_str(cache, tool);
+    va_start(ap, tool);
+    while ((version = va_arg(ap, char const *)) != NULL) {
+	result_cache_add_str(cache, version);
+    }
+    va_end(ap);
+    return;
+}
+
+
+/*
+ * result_cache_add - add raw bytes to the cache key
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	data	pointer to data to add
+ *	len	length of data in bytes
+ *
+ * NOTE: this function does nothing if the cache is disabled.
+ *
+ * NOTE: this function does not return on NULL cache or if called after the
+ *	 cache key was finished by result_cache_lookup().
+ */
+void
+result_cache_add(struct result_cache *cache, void const *data, size_t len)
+{
+    /*
+     * firewall
+     */
+    if (cache == NULL) {
+	err(19, __func__, "cache is NULL");
+	not_reached();
+    }
+    if (!cache->enabled) {
+	return;
+    }
+    if (cache->key_ready) {
+	err(20, __func__, "cannot add to a finished cache key");
+	not_reached();
+    }
+
+    sha256_update(&cache->ctx, data, len);
+    return;
+}
+
+
+/*
+ * result_cache_add_str - add a string to the cache key
+ *
+ * The length of the string is added ahead of the string so that the
+ * concatenation of two strings can never collide with a different pair
+ * of strings (e.g. "ab" + "c" vs. "a" + "bc").
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	str	string to add, NULL is added as if it was an empty string
+ *		that is distinct from ""
+ *
+ * NOTE: this function does nothing if the cache is disabled.
+ */
+void
+result_cache_add_str(struct result_cache *cache, char const *str)
+{
+    if (str == NULL) {
+	result_cache_add_intmax(cache, -1);
+	return;
+    }
+    result_cache_add_intmax(cache, (intmax_t)strlen(str));
+    result_cache_add(cache, str, strlen(str));
+    return;
+}
+
+
+/*
+ * result_cache_add_intmax - add an integer to the cache key
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	value	value to add
+ *
+ * NOTE: this function does nothing if the cache is disabled.
+ */
+void
+result_cache_add_intmax(struct result_cache *cache, intmax_t value)
+{
+    char buf[sizeof("-") + sizeof(intmax_t)*3 + 1];	/* value in decimal */
+    int len;
+
+    len = snprintf(buf, sizeof(buf), "%jd;", value);
+    if (len > 0) {
+	result_cache_add(cache, buf, (size_t)len);
+    }
+    return;
+}
+
+
+/*
+ * result_cache_add_file - add the contents of a file to the cache key
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	path	path of file to add
+ *
+ * returns:
+ *	true ==> file contents added, or cache is disabled
+ *	false ==> file could not be read, a marker for the missing file
+ *		  was added in its place
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+bool
+result_cache_add_file(struct result_cache *cache, char const *path)
+{
+    FILE *stream = NULL;	/* open file */
+    char buf[BUFSIZ];		/* read buffer */
+    size_t len;			/* bytes read */
+    bool ok = true;		/* true ==> file fully read */
+
+    /*
+     * firewall
+     */
+    if (cache == NULL || path == NULL) {
+	err(21, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (!cache->enabled) {
+	return true;
+    }
+
+    /*
+     * add file name ahead of the contents
+     */
+    result_cache_add_str(cache, path);
+
+    errno = 0;		/* pre-clear errno for warnp() */
+    stream = fopen(path, "rb");
+    if (stream == NULL) {
+	dbg(DBG_HIGH, "cannot open for result cache key: %s: %s", path, strerror(errno));
+	result_cache_add_str(cache, NULL);
+	return false;
+    }
+    while ((len = fread(buf, 1, sizeof(buf), stream)) > 0) {
+	result_cache_add(cache, buf, len);
+    }
+    if (ferror(stream)) {
+	warnp(__func__, "error reading: %s", path);
+	result_cache_add_str(cache, NULL);
+	ok = false;
+    }
+    (void) fclose(stream);
+    return ok;
+}
+
+
+/*
+ * result_cache_add_stat - add the type, size, mode and modification time of a path
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	path	path to lstat(2)
+ *
+ * returns:
+ *	true ==> path information was added, or cache is disabled
+ *	false ==> path could not be lstat(2)ed, a marker was added in its place
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+bool
+result_cache_add_stat(struct result_cache *cache, char const *path)
+{
+    struct stat buf;		/* path status */
+
+    /*
+     * firewall
+     */
+    if (cache == NULL || path == NULL) {
+	err(22, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (!cache->enabled) {
+	return true;
+    }
+
+    result_cache_add_str(cache, path);
+    errno = 0;		/* pre-clear errno */
+    if (lstat(path, &buf) != 0) {
+	dbg(DBG_HIGH, "cannot lstat for result cache key: %s: %s", path, strerror(errno));
+	result_cache_add_str(cache, NULL);
+	return false;
+    }
+    result_cache_add_intmax(cache, (intmax_t)buf.st_mode);
+    result_cache_add_intmax(cache, (intmax_t)buf.st_size);
+    result_cache_add_intmax(cache, (intmax_t)buf.st_mtime);
+    return true;
+}
+
+
+/*
+ * result_cache_add_tool - add the identity of an executable to the cache key
+ *
+ * The version strings of a tool do not change when it is rebuilt or when
+ * another tool it runs, such as tar(1), is upgraded, so the path, size,
+ * modification time and inode number of the executable are added as well.
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *	cmd	executable: a path, or a name to look for under $PATH
+ *
+ * returns:
+ *	true ==> executable identity was added, or cache is disabled
+ *	false ==> executable not found, a marker was added in its place
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+bool
+result_cache_add_tool(struct result_cache *cache, char const *cmd)
+{
+    struct stat buf;		/* executable status */
+    char *path = NULL;		/* path of the executable */
+
+    /*
+     * firewall
+     */
+    if (cache == NULL || cmd == NULL) {
+	err(28, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (!cache->enabled) {
+	return true;
+    }
+
+    /*
+     * find the executable, following any symlink to it
+     */
+    result_cache_add_str(cache, cmd);
+    if (strchr(cmd, '/') != NULL) {
+	/* as with execvp(3), a cmd with a / is a path and not looked for under $PATH */
+	path = NULL;
+    } else {
+	path = resolve_path(cmd);
+	if (path == NULL) {
+	    dbg(DBG_HIGH, "cannot find executable under $PATH for result cache key: %s", cmd);
+	    result_cache_add_str(cache, NULL);
+	    return false;
+	}
+    }
+    errno = 0;		/* pre-clear errno */
+    if (stat(path != NULL ? path : cmd, &buf) != 0) {
+	dbg(DBG_HIGH, "cannot stat executable for result cache key: %s: %s", cmd, strerror(errno));
+	result_cache_add_str(cache, NULL);
+	if (path != NULL) {
+	    free(path);
+	}
+	return false;
+    }
+    result_cache_add_str(cache, path != NULL ? path : cmd);
+    result_cache_add_intmax(cache, (intmax_t)buf.st_size);
+    result_cache_add_intmax(cache, (intmax_t)buf.st_mtime);
+    result_cache_add_intmax(cache, (intmax_t)buf.st_ino);
+    if (path != NULL) {
+	free(path);
+    }
+    return true;
+}
+
+
+/*
+ * result_cache_key - finish the cache key
+ *
+ * given:
+ *	cache	pointer to an enabled result cache
+ */
+static void
+result_cache_key(struct result_cache *cache)
+{
+    uint8_t digest[SHA256_DIGEST_LEN];	/* finished digest */
+    int i;
+
+    if (cache->key_ready) {
+	return;
+    }
+    sha256_final(&cache->ctx, digest);
+    for (i=0; i < SHA256_DIGEST_LEN; ++i) {
+	snprintf(cache->key + 2*i, 3, "%02x", digest[i]);
+    }
+    cache->key[RESULT_CACHE_KEY_LEN] = '\0';
+    cache->key_ready = true;
+    dbg(DBG_MED, "%s result cache key: %s", cache->tool, cache->key);
+    return;
+}
+
+
+/*
+ * copy_stream - copy len bytes from one open stream to another
+ *
+ * given:
+ *	from	stream to read
+ *	to	stream to write
+ *	len	number of bytes to copy
+ *
+ * returns:
+ *	true ==> all len bytes were copied
+ *	false ==> short read or write error
+ */
+static bool
+copy_stream(FILE *from, FILE *to, size_t len)
+{
+    char buf[BUFSIZ];		/* copy buffer */
+    size_t want;		/* bytes to read this time */
+    size_t got;			/* bytes actually read */
+
+    while (len > 0) {
+	want = len < sizeof(buf) ? len : sizeof(buf);
+	got = fread(buf, 1, want, from);
+	if (got == 0) {
+	    return false;
+	}
+	if (fwrite(buf, 1, got, to) != got) {
+	    return false;
+	}
+	len -= got;
+    }
+    return true;
+}
+
+
+/*
+ * write_all - write all of a buffer to a file descriptor
+ *
+ * given:
+ *	fd	file descriptor to write
+ *	buf	buffer to write
+ *	len	number of bytes to write
+ *
+ * returns:
+ *	true ==> all len bytes were written
+ *	false ==> write error
+ */
+static bool
+write_all(int fd, char const *buf, size_t len)
+{
+    ssize_t ret;		/* bytes written this time */
+
+    while (len > 0) {
+	ret = write(fd, buf, len);
+	if (ret < 0 && errno == EINTR) {
+	    continue;
+	}
+	if (ret <= 0) {
+	    return false;
+	}
+	buf += ret;
+	len -= (size_t)ret;
+    }
+    return true;
+}
+
+
+/*
+ * result_cache_lookup - look for a cached result, replaying it on a hit
+ *
+ * This function finishes the cache key: no more data may be added to
+ * the key after this call.
+ *
+ * On a cache hit, the cached chunks of the report are written to stdout and
+ * stderr, in the order they were recorded, and the cached verdict is returned.
+ *
+ * given:
+ *	cache	    pointer to an initialized result cache
+ *	verdict	    where to store the cached verdict on a hit
+ *
+ * returns:
+ *	true ==> cache hit, report replayed and *verdict set
+ *	false ==> cache miss, or cache is disabled
+ *
+ * NOTE: a damaged cache file is treated as a cache miss, unless some of its
+ *	 report was already replayed, in which case a warning is issued.
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+bool
+result_cache_lookup(struct result_cache *cache, intmax_t *verdict)
+{
+    char *path = NULL;		/* path of cache file */
+    FILE *stream = NULL;	/* open cache file */
+    char magic[sizeof(RESULT_CACHE_MAGIC)+1];	/* first line of cache file */
+    char tag[sizeof("stdout")];	/* stream of the next chunk */
+    intmax_t cached = 0;	/* cached verdict */
+    size_t len = 0;		/* length of the next chunk */
+    bool ok = false;		/* true ==> valid cache entry replayed */
+    int ret;
+
+    /*
+     * firewall
+     */
+    if (cache == NULL || verdict == NULL) {
+	err(23, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (!cache->enabled) {
+	return false;
+    }
+
+    /*
+     * open the cache entry, if it exists
+     */
+    result_cache_key(cache);
+    path = calloc_path(cache->dir, cache->key);
+    stream = fopen(path, "rb");
+    if (stream == NULL) {
+	dbg(DBG_MED, "%s result cache miss: %s", cache->tool, cache->key);
+	free(path);
+	return false;
+    }
+
+    /*
+     * parse the cache entry header
+     */
+    if (fgets(magic, (int)sizeof(magic), stream) == NULL ||
+	strncmp(magic, RESULT_CACHE_MAGIC "\n", sizeof(magic)) != 0 ||
+	fscanf(stream, "verdict: %jd\n", &cached) != 1) {
+	dbg(DBG_LOW, "ignoring damaged result cache entry: %s", path);
+
+    /*
+     * replay the chunks of the report in order
+     */
+    } else {
+	fflush(stdout);
+	fflush(stderr);
+	ok = true;
+	while (ok && (ret = fscanf(stream, "%6s %zu", tag, &len)) != EOF) {
+	    if (ret != 2 || fgetc(stream) != '\n' || (strcmp(tag, "stdout") != 0 && strcmp(tag, "stderr") != 0)) {
+		ok = false;
+	    } else if (strcmp(tag, "stdout") == 0) {
+		ok = copy_stream(stream, stdout, len);
+		fflush(stdout);
+	    } else {
+		ok = copy_stream(stream, stderr, len);
+		fflush(stderr);
+	    }
+	}
+	if (ok) {
+	    dbg(DBG_MED, "%s result cache hit: %s verdict: %jd", cache->tool, cache->key, cached);
+	    *verdict = cached;
+	} else {
+	    warn(__func__, "damaged result cache entry: %s", path);
+	}
+    }
+
+    (void) fclose(stream);
+    free(path);
+    return ok;
+}
+
+
+/*
+ * result_cache_relay - copy captured output to the real stdout and stderr, and record it
+ *
+ * This is the body of the relay process forked by result_cache_capture().
+ * Whatever is read from either pipe is written at once to the real stream it
+ * was meant for and appended to the report as a chunk tagged with that stream.
+ * Chunks are recorded in the order they are read: output written to both
+ * streams faster than the relay can read it is ordered with stdout first.
+ *
+ * given:
+ *	out_fd	    read end of the pipe that is the captured stdout
+ *	err_fd	    read end of the pipe that is the captured stderr
+ *	live_out    the real stdout
+ *	live_err    the real stderr
+ *	report	    temporary file of the tagged chunks of the report
+ *
+ * NOTE: this function returns when both pipes are closed by every writer.
+ */
+static void
+result_cache_relay(int out_fd, int err_fd, int live_out, int live_err, int report)
+{
+    struct pollfd fds[2];	/* the captured stdout and stderr pipes */
+    char buf[BUFSIZ];		/* chunk of output */
+    char tag[sizeof("stdout ") + sizeof(size_t)*3 + 1];	/* tag line of a chunk */
+    ssize_t len;		/* length of the chunk read */
+    int ret;
+    int i;
+
+    fds[0].fd = out_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = err_fd;
+    fds[1].events = POLLIN;
+    while (fds[0].fd >= 0 || fds[1].fd >= 0) {
+	if (poll(fds, 2, -1) < 0) {
+	    if (errno == EINTR) {
+		continue;
+	    }
+	    break;
+	}
+	for (i=0; i < 2; ++i) {
+	    if (fds[i].fd < 0 || fds[i].revents == 0) {
+		continue;
+	    }
+	    len = read(fds[i].fd, buf, sizeof(buf));
+	    if (len < 0 && errno == EINTR) {
+		continue;
+	    }
+	    if (len <= 0) {
+		(void) close(fds[i].fd);
+		fds[i].fd = -1;
+		continue;
+	    }
+	    (void) write_all(i == 0 ? live_out : live_err, buf, (size_t)len);
+	    ret = snprintf(tag, sizeof(tag), "%s %zu\n", i == 0 ? "stdout" : "stderr", (size_t)len);
+	    if (ret > 0) {
+		(void) write_all(report, tag, (size_t)ret);
+		(void) write_all(report, buf, (size_t)len);
+	    }
+	}
+    }
+    return;
+}
+
+
+/*
+ * result_cache_capture - start capturing stdout and stderr for a new cache entry
+ *
+ * Everything written to stdout and stderr, including the output of any child
+ * process, goes through a relay process until result_cache_store() is called:
+ * the relay writes it to the real stdout and stderr as it arrives and records
+ * it, in order, as the report of the new cache entry.
+ *
+ * given:
+ *	cache	pointer to an initialized result cache
+ *
+ * NOTE: if the pipes, report file or relay process cannot be created, a
+ *	 warning is issued and the cache is disabled for the remainder of the run.
+ *
+ * NOTE: this function does not return on NULL cache.
+ */
+void
+result_cache_capture(struct result_cache *cache)
+{
+    int out_pipe[2] = { -1, -1 };	/* pipe that becomes stdout */
+    int err_pipe[2] = { -1, -1 };	/* pipe that becomes stderr */
+    bool line_buffered;			/* true ==> stdout is a terminal, keep it line buffered */
+    bool ok;				/* true ==> capture set up */
+
+    /*
+     * firewall
+     */
+    if (cache == NULL) {
+	err(24, __func__, "cache is NULL");
+	not_reached();
+    }
+    if (!cache->enabled || cache->capturing) {
+	return;
+    }
+
+    /*
+     * create the report file and the pipes
+     */
+    fflush(stdout);
+    fflush(stderr);
+    line_buffered = isatty(STDOUT_FILENO) != 0;
+    errno = 0;		/* pre-clear errno for warnp() */
+    cache->report = tmpfile();
+    cache->saved_stdout = dup(STDOUT_FILENO);
+    cache->saved_stderr = dup(STDERR_FILENO);
+    ok = cache->report != NULL && cache->saved_stdout >= 0 && cache->saved_stderr >= 0 &&
+	 pipe(out_pipe) == 0 && pipe(err_pipe) == 0;
+
+    /*
+     * fork the relay process
+     */
+    if (ok) {
+	cache->relay = fork();
+	if (cache->relay == 0) {
+	    /* relay process: we only read the pipes, and must not run atexit(3) handlers */
+	    (void) close(out_pipe[1]);
+	    (void) close(err_pipe[1]);
+	    result_cache_relay(out_pipe[0], err_pipe[0], cache->saved_stdout, cache->saved_stderr,
+			       fileno(cache->report));
+	    _exit(0); /*ooo*/
+	}
+	ok = cache->relay > 0;
+    }
+
+    /*
+     * divert stdout and stderr into the pipes
+     */
+    if (ok) {
+	ok = dup2(out_pipe[1], STDOUT_FILENO) >= 0 && dup2(err_pipe[1], STDERR_FILENO) >= 0;
+    }
+    if (out_pipe[0] >= 0) {
+	(void) close(out_pipe[0]);
+	(void) close(out_pipe[1]);
+    }
+    if (err_pipe[0] >= 0) {
+	(void) close(err_pipe[0]);
+	(void) close(err_pipe[1]);
+    }
+    cache->capturing = true;
+    if (!ok) {
+	result_cache_release(cache);
+	warnp(__func__, "cannot capture output for result cache, cache disabled");
+	if (cache->report != NULL) {
+	    (void) fclose(cache->report);
+	    cache->report = NULL;
+	}
+	cache->enabled = false;
+	return;
+    }
+
+    /*
+     * stdout is now a pipe: keep the buffering it had so that stdout and stderr interleave as before
+     */
+    if (line_buffered) {
+	(void) setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+    }
+    capture_cache = cache;
+    if (!capture_atexit) {
+	if (atexit(result_cache_atexit) == 0) {
+	    capture_atexit = true;
+	} else {
+	    warn(__func__, "atexit(result_cache_atexit) failed");
+	}
+    }
+    return;
+}
+
+
+/*
+ * result_cache_atexit - do not lose captured output on an early exit
+ *
+ * If the tool exits while output is being captured, nothing is cached:
+ * the relay already wrote the captured output to the real stdout and stderr.
+ */
+static void
+result_cache_atexit(void)
+{
+    if (capture_cache != NULL && capture_cache->capturing) {
+	result_cache_free(capture_cache);
+    }
+    capture_cache = NULL;
+    return;
+}
+
+
+/*
+ * result_cache_release - stop capturing, restore stdout and stderr and wait for the relay
+ *
+ * Once stdout and stderr are restored, the pipes are closed by their last
+ * writer (provided no child process of the tool still holds them) and the
+ * relay process is done with the report.
+ *
+ * given:
+ *	cache	pointer to an enabled result cache
+ */
+static void
+result_cache_release(struct result_cache *cache)
+{
+    int status;			/* relay process exit status */
+
+    fflush(stdout);
+    fflush(stderr);
+    if (cache->saved_stdout >= 0) {
+	(void) dup2(cache->saved_stdout, STDOUT_FILENO);
+	(void) close(cache->saved_stdout);
+	cache->saved_stdout = -1;
+    }
+    if (cache->saved_stderr >= 0) {
+	(void) dup2(cache->saved_stderr, STDERR_FILENO);
+	(void) close(cache->saved_stderr);
+	cache->saved_stderr = -1;
+    }
+    if (cache->relay > 0) {
+	while (waitpid(cache->relay, &status, 0) < 0 && errno == EINTR) {
+	    /* wait for the relay to finish */
+	}
+	cache->relay = -1;
+    }
+    cache->capturing = false;
+    if (capture_cache == cache) {
+	capture_cache = NULL;
+    }
+    return;
+}
+
+
+/*
+ * result_cache_store - stop capturing, emit the report and store it with a verdict
+ *
+ * The report recorded by the relay process, which already wrote it to the real
+ * stdout and stderr, is saved along with the verdict as a new cache entry.  The cache
+ * entry is written to a temporary file that is renamed into place so that a
+ * concurrent run never sees a partial entry.
+ *
+ * given:
+ *	cache	    pointer to an initialized result cache
+ *	verdict	    verdict of the check to cache
+ *
+ * NOTE: failure to write the cache entry only results in a warning.
+ *
+ * NOTE: this function does not return on NULL cache.
+ */
+void
+result_cache_store(struct result_cache *cache, intmax_t verdict)
+{
+    char *path = NULL;		/* path of cache file */
+    char *tmp_path = NULL;	/* path of temporary cache file */
+    FILE *stream = NULL;	/* open temporary cache file */
+    off_t len = 0;		/* length of the recorded report */
+    bool ok = false;		/* true ==> cache entry written */
+    int ret;
+
+    /*
+     * firewall
+     */
+    if (cache == NULL) {
+	err(25, __func__, "cache is NULL");
+	not_reached();
+    }
+    if (!cache->enabled || !cache->capturing) {
+	return;
+    }
+
+    /*
+     * restore stdout and stderr and wait for the relay to finish the report
+     */
+    result_cache_release(cache);
+    if (fseeko(cache->report, 0, SEEK_END) != 0 || (len = ftello(cache->report)) < 0) {
+	warnp(__func__, "cannot determine length of the result cache report");
+	(void) fclose(cache->report);
+	cache->report = NULL;
+	return;
+    }
+
+    /*
+     * write the cache entry
+     */
+    result_cache_key(cache);
+    path = calloc_path(cache->dir, cache->key);
+    tmp_path = calloc(1, strlen(path) + sizeof(".tmp.") + sizeof(intmax_t)*3 + 1);
+    if (tmp_path == NULL) {
+	errp(26, __func__, "calloc of temporary cache path failed");
+	not_reached();
+    }
+    ret = sprintf(tmp_path, "%s.tmp.%jd", path, (intmax_t)getpid());
+    if (ret <= 0) {
+	warnp(__func__, "sprintf of temporary cache path failed");
+    } else {
+	errno = 0;	/* pre-clear errno for warnp() */
+	stream = fopen(tmp_path, "wb");
+	if (stream == NULL) {
+	    warnp(__func__, "cannot create result cache entry: %s", tmp_path);
+	} else {
+	    rewind(cache->report);
+	    ok = fprintf(stream, "%s\nverdict: %jd\n", RESULT_CACHE_MAGIC, verdict) > 0 &&
+		 copy_stream(cache->report, stream, (size_t)len);
+	    if (fclose(stream) != 0) {
+		ok = false;
+	    }
+	    if (ok && rename(tmp_path, path) != 0) {
+		ok = false;
+	    }
+	    if (!ok) {
+		warnp(__func__, "cannot write result cache entry: %s", path);
+		(void) unlink(tmp_path);
+	    } else {
+		dbg(DBG_MED, "%s result cache stored: %s verdict: %jd", cache->tool, cache->key, verdict);
+	    }
+	}
+    }
+
+    free(tmp_path);
+    free(path);
+    (void) fclose(cache->report);
+    cache->report = NULL;
+    return;
+}
+
+
+/*
+ * result_cache_free - free storage of a result cache
+ *
+ * If output is still being captured, capturing stops without anything being
+ * cached: the relay process already wrote the output to the real stdout and
+ * stderr.
+ *
+ * given:
+ *	cache	pointer to a result cache
+ *
+ * NOTE: this function does nothing if cache is NULL.
+ */
+void
+result_cache_free(struct result_cache *cache)
+{
+    /*
+     * firewall
+     */
+    if (cache == NULL) {
+	return;
+    }
+
+    /*
+     * stop capturing, the output is not lost
+     */
+    if (cache->capturing) {
+	result_cache_release(cache);
+    }
+    if (cache->report != NULL) {
+	(void) fclose(cache->report);
+	cache->report = NULL;
+    }
+    if (cache->dir != NULL) {
+	free(cache->dir);
+	cache->dir = NULL;
+    }
+    cache->enabled = false;
+    return;
+}
@@ -0,0 +1,137 @@
+/*
+ * result_cache - content addressed cache of tool verdicts and reports
+ *
+ * "Because asking the same question twice should not cost twice." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * This tool and the JSON parser were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+#if !defined(INCLUDE_RESULT_CACHE_H)
+#    define  INCLUDE_RESULT_CACHE_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#include "../dbg/dbg.h"
+
+
+/*
+ * result cache definitions
+ */
+#define SHA256_BLOCK_LEN (64)			/* SHA-256 message block length in bytes */
+#define SHA256_DIGEST_LEN (32)			/* SHA-256 digest length in bytes */
+#define RESULT_CACHE_KEY_LEN (2*SHA256_DIGEST_LEN)	/* length of hex cache key, w/o the NUL */
+#define RESULT_CACHE_MAGIC "mkiocccentry result cache 2"	/* first line of every cache file */
+
+
+/*
+ * sha256_ctx - running SHA-256 digest state
+ */
+struct sha256_ctx
+{
+    uint32_t state[8];				/* intermediate hash value */
+    uint64_t bit_len;				/* total number of message bits processed */
+    uint8_t block[SHA256_BLOCK_LEN];		/* partial message block */
+    size_t block_len;				/* number of bytes in block[] */
+};
+
+
+/*
+ * result_cache - state of an opt-in on-disk cache of one tool invocation
+ *
+ * The cache key is the SHA-256 digest of everything added with the
+ * result_cache_add*() functions.  result_cache_init() always adds the
+ * tool name and tool version(s) first so that a new version of a tool
+ * never sees the results of an older version, and result_cache_add_tool()
+ * adds the identity of an executable so that a rebuilt tool, or an upgraded
+ * tool that it runs, does not either.
+ *
+ * A cache entry records the verdict (the value that determines the exit
+ * code of the tool) along with everything the tool wrote to stdout and
+ * stderr while the check was being performed.  While a check is captured,
+ * stdout and stderr are pipes to a relay process that writes what it reads
+ * to the real stdout and stderr as it arrives, so the report of a cache miss
+ * is seen as it is written, and that also records it as a single report of
+ * chunks, each tagged with the stream it was written to.  On a cache hit the
+ * chunks are replayed onto stdout and stderr in the order they were recorded
+ * so that the output is identical to the output of the original check.
+ *
+ * The cache entry is the RESULT_CACHE_MAGIC line, a "verdict: %jd" line and
+ * then the chunks, each a "stdout %zu" or "stderr %zu" line followed by that
+ * many bytes of output.
+ */
+struct result_cache
+{
+    bool enabled;				/* true ==> cache is in use */
+    char *dir;					/* absolute path of the cache directory */
+    char const *tool;				/* name of the tool using the cache */
+    struct sha256_ctx ctx;			/* digest of the cache key material */
+    char key[RESULT_CACHE_KEY_LEN+1];		/* hex cache key, once finished */
+    bool key_ready;				/* true ==> key[] has been computed */
+
+    bool capturing;				/* true ==> stdout and stderr are being captured */
+    FILE *report;				/* temporary file of the tagged chunks of the report */
+    pid_t relay;				/* relay process of the captured output, or -1 */
+    int saved_stdout;				/* dup of the original stdout descriptor */
+    int saved_stderr;				/* dup of the original stderr descriptor */
+};
+
+
+/*
+ * external function declarations
+ */
+extern void sha256_init(struct sha256_ctx *ctx);
+extern void sha256_update(struct sha256_ctx *ctx, void const *data, size_t len);
+extern void sha256_final(struct sha256_ctx *ctx, uint8_t digest[SHA256_DIGEST_LEN]);
+extern void result_cache_init(struct result_cache *cache, char const *dir, char const *tool, ...);
+extern void result_cache_add(struct result_cache *cache, void const *data, size_t len);
+extern void result_cache_add_str(struct result_cache *cache, char const *str);
+extern void result_cache_add_intmax(struct result_cache *cache, intmax_t value);
+extern bool result_cache_add_file(struct result_cache *cache, char const *path);
+extern bool result_cache_add_stat(struct result_cache *cache, char const *path);
+extern bool result_cache_add_tool(struct result_cache *cache, char const *cmd);
+extern bool result_cache_lookup(struct result_cache *cache, intmax_t *verdict);
+extern void result_cache_capture(struct result_cache *cache);
+extern void result_cache_store(struct result_cache *cache, intmax_t verdict);
+extern void result_cache_free(struct result_cache *cache);
+
+
+#endif /* INCLUDE_RESULT_CACHE_H */
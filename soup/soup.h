@@ -108,6 +108,9 @@
 #define LS_PATH_0 "ls"                              /* for $PATH search */
 #define LS_PATH_1 "/bin/ls"			    /* historic path for ls */
 #define LS_PATH_2 "/usr/bin/ls"			    /* alternate ls path for some systems where /bin/ls != /usr/bin/ls */
+#define XZ_PATH_0 "xz"                              /* for $PATH search */
+#define XZ_PATH_1 "/usr/bin/xz"			    /* historic path for xz */
+#define XZ_PATH_2 "/bin/xz"			    /* alternate xz path for some systems where /usr/bin/xz != /bin/xz */
 #define FNAMCHK_PATH_0 "./test_ioccc/fnamchk"	    /* path to fnamchk tool if not installed */
 #define FNAMCHK_PATH_1 "fnamchk"                    /* for $PATH search */
 #define FNAMCHK_PATH_2 "/usr/local/bin/fnamchk"	    /* default path to fnamchk tool if installed */
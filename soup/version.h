@@ -84,12 +84,12 @@
  *
  * NOTE: This should match the latest Release string in CHANGES.md
  */
-#define MKIOCCCENTRY_REPO_VERSION "2.11.8 2026-06-27"	/* special release format: major.minor[.patch] YYYY-MM-DD */
+#define MKIOCCCENTRY_REPO_VERSION "2.11.8 2026-10-19"	/* special release format: major.minor[.patch] YYYY-MM-DD */
 
 /*
  * official soup version (aka recipe :-) )
  */
-#define SOUP_VERSION "2.4.3 2026-06-30"		/* format: major.minor[.patch] YYYY-MM-DD */
+#define SOUP_VERSION "2.4.4 2026-10-19"		/* format: major.minor[.patch] YYYY-MM-DD */
 
 /*
  * official iocccsize version
@@ -131,7 +131,7 @@
 /*
  * official txzchk version
  */
-#define TXZCHK_VERSION "2.1.2 2026-06-13"	/* format: major.minor[.patch] YYYY-MM-DD */
+#define TXZCHK_VERSION "2.1.3 2026-10-19"	/* format: major.minor[.patch] YYYY-MM-DD */
 #define MIN_TXZCHK_VERSION TXZCHK_VERSION
 
 /*
@@ -0,0 +1,718 @@
+/*
+ * xz_index - random access to the blocks of an xz compressed file
+ *
+ * "Because sometimes you only want one feather out of the ball of tar." :-)
+ *
+ * An xz file ends with an index that records, for every block, the size of
+ * the compressed block and the size of its uncompressed data.  This allows
+ * us to locate the block that holds any given uncompressed offset, and to
+ * decompress just that block, without reading the rest of the file.
+ *
+ * We do not link with liblzma: a single block is decompressed by wrapping it
+ * into a minimal single block xz stream which is then given to xz(1), in the
+ * same way that we use tar(1) rather than a tar library.
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * This tool and the JSON parser were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+/* special comments for the seqcexit tool */
+/* exit code out of numerical order - ignore in sequencing - ooo */
+/* exit code change of order - use new value in sequencing - coo */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ * pr - stdio helper library
+ */
+#include "../dbg/dbg.h"
+#include "../pr/pr.h"
+
+/*
+ * util - common utility functions for the IOCCC toolkit
+ */
+#include "util.h"
+
+/*
+ * xz_index - random access to the blocks of an xz compressed file
+ */
+#include "xz_index.h"
+
+
+/*
+ * xz magic bytes
+ */
+static uint8_t const xz_header_magic[6] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+static uint8_t const xz_footer_magic[2] = { 'Y', 'Z' };
+
+
+/*
+ * static declarations
+ */
+static uint32_t get_le32(uint8_t const *p);
+static void put_le32(uint8_t *p, uint32_t value);
+static size_t get_vli(uint8_t const *buf, size_t len, uintmax_t *value);
+static size_t put_vli(uint8_t *buf, uintmax_t value);
+static bool read_at(FILE *stream, off_t offset, void *buf, size_t len);
+
+
+/*
+ * xz_crc32 - compute or continue the CRC32 used by the xz file format
+ *
+ * given:
+ *	crc	0 to start a new CRC32, or the previous return value to continue one
+ *	buf	data to add to the CRC32
+ *	len	length of buf in bytes
+ *
+ * returns:
+ *	CRC32 of all the data given so far
+ *
+ * NOTE: this function does not return on NULL buf with len > 0.
+ */
+uint32_t
+xz_crc32(uint32_t crc, void const *buf, size_t len)
+{
+    uint8_t const *p = buf;	/* next byte to add */
+    int i;
+
+    /*
+     * firewall
+     */
+    if (buf == NULL && len > 0) {
+	err(10, __func__, "buf is NULL with len: %zu > 0", len);
+	not_reached();
+    }
+
+    /*
+     * bitwise IEEE 802.3 CRC32: the xz indexes we check are tiny, so no table is needed
+     */
+    crc = ~crc;
+    while (len-- > 0) {
+	crc ^= *p++;
+	for (i=0; i < 8; ++i) {
+	    crc = (crc >> 1) ^ (0xedb88320 & (uint32_t)-(int32_t)(crc & 1));
+	}
+    }
+    return ~crc;
+}
+
+
+/*
+ * get_le32 - decode a little endian 32 bit value
+ */
+static uint32_t
+get_le32(uint8_t const *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+/*
+ * put_le32 - encode a little endian 32 bit value
+ */
+static void
+put_le32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+    p[2] = (uint8_t)(value >> 16);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+
+/*
+ * get_vli - decode an xz variable length integer
+ *
+ * given:
+ *	buf	encoded integer
+ *	len	bytes available in buf
+ *	value	where to store the decoded integer
+ *
+ * returns:
+ *	number of bytes decoded, or 0 ==> truncated or invalid integer
+ */
+static size_t
+get_vli(uint8_t const *buf, size_t len, uintmax_t *value)
+{
+    size_t i;
+
+    *value = 0;
+    for (i=0; i < len && i < XZ_VLI_MAX_LEN; ++i) {
+	*value |= (uintmax_t)(buf[i] & 0x7f) << (7 * i);
+	if ((buf[i] & 0x80) == 0) {
+	    /* a multi-byte integer may not end with a 0 byte */
+	    if (i > 0 && buf[i] == 0) {
+		return 0;
+	    }
+	    return i + 1;
+	}
+    }
+    return 0;
+}
+
+
+/*
+ * put_vli - encode an xz variable length integer
+ *
+ * given:
+ *	buf	where to store the encoded integer, at least XZ_VLI_MAX_LEN bytes
+ *	value	integer to encode
+ *
+ * returns:
+ *	number of bytes encoded
+ */
+static size_t
+put_vli(uint8_t *buf, uintmax_t value)
+{
+    size_t i = 0;
+
+    while (value >= 0x80) {
+	buf[i++] = (uint8_t)(value | 0x80);
+	value >>= 7;
+    }
+    buf[i++] = (uint8_t)value;
+    return i;
+}
+
+
+/*
+ * read_at - read exactly len bytes at an offset of an open file
+ *
+ * returns:
+ *	true ==> len bytes read
+ *	false ==> seek or read failed, or short read
+ */
+static bool
+read_at(FILE *stream, off_t offset, void *buf, size_t len)
+{
+    if (fseeko(stream, offset, SEEK_SET) != 0) {
+	return false;
+    }
+    return fread(buf, 1, len, stream) == len;
+}
+
+
+/*
+ * xz_index_read - read the block index of an xz compressed file
+ *
+ * Only the stream header, the stream footer and the index at the end of the
+ * file are read: no block is read nor decompressed.
+ *
+ * given:
+ *	index	pointer to the xz_index to fill in
+ *	path	path of the xz file
+ *
+ * returns:
+ *	true ==> index was read, and it is consistent with the file size
+ *	false ==> file cannot be read, is not a single stream xz file, or is corrupt
+ *
+ * NOTE: on false, a warning describing the problem was issued and index
+ *	 need not be freed.  On true, the caller must call free_xz_index().
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+bool
+xz_index_read(struct xz_index *index, char const *path)
+{
+    FILE *stream = NULL;		/* open xz file */
+    struct stat buf;			/* xz file status */
+    uint8_t footer[XZ_STREAM_FOOTER_LEN];	/* stream footer */
+    uint8_t pad[4];			/* stream padding */
+    uint8_t *idx = NULL;		/* malloced index */
+    size_t idx_len;			/* length of the index, including its CRC32 */
+    off_t end;				/* end of the stream, before stream padding */
+    off_t comp_offset;			/* offset of the next block */
+    uintmax_t records = 0;		/* number of index records */
+    uintmax_t unpadded;			/* unpadded size of a block */
+    uintmax_t uncomp;			/* uncompressed size of a block */
+    uintmax_t padded;			/* size of a block with its block padding */
+    struct xz_block block;		/* block being added */
+    size_t i;				/* index into idx */
+    size_t n;				/* bytes used by a variable length integer */
+    uintmax_t r;
+
+    /*
+     * firewall
+     */
+    if (index == NULL || path == NULL) {
+	err(11, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    memset(index, 0, sizeof(*index));
+
+    /*
+     * open the file and read its stream header
+     */
+    errno = 0;		/* pre-clear errno for warnp() */
+    stream = fopen(path, "rb");
+    if (stream == NULL) {
+	warnp(__func__, "cannot open: %s", path);
+	return false;
+    }
+    if (fstat(fileno(stream), &buf) != 0) {
+	warnp(__func__, "cannot fstat: %s", path);
+	fclose(stream);
+	return false;
+    }
+    if (buf.st_size < XZ_STREAM_HEADER_LEN + XZ_STREAM_FOOTER_LEN) {
+	warn(__func__, "too short to be an xz file: %s", path);
+	fclose(stream);
+	return false;
+    }
+    if (!read_at(stream, 0, index->stream_header, XZ_STREAM_HEADER_LEN) ||
+	memcmp(index->stream_header, xz_header_magic, sizeof(xz_header_magic)) != 0 ||
+	xz_crc32(0, index->stream_header + sizeof(xz_header_magic), XZ_STREAM_FLAGS_LEN) !=
+	    get_le32(index->stream_header + sizeof(xz_header_magic) + XZ_STREAM_FLAGS_LEN)) {
+	warn(__func__, "not an xz file or invalid stream header: %s", path);
+	fclose(stream);
+	return false;
+    }
+
+    /*
+     * skip any stream padding, a multiple of 4 NUL bytes, at the end of the file
+     */
+    end = buf.st_size;
+    while (end >= XZ_STREAM_HEADER_LEN + XZ_STREAM_FOOTER_LEN + 4) {
+	if (!read_at(stream, end - 4, pad, sizeof(pad))) {
+	    warnp(__func__, "cannot read: %s", path);
+	    fclose(stream);
+	    return false;
+	}
+	if (pad[0] != 0 || pad[1] != 0 || pad[2] != 0 || pad[3] != 0) {
+	    break;
+	}
+	end -= 4;
+    }
+
+    /*
+     * read and verify the stream footer
+     */
+    if (!read_at(stream, end - XZ_STREAM_FOOTER_LEN, footer, sizeof(footer)) ||
+	memcmp(footer + 10, xz_footer_magic, sizeof(xz_footer_magic)) != 0 ||
+	xz_crc32(0, footer + 4, 6) != get_le32(footer)) {
+	warn(__func__, "invalid xz stream footer: %s", path);
+	fclose(stream);
+	return false;
+    }
+    if (memcmp(footer + 8, index->stream_header + sizeof(xz_header_magic), XZ_STREAM_FLAGS_LEN) != 0) {
+	warn(__func__, "xz stream header and footer flags differ: %s", path);
+	fclose(stream);
+	return false;
+    }
+
+    /*
+     * read the index: its length is given by the backward size of the footer
+     */
+    idx_len = ((size_t)get_le32(footer + 4) + 1) * 4;
+    if ((off_t)idx_len > end - XZ_STREAM_HEADER_LEN - XZ_STREAM_FOOTER_LEN) {
+	warn(__func__, "xz index length: %zu larger than the file: %s", idx_len, path);
+	fclose(stream);
+	return false;
+    }
+    errno = 0;		/* pre-clear errno for errp() */
+    idx = malloc(idx_len);
+    if (idx == NULL) {
+	errp(12, __func__, "malloc of %zu byte xz index failed", idx_len);
+	not_reached();
+    }
+    if (!read_at(stream, end - XZ_STREAM_FOOTER_LEN - (off_t)idx_len, idx, idx_len)) {
+	warnp(__func__, "cannot read xz index: %s", path);
+	free(idx);
+	fclose(stream);
+	return false;
+    }
+    fclose(stream);
+    stream = NULL;
+    if (idx[0] != 0x00 || xz_crc32(0, idx, idx_len - 4) != get_le32(idx + idx_len - 4)) {
+	warn(__func__, "invalid xz index: %s", path);
+	free(idx);
+	return false;
+    }
+
+    /*
+     * decode the index records
+     */
+    index->blocks = dyn_array_create(sizeof(struct xz_block), XZ_BLOCK_CHUNK, XZ_BLOCK_CHUNK, true);
+    i = 1;
+    n = get_vli(idx + i, idx_len - 4 - i, &records);
+    if (n == 0) {
+	warn(__func__, "invalid xz index record count: %s", path);
+	free(idx);
+	free_xz_index(index);
+	return false;
+    }
+    i += n;
+    comp_offset = XZ_STREAM_HEADER_LEN;
+    for (r=0; r < records; ++r) {
+	n = get_vli(idx + i, idx_len - 4 - i, &unpadded);
+	if (n == 0) {
+	    break;
+	}
+	i += n;
+	n = get_vli(idx + i, idx_len - 4 - i, &uncomp);
+	if (n == 0) {
+	    break;
+	}
+	i += n;
+
+	/*
+	 * the sizes are from the file: a block must fit between the blocks
+	 * before it and the index, and the uncompressed sizes must not wrap,
+	 * so that comp_offset stays within the file and no block is larger
+	 * than the file
+	 */
+	padded = (unpadded + 3) & ~(uintmax_t)3;
+	if (unpadded == 0 || padded > (uintmax_t)(end - XZ_STREAM_FOOTER_LEN - (off_t)idx_len - comp_offset)) {
+	    warn(__func__, "xz index record: %ju of %ju: block size: %ju larger than the file: %s",
+			   r, records, unpadded, path);
+	    free(idx);
+	    free_xz_index(index);
+	    return false;
+	}
+	if (uncomp > UINTMAX_MAX - index->uncomp_size) {
+	    warn(__func__, "xz index record: %ju of %ju: uncompressed size: %ju too large: %s",
+			   r, records, uncomp, path);
+	    free(idx);
+	    free_xz_index(index);
+	    return false;
+	}
+
+	block.comp_offset = comp_offset;
+	block.unpadded_size = unpadded;
+	block.uncomp_offset = index->uncomp_size;
+	block.uncomp_size = uncomp;
+	if (dyn_array_append_value(index->blocks, &block)) {
+	    dbg(DBG_VVHIGH, "in %s(): moved data after appending xz block", __func__);
+	}
+	comp_offset += (off_t)padded;
+	index->uncomp_size += uncomp;
+    }
+    if (r < records) {
+	warn(__func__, "truncated xz index record: %ju of %ju: %s", r, records, path);
+	free(idx);
+	free_xz_index(index);
+	return false;
+    }
+
+    /*
+     * the rest of the index before the CRC32 must be the index padding
+     */
+    while (i < idx_len - 4) {
+	if (idx[i++] != 0) {
+	    warn(__func__, "invalid xz index padding: %s", path);
+	    free(idx);
+	    free_xz_index(index);
+	    return false;
+	}
+    }
+    free(idx);
+    idx = NULL;
+
+    /*
+     * the blocks and the index must account for the entire stream,
+     * otherwise the file has more than one stream
+     */
+    if (comp_offset + (off_t)idx_len + XZ_STREAM_FOOTER_LEN != end) {
+	warn(__func__, "not a single stream xz file: %s", path);
+	free_xz_index(index);
+	return false;
+    }
+
+    /*
+     * note the path
+     */
+    errno = 0;		/* pre-clear errno for errp() */
+    index->path = strdup(path);
+    if (index->path == NULL) {
+	errp(13, __func__, "strdup of path failed");
+	not_reached();
+    }
+    index->file_size = buf.st_size;
+    dbg(DBG_MED, "%s: xz index: %jd block(s), %ju uncompressed bytes",
+		 path, dyn_array_tell(index->blocks), index->uncomp_size);
+    return true;
+}
+
+
+/*
+ * xz_index_find - find the block that holds an uncompressed offset
+ *
+ * given:
+ *	index		pointer to an xz_index filled in by xz_index_read()
+ *	uncomp_offset	offset into the uncompressed data
+ *
+ * returns:
+ *	block number, or -1 ==> offset is beyond the uncompressed data
+ *
+ * NOTE: this function does not return on NULL index.
+ */
+intmax_t
+xz_index_find(struct xz_index const *index, uintmax_t uncomp_offset)
+{
+    struct xz_block *block;	/* block being looked at */
+    intmax_t lo;		/* first possible block */
+    intmax_t hi;		/* last possible block */
+    intmax_t mid;
+
+    /*
+     * firewall
+     */
+    if (index == NULL || index->blocks == NULL) {
+	err(14, __func__, "index is NULL or not read");
+	not_reached();
+    }
+    if (uncomp_offset >= index->uncomp_size) {
+	return -1;
+    }
+
+    /*
+     * binary search of the blocks, which are in uncompressed offset order
+     */
+    lo = 0;
+    hi = dyn_array_tell(index->blocks) - 1;
+    while (lo <= hi) {
+	mid = lo + (hi - lo) / 2;
+	block = dyn_array_addr(index->blocks, struct xz_block, mid);
+	if (uncomp_offset < block->uncomp_offset) {
+	    hi = mid - 1;
+	} else if (uncomp_offset >= block->uncomp_offset + block->uncomp_size) {
+	    lo = mid + 1;
+	} else {
+	    return mid;
+	}
+    }
+    return -1;
+}
+
+
+/*
+ * xz_block_decompress - decompress a single block of an xz file
+ *
+ * The block is copied into a temporary single block xz stream, with the
+ * stream header of the original file and an index describing just that
+ * block, which is then decompressed by xz(1).  No other block is read.
+ *
+ * given:
+ *	index	pointer to an xz_index filled in by xz_index_read()
+ *	block	block number to decompress
+ *	xz	path to xz(1)
+ *	len	where to store the length of the decompressed data
+ *
+ * returns:
+ *	malloced decompressed data of the block, or NULL ==> error
+ *
+ * NOTE: on NULL return, a warning describing the problem was issued.
+ *
+ * NOTE: this function does not return on NULL args or an invalid block number.
+ */
+uint8_t *
+xz_block_decompress(struct xz_index const *index, intmax_t block, char const *xz, size_t *len)
+{
+    struct xz_block *b;			/* block to decompress */
+    FILE *in = NULL;			/* open xz file */
+    FILE *out = NULL;			/* open temporary single block stream */
+    FILE *pipe = NULL;			/* pipe from xz -d */
+    char *tmp_path = NULL;		/* path of temporary single block stream */
+    char const *tmpdir = NULL;		/* directory for the temporary file */
+    uint8_t *data = NULL;		/* compressed block, then decompressed data */
+    uint8_t idx[1 + 3*XZ_VLI_MAX_LEN + 3 + 4];	/* single record index */
+    uint8_t footer[XZ_STREAM_FOOTER_LEN];	/* stream footer */
+    size_t padded;			/* block size with block padding */
+    size_t idx_len;			/* length of single record index */
+    size_t out_len = 0;			/* length of decompressed data */
+    int fd = -1;			/* temporary file descriptor */
+    int exit_code;			/* pclose(3) status */
+
+    /*
+     * firewall
+     */
+    if (index == NULL || index->blocks == NULL || index->path == NULL || xz == NULL || len == NULL) {
+	err(15, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    if (block < 0 || block >= dyn_array_tell(index->blocks)) {
+	err(16, __func__, "block: %jd not in range [0, %jd)", block, dyn_array_tell(index->blocks));
+	not_reached();
+    }
+    *len = 0;
+    b = dyn_array_addr(index->blocks, struct xz_block, block);
+    if (b->comp_offset < 0 || b->comp_offset > index->file_size ||
+	((b->unpadded_size + 3) & ~(uintmax_t)3) > (uintmax_t)(index->file_size - b->comp_offset)) {
+	warn(__func__, "block %jd is not within: %s", block, index->path);
+	return NULL;
+    }
+    padded = (size_t)((b->unpadded_size + 3) & ~(uintmax_t)3);
+
+    /*
+     * read the compressed block
+     */
+    errno = 0;		/* pre-clear errno for errp() */
+    data = malloc(padded);
+    if (data == NULL) {
+	errp(17, __func__, "malloc of %zu byte xz block failed", padded);
+	not_reached();
+    }
+    errno = 0;		/* pre-clear errno for warnp() */
+    in = fopen(index->path, "rb");
+    if (in == NULL || !read_at(in, b->comp_offset, data, padded)) {
+	warnp(__func__, "cannot read block %jd of: %s", block, index->path);
+	if (in != NULL) {
+	    fclose(in);
+	}
+	free(data);
+	return NULL;
+    }
+    fclose(in);
+    in = NULL;
+
+    /*
+     * form the single record index and the stream footer
+     */
+    idx_len = 0;
+    idx[idx_len++] = 0x00;
+    idx_len += put_vli(idx + idx_len, 1);
+    idx_len += put_vli(idx + idx_len, b->unpadded_size);
+    idx_len += put_vli(idx + idx_len, b->uncomp_size);
+    while (idx_len % 4 != 0) {
+	idx[idx_len++] = 0x00;
+    }
+    put_le32(idx + idx_len, xz_crc32(0, idx, idx_len));
+    idx_len += 4;
+    put_le32(footer + 4, (uint32_t)(idx_len / 4 - 1));
+    memcpy(footer + 8, index->stream_header + sizeof(xz_header_magic), XZ_STREAM_FLAGS_LEN);
+    put_le32(footer, xz_crc32(0, footer + 4, 6));
+    memcpy(footer + 10, xz_footer_magic, sizeof(xz_footer_magic));
+
+    /*
+     * write the single block stream to a temporary file
+     */
+    tmpdir = getenv("TMPDIR");
+    if (tmpdir == NULL || *tmpdir == '\0') {
+	tmpdir = "/tmp";
+    }
+    errno = 0;		/* pre-clear errno for errp() */
+    tmp_path = calloc(1, strlen(tmpdir) + sizeof("/.xz_block.XXXXXXXXXX"));
+    if (tmp_path == NULL) {
+	errp(18, __func__, "calloc of temporary path failed");
+	not_reached();
+    }
+    sprintf(tmp_path, "%s/.xz_block.XXXXXXXXXX", tmpdir);
+    errno = 0;		/* pre-clear errno for warnp() */
+    fd = mkstemp(tmp_path);
+    if (fd < 0 || (out = fdopen(fd, "wb")) == NULL) {
+	warnp(__func__, "cannot create temporary file: %s", tmp_path);
+	if (fd >= 0) {
+	    close(fd);
+	    (void) unlink(tmp_path);
+	}
+	free(tmp_path);
+	free(data);
+	return NULL;
+    }
+    if (fwrite(index->stream_header, 1, XZ_STREAM_HEADER_LEN, out) != XZ_STREAM_HEADER_LEN ||
+	fwrite(data, 1, padded, out) != padded ||
+	fwrite(idx, 1, idx_len, out) != idx_len ||
+	fwrite(footer, 1, sizeof(footer), out) != sizeof(footer) ||
+	fclose(out) != 0) {
+	warnp(__func__, "cannot write temporary file: %s", tmp_path);
+	(void) unlink(tmp_path);
+	free(tmp_path);
+	free(data);
+	return NULL;
+    }
+    free(data);
+    data = NULL;
+
+    /*
+     * decompress the single block stream
+     */
+    dbg(DBG_HIGH, "about to perform: %s -d -c -q -- %s", xz, tmp_path);
+    pipe = pipe_open(__func__, false, false, "% -d -c -q -- %", xz, tmp_path);
+    if (pipe == NULL) {
+	warnp(__func__, "cannot run: %s -d -c -q -- %s", xz, tmp_path);
+    } else {
+	data = read_all(pipe, &out_len);
+	exit_code = pclose(pipe);
+	if (data == NULL || exit_code != 0 || out_len != b->uncomp_size) {
+	    warn(__func__, "%s failed to decompress block %jd of: %s: exit code: %d length: %zu != %ju",
+			   xz, block, index->path, WEXITSTATUS(exit_code), out_len, b->uncomp_size);
+	    if (data != NULL) {
+		free(data);
+		data = NULL;
+	    }
+	} else {
+	    *len = out_len;
+	}
+    }
+    (void) unlink(tmp_path);
+    free(tmp_path);
+    return data;
+}
+
+
+/*
+ * free_xz_index - free storage of an xz_index
+ *
+ * given:
+ *	index	pointer to an xz_index
+ *
+ * NOTE: this function does nothing if index is NULL.
+ */
+void
+free_xz_index(struct xz_index *index)
+{
+    if (index == NULL) {
+	return;
+    }
+    if (index->blocks != NULL) {
+	dyn_array_free(index->blocks);
+	index->blocks = NULL;
+    }
+    if (index->path != NULL) {
+	free(index->path);
+	index->path = NULL;
+    }
+    index->uncomp_size = 0;
+    index->file_size = 0;
+    return;
+}
@@ -0,0 +1,119 @@
+/*
+ * xz_index - random access to the blocks of an xz compressed file
+ *
+ * "Because sometimes you only want one feather out of the ball of tar." :-)
+ *
+ * Copyright (c) 2026 by Cody Boone Ferguson and Landon Curt Noll. All
+ * rights reserved.
+ *
+ * Permission to use, copy, modify, and distribute this software and
+ * its documentation for any purpose and without fee is hereby granted,
+ * provided that the above copyright, this permission notice and text
+ * this comment, and the disclaimer below appear in all of the following:
+ *
+ *       supporting documentation
+ *       source copies
+ *       source works derived from this source
+ *       binaries derived from this source or from derived source
+ *
+ * THE AUTHORS DISCLAIM ALL WARRANTIES WITH REGARD TO THIS SOFTWARE, INCLUDING
+ * ALL IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE
+ * AUTHORS BE LIABLE FOR ANY SPECIAL, INDIRECT OR CONSEQUENTIAL DAMAGES OR ANY
+ * DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF OR IN
+ * CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * This tool and the JSON parser were co-developed in 2022-2026 by Cody Boone
+ * Ferguson and Landon Curt Noll:
+ *
+ *  @xexyl
+ *	https://xexyl.net		Cody Boone Ferguson
+ *	https://ioccc.xexyl.net
+ * and:
+ *	chongo (Landon Curt Noll, http://www.isthe.com/chongo/index.html) /\oo/\
+ *
+ * "Because sometimes even the IOCCC Judges need some help." :-)
+ *
+ * "Share and Enjoy!"
+ *     --  Sirius Cybernetics Corporation Complaints Division, JSON spec department. :-)
+ */
+
+
+#if !defined(INCLUDE_XZ_INDEX_H)
+#    define  INCLUDE_XZ_INDEX_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/*
+ * dbg - info, debug, warning, error, and usage message facility
+ */
+#include "../dbg/dbg.h"
+
+/*
+ * dyn_array - dynamic array facility
+ */
+#include "../dyn_array/dyn_array.h"
+
+
+/*
+ * xz file format definitions - see The .xz File Format, version 1.2.1
+ */
+#define XZ_STREAM_HEADER_LEN (12)		/* length of a stream header */
+#define XZ_STREAM_FOOTER_LEN (12)		/* length of a stream footer */
+#define XZ_STREAM_FLAGS_LEN (2)			/* length of the stream flags */
+#define XZ_VLI_MAX_LEN (9)			/* max length of an encoded variable length integer */
+#define XZ_INDEX_MAX_LEN ((uintmax_t)1 << 34)	/* max length of an index, from the backward size field */
+#define XZ_BLOCK_CHUNK (16)			/* number of xz_block structures to allocate at a time */
+
+/*
+ * xz block size used by mkiocccentry when it forms a compressed tarball
+ *
+ * Small enough that a single member of a typical submission tarball can be
+ * extracted without decompressing the whole tarball, large enough that the
+ * compressed tarball is not noticeably larger than a single block one.
+ */
+#define XZ_TARBALL_BLOCK_SIZE (64*1024)
+
+
+/*
+ * xz_block - location of a single xz block in both the compressed file and the uncompressed data
+ */
+struct xz_block
+{
+    off_t comp_offset;				/* offset of the block header in the compressed file */
+    uintmax_t unpadded_size;			/* block size w/o the block padding, as recorded in the index */
+    uintmax_t uncomp_offset;			/* offset of the first uncompressed byte of the block */
+    uintmax_t uncomp_size;			/* number of uncompressed bytes in the block */
+};
+
+
+/*
+ * xz_index - block index of an xz compressed file
+ *
+ * NOTE: only single stream xz files (with optional stream padding) are
+ *	 supported, which is what xz(1) and tar -J produce.
+ */
+struct xz_index
+{
+    char *path;					/* malloced path of the xz file */
+    off_t file_size;				/* size of the xz file in bytes */
+    uint8_t stream_header[XZ_STREAM_HEADER_LEN];	/* stream header, including the stream flags */
+    uintmax_t uncomp_size;			/* total size of the uncompressed data */
+    struct dyn_array *blocks;			/* struct xz_block for each block in file order */
+};
+
+
+/*
+ * external function declarations
+ */
+extern uint32_t xz_crc32(uint32_t crc, void const *buf, size_t len);
+extern bool xz_index_read(struct xz_index *index, char const *path);
+extern intmax_t xz_index_find(struct xz_index const *index, uintmax_t uncomp_offset);
+extern uint8_t *xz_block_decompress(struct xz_index const *index, intmax_t block, char const *xz, size_t *len);
+extern void free_xz_index(struct xz_index *index);
+
+
+#endif /* INCLUDE_XZ_INDEX_H */
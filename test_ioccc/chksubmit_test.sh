@@ -54,7 +54,7 @@ export EXIT_CODE=0
 export INVALID_DIRECTORY_FOUND=""
 export WORKDIR="./test_ioccc/workdir"
 
-export CHKSUBMIT_TEST_VERSION="2.1.3 2025-11-08"
+export CHKSUBMIT_TEST_VERSION="2.1.4 2026-10-19"
 
 export USAGE="usage: $0 [-h] [-V] [-v level] [-D dbg_level] [-q] [-c chksubmit] [-C chkentry] [-d workdir]
 
@@ -426,6 +426,96 @@ run_bad_test()
     return
 }
 
+# run_cache_test - run chkentry twice on a directory through the chkentry result cache
+#
+# usage:
+#	run_cache_test chkentry pass|fail directory
+#
+#	chkentry		path to the chkentry program
+#	pass|fail		pass ==> chkentry must exit 0, fail ==> chkentry must not exit 0
+#	workdir		        directory to check
+#
+# The first run must check the directory and, unless chkentry exits with an
+# error other than a failed check (which is never cached), store exactly one
+# new cache entry.  To prove that the second run replays that cache entry rather
+# than checking the directory again, a marker is appended to the cache entry, as
+# one more line of stderr, before the second run: the second run must exit the
+# same way as the first, write the same stdout and write the same stderr with
+# the marker line at the end of the cached report, without storing a cache entry.
+#
+# The return code of this function is non-zero if an internal error occurs.
+#
+run_cache_test()
+{
+    # parse args
+    #
+    if [[ $# -ne 3 ]]; then
+	echo "$0: ERROR: expected 3 args to run_cache_test, found $#" 1>&2
+	exit 12
+    fi
+    declare chkentry="$1"
+    declare expect="$2"
+    declare workdir="$3"
+    declare marker="chksubmit_test.sh: replayed from the result cache"
+    declare before
+    declare entry
+    declare status
+    declare replay_status
+
+    # perform the check that stores the cache entry
+    #
+    if [[ $V_FLAG -ge 3 ]]; then
+	echo "$0: debug[3]: about to run cache test that must $expect: $chkentry -S -C $CACHE_DIR -- $workdir" 1>&2
+    fi
+    before=$(find "$CACHE_DIR" -type f -print | sort)
+    "$chkentry" -S -C "$CACHE_DIR" -- "$workdir" > "$CACHE_OUT.store" 2> "$CACHE_ERR.store"
+    status="$?"
+    if [[ $expect == pass && $status -ne 0 ]] || [[ $expect == fail && $status -eq 0 ]]; then
+	echo "$0: cache test $workdir should $expect: chkentry -S -C exit code: $status" | tee -a -- "${LOGFILE}"
+	EXIT_CODE=1
+	return
+    fi
+    entry=$(comm -13 <(echo "$before") <(find "$CACHE_DIR" -type f -print | sort))
+    if [[ $status -ne 0 && $status -ne 1 ]]; then
+	if [[ -n $entry ]]; then
+	    echo "$0: cache test $workdir: chkentry -S -C exit code: $status was cached" | tee -a -- "${LOGFILE}"
+	    EXIT_CODE=1
+	else
+	    echo "$0: cache test $workdir should $expect: chkentry -S -C exit code: $status was not cached" | tee -a -- "${LOGFILE}"
+	fi
+	return
+    fi
+    if [[ -z $entry || $entry == *$'\n'* ]]; then
+	echo "$0: cache test $workdir: chkentry -S -C did not add exactly one cache entry to: $CACHE_DIR" | tee -a -- "${LOGFILE}"
+	EXIT_CODE=1
+	return
+    fi
+    printf 'stderr %d\n%s\n' "$(( ${#marker} + 1 ))" "$marker" >> "$entry"
+
+    # perform the check that must replay the cache entry
+    #
+    before=$(find "$CACHE_DIR" -type f -print | sort)
+    "$chkentry" -S -C "$CACHE_DIR" -- "$workdir" > "$CACHE_OUT.replay" 2> "$CACHE_ERR.replay"
+    replay_status="$?"
+    if [[ $replay_status -ne $status ]]; then
+	echo "$0: cache test $workdir: chkentry -S -C replay exit code: $replay_status != $status" | tee -a -- "${LOGFILE}"
+	EXIT_CODE=1
+    elif ! cmp -s "$CACHE_OUT.store" "$CACHE_OUT.replay" || ! grep -q -x -F -- "$marker" "$CACHE_ERR.replay" ||
+	 ! grep -v -x -F -- "$marker" "$CACHE_ERR.replay" | cmp -s "$CACHE_ERR.store" -; then
+	echo "$0: cache test $workdir: chkentry -S -C replay did not write what was cached" | tee -a -- "${LOGFILE}"
+	EXIT_CODE=1
+    elif [[ $(find "$CACHE_DIR" -type f -print | sort) != "$before" ]]; then
+	echo "$0: cache test $workdir: chkentry -S -C replay changed the cache entries of: $CACHE_DIR" | tee -a -- "${LOGFILE}"
+	EXIT_CODE=1
+    else
+	echo "$0: cache test $workdir should $expect: chkentry -S -C replayed exit code: $status" | tee -a -- "${LOGFILE}"
+    fi
+
+    # return
+    #
+    return
+}
+
 # run tests that must pass: good
 #
 if [[ $V_FLAG -ge 3 ]]; then
@@ -445,6 +535,28 @@ while read -r dir; do
     run_bad_test "$CHKSUBMIT" "$CHKENTRY" "$DBG_LEVEL" "$Q_FLAG" "$dir"
 done < <(find "$BAD_TREE" -mindepth 1 -maxdepth 1 -type d -print)
 
+# run the tests through the chkentry result cache
+#
+CACHE_DIR=$(mktemp -d .chksubmit_test.cache.XXXXXXXXXX)
+status="$?"
+if [[ $status -ne 0 ]]; then
+    echo "$0: ERROR: mktemp -d .chksubmit_test.cache.XXXXXXXXXX exit code: $status" 1>&2
+    exit 14
+fi
+CACHE_OUT="$CACHE_DIR.stdout"
+CACHE_ERR="$CACHE_DIR.stderr"
+if [[ $V_FLAG -ge 3 ]]; then
+    echo "$0: debug[3]: about to run chkentry result cache tests" | tee -a -- "${LOGFILE}"
+fi
+while read -r dir; do
+    run_cache_test "$CHKENTRY" pass "$dir"
+done < <(find "$GOOD_TREE" -mindepth 1 -maxdepth 1 -type d -print)
+while read -r dir; do
+    run_cache_test "$CHKENTRY" fail "$dir"
+done < <(find "$BAD_TREE" -mindepth 1 -maxdepth 1 -type d -print)
+rm -rf "$CACHE_DIR"
+rm -f "$CACHE_OUT".store "$CACHE_OUT".replay "$CACHE_ERR".store "$CACHE_ERR".replay
+
 # determine exit code
 #
 if [[ $EXIT_CODE -ne 0 ]]; then
@@ -0,0 +1 @@
+char str[] = "string /* with */ comment";
@@ -93,7 +93,7 @@ TAR="$(type -P tar 2>/dev/null)"
 # but due to the reasons cited above we must rely on the more complicated form:
 [[ -z "$TAR" ]] && TAR="/usr/bin/tar"
 
-export TXZCHK_TEST_VERSION="2.0.2 2025-11-15"
+export TXZCHK_TEST_VERSION="2.0.3 2026-10-19"
 export FNAMCHK="./test_ioccc/fnamchk"
 export TXZCHK="./txzchk"
 export TXZCHK_TREE="./test_ioccc/test_txzchk"
@@ -434,12 +434,18 @@ if [[ ! -w "$TMP_STDERR_FILE" ]]; then
     exit 36
 fi
 
+# We need a directory for the txzchk -C cachedir result cache test. txzchk
+# creates the directory itself so we only need an unused name.
+TMP_CACHE_DIR=$(mktemp -u .txzchk_test.cache.XXXXXXXXXX)
+# delete the temporary directory in the off chance it already exists
+rm -rf "$TMP_CACHE_DIR"
+
 # remove or keep (some) temporary files
 #
 if [[ -z $K_FLAG ]]; then
-    trap "rm -f \$TARBALL \$TEST_FILE \$TAR_ERROR \$TMP_STDERR_FILE; exit" 0 1 2 3 15
+    trap "rm -f \$TARBALL \$TEST_FILE \$TAR_ERROR \$TMP_STDERR_FILE; rm -rf \$TMP_CACHE_DIR \$BLOCK_TEST_DIR; exit" 0 1 2 3 15
 else
-    trap "rm -f \$TARBALL \$TEST_FILE \$TAR_ERROR \$TMP_STDERR_FILE; exit" 1 2 3 15
+    trap "rm -f \$TARBALL \$TEST_FILE \$TAR_ERROR \$TMP_STDERR_FILE; rm -rf \$TMP_CACHE_DIR \$BLOCK_TEST_DIR; exit" 1 2 3 15
 fi
 
 # run tar test
@@ -470,6 +476,173 @@ else
     TAR_TEST_SUCCESS=
 fi
 
+# put_le32 - print a 32 bit value as 4 little endian bytes
+#
+# usage:
+#	put_le32 value
+#
+put_le32()
+{
+    declare value="$1"
+    declare i
+
+    for ((i = 0; i < 4; ++i)); do
+	printf "\\$(printf '%03o' $(( (value >> (8 * i)) & 255 )))"
+    done
+}
+
+# put_xz_vli - print a value as an xz variable length integer
+#
+# usage:
+#	put_xz_vli value
+#
+#	value		    - value to print, < 2^63
+#
+put_xz_vli()
+{
+    declare value="$1"
+
+    while (( value >= 128 )); do
+	printf "\\$(printf '%03o' $(( (value & 127) | 128 )))"
+	(( value >>= 7 ))
+    done
+    printf "\\$(printf '%03o' "$value")"
+}
+
+# xz_crc32 - print the CRC32 of a file, as xz(1) forms it
+#
+# usage:
+#	xz_crc32 file
+#
+xz_crc32()
+{
+    declare crc=$((0xFFFFFFFF))
+    declare byte
+    declare i
+
+    for byte in $(od -An -v -tu1 -- "$1"); do
+	(( crc ^= byte ))
+	for ((i = 0; i < 8; ++i)); do
+	    if (( crc & 1 )); then
+		(( crc = (crc >> 1) ^ 0xEDB88320 ))
+	    else
+		(( crc >>= 1 ))
+	    fi
+	done
+    done
+    echo $(( crc ^ 0xFFFFFFFF ))
+}
+
+# run xz block index test
+#
+# Form a multi-block compressed tarball and verify that txzchk -B can map it
+# and that txzchk -X extracts each file, decompressing only the xz blocks it
+# needs, exactly as it was put into the tarball.
+#
+if [[ -n $TAR_TEST_SUCCESS ]]; then
+    BLOCK_TEST_DIR=$(mktemp -d .txzchk_test.block_dir.XXXXXXXXXX)
+    status="$?"
+    if [[ $status -ne 0 ]]; then
+	echo "$0: ERROR: mktemp -d .txzchk_test.block_dir.XXXXXXXXXX exit code: $status" 1>&2
+	EXIT_CODE=1
+    else
+	mkdir -p "$BLOCK_TEST_DIR/submit" && cp -f txzchk.c soup/walk_util.c "$TEST_FILE" "$BLOCK_TEST_DIR/submit"
+	(cd "$BLOCK_TEST_DIR" && XZ_OPT=--block-size=16384 "${TAR}" --format=v7 -cJf block.txz submit) 2>"$TAR_ERROR"
+	status="$?"
+	if [[ $status -ne 0 ]]; then
+	    echo "$0: ERROR: XZ_OPT=--block-size=16384 $TAR --format=v7 -cJf block.txz submit exit code: $status" 1>&2
+	    EXIT_CODE=1
+	elif ! "$TXZCHK" -B -- "$BLOCK_TEST_DIR/block.txz" > "$BLOCK_TEST_DIR/block.map"; then
+	    echo "$0: ERROR: $TXZCHK -B -- $BLOCK_TEST_DIR/block.txz failed" 1>&2
+	    EXIT_CODE=1
+	else
+	    for file in "$BLOCK_TEST_DIR"/submit/*; do
+		name=$(basename -- "$file")
+		if [[ $V_FLAG -ge 5 ]]; then
+		    echo "$0: debug[5]: about to run: $TXZCHK -X $name -- $BLOCK_TEST_DIR/block.txz" 1>&2
+		fi
+		if ! "$TXZCHK" -X "$name" -- "$BLOCK_TEST_DIR/block.txz" | cmp -s - "$file"; then
+		    echo "$0: ERROR: $TXZCHK -X $name -- $BLOCK_TEST_DIR/block.txz does not match: $file" | tee -a -- "$LOGFILE" 1>&2
+		    EXIT_CODE=1
+		fi
+	    done
+	    if "$TXZCHK" -X no-such-file -- "$BLOCK_TEST_DIR/block.txz" >/dev/null 2>&1; then
+		echo "$0: ERROR: $TXZCHK -X no-such-file -- $BLOCK_TEST_DIR/block.txz did not fail" | tee -a -- "$LOGFILE" 1>&2
+		EXIT_CODE=1
+	    fi
+
+	    # a GNU long name (type L) header whose size says the name is 8 GiB long
+	    # must be rejected with a warning, not allocated
+	    #
+	    LONG_NAME_TAR="$BLOCK_TEST_DIR/long_name.tar"
+	    {
+		printf '././@LongLink'; head -c 111 /dev/zero
+		printf '77777777777\0'; head -c 12 /dev/zero
+		printf '        L'; head -c 355 /dev/zero
+		head -c 1024 /dev/zero
+	    } > "$LONG_NAME_TAR"
+	    sum=0
+	    for byte in $(head -c 512 -- "$LONG_NAME_TAR" | od -An -v -tu1); do
+		((sum += byte))
+	    done
+	    printf '%06o\0 ' "$sum" | dd of="$LONG_NAME_TAR" bs=1 seek=148 conv=notrunc 2>/dev/null
+	    xz -c -- "$LONG_NAME_TAR" > "$LONG_NAME_TAR.xz"
+	    "$TXZCHK" -B -- "$LONG_NAME_TAR.xz" > /dev/null 2>"$TAR_ERROR"
+	    status="$?"
+	    if [[ $status -ne 1 ]] || ! grep -q 'GNU long name at offset 512 has invalid size' -- "$TAR_ERROR"; then
+		echo "$0: ERROR: $TXZCHK -B -- $LONG_NAME_TAR.xz exit code: $status != 1 or no invalid size warning" | \
+		    tee -a -- "$LOGFILE" 1>&2
+		cat -- "$TAR_ERROR" 1>&2
+		EXIT_CODE=1
+	    fi
+
+	    # an xz index whose block sizes wrap around to add up to the size of
+	    # the file must be rejected, not trusted to read a block of 8 EiB:
+	    # the blocks of the tarball are claimed to be 2^63-4, 2^63-4 and their
+	    # size + 8 bytes long
+	    #
+	    HUGE_XZ="$BLOCK_TEST_DIR/huge_block.txz"
+	    XZ_SIZE=$(wc -c < "$TARBALL")
+	    read -r b0 b1 b2 b3 < <(tail -c 8 -- "$TARBALL" | od -An -v -tu1 -N 4)
+	    XZ_IDX_LEN=$(( ((b0 | (b1 << 8) | (b2 << 16) | (b3 << 24)) + 1) * 4 ))
+	    XZ_BLOCKS_LEN=$(( XZ_SIZE - 12 - XZ_IDX_LEN - 12 ))
+	    {
+		printf '\0'
+		put_xz_vli 3
+		put_xz_vli $(( (1 << 63) - 4 )); put_xz_vli 10240
+		put_xz_vli $(( (1 << 63) - 4 )); put_xz_vli 0
+		put_xz_vli $(( XZ_BLOCKS_LEN + 8 )); put_xz_vli 0
+	    } > "$HUGE_XZ.idx"
+	    while (( $(wc -c < "$HUGE_XZ.idx") % 4 != 0 )); do
+		printf '\0' >> "$HUGE_XZ.idx"
+	    done
+	    put_le32 "$(xz_crc32 "$HUGE_XZ.idx")" >> "$HUGE_XZ.idx"
+	    {
+		put_le32 $(( $(wc -c < "$HUGE_XZ.idx") / 4 - 1 ))
+		head -c 8 -- "$TARBALL" | tail -c 2
+	    } > "$HUGE_XZ.footer"
+	    {
+		head -c $(( 12 + XZ_BLOCKS_LEN )) -- "$TARBALL"
+		cat -- "$HUGE_XZ.idx"
+		put_le32 "$(xz_crc32 "$HUGE_XZ.footer")"
+		cat -- "$HUGE_XZ.footer"
+		printf 'YZ'
+	    } > "$HUGE_XZ"
+	    "$TXZCHK" -B -- "$HUGE_XZ" > /dev/null 2>"$TAR_ERROR"
+	    status="$?"
+	    if [[ $status -ne 1 ]] || ! grep -q 'xz index record: 0 of 3: block size: .* larger than the file' -- "$TAR_ERROR"; then
+		echo "$0: ERROR: $TXZCHK -B -- $HUGE_XZ exit code: $status != 1 or no block size warning" | \
+		    tee -a -- "$LOGFILE" 1>&2
+		cat -- "$TAR_ERROR" 1>&2
+		EXIT_CODE=1
+	    fi
+	fi
+	if [[ -z $K_FLAG ]]; then
+	    rm -rf "$BLOCK_TEST_DIR"
+	fi
+    fi
+fi
+
 # tar test clean up
 #
 if [[ -n $TAR_TEST_SUCCESS ]]; then
@@ -633,6 +806,98 @@ run_test()
     return
 }
 
+# run_cache_test - run a single test twice through the txzchk result cache
+#
+# The first run must check the tarball and store exactly one new entry in the
+# cache, and both runs must exit 1.  To prove that the second run replays the
+# cache entry rather than checking the tarball again, a marker is appended to
+# the cache entry, as one more chunk of stderr, before the second run: the first
+# run must report exactly what the error file expects and the second run must
+# report that followed by the marker.
+#
+# usage:
+#	run_cache_test txzchk_test_file
+#
+#	run_cache_test	    - our function name
+#	txzchk_test_file    - the txzchk text file, that must fail, to give to txzchk
+#
+run_cache_test()
+{
+    # parse args
+    #
+    if [[ $# -ne 1 ]]; then
+	echo "$0: ERROR: expected 1 arg to run_cache_test, found $#" 1>&2
+	exit 43
+    fi
+    declare txzchk_test_file="$1"
+    declare txzchk_err_file="$txzchk_test_file.err"
+    declare marker="txzchk_test.sh: replayed from the result cache"
+    declare run
+    declare before
+    declare entry
+    declare expected
+
+    test_mode=""
+    if [[ "$txzchk_test_file" =~ submit.test* ]]; then
+	test_mode="-x"
+    fi
+
+    for run in store replay; do
+	before=$(find "$TMP_CACHE_DIR" -type f -print | sort)
+	if [[ $V_FLAG -ge 5 ]]; then
+	    echo "$0: debug[5]: in run_cache_test: $run: $TXZCHK $test_mode -w -v 0 -F $FNAMCHK -t $TAR -T -E txt -C $TMP_CACHE_DIR -- $txzchk_test_file 2>$TMP_STDERR_FILE" 1>&2
+	fi
+	if [[ -n "$test_mode" ]]; then
+	    "$TXZCHK" "-x" -w -v 0 -F "$FNAMCHK" -t "$TAR" -T -E txt -C "$TMP_CACHE_DIR" -- "$txzchk_test_file" 2>"$TMP_STDERR_FILE"
+	else
+	    "$TXZCHK" -w -v 0 -F "$FNAMCHK" -t "$TAR" -T -E txt -C "$TMP_CACHE_DIR" -- "$txzchk_test_file" 2>"$TMP_STDERR_FILE"
+	fi
+	status="$?"
+	if [[ $status -ne 1 ]]; then
+	    echo "$0: Warning: in run_cache_test: FAIL: $run: $TXZCHK $test_mode -w -v 0 -t $TAR -F $FNAMCHK -T -E txt -C $TMP_CACHE_DIR $txzchk_test_file exit code: $status != 1" | tee -a -- "$LOGFILE" 1>&2
+	    EXIT_CODE=1
+	fi
+
+	# the store run must add exactly one cache entry, to which we append the marker
+	#
+	if [[ $run == store ]]; then
+	    entry=$(comm -13 <(echo "$before") <(find "$TMP_CACHE_DIR" -type f -print | sort))
+	    if [[ -z $entry || $entry == *$'\n'* ]]; then
+		echo "$0: Warning: in run_cache_test: FAIL: store: $txzchk_test_file did not add exactly one cache entry to: $TMP_CACHE_DIR" | tee -a -- "$LOGFILE" 1>&2
+		EXIT_CODE=1
+		return
+	    fi
+	    expected="$txzchk_err_file"
+	    printf 'stderr %d\n%s' "${#marker}" "$marker" >> "$entry"
+
+	# the replay run must not add a cache entry, and must report the marker too
+	#
+	else
+	    if [[ $(find "$TMP_CACHE_DIR" -type f -print | sort) != "$before" ]]; then
+		echo "$0: Warning: in run_cache_test: FAIL: replay: $txzchk_test_file changed the cache entries of: $TMP_CACHE_DIR" | tee -a -- "$LOGFILE" 1>&2
+		EXIT_CODE=1
+	    fi
+	    expected="$TMP_STDERR_FILE.expected"
+	    { cat -- "$txzchk_err_file"; printf '%s' "$marker"; } > "$expected"
+	fi
+	if ! cmp -s "$expected" "$TMP_STDERR_FILE"; then
+	    echo "$0: Warning: in run_cache_test: FAIL: $run: $TXZCHK $test_mode -w -v 0 -t $TAR -F $FNAMCHK -T -E txt -C $TMP_CACHE_DIR $txzchk_test_file" | tee -a -- "$LOGFILE" 1>&2
+	    echo "$0: Warning: in run_cache_test: expected errors: $expected do not match result of test: $TMP_STDERR_FILE" 1>&2
+	    if [[ $V_FLAG -ge 1 ]]; then
+		echo "$0: Warning: diff -u $expected $TMP_STDERR_FILE starts below" 1>&2
+		diff -u "$expected" "$TMP_STDERR_FILE" 1>&2
+		echo "$0: Warning: diff -u $expected $TMP_STDERR_FILE ends above" 1>&2
+	    fi
+	    EXIT_CODE=1
+	fi
+    done
+    rm -f "$TMP_STDERR_FILE.expected"
+
+    # return
+    #
+    return
+}
+
 # run txzchk tests
 #
 
@@ -655,10 +920,20 @@ while read -r file; do
     run_test fail "$file"
 done < <(find "$TXZCHK_BAD_TREE" -type f -name '*.txt' -print)
 
+# run tests that must fail through the result cache
+#
+if [[ $V_FLAG -ge 3 ]]; then
+    echo "$0: debug[3]: about to run txzchk result cache tests: text files" 1>&2
+fi
+while read -r file; do
+    run_cache_test "$file"
+done < <(find "$TXZCHK_BAD_TREE" -type f -name '*.txt' -print)
+
 # explicitly delete the temporary files
 
 if [[ -z $K_FLAG ]]; then
     rm -f "$TARBALL" "$TEST_FILE" "$TAR_ERROR" "$TMP_STDERR_FILE"
+    rm -rf "$TMP_CACHE_DIR"
 else
     echo
     echo "$0: keeping temporary files due to use of -k"
@@ -679,6 +954,12 @@ else
 	echo -n " $TMP_STDERR_FILE"
     fi
     echo
+    if [[ -e $TMP_CACHE_DIR ]]; then
+	echo "rm -rf $TMP_CACHE_DIR"
+    fi
+    if [[ -n $BLOCK_TEST_DIR && -e $BLOCK_TEST_DIR ]]; then
+	echo "rm -rf $BLOCK_TEST_DIR"
+    fi
 fi
 
 # All Done!!! All Done!!! -- Jessica Noll, Age 2
@@ -116,7 +116,8 @@ static struct txz_file *txz_files;		/* linked list of the files in the tarball *
  * Use the usage() function to print the usage_msg([0-9]?)+ strings.
  */
 static const char * const usage_msg =
-    "usage: %s [-h] [-v level] [-q] [-e] [-f feathers] [-w] [-V] [-t tar] [-F fnamchk] [-T] [-E ext] [-x] tarball_path\n"
+    "usage: %s [-h] [-v level] [-q] [-e] [-f feathers] [-w] [-V] [-t tar] [-F fnamchk] [-T] [-E ext] [-x]\n"
+    "\t\t[-C cachedir] [-B] [-X member] [-z xz] tarball_path\n"
     "\n"
     "\t-h\t\tprint help message and exit\n"
     "\t-v level\tset verbosity level: (def level: %d)\n"
@@ -132,12 +133,19 @@ static const char * const usage_msg =
     "\t\t\t    different formats)\n"
     "\t-E ext\t\tchange extension to test (def: txz)\n"
     "\t-x\t\tforce fnamchk -t even if -T is not used\n"
+    "\t-C cachedir\tcache verdicts and reports in cachedir, replay them for an unchanged tarball\n"
+    "\t\t\t    (def: do not cache)\n"
+    "\t-B\t\tprint the xz block map of tarball_path and the blocks of each member, do not check it\n"
+    "\t-X member\twrite member of tarball_path to stdout, decompressing only the xz blocks needed,\n"
+    "\t\t\t    do not check it (member may omit the top level directory)\n"
+    "\t-z xz\t\tpath to xz executable used by -B and -X (def: %s)\n"
     "\n"
     "\ttarball_path\tpath to an IOCCC compressed tarball\n"
     "\n"
     "Exit codes:\n"
     "     0   no feathers stuck in tarball :-)\n"
     "     1   tarball was successfully parsed :-) but there's at least one feather stuck in it :-(\n"
+    "         or with -B or -X: the xz index or tar headers cannot be read, or member was not found\n"
     "     2   -h and help string printed or -V and version string printed\n"
     "     3   invalid command line, invalid option or option missing an argument\n"
     " >= 10   internal error has occurred or unknown tar listing format has been encountered\n"
@@ -166,6 +174,13 @@ main(int argc, char **argv)
     bool found_fnamchk = false;                 /* for find_utils */
     bool opt_error = false;			/* fchk_inval_opt() return */
     enum path_sanity sanity = PATH_ERR_UNSET;	/* canon_path error or PATH_OK */
+    char *cachedir = NULL;			/* -C cachedir, NULL ==> no result cache */
+    struct result_cache cache;			/* result cache state */
+    intmax_t cached_feathers = 0;		/* feathers of a cached result */
+    bool block_map = false;			/* true ==> -B used, print xz block map */
+    char const *member = NULL;			/* -X member, member to extract */
+    char *xz = NULL;				/* -z xz, path to xz executable */
+    int exit_code;				/* -B or -X exit code */
 
     /* IOCCC requires use of C locale */
     set_ioccc_locale();
@@ -174,7 +189,7 @@ main(int argc, char **argv)
      * parse args
      */
     program = argv[0];
-    while ((i = getopt(argc, argv, ":hv:qVF:t:TE:wef:x")) != -1) {
+    while ((i = getopt(argc, argv, ":hv:qVF:t:TE:wef:xC:BX:z:")) != -1) {
 	switch (i) {
 	case 'h':		/* -h - print help to stderr and exit 2 */
 	    usage(2, program, ""); /*ooo*/
@@ -229,6 +244,18 @@ main(int argc, char **argv)
         case 'x':   /* when mkiocccentry UUID is "test" we need this */
             test_mode = true;
             break;
+	case 'C': /* -C cachedir - cache verdicts and reports in cachedir */
+	    cachedir = optarg;
+	    break;
+	case 'B': /* -B - print xz block map */
+	    block_map = true;
+	    break;
+	case 'X': /* -X member - extract member */
+	    member = optarg;
+	    break;
+	case 'z': /* -z xz - specify path to xz */
+	    xz = optarg;
+	    break;
 	case ':': /* option requires an argument */
 	case '?': /* illegal option */
 	default:  /* anything else but should not actually happen */
@@ -255,6 +282,29 @@ main(int argc, char **argv)
 	not_reached();
     }
     dbg(DBG_MED, "tarball path: %s", tarball_path);
+
+    /*
+     * case: -B or -X: random access to the compressed tarball rather than checking it
+     */
+    if (block_map || member != NULL) {
+	if (read_from_text_file) {
+	    usage(3, program, "cannot use -T with -B or -X"); /*ooo*/
+	    not_reached();
+	}
+	if (block_map && member != NULL) {
+	    usage(3, program, "cannot use -B with -X"); /*ooo*/
+	    not_reached();
+	}
+	xz = find_xz(xz);
+	if (block_map) {
+	    exit_code = txz_block_map(tarball_path, xz);
+	} else {
+	    exit_code = txz_extract(tarball_path, xz, member);
+	}
+	free(xz);
+	xz = NULL;
+	exit(exit_code); /*ooo*/
+    }
     dbg(DBG_MED, "fnamchk test mode: %s", booltostr(test_mode));
     dbg(DBG_MED, "entertainment mode: %s", booltostr(entertain));
 
@@ -316,18 +366,52 @@ main(int argc, char **argv)
 	para("", "Looking for feathers in tarball ...", NULL);
     }
 
-    tarball.total_feathers = check_tarball(tar, fnamchk);
-    if (entertain) {
-	if (!tarball.total_feathers) {
-	    para("No feathers stuck in tarball.", NULL);
-	} else {
-	    if (tarball.total_feathers >= feathery) {
-		para("\n... looks like someone has been throwing feathers",
-		     "about, because that is quite a feathery ball of tar!", NULL);
+    /*
+     * if -C cachedir was used, key the result cache by the tool versions,
+     * the txzchk, tar and fnamchk executables, every option that can change
+     * the report, the tarball name and the tarball contents
+     */
+    result_cache_init(&cache, cachedir, TXZCHK_BASENAME, TXZCHK_VERSION, MKIOCCCENTRY_REPO_VERSION,
+		      JPARSE_UTILS_VERSION, JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION, FNAMCHK_VERSION, NULL);
+    result_cache_add_tool(&cache, program);
+    if (!read_from_text_file) {
+	result_cache_add_tool(&cache, tar);
+    }
+    result_cache_add_tool(&cache, fnamchk);
+    result_cache_add_intmax(&cache, (intmax_t)verbosity_level);
+    result_cache_add_intmax(&cache, (intmax_t)msg_warn_silent);
+    result_cache_add_intmax(&cache, (intmax_t)show_warnings);
+    result_cache_add_intmax(&cache, (intmax_t)entertain);
+    result_cache_add_intmax(&cache, (intmax_t)feathery);
+    result_cache_add_intmax(&cache, (intmax_t)read_from_text_file);
+    result_cache_add_intmax(&cache, (intmax_t)test_mode);
+    result_cache_add_str(&cache, ext);
+    result_cache_add_str(&cache, read_from_text_file ? NULL : tar);
+    result_cache_add_str(&cache, fnamchk);
+    result_cache_add_file(&cache, tarball_path);
+
+    if (result_cache_lookup(&cache, &cached_feathers)) {
+	/*
+	 * the report of this very tarball was replayed from the cache
+	 */
+	tarball.total_feathers = (uintmax_t)cached_feathers;
+    } else {
+	result_cache_capture(&cache);
+	tarball.total_feathers = check_tarball(tar, fnamchk);
+	if (entertain) {
+	    if (!tarball.total_feathers) {
+		para("No feathers stuck in tarball.", NULL);
+	    } else {
+		if (tarball.total_feathers >= feathery) {
+		    para("\n... looks like someone has been throwing feathers",
+			 "about, because that is quite a feathery ball of tar!", NULL);
+		}
 	    }
 	}
+	show_tarball_info(tarball_path);
+	result_cache_store(&cache, (intmax_t)tarball.total_feathers);
     }
-    show_tarball_info(tarball_path);
+    result_cache_free(&cache);
 
     /*
      * we need to free the paths to the tools
@@ -432,7 +516,7 @@ usage(int exitcode, char const *prog, char const *str)
 	fprintf_usage(DO_NOT_EXIT, stderr, "%s\n", str);
     }
 
-    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, TAR_PATH_0, FNAMCHK_PATH_0,
+    fprintf_usage(exitcode, stderr, usage_msg, prog, DBG_DEFAULT, TAR_PATH_0, FNAMCHK_PATH_0, XZ_PATH_0,
 	    TXZCHK_BASENAME, MKIOCCCENTRY_REPO_VERSION, TXZCHK_VERSION, JPARSE_UTILS_VERSION,
             JPARSE_UTF8_VERSION, JPARSE_LIBRARY_VERSION);
     exit(exitcode); /*ooo*/
@@ -2259,3 +2343,478 @@ free_txz_files_list(void)
     txz_files = NULL;
     return;
 }
+
+
+/*
+ * find_xz - find the xz(1) tool
+ *
+ * given:
+ *	xz	path given by -z xz, or NULL
+ *
+ * returns:
+ *	malloced path to an executable xz(1)
+ *
+ * NOTE: this function does not return if xz(1) cannot be found.
+ */
+static char *
+find_xz(char const *xz)
+{
+    char const *xz_paths[] = { XZ_PATH_0, XZ_PATH_1, XZ_PATH_2, NULL };
+    char *path = NULL;		/* path to xz */
+    int i;
+
+    /*
+     * use -z xz if it is an executable file
+     */
+    if (xz != NULL) {
+	if (!is_file(xz) || !is_exec(xz)) {
+	    err(3, __func__, "-z xz: not an executable file: %s", xz); /*ooo*/
+	    not_reached();
+	}
+	errno = 0; /* pre-clear errno for errp() */
+	path = strdup(xz);
+	if (path == NULL) {
+	    errp(70, __func__, "strdup(xz) failed");
+	    not_reached();
+	}
+	return path;
+    }
+
+    /*
+     * otherwise look in $PATH and then in the historic locations
+     */
+    for (i = 0; xz_paths[i] != NULL; ++i) {
+	path = resolve_path(xz_paths[i]);
+	if (path != NULL) {
+	    dbg(DBG_MED, "found xz at: %s", path);
+	    return path;
+	}
+    }
+    err(71, __func__, "cannot find xz, try -z /path/to/xz");
+    not_reached();
+}
+
+
+/*
+ * txz_read - read uncompressed bytes of a compressed tarball
+ *
+ * Only the xz blocks that hold the requested bytes are decompressed.
+ *
+ * given:
+ *	index	xz block index of the compressed tarball
+ *	xz	path to xz(1)
+ *	cache	the most recently decompressed block
+ *	offset	uncompressed offset of the first byte to read
+ *	buf	where to store the bytes read
+ *	len	number of bytes to read
+ *
+ * returns:
+ *	true ==> len bytes were read
+ *	false ==> offset + len is beyond the uncompressed data, or a block could
+ *		  not be decompressed
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+static bool
+txz_read(struct xz_index const *index, char const *xz, struct txz_block_cache *cache,
+	 uintmax_t offset, uint8_t *buf, size_t len)
+{
+    struct xz_block *b;		/* block holding offset */
+    intmax_t block;		/* block number holding offset */
+    size_t n;			/* bytes to copy from the block */
+
+    /*
+     * firewall
+     */
+    if (index == NULL || xz == NULL || cache == NULL || buf == NULL) {
+	err(72, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    while (len > 0) {
+	block = xz_index_find(index, offset);
+	if (block < 0) {
+	    return false;
+	}
+	b = dyn_array_addr(index->blocks, struct xz_block, block);
+
+	/*
+	 * decompress the block unless it was the last one decompressed
+	 */
+	if (cache->block != block) {
+	    if (cache->data != NULL) {
+		free(cache->data);
+		cache->data = NULL;
+	    }
+	    cache->block = -1;
+	    cache->data = xz_block_decompress(index, block, xz, &cache->len);
+	    if (cache->data == NULL) {
+		return false;
+	    }
+	    cache->block = block;
+	    ++cache->decompressed;
+	    cache->comp_bytes += b->unpadded_size;
+	    dbg(DBG_HIGH, "decompressed xz block %jd for uncompressed offset: %ju", block, offset);
+	}
+
+	/*
+	 * copy what we need from this block
+	 */
+	n = (size_t)(b->uncomp_offset + cache->len - offset);
+	if (n > len) {
+	    n = len;
+	}
+	memcpy(buf, cache->data + (offset - b->uncomp_offset), n);
+	buf += n;
+	offset += n;
+	len -= n;
+    }
+    return true;
+}
+
+
+/*
+ * txz_next_member - read the tar header of the next member of a compressed tarball
+ *
+ * given:
+ *	index	xz block index of the compressed tarball
+ *	xz	path to xz(1)
+ *	cache	the most recently decompressed block
+ *	offset	pointer to uncompressed offset of the tar header, updated to
+ *		the offset of the following tar header
+ *	member	where to store the member information
+ *
+ * returns:
+ *	1 ==> member read, the caller must free member->name
+ *	0 ==> end of the tar archive
+ *	-1 ==> invalid tar header or read error, a warning was issued
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+static int
+txz_next_member(struct xz_index const *index, char const *xz, struct txz_block_cache *cache,
+		uintmax_t *offset, struct txz_member *member)
+{
+    uint8_t hdr[TAR_BLOCK_LEN];		/* tar header */
+    char *long_name = NULL;		/* GNU long name of the next member, if any */
+    uintmax_t size;			/* size field */
+    uintmax_t chksum;			/* checksum field */
+    uintmax_t sum;			/* computed header checksum */
+    size_t name_len;			/* length of the name field */
+    size_t prefix_len;			/* length of the ustar prefix field */
+    size_t i;
+
+    /*
+     * firewall
+     */
+    if (index == NULL || xz == NULL || cache == NULL || offset == NULL || member == NULL) {
+	err(73, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+    memset(member, 0, sizeof(*member));
+
+    for (;;) {
+	/*
+	 * read the header, a missing or all zero header ends the archive
+	 */
+	if (*offset + TAR_BLOCK_LEN > index->uncomp_size) {
+	    free(long_name);
+	    return 0;
+	}
+	if (!txz_read(index, xz, cache, *offset, hdr, sizeof(hdr))) {
+	    warn(__func__, "cannot read tar header at offset: %ju", *offset);
+	    free(long_name);
+	    return -1;
+	}
+	for (i=0; i < sizeof(hdr) && hdr[i] == 0; ++i) {
+	    /* look for a non-zero byte */
+	}
+	if (i == sizeof(hdr)) {
+	    free(long_name);
+	    return 0;
+	}
+
+	/*
+	 * verify the header checksum, computed with the checksum field as spaces
+	 */
+	sum = 0;
+	for (i=0; i < sizeof(hdr); ++i) {
+	    sum += (i >= TAR_CHKSUM_OFFSET && i < TAR_CHKSUM_OFFSET + TAR_CHKSUM_LEN) ? ' ' : hdr[i];
+	}
+	chksum = 0;
+	for (i=TAR_CHKSUM_OFFSET; i < TAR_CHKSUM_OFFSET + TAR_CHKSUM_LEN && hdr[i] == ' '; ++i) {
+	    /* skip leading spaces */
+	}
+	for (; i < TAR_CHKSUM_OFFSET + TAR_CHKSUM_LEN && hdr[i] >= '0' && hdr[i] <= '7'; ++i) {
+	    chksum = (chksum << 3) + (uintmax_t)(hdr[i] - '0');
+	}
+	if (chksum != sum) {
+	    warn(__func__, "invalid tar header checksum at offset: %ju", *offset);
+	    free(long_name);
+	    return -1;
+	}
+
+	/*
+	 * parse the size: octal, or base-256 if the high bit of the first byte is set
+	 */
+	size = 0;
+	if (hdr[TAR_SIZE_OFFSET] & 0x80) {
+	    for (i=TAR_SIZE_OFFSET+1; i < TAR_SIZE_OFFSET + TAR_SIZE_LEN; ++i) {
+		size = (size << 8) | hdr[i];
+	    }
+	} else {
+	    for (i=TAR_SIZE_OFFSET; i < TAR_SIZE_OFFSET + TAR_SIZE_LEN && hdr[i] == ' '; ++i) {
+		/* skip leading spaces */
+	    }
+	    for (; i < TAR_SIZE_OFFSET + TAR_SIZE_LEN && hdr[i] >= '0' && hdr[i] <= '7'; ++i) {
+		size = (size << 3) + (uintmax_t)(hdr[i] - '0');
+	    }
+	}
+	member->header_offset = *offset;
+	member->data_offset = *offset + TAR_BLOCK_LEN;
+	member->size = size;
+	member->type = (char)hdr[TAR_TYPEFLAG_OFFSET];
+	*offset = member->data_offset + ((size + TAR_BLOCK_LEN - 1) / TAR_BLOCK_LEN) * TAR_BLOCK_LEN;
+
+	/*
+	 * case: GNU long name: the data is the name of the next member
+	 */
+	if (member->type == 'L') {
+	    free(long_name);
+	    long_name = NULL;
+	    /* the size comes from the tarball: do not let it decide how much we allocate */
+	    if (size == 0 || size > TAR_LONG_NAME_MAX) {
+		warn(__func__, "GNU long name at offset %ju has invalid size: %ju not in [1,%d]",
+			       member->data_offset, size, TAR_LONG_NAME_MAX);
+		++tarball.total_feathers;
+		return -1;
+	    }
+	    errno = 0; /* pre-clear errno for errp() */
+	    long_name = calloc(1, (size_t)size + 1);
+	    if (long_name == NULL) {
+		errp(74, __func__, "calloc of %ju byte long name failed", size + 1);
+		not_reached();
+	    }
+	    if (!txz_read(index, xz, cache, member->data_offset, (uint8_t *)long_name, (size_t)size)) {
+		warn(__func__, "cannot read GNU long name at offset: %ju", member->data_offset);
+		free(long_name);
+		return -1;
+	    }
+	    continue;
+	}
+
+	/*
+	 * case: pax headers: skip, the ustar fields are good enough for us
+	 */
+	if (member->type == 'x' || member->type == 'g') {
+	    continue;
+	}
+	break;
+    }
+
+    /*
+     * form the name: the GNU long name, or the ustar prefix and name
+     */
+    if (long_name != NULL) {
+	member->name = long_name;
+	return 1;
+    }
+    name_len = strnlen((char *)hdr + TAR_NAME_OFFSET, TAR_NAME_LEN);
+    prefix_len = 0;
+    if (memcmp(hdr + TAR_MAGIC_OFFSET, "ustar", LITLEN("ustar")) == 0) {
+	prefix_len = strnlen((char *)hdr + TAR_PREFIX_OFFSET, TAR_PREFIX_LEN);
+    }
+    errno = 0; /* pre-clear errno for errp() */
+    member->name = calloc(1, prefix_len + 1 + name_len + 1);
+    if (member->name == NULL) {
+	errp(75, __func__, "calloc of member name failed");
+	not_reached();
+    }
+    if (prefix_len > 0) {
+	memcpy(member->name, hdr + TAR_PREFIX_OFFSET, prefix_len);
+	member->name[prefix_len] = '/';
+	memcpy(member->name + prefix_len + 1, hdr + TAR_NAME_OFFSET, name_len);
+    } else {
+	memcpy(member->name, hdr + TAR_NAME_OFFSET, name_len);
+    }
+    return 1;
+}
+
+
+/*
+ * txz_block_map - print the xz block index of a compressed tarball and the blocks of each member
+ *
+ * Only the xz blocks that hold tar headers are decompressed.
+ *
+ * given:
+ *	tarball_path	path of the compressed tarball
+ *	xz		path to xz(1)
+ *
+ * returns:
+ *	0 ==> block map printed
+ *	1 ==> tarball could not be indexed or its tar headers could not be read
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+static int
+txz_block_map(char const *tarball_path, char const *xz)
+{
+    struct xz_index index;		/* xz block index of the tarball */
+    struct txz_block_cache cache = { -1, NULL, 0, 0, 0 };	/* last decompressed block */
+    struct txz_member member;		/* member being mapped */
+    struct xz_block *b;			/* block being printed */
+    uintmax_t offset = 0;		/* uncompressed offset of the next tar header */
+    intmax_t first;			/* first block of member */
+    intmax_t last;			/* last block of member */
+    intmax_t len;			/* number of blocks */
+    intmax_t i;
+    int ret;
+
+    /*
+     * firewall
+     */
+    if (tarball_path == NULL || xz == NULL) {
+	err(76, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    if (!xz_index_read(&index, tarball_path)) {
+	return 1;
+    }
+
+    /*
+     * print the xz blocks
+     */
+    len = dyn_array_tell(index.blocks);
+    print("xz blocks: %jd compressed size: %jd uncompressed size: %ju\n",
+	  len, (intmax_t)index.file_size, index.uncomp_size);
+    for (i=0; i < len; ++i) {
+	b = dyn_array_addr(index.blocks, struct xz_block, i);
+	print("block %jd: compressed offset: %jd size: %ju uncompressed offset: %ju size: %ju\n",
+	      i, (intmax_t)b->comp_offset, b->unpadded_size, b->uncomp_offset, b->uncomp_size);
+    }
+
+    /*
+     * print the blocks of each member
+     */
+    while ((ret = txz_next_member(&index, xz, &cache, &offset, &member)) > 0) {
+	first = xz_index_find(&index, member.data_offset);
+	last = xz_index_find(&index, member.data_offset + (member.size > 0 ? member.size - 1 : 0));
+	if (member.size == 0 || first < 0 || last < 0) {
+	    print("member: %s type: %c size: %ju blocks: none\n",
+		  member.name, member.type == '\0' ? '0' : member.type, member.size);
+	} else {
+	    print("member: %s type: %c size: %ju blocks: %jd-%jd\n",
+		  member.name, member.type == '\0' ? '0' : member.type, member.size, first, last);
+	}
+	free(member.name);
+	member.name = NULL;
+    }
+    print("xz blocks decompressed to read the tar headers: %ju of %jd\n", cache.decompressed, len);
+
+    if (cache.data != NULL) {
+	free(cache.data);
+	cache.data = NULL;
+    }
+    free_xz_index(&index);
+    return ret < 0 ? 1 : 0;
+}
+
+
+/*
+ * txz_extract - write a single member of a compressed tarball to stdout
+ *
+ * Only the xz blocks that hold the tar headers up to and including the member,
+ * and the xz blocks that hold the member data, are decompressed.
+ *
+ * given:
+ *	tarball_path	path of the compressed tarball
+ *	xz		path to xz(1)
+ *	name		name of the member: either its full name in the tarball,
+ *			or its name below the top level directory of the tarball
+ *
+ * returns:
+ *	0 ==> member was written to stdout
+ *	1 ==> member was not found, is not a regular file, or could not be read
+ *
+ * NOTE: this function does not return on NULL args.
+ */
+static int
+txz_extract(char const *tarball_path, char const *xz, char const *name)
+{
+    struct xz_index index;		/* xz block index of the tarball */
+    struct txz_block_cache cache = { -1, NULL, 0, 0, 0 };	/* last decompressed block */
+    struct txz_member member;		/* member being looked at */
+    uintmax_t offset = 0;		/* uncompressed offset of the next tar header */
+    uint8_t buf[BUFSIZ];		/* data being copied */
+    uintmax_t left;			/* member data left to copy */
+    size_t n;				/* bytes to copy this time */
+    char const *below;			/* member name below the top level directory */
+    bool found = false;			/* true ==> member found */
+    int exit_code = 1;			/* our return value */
+
+    /*
+     * firewall
+     */
+    if (tarball_path == NULL || xz == NULL || name == NULL) {
+	err(77, __func__, "called with NULL arg(s)");
+	not_reached();
+    }
+
+    if (!xz_index_read(&index, tarball_path)) {
+	return 1;
+    }
+
+    /*
+     * look for the member
+     */
+    while (!found && txz_next_member(&index, xz, &cache, &offset, &member) > 0) {
+	below = strchr(member.name, '/');
+	if (strcmp(member.name, name) == 0 || (below != NULL && strcmp(below + 1, name) == 0)) {
+	    found = true;
+	} else {
+	    free(member.name);
+	    member.name = NULL;
+	}
+    }
+
+    /*
+     * copy the member data to stdout
+     */
+    if (!found) {
+	warn(__func__, "member not found in %s: %s", tarball_path, name);
+    } else if (member.type != '0' && member.type != '\0') {
+	warn(__func__, "member is not a regular file in %s: %s", tarball_path, member.name);
+    } else {
+	offset = member.data_offset;
+	for (left = member.size; left > 0; left -= n) {
+	    n = left < sizeof(buf) ? (size_t)left : sizeof(buf);
+	    if (!txz_read(&index, xz, &cache, offset, buf, n)) {
+		warn(__func__, "cannot read %s from: %s", member.name, tarball_path);
+		break;
+	    }
+	    if (fwrite(buf, 1, n, stdout) != n) {
+		warnp(__func__, "error writing %s to stdout", member.name);
+		break;
+	    }
+	    offset += n;
+	}
+	if (left == 0 && fflush(stdout) == 0) {
+	    exit_code = 0;
+	}
+	dbg(DBG_LOW, "extracted %s by decompressing %ju of %jd xz blocks (%ju of %jd compressed bytes)",
+		     member.name, cache.decompressed, dyn_array_tell(index.blocks),
+		     cache.comp_bytes, (intmax_t)index.file_size);
+    }
+
+    if (member.name != NULL && found) {
+	free(member.name);
+	member.name = NULL;
+    }
+    if (cache.data != NULL) {
+	free(cache.data);
+	cache.data = NULL;
+    }
+    free_xz_index(&index);
+    return exit_code;
+}
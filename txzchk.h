@@ -106,6 +106,16 @@
  */
 #include "soup/walk.h"
 
+/*
+ * soup/result_cache - so we do not have to walk through the same tar pit twice
+ */
+#include "soup/result_cache.h"
+
+/*
+ * soup/xz_index - so we can pull a single feather out of the tar pit
+ */
+#include "soup/xz_index.h"
+
 
 /*
  * macros
@@ -116,6 +126,23 @@
  */
 #define TXZCHK_BASENAME "txzchk"
 
+/*
+ * tar header definitions - see tar(5)
+ */
+#define TAR_BLOCK_LEN (512)			/* tar header and data block length */
+#define TAR_NAME_OFFSET (0)			/* offset of name field */
+#define TAR_NAME_LEN (100)			/* length of name field */
+#define TAR_SIZE_OFFSET (124)			/* offset of size field */
+#define TAR_SIZE_LEN (12)			/* length of size field */
+#define TAR_CHKSUM_OFFSET (148)			/* offset of header checksum field */
+#define TAR_CHKSUM_LEN (8)			/* length of header checksum field */
+#define TAR_TYPEFLAG_OFFSET (156)		/* offset of typeflag field */
+#define TAR_MAGIC_OFFSET (257)			/* offset of the ustar magic field */
+#define TAR_PREFIX_OFFSET (345)			/* offset of the ustar prefix field */
+#define TAR_PREFIX_LEN (155)			/* length of the ustar prefix field */
+#define TAR_LONG_NAME_MAX (4096)		/* longest GNU long name (type L) we read, with its NUL */
+#define TXZ_MEMBER_CHUNK (16)			/* number of txz_member structures to allocate at a time */
+
 
 /*
  * information about the tarball
@@ -180,6 +207,36 @@ struct txz_line
     struct txz_line *next;		/* pointer to the next line or NULL if last line */
 };
 
+/*
+ * txz_member - a member of a compressed tarball, as located by its tar header
+ *
+ * This struct is used by the -B and -X options that read the tar headers
+ * directly from the xz blocks rather than from the output of tar -tJvf.
+ */
+struct txz_member
+{
+    char *name;				/* malloced name of the member */
+    char type;				/* tar typeflag of the member */
+    uintmax_t header_offset;		/* uncompressed offset of the member tar header */
+    uintmax_t data_offset;		/* uncompressed offset of the member data */
+    uintmax_t size;			/* size of the member data */
+};
+
+/*
+ * txz_block_cache - the most recently decompressed xz block
+ *
+ * Consecutive tar headers are often in the same xz block, so we keep the
+ * last decompressed block around.
+ */
+struct txz_block_cache
+{
+    intmax_t block;			/* block number in data, or -1 ==> no block */
+    uint8_t *data;			/* malloced decompressed block */
+    size_t len;				/* length of data */
+    uintmax_t decompressed;		/* number of blocks decompressed so far */
+    uintmax_t comp_bytes;		/* compressed bytes of the blocks decompressed so far */
+};
+
 /*
  * function prototypes
  */
@@ -205,6 +262,13 @@ static bool has_special_bits(struct txz_file *file);
 static void add_txz_file_to_list(struct txz_file *file);
 static void free_txz_file(struct txz_file **file);
 static void free_txz_files_list(void);
+static char *find_xz(char const *xz);
+static bool txz_read(struct xz_index const *index, char const *xz, struct txz_block_cache *cache,
+	uintmax_t offset, uint8_t *buf, size_t len);
+static int txz_next_member(struct xz_index const *index, char const *xz, struct txz_block_cache *cache,
+	uintmax_t *offset, struct txz_member *member);
+static int txz_block_map(char const *tarball_path, char const *xz);
+static int txz_extract(char const *tarball_path, char const *xz, char const *name);
 
 
 #endif /* INCLUDE_TXZCHK_H */